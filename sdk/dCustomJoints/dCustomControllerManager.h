@@ -93,15 +93,34 @@ class dCustomControllerConvexRayFilter: public dCustomControllerConvexCastPreFil
 };
 
 
+#define D_CONTROLLER_UPDATE_BATCH_SIZE	16
+
+class dCustomControllerBase;
+
 class dCustomControllerManagerBase
 {
 	public:
+	typedef void (*dControllerBatchCallback) (dCustomControllerBase* const controller, dFloat timestep, int threadIndex);
+
 	dCustomControllerManagerBase(NewtonWorld* const world)
 		:m_world(world)
 		,m_curTimestep(0.0f)
+		,m_controllers(NULL)
+		,m_batchCallback(NULL)
+		,m_controllersCount(0)
+		,m_controllersCapacity(0)
+		,m_batchSize(D_CONTROLLER_UPDATE_BATCH_SIZE)
+		,m_batchIndex(0)
 	{
 	}
 
+	~dCustomControllerManagerBase()
+	{
+		if (m_controllers) {
+			NewtonFree(m_controllers);
+		}
+	}
+
 	NewtonWorld* GetWorld() const
 	{
 		return m_world;
@@ -112,8 +131,73 @@ class dCustomControllerManagerBase
 		return m_curTimestep;
 	}
 
+	int GetUpdateBatchSize() const
+	{
+		return m_batchSize;
+	}
+
+	// number of controllers a worker thread updates each time it goes back to the job queue
+	void SetUpdateBatchSize(int batchSize)
+	{
+		m_batchSize = dMax (batchSize, 1);
+	}
+
+	protected:
+	void ResizeControllersArray (int count)
+	{
+		if (count > m_controllersCapacity) {
+			if (m_controllers) {
+				NewtonFree(m_controllers);
+			}
+			m_controllersCapacity = dMax (count, m_controllersCapacity * 2);
+			m_controllers = (dCustomControllerBase**) NewtonAlloc(int (m_controllersCapacity * sizeof (dCustomControllerBase*)));
+		}
+		m_controllersCount = count;
+	}
+
+	// call the callback for all controllers, the controllers are spread in batches across the world worker threads
+	void DispatchBatches (dControllerBatchCallback callback)
+	{
+		const int batchCount = (m_controllersCount + m_batchSize - 1) / m_batchSize;
+		const int threadCount = dMin (NewtonGetThreadsCount(m_world), batchCount);
+
+		m_batchIndex = 0;
+		m_batchCallback = callback;
+		for (int i = 0; i < threadCount; i ++) {
+			NewtonDispachThreadJob(m_world, BatchKernel, this);
+		}
+		NewtonSyncThreadJobs(m_world);
+	}
+
+	private:
+	static void BatchKernel (NewtonWorld* const world, void* const context, int threadIndex)
+	{
+		dTimeTrackerEvent(__FUNCTION__);
+		dCustomControllerManagerBase* const me = (dCustomControllerManagerBase*) context;
+		const dFloat timestep = me->m_curTimestep;
+		const int batchSize = me->m_batchSize;
+		const int count = me->m_controllersCount;
+		dCustomControllerBase** const controllers = me->m_controllers;
+		dControllerBatchCallback callback = me->m_batchCallback;
+		for (int i = NewtonAtomicAdd(&me->m_batchIndex, batchSize); i < count; i = NewtonAtomicAdd(&me->m_batchIndex, batchSize)) {
+			const int batchEnd = dMin (i + batchSize, count);
+			for (int j = i; j < batchEnd; j ++) {
+				callback (controllers[j], timestep, threadIndex);
+			}
+		}
+	}
+
+	public:
 	NewtonWorld* m_world;
 	dFloat m_curTimestep;
+
+	protected:
+	dCustomControllerBase** m_controllers;
+	dControllerBatchCallback m_batchCallback;
+	int m_controllersCount;
+	int m_controllersCapacity;
+	int m_batchSize;
+	int m_batchIndex;
 };
 
 
@@ -186,6 +270,9 @@ class dCustomControllerManager: public dCustomControllerManagerBase, public dLis
 	virtual void PostUpdate(dFloat timestep);
 	virtual void OnDebug(dCustomJoint::dDebugDisplay* const debugContext);
 
+	protected:
+	void BuildControllersArray ();
+
 	private:
 	void DestroyAllController ();
 
@@ -195,8 +282,8 @@ class dCustomControllerManager: public dCustomControllerManagerBase, public dLis
 	static void PostUpdate (const NewtonWorld* const world, void* const listenerUserData, dFloat timestep);
 	static void OnBodyDestroy (const NewtonWorld* const world, void* const listener, NewtonBody* const body);
 
-	static void PreUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex);
-	static void PostUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex);
+	static void PreUpdateKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex);
+	static void PostUpdateKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex);
 };
 
 
@@ -229,21 +316,29 @@ void dCustomControllerManager<CONTROLLER_BASE>::DestroyAllController ()
 
 
 template<class CONTROLLER_BASE>
-void dCustomControllerManager<CONTROLLER_BASE>::PreUpdate(dFloat timestep)
+void dCustomControllerManager<CONTROLLER_BASE>::BuildControllersArray ()
 {
-	for (typename dCustomControllerManager<CONTROLLER_BASE>::dListNode* node = dCustomControllerManager<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
-		NewtonDispachThreadJob(m_world, PreUpdateKernel, &node->GetInfo());
+	ResizeControllersArray (dList<CONTROLLER_BASE>::GetCount());
+
+	int index = 0;
+	for (typename dList<CONTROLLER_BASE>::dListNode* node = dList<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
+		m_controllers[index] = &node->GetInfo();
+		index ++;
 	}
-	NewtonSyncThreadJobs(m_world);
+}
+
+template<class CONTROLLER_BASE>
+void dCustomControllerManager<CONTROLLER_BASE>::PreUpdate(dFloat timestep)
+{
+	BuildControllersArray ();
+	DispatchBatches (PreUpdateKernel);
 }
 
 template<class CONTROLLER_BASE>
 void dCustomControllerManager<CONTROLLER_BASE>::PostUpdate(dFloat timestep)
 {
-	for (typename dList<CONTROLLER_BASE>::dListNode* node = dList<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
-		NewtonDispachThreadJob(m_world, PostUpdateKernel, &node->GetInfo());
-	}
-	NewtonSyncThreadJobs(m_world);
+	BuildControllersArray ();
+	DispatchBatches (PostUpdateKernel);
 }
 
 
@@ -292,19 +387,15 @@ void dCustomControllerManager<CONTROLLER_BASE>::OnBodyDestroy (const NewtonWorld
 }
 
 template<class CONTROLLER_BASE>
-void dCustomControllerManager<CONTROLLER_BASE>::PreUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex)
+void dCustomControllerManager<CONTROLLER_BASE>::PreUpdateKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex)
 {
-	dTimeTrackerEvent(__FUNCTION__);
-	dCustomControllerBase* const controller = (dCustomControllerBase*) context;
-	controller->PreUpdate(((dCustomControllerManager*)controller->m_manager)->GetTimeStep(), threadIndex);
+	controller->PreUpdate(timestep, threadIndex);
 }
 
 template<class CONTROLLER_BASE>
-void dCustomControllerManager<CONTROLLER_BASE>::PostUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex)
+void dCustomControllerManager<CONTROLLER_BASE>::PostUpdateKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex)
 {
-	dTimeTrackerEvent(__FUNCTION__);
-	class dCustomControllerBase* const controller = (dCustomControllerBase*) context;
-	controller->PostUpdate(((dCustomControllerManager*)controller->m_manager)->GetTimeStep(), threadIndex);
+	controller->PostUpdate(timestep, threadIndex);
 }
 
 template<class CONTROLLER_BASE>
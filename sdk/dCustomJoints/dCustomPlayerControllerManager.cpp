@@ -123,14 +123,16 @@ void dCustomPlayerController::Init(dFloat mass, dFloat outerRadius, dFloat inner
 	NewtonDestroyCollision (playerShape);
 
 	m_isJumping = false;
+	m_batchGroundProbe = false;
+	m_groundProbePending = false;
 }
 
 
 
 dCustomPlayerControllerManager::dCustomPlayerControllerManager(NewtonWorld* const world)
 	:dCustomControllerManager<dCustomPlayerController> (world, PLAYER_PLUGIN_NAME)
+	,m_pendingGroundProbes(0)
 {
-
 }
 
 dCustomPlayerControllerManager::~dCustomPlayerControllerManager()
@@ -144,6 +146,27 @@ dCustomPlayerController* dCustomPlayerControllerManager::CreatePlayer (dFloat ma
 	return controller;
 }
 
+void dCustomPlayerControllerManager::PostUpdate(dFloat timestep)
+{
+	dCustomControllerManager<dCustomPlayerController>::PostUpdate(timestep);
+	if (m_pendingGroundProbes) {
+		// all probes see the players at the positions of the last frame, the bodies are moved after the last probe 
+		DispatchBatches (GroundProbeKernel);
+		DispatchBatches (ApplyGroundProbeKernel);
+		m_pendingGroundProbes = 0;
+	}
+}
+
+void dCustomPlayerControllerManager::GroundProbeKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex)
+{
+	((dCustomPlayerController*)controller)->UpdateGroundProbe(threadIndex);
+}
+
+void dCustomPlayerControllerManager::ApplyGroundProbeKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex)
+{
+	((dCustomPlayerController*)controller)->ApplyGroundProbe();
+}
+
 
 
 
@@ -498,17 +521,42 @@ void dCustomPlayerController::PostUpdate(dFloat timestep, int threadIndex)
 	// determine if player is standing on some plane
 	dMatrix supportMatrix (matrix);
 	supportMatrix.m_posit += updir.Scale (m_sphereCastOrigin);
-	if (m_isJumping) {
-		dVector dst (matrix.m_posit);
-		UpdateGroundPlane (matrix, supportMatrix, dst, threadIndex);
-	} else {
+	dVector dst (matrix.m_posit);
+	if (!m_isJumping) {
 		step = dAbs (updir.DotProduct3(veloc.Scale (timestep)));
 		dFloat castDist = (m_groundPlane.DotProduct3(m_groundPlane) > 0.0f) ? m_stairStep : step;
-		dVector dst (matrix.m_posit - updir.Scale (castDist * 2.0f));
+		dst -= updir.Scale (castDist * 2.0f);
+	}
+
+	if (m_batchGroundProbe) {
+		m_probeMatrix = matrix;
+		m_probeTarget = dst;
+		m_probeVeloc = veloc;
+		m_groundProbePending = true;
+		NewtonAtomicAdd (&manager->m_pendingGroundProbes, 1);
+	} else {
 		UpdateGroundPlane (matrix, supportMatrix, dst, threadIndex);
+
+		// set player velocity, position and orientation
+		NewtonBodySetVelocity(m_body, &veloc[0]);
+		NewtonBodySetMatrix (m_body, &matrix[0][0]);
 	}
+}
 
-	// set player velocity, position and orientation
-	NewtonBodySetVelocity(m_body, &veloc[0]);
-	NewtonBodySetMatrix (m_body, &matrix[0][0]);
+void dCustomPlayerController::UpdateGroundProbe (int threadIndex)
+{
+	if (m_groundProbePending) {
+		dMatrix supportMatrix (m_probeMatrix);
+		supportMatrix.m_posit += m_probeMatrix.RotateVector(m_upVector).Scale (m_sphereCastOrigin);
+		UpdateGroundPlane (m_probeMatrix, supportMatrix, m_probeTarget, threadIndex);
+	}
+}
+
+void dCustomPlayerController::ApplyGroundProbe ()
+{
+	if (m_groundProbePending) {
+		m_groundProbePending = false;
+		NewtonBodySetVelocity(m_body, &m_probeVeloc[0]);
+		NewtonBodySetMatrix (m_body, &m_probeMatrix[0][0]);
+	}
 }
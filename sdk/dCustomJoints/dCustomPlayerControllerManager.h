@@ -62,6 +62,17 @@ class dCustomPlayerController: public dCustomControllerBase
 		m_maxSlope = dCos (dAbs(slopeInRadians));
 	}
 
+	bool GetBatchedGroundProbe() const
+	{
+		return m_batchGroundProbe;
+	}
+
+	// when set, the ground probe and the body update are deferred to a batch the manager runs after all players had moved
+	void SetBatchedGroundProbe (bool state)
+	{
+		m_batchGroundProbe = state;
+	}
+
 	virtual void PreUpdate(dFloat timestep, int threadIndex)
 	{
 	}
@@ -78,12 +89,17 @@ class dCustomPlayerController: public dCustomControllerBase
 
 	private:
 	void UpdateGroundPlane (dMatrix& matrix, const dMatrix& castMatrix, const dVector& target, int threadIndex);
+	void UpdateGroundProbe (int threadIndex);
+	void ApplyGroundProbe ();
 	dFloat CalculateContactKinematics(const dVector& veloc, const NewtonWorldConvexCastReturnInfo* const contact) const;
 
 	dVector m_upVector;
 	dVector m_frontVector;
 	dVector m_groundPlane;
 	dVector m_groundVelocity;
+	dVector m_probeTarget;
+	dVector m_probeVeloc;
+	dMatrix m_probeMatrix;
 	dFloat m_outerRadio;
 	dFloat m_innerRadio;
 	dFloat m_height;
@@ -92,9 +108,13 @@ class dCustomPlayerController: public dCustomControllerBase
 	dFloat m_sphereCastOrigin;
 	dFloat m_restrainingDistance;
 	bool m_isJumping;
+	bool m_batchGroundProbe;
+	bool m_groundProbePending;
 	NewtonCollision* m_castingShape;
 	NewtonCollision* m_supportShape;
 	NewtonCollision* m_upperBodyShape;
+
+	friend class dCustomPlayerControllerManager;
 };
 
 
@@ -108,10 +128,19 @@ class dCustomPlayerControllerManager: public dCustomControllerManager<dCustomPla
 	{
 	}
 
+	CUSTOM_JOINTS_API virtual void PostUpdate(dFloat timestep);
+
 	CUSTOM_JOINTS_API virtual void ApplyPlayerMove (dCustomPlayerController* const controller, dFloat timestep) = 0; 
 
 	CUSTOM_JOINTS_API virtual dCustomPlayerController* CreatePlayer (dFloat mass, dFloat outerRadius, dFloat innerRadius, dFloat height, dFloat stairStep, const dMatrix& localAxis);
 	CUSTOM_JOINTS_API virtual int ProcessContacts (const dCustomPlayerController* const controller, NewtonWorldConvexCastReturnInfo* const contacts, int count) const; 
+
+	private:
+	static void GroundProbeKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex);
+	static void ApplyGroundProbeKernel (dCustomControllerBase* const controller, dFloat timestep, int threadIndex);
+
+	int m_pendingGroundProbes;
+	friend class dCustomPlayerController;
 };
 
 #endif 
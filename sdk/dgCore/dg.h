@@ -41,6 +41,7 @@
 #include "dgVector.h"
 #include "dgMatrix.h"
 #include "dgMemory.h"
+#include "dgMemoryImage.h"
 #include "dgRandom.h"
 #include "dgThread.h"
 #include "dgFastQueue.h"
@@ -25,10 +25,15 @@
 #include "dgList.h"
 #include "dgMatrix.h"
 #include "dgAABBPolygonSoup.h"
+#include "dgThreadHive.h"
+#include "dgMemoryImage.h"
 #include "dgPolygonSoupBuilder.h"
 
 
 #define DG_STACK_DEPTH 512
+#define DG_SPLIT_BINS 16
+#define DG_MAX_BUILD_JOBS 64
+#define DG_PARALLEL_BUILD_MIN_FACES 256
 
 
 DG_MSC_VECTOR_ALIGMENT
@@ -139,6 +144,46 @@ class dgAABBPolygonSoup::dgNodeBuilder: public dgAABBPolygonSoup::dgNode
 class dgAABBPolygonSoup::dgSpliteInfo
 {
 	public:
+	class dgBin
+	{
+		public:
+		dgBin ()
+			:m_p0 (dgFloat32 (1.0e15f))
+			,m_p1 (-dgFloat32 (1.0e15f))
+			,m_count(0)
+		{
+			m_p0 = m_p0 & dgVector::m_triplexMask;
+			m_p1 = m_p1 & dgVector::m_triplexMask;
+		}
+
+		void Add (const dgNodeBuilder& box)
+		{
+			m_p0 = m_p0.GetMin (box.m_p0);
+			m_p1 = m_p1.GetMax (box.m_p1);
+			m_count ++;
+		}
+
+		void Add (const dgBin& bin)
+		{
+			m_p0 = m_p0.GetMin (bin.m_p0);
+			m_p1 = m_p1.GetMax (bin.m_p1);
+			m_count += bin.m_count;
+		}
+
+		dgFloat32 GetCost () const
+		{
+			if (!m_count) {
+				return dgFloat32 (0.0f);
+			}
+			dgVector size (m_p1 - m_p0);
+			return size.DotProduct4(size.ShiftTripleRight()).m_x * dgFloat32 (m_count);
+		}
+
+		dgVector m_p0;
+		dgVector m_p1;
+		dgInt32 m_count;
+	};
+
 	dgSpliteInfo (dgNodeBuilder* const boxArray, dgInt32 boxCount)
 	{
 		dgVector minP ( dgFloat32 (1.0e15f)); 
@@ -155,69 +200,86 @@ class dgAABBPolygonSoup::dgSpliteInfo
 			}
 
 		} else {
-			dgVector median (dgFloat32 (0.0f));
-			dgVector varian (dgFloat32 (0.0f));
+			// binned surface area heuristic, the faces centers are sorted into DG_SPLIT_BINS buckets per axis
+			dgVector centerP0 ( dgFloat32 (1.0e15f)); 
+			dgVector centerP1 (-dgFloat32 (1.0e15f)); 
 			for (dgInt32 i = 0; i < boxCount; i ++) {
 				const dgNodeBuilder& box = boxArray[i];
-
-				const dgVector& p0 = box.m_p0;
-				const dgVector& p1 = box.m_p1;
-
-				minP = minP.GetMin (p0); 
-				maxP = maxP.GetMax (p1); 
-				dgVector p (dgVector::m_half * (p0 + p1));
-
-				median += p;
-				varian += p * p;
+				minP = minP.GetMin (box.m_p0); 
+				maxP = maxP.GetMax (box.m_p1); 
+				centerP0 = centerP0.GetMin (box.m_origin); 
+				centerP1 = centerP1.GetMax (box.m_origin); 
 			}
 
-			varian = varian.Scale4 (dgFloat32 (boxCount)) - median * median;
-
-			dgInt32 index = 0;
-			dgFloat32 maxVarian = dgFloat32 (-1.0e10f);
+			dgVector scale (dgFloat32 (0.0f));
+			dgVector extend (centerP1 - centerP0);
 			for (dgInt32 i = 0; i < 3; i ++) {
-				if (varian[i] > maxVarian) {
-					index = i;
-					maxVarian = varian[i];
+				if (extend[i] > dgFloat32 (1.0e-6f)) {
+					scale[i] = dgFloat32 (DG_SPLIT_BINS) * dgFloat32 (0.9999f) / extend[i];
 				}
 			}
 
-			dgVector center = median.Scale4 (dgFloat32 (1.0f) / dgFloat32 (boxCount));
-			dgFloat32 test = center[index];
-			dgInt32 i0 = 0;
-			dgInt32 i1 = boxCount - 1;
-			do {    
-				for (; i0 <= i1; i0 ++) {
-					const dgNodeBuilder& box = boxArray[i0];
-					dgFloat32 val = (box.m_p0[index] + box.m_p1[index]) * dgFloat32 (0.5f);
-					if (val > test) {
-						break;
-					}
+			dgBin bins[3][DG_SPLIT_BINS];
+			for (dgInt32 i = 0; i < boxCount; i ++) {
+				const dgNodeBuilder& box = boxArray[i];
+				for (dgInt32 j = 0; j < 3; j ++) {
+					bins[j][GetBin (box, centerP0, scale, j)].Add (box);
 				}
+			}
 
-				for (; i1 >= i0; i1 --) {
-					const dgNodeBuilder& box = boxArray[i1];
-					dgFloat32 val = (box.m_p0[index] + box.m_p1[index]) * dgFloat32 (0.5f);
-					if (val < test) {
-						break;
+			dgInt32 bestAxis = -1;
+			dgInt32 bestBin = 0;
+			dgFloat32 bestCost = dgFloat32 (1.0e30f);
+			for (dgInt32 j = 0; j < 3; j ++) {
+				if (scale[j] > dgFloat32 (0.0f)) {
+					dgFloat32 leftCost[DG_SPLIT_BINS];
+					dgBin left;
+					for (dgInt32 i = 0; i < DG_SPLIT_BINS - 1; i ++) {
+						left.Add (bins[j][i]);
+						leftCost[i] = left.GetCost();
+					}
+					dgBin right;
+					for (dgInt32 i = DG_SPLIT_BINS - 1; i > 0; i --) {
+						right.Add (bins[j][i]);
+						dgFloat32 cost = leftCost[i - 1] + right.GetCost();
+						if ((cost < bestCost) && right.m_count && (right.m_count < boxCount)) {
+							bestCost = cost;
+							bestAxis = j;
+							bestBin = i;
+						}
 					}
 				}
+			}
 
-				if (i0 < i1)	{
-					dgSwap(boxArray[i0], boxArray[i1]);
-					i0++; 
-					i1--;
-				}
-			} while (i0 <= i1);
+			if (bestAxis >= 0) {
+				dgInt32 i0 = 0;
+				dgInt32 i1 = boxCount - 1;
+				do {    
+					for (; i0 <= i1; i0 ++) {
+						if (GetBin (boxArray[i0], centerP0, scale, bestAxis) >= bestBin) {
+							break;
+						}
+					}
 
-			if (i0 > 0){
-				i0 --;
-			}
-			if ((i0 + 1) >= boxCount) {
-				i0 = boxCount - 2;
-			}
+					for (; i1 >= i0; i1 --) {
+						if (GetBin (boxArray[i1], centerP0, scale, bestAxis) < bestBin) {
+							break;
+						}
+					}
 
-			m_axis = i0 + 1;
+					if (i0 < i1)	{
+						dgSwap(boxArray[i0], boxArray[i1]);
+						i0++; 
+						i1--;
+					}
+				} while (i0 <= i1);
+				m_axis = i0;
+			} else {
+				// all centers are coincident, any split is as good as any other
+				m_axis = boxCount / 2;
+			}
+			dgAssert (m_axis > 0);
+			dgAssert (m_axis < boxCount);
 		}
 
 		dgAssert (maxP.m_x - minP.m_x >= dgFloat32 (0.0f));
@@ -227,11 +289,47 @@ class dgAABBPolygonSoup::dgSpliteInfo
 		m_p1 = maxP;
 	}
 
+	static DG_INLINE dgInt32 GetBin (const dgNodeBuilder& box, const dgVector& centerP0, const dgVector& scale, dgInt32 axis)
+	{
+		dgInt32 bin = dgInt32 ((box.m_origin[axis] - centerP0[axis]) * scale[axis]);
+		return dgClamp (bin, 0, DG_SPLIT_BINS - 1);
+	}
+
 	dgInt32 m_axis;
 	dgVector m_p0;
 	dgVector m_p1;
 };
 
+class dgAABBPolygonSoup::dgBuildDescriptor
+{
+	public:
+	class dgJob
+	{
+		public:
+		dgNodeBuilder* m_parent;
+		dgInt32 m_firstBox;
+		dgInt32 m_lastBox;
+		bool m_isLeft;
+	};
+
+	const dgAABBPolygonSoup* m_me;
+	dgNodeBuilder* m_leafArray;
+	dgNodeBuilder* m_nodePool;
+	dgInt32 m_splitDepth;
+	dgInt32 m_jobsCount;
+	dgInt32 m_atomicIndex;
+	dgJob m_jobs[DG_MAX_BUILD_JOBS];
+};
+
+class dgAABBPolygonSoup::dgAdjacencyDescriptor
+{
+	public:
+	dgAABBPolygonSoup* m_me;
+	const dgNode::dgLeafNodePtr* m_faces;
+	dgInt32 m_facesCount;
+	dgInt32 m_atomicIndex;
+};
+
 
 
 dgAABBPolygonSoup::dgAABBPolygonSoup ()
@@ -240,14 +338,27 @@ dgAABBPolygonSoup::dgAABBPolygonSoup ()
 	,m_indexCount(0)
 	,m_aabb(NULL)
 	,m_indices(NULL)
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	,m_quantizedNodes(NULL)
+	,m_quantizedNodesCount(0)
+#endif
 {
 }
 
 dgAABBPolygonSoup::~dgAABBPolygonSoup ()
 {
-	if (m_aabb) {
-		dgFreeStack (m_aabb);
-		dgFreeStack (m_indices);
+	if (!m_memoryImage) {
+		if (m_aabb) {
+			dgFreeStack (m_aabb);
+		}
+		if (m_indices) {
+			dgFreeStack (m_indices);
+		}
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+		if (m_quantizedNodes) {
+			dgFreeStack (m_quantizedNodes);
+		}
+#endif
 	}
 }
 
@@ -433,8 +544,14 @@ dgFloat32 dgAABBPolygonSoup::CalculateFaceMaxSize (const dgVector* const vertex,
 
 void dgAABBPolygonSoup::GetAABB (dgVector& p0, dgVector& p1) const
 {
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	if (m_quantizedNodes) { 
+		p0 = dgVector (&m_rootBox[0].m_x);
+		p1 = dgVector (&m_rootBox[1].m_x);
+#else
 	if (m_aabb) { 
 		GetNodeAABB (m_aabb, p0, p1);
+#endif
 	} else {
 		p0 = dgVector (dgFloat32 (0.0f));
 		p1 = dgVector (dgFloat32 (0.0f));
@@ -443,77 +560,91 @@ void dgAABBPolygonSoup::GetAABB (dgVector& p0, dgVector& p1) const
 
 
 
-void dgAABBPolygonSoup::CalculateAdjacendy ()
+dgInt32 dgAABBPolygonSoup::GetLeafFaces (dgNode::dgLeafNodePtr* const faces) const
 {
-	dgVector p0;
-	dgVector p1;
-	GetAABB (p0, p1);
-	dgFastAABBInfo box (p0, p1);
-	ForAllSectors (box, dgVector (dgFloat32 (0.0f)), dgFloat32 (1.0f), CalculateAllFaceEdgeNormals, this);
-
-	dgStack<dgTriplex> pool ((m_indexCount / 2) - 1);
-	const dgTriplex* const vertexArray = (dgTriplex*)GetLocalVertexPool();
-	dgInt32 normalCount = 0;
+	dgInt32 facesCount = 0;
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	for (dgInt32 i = 0; i < m_quantizedNodesCount; i ++) {
+		const dgQuantizedNode* const node = &m_quantizedNodes[i];
+		for (dgInt32 j = 0; j < 4; j ++) {
+			if (node->m_child[j].IsLeaf() && node->m_child[j].GetCount()) {
+				faces[facesCount] = node->m_child[j];
+				facesCount ++;
+			}
+		}
+	}
+#else
 	for (dgInt32 i = 0; i < m_nodesCount; i ++) {
 		const dgNode* const node = &m_aabb[i];
-		if (node->m_left.IsLeaf()) {
-			dgInt32 vCount = node->m_left.GetCount();
-			if (vCount) {
-				dgInt32 index = dgInt32 (node->m_left.GetIndex());
-				dgInt32* const face = &m_indices[index];
-
-				dgInt32 j0 = 2 * (vCount + 1) - 1;
-				dgVector normal (&vertexArray[face[vCount + 1]].m_x);
-				dgAssert (dgAbsf (normal.DotProduct3(normal) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
-				dgVector q0 (&vertexArray[face[vCount - 1]].m_x);
-				for (dgInt32 j = 0; j < vCount; j ++) {
-					dgInt32 j1 = vCount + 2 + j;
-					dgVector q1 (&vertexArray[face[j]].m_x);
-					if (face[j0] == -1) {
-						dgVector e (q1 - q0);
-						dgVector n (e.CrossProduct3(normal));
-						n = n.Scale4(dgFloat32 (1.0f) / dgSqrt (n.DotProduct3(n)));
-						dgAssert (dgAbsf (n.DotProduct3(n) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
-						pool[normalCount].m_x = n.m_x;
-						pool[normalCount].m_y = n.m_y;
-						pool[normalCount].m_z = n.m_z;
-						face[j0] = -normalCount - 1;
-						normalCount ++;
-					}
-					q0 = q1;
-					j0 = j1;
-				}
-			}
+		if (node->m_left.IsLeaf() && node->m_left.GetCount()) {
+			faces[facesCount] = node->m_left;
+			facesCount ++;
+		}
+		if (node->m_right.IsLeaf() && node->m_right.GetCount()) {
+			faces[facesCount] = node->m_right;
+			facesCount ++;
 		}
+	}
+#endif
+	return facesCount;
+}
 
-		if (node->m_right.IsLeaf()) {
-			dgInt32 vCount = node->m_right.GetCount();
-			if (vCount) {
-				dgInt32 index = dgInt32 (node->m_right.GetIndex());
-				dgInt32* const face = &m_indices[index];
-
-				dgInt32 j0 = 2 * (vCount + 1) - 1;
-				dgVector normal (&vertexArray[face[vCount + 1]].m_x);
-				dgAssert (dgAbsf (normal.DotProduct3(normal) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
-				dgVector q0 (&vertexArray[face[vCount - 1]].m_x);
-				for (dgInt32 j = 0; j < vCount; j ++) {
-					dgInt32 j1 = vCount + 2 + j;
-					dgVector q1 (&vertexArray[face[j]].m_x);
-					if (face[j0] == -1) {
-						dgVector e (q1 - q0);
-						dgVector n (e.CrossProduct3(normal));
-						n = n.Scale4(dgFloat32 (1.0f) / dgSqrt (n.DotProduct3(n)));
-						dgAssert (dgAbsf (n.DotProduct3(n) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
-						pool[normalCount].m_x = n.m_x;
-						pool[normalCount].m_y = n.m_y;
-						pool[normalCount].m_z = n.m_z;
-						face[j0] = -normalCount - 1;
-						normalCount ++;
-					}
-					q0 = q1;
-					j0 = j1;
-				}
+void dgAABBPolygonSoup::CalculateAdjacendy (dgThreadHive* const threadPool)
+{
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	dgStack<dgNode::dgLeafNodePtr> faces (m_quantizedNodesCount * 4);
+#else
+	dgStack<dgNode::dgLeafNodePtr> faces (m_nodesCount * 2);
+#endif
+	const dgInt32 facesCount = GetLeafFaces (&faces[0]);
+
+	if (threadPool && (threadPool->GetThreadCount() > 1)) {
+		dgAdjacencyDescriptor descriptor;
+		descriptor.m_me = this;
+		descriptor.m_faces = &faces[0];
+		descriptor.m_facesCount = facesCount;
+		descriptor.m_atomicIndex = 0;
+		const dgInt32 threadsCount = threadPool->GetThreadCount();
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			threadPool->QueueJob (CalculateAdjacendyKernel, &descriptor, threadPool);
+		}
+		threadPool->SynchronizationBarrier();
+	} else {
+		dgVector p0;
+		dgVector p1;
+		GetAABB (p0, p1);
+		dgFastAABBInfo box (p0, p1);
+		ForAllSectors (box, dgVector (dgFloat32 (0.0f)), dgFloat32 (1.0f), CalculateAllFaceEdgeNormals, this);
+	}
+
+	dgStack<dgTriplex> pool ((m_indexCount / 2) - 1);
+	const dgTriplex* const vertexArray = (dgTriplex*)GetLocalVertexPool();
+	dgInt32 normalCount = 0;
+	for (dgInt32 i = 0; i < facesCount; i ++) {
+		dgInt32 vCount = faces[i].GetCount();
+		dgInt32 index = dgInt32 (faces[i].GetIndex());
+		dgInt32* const face = &m_indices[index];
+
+		dgInt32 j0 = 2 * (vCount + 1) - 1;
+		dgVector normal (&vertexArray[face[vCount + 1]].m_x);
+		dgAssert (dgAbsf (normal.DotProduct3(normal) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
+		dgVector q0 (&vertexArray[face[vCount - 1]].m_x);
+		for (dgInt32 j = 0; j < vCount; j ++) {
+			dgInt32 j1 = vCount + 2 + j;
+			dgVector q1 (&vertexArray[face[j]].m_x);
+			if (face[j0] == -1) {
+				dgVector e (q1 - q0);
+				dgVector n (e.CrossProduct3(normal));
+				n = n.Scale4(dgFloat32 (1.0f) / dgSqrt (n.DotProduct3(n)));
+				dgAssert (dgAbsf (n.DotProduct3(n) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
+				pool[normalCount].m_x = n.m_x;
+				pool[normalCount].m_y = n.m_y;
+				pool[normalCount].m_z = n.m_z;
+				face[j0] = -normalCount - 1;
+				normalCount ++;
 			}
+			q0 = q1;
+			j0 = j1;
 		}
 	}
 
@@ -530,39 +661,19 @@ void dgAABBPolygonSoup::CalculateAdjacendy ()
 		m_localVertex = &vertexArray1[0].m_x;
 		m_vertexCount = oldCount + newNormalCount;
 
-		for (dgInt32 i = 0; i < m_nodesCount; i ++) {
-			const dgNode* const node = &m_aabb[i];
-			if (node->m_left.IsLeaf()) {
-				dgInt32 vCount = node->m_left.GetCount();
-				dgInt32 index = dgInt32 (node->m_left.GetIndex());
-				dgInt32* const face = &m_indices[index];
-				for (dgInt32 j = 0; j < vCount; j ++) {
-					if (face[vCount + 2 + j] < 0) {
-						dgInt32 k = -1 - face[vCount + 2 + j];
-						face[vCount + 2 + j] = indexArray[k] + oldCount;
-					}
-					#ifdef _DEBUG	
-						dgVector normal (&vertexArray1[face[vCount + 2 + j]].m_x);
-						dgAssert (dgAbsf (normal.DotProduct3 (normal) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
-					#endif
-				}
-			}
-
-			if (node->m_right.IsLeaf()) {
-				dgInt32 vCount = node->m_right.GetCount();
-				dgInt32 index = dgInt32 (node->m_right.GetIndex());
-				dgInt32* const face = &m_indices[index];
-				for (dgInt32 j = 0; j < vCount; j ++) {
-					if (face[vCount + 2 + j] < 0) {
-						dgInt32 k = -1 - face[vCount + 2 + j];
-						face[vCount + 2 + j] = indexArray[k] + oldCount;
-					}
-
-					#ifdef _DEBUG	
-						dgVector normal (&vertexArray1[face[vCount + 2 + j]].m_x);
-						dgAssert (dgAbsf (normal.DotProduct3 (normal) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
-					#endif
+		for (dgInt32 i = 0; i < facesCount; i ++) {
+			dgInt32 vCount = faces[i].GetCount();
+			dgInt32 index = dgInt32 (faces[i].GetIndex());
+			dgInt32* const face = &m_indices[index];
+			for (dgInt32 j = 0; j < vCount; j ++) {
+				if (face[vCount + 2 + j] < 0) {
+					dgInt32 k = -1 - face[vCount + 2 + j];
+					face[vCount + 2 + j] = indexArray[k] + oldCount;
 				}
+				#ifdef _DEBUG	
+					dgVector normal (&vertexArray1[face[vCount + 2 + j]].m_x);
+					dgAssert (dgAbsf (normal.DotProduct3 (normal) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-6f));
+				#endif
 			}
 		}
 	}
@@ -704,7 +815,7 @@ dgIntersectStatus dgAABBPolygonSoup::CalculateDisjointedFaceEdgeNormals (void* c
 
 
 
-dgAABBPolygonSoup::dgNodeBuilder* dgAABBPolygonSoup::BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder** const allocator) const
+dgAABBPolygonSoup::dgNodeBuilder* dgAABBPolygonSoup::BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder* const nodePool, dgBuildDescriptor* const descriptor, dgInt32 depth) const
 {
 	dgAssert (firstBox >= 0);
 	dgAssert (lastBox >= 0);
@@ -714,24 +825,80 @@ dgAABBPolygonSoup::dgNodeBuilder* dgAABBPolygonSoup::BuildTopDown (dgNodeBuilder
 	} else {
 		dgSpliteInfo info (&leafArray[firstBox], lastBox - firstBox + 1);
 
-		dgNodeBuilder* const parent = new (*allocator) dgNodeBuilder (info.m_p0, info.m_p1);
-		*allocator = *allocator + 1;
+		// each split point between two consecutive leaves is used exactly once, 
+		// so it can be used as the node slot and sub trees can be build concurrently  
+		dgInt32 split = firstBox + info.m_axis;
+		dgNodeBuilder* const parent = new (&nodePool[split - 1]) dgNodeBuilder (info.m_p0, info.m_p1);
 
-		dgAssert (parent);
-		parent->m_right = BuildTopDown (leafArray, firstBox + info.m_axis, lastBox, allocator);
-		parent->m_right->m_parent = parent;
+		if (descriptor && (depth >= descriptor->m_splitDepth)) {
+			dgAssert (descriptor->m_jobsCount < (DG_MAX_BUILD_JOBS - 1));
+			if ((lastBox - split) >= DG_PARALLEL_BUILD_MIN_FACES) {
+				AddBuildJob (descriptor, parent, split, lastBox, false);
+			} else {
+				parent->m_right = BuildTopDown (leafArray, split, lastBox, nodePool, NULL, 0);
+				parent->m_right->m_parent = parent;
+			}
+			if ((split - 1 - firstBox) >= DG_PARALLEL_BUILD_MIN_FACES) {
+				AddBuildJob (descriptor, parent, firstBox, split - 1, true);
+			} else {
+				parent->m_left = BuildTopDown (leafArray, firstBox, split - 1, nodePool, NULL, 0);
+				parent->m_left->m_parent = parent;
+			}
+		} else {
+			parent->m_right = BuildTopDown (leafArray, split, lastBox, nodePool, descriptor, depth + 1);
+			parent->m_right->m_parent = parent;
 
-		parent->m_left = BuildTopDown (leafArray, firstBox, firstBox + info.m_axis - 1, allocator);
-		parent->m_left->m_parent = parent;
+			parent->m_left = BuildTopDown (leafArray, firstBox, split - 1, nodePool, descriptor, depth + 1);
+			parent->m_left->m_parent = parent;
+		}
 		return parent;
 	}
 }
 
+void dgAABBPolygonSoup::AddBuildJob (dgBuildDescriptor* const descriptor, dgNodeBuilder* const parent, dgInt32 firstBox, dgInt32 lastBox, bool isLeft) const
+{
+	dgBuildDescriptor::dgJob& job = descriptor->m_jobs[descriptor->m_jobsCount];
+	job.m_parent = parent;
+	job.m_firstBox = firstBox;
+	job.m_lastBox = lastBox;
+	job.m_isLeft = isLeft;
+	descriptor->m_jobsCount ++;
+}
 
+void dgAABBPolygonSoup::BuildTopDownKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgBuildDescriptor* const descriptor = (dgBuildDescriptor*) context;
+	const dgAABBPolygonSoup* const me = descriptor->m_me;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < descriptor->m_jobsCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+		const dgBuildDescriptor::dgJob& job = descriptor->m_jobs[i];
+		dgNodeBuilder* const node = me->BuildTopDown (descriptor->m_leafArray, job.m_firstBox, job.m_lastBox, descriptor->m_nodePool, NULL, 0);
+		node->m_parent = job.m_parent;
+		if (job.m_isLeft) {
+			job.m_parent->m_left = node;
+		} else {
+			job.m_parent->m_right = node;
+		}
+	}
+}
+
+void dgAABBPolygonSoup::CalculateAdjacendyKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgAdjacencyDescriptor* const descriptor = (dgAdjacencyDescriptor*) context;
+	dgAABBPolygonSoup* const me = descriptor->m_me;
+	const dgFloat32* const vertexArray = me->GetLocalVertexPool();
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 64); i < descriptor->m_facesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 64)) {
+		const dgInt32 count = dgMin (descriptor->m_facesCount - i, 64);
+		for (dgInt32 j = 0; j < count; j ++) {
+			// each face only writes its own edge normals, so faces can be processed in any order
+			const dgNode::dgLeafNodePtr& face = descriptor->m_faces[i + j];
+			CalculateAllFaceEdgeNormals (me, vertexArray, sizeof (dgTriplex), &me->m_indices[face.GetIndex()], face.GetCount(), dgFloat32 (1.0f));
+		}
+	}
+}
 
 
 
-void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild)
+void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild, dgThreadHive* const threadPool)
 {
 	if (builder.m_faceCount == 0) {
 		return;
@@ -773,8 +940,30 @@ void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, boo
 		polygonIndex += (indexCount + 1);
 	}
 
-	dgNodeBuilder* contructorAllocator = &constructor[allocatorIndex];
-	dgNodeBuilder* root = BuildTopDown (&constructor[0], 0, allocatorIndex - 1, &contructorAllocator);
+	dgNodeBuilder* root = NULL;
+	const dgInt32 threadsCount = threadPool ? threadPool->GetThreadCount() : 1;
+	if ((threadsCount > 1) && (allocatorIndex >= DG_PARALLEL_BUILD_MIN_FACES * 2)) {
+		// split the top levels serially, until there are a few sub trees per thread, and build those concurrently 
+		dgBuildDescriptor descriptor;
+		descriptor.m_me = this;
+		descriptor.m_leafArray = &constructor[0];
+		descriptor.m_nodePool = &constructor[allocatorIndex];
+		descriptor.m_splitDepth = 0;
+		descriptor.m_jobsCount = 0;
+		descriptor.m_atomicIndex = 0;
+		while (((1 << (descriptor.m_splitDepth + 1)) < threadsCount * 4) && ((2 << (descriptor.m_splitDepth + 1)) <= DG_MAX_BUILD_JOBS)) {
+			descriptor.m_splitDepth ++;
+		}
+
+		root = BuildTopDown (&constructor[0], 0, allocatorIndex - 1, &constructor[allocatorIndex], &descriptor, 0);
+		const dgInt32 jobsCount = dgMin (threadsCount, descriptor.m_jobsCount);
+		for (dgInt32 i = 0; i < jobsCount; i ++) {
+			threadPool->QueueJob (BuildTopDownKernel, &descriptor, threadPool);
+		}
+		threadPool->SynchronizationBarrier();
+	} else {
+		root = BuildTopDown (&constructor[0], 0, allocatorIndex - 1, &constructor[allocatorIndex], NULL, 0);
+	}
 
 	dgAssert (root);
 	if (root->m_left) {
@@ -937,11 +1126,32 @@ void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, boo
 	if (builder.m_faceCount == 1) {
 		m_aabb[0].m_right = dgNode::dgLeafNodePtr (0, 0);
 	}
+
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	BuildQuantizedTree ();
+	RemoveBoxPoints ();
+#endif
 //	CalculateAdjacendy();
 }
 
 void dgAABBPolygonSoup::Serialize (dgSerialize callback, void* const userData) const
 {
+	// the two node counts are the same for a binary tree, a quantized tree saves zero binary nodes
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	dgInt32 nodesCount = 0;
+	callback (userData, &m_vertexCount, sizeof (dgInt32));
+	callback (userData, &m_indexCount, sizeof (dgInt32));
+	callback (userData, &nodesCount, sizeof (dgInt32));
+	callback (userData, &m_quantizedNodesCount, sizeof (dgInt32));
+	if (m_quantizedNodes) {
+		callback (userData, m_localVertex, sizeof (dgTriplex) * m_vertexCount);
+		callback (userData, m_indices, sizeof (dgInt32) * m_indexCount);
+		callback (userData, &m_quantizedOrigin, sizeof (dgTriplex));
+		callback (userData, &m_quantizedStep, sizeof (dgTriplex));
+		callback (userData, m_rootBox, sizeof (m_rootBox));
+		callback (userData, m_quantizedNodes, sizeof (dgQuantizedNode) * m_quantizedNodesCount);
+	}
+#else
 	callback (userData, &m_vertexCount, sizeof (dgInt32));
 	callback (userData, &m_indexCount, sizeof (dgInt32));
 	callback (userData, &m_nodesCount, sizeof (dgInt32));
@@ -951,34 +1161,150 @@ void dgAABBPolygonSoup::Serialize (dgSerialize callback, void* const userData) c
 		callback (userData,  m_indices, sizeof (dgInt32) * m_indexCount);
 		callback (userData, m_aabb, sizeof (dgNode) * m_nodesCount);
 	}
+#endif
 }
 
 void dgAABBPolygonSoup::Deserialize (dgDeserialize callback, void* const userData, dgInt32 revisionNumber)
 {
+	dgInt32 quantizedNodesCount;
 	m_strideInBytes = sizeof (dgTriplex);
 	callback (userData, &m_vertexCount, sizeof (dgInt32));
 	callback (userData, &m_indexCount, sizeof (dgInt32));
 	callback (userData, &m_nodesCount, sizeof (dgInt32));
-	callback (userData, &m_nodesCount, sizeof (dgInt32));
+	callback (userData, &quantizedNodesCount, sizeof (dgInt32));
 
+	m_localVertex = NULL;
+	m_indices = NULL;
+	m_aabb = NULL;
 	if (m_vertexCount) {
 		m_localVertex = (dgFloat32*) dgMallocStack (sizeof (dgTriplex) * m_vertexCount);
 		m_indices = (dgInt32*) dgMallocStack (sizeof (dgInt32) * m_indexCount);
-		m_aabb = (dgNode*) dgMallocStack (sizeof (dgNode) * m_nodesCount);
-
 		callback (userData, m_localVertex, sizeof (dgTriplex) * m_vertexCount);
 		callback (userData, m_indices, sizeof (dgInt32) * m_indexCount);
-		callback (userData, m_aabb, sizeof (dgNode) * m_nodesCount);
-	} else {
+
+		if (m_nodesCount == quantizedNodesCount) {
+			m_aabb = (dgNode*) dgMallocStack (sizeof (dgNode) * m_nodesCount);
+			callback (userData, m_aabb, sizeof (dgNode) * m_nodesCount);
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+			// a binary tree saved by older versions is converted
+			BuildQuantizedTree ();
+			RemoveBoxPoints ();
+#endif
+		} else {
+			dgTriplex quantizedFrame[4];
+			callback (userData, quantizedFrame, sizeof (quantizedFrame));
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+			m_quantizedOrigin = quantizedFrame[0];
+			m_quantizedStep = quantizedFrame[1];
+			m_rootBox[0] = quantizedFrame[2];
+			m_rootBox[1] = quantizedFrame[3];
+			m_quantizedNodesCount = quantizedNodesCount;
+			m_quantizedNodes = (dgQuantizedNode*) dgMallocStack (sizeof (dgQuantizedNode) * m_quantizedNodesCount);
+			callback (userData, m_quantizedNodes, sizeof (dgQuantizedNode) * m_quantizedNodesCount);
+#else
+			// a quantized tree can not be walked by this build, skip it and leave the mesh empty
+			dgAssert (0);
+			dgStack<dgQuantizedNode> skip (quantizedNodesCount);
+			callback (userData, &skip[0], sizeof (dgQuantizedNode) * quantizedNodesCount);
+			dgFreeStack (m_localVertex);
+			dgFreeStack (m_indices);
+			m_localVertex = NULL;
+			m_indices = NULL;
+			m_vertexCount = 0;
+			m_indexCount = 0;
+			m_nodesCount = 0;
+#endif
+		}
+	}
+}
+
+void dgAABBPolygonSoup::SerializeImage (dgMemoryImageWriter& image) const
+{
+	// the tree only stores indices, so the arrays can be used in place at any address 
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	dgInt32 nodesCount = 0;
+	dgInt32 quantizedNodesCount = m_quantizedNodes ? m_quantizedNodesCount : 0;
+	dgMemoryImageWriter::SerializeStream (&image, &m_vertexCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_indexCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &nodesCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &quantizedNodesCount, sizeof (dgInt32));
+	if (quantizedNodesCount) {
+		dgMemoryImageWriter::SerializeStream (&image, &m_quantizedOrigin, sizeof (dgTriplex));
+		dgMemoryImageWriter::SerializeStream (&image, &m_quantizedStep, sizeof (dgTriplex));
+		dgMemoryImageWriter::SerializeStream (&image, m_rootBox, sizeof (m_rootBox));
+		image.AddSection (m_localVertex, sizeof (dgTriplex) * m_vertexCount);
+		image.AddSection (m_indices, sizeof (dgInt32) * m_indexCount);
+		image.AddSection (m_quantizedNodes, sizeof (dgQuantizedNode) * m_quantizedNodesCount);
+	}
+#else
+	dgInt32 nodesCount = m_aabb ? m_nodesCount : 0;
+	dgInt32 quantizedNodesCount = 0;
+	dgMemoryImageWriter::SerializeStream (&image, &m_vertexCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_indexCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &nodesCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &quantizedNodesCount, sizeof (dgInt32));
+	if (nodesCount) {
+		image.AddSection (m_localVertex, sizeof (dgTriplex) * m_vertexCount);
+		image.AddSection (m_indices, sizeof (dgInt32) * m_indexCount);
+		image.AddSection (m_aabb, sizeof (dgNode) * m_nodesCount);
+	}
+#endif
+}
+
+void dgAABBPolygonSoup::DeserializeImage (const dgMemoryImageReader& image)
+{
+	dgInt32 quantizedNodesCount;
+
+	m_strideInBytes = sizeof (dgTriplex);
+	m_memoryImage = true;
+	dgMemoryImageReader::DeserializeStream ((void*) &image, &m_vertexCount, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream ((void*) &image, &m_indexCount, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream ((void*) &image, &m_nodesCount, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream ((void*) &image, &quantizedNodesCount, sizeof (dgInt32));
+
+	// an image can only be used in place by a build that stores the same kind of tree
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	if (m_nodesCount) {
+		image.SetInvalid();
+	} else if (quantizedNodesCount) {
+		dgMemoryImageReader::DeserializeStream ((void*) &image, &m_quantizedOrigin, sizeof (dgTriplex));
+		dgMemoryImageReader::DeserializeStream ((void*) &image, &m_quantizedStep, sizeof (dgTriplex));
+		dgMemoryImageReader::DeserializeStream ((void*) &image, m_rootBox, sizeof (m_rootBox));
+		m_localVertex = (dgFloat32*) image.ReadSection (sizeof (dgTriplex) * m_vertexCount);
+		m_indices = (dgInt32*) image.ReadSection (sizeof (dgInt32) * m_indexCount);
+		m_quantizedNodes = (dgQuantizedNode*) image.ReadSection (sizeof (dgQuantizedNode) * quantizedNodesCount);
+		m_quantizedNodesCount = quantizedNodesCount;
+	}
+#else
+	if (quantizedNodesCount) {
+		image.SetInvalid();
+	} else if (m_nodesCount) {
+		m_localVertex = (dgFloat32*) image.ReadSection (sizeof (dgTriplex) * m_vertexCount);
+		m_indices = (dgInt32*) image.ReadSection (sizeof (dgInt32) * m_indexCount);
+		m_aabb = (dgNode*) image.ReadSection (sizeof (dgNode) * m_nodesCount);
+	}
+#endif
+
+	if (!image.IsValid()) {
+		m_vertexCount = 0;
+		m_indexCount = 0;
+		m_nodesCount = 0;
 		m_localVertex = NULL;
 		m_indices = NULL;
 		m_aabb = NULL;
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+		m_quantizedNodes = NULL;
+		m_quantizedNodesCount = 0;
+#endif
 	}
 }
 
 
 dgVector dgAABBPolygonSoup::ForAllSectorsSupportVectex (const dgVector& dir) const
 {
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	return ForAllSectorsSupportVectexQuantized (dir);
+#else
 	dgVector supportVertex (dgFloat32 (0.0f));
 	if (m_aabb) {
 		dgFloat32 aabbProjection[DG_STACK_DEPTH];
@@ -1102,11 +1428,18 @@ dgVector dgAABBPolygonSoup::ForAllSectorsSupportVectex (const dgVector& dir) con
 		}
 	}
 	return supportVertex;
+#endif
 }
 
 
 void dgAABBPolygonSoup::ForAllSectorsRayHit (const dgFastRayTest& raySrc, dgFloat32 maxParam, dgRayIntersectCallback callback, void* const context) const
 {
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	if (m_quantizedNodes) {
+		ForAllSectorsRayHitQuantized (raySrc, maxParam, callback, context);
+	}
+#else
+
 	const dgNode *stackPool[DG_STACK_DEPTH];
 	dgFloat32 distance[DG_STACK_DEPTH];
 	dgFastRayTest ray (raySrc);
@@ -1184,6 +1517,7 @@ void dgAABBPolygonSoup::ForAllSectorsRayHit (const dgFastRayTest& raySrc, dgFloa
 			}
 		}
 	}
+#endif
 }
 
 
@@ -1197,6 +1531,12 @@ void dgAABBPolygonSoup::ForAllSectors (const dgFastAABBInfo& obbAabbInfo, const
 	dgAssert (dgAbsf(dgAbsf(obbAabbInfo[0][2]) - obbAabbInfo.m_absDir[2][0]) < dgFloat32 (1.0e-4f));
 	dgAssert (dgAbsf(dgAbsf(obbAabbInfo[1][2]) - obbAabbInfo.m_absDir[2][1]) < dgFloat32 (1.0e-4f));
 
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	if (m_quantizedNodes) {
+		ForAllSectorsQuantized (obbAabbInfo, boxDistanceTravel, callback, context);
+	}
+#else
+
 	if (m_aabb) {
 		dgFloat32 distance[DG_STACK_DEPTH];
 		const dgNode* stackPool[DG_STACK_DEPTH];
@@ -1373,6 +1713,586 @@ void dgAABBPolygonSoup::ForAllSectors (const dgFastAABBInfo& obbAabbInfo, const
 			}
 		}
 	}
+#endif
+}
+
+
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+
+dgInt32 dgAABBPolygonSoup::CollapseQuantizedNode (const dgNode* const node, dgNode::dgLeafNodePtr* const children) const
+{
+	// keep opening the internal child with the largest surface until there are four children
+	const dgTriplex* const vertexArray = (dgTriplex*) m_localVertex;
+	children[0] = node->m_left;
+	children[1] = node->m_right;
+	dgInt32 count = 2;
+	while (count < 4) {
+		dgInt32 bestChild = -1;
+		dgFloat32 bestArea = dgFloat32 (-1.0f);
+		for (dgInt32 i = 0; i < count; i ++) {
+			if (!children[i].IsLeaf()) {
+				const dgNode* const child = children[i].GetNode(m_aabb);
+				dgVector p0 (&vertexArray[child->m_indexBox0].m_x);
+				dgVector p1 (&vertexArray[child->m_indexBox1].m_x);
+				dgVector size (p1 - p0);
+				dgFloat32 area = size.DotProduct4(size.ShiftTripleRight()).GetScalar();
+				if (area > bestArea) {
+					bestArea = area;
+					bestChild = i;
+				}
+			}
+		}
+		if (bestChild == -1) {
+			break;
+		}
+		const dgNode* const child = children[bestChild].GetNode(m_aabb);
+		children[bestChild] = child->m_left;
+		children[count] = child->m_right;
+		count ++;
+	}
+	return count;
+}
+
+void dgAABBPolygonSoup::GetQuantizedFrame (dgVector* const origin, dgVector* const step) const
+{
+	origin[0] = dgVector (m_quantizedOrigin.m_x);
+	origin[1] = dgVector (m_quantizedOrigin.m_y);
+	origin[2] = dgVector (m_quantizedOrigin.m_z);
+	step[0] = dgVector (m_quantizedStep.m_x);
+	step[1] = dgVector (m_quantizedStep.m_y);
+	step[2] = dgVector (m_quantizedStep.m_z);
+}
+
+void dgAABBPolygonSoup::BuildQuantizedTree ()
+{
+	if (m_quantizedNodes) {
+		dgFreeStack (m_quantizedNodes);
+		m_quantizedNodes = NULL;
+		m_quantizedNodesCount = 0;
+	}
+	if (!m_aabb) {
+		return;
+	}
+
+	const dgTriplex* const vertexArray = (dgTriplex*) m_localVertex;
+
+	// the grid step can not be smaller than the float precision at the location of the mesh, 
+	// and the grid extends a few steps past the root box so that face boxes never get clamped
+	dgVector rootP0 (&vertexArray[m_aabb->m_indexBox0].m_x);
+	dgVector rootP1 (&vertexArray[m_aabb->m_indexBox1].m_x);
+	m_rootBox[0] = vertexArray[m_aabb->m_indexBox0];
+	m_rootBox[1] = vertexArray[m_aabb->m_indexBox1];
+	dgVector maxAbs (rootP0.Abs().GetMax(rootP1.Abs()));
+	dgVector step (((rootP1 - rootP0).Scale4 (dgFloat32 (1.0f / 65000.0f))).GetMax(maxAbs.Scale4 (dgFloat32 (1.0e-6f))).GetMax(dgVector (dgFloat32 (1.0e-6f))));
+	dgVector origin (rootP0 - step.Scale4 (dgFloat32 (256.0f)));
+	m_quantizedOrigin.m_x = origin.m_x;
+	m_quantizedOrigin.m_y = origin.m_y;
+	m_quantizedOrigin.m_z = origin.m_z;
+	m_quantizedStep.m_x = step.m_x;
+	m_quantizedStep.m_y = step.m_y;
+	m_quantizedStep.m_z = step.m_z;
+
+	dgStack<dgQuantizedNode> nodePool (m_nodesCount);
+	const dgNode* stackPool[DG_STACK_DEPTH];
+	dgInt32 parentPool[DG_STACK_DEPTH];
+
+	dgInt32 stack = 1;
+	stackPool[0] = m_aabb;
+	parentPool[0] = -1;
+	dgInt32 nodeCount = 0;
+	while (stack) {
+		stack --;
+		const dgNode* const node = stackPool[stack];
+		dgInt32 parentSlot = parentPool[stack];
+
+		dgInt32 index = nodeCount;
+		nodeCount ++;
+		dgAssert (nodeCount <= m_nodesCount);
+		if (parentSlot >= 0) {
+			nodePool[parentSlot >> 2].m_child[parentSlot & 3] = dgNode::dgLeafNodePtr (dgUnsigned32 (index));
+		}
+
+		dgNode::dgLeafNodePtr children[] = {node->m_left, node->m_right, node->m_left, node->m_right};
+		dgInt32 count = CollapseQuantizedNode (node, children);
+
+		dgQuantizedNode& quantizedNode = nodePool[index];
+		for (dgInt32 i = 0; i < 4; i ++) {
+			dgVector p0 (dgFloat32 (0.0f));
+			dgVector p1 (dgFloat32 (0.0f));
+			if (i >= count) {
+				quantizedNode.m_child[i] = dgNode::dgLeafNodePtr (0, 0);
+			} else if (children[i].IsLeaf()) {
+				quantizedNode.m_child[i] = children[i];
+				dgInt32 vCount = children[i].GetCount();
+				if (vCount) {
+					// same padding the builder applies to face boxes
+					const dgInt32* const face = &m_indices[children[i].GetIndex()];
+					p0 = dgVector (&vertexArray[face[0]].m_x);
+					p1 = p0;
+					for (dgInt32 j = 1; j < vCount; j ++) {
+						dgVector p (&vertexArray[face[j]].m_x);
+						p0 = p0.GetMin(p);
+						p1 = p1.GetMax(p);
+					}
+					p0 -= dgVector (dgFloat32 (1.0e-3f));
+					p1 += dgVector (dgFloat32 (1.0e-3f));
+				}
+			} else {
+				// the link to an internal child is patched when the child is emitted
+				quantizedNode.m_child[i] = dgNode::dgLeafNodePtr (0, 0);
+				const dgNode* const child = children[i].GetNode(m_aabb);
+				p0 = dgVector (&vertexArray[child->m_indexBox0].m_x);
+				p1 = dgVector (&vertexArray[child->m_indexBox1].m_x);
+			}
+
+			for (dgInt32 j = 0; j < 3; j ++) {
+				dgInt32 q0 = dgClamp (dgInt32 (dgFloor ((p0[j] - origin[j]) / step[j])) - 1, 0, 0xffff);
+				dgInt32 q1 = dgClamp (dgInt32 (dgFloor ((p1[j] - origin[j]) / step[j])) + 2, 0, 0xffff);
+				while ((q0 > 0) && ((origin[j] + step[j] * dgFloat32 (q0)) > p0[j])) {
+					q0 --;
+				}
+				while ((q1 < 0xffff) && ((origin[j] + step[j] * dgFloat32 (q1)) < p1[j])) {
+					q1 ++;
+				}
+				quantizedNode.m_min[j][i] = dgUnsigned16 (q0);
+				quantizedNode.m_max[j][i] = dgUnsigned16 (q1);
+			}
+		}
+
+		// push the internal children in reverse so that the first one is emitted next to its parent
+		for (dgInt32 i = count - 1; i >= 0; i --) {
+			if (!children[i].IsLeaf()) {
+				dgAssert (stack < DG_STACK_DEPTH);
+				stackPool[stack] = children[i].GetNode(m_aabb);
+				parentPool[stack] = index * 4 + i;
+				stack ++;
+			}
+		}
+	}
+
+	m_quantizedNodesCount = nodeCount;
+	m_quantizedNodes = (dgQuantizedNode*) dgMallocStack (sizeof (dgQuantizedNode) * nodeCount);
+	memcpy (m_quantizedNodes, &nodePool[0], sizeof (dgQuantizedNode) * nodeCount);
+
+	// the quantized nodes replace the binary nodes
+	dgFreeStack (m_aabb);
+	m_aabb = NULL;
+	m_nodesCount = 0;
+}
+
+void dgAABBPolygonSoup::RemoveBoxPoints ()
+{
+	// the binary node box corners are in the vertex pool, keep only the points referenced by the faces
+	dgStack<dgInt32> remap (m_vertexCount);
+	memset (&remap[0], 0, sizeof (dgInt32) * m_vertexCount);
+
+	dgStack<dgNode::dgLeafNodePtr> faces (m_quantizedNodesCount * 4);
+	const dgInt32 facesCount = GetLeafFaces (&faces[0]);
+	for (dgInt32 i = 0; i < facesCount; i ++) {
+		// index format i0, i1, i2, ... , id, normal, e0Normal, e1Normal, e2Normal, ..., faceSize
+		const dgInt32 vCount = faces[i].GetCount();
+		const dgInt32* const face = &m_indices[faces[i].GetIndex()];
+		for (dgInt32 j = 0; j < vCount; j ++) {
+			remap[face[j]] = 1;
+		}
+		for (dgInt32 j = vCount + 1; j < 2 * vCount + 2; j ++) {
+			if (face[j] >= 0) {
+				remap[face[j]] = 1;
+			}
+		}
+	}
+
+	dgInt32 count = 0;
+	dgTriplex* const vertexArray = (dgTriplex*) m_localVertex;
+	for (dgInt32 i = 0; i < m_vertexCount; i ++) {
+		if (remap[i]) {
+			vertexArray[count] = vertexArray[i];
+			remap[i] = count;
+			count ++;
+		}
+	}
+
+	if (count < m_vertexCount) {
+		for (dgInt32 i = 0; i < facesCount; i ++) {
+			const dgInt32 vCount = faces[i].GetCount();
+			dgInt32* const face = &m_indices[faces[i].GetIndex()];
+			for (dgInt32 j = 0; j < vCount; j ++) {
+				face[j] = remap[face[j]];
+			}
+			for (dgInt32 j = vCount + 1; j < 2 * vCount + 2; j ++) {
+				if (face[j] >= 0) {
+					face[j] = remap[face[j]];
+				}
+			}
+		}
+
+		dgTriplex* const facePoints = (dgTriplex*) dgMallocStack (sizeof (dgTriplex) * count);
+		memcpy (facePoints, vertexArray, sizeof (dgTriplex) * count);
+		dgFreeStack (m_localVertex);
+		m_localVertex = &facePoints[0].m_x;
+		m_vertexCount = count;
+	}
+}
+
+dgInt32 dgAABBPolygonSoup::GetChildCount (dgInt32 index) const
+{
+	// unused children are empty leaves at the end of the node
+	const dgQuantizedNode* const node = &m_quantizedNodes[index];
+	dgInt32 count = 0;
+	while ((count < 4) && !(node->m_child[count].IsLeaf() && !node->m_child[count].GetCount())) {
+		count ++;
+	}
+	return count;
+}
+
+void* dgAABBPolygonSoup::GetNodeHandle (dgInt32 index, dgInt32 first, dgInt32 last) const
+{
+	dgAssert (last > first);
+	return (void*) (size_t ((index << 4) | (first << 2) | (last - 1)) + 1);
+}
+
+void dgAABBPolygonSoup::GetNodeRange (const void* const handle, dgInt32& index, dgInt32& first, dgInt32& last) const
+{
+	dgInt32 code = dgInt32 (size_t (handle) - 1);
+	index = code >> 4;
+	first = (code >> 2) & 3;
+	last = (code & 3) + 1;
+}
+
+void* dgAABBPolygonSoup::GetRangeHandle (dgInt32 index, dgInt32 first, dgInt32 last) const
+{
+	// a single child is a leaf or the whole range of the child node
+	if ((last - first) == 1) {
+		const dgNode::dgLeafNodePtr& child = m_quantizedNodes[index].m_child[first];
+		return child.IsLeaf() ? NULL : GetNodeHandle (child.m_node, 0, GetChildCount (child.m_node));
+	}
+	return GetNodeHandle (index, first, last);
+}
+
+void dgAABBPolygonSoup::GetNodeAABB (const void* const root, dgVector& p0, dgVector& p1) const
+{
+	dgInt32 index;
+	dgInt32 first;
+	dgInt32 last;
+	GetNodeRange (root, index, first, last);
+
+	const dgQuantizedNode* const node = &m_quantizedNodes[index];
+	dgVector q0 (dgFloat32 (0xffff));
+	dgVector q1 (dgFloat32 (0.0f));
+	for (dgInt32 i = first; i < last; i ++) {
+		q0 = q0.GetMin (dgVector (dgFloat32 (node->m_min[0][i]), dgFloat32 (node->m_min[1][i]), dgFloat32 (node->m_min[2][i]), dgFloat32 (0.0f)));
+		q1 = q1.GetMax (dgVector (dgFloat32 (node->m_max[0][i]), dgFloat32 (node->m_max[1][i]), dgFloat32 (node->m_max[2][i]), dgFloat32 (0.0f)));
+	}
+	dgVector origin (m_quantizedOrigin.m_x, m_quantizedOrigin.m_y, m_quantizedOrigin.m_z, dgFloat32 (0.0f));
+	dgVector step (m_quantizedStep.m_x, m_quantizedStep.m_y, m_quantizedStep.m_z, dgFloat32 (0.0f));
+	p0 = origin + step * q0;
+	p1 = origin + step * q1;
+}
+
+void dgAABBPolygonSoup::ForAllSectorsRayHitQuantized (const dgFastRayTest& raySrc, dgFloat32 maxParam, dgRayIntersectCallback callback, void* const context) const
+{
+	const dgQuantizedNode* stackPool[DG_STACK_DEPTH];
+	dgFloat32 distance[DG_STACK_DEPTH];
+	dgFastRayTest ray (raySrc);
+	const dgTriplex* const vertexArray = (dgTriplex*) m_localVertex;
+
+	dgVector origin[3];
+	dgVector step[3];
+	GetQuantizedFrame (origin, step);
+
+	const dgVector rayP0[] = {ray.m_p0.BroadcastX(), ray.m_p0.BroadcastY(), ray.m_p0.BroadcastZ()};
+	const dgVector rayInvDir[] = {ray.m_dpInv.BroadcastX(), ray.m_dpInv.BroadcastY(), ray.m_dpInv.BroadcastZ()};
+	const dgVector rayParallel[] = {ray.m_isParallel.BroadcastX(), ray.m_isParallel.BroadcastY(), ray.m_isParallel.BroadcastZ()};
+	const dgVector minT (ray.m_minT.BroadcastX());
+	const dgVector maxT (ray.m_maxT.BroadcastX());
+
+	dgInt32 stack = 1;
+	stackPool[0] = m_quantizedNodes;
+	distance[0] = ray.BoxIntersect(dgVector (&m_rootBox[0].m_x), dgVector (&m_rootBox[1].m_x));
+	while (stack) {
+		stack --;
+		if (distance[stack] > maxParam) {
+			break;
+		}
+
+		const dgQuantizedNode* const me = stackPool[stack];
+		dgVector minBox[3];
+		dgVector maxBox[3];
+		dgFloat32 childDist[4];
+		me->GetChildBoxes (origin, step, minBox, maxBox);
+		dgQuantizedNode::RayDistance (rayP0, rayInvDir, rayParallel, minT, maxT, minBox, maxBox).Store (childDist);
+
+		for (dgInt32 i = 0; i < 4; i ++) {
+			const dgFloat32 dist1 = childDist[i];
+			if ((dist1 < dgFloat32 (1.0f)) && (dist1 < maxParam)) {
+				const dgNode::dgLeafNodePtr& child = me->m_child[i];
+				if (child.IsLeaf()) {
+					dgInt32 vCount = child.GetCount();
+					if (vCount > 0) {
+						dgInt32 index = dgInt32 (child.GetIndex());
+						dgFloat32 param = callback(context, &vertexArray[0].m_x, sizeof (dgTriplex), &m_indices[index], vCount);
+						dgAssert (param >= dgFloat32 (0.0f));
+						if (param < maxParam) {
+							maxParam = param;
+							if (maxParam == dgFloat32 (0.0f)) {
+								return;
+							}
+						}
+					}
+				} else {
+					const dgQuantizedNode* const node = &m_quantizedNodes[child.m_node];
+					dgInt32 j = stack;
+					for ( ; j && (dist1 > distance[j - 1]); j --) {
+						stackPool[j] = stackPool[j - 1];
+						distance[j] = distance[j - 1];
+					}
+					dgAssert (stack < DG_STACK_DEPTH);
+					stackPool[j] = node;
+					distance[j] = dist1;
+					stack++;
+				}
+			}
+		}
+	}
+}
+
+void dgAABBPolygonSoup::ForAllSectorsQuantized (const dgFastAABBInfo& obbAabbInfo, const dgVector& boxDistanceTravel, dgAABBIntersectCallback callback, void* const context) const
+{
+	dgFloat32 distance[DG_STACK_DEPTH];
+	const dgQuantizedNode* stackPool[DG_STACK_DEPTH];
+
+	const dgInt32 stride = sizeof (dgTriplex) / sizeof (dgFloat32);
+	const dgTriplex* const vertexArray = (dgTriplex*) m_localVertex;
+
+	dgVector origin[3];
+	dgVector step[3];
+	GetQuantizedFrame (origin, step);
+
+	const dgVector obbP0[] = {obbAabbInfo.m_p0.BroadcastX(), obbAabbInfo.m_p0.BroadcastY(), obbAabbInfo.m_p0.BroadcastZ()};
+	const dgVector obbP1[] = {obbAabbInfo.m_p1.BroadcastX(), obbAabbInfo.m_p1.BroadcastY(), obbAabbInfo.m_p1.BroadcastZ()};
+
+	if (boxDistanceTravel.DotProduct3 (boxDistanceTravel) < dgFloat32 (1.0e-8f)) {
+		dgInt32 stack = 1;
+		stackPool[0] = m_quantizedNodes;
+		distance[0] = dgNode::BoxPenetration(obbAabbInfo, dgVector (&m_rootBox[0].m_x), dgVector (&m_rootBox[1].m_x));
+		if (distance[0] <= dgFloat32(0.0f)) {
+			obbAabbInfo.m_separationDistance = dgMin(obbAabbInfo.m_separationDistance, -distance[0]);
+		}
+		while (stack) {
+			stack --;
+			if (distance[stack] > dgFloat32 (0.0f)) {
+				const dgQuantizedNode* const me = stackPool[stack];
+				dgVector minBox[3];
+				dgVector maxBox[3];
+				dgVector separation;
+				me->GetChildBoxes (origin, step, minBox, maxBox);
+				dgVector penetration (dgQuantizedNode::BoxPenetration (obbP0, obbP1, minBox, maxBox, separation));
+
+				dgFloat32 childPenetration[4];
+				dgFloat32 childSeparation[4];
+				dgFloat32 childBox[6][4];
+				penetration.Store (childPenetration);
+				separation.Store (childSeparation);
+				for (dgInt32 i = 0; i < 3; i ++) {
+					minBox[i].Store (childBox[i]);
+					maxBox[i].Store (childBox[i + 3]);
+				}
+
+				for (dgInt32 i = 0; i < 4; i ++) {
+					const dgNode::dgLeafNodePtr& child = me->m_child[i];
+					if (child.IsLeaf()) {
+						dgInt32 vCount = child.GetCount();
+						if (vCount > 0) {
+							if (childPenetration[i] > dgFloat32 (0.0f)) {
+								const dgInt32* const indices = &m_indices[child.GetIndex()];
+								dgInt32 normalIndex = indices[vCount + 1];
+								dgVector faceNormal (&vertexArray[normalIndex].m_x);
+								dgFloat32 dist1 = obbAabbInfo.PolygonBoxDistance (faceNormal, vCount, indices, stride, &vertexArray[0].m_x);
+								if (dist1 > dgFloat32 (0.0f)) {
+									obbAabbInfo.m_separationDistance = dgFloat32(0.0f);
+									dgAssert (vCount >= 3);
+									if (callback(context, &vertexArray[0].m_x, sizeof (dgTriplex), indices, vCount, dist1) == t_StopSearh) {
+										return;
+									}
+								} else {
+									obbAabbInfo.m_separationDistance = dgMin(obbAabbInfo.m_separationDistance, -dist1);
+								}
+							} else {
+								obbAabbInfo.m_separationDistance = dgMin(obbAabbInfo.m_separationDistance, childSeparation[i]);
+							}
+						}
+					} else if (childPenetration[i] > dgFloat32 (0.0f)) {
+						dgVector p0 (childBox[0][i], childBox[1][i], childBox[2][i], dgFloat32 (0.0f));
+						dgVector p1 (childBox[3][i], childBox[4][i], childBox[5][i], dgFloat32 (0.0f));
+						dgFloat32 dist1 = dgNode::BoxPenetration(obbAabbInfo, p0, p1);
+						if (dist1 > dgFloat32 (0.0f)) {
+							dgInt32 j = stack;
+							for ( ; j && (dist1 > distance[j - 1]); j --) {
+								stackPool[j] = stackPool[j - 1];
+								distance[j] = distance[j - 1];
+							}
+							dgAssert (stack < DG_STACK_DEPTH);
+							stackPool[j] = &m_quantizedNodes[child.m_node];
+							distance[j] = dist1;
+							stack++;
+						} else {
+							obbAabbInfo.m_separationDistance = dgMin(obbAabbInfo.m_separationDistance, -dist1);
+						}
+					} else {
+						obbAabbInfo.m_separationDistance = dgMin(obbAabbInfo.m_separationDistance, childSeparation[i]);
+					}
+				}
+			}
+		}
+
+	} else {
+		dgFastRayTest ray (dgVector (dgFloat32 (0.0f)), boxDistanceTravel);
+		dgFastRayTest obbRay (dgVector (dgFloat32 (0.0f)), obbAabbInfo.UnrotateVector(boxDistanceTravel));
+
+		const dgVector rayP0[] = {dgVector::m_zero, dgVector::m_zero, dgVector::m_zero};
+		const dgVector rayInvDir[] = {ray.m_dpInv.BroadcastX(), ray.m_dpInv.BroadcastY(), ray.m_dpInv.BroadcastZ()};
+		const dgVector rayParallel[] = {ray.m_isParallel.BroadcastX(), ray.m_isParallel.BroadcastY(), ray.m_isParallel.BroadcastZ()};
+		const dgVector minT (ray.m_minT.BroadcastX());
+		const dgVector maxT (ray.m_maxT.BroadcastX());
+
+		dgInt32 stack = 1;
+		stackPool[0] = m_quantizedNodes;
+		distance[0] = dgNode::BoxIntersect (ray, obbRay, obbAabbInfo, dgVector (&m_rootBox[0].m_x), dgVector (&m_rootBox[1].m_x));
+		while (stack) {
+			stack --;
+			if (distance[stack] < dgFloat32 (1.0f)) {
+				const dgQuantizedNode* const me = stackPool[stack];
+				dgVector minBox[3];
+				dgVector maxBox[3];
+				me->GetChildBoxes (origin, step, minBox, maxBox);
+
+				// sweep the child boxes grown by the box extents
+				dgVector sweepBox0[3];
+				dgVector sweepBox1[3];
+				for (dgInt32 i = 0; i < 3; i ++) {
+					sweepBox0[i] = minBox[i] - obbP1[i];
+					sweepBox1[i] = maxBox[i] - obbP0[i];
+				}
+				dgFloat32 childDist[4];
+				dgFloat32 childBox[6][4];
+				dgQuantizedNode::RayDistance (rayP0, rayInvDir, rayParallel, minT, maxT, sweepBox0, sweepBox1).Store (childDist);
+				for (dgInt32 i = 0; i < 3; i ++) {
+					minBox[i].Store (childBox[i]);
+					maxBox[i].Store (childBox[i + 3]);
+				}
+
+				for (dgInt32 i = 0; i < 4; i ++) {
+					if (childDist[i] < dgFloat32 (1.0f)) {
+						const dgNode::dgLeafNodePtr& child = me->m_child[i];
+						if (child.IsLeaf()) {
+							dgInt32 vCount = child.GetCount();
+							if (vCount > 0) {
+								const dgInt32* const indices = &m_indices[child.GetIndex()];
+								dgInt32 normalIndex = indices[vCount + 1];
+								dgVector faceNormal (&vertexArray[normalIndex].m_x);
+								dgFloat32 hitDistance = obbAabbInfo.PolygonBoxRayDistance (faceNormal, vCount, indices, stride, &vertexArray[0].m_x, ray);
+								if (hitDistance < dgFloat32 (1.0f)) {
+									dgAssert (vCount >= 3);
+									if (callback(context, &vertexArray[0].m_x, sizeof (dgTriplex), indices, vCount, hitDistance) == t_StopSearh) {
+										return;
+									}
+								}
+							}
+						} else {
+							dgVector p0 (childBox[0][i], childBox[1][i], childBox[2][i], dgFloat32 (0.0f));
+							dgVector p1 (childBox[3][i], childBox[4][i], childBox[5][i], dgFloat32 (0.0f));
+							dgFloat32 dist1 = dgNode::BoxIntersect (ray, obbRay, obbAabbInfo, p0, p1);
+							if (dist1 < dgFloat32 (1.0f)) {
+								dgInt32 j = stack;
+								for ( ; j && (dist1 > distance[j - 1]); j --) {
+									stackPool[j] = stackPool[j - 1];
+									distance[j] = distance[j - 1];
+								}
+								dgAssert (stack < DG_STACK_DEPTH);
+								stackPool[j] = &m_quantizedNodes[child.m_node];
+								distance[j] = dist1;
+								stack ++;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+dgVector dgAABBPolygonSoup::ForAllSectorsSupportVectexQuantized (const dgVector& dir) const
+{
+	dgVector supportVertex (dgFloat32 (0.0f));
+	if (m_quantizedNodes) {
+		dgFloat32 aabbProjection[DG_STACK_DEPTH];
+		const dgQuantizedNode* stackPool[DG_STACK_DEPTH];
+		const dgTriplex* const vertexArray = (dgTriplex*)m_localVertex;
+
+		dgVector origin[3];
+		dgVector step[3];
+		GetQuantizedFrame (origin, step);
+		const dgVector dirX (dir.BroadcastX());
+		const dgVector dirY (dir.BroadcastY());
+		const dgVector dirZ (dir.BroadcastZ());
+
+		dgInt32 stack = 1;
+		stackPool[0] = m_quantizedNodes;
+		aabbProjection[0] = dgFloat32 (1.0e10f);
+		dgFloat32 maxProj = dgFloat32 (-1.0e20f); 
+		while (stack) {
+			stack--;
+			if (aabbProjection[stack] > maxProj) {
+				const dgQuantizedNode* const me = stackPool[stack];
+				dgVector minBox[3];
+				dgVector maxBox[3];
+				me->GetChildBoxes (origin, step, minBox, maxBox);
+
+				// the support point of each child box is the corner picked by the direction signs
+				dgVector projection (dirX * ((dir.m_x > dgFloat32 (0.0f)) ? maxBox[0] : minBox[0]));
+				projection += dirY * ((dir.m_y > dgFloat32 (0.0f)) ? maxBox[1] : minBox[1]);
+				projection += dirZ * ((dir.m_z > dgFloat32 (0.0f)) ? maxBox[2] : minBox[2]);
+				dgFloat32 childProjection[4];
+				projection.Store (childProjection);
+
+				dgInt32 childOrder[4];
+				dgInt32 internalCount = 0;
+				for (dgInt32 i = 0; i < 4; i ++) {
+					const dgNode::dgLeafNodePtr& child = me->m_child[i];
+					if (child.IsLeaf()) {
+						dgInt32 vCount = child.GetCount();
+						const dgInt32* const face = &m_indices[child.GetIndex()];
+						for (dgInt32 j = 0; j < vCount; j ++) {
+							dgVector p (&vertexArray[face[j]].m_x);
+							dgFloat32 dist = p.DotProduct3 (dir);
+							if (dist > maxProj) {
+								maxProj = dist;
+								supportVertex = p; 
+							}
+						}
+					} else {
+						dgInt32 j = internalCount;
+						for ( ; j && (childProjection[i] < childProjection[childOrder[j - 1]]); j --) {
+							childOrder[j] = childOrder[j - 1];
+						}
+						childOrder[j] = i;
+						internalCount ++;
+					}
+				}
+
+				// the child with the largest projection is visited first
+				for (dgInt32 i = 0; i < internalCount; i ++) {
+					dgInt32 j = childOrder[i];
+					dgAssert (stack < DG_STACK_DEPTH);
+					aabbProjection[stack] = childProjection[j];
+					stackPool[stack] = &m_quantizedNodes[me->m_child[j].m_node];
+					stack++;
+				}
+			}
+		}
+	}
+	return supportVertex;
 }
 
+#endif
 
@@ -26,8 +26,14 @@
 #include "dgIntersections.h"
 #include "dgPolygonSoupDatabase.h"
 
+// store the tree as 4-wide nodes holding 16 bit quantized child boxes, the binary tree 
+// is only used while building, comment out to store and walk the binary tree directly
+#define DG_USE_QUANTIZED_AABB_TREE
 
 class dgPolygonSoupDatabaseBuilder;
+class dgThreadHive;
+class dgMemoryImageWriter;
+class dgMemoryImageReader;
 
 
 class dgAABBPolygonSoup: public dgPolygonSoupDatabase
@@ -112,6 +118,18 @@ class dgAABBPolygonSoup: public dgPolygonSoupDatabase
 		{
 			dgVector p0 (&vertexArray[m_indexBox0].m_x);
 			dgVector p1 (&vertexArray[m_indexBox1].m_x);
+			return BoxPenetration (obb, p0, p1);
+		}
+
+		DG_INLINE dgFloat32 BoxIntersect (const dgFastRayTest& ray, const dgFastRayTest& obbRay, const dgFastAABBInfo& obb, const dgTriplex* const vertexArray) const
+		{
+			dgVector p0 (&vertexArray[m_indexBox0].m_x);
+			dgVector p1 (&vertexArray[m_indexBox1].m_x);
+			return BoxIntersect (ray, obbRay, obb, p0, p1);
+		}
+
+		static DG_INLINE dgFloat32 BoxPenetration (const dgFastAABBInfo& obb, const dgVector& p0, const dgVector& p1)
+		{
 			dgVector minBox (p0 - obb.m_p1);
 			dgVector maxBox (p1 - obb.m_p0);
 			dgAssert(maxBox.m_x >= minBox.m_x);
@@ -149,10 +167,8 @@ class dgAABBPolygonSoup: public dgPolygonSoupDatabase
 			return	dist.GetScalar();
 		}
 
-		DG_INLINE dgFloat32 BoxIntersect (const dgFastRayTest& ray, const dgFastRayTest& obbRay, const dgFastAABBInfo& obb, const dgTriplex* const vertexArray) const
+		static DG_INLINE dgFloat32 BoxIntersect (const dgFastRayTest& ray, const dgFastRayTest& obbRay, const dgFastAABBInfo& obb, const dgVector& p0, const dgVector& p1)
 		{
-			dgVector p0 (&vertexArray[m_indexBox0].m_x);
-			dgVector p1 (&vertexArray[m_indexBox1].m_x);
 			dgVector minBox (p0 - obb.m_p1);
 			dgVector maxBox (p1 - obb.m_p0);
 			dgFloat32 dist = ray.BoxIntersect(minBox, maxBox);
@@ -179,23 +195,106 @@ class dgAABBPolygonSoup: public dgPolygonSoupDatabase
 		dgLeafNodePtr m_right;
 	};
 
+	// the boxes of the four children are stored as 16 bit grid coordinates relative to 
+	// the tree origin, in structure of arrays form so that all four are tested at once.
+	// nodes are laid out in depth first order, the first internal child follows its parent.
+	class dgQuantizedNode
+	{
+		public:
+		DG_INLINE void GetChildBoxes (const dgVector* const origin, const dgVector* const step, dgVector* const minBox, dgVector* const maxBox) const
+		{
+			for (dgInt32 i = 0; i < 3; i ++) {
+				minBox[i] = origin[i] + step[i] * dgVector (dgFloat32 (m_min[i][0]), dgFloat32 (m_min[i][1]), dgFloat32 (m_min[i][2]), dgFloat32 (m_min[i][3]));
+				maxBox[i] = origin[i] + step[i] * dgVector (dgFloat32 (m_max[i][0]), dgFloat32 (m_max[i][1]), dgFloat32 (m_max[i][2]), dgFloat32 (m_max[i][3]));
+			}
+		}
+
+		static DG_INLINE dgVector RayDistance (const dgVector* const p0, const dgVector* const dpInv, const dgVector* const isParallel, const dgVector& minT, const dgVector& maxT, const dgVector* const minBox, const dgVector* const maxBox)
+		{
+			dgVector t0 (minT);
+			dgVector t1 (maxT);
+			dgVector outside (dgVector::m_zero);
+			for (dgInt32 i = 0; i < 3; i ++) {
+				outside = outside | (((p0[i] <= minBox[i]) | (p0[i] >= maxBox[i])) & isParallel[i]);
+				dgVector tt0 (dpInv[i] * (minBox[i] - p0[i]));
+				dgVector tt1 (dpInv[i] * (maxBox[i] - p0[i]));
+				t0 = t0.GetMax(tt0.GetMin(tt1));
+				t1 = t1.GetMin(tt0.GetMax(tt1));
+			}
+			dgVector mask ((t0 < t1).AndNot(outside));
+			return (t0 & mask) | dgVector (dgFloat32 (1.2f)).AndNot(mask);
+		}
+
+		static DG_INLINE dgVector BoxPenetration (const dgVector* const obbP0, const dgVector* const obbP1, const dgVector* const minBox, const dgVector* const maxBox, dgVector& separation)
+		{
+			dgVector dist (dgFloat32 (1.0e10f));
+			dgVector gap2 (dgVector::m_zero);
+			for (dgInt32 i = 0; i < 3; i ++) {
+				dgVector box0 (minBox[i] - obbP1[i]);
+				dgVector box1 (maxBox[i] - obbP0[i]);
+				dgVector mask ((box0 * box1) < dgVector::m_zero);
+				dist = dist.GetMin(box1.GetMin(box0.Abs()) & mask);
+				dgVector gap (box0.Abs().GetMin(box1.Abs()).AndNot(mask));
+				gap2 += gap * gap;
+			}
+			separation = gap2.Sqrt();
+			return dist;
+		}
+
+		dgUnsigned16 m_min[3][4];
+		dgUnsigned16 m_max[3][4];
+		dgNode::dgLeafNodePtr m_child[4];
+	};
+
 	class dgSpliteInfo;
 	class dgNodeBuilder;
+	class dgBuildDescriptor;
+	class dgAdjacencyDescriptor;
 
 	virtual void GetAABB (dgVector& p0, dgVector& p1) const;
 	virtual void Serialize (dgSerialize callback, void* const userData) const;
 	virtual void Deserialize (dgDeserialize callback, void* const userData, dgInt32 revisionNumber);
+	void SerializeImage (dgMemoryImageWriter& image) const;
+	void DeserializeImage (const dgMemoryImageReader& image);
 
 	protected:
 	dgAABBPolygonSoup ();
 	virtual ~dgAABBPolygonSoup ();
 
-	void Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild);
-	void CalculateAdjacendy ();
+	void Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild, dgThreadHive* const threadPool = NULL);
+	void CalculateAdjacendy (dgThreadHive* const threadPool = NULL);
 	virtual void ForAllSectorsRayHit (const dgFastRayTest& ray, dgFloat32 maxT, dgRayIntersectCallback callback, void* const context) const;
 	virtual void ForAllSectors (const dgFastAABBInfo& obbAabb, const dgVector& boxDistanceTravel, dgFloat32 m_maxT, dgAABBIntersectCallback callback, void* const context) const;
 	
 
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	// the compound traversal walks the tree as a binary tree, a node handle is a quantized 
+	// node and a range of its children, ranges are split in halves until a single child is left
+	DG_INLINE void* GetRootNode() const 
+	{
+		return m_quantizedNodes ? GetNodeHandle (0, 0, GetChildCount (0)) : NULL;
+	}
+
+	DG_INLINE void* GetBackNode(const void* const root) const 
+	{
+		dgInt32 index;
+		dgInt32 first;
+		dgInt32 last;
+		GetNodeRange (root, index, first, last);
+		return (last - first) > 1 ? GetRangeHandle (index, first, (first + last) >> 1) : NULL;
+	}
+
+	DG_INLINE void* GetFrontNode(const void* const root) const 
+	{
+		dgInt32 index;
+		dgInt32 first;
+		dgInt32 last;
+		GetNodeRange (root, index, first, last);
+		return (last - first) > 1 ? GetRangeHandle (index, (first + last) >> 1, last) : NULL;
+	}
+
+	void GetNodeAABB(const void* const root, dgVector& p0, dgVector& p1) const;
+#else
 	DG_INLINE void* GetRootNode() const 
 	{
 		return m_aabb;
@@ -219,22 +318,48 @@ class dgAABBPolygonSoup: public dgPolygonSoupDatabase
 		p0 = dgVector (&((dgTriplex*)m_localVertex)[node->m_indexBox0].m_x);
 		p1 = dgVector (&((dgTriplex*)m_localVertex)[node->m_indexBox1].m_x);
 	}
+#endif
 	virtual dgVector ForAllSectorsSupportVectex (const dgVector& dir) const;
 
 	
 
 	private:
-	dgNodeBuilder* BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder** const allocator) const;
+	dgNodeBuilder* BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder* const nodePool, dgBuildDescriptor* const descriptor, dgInt32 depth) const;
+	void AddBuildJob (dgBuildDescriptor* const descriptor, dgNodeBuilder* const parent, dgInt32 firstBox, dgInt32 lastBox, bool isLeft) const;
+	static void BuildTopDownKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateAdjacendyKernel (void* const context, void* const worldContext, dgInt32 threadID);
 	dgFloat32 CalculateFaceMaxSize (const dgVector* const vertex, dgInt32 indexCount, const dgInt32* const indexArray) const;
 //	static dgIntersectStatus CalculateManifoldFaceEdgeNormals (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount);
 	static dgIntersectStatus CalculateDisjointedFaceEdgeNormals (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance);
+	dgInt32 GetLeafFaces (dgNode::dgLeafNodePtr* const faces) const;
 	static dgIntersectStatus CalculateAllFaceEdgeNormals (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance);
 	void ImproveNodeFitness (dgNodeBuilder* const node) const;
 
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	void BuildQuantizedTree ();
+	void RemoveBoxPoints ();
+	dgInt32 GetChildCount (dgInt32 index) const;
+	void* GetNodeHandle (dgInt32 index, dgInt32 first, dgInt32 last) const;
+	void* GetRangeHandle (dgInt32 index, dgInt32 first, dgInt32 last) const;
+	void GetNodeRange (const void* const handle, dgInt32& index, dgInt32& first, dgInt32& last) const;
+	dgInt32 CollapseQuantizedNode (const dgNode* const node, dgNode::dgLeafNodePtr* const children) const;
+	void GetQuantizedFrame (dgVector* const origin, dgVector* const step) const;
+	void ForAllSectorsRayHitQuantized (const dgFastRayTest& ray, dgFloat32 maxT, dgRayIntersectCallback callback, void* const context) const;
+	void ForAllSectorsQuantized (const dgFastAABBInfo& obbAabb, const dgVector& boxDistanceTravel, dgAABBIntersectCallback callback, void* const context) const;
+	dgVector ForAllSectorsSupportVectexQuantized (const dgVector& dir) const;
+#endif
+
 	dgInt32 m_nodesCount;
 	dgInt32 m_indexCount;
 	dgNode* m_aabb;
 	dgInt32* m_indices;
+#ifdef DG_USE_QUANTIZED_AABB_TREE
+	dgQuantizedNode* m_quantizedNodes;
+	dgInt32 m_quantizedNodesCount;
+	dgTriplex m_rootBox[2];
+	dgTriplex m_quantizedOrigin;
+	dgTriplex m_quantizedStep;
+#endif
 };
 
 
@@ -26,6 +26,7 @@
 
 dgAsyncThread::dgAsyncThread(const char* const name, dgInt32 id)
 	:dgThread(name, id)
+	,m_isBusy(0)
 	,m_myMutex()
 	,m_callerMutex()
 {
@@ -57,11 +58,19 @@ void dgAsyncThread::Execute (dgInt32 threadID)
 		if (!m_terminate) {
 			TickCallback(threadID);
 		}
+		dgInterlockedExchange(&m_isBusy, 0);
 	}
 }
 
+bool dgAsyncThread::IsBusy() const
+{
+	return m_isBusy ? true : false;
+}
+
 void dgAsyncThread::Tick()
 {
+	// set busy before the thread starts, so that the caller sees the update running as soon as this returns
+	dgInterlockedExchange(&m_isBusy, 1);
 	m_myMutex.Release();
 	SuspendExecution(m_callerMutex);
 }
@@ -33,12 +33,14 @@ class dgAsyncThread: public dgThread
 
 	void Tick(); 
 	void Terminate(); 
+	bool IsBusy() const;
 
 	protected:
 	virtual void Execute (dgInt32 threadID);
 	virtual void TickCallback (dgInt32 threadID) = 0;
 
 	private:
+	dgInt32 m_isBusy;
 	dgSemaphore m_myMutex;
 	dgSemaphore m_callerMutex;
 };
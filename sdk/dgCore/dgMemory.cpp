@@ -25,16 +25,45 @@
 #include "dgMemory.h"
 
 
-#ifdef _DEBUG
-static dgInt32 m_threadSanityCheck = 0;
-#define DG_MEMORY_THREAD_SANITY_CHECK_LOCK()		\
-	dgAssert (!m_threadSanityCheck);				\
-	dgAtomicExchangeAndAdd(&m_threadSanityCheck, 1);
-	#define DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK()	  dgAtomicExchangeAndAdd(&m_threadSanityCheck, -1);	
-#else 
-	#define DG_MEMORY_THREAD_SANITY_CHECK_LOCK()
-	#define DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK()
-#endif
+// each thread claims one slot the first time it calls an allocator, 
+// the slot index selects the thread cache of every allocator.
+// zero means the thread has not claimed a slot yet, and a negative value that all slots were taken.
+static dgInt32 dgThreadCacheSlots[DG_MEMORY_THREAD_CACHES];
+static DG_THREAD_LOCAL dgInt32 dgThreadCacheSlot = 0;
+
+// releases the slot when the thread exits, so that threads created by the application 
+// do not keep their slot after they are gone
+class dgThreadCacheSlotOwner
+{
+	public:
+	~dgThreadCacheSlotOwner ()
+	{
+		if (m_slot == dgThreadCacheSlot) {
+			dgMemoryAllocator::ReleaseThreadCacheSlot();
+		}
+	}
+
+	dgInt32 m_slot;
+};
+static thread_local dgThreadCacheSlotOwner dgThreadCacheSlotExit;
+
+static DG_INLINE dgInt32 dgGetThreadCacheSlot ()
+{
+	dgInt32 slot = dgThreadCacheSlot;
+	if (!slot) {
+		slot = -1;
+		for (dgInt32 i = 0; i < DG_MEMORY_THREAD_CACHES; i ++) {
+			if (!dgThreadCacheSlots[i] && !dgInterlockedCompareExchange(&dgThreadCacheSlots[i], 1, 0)) {
+				slot = i + 1;
+				// the first access constructs the owner and registers its destructor with the thread exit
+				dgThreadCacheSlotExit.m_slot = slot;
+				break;
+			}
+		}
+		dgThreadCacheSlot = slot;
+	}
+	return slot - 1;
+}
 
 
 class dgMemoryAllocator::dgMemoryBin
@@ -60,6 +89,14 @@ class dgMemoryAllocator::dgMemoryCacheEntry
 	dgMemoryCacheEntry* m_prev;
 };
 
+class dgMemoryAllocator::dgThreadCache
+{
+	public:
+	dgMemoryCacheEntry* m_free[DG_MEMORY_BIN_ENTRIES];
+	dgInt32 m_count[DG_MEMORY_BIN_ENTRIES];
+	dgBinCounters m_counters[DG_MEMORY_BIN_ENTRIES];
+};
+
 class dgMemoryAllocator::dgMemoryInfo
 {
 	public:
@@ -140,35 +177,118 @@ class dgGlobalAllocator: public dgMemoryAllocator, public dgList<dgMemoryAllocat
 dgMemoryAllocator::dgMemoryAllocator ()
 	:m_emumerator(0)
 	,m_memoryUsed(0)
+	,m_lock(0)
 	,m_isInList(true)
 	,m_free(NULL)
 	,m_malloc(NULL)
 {
+	Init();
 	SetAllocatorsCallback (dgGlobalAllocator::GetGlobalAllocator().m_malloc, dgGlobalAllocator::GetGlobalAllocator().m_free);
-	memset (m_memoryDirectory, 0, sizeof (m_memoryDirectory));
 	dgGlobalAllocator::GetGlobalAllocator().Append(this);
 }
 
 dgMemoryAllocator::dgMemoryAllocator (dgMemAlloc memAlloc, dgMemFree memFree)
 	:m_emumerator(0)
 	,m_memoryUsed(0)
+	,m_lock(0)
 	,m_isInList(false)
 	,m_free(NULL)
 	,m_malloc(NULL)
 {
+	Init();
 	SetAllocatorsCallback (memAlloc, memFree);
-	memset (m_memoryDirectory, 0, sizeof (m_memoryDirectory));
 }
 
 
 dgMemoryAllocator::~dgMemoryAllocator  ()
 {
+	FreeThreadCaches();
 	if (m_isInList) {
 		dgGlobalAllocator::GetGlobalAllocator().Remove(this);
 	}
 	dgAssert (m_memoryUsed == 0);
 }
 
+void dgMemoryAllocator::Init ()
+{
+	memset (m_memoryDirectory, 0, sizeof (m_memoryDirectory));
+	memset (m_threadCaches, 0, sizeof (m_threadCaches));
+	memset (m_remoteFree, 0, sizeof (m_remoteFree));
+	memset (m_counters, 0, sizeof (m_counters));
+}
+
+void dgMemoryAllocator::ReleaseThreadCacheSlot ()
+{
+	// the blocks in the slot caches stay there, and will be used by the next thread that claims the slot
+	dgInt32 slot = dgThreadCacheSlot;
+	if (slot > 0) {
+		dgInterlockedExchange(&dgThreadCacheSlots[slot - 1], 0);
+	}
+	dgThreadCacheSlot = 0;
+}
+
+dgInt32 dgMemoryAllocator::GetBinCount ()
+{
+	return DG_MEMORY_BIN_ENTRIES;
+}
+
+// the counters are updated by each thread without synchronization, so the values are only an approximation while the allocator is in use
+void dgMemoryAllocator::GetBinCounters (dgInt32 entry, dgInt32& blockSizeInBytes, dgInt64& hits, dgInt64& misses, dgInt64& bytesLive) const
+{
+	dgAssert (entry >= 0);
+	dgAssert (entry < DG_MEMORY_BIN_ENTRIES);
+	dgInt64 allocated = m_counters[entry].m_allocated;
+	dgInt64 freed = m_counters[entry].m_freed;
+	hits = m_counters[entry].m_hits;
+	misses = m_counters[entry].m_misses;
+	for (dgInt32 i = 0; i < DG_MEMORY_THREAD_CACHES; i ++) {
+		const dgThreadCache* const cache = m_threadCaches[i];
+		if (cache) {
+			hits += cache->m_counters[entry].m_hits;
+			misses += cache->m_counters[entry].m_misses;
+			allocated += cache->m_counters[entry].m_allocated;
+			freed += cache->m_counters[entry].m_freed;
+		}
+	}
+	blockSizeInBytes = entry ? (entry - 1) * DG_MEMORY_GRANULARITY : 0;
+	bytesLive = (allocated - freed) * blockSizeInBytes;
+}
+
+dgMemoryAllocator::dgThreadCache* dgMemoryAllocator::GetThreadCache ()
+{
+	dgInt32 slot = dgGetThreadCacheSlot();
+	if (slot < 0) {
+		return NULL;
+	}
+	dgThreadCache* cache = m_threadCaches[slot];
+	if (!cache) {
+		cache = (dgThreadCache*) MallocLow (sizeof (dgThreadCache));
+		memset (cache, 0, sizeof (dgThreadCache));
+		m_threadCaches[slot] = cache;
+	}
+	return cache;
+}
+
+// return all blocks in the thread caches and in the remote lists to the bins, 
+// it can only be called when no other thread is using the allocator
+void dgMemoryAllocator::FreeThreadCaches ()
+{
+	for (dgInt32 i = 0; i < DG_MEMORY_THREAD_CACHES; i ++) {
+		dgThreadCache* const cache = m_threadCaches[i];
+		if (cache) {
+			for (dgInt32 j = 0; j < DG_MEMORY_BIN_ENTRIES; j ++) {
+				FlushThreadCache (cache, j, 0);
+			}
+			m_threadCaches[i] = NULL;
+			FreeLow (cache);
+		}
+	}
+
+	for (dgInt32 i = 0; i < DG_MEMORY_BIN_ENTRIES; i ++) {
+		FreeRemoteBlocks (i);
+	}
+}
+
 
 void *dgMemoryAllocator::operator new (size_t size) 
 { 
@@ -230,8 +350,174 @@ void dgMemoryAllocator::FreeLow (void* const retPtr)
 	m_free (info->m_ptr, dgUnsigned32 (info->m_size));
 }
 
+// take a block from the bins of this entry, it must be called with the allocator locked
+void* dgMemoryAllocator::MallocBin (dgInt32 entry, dgInt32 memsize)
+{
+	if (!m_memoryDirectory[entry].m_cache) {
+		const dgInt32 paddedSize = entry << DG_MEMORY_GRANULARITY_BITS;
+		dgMemoryBin* const bin = (dgMemoryBin*) MallocLow (sizeof (dgMemoryBin));
+
+		dgInt32 count = dgInt32 (sizeof (bin->m_pool) / paddedSize);
+		bin->m_info.m_count = 0;
+		bin->m_info.m_totalCount = count;
+		bin->m_info.m_stepInBites = paddedSize;
+		bin->m_info.m_next = m_memoryDirectory[entry].m_first;
+		bin->m_info.m_prev = NULL;
+		if (bin->m_info.m_next) {
+			bin->m_info.m_next->m_info.m_prev = bin;
+		}
+
+		m_memoryDirectory[entry].m_first = bin;
+
+		dgInt8* charPtr = reinterpret_cast<dgInt8*>(bin->m_pool);
+		m_memoryDirectory[entry].m_cache = (dgMemoryCacheEntry*)charPtr;
+
+		for (dgInt32 i = 0; i < count; i ++) {
+			dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) charPtr;
+			cashe->m_next = (dgMemoryCacheEntry*) (charPtr + paddedSize);
+			cashe->m_prev = (dgMemoryCacheEntry*) (charPtr - paddedSize);
+			dgMemoryInfo* const info = ((dgMemoryInfo*) (charPtr + DG_MEMORY_GRANULARITY)) - 1;						
+			info->SaveInfo(this, bin, entry, m_emumerator, memsize);
+			charPtr += paddedSize;
+		}
+		dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (charPtr - paddedSize);
+		cashe->m_next = NULL;
+		m_memoryDirectory[entry].m_cache->m_prev = NULL;
+	}
+
+
+	dgAssert (m_memoryDirectory[entry].m_cache);
+
+	dgMemoryCacheEntry* const cashe = m_memoryDirectory[entry].m_cache;
+	m_memoryDirectory[entry].m_cache = cashe->m_next;
+	if (cashe->m_next) {
+		cashe->m_next->m_prev = NULL;
+	}
+
+	void* const ptr = ((dgInt8*)cashe) + DG_MEMORY_GRANULARITY;
+
+	dgMemoryInfo* info;
+	info = ((dgMemoryInfo*) (ptr)) - 1;
+	dgAssert (info->m_allocator == this);
+
+	dgMemoryBin* const bin = (dgMemoryBin*) info->m_ptr;
+	bin->m_info.m_count ++;
+	return ptr;
+}
+
+// return a block to its bin, it must be called with the allocator locked
+void dgMemoryAllocator::FreeBin (dgMemoryCacheEntry* const cashe)
+{
+	dgMemoryInfo* const info = ((dgMemoryInfo*) (((char*)cashe) + DG_MEMORY_GRANULARITY)) - 1;
+	dgAssert (info->m_allocator == this);
+	dgInt32 entry = info->m_size;
+
+	dgMemoryCacheEntry* const tmpCashe = m_memoryDirectory[entry].m_cache;
+	if (tmpCashe) {
+		dgAssert (!tmpCashe->m_prev);
+		tmpCashe->m_prev = cashe;
+	}
+	cashe->m_next = tmpCashe;
+	cashe->m_prev = NULL;
+
+	m_memoryDirectory[entry].m_cache = cashe;
+
+	dgMemoryBin* const bin = (dgMemoryBin *) info->m_ptr;
+	dgAssert (bin);
+
+	bin->m_info.m_count --;
+	if (bin->m_info.m_count == 0) {
+
+		dgInt32 count = bin->m_info.m_totalCount;
+		dgInt32 sizeInBytes = bin->m_info.m_stepInBites;
+		char* charPtr = bin->m_pool;
+		for (dgInt32 i = 0; i < count; i ++) {
+			dgMemoryCacheEntry* const tmpCashe1 = (dgMemoryCacheEntry*)charPtr;
+			charPtr += sizeInBytes;
+
+			if (tmpCashe1 == m_memoryDirectory[entry].m_cache) {
+				m_memoryDirectory[entry].m_cache = tmpCashe1->m_next;
+			}
+
+			if (tmpCashe1->m_prev) {
+				tmpCashe1->m_prev->m_next = tmpCashe1->m_next;
+			}
+
+			if (tmpCashe1->m_next) {
+				tmpCashe1->m_next->m_prev = tmpCashe1->m_prev;
+			}
+		}
+
+		if (m_memoryDirectory[entry].m_first == bin) {
+			m_memoryDirectory[entry].m_first = bin->m_info.m_next;
+		}
+
+		if (bin->m_info.m_next) {
+			bin->m_info.m_next->m_info.m_prev = bin->m_info.m_prev;
+		}
+		if (bin->m_info.m_prev) {
+			bin->m_info.m_prev->m_info.m_next = bin->m_info.m_next;
+		}
+
+		FreeLow (bin);
+	}
+}
+
+// move the blocks released by threads without a cache slot back to the bins, it must be called with the allocator locked
+void dgMemoryAllocator::FreeRemoteBlocks (dgInt32 entry)
+{
+	dgMemoryCacheEntry* next;
+	dgMemoryCacheEntry* cashe = (dgMemoryCacheEntry*) dgInterlockedExchangePointer ((void**) &m_remoteFree[entry], NULL);
+	for (; cashe; cashe = next) {
+		next = cashe->m_next;
+		FreeBin (cashe);
+		m_counters[entry].m_freed ++;
+	}
+}
+
+void dgMemoryAllocator::FlushThreadCache (dgThreadCache* const cache, dgInt32 entry, dgInt32 keepCount)
+{
+	dgSpinLock (&m_lock, false);
+	while (cache->m_count[entry] > keepCount) {
+		dgMemoryCacheEntry* const cashe = cache->m_free[entry];
+		cache->m_free[entry] = cashe->m_next;
+		cache->m_count[entry] --;
+		FreeBin (cashe);
+	}
+	dgSpinUnlock (&m_lock);
+}
+
+void dgMemoryAllocator::RefillThreadCache (dgThreadCache* const cache, dgInt32 entry, dgInt32 memsize)
+{
+	dgAssert (!cache->m_free[entry]);
+	dgAssert (!cache->m_count[entry]);
+
+	// blocks released by threads without a cache are taken first, this does not need the lock 
+	// because the whole list is detached at once.
+	dgMemoryCacheEntry* const remote = (dgMemoryCacheEntry*) dgInterlockedExchangePointer ((void**) &m_remoteFree[entry], NULL);
+	if (remote) {
+		dgInt32 count = 0;
+		for (dgMemoryCacheEntry* cashe = remote; cashe; cashe = cashe->m_next) {
+			count ++;
+		}
+		cache->m_free[entry] = remote;
+		cache->m_count[entry] = count;
+		cache->m_counters[entry].m_freed += count;
+	} else {
+		dgSpinLock (&m_lock, false);
+		for (dgInt32 i = 0; i < DG_MEMORY_THREAD_CACHE_DEPTH / 2; i ++) {
+			dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (((dgInt8*)MallocBin (entry, memsize)) - DG_MEMORY_GRANULARITY);
+			cashe->m_next = cache->m_free[entry];
+			cache->m_free[entry] = cashe;
+		}
+		dgSpinUnlock (&m_lock);
+		cache->m_count[entry] = DG_MEMORY_THREAD_CACHE_DEPTH / 2;
+	}
+}
+
 // alloca memory on pool that are quantized to DG_MEMORY_GRANULARITY
 // if memory size is larger than DG_MEMORY_BIN_ENTRIES then the memory is not placed into a pool
+// small blocks come from the calling thread cache, which is refilled from the bins in batches.
 void *dgMemoryAllocator::Malloc (dgInt32 memsize)
 {
 	dgAssert (dgInt32 (sizeof (dgMemoryCacheEntry) + sizeof (dgInt32) + sizeof(dgInt32)) <= DG_MEMORY_GRANULARITY);
@@ -246,65 +532,40 @@ void *dgMemoryAllocator::Malloc (dgInt32 memsize)
 	if (entry >= DG_MEMORY_BIN_ENTRIES) {
 		ptr = MallocLow (size);
 	} else {
-		if (!m_memoryDirectory[entry].m_cache) {
-			dgMemoryBin* const bin = (dgMemoryBin*) MallocLow (sizeof (dgMemoryBin));
-
-			dgInt32 count = dgInt32 (sizeof (bin->m_pool) / paddedSize);
-			bin->m_info.m_count = 0;
-			bin->m_info.m_totalCount = count;
-			bin->m_info.m_stepInBites = paddedSize;
-			bin->m_info.m_next = m_memoryDirectory[entry].m_first;
-			bin->m_info.m_prev = NULL;
-			if (bin->m_info.m_next) {
-				bin->m_info.m_next->m_info.m_prev = bin;
-			}
-
-			m_memoryDirectory[entry].m_first = bin;
-
-			dgInt8* charPtr = reinterpret_cast<dgInt8*>(bin->m_pool);
-			m_memoryDirectory[entry].m_cache = (dgMemoryCacheEntry*)charPtr;
-
-			for (dgInt32 i = 0; i < count; i ++) {
-				dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) charPtr;
-				cashe->m_next = (dgMemoryCacheEntry*) (charPtr + paddedSize);
-				cashe->m_prev = (dgMemoryCacheEntry*) (charPtr - paddedSize);
-				dgMemoryInfo* const info = ((dgMemoryInfo*) (charPtr + DG_MEMORY_GRANULARITY)) - 1;						
-				info->SaveInfo(this, bin, entry, m_emumerator, memsize);
-				charPtr += paddedSize;
+		dgThreadCache* const cache = GetThreadCache();
+		if (cache) {
+			if (cache->m_free[entry]) {
+				cache->m_counters[entry].m_hits ++;
+			} else {
+				cache->m_counters[entry].m_misses ++;
+				RefillThreadCache (cache, entry, memsize);
 			}
-			dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (charPtr - paddedSize);
-			cashe->m_next = NULL;
-			m_memoryDirectory[entry].m_cache->m_prev = NULL;
-		}
-
-
-		dgAssert (m_memoryDirectory[entry].m_cache);
-
-		dgMemoryCacheEntry* const cashe = m_memoryDirectory[entry].m_cache;
-		m_memoryDirectory[entry].m_cache = cashe->m_next;
-		if (cashe->m_next) {
-			cashe->m_next->m_prev = NULL;
+			dgMemoryCacheEntry* const cashe = cache->m_free[entry];
+			cache->m_free[entry] = cashe->m_next;
+			cache->m_count[entry] --;
+			cache->m_counters[entry].m_allocated ++;
+			ptr = ((dgInt8*)cashe) + DG_MEMORY_GRANULARITY;
+		} else {
+			dgSpinLock (&m_lock, false);
+			FreeRemoteBlocks (entry);
+			ptr = MallocBin (entry, memsize);
+			m_counters[entry].m_misses ++;
+			m_counters[entry].m_allocated ++;
+			dgSpinUnlock (&m_lock);
 		}
 
-		ptr = ((dgInt8*)cashe) + DG_MEMORY_GRANULARITY;
-
-		dgMemoryInfo* info;
-		info = ((dgMemoryInfo*) (ptr)) - 1;
-		dgAssert (info->m_allocator == this);
-
-		dgMemoryBin* const bin = (dgMemoryBin*) info->m_ptr;
-		bin->m_info.m_count ++;
-
 		#ifdef __TRACK_MEMORY_LEAKS__
+		dgSpinLock (&m_lock, false);
 		m_leaklTracker.InsertBlock (dgInt32 (memsize), ptr);
+		dgSpinUnlock (&m_lock);
 		#endif
-
 	}
 	return ptr;
 }
 
 // alloca memory on pool that are quantized to DG_MEMORY_GRANULARITY
 // if memory size is larger than DG_MEMORY_BIN_ENTRIES then the memory is not placed into a pool
+// small blocks go to the calling thread cache, and half the cache is returned to the bins when it is full.
 void dgMemoryAllocator::Free (void* const retPtr)
 {
 	dgMemoryInfo* const info = ((dgMemoryInfo*) (retPtr)) - 1;
@@ -316,70 +577,40 @@ void dgMemoryAllocator::Free (void* const retPtr)
 		FreeLow (retPtr);
 	} else {
 		#ifdef __TRACK_MEMORY_LEAKS__
+		dgSpinLock (&m_lock, false);
 		m_leaklTracker.RemoveBlock (retPtr);
+		dgSpinUnlock (&m_lock);
 		#endif
 
-		dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (((char*)retPtr) - DG_MEMORY_GRANULARITY) ;
-
-		dgMemoryCacheEntry* const tmpCashe = m_memoryDirectory[entry].m_cache;
-		if (tmpCashe) {
-			dgAssert (!tmpCashe->m_prev);
-			tmpCashe->m_prev = cashe;
-		}
-		cashe->m_next = tmpCashe;
-		cashe->m_prev = NULL;
-
-		m_memoryDirectory[entry].m_cache = cashe;
-
+#ifdef _DEBUG
 		dgMemoryBin* const bin = (dgMemoryBin *) info->m_ptr;
-
 		dgAssert (bin);
-#ifdef _DEBUG
 		dgAssert ((bin->m_info.m_stepInBites - DG_MEMORY_GRANULARITY) > 0);
 		memset (retPtr, 0, bin->m_info.m_stepInBites - DG_MEMORY_GRANULARITY);
 #endif
 
-		bin->m_info.m_count --;
-		if (bin->m_info.m_count == 0) {
-
-			dgInt32 count = bin->m_info.m_totalCount;
-			dgInt32 sizeInBytes = bin->m_info.m_stepInBites;
-			char* charPtr = bin->m_pool;
-			for (dgInt32 i = 0; i < count; i ++) {
-				dgMemoryCacheEntry* const tmpCashe1 = (dgMemoryCacheEntry*)charPtr;
-				charPtr += sizeInBytes;
-
-				if (tmpCashe1 == m_memoryDirectory[entry].m_cache) {
-					m_memoryDirectory[entry].m_cache = tmpCashe1->m_next;
-				}
-
-				if (tmpCashe1->m_prev) {
-					tmpCashe1->m_prev->m_next = tmpCashe1->m_next;
-				}
-
-				if (tmpCashe1->m_next) {
-					tmpCashe1->m_next->m_prev = tmpCashe1->m_prev;
-				}
-			}
-
-			if (m_memoryDirectory[entry].m_first == bin) {
-				m_memoryDirectory[entry].m_first = bin->m_info.m_next;
-			}
-
-			if (bin->m_info.m_next) {
-				bin->m_info.m_next->m_info.m_prev = bin->m_info.m_prev;
-			}
-			if (bin->m_info.m_prev) {
-				bin->m_info.m_prev->m_info.m_next = bin->m_info.m_next;
+		dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (((char*)retPtr) - DG_MEMORY_GRANULARITY) ;
+		dgThreadCache* const cache = GetThreadCache();
+		if (cache) {
+			cashe->m_next = cache->m_free[entry];
+			cache->m_free[entry] = cashe;
+			cache->m_count[entry] ++;
+			cache->m_counters[entry].m_freed ++;
+			if (cache->m_count[entry] > DG_MEMORY_THREAD_CACHE_DEPTH) {
+				FlushThreadCache (cache, entry, DG_MEMORY_THREAD_CACHE_DEPTH / 2);
 			}
-
-			FreeLow (bin);
+		} else {
+			// lock free push, the list is only ever detached as a whole so there is not ABA problem
+			dgMemoryCacheEntry* head;
+			do {
+				head = m_remoteFree[entry];
+				cashe->m_next = head;
+			} while (dgInterlockedCompareExchangePointer ((void**) &m_remoteFree[entry], cashe, head) != head);
 		}
 	}
 }
 
 
-
 	// this is a simple memory leak tracker, it uses an flat array of two megabyte indexed by a hatch code
 #ifdef __TRACK_MEMORY_LEAKS__
 
@@ -464,25 +695,133 @@ dgInt32 dgMemoryAllocator::GetGlobalMemoryUsed ()
 	return dgGlobalAllocator::GetGlobalAllocator().GetMemoryUsed();
 }
 
+dgFrameArena::dgFrameArena ()
+	:m_allocator (NULL)
+	,m_first (NULL)
+	,m_current (NULL)
+	,m_offset (0)
+	,m_used (0)
+	,m_capacity (0)
+	,m_highWaterMark (0)
+	,m_allocationsCount (0)
+{
+}
+
+dgFrameArena::~dgFrameArena ()
+{
+	FreeChunks ();
+}
+
+void dgFrameArena::SetAllocator (dgMemoryAllocator* const allocator)
+{
+	dgAssert (!m_first);
+	m_allocator = allocator;
+}
+
+void dgFrameArena::FreeChunks ()
+{
+	dgChunk* next;
+	for (dgChunk* chunk = m_first; chunk; chunk = next) {
+		next = chunk->m_next;
+		m_allocator->FreeLow (chunk);
+	}
+	m_first = NULL;
+	m_current = NULL;
+	m_offset = 0;
+	m_capacity = 0;
+}
+
+void dgFrameArena::AllocChunk (dgInt32 sizeInBytes)
+{
+	dgAssert (m_allocator);
+	dgAssert (!(sizeInBytes & (DG_FRAME_ARENA_ALIGNMENT - 1)));
+	dgChunk* const chunk = (dgChunk*) m_allocator->MallocLow (sizeInBytes + DG_FRAME_ARENA_ALIGNMENT, DG_FRAME_ARENA_ALIGNMENT);
+	chunk->m_size = sizeInBytes;
+	if (m_current) {
+		chunk->m_next = m_current->m_next;
+		m_current->m_next = chunk;
+	} else {
+		dgAssert (!m_first);
+		chunk->m_next = NULL;
+		m_first = chunk;
+	}
+	m_current = chunk;
+	m_offset = 0;
+	m_capacity += sizeInBytes;
+	m_allocationsCount ++;
+}
+
+// this discards all allocated memory, it can only be called outside the world update
+void dgFrameArena::Reserve (dgInt32 sizeInBytes)
+{
+	sizeInBytes = (sizeInBytes + DG_FRAME_ARENA_GRANULARITY - 1) & -DG_FRAME_ARENA_GRANULARITY;
+	if (sizeInBytes > m_capacity) {
+		FreeChunks ();
+		AllocChunk (sizeInBytes);
+	}
+	Reset ();
+}
+
+void dgFrameArena::Reset ()
+{
+	if (m_first && m_first->m_next) {
+		// the last frames did not fit in one chunk, merge them in a single one large enough for the high water mark
+		FreeChunks ();
+		AllocChunk ((m_highWaterMark + DG_FRAME_ARENA_GRANULARITY - 1) & -DG_FRAME_ARENA_GRANULARITY);
+	}
+	m_current = m_first;
+	m_offset = 0;
+	m_used = 0;
+}
+
+void* dgFrameArena::Alloc (dgInt32 sizeInBytes)
+{
+	sizeInBytes = (sizeInBytes + DG_FRAME_ARENA_ALIGNMENT - 1) & -DG_FRAME_ARENA_ALIGNMENT;
+	if (!m_current || ((m_offset + sizeInBytes) > m_current->m_size)) {
+		dgChunk* const next = m_current ? m_current->m_next : NULL;
+		if (next && (next->m_size >= sizeInBytes)) {
+			m_current = next;
+			m_offset = 0;
+		} else {
+			AllocChunk (dgMax (sizeInBytes, dgMax (m_capacity, DG_FRAME_ARENA_GRANULARITY)));
+		}
+	}
+
+	void* const ptr = GetChunkMemory (m_current) + m_offset;
+	m_offset += sizeInBytes;
+	m_used += sizeInBytes;
+	m_highWaterMark = dgMax (m_highWaterMark, m_used);
+	return ptr;
+}
+
+dgInt32 dgFrameArena::GetCapacity () const
+{
+	return m_capacity;
+}
+
+dgInt32 dgFrameArena::GetHighWaterMark () const
+{
+	return m_highWaterMark;
+}
+
+dgInt32 dgFrameArena::GetAllocationsCount () const
+{
+	return m_allocationsCount;
+}
+
+
 // this can be used by function that allocates large memory pools memory locally on the stack
 // this by pases the pool allocation because this should only be used for very large memory blocks.
 // this was using virtual memory on windows but 
 // but because of many complaint I changed it to use malloc and free
 void* dgApi dgMallocStack (size_t size)
 {
-	DG_MEMORY_THREAD_SANITY_CHECK_LOCK();
-	void * const ptr = dgGlobalAllocator::GetGlobalAllocator().MallocLow (dgInt32 (size));
-	DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK();
-	return ptr;
+	return dgGlobalAllocator::GetGlobalAllocator().MallocLow (dgInt32 (size));
 }
 
 void* dgApi dgMallocAligned (size_t size, dgInt32 align)
 {
-	DG_MEMORY_THREAD_SANITY_CHECK_LOCK();
-	void * const ptr = dgGlobalAllocator::GetGlobalAllocator().MallocLow (dgInt32 (size), align);
-	DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK();
-	return ptr;
-	
+	return dgGlobalAllocator::GetGlobalAllocator().MallocLow (dgInt32 (size), align);
 }
 
 // this can be used by function that allocates large memory pools memory locally on the stack
@@ -491,9 +830,7 @@ void* dgApi dgMallocAligned (size_t size, dgInt32 align)
 // but because of many complaint I changed it to use malloc and free
 void  dgApi dgFreeStack (void* const ptr)
 {
-	DG_MEMORY_THREAD_SANITY_CHECK_LOCK();
 	dgGlobalAllocator::GetGlobalAllocator().FreeLow (ptr);
-	DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK();
 }
 
 
@@ -503,12 +840,9 @@ void* dgApi dgMalloc (size_t size, dgMemoryAllocator* const allocator)
 	void* ptr = NULL;
 	dgAssert (allocator);
 
-	DG_MEMORY_THREAD_SANITY_CHECK_LOCK();
 	if (size) {
 		ptr = allocator->Malloc (dgInt32 (size));
 	}
-
-	DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK();
 	return ptr;
 }
 
@@ -517,12 +851,10 @@ void* dgApi dgMalloc (size_t size, dgMemoryAllocator* const allocator)
 void dgApi dgFree (void* const ptr)
 {
 	if (ptr) {
-		DG_MEMORY_THREAD_SANITY_CHECK_LOCK();
 		dgMemoryAllocator::dgMemoryInfo* info;
 		info = ((dgMemoryAllocator::dgMemoryInfo*) ptr) - 1; 
 		dgAssert (info->m_allocator);
 		info->m_allocator->Free (ptr);
-		DG_MEMORY_THREAD_SANITY_CHECK_UNLOCK();
 	}
 }
 
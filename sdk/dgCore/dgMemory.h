@@ -75,12 +75,24 @@ class dgMemoryAllocator
 	#define DG_MEMORY_SIZE						(1024 - 64)
 	#define DG_MEMORY_BIN_SIZE					(1024 * 16)
 	#define DG_MEMORY_BIN_ENTRIES				(DG_MEMORY_SIZE / DG_MEMORY_GRANULARITY)
+	#define DG_MEMORY_THREAD_CACHES				64
+	#define DG_MEMORY_THREAD_CACHE_DEPTH		32
 
 	public: 
 	class dgMemoryBin;
 	class dgMemoryInfo;
+	class dgThreadCache;
 	class dgMemoryCacheEntry;
 
+	class dgBinCounters
+	{
+		public:
+		dgInt64 m_hits;
+		dgInt64 m_misses;
+		dgInt64 m_allocated;
+		dgInt64 m_freed;
+	};
+
 	class dgMemDirectory
 	{
 		public: 
@@ -128,24 +140,54 @@ class dgMemoryAllocator
 	virtual void *Malloc (dgInt32 memsize);
 	virtual void Free (void* const retPtr);
 
+	void GetBinCounters (dgInt32 entry, dgInt32& blockSizeInBytes, dgInt64& hits, dgInt64& misses, dgInt64& bytesLive) const;
+
 	static dgInt32 GetGlobalMemoryUsed ();
 	static void SetGlobalAllocators (dgMemAlloc alloc, dgMemFree free);
+	static dgInt32 GetBinCount ();
+
+	// threads that call the allocator get a cache slot on first use, the slot is released 
+	// when the thread exits. a thread that stops using the allocators can release it earlier.
+	static void ReleaseThreadCacheSlot ();
 
 	protected:
 	dgMemoryAllocator (bool init)
 	{	
 		m_memoryUsed = 0;
 		m_isInList = false;
+		m_lock = 0;
+		memset (m_threadCaches, 0, sizeof (m_threadCaches));
+		memset (m_remoteFree, 0, sizeof (m_remoteFree));
+		memset (m_counters, 0, sizeof (m_counters));
 	}
 	dgMemoryAllocator (dgMemAlloc memAlloc, dgMemFree memFree);
 
+	private:
+	void Init ();
+	void* MallocBin (dgInt32 entry, dgInt32 memsize);
+	void FreeBin (dgMemoryCacheEntry* const cashe);
+	void FreeRemoteBlocks (dgInt32 entry);
+	void FlushThreadCache (dgThreadCache* const cache, dgInt32 entry, dgInt32 keepCount);
+	void RefillThreadCache (dgThreadCache* const cache, dgInt32 entry, dgInt32 memsize);
+	void FreeThreadCaches ();
+	dgThreadCache* GetThreadCache ();
+
+	protected:
 	dgInt32 m_emumerator;
 	dgInt32 m_memoryUsed;
+	dgInt32 m_lock;
 	bool m_isInList;
 	dgMemFree m_free;
 	dgMemAlloc m_malloc;
 	dgMemDirectory m_memoryDirectory[DG_MEMORY_BIN_ENTRIES + 1]; 
 
+	// per thread free lists in front of the bins, only the thread owning the slot touches its cache 
+	dgThreadCache* m_threadCaches[DG_MEMORY_THREAD_CACHES];
+	// blocks released by threads without a cache slot, pushed without locking 
+	dgMemoryCacheEntry* m_remoteFree[DG_MEMORY_BIN_ENTRIES];
+	// counters of the threads without a cache slot 
+	dgBinCounters m_counters[DG_MEMORY_BIN_ENTRIES];
+
 #ifdef __TRACK_MEMORY_LEAKS__
 	dgMemoryLeaksTracker m_leaklTracker;
 #endif
@@ -198,5 +240,112 @@ class dgStackMemoryAllocator: public dgMemoryAllocator
 	dgInt32 m_size;
 };
 
+
+// linear allocator for memory that only lives during one world update.
+// memory is released in stack order with markers, and all at once by Reset.
+// when a frame does not fit, the extra chunks are allocated from the allocator
+// and merged into a single chunk on the next Reset, so that a steady state frame
+// never calls the general purpose allocator.
+class dgFrameArena
+{
+	#define DG_FRAME_ARENA_ALIGNMENT	64
+	#define DG_FRAME_ARENA_GRANULARITY	(1024 * 64)
+
+	public:
+	class dgChunk
+	{
+		public:
+		dgChunk* m_next;
+		dgInt32 m_size;
+	};
+
+	class dgMarker
+	{
+		public:
+		dgChunk* m_chunk;
+		dgInt32 m_offset;
+		dgInt32 m_used;
+	};
+
+	dgFrameArena ();
+	~dgFrameArena ();
+
+	DG_CLASS_ALLOCATOR(allocator)
+
+	void SetAllocator (dgMemoryAllocator* const allocator);
+	void Reserve (dgInt32 sizeInBytes);
+	void Reset ();
+
+	void* Alloc (dgInt32 sizeInBytes);
+	DG_INLINE dgMarker GetMarker () const;
+	DG_INLINE void Release (const dgMarker& marker);
+
+	dgInt32 GetCapacity () const;
+	dgInt32 GetHighWaterMark () const;
+	dgInt32 GetAllocationsCount () const;
+
+	private:
+	void AllocChunk (dgInt32 sizeInBytes);
+	void FreeChunks ();
+	DG_INLINE dgInt8* GetChunkMemory (dgChunk* const chunk) const;
+
+	dgMemoryAllocator* m_allocator;
+	dgChunk* m_first;
+	dgChunk* m_current;
+	dgInt32 m_offset;
+	dgInt32 m_used;
+	dgInt32 m_capacity;
+	dgInt32 m_highWaterMark;
+	dgInt32 m_allocationsCount;
+};
+
+// releases all memory allocated from the arena during the life of the scope
+class dgFrameArenaScope
+{
+	public:
+	DG_INLINE dgFrameArenaScope (dgFrameArena* const arena)
+		:m_arena (arena)
+		,m_marker (arena->GetMarker())
+	{
+	}
+
+	DG_INLINE ~dgFrameArenaScope ()
+	{
+		m_arena->Release (m_marker);
+	}
+
+	template<class T>
+	DG_INLINE T* Alloc (dgInt32 count)
+	{
+		return (T*) m_arena->Alloc (dgInt32 (count * sizeof (T)));
+	}
+
+	private:
+	dgFrameArena* m_arena;
+	dgFrameArena::dgMarker m_marker;
+};
+
+DG_INLINE dgInt8* dgFrameArena::GetChunkMemory (dgChunk* const chunk) const
+{
+	return ((dgInt8*) chunk) + DG_FRAME_ARENA_ALIGNMENT;
+}
+
+DG_INLINE dgFrameArena::dgMarker dgFrameArena::GetMarker () const
+{
+	dgMarker marker;
+	marker.m_chunk = m_current;
+	marker.m_offset = m_offset;
+	marker.m_used = m_used;
+	return marker;
+}
+
+DG_INLINE void dgFrameArena::Release (const dgMarker& marker)
+{
+	// chunks after the marker stay linked, and are reused by the following allocations
+	m_current = marker.m_chunk ? marker.m_chunk : m_first;
+	m_offset = marker.m_chunk ? marker.m_offset : 0;
+	m_used = marker.m_used;
+}
+
 #endif
 
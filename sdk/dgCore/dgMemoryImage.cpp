@@ -0,0 +1,159 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgStdafx.h"
+#include "dgMemoryImage.h"
+
+
+dgMemoryImageWriter::dgMemoryImageWriter (dgMemoryAllocator* const allocator, dgInt32 type)
+	:m_stream (allocator)
+	,m_streamSize(0)
+	,m_sectionsCount(0)
+	,m_type(type)
+{
+}
+
+void dgMemoryImageWriter::AddSection (const void* const data, dgInt64 sizeInBytes)
+{
+	dgAssert (m_sectionsCount < DG_MEMORY_IMAGE_MAX_SECTIONS);
+	m_sections[m_sectionsCount] = data;
+	m_sectionSize[m_sectionsCount] = sizeInBytes;
+	m_sectionsCount ++;
+}
+
+void dgApi dgMemoryImageWriter::SerializeStream (void* const writer, const void* const buffer, dgInt32 size)
+{
+	dgMemoryImageWriter* const me = (dgMemoryImageWriter*) writer;
+	if (size) {
+		me->m_stream[me->m_streamSize + size - 1] = 0;
+		memcpy (&me->m_stream[me->m_streamSize], buffer, size);
+		me->m_streamSize += size;
+	}
+}
+
+void dgMemoryImageWriter::Write (dgSerialize callback, void* const userData) const
+{
+	dgMemoryImageHeader header;
+	memset (&header, 0, sizeof (header));
+	header.m_magic = DG_MEMORY_IMAGE_MAGIC;
+	header.m_version = DG_MEMORY_IMAGE_VERSION;
+	header.m_type = m_type;
+	header.m_revision = m_currentRevision;
+	header.m_sectionsCount = m_sectionsCount;
+
+	dgInt64 offset = (sizeof (dgMemoryImageHeader) + DG_MEMORY_IMAGE_ALIGMENT - 1) & -DG_MEMORY_IMAGE_ALIGMENT;
+	header.m_streamOffset = offset;
+	header.m_streamSize = m_streamSize;
+	offset = (offset + m_streamSize + DG_MEMORY_IMAGE_ALIGMENT - 1) & -DG_MEMORY_IMAGE_ALIGMENT;
+	for (dgInt32 i = 0; i < m_sectionsCount; i ++) {
+		header.m_sectionOffset[i] = offset;
+		header.m_sectionSize[i] = m_sectionSize[i];
+		offset = (offset + m_sectionSize[i] + DG_MEMORY_IMAGE_ALIGMENT - 1) & -DG_MEMORY_IMAGE_ALIGMENT;
+	}
+	header.m_sizeInBytes = offset;
+
+	dgInt8 padding[DG_MEMORY_IMAGE_ALIGMENT];
+	memset (padding, 0, sizeof (padding));
+
+	callback (userData, &header, sizeof (header));
+	dgInt64 position = sizeof (header);
+	callback (userData, padding, dgInt32 (header.m_streamOffset - position));
+	if (m_streamSize) {
+		callback (userData, &m_stream[0], m_streamSize);
+	}
+	position = header.m_streamOffset + m_streamSize;
+	for (dgInt32 i = 0; i < m_sectionsCount; i ++) {
+		callback (userData, padding, dgInt32 (header.m_sectionOffset[i] - position));
+		// sections larger than the callback size are written in pieces
+		const dgInt8* const data = (dgInt8*) m_sections[i];
+		for (dgInt64 j = 0; j < m_sectionSize[i]; j += 0x40000000) {
+			callback (userData, &data[j], dgInt32 (dgMin (m_sectionSize[i] - j, dgInt64 (0x40000000))));
+		}
+		position = header.m_sectionOffset[i] + m_sectionSize[i];
+	}
+	callback (userData, padding, dgInt32 (header.m_sizeInBytes - position));
+}
+
+
+dgMemoryImageReader::dgMemoryImageReader (const void* const image, dgInt64 sizeInBytes)
+	:m_image ((const dgInt8*) image)
+	,m_header ((const dgMemoryImageHeader*) image)
+	,m_streamPosition(0)
+	,m_sectionIndex(0)
+	,m_valid(false)
+{
+	// reject images of a different version or byte order, and images that are not aligned or that are truncated
+	if (image && !(size_t (image) & 15) && (sizeInBytes >= dgInt64 (sizeof (dgMemoryImageHeader)))) {
+		const dgMemoryImageHeader& header = *m_header;
+		m_valid = (header.m_magic == DG_MEMORY_IMAGE_MAGIC) && (header.m_version == DG_MEMORY_IMAGE_VERSION) && 
+				  (header.m_sizeInBytes <= sizeInBytes) && (header.m_sectionsCount >= 0) && (header.m_sectionsCount <= DG_MEMORY_IMAGE_MAX_SECTIONS) &&
+				  (header.m_streamOffset >= dgInt64 (sizeof (dgMemoryImageHeader))) && ((header.m_streamOffset + header.m_streamSize) <= header.m_sizeInBytes);
+		for (dgInt32 i = 0; m_valid && (i < header.m_sectionsCount); i ++) {
+			m_valid = (header.m_sectionOffset[i] >= 0) && !(header.m_sectionOffset[i] & (DG_MEMORY_IMAGE_ALIGMENT - 1)) && 
+					  (header.m_sectionSize[i] >= 0) && ((header.m_sectionOffset[i] + header.m_sectionSize[i]) <= header.m_sizeInBytes);
+		}
+	}
+}
+
+bool dgMemoryImageReader::IsValid () const
+{
+	return m_valid;
+}
+
+void dgMemoryImageReader::SetInvalid () const
+{
+	m_valid = false;
+}
+
+dgInt32 dgMemoryImageReader::GetType () const
+{
+	dgAssert (m_valid);
+	return m_header->m_type;
+}
+
+dgInt32 dgMemoryImageReader::GetRevision () const
+{
+	dgAssert (m_valid);
+	return m_header->m_revision;
+}
+
+const void* dgMemoryImageReader::ReadSection (dgInt64 sizeInBytes) const
+{
+	if (m_valid && (m_sectionIndex < m_header->m_sectionsCount) && (m_header->m_sectionSize[m_sectionIndex] == sizeInBytes)) {
+		const void* const section = &m_image[m_header->m_sectionOffset[m_sectionIndex]];
+		m_sectionIndex ++;
+		return section;
+	}
+	m_valid = false;
+	return NULL;
+}
+
+void dgApi dgMemoryImageReader::DeserializeStream (void* const reader, void* buffer, dgInt32 size)
+{
+	const dgMemoryImageReader* const me = (dgMemoryImageReader*) reader;
+	if (me->m_valid && ((me->m_streamPosition + size) <= me->m_header->m_streamSize)) {
+		memcpy (buffer, &me->m_image[me->m_header->m_streamOffset + me->m_streamPosition], size);
+		me->m_streamPosition += size;
+	} else {
+		me->m_valid = false;
+		memset (buffer, 0, size);
+	}
+}
@@ -0,0 +1,100 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef __dgMemoryImage__
+#define __dgMemoryImage__
+
+#include "dgStdafx.h"
+#include "dgMemory.h"
+#include "dgArray.h"
+
+#define DG_MEMORY_IMAGE_MAGIC			0x4d49444e
+#define DG_MEMORY_IMAGE_VERSION			1
+#define DG_MEMORY_IMAGE_MAX_SECTIONS	16
+#define DG_MEMORY_IMAGE_ALIGMENT		64
+
+
+// a memory image is a position independent block made of a header, a description stream and a list of data sections.
+// all offsets are relative to the beginning of the image, and each section is aligned to DG_MEMORY_IMAGE_ALIGMENT bytes, 
+// so that an image loaded or memory mapped at any 16 byte aligned address can be used in place.
+class dgMemoryImageHeader
+{
+	public:
+	dgUnsigned32 m_magic;
+	dgInt32 m_version;
+	dgInt32 m_type;
+	dgInt32 m_revision;
+	dgInt32 m_sectionsCount;
+	dgInt32 m_reserved[3];
+	dgInt64 m_sizeInBytes;
+	dgInt64 m_streamOffset;
+	dgInt64 m_streamSize;
+	dgInt64 m_sectionOffset[DG_MEMORY_IMAGE_MAX_SECTIONS];
+	dgInt64 m_sectionSize[DG_MEMORY_IMAGE_MAX_SECTIONS];
+};
+
+class dgMemoryImageWriter
+{
+	public:
+	dgMemoryImageWriter (dgMemoryAllocator* const allocator, dgInt32 type);
+
+	// the data of the sections is not copied, it must be valid until the image is written
+	void AddSection (const void* const data, dgInt64 sizeInBytes);
+	void Write (dgSerialize callback, void* const userData) const;
+
+	// dgSerialize callback to add data to the description stream
+	static void dgApi SerializeStream (void* const writer, const void* const buffer, dgInt32 size);
+
+	private:
+	dgArray<dgInt8> m_stream;
+	const void* m_sections[DG_MEMORY_IMAGE_MAX_SECTIONS];
+	dgInt64 m_sectionSize[DG_MEMORY_IMAGE_MAX_SECTIONS];
+	dgInt32 m_streamSize;
+	dgInt32 m_sectionsCount;
+	dgInt32 m_type;
+};
+
+class dgMemoryImageReader
+{
+	public:
+	dgMemoryImageReader (const void* const image, dgInt64 sizeInBytes);
+
+	bool IsValid () const;
+	void SetInvalid () const;
+	dgInt32 GetType () const;
+	dgInt32 GetRevision () const;
+
+	// sections are read in the same order they were added, a section of a different size invalidates the image  
+	const void* ReadSection (dgInt64 sizeInBytes) const;
+
+	// dgDeserialize callback to read data from the description stream
+	static void dgApi DeserializeStream (void* const reader, void* buffer, dgInt32 size);
+
+	private:
+	const dgInt8* m_image;
+	const dgMemoryImageHeader* m_header;
+	mutable dgInt64 m_streamPosition;
+	mutable dgInt32 m_sectionIndex;
+	mutable bool m_valid;
+};
+
+#endif
+
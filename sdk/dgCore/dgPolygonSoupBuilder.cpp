@@ -29,6 +29,7 @@
 #include "dgMatrix.h"
 #include "dgMemory.h"
 #include "dgPolyhedra.h"
+#include "dgThreadHive.h"
 #include "dgPolygonSoupBuilder.h"
 
 #define DG_POINTS_RUN (512 * 1024)
@@ -82,6 +83,26 @@ class dgPolygonSoupDatabaseBuilder::dgFaceMap: public dgTree<dgFaceBucket, dgInt
 };
 
 
+// a group of faces with the same attribute that is merged independently of the others
+class dgPolygonSoupDatabaseBuilder::dgFacePartition
+{
+	public:
+	dgInt32 m_faceId;
+	dgInt32 m_start;
+	dgInt32 m_count;
+	dgPolygonSoupDatabaseBuilder* m_optimizedFaces;
+};
+
+class dgPolygonSoupDatabaseBuilder::dgOptimizeDescriptor
+{
+	public:
+	const dgPolygonSoupDatabaseBuilder* m_source;
+	const dgFaceInfo** m_faces;
+	dgFacePartition* m_partitions;
+	dgInt32 m_partitionsCount;
+	dgInt32 m_atomicIndex;
+};
+
 class dgPolygonSoupDatabaseBuilder::dgPolySoupFilterAllocator: public dgPolyhedra
 {
 	public: 
@@ -464,17 +485,44 @@ void dgPolygonSoupDatabaseBuilder::OptimizeByIndividualFaces()
 }
 
 
-void dgPolygonSoupDatabaseBuilder::End(bool optimize)
+void dgPolygonSoupDatabaseBuilder::End(bool optimize, dgThreadHive* const threadPool)
 {
 	if (optimize) {
 		dgPolygonSoupDatabaseBuilder copy (*this);
 		dgFaceMap faceMap (m_allocator, copy);
 
-		Begin();
+		dgInt32 facesCount = 0;
+		dgInt32 partitionsCount = 0;
+		dgStack<const dgFaceInfo*> faces (copy.m_faceCount + 1);
+		dgStack<dgFacePartition> partitions (copy.m_faceCount + 1);
 		dgFaceMap::Iterator iter (faceMap);
 		for (iter.Begin(); iter; iter ++) {
 			const dgFaceBucket& bucket = iter.GetNode()->GetInfo();
-			Optimize(iter.GetNode()->GetKey(), bucket, copy);
+			partitionsCount += PartitionFaces (iter.GetNode()->GetKey(), bucket, copy, &faces[0], facesCount, &partitions[partitionsCount]);
+			facesCount += bucket.GetCount();
+		}
+
+		// the partitions are merged in parallel and added back in order, so the result does not depend on the threads count
+		dgOptimizeDescriptor descriptor;
+		descriptor.m_source = &copy;
+		descriptor.m_faces = &faces[0];
+		descriptor.m_partitions = &partitions[0];
+		descriptor.m_partitionsCount = partitionsCount;
+		descriptor.m_atomicIndex = 0;
+		if (threadPool) {
+			const dgInt32 threadsCount = dgMin (threadPool->GetThreadCount(), partitionsCount);
+			for (dgInt32 i = 0; i < threadsCount; i ++) {
+				threadPool->QueueJob (OptimizeKernel, &descriptor, this);
+			}
+			threadPool->SynchronizationBarrier();
+		} else {
+			OptimizeKernel (&descriptor, this, 0);
+		}
+
+		Begin();
+		for (dgInt32 i = 0; i < partitionsCount; i ++) {
+			AddOptimizedFaces (partitions[i].m_faceId, *partitions[i].m_optimizedFaces);
+			delete partitions[i].m_optimizedFaces;
 		}
 	}
 	Finalize();
@@ -511,23 +559,29 @@ void dgPolygonSoupDatabaseBuilder::End(bool optimize)
 }
 
 
-void dgPolygonSoupDatabaseBuilder::Optimize(dgInt32 faceId, const dgFaceBucket& faceBucket, const dgPolygonSoupDatabaseBuilder& source)
+
+dgInt32 dgPolygonSoupDatabaseBuilder::PartitionFaces (dgInt32 faceId, const dgFaceBucket& faceBucket, const dgPolygonSoupDatabaseBuilder& source, const dgFaceInfo** const faceArray, dgInt32 faceBase, dgFacePartition* const partitions) const
 {
 	#define DG_MESH_PARTITION_SIZE (1024 * 4)
 
 	const dgInt32* const indexArray = &source.m_vertexIndex[0];
 	const dgBigVector* const points = &source.m_vertexPoints[0];
 
-	dgVector face[256];
-	dgInt32 faceIndex[256];
-	if (faceBucket.GetCount() >= DG_MESH_PARTITION_SIZE) {
-		dgStack<dgFaceBucket::dgListNode*> array(faceBucket.GetCount());
-		dgInt32 count = 0;
-		for (dgFaceBucket::dgListNode* node = faceBucket.GetFirst(); node; node = node->GetNext()) {
-			array[count] = node;
-			count ++;
-		}
+	const dgFaceInfo** const array = &faceArray[faceBase];
+	dgInt32 count = 0;
+	for (dgFaceBucket::dgListNode* node = faceBucket.GetFirst(); node; node = node->GetNext()) {
+		array[count] = &node->GetInfo();
+		count ++;
+	}
 
+	dgInt32 partitionsCount = 0;
+	if (count < DG_MESH_PARTITION_SIZE) {
+		partitions[0].m_faceId = faceId;
+		partitions[0].m_start = faceBase;
+		partitions[0].m_count = count;
+		partitions[0].m_optimizedFaces = NULL;
+		partitionsCount = 1;
+	} else {
 		dgInt32 stack = 1;
 		dgInt32 segments[32][2];
 			
@@ -540,43 +594,17 @@ void dgPolygonSoupDatabaseBuilder::Optimize(dgInt32 faceId, const dgFaceBucket&
 			dgInt32 faceCount = segments[stack][1];
 
 			if (faceCount <= DG_MESH_PARTITION_SIZE) {
-
-				dgPolygonSoupDatabaseBuilder tmpBuilder (m_allocator);
-				for (dgInt32 i = 0; i < faceCount; i ++) {
-					const dgFaceInfo& faceInfo = array[faceStart + i]->GetInfo();
-
-					dgInt32 count1 = faceInfo.indexCount - 1;
-					dgInt32 start1 = faceInfo.indexStart;
-					dgAssert (faceId == indexArray[start1 + count1]);
-					for (dgInt32 j = 0; j < count1; j ++) {
-						dgInt32 index = indexArray[start1 + j];
-						face[j] = points[index];
-						faceIndex[j] = j;
-					}
-					dgInt32 faceIndexCount = count1;
-					tmpBuilder.AddMesh (&face[0].m_x, count1, sizeof (dgVector), 1, &faceIndexCount, &faceIndex[0], &faceId, dgGetIdentityMatrix()); 
-				}
-				tmpBuilder.FinalizeAndOptimize ();
-
-				dgInt32 faceIndexNumber = 0;
-				for (dgInt32 i = 0; i < tmpBuilder.m_faceCount; i ++) {
-					dgInt32 indexCount = tmpBuilder.m_faceVertexCount[i] - 1;
-					for (dgInt32 j = 0; j < indexCount; j ++) {
-						dgInt32 index = tmpBuilder.m_vertexIndex[faceIndexNumber + j];
-						face[j] = tmpBuilder.m_vertexPoints[index];
-						faceIndex[j] = j;
-					}
-					dgInt32 faceArray = indexCount;
-					AddMesh (&face[0].m_x, indexCount, sizeof (dgVector), 1, &faceArray, faceIndex, &faceId, dgGetIdentityMatrix());
-
-					faceIndexNumber += (indexCount + 1); 
-				}
+				partitions[partitionsCount].m_faceId = faceId;
+				partitions[partitionsCount].m_start = faceBase + faceStart;
+				partitions[partitionsCount].m_count = faceCount;
+				partitions[partitionsCount].m_optimizedFaces = NULL;
+				partitionsCount ++;
 
 			} else {
 				dgBigVector median (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
 				dgBigVector varian (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
 				for (dgInt32 i = 0; i < faceCount; i ++) {
-					const dgFaceInfo& faceInfo = array[faceStart + i]->GetInfo();
+					const dgFaceInfo& faceInfo = *array[faceStart + i];
 					dgInt32 count1 = faceInfo.indexCount - 1;
 					dgInt32 start1 = faceInfo.indexStart;
 					dgBigVector p0 (dgFloat32 ( 1.0e10f), dgFloat32 ( 1.0e10f), dgFloat32 ( 1.0e10f), dgFloat32 (0.0f));
@@ -614,7 +642,7 @@ void dgPolygonSoupDatabaseBuilder::Optimize(dgInt32 faceId, const dgFaceBucket&
 
 				for (dgInt32 i = 0; i < lastFace; i ++) {
 					dgInt32 side = 0;
-					const dgFaceInfo& faceInfo = array[faceStart + i]->GetInfo();
+					const dgFaceInfo& faceInfo = *array[faceStart + i];
 
 					dgInt32 start1 = faceInfo.indexStart;
 					dgInt32 count1 = faceInfo.indexCount - 1;
@@ -647,38 +675,58 @@ void dgPolygonSoupDatabaseBuilder::Optimize(dgInt32 faceId, const dgFaceBucket&
 				stack ++;
 			}
 		}
-	
-	} else {
-		dgPolygonSoupDatabaseBuilder tmpBuilder (m_allocator);
-		for (dgFaceBucket::dgListNode* node = faceBucket.GetFirst(); node; node = node->GetNext()) {
-			const dgFaceInfo& faceInfo = node->GetInfo();
+	}
+	return partitionsCount;
+}
+
+void dgPolygonSoupDatabaseBuilder::OptimizeKernel (void* const context, void* const builderContext, dgInt32 threadID)
+{
+	dgOptimizeDescriptor* const descriptor = (dgOptimizeDescriptor*) context;
+	dgPolygonSoupDatabaseBuilder* const me = (dgPolygonSoupDatabaseBuilder*) builderContext;
+
+	const dgInt32* const indexArray = &descriptor->m_source->m_vertexIndex[0];
+	const dgBigVector* const points = &descriptor->m_source->m_vertexPoints[0];
+
+	dgVector face[256];
+	dgInt32 faceIndex[256];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < descriptor->m_partitionsCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+		dgFacePartition& partition = descriptor->m_partitions[i];
+		dgPolygonSoupDatabaseBuilder* const tmpBuilder = new (me->m_allocator) dgPolygonSoupDatabaseBuilder (me->m_allocator);
+		for (dgInt32 j = 0; j < partition.m_count; j ++) {
+			const dgFaceInfo& faceInfo = *descriptor->m_faces[partition.m_start + j];
 
 			dgInt32 count = faceInfo.indexCount - 1;
 			dgInt32 start = faceInfo.indexStart;
-			dgAssert (faceId == indexArray[start + count]);
-			for (dgInt32 j = 0; j < count; j ++) {
-				dgInt32 index = indexArray[start + j];
-				face[j] = points[index];
-				faceIndex[j] = j;
+			dgAssert (partition.m_faceId == indexArray[start + count]);
+			for (dgInt32 k = 0; k < count; k ++) {
+				dgInt32 index = indexArray[start + k];
+				face[k] = points[index];
+				faceIndex[k] = k;
 			}
 			dgInt32 faceIndexCount = count;
-			tmpBuilder.AddMesh (&face[0].m_x, count, sizeof (dgVector), 1, &faceIndexCount, &faceIndex[0], &faceId, dgGetIdentityMatrix()); 
+			tmpBuilder->AddMesh (&face[0].m_x, count, sizeof (dgVector), 1, &faceIndexCount, &faceIndex[0], &partition.m_faceId, dgGetIdentityMatrix()); 
 		}
-		tmpBuilder.FinalizeAndOptimize ();
-
-		dgInt32 faceIndexNumber = 0;
-		for (dgInt32 i = 0; i < tmpBuilder.m_faceCount; i ++) {
-			dgInt32 indexCount = tmpBuilder.m_faceVertexCount[i] - 1;
-			for (dgInt32 j = 0; j < indexCount; j ++) {
-				dgInt32 index = tmpBuilder.m_vertexIndex[faceIndexNumber + j];
-				face[j] = tmpBuilder.m_vertexPoints[index];
-				faceIndex[j] = j;
-			}
-			dgInt32 faceArray = indexCount;
-			AddMesh (&face[0].m_x, indexCount, sizeof (dgVector), 1, &faceArray, faceIndex, &faceId, dgGetIdentityMatrix());
+		tmpBuilder->FinalizeAndOptimize ();
+		partition.m_optimizedFaces = tmpBuilder;
+	}
+}
 
-			faceIndexNumber += (indexCount + 1); 
+void dgPolygonSoupDatabaseBuilder::AddOptimizedFaces (dgInt32 faceId, const dgPolygonSoupDatabaseBuilder& optimizedFaces)
+{
+	dgVector face[256];
+	dgInt32 faceIndex[256];
+	dgInt32 faceIndexNumber = 0;
+	for (dgInt32 i = 0; i < optimizedFaces.m_faceCount; i ++) {
+		dgInt32 indexCount = optimizedFaces.m_faceVertexCount[i] - 1;
+		for (dgInt32 j = 0; j < indexCount; j ++) {
+			dgInt32 index = optimizedFaces.m_vertexIndex[faceIndexNumber + j];
+			face[j] = optimizedFaces.m_vertexPoints[index];
+			faceIndex[j] = j;
 		}
+		dgInt32 faceArray = indexCount;
+		AddMesh (&face[0].m_x, indexCount, sizeof (dgVector), 1, &faceArray, faceIndex, &faceId, dgGetIdentityMatrix());
+
+		faceIndexNumber += (indexCount + 1); 
 	}
 }
 
@@ -33,6 +33,7 @@
 #include "dgArray.h"
 #include "dgIntersections.h"
 
+class dgThreadHive;
 
 class AdjacentdFace
 {
@@ -49,6 +50,8 @@ class dgPolygonSoupDatabaseBuilder
 	class dgFaceInfo;
 	class dgFaceBucket;
 	class dgPolySoupFilterAllocator;
+	class dgFacePartition;
+	class dgOptimizeDescriptor;
 	public:
 
 	dgPolygonSoupDatabaseBuilder (dgMemoryAllocator* const allocator);
@@ -58,12 +61,14 @@ class dgPolygonSoupDatabaseBuilder
 	DG_CLASS_ALLOCATOR(allocator)
 
 	void Begin();
-	void End(bool optimize);
+	void End(bool optimize, dgThreadHive* const threadPool = NULL);
 	void AddMesh (const dgFloat32* const vertex, dgInt32 vertexCount, dgInt32 strideInBytes, dgInt32 faceCount, 
 		          const dgInt32* const faceArray, const dgInt32* const indexArray, const dgInt32* const faceTagsData, const dgMatrix& worldMatrix); 
 
 	private:
-	void Optimize(dgInt32 faceId, const dgFaceBucket& faceBucket, const dgPolygonSoupDatabaseBuilder& source);
+	dgInt32 PartitionFaces (dgInt32 faceId, const dgFaceBucket& faceBucket, const dgPolygonSoupDatabaseBuilder& source, const dgFaceInfo** const faceArray, dgInt32 faceBase, dgFacePartition* const partitions) const;
+	void AddOptimizedFaces (dgInt32 faceId, const dgPolygonSoupDatabaseBuilder& optimizedFaces);
+	static void OptimizeKernel (void* const context, void* const builderContext, dgInt32 threadID);
 
 	void Finalize();
 	void FinalizeAndOptimize();
@@ -59,6 +59,9 @@ class dgPolygonSoupDatabase
 	dgInt32 m_vertexCount;
 	dgInt32 m_strideInBytes;
 	dgFloat32* m_localVertex;
+
+	// the arrays are part of a read only memory image owned by the application
+	bool m_memoryImage;
 };
 
 
@@ -67,11 +70,12 @@ inline dgPolygonSoupDatabase::dgPolygonSoupDatabase(const char* const name)
 	m_vertexCount = 0;
 	m_strideInBytes = 0;
 	m_localVertex = NULL;
+	m_memoryImage = false;
 }
 
 inline dgPolygonSoupDatabase::~dgPolygonSoupDatabase ()
 {
-	if (m_localVertex) {
+	if (m_localVertex && !m_memoryImage) {
 		dgFreeStack (m_localVertex);
 	}
 }
@@ -84,8 +88,11 @@ inline dgUnsigned32 dgPolygonSoupDatabase::GetTagId(const dgInt32* const face, d
 
 inline void dgPolygonSoupDatabase::SetTagId(const dgInt32* const facePtr, dgInt32 indexCount, dgUnsigned32 newID) const
 {
-	dgUnsigned32* const face = (dgUnsigned32*) facePtr;
-	face[indexCount] = newID;
+	dgAssert (!m_memoryImage);
+	if (!m_memoryImage) {
+		dgUnsigned32* const face = (dgUnsigned32*) facePtr;
+		face[indexCount] = newID;
+	}
 }
 
 inline dgInt32 dgPolygonSoupDatabase::GetVertexCount()	const
@@ -21,6 +21,12 @@
 
 #include "dgStdafx.h"
 #include "dgThread.h"
+#include "dgMemory.h"
+
+#if (defined (_POSIX_VER) || defined (_POSIX_VER_64)) && !defined (DG_USE_THREAD_EMULATION)
+	#include <sched.h>
+	#include <pthread.h>
+#endif
 
 
 
@@ -28,6 +34,7 @@ dgThread::dgThread ()
 	:m_id(0)
 	,m_terminate(0)
 	,m_threadRunning(0)
+	,m_affinitySaved(0)
 {
 	m_name[0] = 0;
 }
@@ -36,6 +43,7 @@ dgThread::dgThread (const char* const name, dgInt32 id)
 	:m_id(id)
 	,m_terminate(0)
 	,m_threadRunning(0)
+	,m_affinitySaved(0)
 {
 	strncpy (m_name, name, sizeof (m_name) - 1);
 }
@@ -99,6 +107,25 @@ void* dgThread::dgThreadSystemCallback(void* threadData)
 	return 0;
 }
 
+bool dgThread::SetAffinity (const dgInt32* const processors, dgInt32 count)
+{
+	return false;
+}
+
+void dgThread::RestoreAffinity ()
+{
+}
+
+dgInt32 dgThread::GetProcessorsCount ()
+{
+	return 1;
+}
+
+dgInt32 dgThread::GetProcessorPackage (dgInt32 processor)
+{
+	return 0;
+}
+
 #else  
 
 dgThread::dgSemaphore::dgSemaphore ()
@@ -171,6 +198,98 @@ void* dgThread::dgThreadSystemCallback(void* threadData)
 	return 0;
 }
 
+bool dgThread::SetAffinity (const dgInt32* const processors, dgInt32 count)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		DWORD_PTR mask = 0;
+		for (dgInt32 i = 0; i < count; i ++) {
+			if (processors[i] < dgInt32 (sizeof (DWORD_PTR) * 8)) {
+				mask |= DWORD_PTR (1) << processors[i];
+			}
+		}
+		if (!mask) {
+			return false;
+		}
+		DWORD_PTR const oldMask = SetThreadAffinityMask (m_handle.native_handle(), mask);
+		if (oldMask && !m_affinitySaved) {
+			m_savedAffinity[0] = dgUnsigned64 (oldMask);
+			m_affinitySaved = 1;
+		}
+		return oldMask ? true : false;
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64))
+		dgAssert (sizeof (cpu_set_t) <= sizeof (m_savedAffinity));
+		if (!m_affinitySaved) {
+			m_affinitySaved = (pthread_getaffinity_np (m_handle.native_handle(), sizeof (cpu_set_t), (cpu_set_t*) m_savedAffinity) == 0) ? 1 : 0;
+		}
+
+		cpu_set_t cpuSet;
+		CPU_ZERO (&cpuSet);
+		for (dgInt32 i = 0; i < count; i ++) {
+			if (processors[i] < CPU_SETSIZE) {
+				CPU_SET (processors[i], &cpuSet);
+			}
+		}
+		return pthread_setaffinity_np (m_handle.native_handle(), sizeof (cpuSet), &cpuSet) == 0;
+	#else
+		// osx does not support binding threads to processors
+		return false;
+	#endif
+}
+
+void dgThread::RestoreAffinity ()
+{
+	if (m_affinitySaved) {
+		#if (defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+			SetThreadAffinityMask (m_handle.native_handle(), DWORD_PTR (m_savedAffinity[0]));
+		#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64))
+			pthread_setaffinity_np (m_handle.native_handle(), sizeof (cpu_set_t), (cpu_set_t*) m_savedAffinity);
+		#endif
+		m_affinitySaved = 0;
+	}
+}
+
+dgInt32 dgThread::GetProcessorsCount ()
+{
+	return dgMax (dgInt32 (std::thread::hardware_concurrency()), 1);
+}
+
+dgInt32 dgThread::GetProcessorPackage (dgInt32 processor)
+{
+	dgInt32 package = 0;
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		DWORD size = 0;
+		GetLogicalProcessorInformation (NULL, &size);
+		if (size) {
+			dgInt32 count = dgInt32 (size / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION)) + 1;
+			SYSTEM_LOGICAL_PROCESSOR_INFORMATION* const info = dgAlloca (SYSTEM_LOGICAL_PROCESSOR_INFORMATION, count);
+			if (GetLogicalProcessorInformation (info, &size)) {
+				dgInt32 packageIndex = 0;
+				count = dgInt32 (size / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+				for (dgInt32 i = 0; i < count; i ++) {
+					if (info[i].Relationship == RelationProcessorPackage) {
+						if ((processor < dgInt32 (sizeof (ULONG_PTR) * 8)) && (info[i].ProcessorMask & (ULONG_PTR (1) << processor))) {
+							package = packageIndex;
+							break;
+						}
+						packageIndex ++;
+					}
+				}
+			}
+		}
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64))
+		char path[256];
+		sprintf (path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", processor);
+		FILE* const file = fopen (path, "rb");
+		if (file) {
+			if (fscanf (file, "%d", &package) != 1) {
+				package = 0;
+			}
+			fclose (file);
+		}
+	#endif
+	return package;
+}
+
 
 #endif
 
@@ -70,6 +70,11 @@ class dgThread
 	void SuspendExecution (dgSemaphore& mutex);
 	void SuspendExecution (dgInt32 count, dgSemaphore* const mutexes);
 
+	bool SetAffinity (const dgInt32* const processors, dgInt32 count);
+	void RestoreAffinity ();
+	static dgInt32 GetProcessorsCount ();
+	static dgInt32 GetProcessorPackage (dgInt32 processor);
+
 	protected:
 	void Init ();
 	void Init (const char* const name, dgInt32 id);
@@ -82,7 +87,10 @@ class dgThread
 	dgInt32 m_id;
 	dgInt32 m_terminate;
 	dgInt32 m_threadRunning;
-	
+	dgInt32 m_affinitySaved;
+
+	// affinity mask the thread had before the first call to SetAffinity
+	dgUnsigned64 m_savedAffinity[16];
 	char m_name[32];
 };
 
@@ -27,8 +27,13 @@
 
 dgThreadHive::dgThreadBee::dgThreadBee()
 	:dgThread()
+	,m_top(0)
+	,m_bottom(0)
 	,m_isBusy(0)
+	,m_processor(-1)
+	,m_package(-1)
 	,m_myMutex()
+	,m_doneMutex()
 	,m_hive(NULL)
 	,m_allocator(NULL)
 {
@@ -66,7 +71,7 @@ void dgThreadHive::dgThreadBee::Execute (dgInt32 threadId)
 		dgInterlockedExchange(&m_isBusy, 1);
 		if (!m_terminate) {
 			RunNextJobInQueue(threadId);
-			m_hive->m_myMutex[threadId].Release();
+			m_doneMutex.Release();
 		}
 	}
 
@@ -78,22 +83,26 @@ void dgThreadHive::dgThreadBee::Execute (dgInt32 threadId)
 
 void dgThreadHive::dgThreadBee::RunNextJobInQueue(dgInt32 threadId)
 {
-	bool isEmpty = false;
-	do {
-		dgThreadJob job;
-		dgAssert (threadId == m_id);
-		m_hive->m_jobsCriticalSection.Lock(false);
-		isEmpty = m_hive->m_jobsPool.IsEmpty();
-		if (!isEmpty) {
-			job = m_hive->m_jobsPool.GetHead();
-			m_hive->m_jobsPool.Pop();
-		}
-		m_hive->m_jobsCriticalSection.Unlock();
+	dgThreadJob job;
+	dgAssert (threadId == m_id);
+
+	// drain my own deque first
+	while (PopJob(job)) {
+		job.m_callback (job.m_context0, job.m_context1, m_id);
+	}
 
-		if (!isEmpty) {
-			job.m_callback (job.m_context0, job.m_context1, m_id);
+	// no jobs are pushed while the workers are running, so a single pass over the other bees is enough
+	const dgInt32 beesCount = m_hive->m_beesCount;
+	for (dgInt32 i = 1; i < beesCount; i ++) {
+		dgInt32 index = threadId + i;
+		index -= (index >= beesCount) ? beesCount : 0;
+		dgThreadBee* const victim = &m_hive->m_workerBees[index];
+		while (victim->HasJobs()) {
+			if (victim->StealJob(job)) {
+				job.m_callback (job.m_context0, job.m_context1, m_id);
+			}
 		}
-	} while (!isEmpty);
+	}
 }
 
 
@@ -103,9 +112,8 @@ dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
 	,m_workerBees(NULL)
 	,m_myMasterThread(NULL)
 	,m_allocator(allocator)
-	,m_jobsCriticalSection()
+	,m_affinityMode(m_affinityNone)
 	,m_globalCriticalSection()
-    ,m_jobsPool(allocator)
 {
 }
 
@@ -122,6 +130,7 @@ void dgThreadHive::SetMatertThread (dgThread* const mastertThread)
 void dgThreadHive::DestroyThreads()
 {
 	if (m_beesCount) {
+		m_currentIdleBee = 0;
 		delete[] m_workerBees;
 		m_workerBees = NULL;
 		m_beesCount = 0;
@@ -155,6 +164,93 @@ void dgThreadHive::SetThreadsCount (dgInt32 threads)
 			sprintf (name, "dgThreadBee%d", i);
 			m_workerBees[i].SetUp(m_allocator, name, i, this);
 		}
+		ApplyThreadAffinity();
+	}
+}
+
+dgThreadHive::dgThreadAffinityMode dgThreadHive::GetThreadAffinityMode() const
+{
+	return m_affinityMode;
+}
+
+void dgThreadHive::SetThreadAffinityMode (dgThreadAffinityMode mode)
+{
+	m_affinityMode = mode;
+	ApplyThreadAffinity();
+}
+
+dgInt32 dgThreadHive::GetThreadPackage (dgInt32 threadIndex) const
+{
+	return ((threadIndex >= 0) && (threadIndex < m_beesCount)) ? m_workerBees[threadIndex].m_package : -1;
+}
+
+dgInt32 dgThreadHive::GetThreadProcessor (dgInt32 threadIndex) const
+{
+	return ((threadIndex >= 0) && (threadIndex < m_beesCount)) ? m_workerBees[threadIndex].m_processor : -1;
+}
+
+void dgThreadHive::ApplyThreadAffinity()
+{
+	if (!m_beesCount) {
+		return;
+	}
+
+	// sort the logical processors by socket so that consecutive workers share a package
+	const dgInt32 processorsCount = dgMin (dgThread::GetProcessorsCount(), 1024);
+	dgInt32* const processors = dgAlloca (dgInt32, processorsCount);
+	dgInt32* const packages = dgAlloca (dgInt32, processorsCount);
+	for (dgInt32 i = 0; i < processorsCount; i ++) {
+		processors[i] = i;
+		packages[i] = dgThread::GetProcessorPackage (i);
+	}
+	for (dgInt32 i = 1; i < processorsCount; i ++) {
+		const dgInt32 processor = processors[i];
+		const dgInt32 package = packages[i];
+		dgInt32 j = i - 1;
+		for (; (j >= 0) && (packages[j] > package); j --) {
+			processors[j + 1] = processors[j];
+			packages[j + 1] = packages[j];
+		}
+		processors[j + 1] = processor;
+		packages[j + 1] = package;
+	}
+
+	for (dgInt32 i = 0; i < m_beesCount; i ++) {
+		dgThreadBee& bee = m_workerBees[i];
+		const dgInt32 slot = i % processorsCount;
+		bee.m_processor = -1;
+		bee.m_package = -1;
+		switch (m_affinityMode)
+		{
+			case m_affinityPinned:
+			{
+				if (bee.SetAffinity (&processors[slot], 1)) {
+					bee.m_processor = processors[slot];
+					bee.m_package = packages[slot];
+				}
+				break;
+			}
+
+			case m_affinityPackage:
+			{
+				dgInt32 start = slot;
+				dgInt32 end = slot;
+				for (; (start > 0) && (packages[start - 1] == packages[slot]); start --);
+				for (; (end < processorsCount) && (packages[end] == packages[slot]); end ++);
+				if (bee.SetAffinity (&processors[start], end - start)) {
+					bee.m_package = packages[slot];
+				}
+				break;
+			}
+
+			case m_affinityNone:
+			default:
+			{
+				// leave the mask set by the process or the container in place
+				bee.RestoreAffinity ();
+				break;
+			}
+		}
 	}
 }
 
@@ -167,9 +263,10 @@ void dgThreadHive::QueueJob (dgWorkerThreadTaskCallback callback, void* const co
 		#ifdef DG_USE_THREAD_EMULATION
 			callback (context0, context1, 0);
 		#else 
-			dgThreadJob job (context0, context1, callback);
-			m_jobsPool.Push(job);
-			if (m_jobsPool.IsFull()) {
+			dgThreadBee* const bee = &m_workerBees[m_currentIdleBee];
+			bee->PushJob(dgThreadJob (context0, context1, callback));
+			m_currentIdleBee = (m_currentIdleBee + 1 < m_beesCount) ? m_currentIdleBee + 1 : 0;
+			if (bee->IsFull()) {
 				SynchronizationBarrier ();
 			}
 		#endif
@@ -177,6 +274,44 @@ void dgThreadHive::QueueJob (dgWorkerThreadTaskCallback callback, void* const co
 }
 
 
+void dgThreadHive::ParallelForKernel (void* const context0, void* const context1, dgInt32 threadID)
+{
+	dgParallelForDescriptor* const descriptor = (dgParallelForDescriptor*) context0;
+	for (dgInt32 start = dgAtomicExchangeAndAdd(&descriptor->m_cursor, 0); start < descriptor->m_count; start = dgAtomicExchangeAndAdd(&descriptor->m_cursor, 0)) {
+		// guided schedule, each thread claims a fraction of what is left so that the tail is split in small ranges
+		const dgInt32 remaining = descriptor->m_count - start;
+		const dgInt32 grain = dgMin (remaining, dgMax (descriptor->m_minGrainSize, remaining / descriptor->m_grainDivisor));
+		if (dgInterlockedCompareExchange(&descriptor->m_cursor, start + grain, start) == start) {
+			descriptor->m_callback (descriptor->m_context, start, start + grain, threadID);
+		}
+	}
+}
+
+void dgThreadHive::ParallelFor (dgParallelForCallback callback, void* const context, dgInt32 count, dgInt32 minGrainSize)
+{
+	dgAssert (minGrainSize > 0);
+	if (count <= 0) {
+		return;
+	}
+
+	const dgInt32 threadsCount = dgMin (GetThreadCount(), (count + minGrainSize - 1) / minGrainSize);
+	if (threadsCount <= 1) {
+		callback (context, 0, count, 0);
+	} else {
+		dgParallelForDescriptor descriptor;
+		descriptor.m_callback = callback;
+		descriptor.m_context = context;
+		descriptor.m_count = count;
+		descriptor.m_minGrainSize = minGrainSize;
+		descriptor.m_grainDivisor = threadsCount * 2;
+		descriptor.m_cursor = 0;
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			QueueJob (ParallelForKernel, &descriptor, this);
+		}
+		SynchronizationBarrier();
+	}
+}
+
 void dgThreadHive::OnBeginWorkerThread (dgInt32 threadId)
 {
 }
@@ -188,13 +323,19 @@ void dgThreadHive::OnEndWorkerThread (dgInt32 threadId)
 
 void dgThreadHive::SynchronizationBarrier ()
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	if (m_beesCount) {
 		for (dgInt32 i = 0; i < m_beesCount; i ++) {
 			m_workerBees[i].m_myMutex.Release();
 		}
 
-		m_myMasterThread->SuspendExecution(m_beesCount, m_myMutex);
-		dgAssert (m_jobsPool.IsEmpty());
+		for (dgInt32 i = 0; i < m_beesCount; i ++) {
+			m_myMasterThread->SuspendExecution(m_workerBees[i].m_doneMutex);
+		}
+		for (dgInt32 i = 0; i < m_beesCount; i ++) {
+			m_workerBees[i].ResetJobs();
+		}
+		m_currentIdleBee = 0;
 	}
 }
 
@@ -25,18 +25,26 @@
 
 #include "dgThread.h"
 #include "dgMemory.h"
-#include "dgFastQueue.h"
 
 
-
-//#define DG_THREAD_POOL_JOB_SIZE (512)
-#define DG_THREAD_POOL_JOB_SIZE (1024 * 8)
+// each worker owns a job deque of this size, jobs are distributed round robin by the master thread 
+// and idle workers steal from the top of the deque of the other workers.
+//#define DG_THREAD_BEE_JOB_SIZE (256)
+#define DG_THREAD_BEE_JOB_SIZE (1024)
+#define DG_THREAD_BEE_PADDING_SIZE (64)
 
 typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const context1, dgInt32 threadID);
+typedef void (*dgParallelForCallback) (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
 
 class dgThreadHive  
 {
 	public:
+	enum dgThreadAffinityMode
+	{
+		m_affinityNone = 0,		// let the OS schedule the workers
+		m_affinityPinned,		// bind each worker to a single logical processor
+		m_affinityPackage,		// bind each worker to all the logical processors of one socket
+	};
 
 	class dgThreadJob
 	{
@@ -71,8 +79,23 @@ class dgThreadHive
 
 		void RunNextJobInQueue(dgInt32 threadId);
 
+		bool HasJobs() const;
+		bool IsFull() const;
+		void ResetJobs();
+		void PushJob(const dgThreadJob& job);
+		bool PopJob(dgThreadJob& job);
+		bool StealJob(dgThreadJob& job);
+
+		dgInt32 m_top;
+		dgInt8 m_padding0[DG_THREAD_BEE_PADDING_SIZE];
+		dgInt32 m_bottom;
+		dgInt8 m_padding1[DG_THREAD_BEE_PADDING_SIZE];
+		dgThreadJob m_jobs[DG_THREAD_BEE_JOB_SIZE];
 		dgInt32 m_isBusy;
+		dgInt32 m_processor;
+		dgInt32 m_package;
 		dgSemaphore m_myMutex;
+		dgSemaphore m_doneMutex;
 		dgThreadHive* m_hive;
 		dgMemoryAllocator* m_allocator; 
 	};
@@ -95,24 +118,104 @@ class dgThreadHive
 	dgInt32 GetMaxThreadCount() const;
 	void SetThreadsCount (dgInt32 count);
 
+	dgThreadAffinityMode GetThreadAffinityMode() const;
+	void SetThreadAffinityMode (dgThreadAffinityMode mode);
+	dgInt32 GetThreadPackage (dgInt32 threadIndex) const;
+	dgInt32 GetThreadProcessor (dgInt32 threadIndex) const;
+
 	void QueueJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1);
 	void SynchronizationBarrier ();
 
+	// calls back with contiguous ranges [start, end) of the items [0, count), each item is visited by exactly one thread.
+	// the ranges start large and shrink down to minGrainSize as the items run out, and the function returns after all the items are done.
+	void ParallelFor (dgParallelForCallback callback, void* const context, dgInt32 count, dgInt32 minGrainSize);
+
 	private:
+	class dgParallelForDescriptor
+	{
+		public:
+		dgParallelForCallback m_callback;
+		void* m_context;
+		dgInt32 m_count;
+		dgInt32 m_minGrainSize;
+		dgInt32 m_grainDivisor;
+		dgInt32 m_cursor;
+	};
+
+	static void ParallelForKernel (void* const context0, void* const context1, dgInt32 threadID);
 	void DestroyThreads();
+	void ApplyThreadAffinity();
 
 	dgInt32 m_beesCount;
 	dgInt32 m_currentIdleBee;
 	dgThreadBee* m_workerBees;
 	dgThread* m_myMasterThread;
 	dgMemoryAllocator* m_allocator;
-	dgThread::dgCriticalSection m_jobsCriticalSection;
+	dgThreadAffinityMode m_affinityMode;
 	mutable dgThread::dgCriticalSection m_globalCriticalSection;
-	dgThread::dgSemaphore m_myMutex[DG_MAX_THREADS_HIVE_COUNT];
-	dgFastQueue<dgThreadJob, DG_THREAD_POOL_JOB_SIZE> m_jobsPool;
 };
 
 
+DG_INLINE bool dgThreadHive::dgThreadBee::HasJobs() const
+{
+	return m_top < m_bottom;
+}
+
+DG_INLINE bool dgThreadHive::dgThreadBee::IsFull() const
+{
+	return m_bottom >= DG_THREAD_BEE_JOB_SIZE;
+}
+
+DG_INLINE void dgThreadHive::dgThreadBee::ResetJobs()
+{
+	dgAssert (!HasJobs());
+	m_top = 0;
+	m_bottom = 0;
+}
+
+DG_INLINE void dgThreadHive::dgThreadBee::PushJob(const dgThreadJob& job)
+{
+	// only the master thread pushes jobs, and only while the workers are suspended
+	dgAssert (!IsFull());
+	m_jobs[m_bottom] = job;
+	m_bottom ++;
+}
+
+DG_INLINE bool dgThreadHive::dgThreadBee::PopJob(dgThreadJob& job)
+{
+	// the owner takes jobs from the bottom, the interlocked decrement fences the read of m_top 
+	const dgInt32 bottom = dgAtomicExchangeAndAdd(&m_bottom, -1) - 1;
+	const dgInt32 top = m_top;
+	if (top < bottom) {
+		job = m_jobs[bottom];
+		return true;
+	}
+
+	bool state = false;
+	dgInt32 newBottom = top;
+	if (top == bottom) {
+		// last job in the deque, race the thieves for it 
+		job = m_jobs[bottom];
+		state = (dgInterlockedCompareExchange(&m_top, top + 1, top) == top);
+		newBottom = top + 1;
+	}
+	dgInterlockedExchange(&m_bottom, newBottom);
+	return state;
+}
+
+DG_INLINE bool dgThreadHive::dgThreadBee::StealJob(dgThreadJob& job)
+{
+	// thieves take jobs from the top, the interlocked read fences the read of m_bottom 
+	const dgInt32 top = dgAtomicExchangeAndAdd(&m_top, 0);
+	const dgInt32 bottom = m_bottom;
+	if (top < bottom) {
+		job = m_jobs[top];
+		return (dgInterlockedCompareExchange(&m_top, top + 1, top) == top);
+	}
+	return false;
+}
+
+
 DG_INLINE void dgThreadHive::GlobalLock(bool yield) const
 {
 	GetIndirectLock(&m_globalCriticalSection, yield);
@@ -71,6 +71,34 @@ dgUnsigned64 dgGetTimeInMicrosenconds()
 #endif
 }
 
+// monotonic high resolution clock, for measuring short sections of the update
+dgUnsigned64 dgGetTimeInNanoseconds()
+{
+#ifdef _MSC_VER
+	static LARGE_INTEGER frequency;
+	if (!frequency.QuadPart) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER count;
+	QueryPerformanceCounter (&count);
+	const dgUnsigned64 seconds = dgUnsigned64 (count.QuadPart / frequency.QuadPart);
+	const dgUnsigned64 fraction = dgUnsigned64 (count.QuadPart % frequency.QuadPart);
+	return seconds * 1000000000 + fraction * 1000000000 / dgUnsigned64 (frequency.QuadPart);
+#endif
+
+#if (defined (_POSIX_VER) || defined (_POSIX_VER_64))
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return dgUnsigned64 (ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+
+#ifdef _MACOSX_VER
+	timeval tp;
+	gettimeofday(&tp, NULL);
+	return (dgUnsigned64 (tp.tv_sec) * 1000000 + tp.tv_usec) * 1000;
+#endif
+}
+
 
 dgFloat64 dgRoundToFloat(dgFloat64 val)
 {
@@ -545,6 +573,69 @@ dgInt32 dgDeserializeMarker(dgDeserialize serializeCallback, void* const userDat
 }
 
 
+#if (defined (__i386__) || defined (__x86_64__) || defined (_M_IX86) || defined (_M_X64))
+	#define DG_X86_CPUID
+	#ifndef _MSC_VER
+		#include <cpuid.h>
+	#endif
+
+static void dgCpuId (dgUnsigned32 leaf, dgUnsigned32 subLeaf, dgUnsigned32 info[4])
+{
+	#ifdef _MSC_VER
+		int regs[4];
+		__cpuidex (regs, dgInt32 (leaf), dgInt32 (subLeaf));
+		info[0] = dgUnsigned32 (regs[0]);
+		info[1] = dgUnsigned32 (regs[1]);
+		info[2] = dgUnsigned32 (regs[2]);
+		info[3] = dgUnsigned32 (regs[3]);
+	#else
+		__cpuid_count (leaf, subLeaf, info[0], info[1], info[2], info[3]);
+	#endif
+}
+
+static dgUnsigned64 dgGetExtendedControlRegister ()
+{
+	#ifdef _MSC_VER
+		return _xgetbv (0);
+	#else
+		dgUnsigned32 eax;
+		dgUnsigned32 edx;
+		__asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+		return (dgUnsigned64 (edx) << 32) | eax;
+	#endif
+}
+#endif
+
+// returns the set of DG_CPU_FEATURE_XXX flags supported by both the processor and the operating system
+dgUnsigned32 dgGetCpuFeatures()
+{
+	dgUnsigned32 features = 0;
+#ifdef DG_X86_CPUID
+	dgUnsigned32 info[4];
+	dgCpuId (0, 0, info);
+	const dgUnsigned32 maxLeaf = info[0];
+	if (maxLeaf >= 7) {
+		dgCpuId (1, 0, info);
+		const bool hasFma = (info[2] & (1 << 12)) ? true : false;
+		const bool hasOsSave = (info[2] & (1 << 27)) ? true : false;
+		const bool hasAvx = (info[2] & (1 << 28)) ? true : false;
+		if (hasFma && hasOsSave && hasAvx) {
+			// the os must save the ymm (and for avx512 the opmask and zmm) registers on context switch 
+			const dgUnsigned64 xcr0 = dgGetExtendedControlRegister ();
+			dgCpuId (7, 0, info);
+			if (((xcr0 & 0x06) == 0x06) && (info[1] & (1 << 5))) {
+				features |= DG_CPU_FEATURE_AVX2;
+				if (((xcr0 & 0xe6) == 0xe6) && (info[1] & (1 << 16))) {
+					features |= DG_CPU_FEATURE_AVX512;
+				}
+			}
+		}
+	}
+#endif
+	return features;
+}
+
+
 void dgSpinLock (dgInt32* const ptr, bool yield)
 {
 	#ifndef DG_USE_THREAD_EMULATION 
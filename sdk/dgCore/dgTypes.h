@@ -202,7 +202,7 @@
 #endif
 
 
-#define	DG_MAX_THREADS_HIVE_COUNT		16
+#define	DG_MAX_THREADS_HIVE_COUNT		256
 
 #ifdef _DEBUG
 //#define __ENABLE_DG_CONTAINERS_SANITY_CHECK 
@@ -220,6 +220,12 @@
 	//#define DG_INLINE	 __attribute__((always_inline))
 #endif
 
+#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+	#define DG_THREAD_LOCAL __declspec(thread)
+#else 
+	#define DG_THREAD_LOCAL __thread
+#endif
+
 
 #define DG_VECTOR_SIMD_SIZE		16
 #define DG_VECTOR_AVX2_SIZE		32
@@ -332,7 +338,7 @@ typedef bool (dgApi *dgReportProgress) (dgFloat32 progressNormalzedPercent, void
 
 //#define DG_ALLOCA_SIZE (sizeof (dgVector))
 //#define dgAlloca(type, size) (type*) alloca ((size) * sizeof (type))
-#define dgAlloca(type, size) (type*) ((dgVector*) alloca (size * sizeof (type) + 256))
+#define dgAlloca(type, size) (type*) ((dgVector*) alloca ((size) * sizeof (type) + 256))
 
 //#define dgCheckAligment(x) dgAssert (!(dgUnsigned64 (x) & 0xf))
 #define dgCheckAligment(x) 
@@ -761,6 +767,10 @@ dgInt32 dgVertexListToIndexList (dgFloat32* const vertexList, dgInt32 strideInBy
 #define dgClearFP()			_clearfp() 
 #define dgControlFP(x,y)	_controlfp(x,y)
 
+// cpu instruction set extensions reported by dgGetCpuFeatures
+#define DG_CPU_FEATURE_AVX2		(1<<0)
+#define DG_CPU_FEATURE_AVX512	(1<<1)
+
 enum dgSerializeRevisionNumber
 {
 	m_firstRevision = 100,
@@ -769,9 +779,11 @@ enum dgSerializeRevisionNumber
 };
 
 dgUnsigned64 dgGetTimeInMicrosenconds();
+dgUnsigned64 dgGetTimeInNanoseconds();
 dgFloat64 dgRoundToFloat(dgFloat64 val);
 void dgSerializeMarker(dgSerialize serializeCallback, void* const userData);
 dgInt32 dgDeserializeMarker(dgDeserialize serializeCallback, void* const userData);
+dgUnsigned32 dgGetCpuFeatures();
 
 class dgFloatExceptions
 {
@@ -831,6 +843,51 @@ DG_INLINE dgInt32 dgInterlockedExchange(dgInt32* const ptr, dgInt32 value)
 	#endif
 }
 
+DG_INLINE dgInt32 dgInterlockedCompareExchange(dgInt32* const ptr, dgInt32 newValue, dgInt32 oldValue)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedCompareExchange((long*) ptr, long (newValue), long (oldValue));
+	#endif
+
+	#if (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedCompareExchange((long*) ptr, long (newValue), long (oldValue));
+	#endif
+
+	#if (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER))
+		return __sync_val_compare_and_swap((int32_t*)ptr, oldValue, newValue);
+	#endif
+}
+
+DG_INLINE void* dgInterlockedExchangePointer(void** const ptr, void* const value)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedExchangePointer(ptr, value);
+	#endif
+
+	#if (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedExchangePointer(ptr, value);
+	#endif
+
+	#if (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER))
+		return __sync_lock_test_and_set(ptr, value);
+	#endif
+}
+
+DG_INLINE void* dgInterlockedCompareExchangePointer(void** const ptr, void* const newValue, void* const oldValue)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedCompareExchangePointer(ptr, newValue, oldValue);
+	#endif
+
+	#if (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedCompareExchangePointer(ptr, newValue, oldValue);
+	#endif
+
+	#if (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER))
+		return __sync_val_compare_and_swap(ptr, oldValue, newValue);
+	#endif
+}
+
 DG_INLINE void dgThreadYield()
 {
 	#ifndef DG_USE_THREAD_EMULATION
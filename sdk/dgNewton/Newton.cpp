@@ -137,6 +137,28 @@ void NewtonFree (void* const ptr)
 	dgFreeStack(ptr); 
 }
 
+/*!
+  Capture the profile of the next world updates to a file.
+
+  @param *fileName name of the file to create.
+  @param framesCount number of world updates to capture.
+
+  @return 1 if the capture started, 0 if the file can not be created or the engine was built without the time tracker.
+
+  The engine must be built with the time tracker (the D_TIME_TRACKER define), each thread records the begin and end time of
+  the named sections of the update, and the file is written in chrome trace event format after the last captured update.
+  The file can be open with chrome://tracing to see the load of each worker thread.
+*/
+int NewtonTimeTrackerStartCapture (const char* const fileName, int framesCount)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	#ifdef D_TIME_TRACKER
+		return dTimeTracker::GetInstance()->StartSection (fileName, framesCount) ? 1 : 0;
+	#else
+		return 0;
+	#endif
+}
+
 /*! @} */ // end of group Misc
 
 
@@ -443,11 +465,11 @@ void NewtonWorldCriticalSectionUnlock(const NewtonWorld* const newtonWorld)
 
   @return Nothing
 
-  The maximum number of threaded is set on initialization to the maximum number
-  of CPU in the system.
-  fixme: this appears to be wrong. It is set to 1.
+  The worker pool is sized at runtime, up to ::NewtonGetMaxThreadsCount workers; use
+  ::NewtonGetProcessorsCount to match the pool to the host. The workers are bound to
+  the processors according to the policy set with ::NewtonSetThreadsAffinityMode.
 
-  See also: ::NewtonGetThreadsCount
+  See also: ::NewtonGetThreadsCount, ::NewtonSetThreadsAffinityMode
 */
 void NewtonSetThreadsCount(const NewtonWorld* const newtonWorld, int threads)
 {
@@ -496,6 +518,89 @@ int NewtonGetMaxThreadsCount(const NewtonWorld* const newtonWorld)
 	return world->GetMaxThreadCount();
 }
 
+/*!
+  Return the number of logical processors on the host.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return Number of logical processors.
+
+  Use this value to size the worker pool to the machine with ::NewtonSetThreadsCount.
+
+  See also: ::NewtonSetThreadsCount, ::NewtonGetMaxThreadsCount
+*/
+int NewtonGetProcessorsCount(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	return dgThread::GetProcessorsCount();
+}
+
+/*!
+  Set the policy used to bind the worker threads to the logical processors.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param mode NEWTON_THREADS_AFFINITY_NONE (default), NEWTON_THREADS_AFFINITY_PINNED or NEWTON_THREADS_AFFINITY_PACKAGE
+
+  @return Nothing
+
+  NEWTON_THREADS_AFFINITY_PINNED binds each worker to one logical processor, NEWTON_THREADS_AFFINITY_PACKAGE
+  binds each worker to all the logical processors of one socket. In both modes the workers fill one socket
+  before moving to the next, so a pool smaller than a socket never migrates across sockets.
+  NEWTON_THREADS_AFFINITY_NONE leaves the workers with the affinity they had when they were created, 
+  so a mask set on the process, for example by taskset or a container, is kept.
+  The policy is kept by the world and applied again each time ::NewtonSetThreadsCount is called.
+  On platforms that do not support thread affinity the call has no effect.
+
+  See also: ::NewtonGetThreadsAffinityMode, ::NewtonGetThreadProcessor, ::NewtonGetThreadPackage
+*/
+void NewtonSetThreadsAffinityMode(const NewtonWorld* const newtonWorld, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetThreadAffinityMode (dgThreadHive::dgThreadAffinityMode (dgClamp (mode, NEWTON_THREADS_AFFINITY_NONE, NEWTON_THREADS_AFFINITY_PACKAGE)));
+}
+
+int NewtonGetThreadsAffinityMode(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetThreadAffinityMode();
+}
+
+/*!
+  Return the logical processor a worker thread is pinned to.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param threadIndex index of the worker thread.
+
+  @return processor index, or -1 if the worker is not pinned to a single processor.
+
+  See also: ::NewtonSetThreadsAffinityMode, ::NewtonGetThreadPackage
+*/
+int NewtonGetThreadProcessor(const NewtonWorld* const newtonWorld, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetThreadProcessor(threadIndex);
+}
+
+/*!
+  Return the socket a worker thread is bound to.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param threadIndex index of the worker thread.
+
+  @return socket index, or -1 if the worker is not bound to a socket.
+
+  See also: ::NewtonSetThreadsAffinityMode, ::NewtonGetThreadProcessor
+*/
+int NewtonGetThreadPackage(const NewtonWorld* const newtonWorld, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetThreadPackage(threadIndex);
+}
+
 
 /*!
   Enable/disable multi-threaded constraint resolution for large islands
@@ -1068,6 +1173,206 @@ int NewtonWorldGetConstraintCount(const NewtonWorld* const newtonWorld)
 	return world->GetConstraintsCount();
 }
 
+/*!
+  Return the number of frame arenas of the world.
+
+  @param *newtonWorld pointer to the Newton world.
+
+  @return number of arenas.
+
+  The frame arenas hold the transient memory of one world update and are reset at the beginning of each step.
+  Arena zero holds the solver memory, arena i + 1 is the scratch memory of worker thread i.
+
+  See also: ::NewtonWorldGetFrameArenaStatistics, ::NewtonWorldReserveFrameArena
+*/
+int NewtonWorldGetFrameArenaCount(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetFrameArenaCount();
+}
+
+/*!
+  Presize a frame arena.
+
+  @param *newtonWorld pointer to the Newton world.
+  @param arenaIndex index of the arena.
+  @param sizeInBytes minimum capacity of the arena.
+
+  An arena that runs out of memory during an update gets more memory from the general allocator, and merges it in a
+  single block at the next update. Reserving the high water mark of a typical scene at startup avoids these allocations.
+
+  This function can not be called from inside an update.
+
+  See also: ::NewtonWorldGetFrameArenaStatistics
+*/
+void NewtonWorldReserveFrameArena(const NewtonWorld* const newtonWorld, int arenaIndex, int sizeInBytes)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	world->ReserveFrameArena(arenaIndex, sizeInBytes);
+}
+
+/*!
+  Return the usage statistics of a frame arena.
+
+  @param *newtonWorld pointer to the Newton world.
+  @param arenaIndex index of the arena.
+  @param *highWaterMarkInBytes pointer to an int to receive the largest number of bytes used during one update.
+  @param *capacityInBytes pointer to an int to receive the current capacity of the arena.
+  @param *allocationsCount pointer to an int to receive the number of times the arena got memory from the general allocator.
+
+  See also: ::NewtonWorldGetFrameArenaCount, ::NewtonWorldReserveFrameArena
+*/
+void NewtonWorldGetFrameArenaStatistics(const NewtonWorld* const newtonWorld, int arenaIndex, int* const highWaterMarkInBytes, int* const capacityInBytes, int* const allocationsCount)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgInt32 highWaterMark;
+	dgInt32 capacity;
+	dgInt32 count;
+	world->GetFrameArenaStatistics(arenaIndex, highWaterMark, capacity, count);
+	*highWaterMarkInBytes = highWaterMark;
+	*capacityInBytes = capacity;
+	*allocationsCount = count;
+}
+
+/*!
+  Return the number of size bins of the world memory allocator.
+
+  @param *newtonWorld pointer to the Newton world.
+
+  @return number of bins.
+
+  Small allocations are quantized to the bin granularity and served from per thread caches in front of the bins,
+  larger allocations go directly to the memory callbacks.
+
+  See also: ::NewtonWorldGetMemoryBinCounters
+*/
+int NewtonWorldGetMemoryBinCount(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	return dgMemoryAllocator::GetBinCount();
+}
+
+/*!
+  Return the usage counters of one size bin of the world memory allocator.
+
+  @param *newtonWorld pointer to the Newton world.
+  @param binIndex index of the bin.
+  @param *blockSizeInBytes pointer to an int to receive the largest allocation served by the bin.
+  @param *hits pointer to a dLong to receive the number of allocations served from a thread cache.
+  @param *misses pointer to a dLong to receive the number of allocations that had to go to the shared bins.
+  @param *bytesLive pointer to a dLong to receive the bytes currently allocated from the bin.
+
+  The counters are updated without synchronization, the values read during an update are approximated.
+
+  See also: ::NewtonWorldGetMemoryBinCount
+*/
+void NewtonWorldGetMemoryBinCounters(const NewtonWorld* const newtonWorld, int binIndex, int* const blockSizeInBytes, dLong* const hits, dLong* const misses, dLong* const bytesLive)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgInt32 blockSize;
+	dgInt64 hitsCount;
+	dgInt64 missesCount;
+	dgInt64 live;
+	world->dgWorld::GetAllocator()->GetBinCounters(binIndex, blockSize, hitsCount, missesCount, live);
+	*blockSizeInBytes = blockSize;
+	*hits = hitsCount;
+	*misses = missesCount;
+	*bytesLive = live;
+}
+
+/*!
+  Return the state of the world performance counters.
+
+  @param *newtonWorld pointer to the Newton world.
+
+  @return 1 if the counters are updated by each world update, 0 otherwise.
+
+  See also: ::NewtonWorldSetPerformanceCountersState
+*/
+int NewtonWorldGetPerformanceCountersState(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetPerformanceCountersState() ? 1 : 0;
+}
+
+/*!
+  Enable or disable the world performance counters.
+
+  @param *newtonWorld pointer to the Newton world.
+  @param state 1 to measure each world update, 0 to disable the counters.
+
+  The counters are disabled by default, when enabled each thread reads a high resolution clock at the beginning and the
+  end of each task of the update. Changing the state clears the counters of the last update.
+
+  This function can not be called from inside an update.
+
+  See also: ::NewtonWorldGetPerformanceCounters, ::NewtonWorldGetPerformanceCounts
+*/
+void NewtonWorldSetPerformanceCountersState(const NewtonWorld* const newtonWorld, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	world->SetPerformanceCountersState(state ? true : false);
+}
+
+/*!
+  Return the time a thread spent in each phase of the last world update.
+
+  @param *newtonWorld pointer to the Newton world.
+  @param threadIndex index of the worker thread, or -1 for the sum of all threads.
+  @param *phaseTimesInMicroseconds pointer to an array of NEWTON_PERFORMANCE_PHASES_COUNT dFloat to receive the time in microseconds
+  spent in each phase, indexed by the NEWTON_PERFORMANCE_* phase identifiers.
+
+  The times add up all the sub steps of the update. Serial parts of the update, like building the islands, are
+  charged to thread zero. Time a thread spends waiting for the other threads is not included.
+
+  The counters are published when an update finishes, reading them while an asynchronous update is running returns the
+  values of the previous update.
+
+  See also: ::NewtonWorldSetPerformanceCountersState, ::NewtonWorldGetPerformanceCounts
+*/
+void NewtonWorldGetPerformanceCounters(const NewtonWorld* const newtonWorld, int threadIndex, dFloat* const phaseTimesInMicroseconds)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	dgAssert (NEWTON_PERFORMANCE_PHASES_COUNT == dgWorldPerformanceCounters::m_phasesCount);
+	dgUnsigned64 phaseTimes[dgWorldPerformanceCounters::m_phasesCount];
+	world->GetPerformanceCounters(threadIndex, phaseTimes);
+	for (dgInt32 i = 0; i < dgWorldPerformanceCounters::m_phasesCount; i ++) {
+		phaseTimesInMicroseconds[i] = dFloat (phaseTimes[i] * 1.0e-3);
+	}
+}
+
+/*!
+  Return the size of the simulation solved by the last world update.
+
+  @param *newtonWorld pointer to the Newton world.
+  @param *activeBodies pointer to an int to receive the number of bodies that were simulated.
+  @param *activeContacts pointer to an int to receive the number of touching contact joints passed to the solver.
+  @param *activeJoints pointer to an int to receive the number of joints passed to the solver, including the contacts.
+  @param *jointRows pointer to an int to receive the number of jacobian rows of all active joints.
+  @param *clusters pointer to an int to receive the number of islands.
+
+  When the update has sub steps the values are those of the last sub step.
+
+  See also: ::NewtonWorldGetPerformanceCounters
+*/
+void NewtonWorldGetPerformanceCounts(const NewtonWorld* const newtonWorld, int* const activeBodies, int* const activeContacts, int* const activeJoints, int* const jointRows, int* const clusters)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	*activeBodies = world->GetPerformanceCount(dgWorldPerformanceCounters::m_activeBodies);
+	*activeContacts = world->GetPerformanceCount(dgWorldPerformanceCounters::m_activeContacts);
+	*activeJoints = world->GetPerformanceCount(dgWorldPerformanceCounters::m_activeJoints);
+	*jointRows = world->GetPerformanceCount(dgWorldPerformanceCounters::m_jointRows);
+	*clusters = world->GetPerformanceCount(dgWorldPerformanceCounters::m_clusters);
+}
+
 
 /*!
   Shoot ray from point p0 to p1 and trigger callback for each body on that line.
@@ -1128,6 +1433,39 @@ void NewtonWorldRayCast(const NewtonWorld* const newtonWorld, const dFloat* cons
 	}
 }
 
+/*!
+  cast a batch of rays against the world and report the closest hit of each ray.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *p0 pointer to the array of ray origins in global space.
+  @param *p1 pointer to the array of ray end points in global space.
+  @param strideInBytes distance in bytes between two consecutive points in the *p0* and *p1* arrays, must be at least 3 * sizeof (dFloat).
+  @param raysCount number of rays in the batch.
+  @param *hits pointer to an array of at least *raysCount* entries that receives the closest hit of each ray.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user defined function to be called for each body before intersection, can be NULL.
+
+  @return the number of rays that hit a body.
+
+  The rays are traced through the broadphase in packets of four consecutive entries, and the packets are spread across the world worker threads.
+  Rays that start close to each other and point in similar directions should be placed next to each other in the arrays for best performance.
+
+  Each entry of *hits* is set to the closest intersection of the corresponding ray, a ray that did not hit anything has a NULL *m_hitBody*
+  and an *m_param* of 1.0. There are no per hit callbacks, the prefilter is the only callback and it can be called from any of the worker threads.
+
+  When the function is called while the world is updating, from inside a Newton callback or while a ::NewtonUpdateAsync is running, 
+  the workers are busy and the whole batch is traced serially on the calling thread. Like the other functions that use the world 
+  worker threads, it must not be called from two application threads at the same time.
+
+  See also: ::NewtonWorldRayCast
+*/
+int NewtonWorldRayCastBatch(const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, int strideInBytes, int raysCount, NewtonWorldRayCastBatchHit* const hits, void* const userData, NewtonWorldRayPrefilterCallback prefilter)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetBroadPhase()->RayCastBatch (p0, p1, strideInBytes, raysCount, (OnRayPrecastAction) prefilter, userData, (dgRayCastBatchHit*) hits);
+}
+
 
 /*!
   cast a simple convex shape along the ray that goes for the matrix position to the destination and get the firsts contacts of collision.
@@ -1185,6 +1523,149 @@ int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* cons
 	return world->GetBroadPhase()->Collide((dgCollisionInstance*)shape, dgMatrix(matrix), (OnRayPrecastAction)prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
 }
 
+/*!
+  cast a batch of convex shapes along their sweep segments and get the first contacts of each cast.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *queries pointer to an array of *queriesCount* queries, each with the shape, the start matrix and the target position of the sweep.
+  @param queriesCount number of queries in the batch.
+  @param *params pointer to an array of *queriesCount* entries that receives the time of impact of each query, 1.0 if the shape did not hit anything.
+  @param *contactsCount pointer to an array of *queriesCount* entries that receives the number of contacts reported by each query.
+  @param *info pointer to an array of *queriesCount* x *maxContactsPerQuery* contacts, the contacts of query i start at entry i * *maxContactsPerQuery*. can be NULL.
+  @param maxContactsPerQuery capacity of each query slice in *info*.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user defined function to be called for each body before intersection, can be NULL.
+  @param threadIndex Index of the thread that calls the function, only used when the batch runs on the calling thread.
+
+  @return the number of queries that hit a body.
+
+  Each query is the same cast that ::NewtonWorldConvexCast does, the queries are spread in small chunks across the world worker threads.
+  Passing NULL in *info* and zero in *maxContactsPerQuery* only calculates the time of impact of each query.
+
+  Queries can share the same shape. The prefilter can be called from any of the worker threads.
+
+  When the function is called while the world is updating, from inside a Newton callback or while a ::NewtonUpdateAsync is running, 
+  the workers are busy and the whole batch runs serially on the calling thread, with *threadIndex* as the thread index of the 
+  casts, the same way ::NewtonWorldConvexCast uses it. Like the other functions that use the world worker threads, 
+  it must not be called from two application threads at the same time.
+
+  See also: ::NewtonWorldConvexCast, ::NewtonWorldCollideBatch
+*/
+int NewtonWorldConvexCastBatch (const NewtonWorld* const newtonWorld, const NewtonWorldConvexCastBatchQuery* const queries, int queriesCount, dFloat* const params, int* const contactsCount, NewtonWorldConvexCastReturnInfo* const info, int maxContactsPerQuery, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetBroadPhase()->ConvexCastBatch ((const dgConvexCastBatchQuery*) queries, queriesCount, params, contactsCount, (dgConvexCastReturnInfo*) info, maxContactsPerQuery, (OnRayPrecastAction) prefilter, userData, threadIndex);
+}
+
+/*!
+  collide a batch of shapes against the world and get the contacts of each overlap.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *queries pointer to an array of *queriesCount* queries, the target of each query is not used.
+  @param queriesCount number of queries in the batch.
+  @param *contactsCount pointer to an array of *queriesCount* entries that receives the number of contacts reported by each query.
+  @param *info pointer to an array of *queriesCount* x *maxContactsPerQuery* contacts, the contacts of query i start at entry i * *maxContactsPerQuery*.
+  @param maxContactsPerQuery capacity of each query slice in *info*, must be larger than zero.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user defined function to be called for each body before intersection, can be NULL.
+  @param threadIndex Index of the thread that calls the function, only used when the batch runs on the calling thread.
+
+  @return the number of queries that overlap a body.
+
+  Each query is the same test that ::NewtonWorldCollide does, the queries are spread in small chunks across the world worker threads.
+  The prefilter can be called from any of the worker threads.
+
+  When the function is called while the world is updating, from inside a Newton callback or while a ::NewtonUpdateAsync is running, 
+  the workers are busy and the whole batch runs serially on the calling thread, with *threadIndex* as the thread index of the 
+  tests, the same way ::NewtonWorldCollide uses it. Like the other functions that use the world worker threads, 
+  it must not be called from two application threads at the same time.
+
+  See also: ::NewtonWorldCollide, ::NewtonWorldConvexCastBatch
+*/
+int NewtonWorldCollideBatch (const NewtonWorld* const newtonWorld, const NewtonWorldConvexCastBatchQuery* const queries, int queriesCount, int* const contactsCount, NewtonWorldConvexCastReturnInfo* const info, int maxContactsPerQuery, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetBroadPhase()->CollideBatch ((const dgConvexCastBatchQuery*) queries, queriesCount, contactsCount, (dgConvexCastReturnInfo*) info, maxContactsPerQuery, (OnRayPrecastAction) prefilter, userData, threadIndex);
+}
+
+/*!
+  Create a query cache for repeated world queries in the same region.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param padding distance the cached region extends around the query that created it.
+
+  @return the query cache.
+
+  The cache keeps the broadphase bodies overlapping a padded region around the last query. Queries that stay inside 
+  the region skip the broadphase tree descent, and the cache is brought up to date across frames by only visiting
+  the branches of the tree with moving bodies. A larger padding keeps the region valid for longer at the cost of more
+  candidate bodies per query.
+
+  A cache is not thread safe, each thread issuing cached queries must use its own cache.
+
+  See also: ::NewtonWorldDestroyQueryCache, ::NewtonWorldCollideCached, ::NewtonWorldConvexCastCached
+*/
+NewtonWorldQueryCache* NewtonWorldCreateQueryCache (const NewtonWorld* const newtonWorld, dFloat padding)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return (NewtonWorldQueryCache*) new (world->GetAllocator()) dgBroadPhaseQueryCache (world->GetAllocator(), padding);
+}
+
+/*!
+  Destroy a query cache.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *cache the query cache.
+
+  See also: ::NewtonWorldCreateQueryCache
+*/
+void NewtonWorldDestroyQueryCache (const NewtonWorld* const newtonWorld, NewtonWorldQueryCache* const cache)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	delete (dgBroadPhaseQueryCache*) cache;
+}
+
+/*!
+  Same as ::NewtonWorldConvexCast, but the broadphase candidates are taken from a query cache.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *cache the query cache.
+
+  The rest of the arguments and the return value are the same as ::NewtonWorldConvexCast.
+
+  See also: ::NewtonWorldCreateQueryCache
+*/
+int NewtonWorldConvexCastCached (const NewtonWorld* const newtonWorld, NewtonWorldQueryCache* const cache, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, 
+								 dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, 
+								 int maxContactsCount, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgVector destination (target[0], target[1], target[2], dgFloat32 (0.0f));
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetBroadPhase()->ConvexCast ((dgBroadPhaseQueryCache*) cache, (dgCollisionInstance*) shape, dgMatrix (matrix), destination, param, (OnRayPrecastAction) prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
+}
+
+/*!
+  Same as ::NewtonWorldCollide, but the broadphase candidates are taken from a query cache.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *cache the query cache.
+
+  The rest of the arguments and the return value are the same as ::NewtonWorldCollide.
+
+  See also: ::NewtonWorldCreateQueryCache
+*/
+int NewtonWorldCollideCached (const NewtonWorld* const newtonWorld, NewtonWorldQueryCache* const cache, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData,  
+							  NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetBroadPhase()->Collide((dgBroadPhaseQueryCache*) cache, (dgCollisionInstance*)shape, dgMatrix(matrix), (OnRayPrecastAction)prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
+}
+
 
 /*!
   Retrieve body by index from island.
@@ -3292,6 +3773,11 @@ void NewtonTreeCollisionAddFace(const NewtonCollision* const treeCollision, int
   A reduction factor of 1.5 to 2.0 is common.
   Calling this function with the parameter *optimize* set to zero, will leave the mesh geometry unaltered.
 
+  The build is spread across the world worker threads. When the function is called while the world is updating,
+  from inside a Newton callback or while a ::NewtonUpdateAsync is running, the workers are busy and the mesh is built
+  serially on the calling thread. Like the other functions that use the world worker threads, such as ::NewtonWorldRayCastBatch,
+  it must not be called from two application threads at the same time.
+
   See also: ::NewtonTreeCollisionAddFace, ::NewtonTreeCollisionEndBuild
 */
 void NewtonTreeCollisionEndBuild(const NewtonCollision* const treeCollision, int optimize)
@@ -3302,6 +3788,31 @@ void NewtonTreeCollisionEndBuild(const NewtonCollision* const treeCollision, int
 	collision->EndBuild(optimize);
 }
 
+/*!
+  Return the time spent in each phase of the last call to ::NewtonTreeCollisionEndBuild.
+
+  @param *treeCollision is the pointer to the collision tree.
+  @param *faceMergeTimeInMicroseconds pointer to a dFloat to receive the time spent welding the vertices and merging the coplanar faces.
+  @param *treeBuildTimeInMicroseconds pointer to a dFloat to receive the time spent building the bounding box hierarchy.
+  @param *adjacencyTimeInMicroseconds pointer to a dFloat to receive the time spent calculating the face edge normals.
+
+  The build runs on the worker threads of the world that created the collision, see ::NewtonSetThreadsCount.
+  The resulting mesh does not depend on the number of threads.
+
+  See also: ::NewtonTreeCollisionEndBuild
+*/
+void NewtonTreeCollisionGetBuildTimings (const NewtonCollision* const treeCollision, dFloat* const faceMergeTimeInMicroseconds, dFloat* const treeBuildTimeInMicroseconds, dFloat* const adjacencyTimeInMicroseconds)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionBVH* const collision = (dgCollisionBVH*) ((dgCollisionInstance*)treeCollision)->GetChildShape();
+	dgAssert (collision->IsType (dgCollision::dgCollisionBVH_RTTI));
+	dgFloat32 times[3];
+	collision->GetBuildTimes (&times[0], &times[1], &times[2]);
+	*faceMergeTimeInMicroseconds = dFloat (times[0]);
+	*treeBuildTimeInMicroseconds = dFloat (times[1]);
+	*adjacencyTimeInMicroseconds = dFloat (times[2]);
+}
+
 
 /*!
   Get the user defined collision attributes stored with each face of the collision mesh.
@@ -3449,6 +3960,70 @@ int NewtonTreeCollisionGetVertexListTriangleListInAABB(const NewtonCollision* co
 	return (NewtonCollision*) collision;
 }
 
+/*!
+  Create a height field collision geometry that streams its elevation and attribute maps one tile at a time.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param width number of vertices along the x axis.
+  @param height number of vertices along the z axis.
+  @param gridsDiagonals the cell diagonals construction mode, same as in NewtonCreateHeightFieldCollision.
+  @param elevationdatType 0 for 32 bit float elevations, 1 for unsigned 16 bit elevations.
+  @param tileSize number of cells along each side of a tile, it must be a power of two not smaller than four.
+  @param maxResidentTiles number of tiles kept in memory, the least recently used tiles above this budget are released.
+  @param minElevation smallest elevation value of the whole map, before the vertical scale.
+  @param maxElevation largest elevation value of the whole map, before the vertical scale.
+  @param pageInCallback function that fills the elevation and attributes of a tile.
+  @param *pageInUserData user data passed to the page in callback.
+  @param verticalScale scale applied to the elevation values.
+  @param horizontalScale_x distance between vertices along the x axis.
+  @param horizontalScale_z distance between vertices along the z axis.
+  @param shapeID user id of the shape.
+
+  @return Pointer to the collision, or NULL if tileSize is not a power of two not smaller than four, or pageInCallback is NULL.
+
+  The page in callback is called the first time a ray cast or a collision query reaches a tile that is not in memory, 
+  and it may be called from any of the worker threads. Different tiles can be paged in at the same time from different threads,
+  so the callback must be thread safe, but a tile is never paged in by two calls at once. Only the queries that need a tile
+  that is being paged in wait for the callback, queries on the tiles that are in memory do not.
+  It must fill tileSize + 1 by tileSize + 1 elevations and attributes, in rows of tileSize + 1 entries,
+  starting at vertex (tileX * tileSize, tileZ * tileSize), so the last row and column of a tile are the first ones of the next tile.
+  The entries past the edge of the map are never read. The data can come from any source, for example a memory mapped file.
+
+  The elevation and attribute maps are not available to NewtonCollisionGetInfo, and horizontal displacement is not supported.
+*/
+NewtonCollision* NewtonCreateTiledHeightFieldCollision (const NewtonWorld* const newtonWorld, int width, int height, int gridsDiagonals, int elevationdatType,
+														int tileSize, int maxResidentTiles, dFloat minElevation, dFloat maxElevation, NewtonHeightFieldPageInCallback pageInCallback, void* const pageInUserData, 
+														dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID)
+{
+	Newton* const world = (Newton *)newtonWorld;
+
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = world->CreateTiledHeightField(width, height, gridsDiagonals, elevationdatType, tileSize, maxResidentTiles, dgFloat32 (minElevation), dgFloat32 (maxElevation), 
+																		 (dgCollisionHeightFieldPageInCallback) pageInCallback, pageInUserData, dgFloat32 (verticalScale), dgFloat32 (horizontalScale_x), dgFloat32 (horizontalScale_z));
+	if (collision) {
+		collision->SetUserDataID(dgUnsigned32 (shapeID));
+	}
+	return (NewtonCollision*) collision;
+}
+
+/*!
+  Return the number of tiles of a tiled height field that are in memory.
+
+  @param *heightfieldCollision pointer to the height field collision.
+
+  @return number of resident tiles, zero for height fields that are not tiled.
+*/
+int NewtonHeightFieldGetResidentTilesCount (const NewtonCollision* const heightfieldCollision)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)heightfieldCollision;
+	if (collision->IsType (dgCollision::dgCollisionHeightField_RTTI)) {
+		dgCollisionHeightField* const shape = (dgCollisionHeightField*) collision->GetChildShape();
+		return shape->GetResidentTilesCount();
+	}
+	return 0;
+}
+
 
 
 /*!
@@ -4107,6 +4682,54 @@ NewtonCollision* NewtonCreateCollisionFromSerialization(const NewtonWorld* const
 	return  (NewtonCollision*) world->CreateCollisionFromSerialization ((dgDeserialize) deserializeFunction, serializeHandle);
 }
 
+/*!
+  Save a tree collision or a height field collision as a relocatable memory image.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *collision is the pointer to a tree collision or a height field collision.
+  @param serializeFunction pointer to the event function that will receive the image.
+  @param *serializeHandle user data that will be passed to the _NewtonSerialize_ callback.
+
+  @return 1 if the image was written, 0 if the shape type has no image.
+
+  The image is a versioned block made of a header and the arrays of the shape, each array is 64 bytes aligned and all references are
+  relative to the beginning of the image. Unlike ::NewtonCollisionSerialize, the image can be loaded with no copy by ::NewtonCreateCollisionFromImage.
+  The image uses the byte order and the floating point format of the machine that wrote it. Only the shape is saved, not the instance data
+  like the scale, matrix or user data.
+
+  Tiled height fields are not supported, they are already paged in from the application data.
+
+  See also: ::NewtonCreateCollisionFromImage, ::NewtonCollisionSerialize
+*/
+int NewtonCollisionSerializeImage (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, NewtonSerializeCallback serializeFunction, void* const serializeHandle)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->SerializeCollisionImage ((dgCollisionInstance*) collision, (dgSerialize) serializeFunction, serializeHandle) ? 1 : 0;
+}
+
+/*!
+  Create a collision shape that uses a memory image in place.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *image pointer to an image written by ::NewtonCollisionSerializeImage, it must be 16 bytes aligned.
+  @param sizeInBytes size of the memory block that contains the image.
+
+  @return the new collision, or NULL if the image is not valid, or it was written by a different version or a machine with a different byte order.
+
+  The collision does not copy the arrays of the image, the image must remain valid and unchanged until the collision is destroyed.
+  The image is never written to, so a read only memory mapped file can be shared by several worlds or processes loading the same static mesh.
+  The face attributes of a tree collision and the horizontal displacement of a height field loaded from an image can not be changed.
+
+  See also: ::NewtonCollisionSerializeImage, ::NewtonCreateCollisionFromSerialization
+*/
+NewtonCollision* NewtonCreateCollisionFromImage (const NewtonWorld* const newtonWorld, const void* const image, dLong sizeInBytes)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return (NewtonCollision*) world->CreateCollisionFromImage (image, sizeInBytes);
+}
+
 
 /*!
   Get creation parameters for this collision objects.
@@ -4329,6 +4952,46 @@ NewtonBody* NewtonCreateKinematicBody(const NewtonWorld* const newtonWorld, cons
 	return body;
 }
 
+/*!
+  Create a sensor volume.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *collisionPtr pointer to the collision object.
+  @param *matrixPtr pointer to an array of 16 floats containing the global matrix of the sensor.
+
+  @return Pointer to the sensor body.
+
+  A sensor is a kinematic body that never generates contacts. Every update the broadphase tests it against the
+  dynamics bodies that overlap its bounding box with an exact shape intersection test, and after the step the
+  sensor event callback is called with NEWTON_SENSOR_OVERLAP_BEGIN, NEWTON_SENSOR_OVERLAP_PERSIST and
+  NEWTON_SENSOR_OVERLAP_END for each of those bodies. Sensors do not detect static bodies, kinematic bodies or
+  other sensors, and a body that is destroyed while inside a sensor leaves it without an end event.
+  The material of the sensor and body group ids must have collision enabled for the pair to be tested.
+
+  See also: ::NewtonSensorSetEventCallback, ::NewtonCreateKinematicBody
+*/
+NewtonBody* NewtonCreateSensorBody(const NewtonWorld* const newtonWorld, const NewtonCollision* const collisionPtr, const dFloat* const matrixPtr)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgCollisionInstance* collision = (dgCollisionInstance*)collisionPtr;
+	if (!collisionPtr) {
+		collision = (dgCollisionInstance*)NewtonCreateNull(newtonWorld);
+	}
+
+	dgMatrix matrix (matrixPtr);
+	matrix.m_front.m_w = dgFloat32 (0.0f);
+	matrix.m_up.m_w    = dgFloat32 (0.0f);
+	matrix.m_right.m_w = dgFloat32 (0.0f);
+	matrix.m_posit.m_w = dgFloat32 (1.0f);
+
+	NewtonBody* const body = (NewtonBody*) world->CreateSensorBody(collision, matrix);
+	if (!collisionPtr) {
+		NewtonDestroyCollision((NewtonCollision*)collision);
+	}
+	return body;
+}
+
 
 /*!
   Destroy a rigid body.
@@ -4429,6 +5092,8 @@ int NewtonBodyGetType (const NewtonBody* const bodyPtr)
 	dgBody* const body = (dgBody *)bodyPtr;
 	if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 		return NEWTON_DYNAMIC_BODY;
+	} else if (body->IsRTTIType(dgBody::m_sensorBodyRTTI)) {
+		return NEWTON_SENSOR_BODY;
 	} else if (body->IsRTTIType(dgBody::m_kinematicBodyRTTI)) {
 		return NEWTON_KINEMATIC_BODY;
 //	} else if (body->IsRTTIType(dgBody::m_deformableBodyRTTI)) {
@@ -4438,6 +5103,42 @@ int NewtonBodyGetType (const NewtonBody* const bodyPtr)
 	return 0;
 }
 
+/*!
+  Set the function called with the overlap events of a sensor.
+
+  @param *sensorPtr pointer to a sensor body.
+  @param callback pointer to the event function, or NULL to stop the events.
+
+  @return Nothing.
+
+  The events of all sensors are collected while the broadphase runs, and the callbacks are called from the calling thread
+  after the dynamics step, sorted by sensor and body, so the order does not depend on the number of threads.
+  The callback can destroy bodies; any pending event that refers to a destroyed body is skipped.
+
+  See also: ::NewtonCreateSensorBody, ::NewtonSensorGetEventCallback
+*/
+void NewtonSensorSetEventCallback (const NewtonBody* const sensorPtr, NewtonSensorEventCallback callback)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)sensorPtr;
+	dgAssert (body->IsRTTIType(dgBody::m_sensorBodyRTTI));
+	if (body->IsRTTIType(dgBody::m_sensorBodyRTTI)) {
+		dgSensorBody* const sensor = (dgSensorBody*) body;
+		sensor->SetSensorCallback (dgSensorBody::OnSensorEvent (callback));
+	}
+}
+
+NewtonSensorEventCallback NewtonSensorGetEventCallback (const NewtonBody* const sensorPtr)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)sensorPtr;
+	if (body->IsRTTIType(dgBody::m_sensorBodyRTTI)) {
+		dgSensorBody* const sensor = (dgSensorBody*) body;
+		return NewtonSensorEventCallback (sensor->GetSensorCallback());
+	}
+	return NULL;
+}
+
 int NewtonBodyGetID (const NewtonBody* const bodyPtr)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -8405,6 +9106,70 @@ NewtonCollision* NewtonCreateMassSpringDamperSystem (const NewtonWorld* const ne
 	return (NewtonCollision*)world->CreateMassSpringDamperSystem (shapeID, pointCount, points, strideInBytes, pointMass, linksCount, links, linksSpring, linksDamper);
 }
 
+/*!
+  Select the time integrator of a mass spring damper system.
+
+  @param *massSpringSystem is the mass spring damper collision.
+  @param state non zero selects the implicit solver, zero the default explicit integrator.
+  @param iterations is the number of local global passes per step of the implicit solver, default is 4.
+
+  The implicit solver is a projective dynamics backward Euler step, it stays stable with stiff springs 
+  at the world time step. The system matrix is factored the first time the mode is used and again 
+  only when the time step changes, the fill reducing ordering of the factor is calculated only once.
+  The link projection and the right hand side run on the world worker threads, but the forward and 
+  back substitution with the factor runs serially on one thread.
+*/
+void NewtonMassSpringDamperSystemSetImplicitSolver (const NewtonCollision* const massSpringSystem, int state, int iterations)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)massSpringSystem;
+	if (collision->IsType(dgCollision::dgCollisionMassSpringDamperSystem_RTTI)) {
+		dgCollisionMassSpringDamperSystem* const springSystem = (dgCollisionMassSpringDamperSystem*)collision->GetChildShape();
+		springSystem->SetImplicitSolver (state ? true : false, iterations);
+	}
+}
+
+/*!
+  Create a particle fluid volume solved as an incompressible fluid.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param shapeID is the user defined shape id.
+  @param *points is the array of initial particle positions.
+  @param pointCount is the number of particles.
+  @param strideInBytes is the distance in bytes between two consecutive particle positions.
+  @param particleRadius is the particle radius, particles at rest are spaced two radius apart.
+  @param restDensity is the density of the fluid, it sets the mass of the particles.
+
+  @return the particle fluid collision.
+
+  The volume must be assigned to a dynamic body with identity rotation, the body force callback
+  acceleration is applied to every particle. Bodies overlapping the volume act as boundaries
+  and receive the fluid pressure as impulses.
+*/
+NewtonCollision* NewtonCreateIncompressibleParticles (const NewtonWorld* const newtonWorld, int shapeID, const dFloat* const points, int pointCount, int strideInBytes, dFloat particleRadius, dFloat restDensity)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return (NewtonCollision*)world->CreateIncompressibleParticles (shapeID, pointCount, points, strideInBytes, particleRadius, restDensity);
+}
+
+/*!
+  Set the solver parameters of a particle fluid volume.
+
+  @param *fluid is the particle fluid collision.
+  @param iterations is the number of density constraint iterations per step, default is 4.
+  @param viscosity is the velocity smoothing factor in the range [0, 1], default is 0.01.
+*/
+void NewtonIncompressibleParticlesSetSolverParameters (const NewtonCollision* const fluid, int iterations, dFloat viscosity)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)fluid;
+	if (collision->IsType(dgCollision::dgCollisionIncompressibleParticles_RTTI)) {
+		dgCollisionIncompressibleParticles* const fluidShape = (dgCollisionIncompressibleParticles*)collision->GetChildShape();
+		fluidShape->SetSolverParameters (iterations, viscosity);
+	}
+}
+
 int NewtonDeformableMeshGetParticleCount(const NewtonCollision* const deformableMesh)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -73,9 +73,28 @@ extern "C" {
 	#define NEWTON_BROADPHASE_DEFAULT						0
 	#define NEWTON_BROADPHASE_PERSINTENT					1
 
+	#define NEWTON_THREADS_AFFINITY_NONE					0
+	#define NEWTON_THREADS_AFFINITY_PINNED					1
+	#define NEWTON_THREADS_AFFINITY_PACKAGE					2
+
+	#define NEWTON_PERFORMANCE_FORCE_AND_TORQUE				0
+	#define NEWTON_PERFORMANCE_BROADPHASE_UPDATE			1
+	#define NEWTON_PERFORMANCE_PAIR_FINDING					2
+	#define NEWTON_PERFORMANCE_NARROW_PHASE					3
+	#define NEWTON_PERFORMANCE_ISLAND_BUILD					4
+	#define NEWTON_PERFORMANCE_JACOBIAN_BUILD				5
+	#define NEWTON_PERFORMANCE_SOLVER_ITERATIONS			6
+	#define NEWTON_PERFORMANCE_INTEGRATION					7
+	#define NEWTON_PERFORMANCE_PHASES_COUNT					8
+
 	#define NEWTON_DYNAMIC_BODY								0
 	#define NEWTON_KINEMATIC_BODY							1
 //	#define NEWTON_DEFORMABLE_BODY							2
+	#define NEWTON_SENSOR_BODY								3
+
+	#define NEWTON_SENSOR_OVERLAP_BEGIN						0
+	#define NEWTON_SENSOR_OVERLAP_PERSIST					1
+	#define NEWTON_SENSOR_OVERLAP_END						2
 
 	#define SERIALIZE_ID_SPHERE								0
 	#define SERIALIZE_ID_CAPSULE							1
@@ -104,6 +123,7 @@ extern "C" {
 	class NewtonInverseDynamics;
 	class NewtonDeformableMeshSegment;
 	class NewtonFracturedCompoundMeshPart;
+	class NewtonWorldQueryCache;
 #else
 	typedef struct NewtonMesh{} NewtonMesh;
 	typedef struct NewtonBody{} NewtonBody;
@@ -115,6 +135,7 @@ extern "C" {
 	typedef struct NewtonDeformableMeshSegment{} NewtonDeformableMeshSegment;
 	typedef struct NewtonInverseDynamicsEffector {} NewtonInverseDynamicsEffector;
 	typedef struct NewtonFracturedCompoundMeshPart{} NewtonFracturedCompoundMeshPart;
+	typedef struct NewtonWorldQueryCache{} NewtonWorldQueryCache;
 #endif
 
 
@@ -281,6 +302,22 @@ extern "C" {
 		const NewtonBody* m_hitBody;			// body hit at contact point
 		dFloat m_penetration;                   // contact penetration at collision point
 	} NewtonWorldConvexCastReturnInfo;
+
+	typedef struct NewtonWorldRayCastBatchHit
+	{
+		dFloat m_point[4];						// hit point in global space
+		dFloat m_normal[4];						// surface normal at hit point in global space
+		dLong m_contactID;						// collision ID at hit point
+		const NewtonBody* m_hitBody;			// closest body hit by the ray, NULL if the ray did not hit anything
+		dFloat m_param;							// intersection parameter along the ray
+	} NewtonWorldRayCastBatchHit;
+
+	typedef struct NewtonWorldConvexCastBatchQuery
+	{
+		dFloat m_matrix[16];					// shape matrix in global space
+		dFloat m_target[4];						// end of the sweep in global space, not used by overlap queries
+		const NewtonCollision* m_shape;			// shape of the query
+	} NewtonWorldConvexCastBatchQuery;
 	
 	typedef struct NewtonUserMeshCollisionRayHitDesc
 	{
@@ -376,6 +413,7 @@ extern "C" {
 
 	typedef dFloat (*NewtonCollisionTreeRayCastCallback) (const NewtonBody* const body, const NewtonCollision* const treeCollision, dFloat intersection, dFloat* const normal, int faceId, void* const usedData);
 	typedef dFloat (*NewtonHeightFieldRayCastCallback) (const NewtonBody* const body, const NewtonCollision* const heightFieldCollision, dFloat intersection, int row, int col, dFloat* const normal, int faceId, void* const usedData);
+	typedef void (*NewtonHeightFieldPageInCallback) (void* const userData, int tileX, int tileZ, void* const elevation, char* const attributes);
 
 	typedef void (*NewtonCollisionCopyConstructionCallback) (const NewtonWorld* const newtonWorld, NewtonCollision* const collision, const NewtonCollision* const sourceCollision);
 	typedef void (*NewtonCollisionDestructorCallback) (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision);
@@ -385,6 +423,7 @@ extern "C" {
 												 int vertexCount, const dFloat* const vertex, int vertexStrideInBytes); 
 
 	typedef void (*NewtonBodyDestructor) (const NewtonBody* const body);
+	typedef void (*NewtonSensorEventCallback) (const NewtonBody* const sensor, const NewtonBody* const body, int eventType);
 	typedef void (*NewtonApplyForceAndTorque) (const NewtonBody* const body, dFloat timestep, int threadIndex);
 	typedef void (*NewtonSetTransform) (const NewtonBody* const body, const dFloat* const matrix, int threadIndex);
 
@@ -431,6 +470,8 @@ extern "C" {
 	NEWTON_API int NewtonGetMemoryUsed ();
 	NEWTON_API void NewtonSetMemorySystem (NewtonAllocMemory malloc, NewtonFreeMemory free);
 
+	NEWTON_API int NewtonTimeTrackerStartCapture (const char* const fileName, int framesCount);
+
 	NEWTON_API NewtonWorld* NewtonCreate ();
 	NEWTON_API void NewtonDestroy (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonDestroyAllBodies (const NewtonWorld* const newtonWorld);
@@ -487,6 +528,11 @@ extern "C" {
 	NEWTON_API void NewtonSetThreadsCount (const NewtonWorld* const newtonWorld, int threads);
 	NEWTON_API int NewtonGetThreadsCount(const NewtonWorld* const newtonWorld);
 	NEWTON_API int NewtonGetMaxThreadsCount(const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonGetProcessorsCount(const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetThreadsAffinityMode(const NewtonWorld* const newtonWorld, int mode);
+	NEWTON_API int NewtonGetThreadsAffinityMode(const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonGetThreadProcessor(const NewtonWorld* const newtonWorld, int threadIndex);
+	NEWTON_API int NewtonGetThreadPackage(const NewtonWorld* const newtonWorld, int threadIndex);
 	NEWTON_API void NewtonDispachThreadJob(const NewtonWorld* const newtonWorld, NewtonJobTask task, void* const usedData);
 	NEWTON_API void NewtonSyncThreadJobs(const NewtonWorld* const newtonWorld);
 
@@ -523,13 +569,33 @@ extern "C" {
 	NEWTON_API void NewtonWorldSetCollisionConstructorDestructorCallback (const NewtonWorld* const newtonWorld, NewtonCollisionCopyConstructionCallback constructor, NewtonCollisionDestructorCallback destructor);
 
 	NEWTON_API void NewtonWorldRayCast (const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, NewtonWorldRayFilterCallback filter, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
+	NEWTON_API int NewtonWorldRayCastBatch (const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, int strideInBytes, int raysCount, NewtonWorldRayCastBatchHit* const hits, void* const userData, NewtonWorldRayPrefilterCallback prefilter);
 	NEWTON_API int NewtonWorldConvexCast (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
 	NEWTON_API int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
+	NEWTON_API int NewtonWorldConvexCastBatch (const NewtonWorld* const newtonWorld, const NewtonWorldConvexCastBatchQuery* const queries, int queriesCount, dFloat* const params, int* const contactsCount, NewtonWorldConvexCastReturnInfo* const info, int maxContactsPerQuery, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
+	NEWTON_API int NewtonWorldCollideBatch (const NewtonWorld* const newtonWorld, const NewtonWorldConvexCastBatchQuery* const queries, int queriesCount, int* const contactsCount, NewtonWorldConvexCastReturnInfo* const info, int maxContactsPerQuery, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
+
+	NEWTON_API NewtonWorldQueryCache* NewtonWorldCreateQueryCache (const NewtonWorld* const newtonWorld, dFloat padding);
+	NEWTON_API void NewtonWorldDestroyQueryCache (const NewtonWorld* const newtonWorld, NewtonWorldQueryCache* const cache);
+	NEWTON_API int NewtonWorldConvexCastCached (const NewtonWorld* const newtonWorld, NewtonWorldQueryCache* const cache, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
+	NEWTON_API int NewtonWorldCollideCached (const NewtonWorld* const newtonWorld, NewtonWorldQueryCache* const cache, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
 	
 	// world utility functions
 	NEWTON_API int NewtonWorldGetBodyCount(const NewtonWorld* const newtonWorld);
 	NEWTON_API int NewtonWorldGetConstraintCount(const NewtonWorld* const newtonWorld);
 
+	NEWTON_API int NewtonWorldGetFrameArenaCount(const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldReserveFrameArena(const NewtonWorld* const newtonWorld, int arenaIndex, int sizeInBytes);
+	NEWTON_API void NewtonWorldGetFrameArenaStatistics(const NewtonWorld* const newtonWorld, int arenaIndex, int* const highWaterMarkInBytes, int* const capacityInBytes, int* const allocationsCount);
+
+	NEWTON_API int NewtonWorldGetMemoryBinCount(const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldGetMemoryBinCounters(const NewtonWorld* const newtonWorld, int binIndex, int* const blockSizeInBytes, dLong* const hits, dLong* const misses, dLong* const bytesLive);
+
+	NEWTON_API int NewtonWorldGetPerformanceCountersState(const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldSetPerformanceCountersState(const NewtonWorld* const newtonWorld, int state);
+	NEWTON_API void NewtonWorldGetPerformanceCounters(const NewtonWorld* const newtonWorld, int threadIndex, dFloat* const phaseTimesInMicroseconds);
+	NEWTON_API void NewtonWorldGetPerformanceCounts(const NewtonWorld* const newtonWorld, int* const activeBodies, int* const activeContacts, int* const activeJoints, int* const jointRows, int* const clusters);
+
 	// **********************************************************************************************
 	//
 	// Simulation islands 
@@ -734,6 +800,8 @@ extern "C" {
 	// ***********************************************************************************************************
 	NEWTON_API NewtonCollision* NewtonCreateCollisionFromSerialization (const NewtonWorld* const newtonWorld, NewtonDeserializeCallback deserializeFunction, void* const serializeHandle);
 	NEWTON_API void NewtonCollisionSerialize (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, NewtonSerializeCallback serializeFunction, void* const serializeHandle);
+	NEWTON_API int NewtonCollisionSerializeImage (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, NewtonSerializeCallback serializeFunction, void* const serializeHandle);
+	NEWTON_API NewtonCollision* NewtonCreateCollisionFromImage (const NewtonWorld* const newtonWorld, const void* const image, dLong sizeInBytes);
 	NEWTON_API void NewtonCollisionGetInfo (const NewtonCollision* const collision, NewtonCollisionInfoRecord* const collisionInfo);
 
 	// **********************************************************************************************
@@ -743,6 +811,10 @@ extern "C" {
 	// **********************************************************************************************
 	NEWTON_API NewtonCollision* NewtonCreateHeightFieldCollision (const NewtonWorld* const newtonWorld, int width, int height, int gridsDiagonals, int elevationdatType,
 																  const void* const elevationMap, const char* const attributeMap, dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID);
+	NEWTON_API NewtonCollision* NewtonCreateTiledHeightFieldCollision (const NewtonWorld* const newtonWorld, int width, int height, int gridsDiagonals, int elevationdatType,
+																	   int tileSize, int maxResidentTiles, dFloat minElevation, dFloat maxElevation, NewtonHeightFieldPageInCallback pageInCallback, void* const pageInUserData, 
+																	   dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID);
+	NEWTON_API int NewtonHeightFieldGetResidentTilesCount (const NewtonCollision* const heightfieldCollision);
 	NEWTON_API void NewtonHeightFieldSetUserRayCastCallback (const NewtonCollision* const heightfieldCollision, NewtonHeightFieldRayCastCallback rayHitCallback);
 	NEWTON_API void NewtonHeightFieldSetHorizontalDisplacement (const NewtonCollision* const heightfieldCollision, const unsigned short* const horizontalMap, dFloat scale);
 
@@ -753,6 +825,7 @@ extern "C" {
 	NEWTON_API void NewtonTreeCollisionBeginBuild (const NewtonCollision* const treeCollision);
 	NEWTON_API void NewtonTreeCollisionAddFace (const NewtonCollision* const treeCollision, int vertexCount, const dFloat* const vertexPtr, int strideInBytes, int faceAttribute);
 	NEWTON_API void NewtonTreeCollisionEndBuild (const NewtonCollision* const treeCollision, int optimize);
+	NEWTON_API void NewtonTreeCollisionGetBuildTimings (const NewtonCollision* const treeCollision, dFloat* const faceMergeTimeInMicroseconds, dFloat* const treeBuildTimeInMicroseconds, dFloat* const adjacencyTimeInMicroseconds);
 
 	NEWTON_API int NewtonTreeCollisionGetFaceAttribute (const NewtonCollision* const treeCollision, const int* const faceIndexArray, int indexCount); 
 	NEWTON_API void NewtonTreeCollisionSetFaceAttribute (const NewtonCollision* const treeCollision, const int* const faceIndexArray, int indexCount, int attribute);
@@ -858,6 +931,7 @@ extern "C" {
 	// **********************************************************************************************
 	NEWTON_API NewtonBody* NewtonCreateDynamicBody (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, const dFloat* const matrix);
 	NEWTON_API NewtonBody* NewtonCreateKinematicBody (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, const dFloat* const matrix);
+	NEWTON_API NewtonBody* NewtonCreateSensorBody (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, const dFloat* const matrix);
 
 	NEWTON_API void NewtonDestroyBody(const NewtonBody* const body);
 
@@ -868,6 +942,9 @@ extern "C" {
 	NEWTON_API int NewtonBodyGetCollidable (const NewtonBody* const body);
 	NEWTON_API void NewtonBodySetCollidable (const NewtonBody* const body, int collidableState);
 
+	NEWTON_API void NewtonSensorSetEventCallback (const NewtonBody* const sensor, NewtonSensorEventCallback callback);
+	NEWTON_API NewtonSensorEventCallback NewtonSensorGetEventCallback (const NewtonBody* const sensor);
+
 	NEWTON_API void  NewtonBodyAddForce (const NewtonBody* const body, const dFloat* const force);
 	NEWTON_API void  NewtonBodyAddTorque (const NewtonBody* const body, const dFloat* const torque);
 	NEWTON_API void  NewtonBodyCalculateInverseDynamicsForce (const NewtonBody* const body, dFloat timestep, const dFloat* const desiredVeloc, dFloat* const forceOut);
@@ -1040,8 +1117,11 @@ extern "C" {
 	NEWTON_API NewtonCollision* NewtonCreateMassSpringDamperSystem (const NewtonWorld* const newtonWorld, int shapeID,
 																	const dFloat* const points, int pointCount, int strideInBytes, const dFloat* const pointMass, 
 																	const int* const links, int linksCount, const dFloat* const linksSpring, const dFloat* const linksDamper);
+	NEWTON_API void NewtonMassSpringDamperSystemSetImplicitSolver (const NewtonCollision* const massSpringSystem, int state, int iterations);
 
 	NEWTON_API NewtonCollision* NewtonCreateDeformableSolid(const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, int shapeID);
+	NEWTON_API NewtonCollision* NewtonCreateIncompressibleParticles (const NewtonWorld* const newtonWorld, int shapeID, const dFloat* const points, int pointCount, int strideInBytes, dFloat particleRadius, dFloat restDensity);
+	NEWTON_API void NewtonIncompressibleParticlesSetSolverParameters (const NewtonCollision* const fluid, int iterations, dFloat viscosity);
 
 	NEWTON_API int NewtonDeformableMeshGetParticleCount (const NewtonCollision* const deformableMesh); 
 	NEWTON_API int NewtonDeformableMeshGetParticleStrideInBytes (const NewtonCollision* const deformableMesh); 
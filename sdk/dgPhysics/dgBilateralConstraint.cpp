@@ -228,10 +228,10 @@ void dgBilateralConstraint::SetSpringDamperAcceleration (dgInt32 index, dgContra
 		const dgJacobian &jacobian0 = desc.m_jacobian[index].m_jacobianM0; 
 		const dgJacobian &jacobian1 = desc.m_jacobian[index].m_jacobianM1; 
 
-		const dgVector& veloc0 = m_body0->m_veloc;
-		const dgVector& omega0 = m_body0->m_omega;
-		const dgVector& veloc1 = m_body1->m_veloc;
-		const dgVector& omega1 = m_body1->m_omega;
+		const dgVector& veloc0 = m_body0->m_state->m_veloc;
+		const dgVector& omega0 = m_body0->m_state->m_omega;
+		const dgVector& veloc1 = m_body1->m_state->m_veloc;
+		const dgVector& omega1 = m_body1->m_state->m_omega;
 
 		//dgFloat32 relPosit = (p1Global - p0Global) % jacobian0.m_linear + jointAngle;
 		dgFloat32 relPosit = desc.m_penetration[index];
@@ -401,10 +401,10 @@ dgFloat32 dgBilateralConstraint::GetInverseDynamicAcceleration(dgInt32 index) co
 void dgBilateralConstraint::JointAccelerations(dgJointAccelerationDecriptor* const params)
 {
 	dgJacobianMatrixElement* const jacobianMatrixElements = params->m_rowMatrix;
-	const dgVector& bodyVeloc0 = m_body0->m_veloc;
-	const dgVector& bodyOmega0 = m_body0->m_omega;
-	const dgVector& bodyVeloc1 = m_body1->m_veloc;
-	const dgVector& bodyOmega1 = m_body1->m_omega;
+	const dgVector& bodyVeloc0 = m_body0->m_state->m_veloc;
+	const dgVector& bodyOmega0 = m_body0->m_state->m_omega;
+	const dgVector& bodyVeloc1 = m_body1->m_state->m_veloc;
+	const dgVector& bodyOmega1 = m_body1->m_state->m_omega;
 
 // remember the impulse branch 
 //dgAssert (params->m_timeStep > dgFloat32 (0.0f));
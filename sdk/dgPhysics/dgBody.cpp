@@ -40,32 +40,31 @@
 
 dgBody::dgBody()
 	:m_invWorldInertiaMatrix(dgGetZeroMatrix())
-	,m_matrix (dgGetIdentityMatrix())
 	,m_rotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
 	,m_mass(dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f))
 	,m_invMass(dgFloat32 (0.0f))
-	,m_veloc(dgFloat32 (0.0f))
-	,m_omega(dgFloat32 (0.0f))
 	,m_accel(dgFloat32 (0.0f))
 	,m_alpha(dgFloat32 (0.0f))
-	,m_minAABB(dgFloat32 (0.0f))
-	,m_maxAABB(dgFloat32 (0.0f))
 	,m_localCentreOfMass(dgFloat32 (0.0f))	
 	,m_globalCentreOfMass(dgFloat32 (0.0f))	
 	,m_impulseForce(dgFloat32 (0.0f))		
 	,m_impulseTorque(dgFloat32 (0.0f))		
 	,m_maxAngulaRotationPerSet2(DG_MAX_ANGLE_STEP * DG_MAX_ANGLE_STEP )
 	,m_criticalSectionLock()
-	,m_flags(0)
+	,m_state(&m_detachedState)
+	,m_detachedState()
 	,m_userData(NULL)
 	,m_world(NULL)
 	,m_collision(NULL)
 	,m_broadPhaseNode(NULL)
 	,m_masterNode(NULL)
+	,m_island(NULL)
+	,m_islandLink(NULL)
 	,m_broadPhaseaggregateNode(NULL)
 	,m_destructor(NULL)
 	,m_matrixUpdate(NULL)
 	,m_index(0)
+	,m_masterIndex(-1)
 	,m_uniqueID(0)
 	,m_bodyGroupId(0)
 	,m_rtti(m_baseBodyRTTI)
@@ -74,41 +73,40 @@ dgBody::dgBody()
 	,m_dynamicsLru(0)
 	,m_genericLRUMark(0)
 {
-	m_autoSleep = true;
-	m_collidable = true;
-	m_transformIsDirty = true;
-	m_collideWithLinkedBodies = true;
+	m_state->m_autoSleep = true;
+	m_state->m_collidable = true;
+	m_state->m_transformIsDirty = true;
+	m_state->m_collideWithLinkedBodies = true;
 	m_invWorldInertiaMatrix[3][3] = dgFloat32 (1.0f);
 }
 
 dgBody::dgBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>* const collisionCashe, dgDeserialize serializeCallback, void* const userData, dgInt32 revisionNumber)
 	:m_invWorldInertiaMatrix(dgGetZeroMatrix())
-	,m_matrix (dgGetIdentityMatrix())
 	,m_rotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
 	,m_mass(dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f))
 	,m_invMass(dgFloat32 (0.0f))
-	,m_veloc(dgFloat32 (0.0f))
-	,m_omega(dgFloat32 (0.0f))
 	,m_accel(dgFloat32 (0.0f))
 	,m_alpha(dgFloat32 (0.0f))
-	,m_minAABB(dgFloat32 (0.0f))
-	,m_maxAABB(dgFloat32 (0.0f))
 	,m_localCentreOfMass(dgFloat32 (0.0f))	
 	,m_globalCentreOfMass(dgFloat32 (0.0f))	
 	,m_impulseForce(dgFloat32 (0.0f))		
 	,m_impulseTorque(dgFloat32 (0.0f))		
 	,m_maxAngulaRotationPerSet2(DG_MAX_ANGLE_STEP * DG_MAX_ANGLE_STEP )
 	,m_criticalSectionLock()
-	,m_flags(0)
+	,m_state(&m_detachedState)
+	,m_detachedState()
 	,m_userData(NULL)
 	,m_world(world)
 	,m_collision(NULL)
 	,m_broadPhaseNode(NULL)
 	,m_masterNode(NULL)
+	,m_island(NULL)
+	,m_islandLink(NULL)
 	,m_broadPhaseaggregateNode(NULL)
 	,m_destructor(NULL)
 	,m_matrixUpdate(NULL)
 	,m_index(0)
+	,m_masterIndex(-1)
 	,m_uniqueID(0)
 	,m_bodyGroupId(0)
 	,m_rtti(m_baseBodyRTTI)
@@ -117,21 +115,21 @@ dgBody::dgBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>*
 	,m_dynamicsLru(0)
 	,m_genericLRUMark(0)
 {
-	m_autoSleep = true;
-	m_collidable = true;
-	m_transformIsDirty = true;
-	m_collideWithLinkedBodies = true;
+	m_state->m_autoSleep = true;
+	m_state->m_collidable = true;
+	m_state->m_transformIsDirty = true;
+	m_state->m_collideWithLinkedBodies = true;
 	m_invWorldInertiaMatrix[3][3] = dgFloat32 (1.0f);
 
 	serializeCallback (userData, &m_rotation, sizeof (m_rotation));
-	serializeCallback (userData, &m_matrix, sizeof (m_matrix));
-	serializeCallback (userData, &m_veloc, sizeof (m_veloc));
-	serializeCallback (userData, &m_omega, sizeof (m_omega));
-	serializeCallback (userData, &m_accel, sizeof (m_veloc));
-	serializeCallback (userData, &m_alpha, sizeof (m_omega));
+	serializeCallback (userData, &m_state->m_matrix, sizeof (m_state->m_matrix));
+	serializeCallback (userData, &m_state->m_veloc, sizeof (m_state->m_veloc));
+	serializeCallback (userData, &m_state->m_omega, sizeof (m_state->m_omega));
+	serializeCallback (userData, &m_accel, sizeof (m_state->m_veloc));
+	serializeCallback (userData, &m_alpha, sizeof (m_state->m_omega));
 	serializeCallback (userData, &m_localCentreOfMass, sizeof (m_localCentreOfMass));
 	serializeCallback (userData, &m_mass, sizeof (m_mass));
-	serializeCallback (userData, &m_flags, sizeof (m_flags));
+	serializeCallback (userData, &m_state->m_flags, sizeof (m_state->m_flags));
 	serializeCallback (userData, &m_maxAngulaRotationPerSet2, sizeof (m_maxAngulaRotationPerSet2));
 	serializeCallback (userData, &m_serializedEnum, sizeof(dgInt32));
 
@@ -178,20 +176,20 @@ void dgBody::AttachCollision (dgCollisionInstance* const collisionSrc)
 		m_collision->Release();
 	}
 	m_collision = instance;
-	m_equilibrium = 0;
+	m_state->m_equilibrium = 0;
 }
 
 void dgBody::Serialize (const dgTree<dgInt32, const dgCollision*>& collisionRemapId, dgSerialize serializeCallback, void* const userData)
 {
 	serializeCallback (userData, &m_rotation, sizeof (m_rotation));
-	serializeCallback (userData, &m_matrix, sizeof (m_matrix));
-	serializeCallback (userData, &m_veloc, sizeof (m_veloc));
-	serializeCallback (userData, &m_omega, sizeof (m_omega));
-	serializeCallback (userData, &m_accel, sizeof (m_veloc));
-	serializeCallback (userData, &m_alpha, sizeof (m_omega));
+	serializeCallback (userData, &m_state->m_matrix, sizeof (m_state->m_matrix));
+	serializeCallback (userData, &m_state->m_veloc, sizeof (m_state->m_veloc));
+	serializeCallback (userData, &m_state->m_omega, sizeof (m_state->m_omega));
+	serializeCallback (userData, &m_accel, sizeof (m_state->m_veloc));
+	serializeCallback (userData, &m_alpha, sizeof (m_state->m_omega));
 	serializeCallback (userData, &m_localCentreOfMass, sizeof (m_localCentreOfMass));
 	serializeCallback(userData, &m_mass, sizeof (m_mass));
-	serializeCallback (userData, &m_flags, sizeof (m_flags));
+	serializeCallback (userData, &m_state->m_flags, sizeof (m_state->m_flags));
 	serializeCallback (userData, &m_maxAngulaRotationPerSet2, sizeof (m_maxAngulaRotationPerSet2));
 	serializeCallback(userData, &m_serializedEnum, sizeof(dgInt32));
 
@@ -217,7 +215,7 @@ void dgBody::SetMatrix(const dgMatrix& matrix)
 {
 	SetMatrixOriginAndRotation(matrix);
 
-	if (!m_inCallback) {
+	if (!m_state->m_inCallback) {
 		UpdateCollisionMatrix (dgFloat32 (0.0f), 0);
 	}
 }
@@ -229,33 +227,33 @@ void dgBody::SetMatrixNoSleep(const dgMatrix& matrix)
 
 void dgBody::SetMatrixResetSleep(const dgMatrix& matrix)
 {
-	m_sleeping = false;
+	m_state->m_sleeping = false;
 	SetMatrix(matrix);
 }
 
 void dgBody::UpdateWorlCollisionMatrix() const
 {
-	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * m_matrix);
+	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * m_state->m_matrix);
 }
 
 
 
 void dgBody::UpdateCollisionMatrix (dgFloat32 timestep, dgInt32 threadIndex)
 {
-	m_transformIsDirty = true;
-	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * m_matrix);
-	m_collision->CalcAABB (m_collision->GetGlobalMatrix(), m_minAABB, m_maxAABB);
+	m_state->m_transformIsDirty = true;
+	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * m_state->m_matrix);
+	m_collision->CalcAABB (m_collision->GetGlobalMatrix(), m_state->m_minAABB, m_state->m_maxAABB);
 
-	if (m_continueCollisionMode) {
+	if (m_state->m_continueCollisionMode) {
 		dgVector predictiveVeloc (PredictLinearVelocity(timestep));
 		dgVector predictiveOmega (PredictAngularVelocity(timestep));
-		dgMovingAABB (m_minAABB, m_maxAABB, predictiveVeloc, predictiveOmega, timestep, m_collision->GetBoxMaxRadius(), m_collision->GetBoxMinRadius());
+		dgMovingAABB (m_state->m_minAABB, m_state->m_maxAABB, predictiveVeloc, predictiveOmega, timestep, m_collision->GetBoxMaxRadius(), m_collision->GetBoxMinRadius());
 	}
 
 	if (m_broadPhaseNode) {
 		dgAssert (m_world);
 		
-		if (!m_equilibrium) {
+		if (!m_state->m_equilibrium) {
 			m_world->GetBroadPhase()->UpdateBody (this, threadIndex);
 		}
 	}
@@ -267,7 +265,7 @@ dgFloat32 dgBody::RayCast (const dgLineBox& line, OnRayCastAction filter, OnRayP
 	dgAssert (filter);
 	dgVector l0 (line.m_l0);
 	dgVector l1 (line.m_l0 + (line.m_l1 - line.m_l0).Scale4 (dgMin(maxT, dgFloat32 (1.0f))));
-	if (dgRayBoxClip (l0, l1, m_minAABB, m_maxAABB)) {
+	if (dgRayBoxClip (l0, l1, m_state->m_minAABB, m_state->m_maxAABB)) {
 //	if (1) {
 //l0 = dgVector (-20.3125000f, 3.54991579f, 34.3441200f, 0.0f);
 //l1 = dgVector (-19.6875000f, 3.54257250f, 35.2211456f, 0.0f);
@@ -309,25 +307,25 @@ void dgBody::IntegrateVelocity (dgFloat32 timestep)
 {
 	//dgTrace (("%d p(%f %f %f)\n", m_uniqueID, m_globalCentreOfMass[0], m_globalCentreOfMass[1], m_globalCentreOfMass[2]));
 
-	m_globalCentreOfMass += m_veloc.Scale3 (timestep); 
-	while ((m_omega.DotProduct3(m_omega) * timestep * timestep) > m_maxAngulaRotationPerSet2) {
-		m_omega = m_omega.Scale4 (dgFloat32 (0.9f));
+	m_globalCentreOfMass += m_state->m_veloc.Scale3 (timestep); 
+	while ((m_state->m_omega.DotProduct3(m_state->m_omega) * timestep * timestep) > m_maxAngulaRotationPerSet2) {
+		m_state->m_omega = m_state->m_omega.Scale4 (dgFloat32 (0.9f));
 	}
 
 	// this is correct
-	dgFloat32 omegaMag2 = m_omega.DotProduct3(m_omega);
+	dgFloat32 omegaMag2 = m_state->m_omega.DotProduct3(m_state->m_omega);
 	if (omegaMag2 > ((dgFloat32 (0.0125f) * dgDEG2RAD) * (dgFloat32 (0.0125f) * dgDEG2RAD))) {
 		dgFloat32 invOmegaMag = dgRsqrt (omegaMag2);
-		dgVector omegaAxis (m_omega.Scale4 (invOmegaMag));
+		dgVector omegaAxis (m_state->m_omega.Scale4 (invOmegaMag));
 		dgFloat32 omegaAngle = invOmegaMag * omegaMag2 * timestep;
 		dgQuaternion rotation (omegaAxis, omegaAngle);
 		m_rotation = m_rotation * rotation;
 		m_rotation.Scale(dgRsqrt (m_rotation.DotProduct (m_rotation)));
-		m_matrix = dgMatrix (m_rotation, m_matrix.m_posit);
+		m_state->m_matrix = dgMatrix (m_rotation, m_state->m_matrix.m_posit);
 	}
 
-	m_matrix.m_posit = m_globalCentreOfMass - m_matrix.RotateVector(m_localCentreOfMass);
-	dgAssert (m_matrix.TestOrthogonal());
+	m_state->m_matrix.m_posit = m_globalCentreOfMass - m_state->m_matrix.RotateVector(m_localCentreOfMass);
+	dgAssert (m_state->m_matrix.TestOrthogonal());
 }
 
 
@@ -431,8 +429,8 @@ void dgBody::SetFreeze (bool state)
 void dgBody::Freeze ()
 {
 	if (GetInvMass().m_w > dgFloat32 (0.0f)) {
-		if (!m_freeze) {
-			m_freeze = true;
+		if (!m_state->m_freeze) {
+			m_state->m_freeze = true;
 			for (dgBodyMasterListRow::dgListNode* node = m_masterNode->GetInfo().GetFirst(); node; node = node->GetNext()) {
 				dgBody* const body = node->GetInfo().m_bodyNode;
 				body->Freeze ();
@@ -446,8 +444,8 @@ void dgBody::Unfreeze ()
 	if (GetInvMass().m_w > dgFloat32 (0.0f)) {
 // note this is in observation (to prevent bodies from not going to sleep  inside triggers	               
 //		m_equilibrium = false;			
-		if (m_freeze) {
-			m_freeze = false;
+		if (m_state->m_freeze) {
+			m_state->m_freeze = false;
 			for (dgBodyMasterListRow::dgListNode* node = m_masterNode->GetInfo().GetFirst(); node; node = node->GetNext()) {
 				dgBody* const body = node->GetInfo().m_bodyNode;
 				body->Unfreeze ();
@@ -473,6 +471,7 @@ void dgBody::SetMassMatrix(dgFloat32 mass, const dgMatrix& inertia)
 
 	//dgAssert (m_masterNode);
 	m_world->GetBroadPhase()->CheckStaticDynamic(this, mass);
+	const bool hadFiniteMass = m_invMass.m_w > dgFloat32 (0.0f);
 
 	if (mass >= DG_INFINITE_MASS) {
 		m_mass.m_x = DG_INFINITE_MASS;
@@ -520,6 +519,11 @@ void dgBody::SetMassMatrix(dgFloat32 mass, const dgMatrix& inertia)
 		}
 	}
 
+	if (m_masterNode && (hadFiniteMass != (m_invMass.m_w > dgFloat32 (0.0f)))) {
+		dgBodyMasterList& masterList (*m_world);
+		masterList.UpdateBodyIsland (this);
+	}
+
 
 #ifdef _DEBUG
 	dgBodyMasterList& me = *m_world;
@@ -575,27 +579,28 @@ dgMatrix dgBody::CalculateLocalInertiaMatrix () const
 dgMatrix dgBody::CalculateInertiaMatrix () const
 {
 #if 0
-	dgMatrix tmp (m_matrix.Transpose4X4());
+	dgMatrix tmp (m_state->m_matrix.Transpose4X4());
 	dgVector mass (m_mass & dgVector::m_triplexMask);
 	tmp[0] = tmp[0] * mass;
 	tmp[1] = tmp[1] * mass;
 	tmp[2] = tmp[2] * mass;
-	return dgMatrix (m_matrix.RotateVector(tmp[0]), m_matrix.RotateVector(tmp[1]), m_matrix.RotateVector(tmp[2]), dgVector::m_wOne);
+	return dgMatrix (m_state->m_matrix.RotateVector(tmp[0]), m_state->m_matrix.RotateVector(tmp[1]), m_state->m_matrix.RotateVector(tmp[2]), dgVector::m_wOne);
 #else
+	const dgMatrix& matrix = m_state->m_matrix;
 	const dgVector Ixx(m_mass[0]);
 	const dgVector Iyy(m_mass[1]);
 	const dgVector Izz(m_mass[2]);
-	return dgMatrix (m_matrix.m_front.Scale4(m_matrix.m_front[0]) * Ixx +
-					 m_matrix.m_up.Scale4(m_matrix.m_up[0])		  * Iyy +
-					 m_matrix.m_right.Scale4(m_matrix.m_right[0]) * Izz,
+	return dgMatrix (matrix.m_front.Scale4(matrix.m_front[0]) * Ixx +
+					 matrix.m_up.Scale4(matrix.m_up[0])		  * Iyy +
+					 matrix.m_right.Scale4(matrix.m_right[0]) * Izz,
 
-					 m_matrix.m_front.Scale4(m_matrix.m_front[1]) * Ixx +
-					 m_matrix.m_up.Scale4(m_matrix.m_up[1])       * Iyy +
-					 m_matrix.m_right.Scale4(m_matrix.m_right[1]) * Izz,
+					 matrix.m_front.Scale4(matrix.m_front[1]) * Ixx +
+					 matrix.m_up.Scale4(matrix.m_up[1])       * Iyy +
+					 matrix.m_right.Scale4(matrix.m_right[1]) * Izz,
 
-					 m_matrix.m_front.Scale4(m_matrix.m_front[2]) * Ixx +
-					 m_matrix.m_up.Scale4(m_matrix.m_up[2])       * Iyy +
-					 m_matrix.m_right.Scale4(m_matrix.m_right[2]) * Izz,
+					 matrix.m_front.Scale4(matrix.m_front[2]) * Ixx +
+					 matrix.m_up.Scale4(matrix.m_up[2])       * Iyy +
+					 matrix.m_right.Scale4(matrix.m_right[2]) * Izz,
 					 dgVector::m_wOne);
 #endif
 }
@@ -603,36 +608,37 @@ dgMatrix dgBody::CalculateInertiaMatrix () const
 dgMatrix dgBody::CalculateInvInertiaMatrix () const
 {
 #if 0
-	dgMatrix tmp (m_matrix.Transpose4X4());
+	dgMatrix tmp (m_state->m_matrix.Transpose4X4());
 	tmp[0] = tmp[0] * m_invMass;
 	tmp[1] = tmp[1] * m_invMass;
 	tmp[2] = tmp[2] * m_invMass;
-	return dgMatrix (m_matrix.RotateVector(tmp[0]), m_matrix.RotateVector(tmp[1]), m_matrix.RotateVector(tmp[2]), dgVector::m_wOne);
+	return dgMatrix (m_state->m_matrix.RotateVector(tmp[0]), m_state->m_matrix.RotateVector(tmp[1]), m_state->m_matrix.RotateVector(tmp[2]), dgVector::m_wOne);
 #else
+	const dgMatrix& matrix = m_state->m_matrix;
 	const dgVector invIxx(m_invMass[0]);
 	const dgVector invIyy(m_invMass[1]);
 	const dgVector invIzz(m_invMass[2]);
-	return dgMatrix(m_matrix.m_front.Scale4(m_matrix.m_front[0]) * invIxx +
-					m_matrix.m_up.Scale4(m_matrix.m_up[0])		 * invIyy +
-					m_matrix.m_right.Scale4(m_matrix.m_right[0]) * invIzz,
+	return dgMatrix(matrix.m_front.Scale4(matrix.m_front[0]) * invIxx +
+					matrix.m_up.Scale4(matrix.m_up[0])		 * invIyy +
+					matrix.m_right.Scale4(matrix.m_right[0]) * invIzz,
 
-					m_matrix.m_front.Scale4(m_matrix.m_front[1]) * invIxx +
-					m_matrix.m_up.Scale4(m_matrix.m_up[1])		 * invIyy +
-					m_matrix.m_right.Scale4(m_matrix.m_right[1]) * invIzz,
+					matrix.m_front.Scale4(matrix.m_front[1]) * invIxx +
+					matrix.m_up.Scale4(matrix.m_up[1])		 * invIyy +
+					matrix.m_right.Scale4(matrix.m_right[1]) * invIzz,
 
-					m_matrix.m_front.Scale4(m_matrix.m_front[2]) * invIxx +
-					m_matrix.m_up.Scale4(m_matrix.m_up[2])		 * invIyy +
-					m_matrix.m_right.Scale4(m_matrix.m_right[2]) * invIzz,
+					matrix.m_front.Scale4(matrix.m_front[2]) * invIxx +
+					matrix.m_up.Scale4(matrix.m_up[2])		 * invIyy +
+					matrix.m_right.Scale4(matrix.m_right[2]) * invIzz,
 					dgVector::m_wOne);
 #endif
 }
 
 void dgBody::InvalidateCache ()
 {
-	m_sleeping = false;
-	m_equilibrium = false;
+	m_state->m_sleeping = false;
+	m_state->m_equilibrium = false;
 	m_genericLRUMark = 0;
-	dgMatrix matrix (m_matrix);
+	dgMatrix matrix (m_state->m_matrix);
 	SetMatrixOriginAndRotation(matrix);
 }
 
@@ -689,8 +695,8 @@ void dgBody::AddImpulse (const dgVector& pointDeltaVeloc, const dgVector& pointP
 	m_impulseForce += changeOfMomentum.Scale4(1.0f / timestep);
 	m_impulseTorque += globalContact.CrossProduct3(m_impulseForce);
 
-	m_sleeping	= false;
-	m_equilibrium = false;
+	m_state->m_sleeping	= false;
+	m_state->m_equilibrium = false;
 	Unfreeze ();
 }
 
@@ -706,8 +712,8 @@ void dgBody::ApplyImpulsePair (const dgVector& linearImpulseIn, const dgVector&
 	m_impulseForce += linearImpulseIn.Scale4(1.0f / timestep);
 	m_impulseTorque += angularImpulseIn.Scale4(1.0f / timestep);
 
-	m_sleeping	= false;
-	m_equilibrium = false;
+	m_state->m_sleeping	= false;
+	m_state->m_equilibrium = false;
 	Unfreeze ();
 }
 
@@ -739,8 +745,8 @@ void dgBody::ApplyImpulsesAtPoint (dgInt32 count, dgInt32 strideInBytes, const d
 	m_impulseForce += impulse.Scale4(1.0f / timestep);
 	m_impulseTorque += angularImpulse.Scale4(1.0f / timestep);
 
-	m_sleeping	= false;
-	m_equilibrium = false;
+	m_state->m_sleeping	= false;
+	m_state->m_equilibrium = false;
 	Unfreeze ();
 }
 
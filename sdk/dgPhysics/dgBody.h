@@ -42,7 +42,7 @@ class dgBroadPhaseAggregate;
 #define DG_MINIMUM_MASS		dgFloat32(1.0e-5f)
 #define DG_INFINITE_MASS	dgFloat32(1.0e15f)
 
-#define OverlapTest(body0,body1) dgOverlapTest ((body0)->m_minAABB, (body0)->m_maxAABB, (body1)->m_minAABB, (body1)->m_maxAABB)
+#define OverlapTest(body0,body1) dgOverlapTest ((body0)->m_state->m_minAABB, (body0)->m_state->m_maxAABB, (body1)->m_state->m_minAABB, (body1)->m_state->m_maxAABB)
 
 
 
@@ -70,6 +70,7 @@ class dgBody
 		m_dynamicBodyRTTI = 1<<1,
 		m_kinematicBodyRTTI = 1<<2,
 		//m_deformableBodyRTTI = 1<<3,
+		m_sensorBodyRTTI = 1<<4,
 	};
 
 	enum dgType
@@ -77,6 +78,7 @@ class dgBody
 		m_dynamicBody = 0,
 		m_kinematicBody,
 		//m_deformableBody,
+		m_sensorBody,
 	};
 
 	DG_CLASS_ALLOCATOR(allocator)
@@ -228,16 +230,11 @@ class dgBody
 	void ApplyGyroTorque ();
 
 	dgMatrix m_invWorldInertiaMatrix;
-	dgMatrix m_matrix;
 	dgQuaternion m_rotation;
 	dgVector m_mass;
 	dgVector m_invMass;
-	dgVector m_veloc;
-	dgVector m_omega;
 	dgVector m_accel;
 	dgVector m_alpha;
-	dgVector m_minAABB;
-	dgVector m_maxAABB;
 	dgVector m_localCentreOfMass;	
 	dgVector m_globalCentreOfMass;	
 	dgVector m_impulseForce;	
@@ -245,34 +242,25 @@ class dgBody
 
 	dgFloat32 m_maxAngulaRotationPerSet2;
 	dgThread::dgCriticalSection m_criticalSectionLock;
-	union 
-	{
-		dgUnsigned32 m_flags;
-		struct {
-			dgUnsigned32 m_freeze					: 1;
-			dgUnsigned32 m_resting					: 1;
-			dgUnsigned32 m_sleeping					: 1;
-			dgUnsigned32 m_autoSleep				: 1;
-			dgUnsigned32 m_inCallback				: 1;
-			dgUnsigned32 m_collidable				: 1;
-			dgUnsigned32 m_equilibrium				: 1;
-			dgUnsigned32 m_spawnnedFromCallback		: 1;
-			dgUnsigned32 m_continueCollisionMode	: 1;
-			dgUnsigned32 m_collideWithLinkedBodies	: 1;
-			dgUnsigned32 m_transformIsDirty			: 1;
-		};
-	};
+
+	// matrix, velocities, aabb and flags, in the world body state table while the body is in the 
+	// master list, and in m_detachedState while it is not
+	dgBodyState* m_state;
+	dgBodyState m_detachedState;
 
 	void* m_userData;
 	dgWorld* m_world;
 	dgCollisionInstance* m_collision;
 	dgBroadPhaseBodyNode* m_broadPhaseNode;
 	dgBodyMasterList::dgListNode* m_masterNode;
+	dgBodyMasterList::dgIslandList::dgListNode* m_island;
+	dgBodyIsland::dgListNode* m_islandLink;
 	dgBroadPhaseAggregate* m_broadPhaseaggregateNode;
 	OnBodyDestroy m_destructor;
 	OnMatrixUpdateCallback m_matrixUpdate;
 	
 	dgInt32 m_index;
+	dgInt32 m_masterIndex;
 	dgInt32 m_uniqueID;
 	dgInt32 m_bodyGroupId;
 	dgInt32 m_rtti;
@@ -301,6 +289,7 @@ class dgBody
 	friend class dgCollisionConvexPolygon;
 	friend class dgCollidingPairCollector;
 	friend class dgCollisionLumpedMassParticles;
+	friend class dgCollisionIncompressibleParticles;
 
 } DG_GCC_VECTOR_ALIGMENT;
 
@@ -375,62 +364,62 @@ DG_INLINE dgBodyMasterList::dgListNode* dgBody::GetMasterList() const
 
 DG_INLINE void dgBody::GetAABB (dgVector &p0, dgVector &p1) const
 {
-	p0.m_x = m_minAABB.m_x;
-	p0.m_y = m_minAABB.m_y;
-	p0.m_z = m_minAABB.m_z;
-	p1.m_x = m_maxAABB.m_x;
-	p1.m_y = m_maxAABB.m_y;
-	p1.m_z = m_maxAABB.m_z;
+	p0.m_x = m_state->m_minAABB.m_x;
+	p0.m_y = m_state->m_minAABB.m_y;
+	p0.m_z = m_state->m_minAABB.m_z;
+	p1.m_x = m_state->m_maxAABB.m_x;
+	p1.m_y = m_state->m_maxAABB.m_y;
+	p1.m_z = m_state->m_maxAABB.m_z;
 }
 
 DG_INLINE const dgVector& dgBody::GetOmega() const
 {
-	return m_omega;
+	return m_state->m_omega;
 }
 
 DG_INLINE const dgVector& dgBody::GetVelocity() const
 {
-	return m_veloc; 
+	return m_state->m_veloc; 
 }
 
 DG_INLINE void dgBody::SetOmegaNoSleep(const dgVector& omega)
 {
-	m_omega = omega;
+	m_state->m_omega = omega;
 }
 
 
 DG_INLINE void dgBody::SetOmega (const dgVector& omega)
 {
 	SetOmegaNoSleep(omega);
-	m_equilibrium = false;
+	m_state->m_equilibrium = false;
 }
 
 
 DG_INLINE dgVector dgBody::GetVelocityAtPoint (const dgVector& point) const
 {
-	return m_veloc + m_omega.CrossProduct3(point - m_globalCentreOfMass);
+	return m_state->m_veloc + m_state->m_omega.CrossProduct3(point - m_globalCentreOfMass);
 }
 
 DG_INLINE void dgBody::SetVelocityNoSleep(const dgVector& velocity)
 {
-	m_veloc = velocity;
+	m_state->m_veloc = velocity;
 }
 
 DG_INLINE void dgBody::SetVelocity (const dgVector& velocity)
 {
 	SetVelocityNoSleep(velocity);
-	m_equilibrium = false;
+	m_state->m_equilibrium = false;
 }
 
 
 DG_INLINE const dgMatrix& dgBody::GetMatrix() const
 {
-	return m_matrix;
+	return m_state->m_matrix;
 }
 
 DG_INLINE const dgVector& dgBody::GetPosition() const
 {
-	return m_matrix.m_posit;
+	return m_state->m_matrix.m_posit;
 }
 
 DG_INLINE const dgQuaternion& dgBody::GetRotation() const
@@ -449,7 +438,7 @@ DG_INLINE void dgBody::SetCentreOfMass (const dgVector& com)
 	m_localCentreOfMass.m_y = com.m_y;
 	m_localCentreOfMass.m_z = com.m_z;
 	m_localCentreOfMass.m_w = dgFloat32 (1.0f);
-	m_globalCentreOfMass = m_matrix.TransformVector (m_localCentreOfMass);
+	m_globalCentreOfMass = m_state->m_matrix.TransformVector (m_localCentreOfMass);
 }
 
 
@@ -485,27 +474,27 @@ DG_INLINE dgCollisionInstance* dgBody::GetCollision () const
 
 DG_INLINE void dgBody::SetContinueCollisionMode (bool mode)
 {
-	m_continueCollisionMode = dgUnsigned32 (mode);
+	m_state->m_continueCollisionMode = dgUnsigned32 (mode);
 }
 
 DG_INLINE bool dgBody::GetContinueCollisionMode () const
 {
-	return m_continueCollisionMode;
+	return m_state->m_continueCollisionMode;
 }
 
 DG_INLINE void dgBody::SetCollisionWithLinkedBodies (bool state)
 {
-	m_collideWithLinkedBodies = dgUnsigned32 (state);
+	m_state->m_collideWithLinkedBodies = dgUnsigned32 (state);
 }
 
 DG_INLINE bool dgBody::GetCollisionWithLinkedBodies () const
 {
-	return m_collideWithLinkedBodies;
+	return m_state->m_collideWithLinkedBodies;
 }
 
 DG_INLINE bool dgBody::GetFreeze () const
 {
-	return m_freeze;
+	return m_state->m_freeze;
 }
 
 DG_INLINE dgFloat32 dgBody::GetMaxRotationPerStep() const
@@ -521,43 +510,43 @@ DG_INLINE void dgBody::SetMaxRotationPerStep(dgFloat32 angle)
 
 DG_INLINE void dgBody::SetAutoSleep (bool state)
 {
-	m_autoSleep = dgUnsigned32 (state);
-	if (m_autoSleep == 0) {
-		m_sleeping = false;
+	m_state->m_autoSleep = dgUnsigned32 (state);
+	if (m_state->m_autoSleep == 0) {
+		m_state->m_sleeping = false;
 	}
 }
 
 DG_INLINE bool dgBody::GetAutoSleep () const
 {
-	return m_autoSleep;
+	return m_state->m_autoSleep;
 }
 
 DG_INLINE bool dgBody::GetSleepState () const
 {
 //	return m_equilibrium;
-	return m_sleeping;
+	return m_state->m_sleeping;
 }
 
 DG_INLINE void dgBody::SetSleepState (bool state)
 {
-	m_sleeping = state;
-	m_equilibrium = state;
+	m_state->m_sleeping = state;
+	m_state->m_equilibrium = state;
 }
 
 
 DG_INLINE bool dgBody::IsCollidable() const
 {
-	return m_collidable;
+	return m_state->m_collidable;
 }
 
 
 DG_INLINE void dgBody::SetMatrixOriginAndRotation(const dgMatrix& matrix)
 {
-	m_matrix = matrix;
-	dgAssert (m_matrix.TestOrthogonal(dgFloat32 (1.0e-4f)));
+	m_state->m_matrix = matrix;
+	dgAssert (m_state->m_matrix.TestOrthogonal(dgFloat32 (1.0e-4f)));
 
-	m_rotation = dgQuaternion (m_matrix);
-	m_globalCentreOfMass = m_matrix.TransformVector (m_localCentreOfMass);
+	m_rotation = dgQuaternion (m_state->m_matrix);
+	m_globalCentreOfMass = m_state->m_matrix.TransformVector (m_localCentreOfMass);
 	UpdateLumpedMatrix();
 }
 
@@ -599,7 +588,7 @@ DG_INLINE void dgBody::CalcInvInertiaMatrix ()
 
 DG_INLINE void dgBody::ApplyGyroTorque ()
 {
-	dgVector gyroTorque (m_omega.CrossProduct3(m_matrix.RotateVector(m_mass * m_matrix.UnrotateVector(m_omega))));
+	dgVector gyroTorque (m_state->m_omega.CrossProduct3(m_state->m_matrix.RotateVector(m_mass * m_state->m_matrix.UnrotateVector(m_state->m_omega))));
 	SetTorque (GetTorque() - gyroTorque);
 }
 
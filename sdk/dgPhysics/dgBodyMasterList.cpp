@@ -45,9 +45,7 @@ dgBodyMasterListRow::dgListNode* dgBodyMasterListRow::AddContactJoint (dgConstra
 {
 	dgThreadHiveScopeLock lock (body->m_world, &m_body->m_criticalSectionLock, false);
 
-	body->m_world->GlobalLock(false);
 	dgListNode* const node = Addtop();
-	body->m_world->GlobalUnlock();
 
 #ifdef _DEBUG
 	for (dgListNode* ptr = GetFirst()->GetNext(); ptr && (ptr->GetInfo().m_joint->GetId() == dgConstraint::m_contactConstraint); ptr = ptr->GetNext()) { 
@@ -89,9 +87,7 @@ dgBodyMasterListRow::dgListNode* dgBodyMasterListRow::AddBilateralJoint (dgConst
 {
 	dgThreadHiveScopeLock lock (body->m_world, &m_body->m_criticalSectionLock, false);
 
-	body->m_world->GlobalLock(false);
 	dgListNode* const node = Append();
-	body->m_world->GlobalUnlock();
 	
 	node->GetInfo().m_joint = joint;
 	node->GetInfo().m_bodyNode = body;
@@ -113,9 +109,7 @@ void dgBodyMasterListRow::RemoveContactJoint (dgListNode* const link)
 {
 	dgThreadHiveScopeLock lock (m_body->m_world, &m_body->m_criticalSectionLock, false);
 	
-	m_body->m_world->GlobalLock(false);
 	Remove(link);
-	m_body->m_world->GlobalUnlock();
 	
 	m_contactCount --;
 	SetAcceleratedSearch();
@@ -125,9 +119,7 @@ void dgBodyMasterListRow::RemoveBilateralJoint (dgListNode* const link)
 {
 	dgThreadHiveScopeLock lock (m_body->m_world, &m_body->m_criticalSectionLock, false);
 	
-	m_body->m_world->GlobalLock(false);
 	Remove(link);
-	m_body->m_world->GlobalUnlock();
 }
 
 
@@ -237,16 +229,56 @@ void dgBodyMasterListRow::SortList()
 }
 
 
+dgBodyIsland::dgBodyIsland ()
+	:dgList<dgBody*>(NULL)
+	,m_active(1)
+	,m_removedConstraints(0)
+{
+}
+
+dgBodyIsland::~dgBodyIsland ()
+{
+}
+
+
 dgBodyMasterList::dgBodyMasterList (dgMemoryAllocator* const allocator)
 	:dgList<dgBodyMasterListRow>(allocator)
 	,m_disableBodies(allocator)
+	,m_activeIslands(allocator)
 	,m_constraintCount (0)
+	,m_sleepingIslands(allocator)
+	,m_islandLock()
+	,m_bodyArray(NULL)
+	,m_bodyArrayCount (0)
+	,m_bodyArraySize (256)
+	,m_bodyStateBlocks(NULL)
+	,m_bodyStateBlocksCount (0)
+	,m_bodyStateBlocksSize (16)
+	,m_retiredArrays(allocator)
 {
+	m_bodyArray = (dgBody**) allocator->Malloc (dgInt32 (sizeof (dgBody*) * m_bodyArraySize));
+	m_bodyStateBlocks = (dgBodyState**) allocator->Malloc (dgInt32 (sizeof (dgBodyState*) * m_bodyStateBlocksSize));
 }
 
 
 dgBodyMasterList::~dgBodyMasterList(void)
 {
+	ReleaseRetiredBodyArrays();
+	dgMemoryAllocator* const allocator = GetAllocator();
+	for (dgInt32 i = 0; i < m_bodyStateBlocksCount; i ++) {
+		allocator->Free (m_bodyStateBlocks[i]);
+	}
+	allocator->Free (m_bodyStateBlocks);
+	allocator->Free (m_bodyArray);
+}
+
+void dgBodyMasterList::ReleaseRetiredBodyArrays()
+{
+	dgMemoryAllocator* const allocator = GetAllocator();
+	for (dgList<void*>::dgListNode* node = m_retiredArrays.GetFirst(); node; node = node->GetNext()) {
+		allocator->Free (node->GetInfo());
+	}
+	m_retiredArrays.RemoveAll();
 }
 
 
@@ -260,6 +292,41 @@ void dgBodyMasterList::AddBody (dgBody* const body)
 	if (GetFirst() != node) {
 		InsertAfter (GetFirst(), node);
 	}
+
+	// new bodies start in an island of their own
+	dgIslandList::dgListNode* const island = m_activeIslands.Append();
+	island->GetInfo().SetAllocator (body->GetWorld()->GetAllocator());
+	body->m_island = island;
+	body->m_islandLink = island->GetInfo().Append(body);
+
+	if (m_bodyArrayCount >= m_bodyArraySize) {
+		dgBody** const bodyArray = (dgBody**) GetAllocator()->Malloc (dgInt32 (sizeof (dgBody*) * m_bodyArraySize * 2));
+		memcpy (bodyArray, m_bodyArray, sizeof (dgBody*) * m_bodyArrayCount);
+		m_retiredArrays.Append (m_bodyArray);
+		m_bodyArray = bodyArray;
+		m_bodyArraySize *= 2;
+	}
+
+	if ((m_bodyArrayCount >> DG_BODY_STATE_BLOCK_BITS) >= m_bodyStateBlocksCount) {
+		if (m_bodyStateBlocksCount >= m_bodyStateBlocksSize) {
+			dgBodyState** const stateBlocks = (dgBodyState**) GetAllocator()->Malloc (dgInt32 (sizeof (dgBodyState*) * m_bodyStateBlocksSize * 2));
+			memcpy (stateBlocks, m_bodyStateBlocks, sizeof (dgBodyState*) * m_bodyStateBlocksCount);
+			m_retiredArrays.Append (m_bodyStateBlocks);
+			m_bodyStateBlocks = stateBlocks;
+			m_bodyStateBlocksSize *= 2;
+		}
+		m_bodyStateBlocks[m_bodyStateBlocksCount] = (dgBodyState*) GetAllocator()->Malloc (dgInt32 (sizeof (dgBodyState) * DG_BODY_STATE_BLOCK_SIZE));
+		m_bodyStateBlocksCount ++;
+	}
+
+	m_bodyArray[m_bodyArrayCount] = body;
+	body->m_masterIndex = m_bodyArrayCount;
+	m_bodyArrayCount ++;
+
+	// the body state moves to the table, it comes back to the body when the body is removed or disabled
+	dgBodyState* const state = GetBodyState(body->m_masterIndex);
+	*state = body->m_detachedState;
+	body->m_state = state;
 }
 
 void dgBodyMasterList::RemoveBody (dgBody* const body)
@@ -272,6 +339,32 @@ void dgBodyMasterList::RemoveBody (dgBody* const body)
 
 	Remove (node);
 	body->m_masterNode = NULL;
+
+	dgIslandList::dgListNode* const island = body->m_island;
+	island->GetInfo().Remove (body->m_islandLink);
+	if (!island->GetInfo().GetCount()) {
+		dgIslandList& islandList = island->GetInfo().m_active ? m_activeIslands : m_sleepingIslands;
+		islandList.Remove (island);
+	}
+	body->m_island = NULL;
+	body->m_islandLink = NULL;
+
+	const dgInt32 index = body->m_masterIndex;
+	dgAssert ((index >= 0) && (index < m_bodyArrayCount));
+	dgAssert (m_bodyArray[index] == body);
+	dgBodyState* const state = GetBodyState(index);
+	body->m_detachedState = *state;
+	body->m_state = &body->m_detachedState;
+
+	m_bodyArrayCount --;
+	dgBody* const lastBody = m_bodyArray[m_bodyArrayCount];
+	m_bodyArray[index] = lastBody;
+	lastBody->m_masterIndex = index;
+	if (lastBody != body) {
+		*state = *lastBody->m_state;
+		lastBody->m_state = state;
+	}
+	body->m_masterIndex = -1;
 }
 
 
@@ -323,16 +416,23 @@ void dgBodyMasterList::AttachConstraint(dgConstraint* const constraint,	dgBody*
 
 	if (constraint->GetId() != dgConstraint::m_contactConstraint) {
 		dgWorld* const world = body0->GetWorld();
-		world->m_skelListIsDirty = world->m_skelListIsDirty || (constraint->m_solverModel != 2);
+		if (constraint->m_solverModel != 2) {
+			world->SetSkeletonDirty(body0);
+			world->SetSkeletonDirty(body1);
+		}
 
-		body0->m_equilibrium = body0->GetInvMass().m_w ? false : true;
-		body1->m_equilibrium = body1->GetInvMass().m_w ? false : true;
+		body0->m_state->m_equilibrium = body0->GetInvMass().m_w ? false : true;
+		body1->m_state->m_equilibrium = body1->GetInvMass().m_w ? false : true;
 		constraint->m_link0 = body0->m_masterNode->GetInfo().AddBilateralJoint (constraint, body1);
 		constraint->m_link1 = body1->m_masterNode->GetInfo().AddBilateralJoint (constraint, body0);
 	} else {
 		constraint->m_link0 = body0->m_masterNode->GetInfo().AddContactJoint (constraint, body1);
 		constraint->m_link1 = body1->m_masterNode->GetInfo().AddContactJoint (constraint, body0);
 	}
+
+	if ((body0->GetInvMass().m_w > dgFloat32 (0.0f)) && (body1->GetInvMass().m_w > dgFloat32 (0.0f))) {
+		MergeIslands (body0, body1);
+	}
 	dgAtomicExchangeAndAdd((dgInt32*) &m_constraintCount, 1);
 }
 
@@ -352,6 +452,12 @@ void dgBodyMasterList::RemoveConstraint (dgConstraint* const constraint)
 	dgBodyMasterListRow& row0 = body0->m_masterNode->GetInfo();
 	dgBodyMasterListRow& row1 = body1->m_masterNode->GetInfo();
 
+	if ((body0->GetInvMass().m_w > dgFloat32 (0.0f)) && (body1->GetInvMass().m_w > dgFloat32 (0.0f))) {
+		// the island may be in two pieces now, it is split the next time it is active
+		dgAssert (body0->m_island == body1->m_island);
+		dgAtomicExchangeAndAdd(&body0->m_island->GetInfo().m_removedConstraints, 1);
+	}
+
 	if (body0->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 		dgDynamicBody* const dynBody0 = (dgDynamicBody*)body0;
 		dynBody0->m_savedExternalForce = dgVector(dgFloat32(0.0f));
@@ -373,14 +479,15 @@ void dgBodyMasterList::RemoveConstraint (dgConstraint* const constraint)
 	if (constraint->GetId() == dgConstraint::m_contactConstraint) {
 		dgConstraint* const contact = (dgConstraint*) constraint;
 		if (contact->m_maxDOF) {
-			body0->m_equilibrium = body0->GetInvMass().m_w ? false : true;
-			body1->m_equilibrium = body1->GetInvMass().m_w ? false : true;
+			body0->m_state->m_equilibrium = body0->GetInvMass().m_w ? false : true;
+			body1->m_state->m_equilibrium = body1->GetInvMass().m_w ? false : true;
 		}
 		row0.RemoveContactJoint(constraint->m_link0);
 		row1.RemoveContactJoint(constraint->m_link1);
 	} else {
 		dgWorld* const world = body0->GetWorld();
-		world->m_skelListIsDirty = true;
+		world->SetSkeletonDirty(body0);
+		world->SetSkeletonDirty(body1);
 
 		if (body0->GetSkeleton()) {
 			world->DestroySkeletonContainer (body0->GetSkeleton());
@@ -389,14 +496,129 @@ void dgBodyMasterList::RemoveConstraint (dgConstraint* const constraint)
 			world->DestroySkeletonContainer(body1->GetSkeleton());
 		}
 
-		body0->m_equilibrium = body0->GetInvMass().m_w ? false : true;
-		body1->m_equilibrium = body1->GetInvMass().m_w ? false : true;
+		body0->m_state->m_equilibrium = body0->GetInvMass().m_w ? false : true;
+		body1->m_state->m_equilibrium = body1->GetInvMass().m_w ? false : true;
 		row0.RemoveBilateralJoint(constraint->m_link0);
 		row1.RemoveBilateralJoint(constraint->m_link1);
 	}
 }
 
 
+void dgBodyMasterList::MergeIslands (dgBody* const body0, dgBody* const body1)
+{
+	dgThreadHiveScopeLock lock (body0->m_world, &m_islandLock, false);
+
+	dgIslandList::dgListNode* island0 = body0->m_island;
+	dgIslandList::dgListNode* island1 = body1->m_island;
+	if (island0 != island1) {
+		// move the bodies of the smaller island to the larger one
+		if (island0->GetInfo().GetCount() < island1->GetInfo().GetCount()) {
+			dgSwap (island0, island1);
+		}
+		dgBodyIsland& dst = island0->GetInfo();
+		dgBodyIsland& src = island1->GetInfo();
+		for (dgBodyIsland::dgListNode* node = src.GetFirst(); node; node = node->GetNext()) {
+			node->GetInfo()->m_island = island0;
+		}
+		dst.Merge (src);
+		dst.m_removedConstraints += src.m_removedConstraints;
+
+		if (src.m_active && !dst.m_active) {
+			dst.m_active = 1;
+			m_sleepingIslands.Unlink (island0);
+			m_activeIslands.Append (island0);
+		}
+		dgIslandList& islandList = src.m_active ? m_activeIslands : m_sleepingIslands;
+		islandList.Remove (island1);
+	}
+}
+
+void dgBodyMasterList::WakeUpIsland (dgBody* const body)
+{
+	// islands are only merged while constraints are attached, so the island of the body can be read outside the lock
+	dgIslandList::dgListNode* const island = body->m_island;
+	if (island && !island->GetInfo().m_active) {
+		dgThreadHiveScopeLock lock (body->m_world, &m_islandLock, false);
+		if (!island->GetInfo().m_active) {
+			island->GetInfo().m_active = 1;
+			m_sleepingIslands.Unlink (island);
+			m_activeIslands.Append (island);
+		}
+	}
+}
+
+void dgBodyMasterList::SleepIsland (dgIslandList::dgListNode* const island)
+{
+	dgAssert (island->GetInfo().m_active);
+	island->GetInfo().m_active = 0;
+	m_activeIslands.Unlink (island);
+	m_sleepingIslands.Append (island);
+}
+
+void dgBodyMasterList::SplitIsland (dgIslandList::dgListNode* const island)
+{
+	dgBodyIsland& srcIsland = island->GetInfo();
+	if (srcIsland.m_removedConstraints) {
+		srcIsland.m_removedConstraints = 0;
+
+		dgBodyIsland pending;
+		pending.Merge (srcIsland);
+		for (dgBodyIsland::dgListNode* node = pending.GetFirst(); node; node = node->GetNext()) {
+			node->GetInfo()->m_island = NULL;
+		}
+
+		// flood fill the bodies of the old island, the first piece keeps the island and each other piece gets a new one
+		dgIslandList& islandList = srcIsland.m_active ? m_activeIslands : m_sleepingIslands;
+		dgIslandList::dgListNode* dstIsland = island;
+		while (pending.GetFirst()) {
+			if (dstIsland->GetInfo().GetCount()) {
+				dstIsland = islandList.Append();
+				dstIsland->GetInfo().SetAllocator (srcIsland.GetAllocator());
+				dstIsland->GetInfo().m_active = srcIsland.m_active;
+			}
+			dgBodyIsland& dst = dstIsland->GetInfo();
+
+			dgBodyIsland::dgListNode* const seed = pending.GetFirst();
+			pending.Unlink (seed);
+			dst.Append (seed);
+			seed->GetInfo()->m_island = dstIsland;
+
+			// the island list is also the queue of the flood fill
+			for (dgBodyIsland::dgListNode* node = seed; node; node = node->GetNext()) {
+				dgBody* const body = node->GetInfo();
+				if (body->GetInvMass().m_w > dgFloat32 (0.0f)) {
+					for (dgBodyMasterListRow::dgListNode* jointNode = body->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
+						dgBody* const linkBody = jointNode->GetInfo().m_bodyNode;
+						if (!linkBody->m_island && (linkBody->GetInvMass().m_w > dgFloat32 (0.0f))) {
+							pending.Unlink (linkBody->m_islandLink);
+							dst.Append (linkBody->m_islandLink);
+							linkBody->m_island = dstIsland;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void dgBodyMasterList::UpdateBodyIsland (dgBody* const body)
+{
+	// called when the mass of the body changes from finite to infinite or the other way around
+	if (body->m_island) {
+		if (body->GetInvMass().m_w > dgFloat32 (0.0f)) {
+			for (dgBodyMasterListRow::dgListNode* jointNode = body->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
+				dgBody* const linkBody = jointNode->GetInfo().m_bodyNode;
+				if (linkBody->GetInvMass().m_w > dgFloat32 (0.0f)) {
+					MergeIslands (body, linkBody);
+				}
+			}
+		} else if (body->m_island->GetInfo().GetCount() > 1) {
+			body->m_island->GetInfo().m_removedConstraints ++;
+		}
+	}
+}
+
+
 DG_INLINE dgUnsigned32 dgBodyMasterList::MakeSortMask(const dgBody* const body) const
 {
 	dgUnsigned32 val0 = body->IsRTTIType(dgBody::m_dynamicBodyRTTI) ? (body->GetInvMass().m_w > 0.0f) << 30 : 0;
@@ -22,12 +22,58 @@
 #ifndef __DGBODYMASTER_LIST__
 #define __DGBODYMASTER_LIST__
 
+// number of consecutive body pointers a thread takes from the body array in each step of a world pass
+#define DG_BODY_ARRAY_CHUNK_SIZE	64
+
+// the body state table is made of blocks of this many entries
+#define DG_BODY_STATE_BLOCK_BITS	8
+#define DG_BODY_STATE_BLOCK_SIZE	(1<<DG_BODY_STATE_BLOCK_BITS)
+
 
 class dgBody;
 class dgContact;
 class dgConstraint;
 class dgBilateralConstraint;
 
+// the part of the body that the per body passes read and write every step
+DG_MSC_VECTOR_ALIGMENT
+class dgBodyState
+{
+	public:
+	dgBodyState()
+		:m_matrix (dgGetIdentityMatrix())
+		,m_veloc(dgFloat32 (0.0f))
+		,m_omega(dgFloat32 (0.0f))
+		,m_minAABB(dgFloat32 (0.0f))
+		,m_maxAABB(dgFloat32 (0.0f))
+		,m_flags(0)
+	{
+	}
+
+	dgMatrix m_matrix;
+	dgVector m_veloc;
+	dgVector m_omega;
+	dgVector m_minAABB;
+	dgVector m_maxAABB;
+	union 
+	{
+		dgUnsigned32 m_flags;
+		struct {
+			dgUnsigned32 m_freeze					: 1;
+			dgUnsigned32 m_resting					: 1;
+			dgUnsigned32 m_sleeping					: 1;
+			dgUnsigned32 m_autoSleep				: 1;
+			dgUnsigned32 m_inCallback				: 1;
+			dgUnsigned32 m_collidable				: 1;
+			dgUnsigned32 m_equilibrium				: 1;
+			dgUnsigned32 m_spawnnedFromCallback		: 1;
+			dgUnsigned32 m_continueCollisionMode	: 1;
+			dgUnsigned32 m_collideWithLinkedBodies	: 1;
+			dgUnsigned32 m_transformIsDirty			: 1;
+		};
+	};
+} DG_GCC_VECTOR_ALIGMENT;
+
 class dgBodyMasterListCell
 {
 	public:
@@ -67,9 +113,26 @@ class dgBodyMasterListRow: public dgList<dgBodyMasterListCell>
 	friend class dgBodyMasterList;
 };
 
+// set of bodies connected by constraints through bodies with finite mass. islands are merged when a constraint is 
+// attached and only split again after constraints were removed, so the clusters are built from the active islands 
+// and the bodies of sleeping islands are not visited at all.
+class dgBodyIsland: public dgList<dgBody*>
+{
+	public:
+	dgBodyIsland ();
+	~dgBodyIsland ();
+
+	private:
+	dgInt32 m_active;
+	dgInt32 m_removedConstraints;
+	friend class dgBodyMasterList;
+};
+
 class dgBodyMasterList: public dgList<dgBodyMasterListRow>
 {
 	public:
+	typedef dgList<dgBodyIsland> dgIslandList;
+
 	dgBodyMasterList (dgMemoryAllocator* const allocator);
 	~dgBodyMasterList ();
 
@@ -86,9 +149,55 @@ class dgBodyMasterList: public dgList<dgBodyMasterListRow>
 	dgUnsigned32 MakeSortMask(const dgBody* const body) const;
 	void SortMasterList();
 
+	dgInt32 GetBodyArrayCount() const;
+	dgBody** GetBodyArray() const;
+	dgBodyState* GetBodyState(dgInt32 index) const;
+	void ReleaseRetiredBodyArrays();
+
+	void WakeUpIsland (dgBody* const body);
+	void SleepIsland (dgIslandList::dgListNode* const island);
+	void SplitIsland (dgIslandList::dgListNode* const island);
+	void UpdateBodyIsland (dgBody* const body);
+
 	public:
 	dgTree<int, dgBody*> m_disableBodies;
+	dgIslandList m_activeIslands;
 	dgUnsigned32 m_constraintCount;
+
+	private:
+	void MergeIslands (dgBody* const body0, dgBody* const body1);
+
+	dgIslandList m_sleepingIslands;
+	dgThread::dgCriticalSection m_islandLock;
+
+	// packed array of pointers to all the bodies in the list, in no particular order, for the passes that visit 
+	// every body. the body state table runs parallel to it, entry i holds the matrix, velocities, aabb and flags 
+	// of body i and the body reads them through its state pointer. removal moves the last body and its state to 
+	// the vacant slot. bodies created from a callback can grow the table while a pass reads it, so the state 
+	// blocks never move and a replaced pointer array is retired and only released between updates.
+	dgBody** m_bodyArray;
+	dgInt32 m_bodyArrayCount;
+	dgInt32 m_bodyArraySize;
+	dgBodyState** m_bodyStateBlocks;
+	dgInt32 m_bodyStateBlocksCount;
+	dgInt32 m_bodyStateBlocksSize;
+	dgList<void*> m_retiredArrays;
 };
 
+inline dgInt32 dgBodyMasterList::GetBodyArrayCount() const
+{
+	return m_bodyArrayCount;
+}
+
+inline dgBody** dgBodyMasterList::GetBodyArray() const
+{
+	return m_bodyArray;
+}
+
+inline dgBodyState* dgBodyMasterList::GetBodyState(dgInt32 index) const
+{
+	dgAssert ((index >= 0) && (index < m_bodyArrayCount));
+	return &m_bodyStateBlocks[index >> DG_BODY_STATE_BLOCK_BITS][index & (DG_BODY_STATE_BLOCK_SIZE - 1)];
+}
+
 #endif
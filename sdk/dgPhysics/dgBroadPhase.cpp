@@ -24,6 +24,7 @@
 #include "dgWorld.h"
 #include "dgContact.h"
 #include "dgBroadPhase.h"
+#include "dgSensorBody.h"
 #include "dgDynamicBody.h"
 #include "dgCollisionConvex.h"
 #include "dgCollisionInstance.h"
@@ -158,27 +159,52 @@ dgBroadPhase::dgBroadPhase(dgWorld* const world)
 	,m_generatedBodies(world->GetAllocator())
 	,m_updateList(world->GetAllocator())
 	,m_aggregateList(world->GetAllocator())
+	,m_updateArray(world->GetAllocator(), 256)
+	,m_contactArray(world->GetAllocator(), 256)
 	,m_lru(DG_CONTACT_DELAY_FRAMES)
+	,m_treeLru(0)
+	,m_motionLru(0)
 	,m_contacJointLock()
 	,m_criticalSectionLock()
 	,m_pendingSoftBodyCollisions(world->GetAllocator(), 64)
 	,m_pendingSoftBodyPairsCount(0)
 	,m_dirtyNodesCount(0)
+	,m_sensorPairs(NULL)
+	,m_sensorOverlaps(world->GetAllocator(), 64)
+	,m_sensorEvents(world->GetAllocator(), 64)
+	,m_sensorOverlapsCount(0)
+	,m_sensorEventsCount(0)
 	,m_scanTwoWays(false)
 	,m_recursiveChunks(false)
 {
+	SetThreadsCount (world->GetThreadCount());
 }
 
 dgBroadPhase::~dgBroadPhase()
 {
+	delete[] m_sensorPairs;
+}
+
+void dgBroadPhase::SetThreadsCount (dgInt32 count)
+{
+	if (m_sensorPairs) {
+		delete[] m_sensorPairs;
+	}
+	m_sensorPairs = new (m_world->GetAllocator()) dgSensorPairs[count];
+	for (dgInt32 i = 0; i < count; i ++) {
+		m_sensorPairs[i].m_pairs.SetAllocator(m_world->GetAllocator());
+		m_sensorPairs[i].m_count = 0;
+	}
 }
 
 
 void dgBroadPhase::MoveNodes (dgBroadPhase* const dst)
 {
 	const dgBodyMasterList* const masterList = m_world;
-	for (dgBodyMasterList::dgListNode* node = masterList->GetFirst(); node; node = node->GetNext()) {
-		dgBody* const body = node->GetInfo().GetBody();
+	dgBody** const bodyArray = masterList->GetBodyArray();
+	const dgInt32 bodyCount = masterList->GetBodyArrayCount();
+	for (dgInt32 i = 0; i < bodyCount; i ++) {
+		dgBody* const body = bodyArray[i];
 		if (body->GetBroadPhase() && !body->GetBroadPhaseAggregate()) {
 			Remove(body);
 			dst->Add(body);
@@ -196,6 +222,17 @@ void dgBroadPhase::MoveNodes (dgBroadPhase* const dst)
 		UnlinkAggregate(aggregate);
 		dst->LinkAggregate(aggregate);
 	}
+
+	// query caches built on this broadphase must not validate against the new one 
+	dst->m_treeLru = dgMax (dst->m_treeLru, m_treeLru) + 1;
+
+	// the sensors keep their overlaps, so switching broadphase does not fire begin events
+	dst->m_sensorOverlaps.ResizeIfNecessary(m_sensorOverlapsCount);
+	for (dgInt32 i = 0; i < m_sensorOverlapsCount; i ++) {
+		dst->m_sensorOverlaps[i] = m_sensorOverlaps[i];
+	}
+	dst->m_sensorOverlapsCount = m_sensorOverlapsCount;
+	m_sensorOverlapsCount = 0;
 }
 
 dgBroadPhaseTreeNode* dgBroadPhase::InsertNode(dgBroadPhaseNode* const root, dgBroadPhaseNode* const node)
@@ -246,34 +283,35 @@ void dgBroadPhase::UpdateAggregateEntropyKernel(void* const context, void* const
 	dTimeTrackerEvent(__FUNCTION__);
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_broadPhaseUpdate);
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
 	broadPhase->UpdateAggregateEntropy(descriptor, (dgList<dgBroadPhaseAggregate*>::dgListNode*) node, threadID);
 }
 
-void dgBroadPhase::ForceAndToqueKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::ForceAndToqueKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dTimeTrackerEvent(__FUNCTION__);
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_forceAndTorque);
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->ApplyForceAndtorque(descriptor, (dgBodyMasterList::dgListNode*) node, threadID);
+	broadPhase->ApplyForceAndtorque(descriptor, start, end, threadID);
 }
 
-void dgBroadPhase::SleepingStateKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::SleepingStateKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dTimeTrackerEvent(__FUNCTION__);
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_broadPhaseUpdate);
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->SleepingState(descriptor, (dgBodyMasterList::dgListNode*) node, threadID);
+	broadPhase->SleepingState(descriptor, start, end, threadID);
 }
 
-bool dgBroadPhase::DoNeedUpdate(dgBodyMasterList::dgListNode* const node) const
+bool dgBroadPhase::DoNeedUpdate(const dgBody* const body) const
 {
-	dgBody* const body = node->GetInfo().GetBody();
-
 	bool state = body->GetInvMass().m_w != dgFloat32 (0.0f);
-	state = state || !body->m_equilibrium || (body->GetExtForceAndTorqueCallback() != NULL);
+	state = state || !body->m_state->m_equilibrium || (body->GetExtForceAndTorqueCallback() != NULL) || body->IsRTTIType(dgBody::m_sensorBodyRTTI);
 	return state;
 }
 
@@ -289,48 +327,44 @@ void dgBroadPhase::UpdateAggregateEntropy (dgBroadphaseSyncDescriptor* const des
 }
 
 
-void dgBroadPhase::ApplyForceAndtorque(dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgBroadPhase::ApplyForceAndtorque(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgFloat32 timestep = descriptor->m_timestep;
 
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-	while (node) {
-		if (DoNeedUpdate(node)) {
-			dgBody* const body = node->GetInfo().GetBody();
-
-			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
-				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
-				dynamicBody->ApplyExtenalForces(timestep, threadID);
-			}
-		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetPrev() : NULL;
+	const dgBodyMasterList* const masterList = m_world;
+	dgBody** const bodyArray = masterList->GetBodyArray();
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBody* const body = bodyArray[i];
+		if (DoNeedUpdate(body) && body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+			dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+			dynamicBody->ApplyExtenalForces(timestep, threadID);
 		}
 	}
 }
 
 
-void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgFloat32 timestep = descriptor->m_timestep;
 
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-	while (node) {
-		if (DoNeedUpdate(node)) {
-			dgBody* const body = node->GetInfo().GetBody();
-
+	const dgBodyMasterList* const masterList = m_world;
+	dgBody** const bodyArray = masterList->GetBodyArray();
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBody* const body = bodyArray[i];
+		if (DoNeedUpdate(body)) {
 			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
 				if (!dynamicBody->IsInEquilibrium()) {
-					dynamicBody->m_sleeping = false;
-					dynamicBody->m_equilibrium = false;
+					dynamicBody->m_state->m_sleeping = false;
+					dynamicBody->m_state->m_equilibrium = false;
 					dynamicBody->UpdateCollisionMatrix(timestep, threadID);
 				}
 				if (dynamicBody->GetInvMass().m_w == dgFloat32(0.0f) || body->m_collision->IsType(dgCollision::dgCollisionMesh_RTTI)) {
-					dynamicBody->m_sleeping = true;
-					dynamicBody->m_autoSleep = true;
-					dynamicBody->m_equilibrium = true;
+					dynamicBody->m_state->m_sleeping = true;
+					dynamicBody->m_state->m_autoSleep = true;
+					dynamicBody->m_state->m_equilibrium = true;
+				} else if (!(dynamicBody->m_state->m_sleeping | dynamicBody->m_state->m_freeze)) {
+					m_world->WakeUpIsland(dynamicBody);
 				}
 
 				dynamicBody->m_savedExternalForce = dynamicBody->m_externalForce;
@@ -340,22 +374,29 @@ void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, d
 
 				// kinematic bodies are always sleeping (skip collision with kinematic bodies)
 				if (body->IsCollidable()) {
-					body->m_sleeping = false;
-					body->m_autoSleep = false;
+					body->m_state->m_sleeping = false;
+					body->m_state->m_autoSleep = false;
 				} else {
-					body->m_sleeping = true;
-					body->m_autoSleep = true;
+					body->m_state->m_sleeping = true;
+					body->m_state->m_autoSleep = true;
 				}
-				body->m_equilibrium = true;
+				if (body->IsRTTIType(dgBody::m_sensorBodyRTTI)) {
+					// sensors stay out of equilibrium for the frame they moved, so that their broadphase node gets rescanned
+					dgSensorBody* const sensor = (dgSensorBody*)body;
+					if (sensor->UpdateSensorMatrix()) {
+						sensor->m_state->m_equilibrium = false;
+						sensor->UpdateCollisionMatrix(timestep, threadID);
+					} else {
+						sensor->m_state->m_equilibrium = true;
+					}
+				} else {
+					body->m_state->m_equilibrium = true;
 
-				// update collision matrix by calling the transform callback for all kinematic bodies
-				body->UpdateCollisionMatrix(timestep, threadID);
+					// update collision matrix by calling the transform callback for all kinematic bodies
+					body->UpdateCollisionMatrix(timestep, threadID);
+				}
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetPrev() : NULL;
-		}
 	}
 }
 
@@ -369,7 +410,7 @@ void dgBroadPhase::ForEachBodyInAABB(const dgBroadPhaseNode** stackPool, dgInt32
 
 			dgBody* const body = rootNode->GetBody();
 			if (body) {
-				if (dgOverlapTest(body->m_minAABB, body->m_maxAABB, minBox, maxBox)) {
+				if (dgOverlapTest(body->m_state->m_minAABB, body->m_state->m_maxAABB, minBox, maxBox)) {
 					if (!callback(body, userData)) {
 						break;
 					}
@@ -431,7 +472,7 @@ dgInt32 dgBroadPhase::ConvexCast(const dgBroadPhaseNode** stackPool, dgFloat32*
 			dgBody* const body = me->GetBody();
 			if (body) {
 				if (!PREFILTER_RAYCAST(prefilter, body, body->m_collision, userData)) {
-					dgInt32 count = m_world->CollideContinue(shape, matrix, velocA, velocB, body->m_collision, body->m_matrix, velocB, velocB, timeToImpact, points, normals, penetration, attributeA, attributeB, maxContacts, threadIndex);
+					dgInt32 count = m_world->CollideContinue(shape, matrix, velocA, velocB, body->m_collision, body->m_state->m_matrix, velocB, velocB, timeToImpact, points, normals, penetration, attributeA, attributeB, maxContacts, threadIndex);
 
 					if (timeToImpact < maxParam) {
 						if ((timeToImpact - maxParam) < dgFloat32(-1.0e-3f)) {
@@ -543,7 +584,7 @@ dgInt32 dgBroadPhase::Collide(const dgBroadPhaseNode** stackPool, dgInt32* const
 			dgBody* const body = me->GetBody();
 			if (body) {
 				if (!PREFILTER_RAYCAST(prefilter, body, body->m_collision, userData)) {
-					dgInt32 count = m_world->Collide(shape, matrix, body->m_collision, body->m_matrix, points, normals, penetration, attributeA, attributeB, DG_CONVEX_CAST_POOLSIZE, threadIndex);
+					dgInt32 count = m_world->Collide(shape, matrix, body->m_collision, body->m_state->m_matrix, points, normals, penetration, attributeA, attributeB, DG_CONVEX_CAST_POOLSIZE, threadIndex);
 
 					if (count) {
 						bool teminate = false;
@@ -601,6 +642,192 @@ dgInt32 dgBroadPhase::Collide(const dgBroadPhaseNode** stackPool, dgInt32* const
 	return totalCount;
 }
 
+void dgBroadPhase::CollectQueryCacheLeafs (dgBroadPhaseQueryCache* const cache, dgUnsigned32 lru) const
+{
+	const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+	dgInt32 stack = 1;
+	stackPool[0] = m_rootNode;
+	while (stack) {
+		stack --;
+		const dgBroadPhaseNode* const node = stackPool[stack];
+		if ((node->m_nodeIsDirtyLru >= lru) && dgOverlapTest(node->m_minBox, node->m_maxBox, cache->m_minBox, cache->m_maxBox)) {
+			if (node->GetBody()) {
+				dgInt32 index = 0;
+				if (lru) {
+					for (; (index < cache->m_leafsCount) && (cache->m_leafs[index] != node); index ++);
+				} else {
+					index = cache->m_leafsCount;
+				}
+				if (index == cache->m_leafsCount) {
+					cache->m_leafs[cache->m_leafsCount] = node;
+					cache->m_leafsCount ++;
+				}
+			} else if (node->IsAggregate()) {
+				const dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)node;
+				if (aggregate->m_root) {
+					stackPool[stack] = aggregate->m_root;
+					stack ++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			} else {
+				if (node->GetLeft()) {
+					stackPool[stack] = node->GetLeft();
+					stack ++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+				if (node->GetRight()) {
+					stackPool[stack] = node->GetRight();
+					stack ++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			}
+		}
+	}
+}
+
+void dgBroadPhase::UpdateQueryCache (dgBroadPhaseQueryCache* const cache, const dgVector& minBox, const dgVector& maxBox) const
+{
+	if ((cache->m_broadPhase != this) || (cache->m_treeLru != m_treeLru) || !dgBoxInclusionTest(minBox, maxBox, cache->m_minBox, cache->m_maxBox)) {
+		// the tree changed or the query left the cached region, collect the leafs of a new padded region.
+		cache->m_minBox = minBox - cache->m_padding;
+		cache->m_maxBox = maxBox + cache->m_padding;
+		cache->m_leafsCount = 0;
+		if (m_rootNode) {
+			CollectQueryCacheLeafs (cache, 0);
+		}
+	} else if (cache->m_motionLru != m_motionLru) {
+		// only the branches stamped since the last update can move bodies in or out of the region
+		for (dgInt32 i = cache->m_leafsCount - 1; i >= 0; i --) {
+			const dgBroadPhaseNode* const node = cache->m_leafs[i];
+			if ((node->m_nodeIsDirtyLru >= cache->m_nodeLru) && !dgOverlapTest(node->m_minBox, node->m_maxBox, cache->m_minBox, cache->m_maxBox)) {
+				cache->m_leafsCount --;
+				cache->m_leafs[i] = cache->m_leafs[cache->m_leafsCount];
+			}
+		}
+		CollectQueryCacheLeafs (cache, cache->m_nodeLru);
+	} else {
+		return;
+	}
+
+	// keep a copy of the leaf boxes packed four at the time, the queries test them in 
+	// groups of four without touching the tree nodes. 
+	const dgInt32 blocksCount = (cache->m_leafsCount + 3) >> 2;
+	cache->m_boxes.ResizeIfNecessary(blocksCount * 6 + 1);
+	dgVector* const boxes = &cache->m_boxes[0];
+	for (dgInt32 i = 0; i < blocksCount; i ++) {
+		dgVector p0[4];
+		dgVector p1[4];
+		for (dgInt32 j = 0; j < 4; j ++) {
+			const dgInt32 index = i * 4 + j;
+			if (index < cache->m_leafsCount) {
+				p0[j] = cache->m_leafs[index]->m_minBox;
+				p1[j] = cache->m_leafs[index]->m_maxBox;
+			} else {
+				p0[j] = dgVector (dgFloat32 (1.0e15f));
+				p1[j] = dgVector (dgFloat32 (-1.0e15f));
+			}
+		}
+		dgVector unused;
+		dgVector::Transpose4x4 (boxes[i * 6 + 0], boxes[i * 6 + 1], boxes[i * 6 + 2], unused, p0[0], p0[1], p0[2], p0[3]);
+		dgVector::Transpose4x4 (boxes[i * 6 + 3], boxes[i * 6 + 4], boxes[i * 6 + 5], unused, p1[0], p1[1], p1[2], p1[3]);
+	}
+
+	cache->m_broadPhase = this;
+	cache->m_treeLru = m_treeLru;
+	cache->m_motionLru = m_motionLru;
+	cache->m_nodeLru = m_lru + 1;
+}
+
+dgInt32 dgBroadPhase::Collide(dgBroadPhaseQueryCache* const cache, dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgVector boxP0;
+	dgVector boxP1;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(matrix, boxP0, boxP1);
+	UpdateQueryCache (cache, boxP0, boxP1);
+
+	dgInt32 overlaped[DG_BROADPHASE_MAX_STACK_DEPTH];
+	const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+	dgVector query[6];
+	query[0] = dgVector (boxP0.m_x);
+	query[1] = dgVector (boxP0.m_y);
+	query[2] = dgVector (boxP0.m_z);
+	query[3] = dgVector (boxP1.m_x);
+	query[4] = dgVector (boxP1.m_y);
+	query[5] = dgVector (boxP1.m_z);
+
+	dgInt32 stack = 0;
+	const dgInt32 blocksCount = (cache->m_leafsCount + 3) >> 2;
+	for (dgInt32 i = 0; i < blocksCount; i ++) {
+		for (dgInt32 mask = cache->GetOverlapMask(i, query); mask; mask &= mask - 1) {
+			if (stack >= DG_BROADPHASE_MAX_STACK_DEPTH) {
+				// too many bodies in the region, let the tree sort them out
+				return Collide(shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
+			}
+			stackPool[stack] = cache->m_leafs[i * 4 + dgExp2 (mask & -mask)];
+			overlaped[stack] = 1;
+			stack ++;
+		}
+	}
+	return stack ? Collide(stackPool, overlaped, stack, boxP0, boxP1, shape, matrix, prefilter, userData, info, maxContacts, threadIndex) : 0;
+}
+
+dgInt32 dgBroadPhase::ConvexCast (dgBroadPhaseQueryCache* const cache, dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgVector boxP0;
+	dgVector boxP1;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(matrix, boxP0, boxP1);
+
+	dgVector velocA((target - matrix.m_posit) & dgVector::m_triplexMask);
+	dgVector velocB(dgFloat32(0.0f));
+	const dgVector sweptP0 (boxP0.GetMin(boxP0 + velocA));
+	const dgVector sweptP1 (boxP1.GetMax(boxP1 + velocA));
+	UpdateQueryCache (cache, sweptP0, sweptP1);
+
+	dgVector query[6];
+	query[0] = dgVector (sweptP0.m_x);
+	query[1] = dgVector (sweptP0.m_y);
+	query[2] = dgVector (sweptP0.m_z);
+	query[3] = dgVector (sweptP1.m_x);
+	query[4] = dgVector (sweptP1.m_y);
+	query[5] = dgVector (sweptP1.m_z);
+
+	dgFloat32 distance[DG_BROADPHASE_MAX_STACK_DEPTH];
+	const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+	// the cast pops the closest box first, so keep the stack sorted by decreasing distance
+	dgInt32 stack = 0;
+	dgFastRayTest ray(dgVector(dgFloat32(0.0f)), velocA);
+	const dgInt32 blocksCount = (cache->m_leafsCount + 3) >> 2;
+	for (dgInt32 i = 0; i < blocksCount; i ++) {
+		for (dgInt32 mask = cache->GetOverlapMask(i, query); mask; mask &= mask - 1) {
+			const dgBroadPhaseNode* const node = cache->m_leafs[i * 4 + dgExp2 (mask & -mask)];
+			dgVector minBox(node->m_minBox - boxP1);
+			dgVector maxBox(node->m_maxBox - boxP0);
+			dgFloat32 dist = ray.BoxIntersect(minBox, maxBox);
+			if (dist < dgFloat32 (1.0f)) {
+				if (stack >= DG_BROADPHASE_MAX_STACK_DEPTH) {
+					return ConvexCast (shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex);
+				}
+				dgInt32 j = stack;
+				for (; j && (dist > distance[j - 1]); j--) {
+					stackPool[j] = stackPool[j - 1];
+					distance[j] = distance[j - 1];
+				}
+				stackPool[j] = node;
+				distance[j] = dist;
+				stack++;
+			}
+		}
+	}
+
+	*param = dgFloat32 (1.0f);
+	return stack ? ConvexCast(stackPool, distance, stack, velocA, velocB, ray, shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex) : 0;
+}
+
 void dgBroadPhase::RayCast(const dgBroadPhaseNode** stackPool, dgFloat32* const distance, dgInt32 stack, const dgVector& l0, const dgVector& l1, dgFastRayTest& ray, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
 {
 	dgLineBox line;
@@ -684,6 +911,360 @@ void dgBroadPhase::RayCast(const dgBroadPhaseNode** stackPool, dgFloat32* const
 	}
 }
 
+// a packet of up to four rays traced together through the broadphase tree, 
+// each lane of the SoA vectors holds one ray, so a single box test visits the node for the whole packet.
+DG_MSC_VECTOR_ALIGMENT
+class dgRayCastPacket
+{
+	public:
+	class dgLane
+	{
+		public:
+		dgLineBox m_line;
+		const dgRayCastPacket* m_packet;
+		dgRayCastBatchHit* m_hit;
+		dgFloat32 m_maxParam;
+	};
+
+	dgRayCastPacket(const dgVector* const p0, const dgVector* const p1, dgInt32 count, OnRayPrecastAction prefilter, void* const userData, dgRayCastBatchHit* const hits)
+		:m_direction(dgFloat32 (0.0f))
+		,m_prefilter(prefilter)
+		,m_userData(userData)
+		,m_activeMask(0)
+	{
+		dgFloat32 origin[3][DG_RAYCAST_PACKET_SIZE];
+		dgFloat32 invDir[3][DG_RAYCAST_PACKET_SIZE];
+		for (dgInt32 i = 0; i < DG_RAYCAST_PACKET_SIZE; i ++) {
+			dgLane& lane = m_lanes[i];
+			lane.m_packet = this;
+			lane.m_hit = NULL;
+			lane.m_maxParam = dgFloat32 (-1.0f);
+			for (dgInt32 j = 0; j < 3; j ++) {
+				origin[j][i] = dgFloat32 (0.0f);
+				invDir[j][i] = dgFloat32 (0.0f);
+			}
+		}
+
+		for (dgInt32 i = 0; i < count; i ++) {
+			dgLane& lane = m_lanes[i];
+			dgRayCastBatchHit* const hit = &hits[i];
+			hit->m_hitBody = NULL;
+			hit->m_contaID = 0;
+			hit->m_param = dgFloat32 (1.0f);
+
+			const dgVector segment (p1[i] - p0[i]);
+			if (segment.DotProduct3(segment) > dgFloat32(1.0e-8f)) {
+				dgVector test(p0[i] <= p1[i]);
+				lane.m_line.m_l0 = p0[i];
+				lane.m_line.m_l1 = p1[i];
+				lane.m_line.m_boxL0 = (p0[i] & test) | p1[i].AndNot(test);
+				lane.m_line.m_boxL1 = (p1[i] & test) | p0[i].AndNot(test);
+				lane.m_hit = hit;
+				lane.m_maxParam = dgFloat32 (1.0f);
+				m_activeMask |= 1 << i;
+
+				// same parallel axis guard as dgFastRayTest
+				for (dgInt32 j = 0; j < 3; j ++) {
+					const dgFloat32 den = (dgAbsf (segment[j]) < dgFloat32 (1.0e-8f)) ? dgFloat32 (1.0e-20f) : segment[j];
+					origin[j][i] = p0[i][j];
+					invDir[j][i] = dgFloat32 (1.0f) / den;
+				}
+				m_direction += segment.Scale4 (dgRsqrt (segment.DotProduct3(segment)));
+			}
+		}
+
+		m_originX = dgVector (origin[0][0], origin[0][1], origin[0][2], origin[0][3]);
+		m_originY = dgVector (origin[1][0], origin[1][1], origin[1][2], origin[1][3]);
+		m_originZ = dgVector (origin[2][0], origin[2][1], origin[2][2], origin[2][3]);
+		m_invDirX = dgVector (invDir[0][0], invDir[0][1], invDir[0][2], invDir[0][3]);
+		m_invDirY = dgVector (invDir[1][0], invDir[1][1], invDir[1][2], invDir[1][3]);
+		m_invDirZ = dgVector (invDir[2][0], invDir[2][1], invDir[2][2], invDir[2][3]);
+		UpdateMaxParam ();
+	}
+
+	DG_INLINE void UpdateMaxParam ()
+	{
+		m_maxParam = dgVector (m_lanes[0].m_maxParam, m_lanes[1].m_maxParam, m_lanes[2].m_maxParam, m_lanes[3].m_maxParam);
+	}
+
+	// returns the mask of the active rays that intersect the box before their closest hit so far
+	DG_INLINE dgInt32 BoxTest (const dgVector& minBox, const dgVector& maxBox) const
+	{
+		const dgVector tx0 ((dgVector (minBox.m_x) - m_originX) * m_invDirX);
+		const dgVector tx1 ((dgVector (maxBox.m_x) - m_originX) * m_invDirX);
+		const dgVector ty0 ((dgVector (minBox.m_y) - m_originY) * m_invDirY);
+		const dgVector ty1 ((dgVector (maxBox.m_y) - m_originY) * m_invDirY);
+		const dgVector tz0 ((dgVector (minBox.m_z) - m_originZ) * m_invDirZ);
+		const dgVector tz1 ((dgVector (maxBox.m_z) - m_originZ) * m_invDirZ);
+
+		const dgVector t0 (tx0.GetMin(tx1).GetMax(ty0.GetMin(ty1)).GetMax(tz0.GetMin(tz1)).GetMax(dgVector::m_zero));
+		const dgVector t1 (tx0.GetMax(tx1).GetMin(ty0.GetMax(ty1)).GetMin(tz0.GetMax(tz1)).GetMin(m_maxParam));
+		return (t0 <= t1).GetSignMask() & m_activeMask;
+	}
+
+	void CastBody (dgBody* const body, dgInt32 mask)
+	{
+		for (dgInt32 i = 0; mask; i ++) {
+			if (mask & 1) {
+				dgLane& lane = m_lanes[i];
+				lane.m_maxParam = body->RayCast(lane.m_line, Filter, m_prefilter ? Prefilter : NULL, &lane, lane.m_maxParam);
+			}
+			mask >>= 1;
+		}
+		UpdateMaxParam ();
+	}
+
+	dgInt32 GetHitCount() const
+	{
+		dgInt32 count = 0;
+		for (dgInt32 i = 0; i < DG_RAYCAST_PACKET_SIZE; i ++) {
+			count += (m_lanes[i].m_hit && m_lanes[i].m_hit->m_hitBody) ? 1 : 0;
+		}
+		return count;
+	}
+
+	static dgUnsigned32 Prefilter (const dgBody* const body, const dgCollisionInstance* const collision, void* const context)
+	{
+		const dgLane* const lane = (dgLane*) context;
+		return lane->m_packet->m_prefilter (body, collision, lane->m_packet->m_userData);
+	}
+
+	static dgFloat32 Filter (const dgBody* const body, const dgCollisionInstance* const collision, const dgVector& contact, const dgVector& normal, dgInt64 collisionID, void* const context, dgFloat32 intersetParam)
+	{
+		dgLane* const lane = (dgLane*) context;
+		dgRayCastBatchHit* const hit = lane->m_hit;
+		dgAssert (intersetParam < lane->m_maxParam);
+		hit->m_point[0] = contact.m_x;
+		hit->m_point[1] = contact.m_y;
+		hit->m_point[2] = contact.m_z;
+		hit->m_point[3] = dgFloat32 (0.0f);
+		hit->m_normal[0] = normal.m_x;
+		hit->m_normal[1] = normal.m_y;
+		hit->m_normal[2] = normal.m_z;
+		hit->m_normal[3] = dgFloat32 (0.0f);
+		hit->m_contaID = collisionID;
+		hit->m_hitBody = body;
+		hit->m_param = intersetParam;
+		return intersetParam;
+	}
+
+	dgVector m_originX;
+	dgVector m_originY;
+	dgVector m_originZ;
+	dgVector m_invDirX;
+	dgVector m_invDirY;
+	dgVector m_invDirZ;
+	dgVector m_maxParam;
+	dgVector m_direction;
+	dgLane m_lanes[DG_RAYCAST_PACKET_SIZE];
+	OnRayPrecastAction m_prefilter;
+	void* m_userData;
+	dgInt32 m_activeMask;
+} DG_GCC_VECTOR_ALIGMENT;
+
+void dgBroadPhase::RayCastPacket (const dgBroadPhaseNode** stackPool, dgInt32 stack, dgRayCastPacket& packet) const
+{
+	while (stack) {
+		stack--;
+		const dgBroadPhaseNode* const me = stackPool[stack];
+		dgAssert(me);
+		const dgInt32 mask = packet.BoxTest(me->m_minBox, me->m_maxBox);
+		if (mask) {
+			dgBody* const body = me->GetBody();
+			if (body) {
+				dgAssert(!me->GetLeft());
+				dgAssert(!me->GetRight());
+				packet.CastBody(body, mask);
+			} else if (me->IsAggregate()) {
+				dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)me;
+				if (aggregate->m_root) {
+					stackPool[stack] = aggregate->m_root;
+					stack++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			} else {
+				const dgBroadPhaseNode* const left = me->GetLeft();
+				const dgBroadPhaseNode* const right = me->GetRight();
+				dgAssert(left);
+				dgAssert(right);
+
+				// push the far child first so that the packet visits the near child first
+				const dgVector diff (left->m_minBox + left->m_maxBox - right->m_minBox - right->m_maxBox);
+				if (diff.DotProduct3(packet.m_direction) > dgFloat32 (0.0f)) {
+					stackPool[stack] = left;
+					stackPool[stack + 1] = right;
+				} else {
+					stackPool[stack] = right;
+					stackPool[stack + 1] = left;
+				}
+				stack += 2;
+				dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+			}
+		}
+	}
+}
+
+void dgBroadPhase::RayCastBatchKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dTimeTrackerEvent(__FUNCTION__);
+	dgRayCastBatchDescriptor* const descriptor = (dgRayCastBatchDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgBroadPhase* const broadPhase = world->GetBroadPhase();
+
+	dgInt32 hitCount = 0;
+	const dgInt32 raysCount = descriptor->m_raysCount;
+	const dgInt32 stride = descriptor->m_strideInBytes / sizeof (dgFloat32);
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_RAYCAST_BATCH_CHUNK_SIZE); i < raysCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_RAYCAST_BATCH_CHUNK_SIZE)) {
+		const dgInt32 chunkCount = dgMin (i + DG_RAYCAST_BATCH_CHUNK_SIZE, raysCount);
+		for (dgInt32 j = i; j < chunkCount; j += DG_RAYCAST_PACKET_SIZE) {
+			dgVector p0[DG_RAYCAST_PACKET_SIZE];
+			dgVector p1[DG_RAYCAST_PACKET_SIZE];
+			const dgInt32 count = dgMin (DG_RAYCAST_PACKET_SIZE, chunkCount - j);
+			for (dgInt32 k = 0; k < count; k ++) {
+				const dgFloat32* const q0 = &descriptor->m_p0[(j + k) * stride];
+				const dgFloat32* const q1 = &descriptor->m_p1[(j + k) * stride];
+				p0[k] = dgVector (q0[0], q0[1], q0[2], dgFloat32 (0.0f));
+				p1[k] = dgVector (q1[0], q1[1], q1[2], dgFloat32 (0.0f));
+			}
+			dgRayCastPacket packet (p0, p1, count, descriptor->m_prefilter, descriptor->m_userData, &descriptor->m_hits[j]);
+			broadPhase->RayCastPacket (packet);
+			hitCount += packet.GetHitCount();
+		}
+	}
+	dgAtomicExchangeAndAdd(&descriptor->m_hitCount, hitCount);
+}
+
+dgInt32 dgBroadPhase::RayCastBatch (const dgFloat32* const p0, const dgFloat32* const p1, dgInt32 strideInBytes, dgInt32 raysCount, OnRayPrecastAction prefilter, void* const userData, dgRayCastBatchHit* const hits)
+{
+	dgAssert (strideInBytes >= dgInt32 (3 * sizeof (dgFloat32)));
+	dgRayCastBatchDescriptor descriptor;
+	descriptor.m_p0 = p0;
+	descriptor.m_p1 = p1;
+	descriptor.m_hits = hits;
+	descriptor.m_prefilter = prefilter;
+	descriptor.m_userData = userData;
+	descriptor.m_strideInBytes = strideInBytes;
+	descriptor.m_raysCount = raysCount;
+	descriptor.m_atomicIndex = 0;
+	descriptor.m_hitCount = 0;
+
+	if (m_world->IsUpdating()) {
+		// the workers are busy with the update, which includes calls from inside a callback, trace the batch on the calling thread
+		RayCastBatchKernel (&descriptor, m_world, 0);
+	} else {
+		const dgInt32 threadsCount = dgMin (m_world->GetThreadCount(), (raysCount + DG_RAYCAST_BATCH_CHUNK_SIZE - 1) / DG_RAYCAST_BATCH_CHUNK_SIZE);
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			m_world->QueueJob(RayCastBatchKernel, &descriptor, m_world);
+		}
+		m_world->SynchronizationBarrier();
+	}
+	return descriptor.m_hitCount;
+}
+
+void dgBroadPhase::ConvexCastBatchKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dTimeTrackerEvent(__FUNCTION__);
+	dgConvexCastBatchDescriptor* const descriptor = (dgConvexCastBatchDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgBroadPhase* const broadPhase = world->GetBroadPhase();
+
+	dgInt32 hitCount = 0;
+	const dgInt32 maxContacts = descriptor->m_maxContacts;
+	const dgInt32 queriesCount = descriptor->m_queriesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CONVEX_CAST_BATCH_CHUNK_SIZE); i < queriesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CONVEX_CAST_BATCH_CHUNK_SIZE)) {
+		const dgInt32 chunkCount = dgMin (i + DG_CONVEX_CAST_BATCH_CHUNK_SIZE, queriesCount);
+		for (dgInt32 j = i; j < chunkCount; j ++) {
+			const dgConvexCastBatchQuery& query = descriptor->m_queries[j];
+			const dgVector target (query.m_target[0], query.m_target[1], query.m_target[2], dgFloat32 (0.0f));
+			dgConvexCastReturnInfo* const info = descriptor->m_info ? &descriptor->m_info[j * maxContacts] : NULL;
+
+			dgFloat32 param = dgFloat32 (1.0f);
+			descriptor->m_contactsCount[j] = broadPhase->ConvexCast (query.m_shape, dgMatrix (query.m_matrix), target, &param, descriptor->m_prefilter, descriptor->m_userData, info, maxContacts, threadID);
+			descriptor->m_params[j] = param;
+			hitCount += (param < dgFloat32 (1.0f)) ? 1 : 0;
+		}
+	}
+	dgAtomicExchangeAndAdd(&descriptor->m_hitCount, hitCount);
+}
+
+void dgBroadPhase::CollideBatchKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dTimeTrackerEvent(__FUNCTION__);
+	dgConvexCastBatchDescriptor* const descriptor = (dgConvexCastBatchDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgBroadPhase* const broadPhase = world->GetBroadPhase();
+
+	dgInt32 hitCount = 0;
+	const dgInt32 maxContacts = descriptor->m_maxContacts;
+	const dgInt32 queriesCount = descriptor->m_queriesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CONVEX_CAST_BATCH_CHUNK_SIZE); i < queriesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CONVEX_CAST_BATCH_CHUNK_SIZE)) {
+		const dgInt32 chunkCount = dgMin (i + DG_CONVEX_CAST_BATCH_CHUNK_SIZE, queriesCount);
+		for (dgInt32 j = i; j < chunkCount; j ++) {
+			const dgConvexCastBatchQuery& query = descriptor->m_queries[j];
+			const dgInt32 count = broadPhase->Collide (query.m_shape, dgMatrix (query.m_matrix), descriptor->m_prefilter, descriptor->m_userData, &descriptor->m_info[j * maxContacts], maxContacts, threadID);
+			descriptor->m_contactsCount[j] = count;
+			hitCount += count ? 1 : 0;
+		}
+	}
+	dgAtomicExchangeAndAdd(&descriptor->m_hitCount, hitCount);
+}
+
+dgInt32 dgBroadPhase::ConvexCastBatch (const dgConvexCastBatchQuery* const queries, dgInt32 queriesCount, dgFloat32* const params, dgInt32* const contactsCount, dgConvexCastReturnInfo* const info, dgInt32 maxContactsPerQuery, OnRayPrecastAction prefilter, void* const userData, dgInt32 threadIndex)
+{
+	dgAssert (!maxContactsPerQuery || info);
+	dgConvexCastBatchDescriptor descriptor;
+	descriptor.m_queries = queries;
+	descriptor.m_info = info;
+	descriptor.m_params = params;
+	descriptor.m_contactsCount = contactsCount;
+	descriptor.m_prefilter = prefilter;
+	descriptor.m_userData = userData;
+	descriptor.m_queriesCount = queriesCount;
+	descriptor.m_maxContacts = info ? maxContactsPerQuery : 0;
+	descriptor.m_atomicIndex = 0;
+	descriptor.m_hitCount = 0;
+
+	if (m_world->IsUpdating()) {
+		// the workers are busy with the update, which includes calls from inside a callback, run the batch on the calling thread
+		ConvexCastBatchKernel (&descriptor, m_world, threadIndex);
+	} else {
+		const dgInt32 threadsCount = dgMin (m_world->GetThreadCount(), (queriesCount + DG_CONVEX_CAST_BATCH_CHUNK_SIZE - 1) / DG_CONVEX_CAST_BATCH_CHUNK_SIZE);
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			m_world->QueueJob(ConvexCastBatchKernel, &descriptor, m_world);
+		}
+		m_world->SynchronizationBarrier();
+	}
+	return descriptor.m_hitCount;
+}
+
+dgInt32 dgBroadPhase::CollideBatch (const dgConvexCastBatchQuery* const queries, dgInt32 queriesCount, dgInt32* const contactsCount, dgConvexCastReturnInfo* const info, dgInt32 maxContactsPerQuery, OnRayPrecastAction prefilter, void* const userData, dgInt32 threadIndex)
+{
+	dgAssert (info && (maxContactsPerQuery > 0));
+	dgConvexCastBatchDescriptor descriptor;
+	descriptor.m_queries = queries;
+	descriptor.m_info = info;
+	descriptor.m_params = NULL;
+	descriptor.m_contactsCount = contactsCount;
+	descriptor.m_prefilter = prefilter;
+	descriptor.m_userData = userData;
+	descriptor.m_queriesCount = queriesCount;
+	descriptor.m_maxContacts = maxContactsPerQuery;
+	descriptor.m_atomicIndex = 0;
+	descriptor.m_hitCount = 0;
+
+	if (m_world->IsUpdating()) {
+		// the workers are busy with the update, which includes calls from inside a callback, run the batch on the calling thread
+		CollideBatchKernel (&descriptor, m_world, threadIndex);
+	} else {
+		const dgInt32 threadsCount = dgMin (m_world->GetThreadCount(), (queriesCount + DG_CONVEX_CAST_BATCH_CHUNK_SIZE - 1) / DG_CONVEX_CAST_BATCH_CHUNK_SIZE);
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			m_world->QueueJob(CollideBatchKernel, &descriptor, m_world);
+		}
+		m_world->SynchronizationBarrier();
+	}
+	return descriptor.m_hitCount;
+}
+
 void dgBroadPhase::CollisionChange (dgBody* const body, dgCollisionInstance* const collision)
 {
 	dgCollisionInstance* const bodyCollision = body->GetCollision();
@@ -715,15 +1296,21 @@ void dgBroadPhase::UpdateBody(dgBody* const body, dgInt32 threadIndex)
 		dgThreadHiveScopeLock lock(m_world, &m_criticalSectionLock, true);
 		if (body1->GetBroadPhaseAggregate()) {
 			dgBroadPhaseAggregate* const aggregate = body1->GetBroadPhaseAggregate();
-			aggregate->m_isInEquilibrium = body1->m_equilibrium;
+			aggregate->m_isInEquilibrium = body1->m_state->m_equilibrium;
 			aggregate->SetAsDirty(m_lru + 1);
 		}
 
 		m_dirtyNodesCount += (node->m_nodeIsDirtyLru != (m_lru + 1)) ? 1 : 0;
 		node->SetAsDirty(m_lru + 1);
-		if (!dgBoxInclusionTest(body1->m_minAABB, body1->m_maxAABB, node->m_minBox, node->m_maxBox)) {
+
+		// stamp the path to the root so that query caches only revisit the branches with moving bodies
+		m_motionLru ++;
+		for (dgBroadPhaseNode* parent = node->m_parent; parent && ((parent->m_nodeIsDirtyLru != (m_lru + 1)) || parent->IsAggregate()); parent = parent->m_parent) {
+			parent->SetAsDirty(m_lru + 1);
+		}
+		if (!dgBoxInclusionTest(body1->m_state->m_minAABB, body1->m_state->m_maxAABB, node->m_minBox, node->m_maxBox)) {
 			dgAssert(!node->IsAggregate());
-			node->SetAABB(body1->m_minAABB, body1->m_maxAABB);
+			node->SetAABB(body1->m_state->m_minAABB, body1->m_state->m_maxAABB);
 			for (dgBroadPhaseNode* parent = node->m_parent; parent != root; parent = parent->m_parent) {
 				if (!parent->IsAggregate()) {
 					dgVector minBox;
@@ -853,7 +1440,7 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 					dgBroadPhaseNode* const leftNode = node->GetLeft();
 					dgBody* const leftBody = leftNode->GetBody();
 					if (leftBody) {
-						node->SetAABB(leftBody->m_minAABB, leftBody->m_maxAABB);
+						node->SetAABB(leftBody->m_state->m_minAABB, leftBody->m_state->m_maxAABB);
 						leafArray[leafNodesCount] = leftNode;
 						leafNodesCount++;
 					} else if (leftNode->IsAggregate()) {
@@ -863,7 +1450,7 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 					dgBroadPhaseNode* const rightNode = node->GetRight();
 					dgBody* const rightBody = rightNode->GetBody();
 					if (rightBody) {
-						rightNode->SetAABB(rightBody->m_minAABB, rightBody->m_maxAABB);
+						rightNode->SetAABB(rightBody->m_state->m_minAABB, rightBody->m_state->m_maxAABB);
 						leafArray[leafNodesCount] = rightNode;
 						leafNodesCount++;
 					} else if (rightNode->IsAggregate()) {
@@ -874,6 +1461,7 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 
 				dgFitnessList::dgListNode* nodePtr = fitness.GetFirst();
 
+				InvalidateQueryCaches();
 				dgSortIndirect(leafArray, leafNodesCount, CompareNodes);
 				*root = BuildTopDownBig(leafArray, 0, leafNodesCount - 1, &nodePtr);
 				dgAssert(!(*root)->m_parent);
@@ -893,6 +1481,7 @@ void dgBroadPhase::RotateLeft (dgBroadPhaseTreeNode* const node, dgBroadPhaseNod
 
 	dgBroadPhaseTreeNode* const parent = (dgBroadPhaseTreeNode*)node->m_parent;
 	dgAssert(parent && !parent->IsLeafNode());
+	node->m_nodeIsDirtyLru = dgMax (node->m_nodeIsDirtyLru, parent->m_nodeIsDirtyLru);
 	dgFloat32 cost1 = CalculateSurfaceArea(node->m_left, parent->m_left, cost1P0, cost1P1);
 
 	dgVector cost2P0;
@@ -965,6 +1554,7 @@ void dgBroadPhase::RotateRight (dgBroadPhaseTreeNode* const node, dgBroadPhaseNo
 
 	dgBroadPhaseTreeNode* const parent = (dgBroadPhaseTreeNode*) node->m_parent;
 	dgAssert (parent && !parent->IsLeafNode());
+	node->m_nodeIsDirtyLru = dgMax (node->m_nodeIsDirtyLru, parent->m_nodeIsDirtyLru);
 
 	dgFloat32 cost1 = CalculateSurfaceArea(node->m_right, parent->m_right, cost1P0, cost1P1);
 
@@ -1041,13 +1631,13 @@ bool dgBroadPhase::ValidateContactCache(dgContact* const contact, dgFloat32 time
 		dgBody* const body1 = contact->GetBody1();
 
 		dgVector deltaTime(timestep);
-		dgVector positStep(deltaTime * (body0->m_veloc - body1->m_veloc));
+		dgVector positStep(deltaTime * (body0->m_state->m_veloc - body1->m_state->m_veloc));
 		positStep = ((positStep.DotProduct4(positStep)) > m_velocTol) & positStep;
 		contact->m_positAcc += positStep;
 
 		dgVector positError2(contact->m_positAcc.DotProduct4(contact->m_positAcc));
 		if ((positError2 < m_linearContactError2).GetSignMask()) {
-			dgVector rotationStep(deltaTime * (body0->m_omega - body1->m_omega));
+			dgVector rotationStep(deltaTime * (body0->m_state->m_omega - body1->m_state->m_omega));
 			rotationStep = ((rotationStep.DotProduct4(rotationStep)) > m_velocTol) & rotationStep;
 			contact->m_rotationAcc = contact->m_rotationAcc * dgQuaternion(dgFloat32(1.0f), rotationStep.m_x, rotationStep.m_y, rotationStep.m_z);
 
@@ -1064,7 +1654,8 @@ bool dgBroadPhase::ValidateContactCache(dgContact* const contact, dgFloat32 time
 
 void dgBroadPhase::CalculatePairContacts (dgPair* const pair, dgInt32 threadID)
 {
-    dgContactPoint contacts[DG_MAX_CONTATCS];
+	dgFrameArenaScope scratch(&m_world->m_threadArena[threadID]);
+	dgContactPoint* const contacts = scratch.Alloc<dgContactPoint>(DG_MAX_CONTATCS);
 
 	pair->m_cacheIsValid = false;
 	pair->m_contactBuffer = contacts;
@@ -1103,7 +1694,7 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 	dgAssert (body1->GetWorld());
 	dgAssert (body0->GetWorld() == world);
 	dgAssert (body1->GetWorld() == world);
-	if (!(body0->m_collideWithLinkedBodies & body1->m_collideWithLinkedBodies)) {
+	if (!(body0->m_state->m_collideWithLinkedBodies & body1->m_state->m_collideWithLinkedBodies)) {
 		if (world->AreBodyConnectedByJoints (body0, body1)) {
 			return;
 		}
@@ -1130,10 +1721,10 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 
 void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFloat32 timestep, dgInt32 threadID)
 {
-	dTimeTrackerEvent(__FUNCTION__);
-
 //	dgAssert ((body0->GetInvMass().m_w != dgFloat32 (0.0f)) || (body1->GetInvMass().m_w != dgFloat32 (0.0f)) || (body0->IsRTTIType(dgBody::m_kinematicBodyRTTI)) || (body1->IsRTTIType(dgBody::m_kinematicBodyRTTI)));
-	if ((body0->GetInvMass().m_w != dgFloat32 (0.0f)) || (body1->GetInvMass().m_w != dgFloat32 (0.0f)) || 
+	if (body0->IsRTTIType(dgBody::m_sensorBodyRTTI) | body1->IsRTTIType(dgBody::m_sensorBodyRTTI)) {
+		AddSensorPair (body0, body1, threadID);
+	} else if ((body0->GetInvMass().m_w != dgFloat32 (0.0f)) || (body1->GetInvMass().m_w != dgFloat32 (0.0f)) || 
 		(body0->IsRTTIType(dgBody::m_kinematicBodyRTTI)) || (body1->IsRTTIType(dgBody::m_kinematicBodyRTTI))) {
 		dgThreadHiveScopeLock lock(m_world, &m_contacJointLock, true);
 		dgContact* contact = m_world->FindContactJoint(body0, body1);
@@ -1155,7 +1746,7 @@ void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFl
 
 				if (material->m_flags & dgContactMaterial::m_collisionEnable) {
 					const dgInt32 kinematicBodyEquilibrium = (((body0->IsRTTIType(dgBody::m_kinematicBodyRTTI) ? true : false) & body0->IsCollidable()) | ((body1->IsRTTIType(dgBody::m_kinematicBodyRTTI) ? true : false) & body1->IsCollidable())) ? 0 : 1;
-					if (!(body0->m_equilibrium & body1->m_equilibrium & kinematicBodyEquilibrium)) {
+					if (!(body0->m_state->m_equilibrium & body1->m_state->m_equilibrium & kinematicBodyEquilibrium)) {
 						const dgInt32 isSofBody0 = body0->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI);
 						const dgInt32 isSofBody1 = body1->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI);
 						if (isSofBody0 || isSofBody1) {
@@ -1184,6 +1775,189 @@ void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFl
 }
 
 
+void dgBroadPhase::AddSensorPair (dgBody* const body0, dgBody* const body1, dgInt32 threadID)
+{
+	dgSensorBody* const sensor = (dgSensorBody*) (body0->IsRTTIType(dgBody::m_sensorBodyRTTI) ? body0 : body1);
+	dgBody* const body = (sensor == body0) ? body1 : body0;
+	if (body->IsRTTIType(dgBody::m_sensorBodyRTTI)) {
+		return;
+	}
+
+	dgUnsigned32 group0_ID = dgUnsigned32 (sensor->m_bodyGroupId);
+	dgUnsigned32 group1_ID = dgUnsigned32 (body->m_bodyGroupId);
+	if (group1_ID < group0_ID) {
+		dgSwap (group0_ID, group1_ID);
+	}
+	dgUnsigned32 key = (group1_ID << 16) + group0_ID;
+	const dgBodyMaterialList* const materialList = m_world;  
+	dgAssert (materialList->Find (key));
+	const dgContactMaterial* const material = &materialList->Find (key)->GetInfo();
+	if (!(material->m_flags & dgContactMaterial::m_collisionEnable)) {
+		return;
+	}
+
+	const dgUnsigned64 pairKey = (dgUnsigned64 (sensor->m_uniqueID) << 32) + dgUnsigned32 (body->m_uniqueID);
+	if (sensor->m_state->m_equilibrium & body->m_state->m_equilibrium) {
+		// neither body moved, the overlap found last update is carried over by the merge
+		if (FindSensorOverlap (pairKey)) {
+			return;
+		}
+	}
+
+	if (m_world->IntersectionTest (sensor, body, threadID)) {
+		dgSensorPairs& pairs = m_sensorPairs[threadID];
+		dgSensorOverlap& overlap = pairs.m_pairs[pairs.m_count];
+		overlap.m_key = pairKey;
+		overlap.m_sensor = sensor;
+		overlap.m_body = body;
+		overlap.m_eventType = dgSensorBody::m_overlapBegin;
+		pairs.m_count ++;
+	}
+}
+
+bool dgBroadPhase::FindSensorOverlap (dgUnsigned64 key) const
+{
+	dgInt32 i0 = 0;
+	dgInt32 i1 = m_sensorOverlapsCount - 1;
+	const dgSensorOverlap* const overlaps = &m_sensorOverlaps[0];
+	while (i0 <= i1) {
+		const dgInt32 mid = (i0 + i1) >> 1;
+		if (overlaps[mid].m_key < key) {
+			i0 = mid + 1;
+		} else if (overlaps[mid].m_key > key) {
+			i1 = mid - 1;
+		} else {
+			return true;
+		}
+	}
+	return false;
+}
+
+dgInt32 dgBroadPhase::CompareSensorOverlaps(const dgSensorOverlap* const overlapA, const dgSensorOverlap* const overlapB, void* const notUsed)
+{
+	if (overlapA->m_key < overlapB->m_key) {
+		return -1;
+	} else if (overlapA->m_key > overlapB->m_key) {
+		return 1;
+	}
+	return 0;
+}
+
+void dgBroadPhase::AddSensorEvent (const dgSensorOverlap& overlap, dgInt32 eventType)
+{
+	if (overlap.m_sensor->m_sensorCallback) {
+		dgSensorOverlap& event = m_sensorEvents[m_sensorEventsCount];
+		event = overlap;
+		event.m_eventType = eventType;
+		m_sensorEventsCount ++;
+	}
+}
+
+void dgBroadPhase::UpdateSensorOverlaps ()
+{
+	dTimeTrackerEvent(__FUNCTION__);
+
+	m_sensorEventsCount = 0;
+	const dgInt32 threadsCount = m_world->GetThreadCount();
+	dgInt32 pairsCount = 0;
+	for (dgInt32 i = 0; i < threadsCount; i ++) {
+		pairsCount += m_sensorPairs[i].m_count;
+	}
+	if (!(pairsCount | m_sensorOverlapsCount)) {
+		return;
+	}
+
+	dgFrameArenaScope scratch(&m_world->m_threadArena[0]);
+	dgSensorOverlap* const overlaps = scratch.Alloc<dgSensorOverlap>(pairsCount + m_sensorOverlapsCount);
+
+	// pairs of bodies that did not move are not tested again, so the old overlaps still hold
+	dgInt32 count = 0;
+	for (dgInt32 i = 0; i < m_sensorOverlapsCount; i ++) {
+		const dgSensorOverlap& overlap = m_sensorOverlaps[i];
+		if (overlap.m_sensor->m_state->m_equilibrium & overlap.m_body->m_state->m_equilibrium) {
+			overlaps[count] = overlap;
+			count ++;
+		}
+	}
+	for (dgInt32 i = 0; i < threadsCount; i ++) {
+		const dgSensorOverlap* const pairs = &m_sensorPairs[i].m_pairs[0];
+		for (dgInt32 j = 0; j < m_sensorPairs[i].m_count; j ++) {
+			overlaps[count] = pairs[j];
+			count ++;
+		}
+		m_sensorPairs[i].m_count = 0;
+	}
+
+	// sort by sensor and body id, so that the events do not depend on the thread count, 
+	// two moving bodies can be submitted twice by the broadphase, drop the duplicates
+	dgSort (overlaps, count, CompareSensorOverlaps);
+	dgInt32 uniqueCount = 0;
+	for (dgInt32 i = 0; i < count; i ++) {
+		if (!uniqueCount || (overlaps[uniqueCount - 1].m_key != overlaps[i].m_key)) {
+			overlaps[uniqueCount] = overlaps[i];
+			uniqueCount ++;
+		}
+	}
+
+	dgInt32 i0 = 0;
+	dgInt32 i1 = 0;
+	const dgSensorOverlap* const oldOverlaps = &m_sensorOverlaps[0];
+	while ((i0 < m_sensorOverlapsCount) || (i1 < uniqueCount)) {
+		if ((i1 >= uniqueCount) || ((i0 < m_sensorOverlapsCount) && (oldOverlaps[i0].m_key < overlaps[i1].m_key))) {
+			AddSensorEvent (oldOverlaps[i0], dgSensorBody::m_overlapEnd);
+			i0 ++;
+		} else if ((i0 >= m_sensorOverlapsCount) || (overlaps[i1].m_key < oldOverlaps[i0].m_key)) {
+			AddSensorEvent (overlaps[i1], dgSensorBody::m_overlapBegin);
+			i1 ++;
+		} else {
+			AddSensorEvent (overlaps[i1], dgSensorBody::m_overlapPersist);
+			i0 ++;
+			i1 ++;
+		}
+	}
+
+	m_sensorOverlaps.ResizeIfNecessary(uniqueCount);
+	for (dgInt32 i = 0; i < uniqueCount; i ++) {
+		m_sensorOverlaps[i] = overlaps[i];
+	}
+	m_sensorOverlapsCount = uniqueCount;
+}
+
+void dgBroadPhase::DispatchSensorEvents ()
+{
+	dTimeTrackerEvent(__FUNCTION__);
+	// a callback can destroy bodies, which clears their pending events, so read the array by index
+	for (dgInt32 i = 0; i < m_sensorEventsCount; i ++) {
+		const dgSensorOverlap& event = m_sensorEvents[i];
+		if (event.m_sensor && event.m_sensor->m_sensorCallback) {
+			event.m_sensor->m_sensorCallback (*event.m_sensor, *event.m_body, dgSensorBody::dgSensorEventType (event.m_eventType));
+		}
+	}
+	m_sensorEventsCount = 0;
+}
+
+void dgBroadPhase::RemoveSensorOverlaps (const dgBody* const body)
+{
+	dgInt32 count = 0;
+	for (dgInt32 i = 0; i < m_sensorOverlapsCount; i ++) {
+		const dgSensorOverlap& overlap = m_sensorOverlaps[i];
+		if ((overlap.m_sensor != body) && (overlap.m_body != body)) {
+			m_sensorOverlaps[count] = overlap;
+			count ++;
+		}
+	}
+	m_sensorOverlapsCount = count;
+
+	for (dgInt32 i = 0; i < m_sensorEventsCount; i ++) {
+		dgSensorOverlap& event = m_sensorEvents[i];
+		if ((event.m_sensor == body) || (event.m_body == body)) {
+			event.m_sensor = NULL;
+			event.m_body = NULL;
+		}
+	}
+}
+
+
 void dgBroadPhase::FindGeneratedBodiesCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID)
 {
 dgAssert (0);
@@ -1239,8 +2013,8 @@ void dgBroadPhase::SubmitPairs(dgBroadPhaseNode* const leafNode, dgBroadPhaseNod
 
 	dgAssert (leafNode->IsLeafNode());
 	dgBody* const body0 = leafNode->GetBody();
-	const dgVector boxP0 (body0 ? body0->m_minAABB : leafNode->m_minBox);
-	const dgVector boxP1 (body0 ? body0->m_maxAABB : leafNode->m_maxBox);
+	const dgVector boxP0 (body0 ? body0->m_state->m_minAABB : leafNode->m_minBox);
+	const dgVector boxP1 (body0 ? body0->m_state->m_maxAABB : leafNode->m_maxBox);
 
 	const bool test0 = body0 ? (body0->GetInvMass().m_w != dgFloat32(0.0f)) : true;
 	while (stack) {
@@ -1328,26 +2102,28 @@ void dgBroadPhase::KinematicBodyActivation (dgContact* const contatJoint) const
 	if (body0->IsCollidable() | body1->IsCollidable()) {
 		if (body0->IsRTTIType(dgBody::m_kinematicBodyRTTI)) {
 			if (body1->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body1->GetInvMass().m_w > dgFloat32 (0.0f))) {
-				if (body1->m_equilibrium) {
-					dgVector relVeloc (body0->m_veloc - body1->m_veloc);
-					dgVector relOmega (body0->m_omega - body1->m_omega);
+				if (body1->m_state->m_equilibrium) {
+					dgVector relVeloc (body0->m_state->m_veloc - body1->m_state->m_veloc);
+					dgVector relOmega (body0->m_state->m_omega - body1->m_state->m_omega);
 					dgVector mask2 ((relVeloc.DotProduct4(relVeloc) < dgDynamicBody::m_equilibriumError2) & (relOmega.DotProduct4(relOmega) < dgDynamicBody::m_equilibriumError2));
 
 					dgThreadHiveScopeLock lock (m_world, &body1->m_criticalSectionLock, false);
-					body1->m_sleeping = false;
-					body1->m_equilibrium = mask2.GetSignMask() ? true : false;
+					body1->m_state->m_sleeping = false;
+					body1->m_state->m_equilibrium = mask2.GetSignMask() ? true : false;
+					m_world->WakeUpIsland(body1);
 				}
 			}
 		} else if (body1->IsRTTIType(dgBody::m_kinematicBodyRTTI)) {
 			if (body0->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body0->GetInvMass().m_w > dgFloat32 (0.0f))) {
-				if (body0->m_equilibrium) {
-					dgVector relVeloc (body0->m_veloc - body1->m_veloc);
-					dgVector relOmega (body0->m_omega - body1->m_omega);
+				if (body0->m_state->m_equilibrium) {
+					dgVector relVeloc (body0->m_state->m_veloc - body1->m_state->m_veloc);
+					dgVector relOmega (body0->m_state->m_omega - body1->m_state->m_omega);
 					dgVector mask2 ((relVeloc.DotProduct4(relVeloc) < dgDynamicBody::m_equilibriumError2) & (relOmega.DotProduct4(relOmega) < dgDynamicBody::m_equilibriumError2));
 
 					dgThreadHiveScopeLock lock (m_world, &body0->m_criticalSectionLock, false);
-					body0->m_sleeping = false;
-					body0->m_equilibrium = mask2.GetSignMask() ? true : false;
+					body0->m_state->m_sleeping = false;
+					body0->m_state->m_equilibrium = mask2.GetSignMask() ? true : false;
+					m_world->WakeUpIsland(body0);
 				}
 			}
 		}
@@ -1355,16 +2131,17 @@ void dgBroadPhase::KinematicBodyActivation (dgContact* const contatJoint) const
 }
 
 
-void dgBroadPhase::CollidingPairsKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::CollidingPairsKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dTimeTrackerEvent(__FUNCTION__);
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_pairFinding);
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
 	if (broadPhase->m_scanTwoWays) {
-		broadPhase->FindCollidingPairsForwardAndBackward(descriptor, (dgList<dgBroadPhaseNode*>::dgListNode*) node, threadID);
+		broadPhase->FindCollidingPairsForwardAndBackward(descriptor, start, end, threadID);
 	} else {
-		broadPhase->FindCollidingPairsForward(descriptor, (dgList<dgBroadPhaseNode*>::dgListNode*) node, threadID);
+		broadPhase->FindCollidingPairsForward(descriptor, start, end, threadID);
 	}
 }
 
@@ -1382,14 +2159,18 @@ void dgBroadPhase::AddGeneratedBodiesContactsKernel (void* const context, void*
 void dgBroadPhase::ScanForContactJoints(dgBroadphaseSyncDescriptor& syncPoints)
 {
 	dTimeTrackerEvent(__FUNCTION__);
-	dgInt32 threadsCount = m_world->GetThreadCount();
-	dgList<dgBroadPhaseNode*>::dgListNode* node = m_updateList.GetFirst();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(CollidingPairsKernel, &syncPoints, node);
-		node = node ? node->GetNext() : NULL;
+
+	// flatten the update list, so that the workers get contiguous ranges of leafs instead of all walking the list
+	dgInt32 count = 0;
+	m_updateArray.ResizeIfNecessary(m_updateList.GetCount());
+	dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+	for (dgList<dgBroadPhaseNode*>::dgListNode* node = m_updateList.GetFirst(); node; node = node->GetNext()) {
+		updateArray[count] = node->GetInfo();
+		count ++;
 	}
-	m_world->SynchronizationBarrier();
+	m_world->ParallelFor(CollidingPairsKernel, &syncPoints, count, DG_UPDATE_ARRAY_CHUNK_SIZE);
 
+	dgWorldPhaseTimer timer (m_world, 0, dgWorldPerformanceCounters::m_pairFinding);
 	const dgUnsigned32 lru = m_lru - DG_CONTACT_DELAY_FRAMES;
 	dgActiveContacts* const contactList = m_world;
 	for (dgActiveContacts::dgListNode* contactNode = contactList->GetFirst(); contactNode;) {
@@ -1397,8 +2178,8 @@ void dgBroadPhase::ScanForContactJoints(dgBroadphaseSyncDescriptor& syncPoints)
 		contactNode = contactNode->GetNext();
 		const dgBody* const body0 = contact->GetBody0();
 		const dgBody* const body1 = contact->GetBody1();
-		const dgInt32 equilbriun0 = body0->m_equilibrium;
-		const dgInt32 equilbriun1 = body1->m_equilibrium;
+		const dgInt32 equilbriun0 = body0->m_state->m_equilibrium;
+		const dgInt32 equilbriun1 = body1->m_state->m_equilibrium;
 		if (equilbriun0 & equilbriun1) {
 			contact->m_broadphaseLru = lru;
 		}
@@ -1429,16 +2210,18 @@ void dgBroadPhase::UpdateSoftBodyContactKernel(void* const context, void* const
 {
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_narrowPhase);
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
 	broadPhase->UpdateSoftBodyContacts(descriptor, descriptor->m_timestep, threadID);
 }
 
-void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_narrowPhase);
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->UpdateRigidBodyContacts(descriptor, (dgActiveContacts::dgListNode*) node, descriptor->m_timestep, threadID);
+	broadPhase->UpdateRigidBodyContacts(descriptor, start, end, threadID);
 }
 
 void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
@@ -1460,19 +2243,18 @@ void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const desc
 	}
 }
 
-void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgActiveContacts::dgListNode* const nodePtr, dgFloat32 timeStep, dgInt32 threadID)
+void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dTimeTrackerEvent(__FUNCTION__);
 
-	dgActiveContacts::dgListNode* node = nodePtr;
+	dgContact** const contactArray = &m_contactArray[0];
 	const dgFloat32 timestep = descriptor->m_timestep;
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-	while (node) {
-		dgContact* const contact = node->GetInfo();
+	for (dgInt32 i = start; i < end; i ++) {
+		dgContact* const contact = contactArray[i];
 
 		const dgBody* const body0 = contact->GetBody0();
 		const dgBody* const body1 = contact->GetBody1();
-		if (!(body0->m_equilibrium & body1->m_equilibrium)) {
+		if (!(body0->m_state->m_equilibrium & body1->m_state->m_equilibrium)) {
 			if (ValidateContactCache(contact, timestep)) {
 				contact->m_timeOfImpact = dgFloat32(1.0e10f);
 			} else {
@@ -1506,10 +2288,6 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 				}
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
@@ -1526,15 +2304,10 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	m_recursiveChunks = true;
 	const dgInt32 threadsCount = m_world->GetThreadCount();
 
-	const dgBodyMasterList* const masterList = m_world;
 	dgBroadphaseSyncDescriptor syncPoints(timestep, m_world);
 
-	dgBodyMasterList::dgListNode* node = masterList->GetLast();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(ForceAndToqueKernel, &syncPoints, node);
-		node = node ? node->GetPrev() : NULL;
-	}
-	m_world->SynchronizationBarrier();
+	const dgInt32 bodyCount = m_world->GetBodyArrayCount();
+	m_world->ParallelFor(ForceAndToqueKernel, &syncPoints, bodyCount, DG_BODY_ARRAY_CHUNK_SIZE);
 
 	// update pre-listeners after the force and true are applied
 	if (m_world->m_listeners.GetCount()) {
@@ -1547,17 +2320,13 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 		}
 	}
 
-	node = masterList->GetLast();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(SleepingStateKernel, &syncPoints, node);
-		node = node ? node->GetPrev() : NULL;
-	}
-	m_world->SynchronizationBarrier();
+	m_world->ParallelFor(SleepingStateKernel, &syncPoints, bodyCount, DG_BODY_ARRAY_CHUNK_SIZE);
 
 
 #if 0
 	static dgInt32 xxx;
 	xxx ++;
+	const dgBodyMasterList* const masterList = m_world;
 	for (dgBodyMasterList::dgListNode* node = masterList->GetLast(); node; node = node->GetPrev()) {
 		dgDynamicBody* const body = (dgDynamicBody*)node->GetInfo().GetBody();
 		if ((body->GetType() == dgBody::m_dynamicBody) && (body->GetInvMass().m_w > dgFloat32 (0.0f))) {
@@ -1601,22 +2370,28 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 		aggregateNode = aggregateNode ? aggregateNode->GetNext() : NULL;
 	}
 	m_world->SynchronizationBarrier();
-	UpdateFitness();
+	{
+		dgWorldPhaseTimer timer (m_world, 0, dgWorldPerformanceCounters::m_broadPhaseUpdate);
+		UpdateFitness();
+	}
 
 	m_scanTwoWays = (lastDirtyCount * 100) < (40 * m_updateList.GetCount());
 	ScanForContactJoints (syncPoints);
+	UpdateSensorOverlaps ();
 
+	dgInt32 contactCount = 0;
 	dgActiveContacts* const contactList = m_world;
-	dgActiveContacts::dgListNode* contactListNode = contactList->GetFirst();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(UpdateRigidBodyContactKernel, &syncPoints, contactListNode);
-		contactListNode = contactListNode ? contactListNode->GetNext() : NULL;
+	m_contactArray.ResizeIfNecessary(contactList->GetCount());
+	dgContact** const contactArray = &m_contactArray[0];
+	for (dgActiveContacts::dgListNode* contactNode = contactList->GetFirst(); contactNode; contactNode = contactNode->GetNext()) {
+		contactArray[contactCount] = contactNode->GetInfo();
+		contactCount ++;
 	}
-	m_world->SynchronizationBarrier();
+	m_world->ParallelFor(UpdateRigidBodyContactKernel, &syncPoints, contactCount, DG_CONTACT_ARRAY_CHUNK_SIZE);
 
 	if (m_pendingSoftBodyPairsCount) {
 		for (dgInt32 i = 0; i < threadsCount; i++) {
-			m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, contactListNode);
+			m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, m_world);
 		}
 		m_world->SynchronizationBarrier();
 	}
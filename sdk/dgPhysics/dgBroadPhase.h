@@ -32,11 +32,20 @@ class dgContact;
 class dgCollision;
 class dgDynamicBody;
 class dgCollisionInstance;
+class dgBroadPhase;
+class dgSensorBody;
 class dgBroadPhaseAggregate;
 
 
 #define DG_CACHE_DIST_TOL				dgFloat32 (1.0e-3f)
 #define DG_BROADPHASE_MAX_STACK_DEPTH	256
+#define DG_RAYCAST_PACKET_SIZE			4
+#define DG_RAYCAST_BATCH_CHUNK_SIZE		(DG_RAYCAST_PACKET_SIZE * 8)
+#define DG_CONVEX_CAST_BATCH_CHUNK_SIZE	8
+#define DG_UPDATE_ARRAY_CHUNK_SIZE		16
+#define DG_CONTACT_ARRAY_CHUNK_SIZE		32
+
+class dgRayCastPacket;
 
 class dgConvexCastReturnInfo
 {
@@ -50,6 +59,24 @@ class dgConvexCastReturnInfo
 	dgFloat32 m_penetration;                // contact penetration at collision point
 };
 
+class dgRayCastBatchHit
+{
+	public:
+	dgFloat32 m_point[4];					// hit point in global space
+	dgFloat32 m_normal[4];					// surface normal at hit point in global space
+	dgInt64  m_contaID;	                // collision ID at hit point
+	const dgBody* m_hitBody;				// closest body hit by the ray, NULL if the ray did not hit anything
+	dgFloat32 m_param;						// intersection parameter along the ray
+};
+
+class dgConvexCastBatchQuery
+{
+	public:
+	dgFloat32 m_matrix[16];					// shape matrix in global space
+	dgFloat32 m_target[4];					// end of the sweep in global space, not used by overlap queries
+	dgCollisionInstance* m_shape;			// shape of the query
+};
+
 
 DG_MSC_VECTOR_ALIGMENT
 class dgBroadPhaseNode
@@ -147,7 +174,7 @@ class dgBroadPhaseBodyNode: public dgBroadPhaseNode
 		,m_body(body)
 		,m_updateNode(NULL)
 	{
-		SetAABB(body->m_minAABB, body->m_maxAABB);
+		SetAABB(body->m_state->m_minAABB, body->m_state->m_maxAABB);
 		m_body->SetBroadPhase(this);
 	}
 
@@ -230,6 +257,45 @@ class dgBroadPhaseTreeNode: public dgBroadPhaseNode
 } DG_GCC_VECTOR_ALIGMENT;
 
 
+class dgBroadPhaseQueryCache
+{
+	public:
+	DG_CLASS_ALLOCATOR(allocator)
+	dgBroadPhaseQueryCache(dgMemoryAllocator* const allocator, dgFloat32 padding)
+		:m_minBox(dgFloat32(0.0f))
+		,m_maxBox(dgFloat32(0.0f))
+		,m_padding(dgVector (dgAbsf (padding)) & dgVector::m_triplexMask)
+		,m_leafs(allocator)
+		,m_boxes(allocator)
+		,m_broadPhase(NULL)
+		,m_leafsCount(0)
+		,m_treeLru(0)
+		,m_motionLru(0)
+		,m_nodeLru(0)
+	{
+	}
+
+	// query is the box min x, y, z and max x, y, z, each splatted to all lanes
+	DG_INLINE dgInt32 GetOverlapMask (dgInt32 block, const dgVector* const query) const
+	{
+		const dgVector* const box = &m_boxes[block * 6];
+		dgVector test ((box[0] < query[3]) & (box[1] < query[4]) & (box[2] < query[5]));
+		test = test & (box[3] > query[0]) & (box[4] > query[1]) & (box[5] > query[2]);
+		return test.GetSignMask();
+	}
+
+	dgVector m_minBox;
+	dgVector m_maxBox;
+	dgVector m_padding;
+	dgArray<const dgBroadPhaseNode*> m_leafs;
+	dgArray<dgVector> m_boxes;
+	const dgBroadPhase* m_broadPhase;
+	dgInt32 m_leafsCount;
+	dgUnsigned32 m_treeLru;
+	dgUnsigned32 m_motionLru;
+	dgUnsigned32 m_nodeLru;
+};
+
 class dgBroadPhase
 {
 	protected:
@@ -250,6 +316,35 @@ class dgBroadPhase
 		dgFloat32 m_timestep;
 		dgInt32 m_pairsAtomicCounter;
 	};
+
+	class dgRayCastBatchDescriptor
+	{
+		public:
+		const dgFloat32* m_p0;
+		const dgFloat32* m_p1;
+		dgRayCastBatchHit* m_hits;
+		OnRayPrecastAction m_prefilter;
+		void* m_userData;
+		dgInt32 m_strideInBytes;
+		dgInt32 m_raysCount;
+		dgInt32 m_atomicIndex;
+		dgInt32 m_hitCount;
+	};
+
+	class dgConvexCastBatchDescriptor
+	{
+		public:
+		const dgConvexCastBatchQuery* m_queries;
+		dgConvexCastReturnInfo* m_info;
+		dgFloat32* m_params;
+		dgInt32* m_contactsCount;
+		OnRayPrecastAction m_prefilter;
+		void* m_userData;
+		dgInt32 m_queriesCount;
+		dgInt32 m_maxContacts;
+		dgInt32 m_atomicIndex;
+		dgInt32 m_hitCount;
+	};
 	
 	class dgFitnessList: public dgList <dgBroadPhaseTreeNode*>
 	{
@@ -289,9 +384,29 @@ class dgBroadPhase
 		dgInt32 m_flipContacts : 1;
 	};
 
+	class dgSensorOverlap
+	{
+		public:
+		dgUnsigned64 m_key;
+		dgSensorBody* m_sensor;
+		dgBody* m_body;
+		dgInt32 m_eventType;
+	};
+
+	class dgSensorPairs
+	{
+		public:
+		DG_CLASS_ALLOCATOR(allocator)
+
+		dgArray<dgSensorOverlap> m_pairs;
+		dgInt32 m_count;
+	};
+
 	dgBroadPhase(dgWorld* const world);
 	virtual ~dgBroadPhase();
 
+	void SetThreadsCount (dgInt32 count);
+
 	DG_INLINE dgUnsigned32 GetLRU() const
 	{
 		return m_lru;
@@ -321,13 +436,20 @@ class dgBroadPhase
 	virtual void CheckStaticDynamic(dgBody* const body, dgFloat32 mass) = 0;
 	virtual void ForEachBodyInAABB (const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const = 0;
 	virtual void RayCast (const dgVector& p0, const dgVector& p1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const = 0;
+	virtual void RayCastPacket (dgRayCastPacket& packet) const = 0;
 	virtual dgInt32 Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const = 0;
 	virtual dgInt32 ConvexCast (dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const = 0;
-	virtual void FindCollidingPairsForward (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID) = 0;
-	virtual void FindCollidingPairsForwardAndBackward (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID) = 0;
+	virtual void FindCollidingPairsForward (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID) = 0;
+	virtual void FindCollidingPairsForwardAndBackward (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID) = 0;
 
 	void ScanForContactJoints(dgBroadphaseSyncDescriptor& syncPoints);
 
+	dgInt32 RayCastBatch (const dgFloat32* const p0, const dgFloat32* const p1, dgInt32 strideInBytes, dgInt32 raysCount, OnRayPrecastAction prefilter, void* const userData, dgRayCastBatchHit* const hits);
+	dgInt32 ConvexCastBatch (const dgConvexCastBatchQuery* const queries, dgInt32 queriesCount, dgFloat32* const params, dgInt32* const contactsCount, dgConvexCastReturnInfo* const info, dgInt32 maxContactsPerQuery, OnRayPrecastAction prefilter, void* const userData, dgInt32 threadIndex);
+	dgInt32 CollideBatch (const dgConvexCastBatchQuery* const queries, dgInt32 queriesCount, dgInt32* const contactsCount, dgConvexCastReturnInfo* const info, dgInt32 maxContactsPerQuery, OnRayPrecastAction prefilter, void* const userData, dgInt32 threadIndex);
+	dgInt32 Collide(dgBroadPhaseQueryCache* const cache, dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	dgInt32 ConvexCast (dgBroadPhaseQueryCache* const cache, dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+
 	void UpdateBody(dgBody* const body, dgInt32 threadIndex);
 	void AddInternallyGeneratedBody(dgBody* const body)
 	{
@@ -339,11 +461,14 @@ class dgBroadPhase
 
 	void MoveNodes (dgBroadPhase* const dest);
 
+	void DispatchSensorEvents ();
+	void RemoveSensorOverlaps (const dgBody* const body);
+
 	protected:
 	virtual void LinkAggregate (dgBroadPhaseAggregate* const aggregate) = 0; 
 	virtual void UnlinkAggregate (dgBroadPhaseAggregate* const aggregate) = 0; 
 
-	bool DoNeedUpdate(dgBodyMasterList::dgListNode* const node) const;
+	bool DoNeedUpdate(const dgBody* const body) const;
 	dgFloat64 CalculateEntropy (dgFitnessList& fitness, dgBroadPhaseNode** const root);
 	dgBroadPhaseTreeNode* InsertNode (dgBroadPhaseNode* const root, dgBroadPhaseNode* const node);
 
@@ -356,9 +481,14 @@ class dgBroadPhase
 	bool ValidateContactCache(dgContact* const contact, dgFloat32 timestep) const;
     void AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex);
 	void AddPair (dgBody* const body0, dgBody* const body1, dgFloat32 timestep, dgInt32 threadID);	
+	void AddSensorPair (dgBody* const body0, dgBody* const body1, dgInt32 threadID);
+	bool FindSensorOverlap (dgUnsigned64 key) const;
+	void UpdateSensorOverlaps ();
+	void AddSensorEvent (const dgSensorOverlap& overlap, dgInt32 eventType);
 
 	void ForEachBodyInAABB (const dgBroadPhaseNode** stackPool, dgInt32 stack, const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const;
 	void RayCast (const dgBroadPhaseNode** stackPool, dgFloat32* const distance, dgInt32 stack, const dgVector& l0, const dgVector& l1, dgFastRayTest& ray, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
+	void RayCastPacket (const dgBroadPhaseNode** stackPool, dgInt32 stack, dgRayCastPacket& packet) const;
 
 	dgInt32 ConvexCast (const dgBroadPhaseNode** stackPool, dgFloat32* const distance, dgInt32 stack, const dgVector& velocA, const dgVector& velocB, dgFastRayTest& ray,  
 						dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
@@ -366,8 +496,15 @@ class dgBroadPhase
 	dgInt32 Collide(const dgBroadPhaseNode** stackPool, dgInt32* const overlap, dgInt32 stack, const dgVector& p0, const dgVector& p1, 
 		            dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
 
-	void SleepingState (dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID);
-	void ApplyForceAndtorque (dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	void UpdateQueryCache (dgBroadPhaseQueryCache* const cache, const dgVector& minBox, const dgVector& maxBox) const;
+	void CollectQueryCacheLeafs (dgBroadPhaseQueryCache* const cache, dgUnsigned32 lru) const;
+	DG_INLINE void InvalidateQueryCaches()
+	{
+		m_treeLru ++;
+	}
+
+	void SleepingState (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	void ApplyForceAndtorque (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	
 	void UpdateAggregateEntropy (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseAggregate*>::dgListNode* node, dgInt32 threadID);
 
@@ -378,17 +515,21 @@ class dgBroadPhase
 	
 	void FindGeneratedBodiesCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
 	void UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID);
-	void UpdateRigidBodyContacts (dgBroadphaseSyncDescriptor* const descriptor, dgActiveContacts::dgListNode* const node, dgFloat32 timeStep, dgInt32 threadID);
+	void UpdateRigidBodyContacts (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	void SubmitPairs (dgBroadPhaseNode* const body, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threaCount, dgInt32 threadID);
 		
-	static void SleepingStateKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void ForceAndToqueKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void CollidingPairsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void SleepingStateKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void ForceAndToqueKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void CollidingPairsKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	static void UpdateAggregateEntropyKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void AddGeneratedBodiesContactsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void UpdateRigidBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void UpdateRigidBodyContactKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	static void UpdateSoftBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void RayCastBatchKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void ConvexCastBatchKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void CollideBatchKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static dgInt32 CompareNodes(const dgBroadPhaseNode* const nodeA, const dgBroadPhaseNode* const nodeB, void* const notUsed);
+	static dgInt32 CompareSensorOverlaps(const dgSensorOverlap* const overlapA, const dgSensorOverlap* const overlapB, void* const notUsed);
 
 	class dgPendingCollisionSofBodies
 	{
@@ -402,12 +543,23 @@ class dgBroadPhase
 	dgList<dgBody*> m_generatedBodies;
 	dgList<dgBroadPhaseNode*> m_updateList;
 	dgList<dgBroadPhaseAggregate*> m_aggregateList;
+	dgArray<dgBroadPhaseNode*> m_updateArray;
+	dgArray<dgContact*> m_contactArray;
 	dgUnsigned32 m_lru;
+	dgUnsigned32 m_treeLru;
+	dgUnsigned32 m_motionLru;
 	dgThread::dgCriticalSection m_contacJointLock;
 	dgThread::dgCriticalSection m_criticalSectionLock;
 	dgArray<dgPendingCollisionSofBodies> m_pendingSoftBodyCollisions;
 	dgInt32 m_pendingSoftBodyPairsCount;
 	dgInt32 m_dirtyNodesCount;
+
+	// sensor overlaps are written lock free to per thread buffers and merged after the pair scan
+	dgSensorPairs* m_sensorPairs;
+	dgArray<dgSensorOverlap> m_sensorOverlaps;
+	dgArray<dgSensorOverlap> m_sensorEvents;
+	dgInt32 m_sensorOverlapsCount;
+	dgInt32 m_sensorEventsCount;
 	bool m_scanTwoWays;
 	bool m_recursiveChunks;
 
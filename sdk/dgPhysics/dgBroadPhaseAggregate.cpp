@@ -121,7 +121,7 @@ void dgBroadPhaseAggregate::ImproveEntropy()
 	if (m_root) {
 		if (m_root->IsLeafNode()) {
 			dgAssert (m_root->GetBody());
-			m_isInEquilibrium = m_root->GetBody()->m_equilibrium;
+			m_isInEquilibrium = m_root->GetBody()->m_state->m_equilibrium;
 		} else if (!m_isInEquilibrium) {
 
 			bool equlibrium = true;
@@ -131,8 +131,8 @@ void dgBroadPhaseAggregate::ImproveEntropy()
 				entropy += tmpNode->m_surfaceArea;
 				const dgBody* const leftBody = tmpNode->m_left->GetBody();
 				const dgBody* const rightBody = tmpNode->m_right->GetBody();
-				equlibrium &= (!leftBody || leftBody->m_equilibrium) ? true : false;
-				equlibrium &= (!rightBody ||rightBody->m_equilibrium) ? true : false;
+				equlibrium &= (!leftBody || leftBody->m_state->m_equilibrium) ? true : false;
+				equlibrium &= (!rightBody ||rightBody->m_state->m_equilibrium) ? true : false;
 			}
 
 			m_isInEquilibrium = equlibrium;
@@ -187,13 +187,13 @@ void dgBroadPhaseAggregate::SummitPairs(dgBody* const body, dgFloat32 timestep,
 		if (m_root->IsLeafNode()) {
 			dgAssert (m_root->GetBody());
 			m_broadPhase->AddPair(body, m_root->GetBody(), timestep, threadID);
-		} else if (!(m_isInEquilibrium & body->m_equilibrium)) {
+		} else if (!(m_isInEquilibrium & body->m_state->m_equilibrium)) {
 			dgBroadPhaseNode* pool[DG_BROADPHASE_MAX_STACK_DEPTH/2];
 			pool[0] = m_root;
 			dgInt32 stack = 1;
 
-			const dgVector& boxP0 = body->m_minAABB;
-			const dgVector& boxP1 = body->m_maxAABB;
+			const dgVector& boxP0 = body->m_state->m_minAABB;
+			const dgVector& boxP1 = body->m_state->m_maxAABB;
 
 			while (stack) {
 				stack--;
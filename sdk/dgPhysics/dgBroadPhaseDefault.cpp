@@ -54,6 +54,7 @@ void dgBroadPhaseDefault::ResetEntropy()
 
 void dgBroadPhaseDefault::UpdateFitness()
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	ImproveFitness(m_fitness, m_treeEntropy, &m_rootNode);
 }
 
@@ -93,6 +94,15 @@ void dgBroadPhaseDefault::RayCast(const dgVector& l0, const dgVector& l1, OnRayC
 }
 
 
+void dgBroadPhaseDefault::RayCastPacket(dgRayCastPacket& packet) const
+{
+	if (m_rootNode) {
+		const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+		stackPool[0] = m_rootNode;
+		dgBroadPhase::RayCastPacket(stackPool, 1, packet);
+	}
+}
+
 dgInt32 dgBroadPhaseDefault::ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
@@ -157,6 +167,7 @@ void dgBroadPhaseDefault::AddNode(dgBroadPhaseNode* const newNode)
 
 void dgBroadPhaseDefault::Add(dgBody* const body)
 {
+	InvalidateQueryCaches();
 	// create a new leaf node;
 	dgAssert (!body->GetCollision()->IsType (dgCollision::dgCollisionNull_RTTI));
 	dgBroadPhaseBodyNode* const newNode = new (m_world->GetAllocator()) dgBroadPhaseBodyNode(body);
@@ -173,6 +184,7 @@ dgBroadPhaseAggregate* dgBroadPhaseDefault::CreateAggregate()
 
 void dgBroadPhaseDefault::LinkAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryCaches();
 	AddNode(aggregate);
 	aggregate->m_broadPhase = this;
 	aggregate->m_updateNode = m_updateList.Append(aggregate);
@@ -269,6 +281,7 @@ void dgBroadPhaseDefault::RemoveNode(dgBroadPhaseNode* const node)
 
 void dgBroadPhaseDefault::UnlinkAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryCaches();
 	dgAssert (m_rootNode);
 	if (m_rootNode == aggregate) {
 		m_rootNode = NULL;
@@ -320,6 +333,7 @@ void dgBroadPhaseDefault::UnlinkAggregate(dgBroadPhaseAggregate* const aggregate
 
 void dgBroadPhaseDefault::Remove(dgBody* const body)
 {
+	InvalidateQueryCaches();
 	if (body->GetBroadPhase()) {
 		dgBroadPhaseBodyNode* const node = (dgBroadPhaseBodyNode*)body->GetBroadPhase();
 		if (node->m_updateNode) {
@@ -332,19 +346,19 @@ void dgBroadPhaseDefault::Remove(dgBody* const body)
 
 void dgBroadPhaseDefault::DestroyAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryCaches();
 	m_updateList.Remove(aggregate->m_updateNode);
 	m_aggregateList.Remove(aggregate->m_myAggregateNode);
 	RemoveNode(aggregate);
 }
 
-void dgBroadPhaseDefault::FindCollidingPairsForward(dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const nodePtr, dgInt32 threadID)
+void dgBroadPhaseDefault::FindCollidingPairsForward(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	const dgFloat32 timestep = descriptor->m_timestep;
 
-	dgList<dgBroadPhaseNode*>::dgListNode* node = nodePtr;
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-	while (node) {
-		dgBroadPhaseNode* const broadPhaseNode = node->GetInfo();
+	dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const broadPhaseNode = updateArray[i];
 		dgAssert(broadPhaseNode->IsLeafNode());
 		dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
 
@@ -360,23 +374,19 @@ void dgBroadPhaseDefault::FindCollidingPairsForward(dgBroadphaseSyncDescriptor*
 				SubmitPairs(broadPhaseNode, sibling, timestep, 0, threadID);
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
 
-void dgBroadPhaseDefault::FindCollidingPairsForwardAndBackward(dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const nodePtr, dgInt32 threadID)
+void dgBroadPhaseDefault::FindCollidingPairsForwardAndBackward(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	const dgFloat32 timestep = descriptor->m_timestep;
 
-	dgList<dgBroadPhaseNode*>::dgListNode* node = nodePtr;
+	dgBroadPhaseNode** const updateArray = &m_updateArray[0];
 	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
 	const dgUnsigned32 lru = m_lru + 1;
-	while (node) {
-		dgBroadPhaseNode* const broadPhaseNode = node->GetInfo();
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const broadPhaseNode = updateArray[i];
 		dgAssert(broadPhaseNode->IsLeafNode());
 		dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
 
@@ -398,10 +408,6 @@ void dgBroadPhaseDefault::FindCollidingPairsForwardAndBackward(dgBroadphaseSyncD
 				}
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
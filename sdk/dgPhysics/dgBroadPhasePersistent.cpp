@@ -44,7 +44,7 @@ class dgBroadPhasePesistanceRootNode: public dgBroadPhaseTreeNode
 	{
 		if (m_right && m_left) {
 			dgVector minBox (m_right->m_minBox.GetMin(m_left->m_minBox));
-			dgVector maxBox (m_right->m_maxBox.GetMin(m_left->m_maxBox));
+			dgVector maxBox (m_right->m_maxBox.GetMax(m_left->m_maxBox));
 			SetAABB(minBox, maxBox);
 		} else if (m_right) {
 			SetAABB(m_right->m_minBox, m_right->m_maxBox);
@@ -91,6 +91,7 @@ void dgBroadPhasePersistent::CheckStaticDynamic(dgBody* const body, dgFloat32 ma
 
 void dgBroadPhasePersistent::Add(dgBody* const body)
 {
+	InvalidateQueryCaches();
 	dgAssert (!body->GetCollision()->IsType (dgCollision::dgCollisionNull_RTTI));
 	dgBroadPhasePesistanceRootNode* const root = (dgBroadPhasePesistanceRootNode*)m_rootNode;
 	dgAssert (m_rootNode->IsPersistentRoot());
@@ -126,6 +127,7 @@ dgBroadPhaseAggregate* dgBroadPhasePersistent::CreateAggregate()
 
 void dgBroadPhasePersistent::LinkAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryCaches();
 	dgAssert(m_rootNode->IsPersistentRoot());
 	dgBroadPhasePesistanceRootNode* const root = (dgBroadPhasePesistanceRootNode*)m_rootNode;
 
@@ -143,6 +145,7 @@ void dgBroadPhasePersistent::LinkAggregate(dgBroadPhaseAggregate* const aggregat
 
 void dgBroadPhasePersistent::DestroyAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryCaches();
 	m_updateList.Remove(aggregate->m_updateNode);
 	m_aggregateList.Remove(aggregate->m_myAggregateNode);
 	RemoveNode(aggregate);
@@ -289,6 +292,7 @@ void dgBroadPhasePersistent::RemoveNode(dgBroadPhaseNode* const node)
 
 void dgBroadPhasePersistent::UnlinkAggregate (dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryCaches();
 	dgBroadPhasePesistanceRootNode* const root = (dgBroadPhasePesistanceRootNode*)m_rootNode;
 	dgAssert (root && root->m_left);
 	if (aggregate->m_parent == root) {
@@ -326,6 +330,7 @@ void dgBroadPhasePersistent::UnlinkAggregate (dgBroadPhaseAggregate* const aggre
 
 void dgBroadPhasePersistent::Remove(dgBody* const body)
 {
+	InvalidateQueryCaches();
 	if (body->GetBroadPhase()) {
 		dgBroadPhaseBodyNode* const node = body->GetBroadPhase();
 		if (node->m_updateNode) {
@@ -356,6 +361,7 @@ void dgBroadPhasePersistent::InvalidateCache()
 
 void dgBroadPhasePersistent::UpdateFitness()
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	dgBroadPhasePesistanceRootNode* const root = (dgBroadPhasePesistanceRootNode*)m_rootNode;
 	if (m_staticNeedsUpdate) {
 		m_staticNeedsUpdate = false;
@@ -419,6 +425,22 @@ void dgBroadPhasePersistent::RayCast(const dgVector& l0, const dgVector& l1, OnR
 	}
 }
 
+void dgBroadPhasePersistent::RayCastPacket(dgRayCastPacket& packet) const
+{
+	dgInt32 stack = 0;
+	const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	dgBroadPhasePesistanceRootNode* const root = (dgBroadPhasePesistanceRootNode*)m_rootNode;
+	if (root->m_left) {
+		stackPool[stack] = root->m_left;
+		stack++;
+	}
+	if (root->m_right) {
+		stackPool[stack] = root->m_right;
+		stack++;
+	}
+	dgBroadPhase::RayCastPacket(stackPool, stack, packet);
+}
+
 dgInt32 dgBroadPhasePersistent::ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
@@ -460,7 +482,7 @@ dgInt32 dgBroadPhasePersistent::ConvexCast(dgCollisionInstance* const shape, con
 		}
 
 		*param = dgFloat32 (1.0f);
-		totalCount = dgBroadPhase::ConvexCast(stackPool, distance, 2, velocA, velocB, ray, shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex);
+		totalCount = dgBroadPhase::ConvexCast(stackPool, distance, stack, velocA, velocB, ray, shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex);
 	}
 	return totalCount;
 }
@@ -485,28 +507,31 @@ dgInt32 dgBroadPhasePersistent::Collide(dgCollisionInstance* const shape, const
 				overlaped[stack] = dgOverlapTest(root->m_left->m_minBox, root->m_left->m_maxBox, boxP0, boxP1);
 				stack ++;
 			}
-			if (root->m_left) {
+			if (root->m_right) {
 				stackPool[stack] = root->m_right;
 				overlaped[stack] = dgOverlapTest(root->m_right->m_minBox, root->m_right->m_maxBox, boxP0, boxP1);
 				stack++;
 			}
-			totalCount = dgBroadPhase::Collide(stackPool, overlaped, 1, boxP0, boxP1, shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
+			totalCount = dgBroadPhase::Collide(stackPool, overlaped, stack, boxP0, boxP1, shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
 		}
 	}
 
 	return totalCount;
 }
 
-void dgBroadPhasePersistent::FindCollidingPairsForward (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const nodePtr, dgInt32 threadID)
+void dgBroadPhasePersistent::FindCollidingPairsForward (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	const dgFloat32 timestep = descriptor->m_timestep;
 
-	dgList<dgBroadPhaseNode*>::dgListNode* node = nodePtr;
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-	while (node) {
-		dgBroadPhaseNode* const broadPhaseNode = node->GetInfo();
+	dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const broadPhaseNode = updateArray[i];
 		dgAssert(broadPhaseNode->IsLeafNode());
 		dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
+		if (!broadPhaseNode->IsAggregate() && !(broadPhaseNode->GetBody() && (broadPhaseNode->GetBody()->GetInvMass().m_w != dgFloat32(0.0f)))) {
+			// bodies that became static after they were added do not generate pairs from the dynamic tree
+			continue;
+		}
 
 		if (broadPhaseNode->IsAggregate()) {
 			((dgBroadPhaseAggregate*)broadPhaseNode)->SubmitSeltPairs(timestep, threadID);
@@ -520,26 +545,24 @@ void dgBroadPhasePersistent::FindCollidingPairsForward (dgBroadphaseSyncDescript
 				SubmitPairs(broadPhaseNode, sibling, timestep, 0, threadID);
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			//node = (node && node->GetInfo()->GetBody() && (node->GetInfo()->GetBody()->GetInvMass().m_w != dgFloat32(0.0f))) ? node->GetNext() : NULL;
-			dgBroadPhaseNode* const info = node ? node->GetInfo() : NULL;
-			node = (info && ((info->GetBody() && (info->GetBody()->GetInvMass().m_w != dgFloat32(0.0f))) || info->IsAggregate())) ? node->GetNext() : NULL;
-		}
 	}	
 }
 
-void dgBroadPhasePersistent::FindCollidingPairsForwardAndBackward (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const nodePtr, dgInt32 threadID)
+void dgBroadPhasePersistent::FindCollidingPairsForwardAndBackward (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	const dgFloat32 timestep = descriptor->m_timestep;
 
-	dgList<dgBroadPhaseNode*>::dgListNode* node = nodePtr;
+	dgBroadPhaseNode** const updateArray = &m_updateArray[0];
 	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
 	const dgUnsigned32 lru = m_lru + 1;
-	while (node) {
-		dgBroadPhaseNode* const broadPhaseNode = node->GetInfo();
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const broadPhaseNode = updateArray[i];
 		dgAssert(broadPhaseNode->IsLeafNode());
 		dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
+		if (!broadPhaseNode->IsAggregate() && !(broadPhaseNode->GetBody() && (broadPhaseNode->GetBody()->GetInvMass().m_w != dgFloat32(0.0f)))) {
+			// bodies that became static after they were added do not generate pairs from the dynamic tree
+			continue;
+		}
 
 		if (lru == broadPhaseNode->GetDirtyLru()) {
 			if (broadPhaseNode->IsAggregate()) {
@@ -559,11 +582,5 @@ void dgBroadPhasePersistent::FindCollidingPairsForwardAndBackward (dgBroadphaseS
 				}
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			//node = (node && node->GetInfo()->GetBody() && (node->GetInfo()->GetBody()->GetInvMass().m_w != dgFloat32(0.0f))) ? node->GetNext() : NULL;
-			dgBroadPhaseNode* const info = node ? node->GetInfo() : NULL;
-			node = (info && ((info->GetBody() && (info->GetBody()->GetInvMass().m_w != dgFloat32(0.0f))) || info->IsAggregate())) ? node->GetNext() : NULL;
-		}
 	}
 }
@@ -44,6 +44,7 @@ class dgPolygonSoupRayHitDesc;
 typedef dgInt32(dgApi *OnBodiesInAABB) (dgBody* body, void* const userData);
 typedef dgUnsigned32(dgApi *OnRayPrecastAction) (const dgBody* const body, const dgCollisionInstance* const collision, void* const userData);
 typedef dgFloat32(dgApi *OnRayCastAction) (const dgBody* const body, const dgCollisionInstance* const collision, const dgVector& contact, const dgVector& normal, dgInt64 collisionID, void* const userData, dgFloat32 intersetParam);
+typedef void (*dgCollisionHeightFieldPageInCallback) (void* const userData, dgInt32 tileX, dgInt32 tileZ, void* const elevation, dgInt8* const atributes);
 
 
 enum dgCollisionID
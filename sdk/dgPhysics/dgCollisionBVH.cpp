@@ -30,8 +30,10 @@ dgCollisionBVH::dgCollisionBVH(dgWorld* const world)
 	,m_trianglesCount(0)
 {
 	m_rtti |= dgCollisionBVH_RTTI;
+	m_world = world;
 	m_builder = NULL;
 	m_userRayCastCallback = NULL;
+	memset (m_buildTime, 0, sizeof (m_buildTime));
 }
 
 dgCollisionBVH::dgCollisionBVH (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
@@ -40,8 +42,10 @@ dgCollisionBVH::dgCollisionBVH (dgWorld* const world, dgDeserialize deserializat
 	,m_trianglesCount(0)
 {
 	dgAssert (m_rtti | dgCollisionBVH_RTTI);
+	m_world = world;
 	m_builder = NULL;;
 	m_userRayCastCallback = NULL;
+	memset (m_buildTime, 0, sizeof (m_buildTime));
 
 	dgAABBPolygonSoup::Deserialize (deserialization, userData, revisionNumber);
 
@@ -53,6 +57,28 @@ dgCollisionBVH::dgCollisionBVH (dgWorld* const world, dgDeserialize deserializat
 	deserialization(userData, &m_trianglesCount, sizeof (dgInt32));
 }
 
+// the arrays of the polygon soup point to the image, the image must outlive the collision
+dgCollisionBVH::dgCollisionBVH (dgWorld* const world, const dgMemoryImageReader& image)
+	:dgCollisionMesh (world, dgMemoryImageReader::DeserializeStream, (void*) &image, image.GetRevision())
+	,dgAABBPolygonSoup()
+	,m_trianglesCount(0)
+{
+	dgAssert (m_rtti | dgCollisionBVH_RTTI);
+	m_world = world;
+	m_builder = NULL;
+	m_userRayCastCallback = NULL;
+	memset (m_buildTime, 0, sizeof (m_buildTime));
+
+	dgAABBPolygonSoup::DeserializeImage (image);
+
+	dgVector p0; 
+	dgVector p1; 
+	GetAABB (p0, p1);
+	SetCollisionBBox(p0, p1);
+
+	dgMemoryImageReader::DeserializeStream ((void*) &image, &m_trianglesCount, sizeof (dgInt32));
+}
+
 dgCollisionBVH::~dgCollisionBVH(void)
 {
 }
@@ -64,6 +90,13 @@ void dgCollisionBVH::Serialize(dgSerialize callback, void* const userData) const
 	callback(userData, &m_trianglesCount, sizeof (dgInt32));
 }
 
+void dgCollisionBVH::SerializeImage (dgMemoryImageWriter& image) const
+{
+	SerializeLow(dgMemoryImageWriter::SerializeStream, &image);
+	dgAABBPolygonSoup::SerializeImage (image);
+	dgMemoryImageWriter::SerializeStream (&image, &m_trianglesCount, sizeof (dgInt32));
+}
+
 void dgCollisionBVH::BeginBuild()
 {
 	m_builder = new (m_allocator) dgPolygonSoupDatabaseBuilder(m_allocator);
@@ -96,9 +129,20 @@ void dgCollisionBVH::EndBuild(dgInt32 optimize)
 
 	bool state = optimize ? true : false;
 
-	m_builder->End(state);
-	Create (*m_builder, state);
-	CalculateAdjacendy();
+	// all phases of the build run on the world worker threads, unless the world is updating and the workers are busy, 
+	// in that case, which includes calls from inside a callback, the tree is built serially on the calling thread
+	dgThreadHive* const threadPool = m_world->IsUpdating() ? NULL : m_world;
+	dgUnsigned64 time0 = dgGetTimeInNanoseconds();
+	m_builder->End(state, threadPool);
+	dgUnsigned64 time1 = dgGetTimeInNanoseconds();
+	Create (*m_builder, state, threadPool);
+	dgUnsigned64 time2 = dgGetTimeInNanoseconds();
+	CalculateAdjacendy(threadPool);
+	dgUnsigned64 time3 = dgGetTimeInNanoseconds();
+
+	m_buildTime[0] = time1 - time0;
+	m_buildTime[1] = time2 - time1;
+	m_buildTime[2] = time3 - time2;
 	
 	GetAABB (p0, p1);
 	SetCollisionBBox (p0, p1);
@@ -118,6 +162,13 @@ void dgCollisionBVH::EndBuild(dgInt32 optimize)
 }
 
 
+void dgCollisionBVH::GetBuildTimes (dgFloat32* const faceMergeTime, dgFloat32* const treeBuildTime, dgFloat32* const adjacencyTime) const
+{
+	*faceMergeTime = dgFloat32 (m_buildTime[0]) * dgFloat32 (1.0e-3f);
+	*treeBuildTime = dgFloat32 (m_buildTime[1]) * dgFloat32 (1.0e-3f);
+	*adjacencyTime = dgFloat32 (m_buildTime[2]) * dgFloat32 (1.0e-3f);
+}
+
 void dgCollisionBVH::GetCollisionInfo(dgCollisionInfo* const info) const
 {
 	dgCollision::GetCollisionInfo(info);
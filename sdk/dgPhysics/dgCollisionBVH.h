@@ -51,17 +51,20 @@ class dgCollisionBVH: public dgCollisionMesh, public dgAABBPolygonSoup
 
 	dgCollisionBVH(dgWorld* const world);
 	dgCollisionBVH (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
+	dgCollisionBVH (dgWorld* const world, const dgMemoryImageReader& image);
 	virtual ~dgCollisionBVH(void);
 
 	void BeginBuild();
 	void AddFace (dgInt32 vertexCount, const dgFloat32* const vertexPtr, dgInt32 strideInBytes, dgInt32 faceAttribute);
 	void EndBuild(dgInt32 optimize);
+	void GetBuildTimes (dgFloat32* const faceMergeTime, dgFloat32* const treeBuildTime, dgFloat32* const adjacencyTime) const;
 
 	void SetCollisionRayCastCallback (dgCollisionBVHUserRayCastCallback rayCastCallback);
 	dgCollisionBVHUserRayCastCallback GetDebugRayCastCallback() const { return m_userRayCastCallback;} 
 	void GetVertexListIndexList (const dgVector& p0, const dgVector& p1, dgMeshVertexListIndexList &data) const;
 
 	void ForEachFace (dgAABBIntersectCallback callback, void* const context) const;
+	void SerializeImage (dgMemoryImageWriter& image) const;
 
 	private:
 	static dgFloat32 RayHit (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount);
@@ -85,8 +88,10 @@ class dgCollisionBVH: public dgCollisionMesh, public dgAABBPolygonSoup
 	virtual dgVector SupportVertexSpecial (const dgVector& dir, dgInt32* const vertexIndex) const;
 	virtual dgVector SupportVertexSpecialProjectPoint (const dgVector& point, const dgVector& dir) const {return point;}
 
+	dgWorld* m_world;
 	dgPolygonSoupDatabaseBuilder* m_builder;
 	dgCollisionBVHUserRayCastCallback m_userRayCastCallback;
+	dgUnsigned64 m_buildTime[3];
 
 	dgInt32 m_trianglesCount;
 	friend class dgCollisionCompound;
@@ -496,7 +496,7 @@ dgInt32 dgCollisionConvexPolygon::CalculateContactToConvexHullContinue(const dgW
 
 	dgAssert (proxy.m_instance1->GetGlobalMatrix().TestIdentity());
 
-	dgVector relativeVelocity (body0->m_veloc - body1->m_veloc);
+	dgVector relativeVelocity (body0->m_state->m_veloc - body1->m_state->m_veloc);
 	dgAssert (relativeVelocity.m_w == dgFloat32 (0.0f));
 	dgFloat32 den = m_normal.DotProduct4(relativeVelocity).GetScalar();
 	if (den > dgFloat32 (-1.0e-10f)) {
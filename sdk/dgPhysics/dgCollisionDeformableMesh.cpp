@@ -165,10 +165,10 @@ void dgCollisionDeformableMesh::IntegrateForces(dgFloat32 timestep)
 
 	dgVector invMass(dgFloat32(1.0f / m_totalMass));
 	comVeloc = comVeloc * invMass;
-	m_body->m_accel = invTimestep * (comVeloc - m_body->m_veloc);
-	m_body->m_veloc = comVeloc;
+	m_body->m_accel = invTimestep * (comVeloc - m_body->m_state->m_veloc);
+	m_body->m_state->m_veloc = comVeloc;
 	m_body->m_alpha = dgVector::m_zero;
-	m_body->m_omega = dgVector::m_zero;
+	m_body->m_state->m_omega = dgVector::m_zero;
 	m_body->m_invWorldInertiaMatrix = dgGetIdentityMatrix();
 
 	dgVector localCom(xMassSum * invMass);
@@ -72,6 +72,20 @@ dgCollisionHeightField::dgCollisionHeightField(
 	,m_horizontalDisplacementScale_z(dgFloat32(1.0f))
 	,m_userRayCastCallback(NULL)
 	,m_elevationDataType(elevationDataType)
+	,m_elevationPyramid(NULL)
+	,m_pyramidLevelsCount(0)
+	,m_tiles(NULL)
+	,m_residentTiles(world->GetAllocator())
+	,m_tileLock()
+	,m_pageInCallback(NULL)
+	,m_pageInUserData(NULL)
+	,m_tileSize(0)
+	,m_tileLevel(0)
+	,m_tilesCount_x(0)
+	,m_tilesCount_z(0)
+	,m_maxResidentTiles(0)
+	,m_tilePageSize(0)
+	,m_memoryImage(false)
 {
 	m_rtti |= dgCollisionHeightField_RTTI;
 
@@ -230,29 +244,115 @@ dgCollisionHeightField::dgCollisionHeightField(
 	}
 	memcpy (m_atributeMap, atributeMap, m_width * m_height * sizeof (dgInt8));
 
-	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
-	if (!nodeData) {
-		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
-		m_instanceData->m_refCount = 0;
-		m_instanceData->m_world = world;
-		for (dgInt32 i = 0 ; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
-			m_instanceData->m_vertex[i] = NULL;
-			m_instanceData->m_vertexCount[i] = 0;
-			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
-			AllocateVertex(world, i);
-		}
-		nodeData = world->m_perInstanceData.Insert (m_instanceData, DG_HIGHTFIELD_DATA_ID);
-	}
-	m_instanceData = (dgPerIntanceData*) nodeData->GetInfo();
+	m_mapPage.m_elevation = m_elevationMap;
+	m_mapPage.m_atributes = m_atributeMap;
+	m_mapPage.m_diagonals = m_diagonals;
+	m_mapPage.m_x0 = 0;
+	m_mapPage.m_z0 = 0;
+	m_mapPage.m_stride = m_width;
 
-	m_instanceData->m_refCount ++;
+	AttachInstanceData(world);
 
 	CalculateAABB();
+	BuildElevationPyramid();
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
+
+dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgInt32 width, dgInt32 height, dgInt32 contructionMode, 
+	dgElevationType elevationDataType, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z,
+	dgInt32 tileSize, dgInt32 maxResidentTiles, dgFloat32 minElevation, dgFloat32 maxElevation, 
+	dgCollisionHeightFieldPageInCallback pageInCallback, void* const pageInUserData)
+	:dgCollisionMesh (world, m_heightField)
+	,m_width(width)
+	,m_height(height)
+	,m_diagonalMode (dgCollisionHeightFieldGridConstruction  (dgClamp (contructionMode, dgInt32 (m_normalDiagonals), dgInt32 (m_starInvertexDiagonals))))
+	,m_atributeMap(NULL)
+	,m_diagonals(NULL)
+	,m_elevationMap(NULL)
+	,m_horizontalDisplacement(NULL)
+	,m_verticalScale(verticalScale)
+	,m_horizontalScale_x(horizontalScale_x)
+	,m_horizontalScaleInv_x (dgFloat32 (1.0f) / m_horizontalScale_x)
+	,m_horizontalDisplacementScale_x(dgFloat32 (1.0f))
+	,m_horizontalScale_z(horizontalScale_z)
+	,m_horizontalScaleInv_z(dgFloat32(1.0f) / m_horizontalScale_z)
+	,m_horizontalDisplacementScale_z(dgFloat32(1.0f))
+	,m_userRayCastCallback(NULL)
+	,m_elevationDataType(elevationDataType)
+	,m_elevationPyramid(NULL)
+	,m_pyramidLevelsCount(0)
+	,m_tiles(NULL)
+	,m_residentTiles(world->GetAllocator())
+	,m_tileLock()
+	,m_pageInCallback(pageInCallback)
+	,m_pageInUserData(pageInUserData)
+	,m_tileSize(DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE)
+	,m_tileLevel(0)
+	,m_tilesCount_x(0)
+	,m_tilesCount_z(0)
+	,m_maxResidentTiles(dgMax (maxResidentTiles, 1))
+	,m_tilePageSize(0)
+	,m_memoryImage(false)
+{
+	m_rtti |= dgCollisionHeightField_RTTI;
+
+	// the tile size must be a power of two multiple of the pyramid block size, so that the pyramid blocks below the tile level do not cross tiles 
+	dgAssert (m_pageInCallback);
+	dgAssert ((tileSize >= DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE) && !(tileSize & (tileSize - 1)));
+	while (m_tileSize < tileSize) {
+		m_tileSize *= 2;
+		m_tileLevel ++;
+	}
+	m_tilesCount_x = dgMax ((m_width - 1 + m_tileSize - 1) / m_tileSize, 1);
+	m_tilesCount_z = dgMax ((m_height - 1 + m_tileSize - 1) / m_tileSize, 1);
+
+	m_tiles = (dgHeightFieldTileSlot*) dgMallocStack(m_tilesCount_x * m_tilesCount_z * sizeof (dgHeightFieldTileSlot));
+	memset (m_tiles, 0, m_tilesCount_x * m_tilesCount_z * sizeof (dgHeightFieldTileSlot));
+	for (dgInt32 i = 0; i < m_tilesCount_x * m_tilesCount_z; i ++) {
+		m_tiles[i].m_pinCount = DG_HEIGHTFIELD_TILE_EMPTY;
+	}
+
+	dgInt32 tilePyramidCount = 0;
+	for (dgInt32 i = 0; i < m_tileLevel; i ++) {
+		const dgInt32 levelWidth = (m_tileSize / DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE) >> i;
+		m_tilePyramidOffset[i] = tilePyramidCount;
+		tilePyramidCount += levelWidth * levelWidth;
+	}
+
+	const dgInt32 vertexCount = (m_tileSize + 1) * (m_tileSize + 1);
+	const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	m_tilePageSize = (sizeof (dgHeightFieldTile) + 15) & -16;
+	m_tilePageSize += (vertexCount * elementSize + 15) & -16;
+	m_tilePageSize += 2 * ((vertexCount + 15) & -16);
+	m_tilePageSize += tilePyramidCount * sizeof (dgElevationRange);
+
+	memset (&m_mapPage, 0, sizeof (m_mapPage));
+
+	AttachInstanceData(world);
+
+	const dgFloat32 y0 = dgMin (minElevation * m_verticalScale, maxElevation * m_verticalScale);
+	const dgFloat32 y1 = dgMax (minElevation * m_verticalScale, maxElevation * m_verticalScale);
+	m_minBox = dgVector (dgFloat32 (0.0f), y0, dgFloat32 (0.0f), dgFloat32 (0.0f)); 
+	m_maxBox = dgVector (dgFloat32 (m_width - 1) * m_horizontalScale_x, y1, dgFloat32 (m_height - 1) * m_horizontalScale_z, dgFloat32 (0.0f)); 
+
+	BuildElevationPyramid();
 	SetCollisionBBox(m_minBox, m_maxBox);
 }
 
 dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollisionMesh (world, deserialization, userData, revisionNumber)
+	,m_tiles(NULL)
+	,m_residentTiles(world->GetAllocator())
+	,m_tileLock()
+	,m_pageInCallback(NULL)
+	,m_pageInUserData(NULL)
+	,m_tileSize(0)
+	,m_tileLevel(0)
+	,m_tilesCount_x(0)
+	,m_tilesCount_z(0)
+	,m_maxResidentTiles(0)
+	,m_tilePageSize(0)
+	,m_memoryImage(false)
 {
 	dgAssert (m_rtti | dgCollisionHeightField_RTTI);
 	
@@ -260,6 +360,8 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 
 	m_userRayCastCallback = NULL;
 	m_horizontalDisplacement = NULL;
+	m_elevationPyramid = NULL;
+	m_pyramidLevelsCount = 0;
 	deserialization (userData, &m_width, sizeof (dgInt32));
 	deserialization (userData, &m_height, sizeof (dgInt32));
 	deserialization (userData, &m_diagonalMode, sizeof (dgInt32));
@@ -307,22 +409,103 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 	m_horizontalScaleInv_x = dgFloat32 (1.0f) / m_horizontalScale_x;
 	m_horizontalScaleInv_z = dgFloat32 (1.0f) / m_horizontalScale_z;
 
-	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
-	if (!nodeData) {
-		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
-		m_instanceData->m_refCount = 0;
-		m_instanceData->m_world = world;
-		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i++) {
-			m_instanceData->m_vertex[i] = NULL;
-			m_instanceData->m_vertexCount[i] = 0;
-			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
-			AllocateVertex(world, i);
-		}
-		nodeData = world->m_perInstanceData.Insert(m_instanceData, DG_HIGHTFIELD_DATA_ID);
+	m_mapPage.m_elevation = m_elevationMap;
+	m_mapPage.m_atributes = m_atributeMap;
+	m_mapPage.m_diagonals = m_diagonals;
+	m_mapPage.m_x0 = 0;
+	m_mapPage.m_z0 = 0;
+	m_mapPage.m_stride = m_width;
+
+	AttachInstanceData(world);
+	BuildElevationPyramid();
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
+
+dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, const dgMemoryImageReader& image)
+	:dgCollisionMesh (world, dgMemoryImageReader::DeserializeStream, (void*) &image, image.GetRevision())
+	,m_atributeMap(NULL)
+	,m_diagonals(NULL)
+	,m_elevationMap(NULL)
+	,m_horizontalDisplacement(NULL)
+	,m_userRayCastCallback(NULL)
+	,m_elevationPyramid(NULL)
+	,m_pyramidLevelsCount(0)
+	,m_tiles(NULL)
+	,m_residentTiles(world->GetAllocator())
+	,m_tileLock()
+	,m_pageInCallback(NULL)
+	,m_pageInUserData(NULL)
+	,m_tileSize(0)
+	,m_tileLevel(0)
+	,m_tilesCount_x(0)
+	,m_tilesCount_z(0)
+	,m_maxResidentTiles(0)
+	,m_tilePageSize(0)
+	,m_memoryImage(true)
+{
+	dgAssert (m_rtti | dgCollisionHeightField_RTTI);
+
+	dgInt32 elevationDataType;
+	dgInt32 hasDisplacement;
+	void* const reader = (void*) &image;
+	dgMemoryImageReader::DeserializeStream (reader, &m_width, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_height, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_diagonalMode, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream (reader, &elevationDataType, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_verticalScale, sizeof (dgFloat32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_horizontalScale_x, sizeof (dgFloat32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_horizontalDisplacementScale_x, sizeof (dgFloat32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_horizontalScale_z, sizeof (dgFloat32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_horizontalDisplacementScale_z, sizeof (dgFloat32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_minBox.m_x, sizeof (dgVector)); 
+	dgMemoryImageReader::DeserializeStream (reader, &m_maxBox.m_x, sizeof (dgVector)); 
+	dgMemoryImageReader::DeserializeStream (reader, &hasDisplacement, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream (reader, &m_pyramidLevelsCount, sizeof (dgInt32));
+	dgMemoryImageReader::DeserializeStream (reader, m_pyramidLevelOffset, sizeof (m_pyramidLevelOffset));
+	dgMemoryImageReader::DeserializeStream (reader, m_pyramidLevelWidth, sizeof (m_pyramidLevelWidth));
+	dgMemoryImageReader::DeserializeStream (reader, m_pyramidLevelHeight, sizeof (m_pyramidLevelHeight));
+	m_elevationDataType = dgElevationType (elevationDataType);
+
+	if ((m_pyramidLevelsCount < 0) || (m_pyramidLevelsCount > DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS)) {
+		m_pyramidLevelsCount = 0;
+		image.SetInvalid();
 	}
-	m_instanceData = (dgPerIntanceData*)nodeData->GetInfo();
 
-	m_instanceData->m_refCount ++;
+	const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	const dgInt32 attibutePaddedMapSize = (m_width * m_height + 4) & -4; 
+	const dgInt32 pyramidCount = m_pyramidLevelsCount ? m_pyramidLevelOffset[m_pyramidLevelsCount - 1] + m_pyramidLevelWidth[m_pyramidLevelsCount - 1] * m_pyramidLevelHeight[m_pyramidLevelsCount - 1] : 0;
+	m_elevationMap = (void*) image.ReadSection (m_width * m_height * elementSize);
+	m_atributeMap = (dgInt8*) image.ReadSection (attibutePaddedMapSize * sizeof (dgInt8));
+	m_diagonals = (dgInt8*) image.ReadSection (attibutePaddedMapSize * sizeof (dgInt8));
+	if (pyramidCount) {
+		m_elevationPyramid = (dgElevationRange*) image.ReadSection (pyramidCount * sizeof (dgElevationRange));
+	}
+	if (hasDisplacement) {
+		m_horizontalDisplacement = (dgUnsigned16*) image.ReadSection (m_width * m_height * sizeof (dgUnsigned16));
+	}
+
+	if (!image.IsValid()) {
+		// the caller destroys the collision, this only leaves it in a state that is safe to destroy
+		m_width = 0;
+		m_height = 0;
+		m_pyramidLevelsCount = 0;
+		m_elevationPyramid = NULL;
+		m_horizontalDisplacement = NULL;
+		m_horizontalScale_x = dgFloat32 (1.0f);
+		m_horizontalScale_z = dgFloat32 (1.0f);
+	}
+
+	m_horizontalScaleInv_x = dgFloat32 (1.0f) / m_horizontalScale_x;
+	m_horizontalScaleInv_z = dgFloat32 (1.0f) / m_horizontalScale_z;
+
+	m_mapPage.m_elevation = m_elevationMap;
+	m_mapPage.m_atributes = m_atributeMap;
+	m_mapPage.m_diagonals = m_diagonals;
+	m_mapPage.m_x0 = 0;
+	m_mapPage.m_z0 = 0;
+	m_mapPage.m_stride = m_width;
+
+	AttachInstanceData(world);
 	SetCollisionBBox(m_minBox, m_maxBox);
 }
 
@@ -331,18 +514,75 @@ dgCollisionHeightField::~dgCollisionHeightField(void)
 	m_instanceData->m_refCount --;
 	if (!m_instanceData->m_refCount) {
 		dgWorld* const world = m_instanceData->m_world;
+		delete[] m_instanceData->m_threadData;
 		delete m_instanceData;
 		world->m_perInstanceData.Remove(DG_HIGHTFIELD_DATA_ID);
 	}
-	dgFreeStack(m_elevationMap);
-	dgFreeStack(m_atributeMap);
-	dgFreeStack(m_diagonals);
 
-	if (m_horizontalDisplacement) {
+	if (m_tiles) {
+		while (m_residentTiles.GetCount()) {
+			dgHeightFieldTile* const tile = m_residentTiles.GetFirst()->GetInfo();
+			dgHeightFieldTileSlot* const slot = &m_tiles[tile->m_z * m_tilesCount_x + tile->m_x];
+			dgAssert (!slot->m_pinCount);
+			slot->m_pinCount = DG_HEIGHTFIELD_TILE_EMPTY;
+			ReleaseTile (tile);
+		}
+		dgFreeStack(m_tiles);
+	} else if (!m_memoryImage) {
+		dgFreeStack(m_elevationMap);
+		dgFreeStack(m_atributeMap);
+		dgFreeStack(m_diagonals);
+	}
+	if (m_elevationPyramid && !m_memoryImage) {
+		dgFreeStack(m_elevationPyramid);
+	}
+
+	if (m_horizontalDisplacement && !m_memoryImage) {
 		dgFreeStack(m_horizontalDisplacement);
 	}
 }
 
+void dgCollisionHeightField::AttachInstanceData(dgWorld* const world)
+{
+	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
+	if (!nodeData) {
+		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
+		m_instanceData->m_refCount = 0;
+		m_instanceData->m_world = world;
+		m_instanceData->m_threadData = NULL;
+		m_instanceData->m_threadCount = 0;
+		m_instanceData->SetThreadsCount(world->GetThreadCount());
+		nodeData = world->m_perInstanceData.Insert (m_instanceData, DG_HIGHTFIELD_DATA_ID);
+	}
+	m_instanceData = (dgPerIntanceData*) nodeData->GetInfo();
+
+	m_instanceData->m_refCount ++;
+}
+
+void dgCollisionHeightField::dgPerIntanceData::SetThreadsCount (dgInt32 count)
+{
+	if (m_threadData) {
+		delete[] m_threadData;
+	}
+	m_threadCount = count;
+	m_threadData = new (m_world->GetAllocator()) dgPerThreadData[count];
+	for (dgInt32 i = 0; i < count; i ++) {
+		m_threadData[i].m_vertexCount = 0;
+		m_threadData[i].m_vertex.SetAllocator(m_world->GetAllocator());
+		m_threadData[i].m_tileGather.SetAllocator(m_world->GetAllocator());
+	}
+}
+
+// called by the world when the worker count changes, the height fields of a world share one vertex buffer per worker
+void dgCollisionHeightField::SetThreadsCount (dgWorld* const world, dgInt32 count)
+{
+	dgTree<void*, unsigned>::dgTreeNode* const nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
+	if (nodeData) {
+		dgPerIntanceData* const instanceData = (dgPerIntanceData*) nodeData->GetInfo();
+		instanceData->SetThreadsCount(count);
+	}
+}
+
 void dgCollisionHeightField::Serialize(dgSerialize callback, void* const userData) const
 {
 	SerializeLow(callback, userData);
@@ -361,23 +601,41 @@ void dgCollisionHeightField::Serialize(dgSerialize callback, void* const userDat
 	callback (userData, &m_minBox.m_x, sizeof (dgVector)); 
 	callback (userData, &m_maxBox.m_x, sizeof (dgVector)); 
 
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
+	dgInt32 attibutePaddedMapSize = (m_width * m_height + 4) & -4; 
+	if (!m_tiles) {
+		switch (m_elevationDataType) 
 		{
-			callback (userData, m_elevationMap, m_width * m_height * sizeof (dgFloat32));
-			break;
+			case m_float32Bit:
+			{
+				callback (userData, m_elevationMap, m_width * m_height * sizeof (dgFloat32));
+				break;
+			}
+			case m_unsigned16Bit:
+			{
+				callback (userData, m_elevationMap, m_width * m_height * sizeof (dgUnsigned16));
+				break;
+			}
 		}
-		case m_unsigned16Bit:
-		{
-			callback (userData, m_elevationMap, m_width * m_height * sizeof (dgUnsigned16));
-			break;
+
+		callback (userData, m_atributeMap, attibutePaddedMapSize * sizeof (dgInt8));
+		callback (userData, m_diagonals, attibutePaddedMapSize * sizeof (dgInt8));
+	} else {
+		// a tiled height field is saved as a flat height field, the maps are written one row of tiles at a time 
+		const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+		dgInt8* const band = (dgInt8*) dgMallocStack(m_tileSize * m_width * elementSize);
+		for (dgInt32 pass = 0; pass < 3; pass ++) {
+			for (dgInt32 z0 = 0; z0 < m_height; z0 += m_tileSize) {
+				const dgInt32 z1 = dgMin (z0 + m_tileSize - 1, m_height - 1);
+				GatherTiles (0, m_width - 1, z0, z1, (pass == 0) ? band : NULL, (pass == 1) ? band : NULL, (pass == 2) ? band : NULL);
+				callback (userData, band, (z1 - z0 + 1) * m_width * ((pass == 0) ? elementSize : sizeof (dgInt8)));
+			}
+			if (pass) {
+				dgInt8 padding[4] = {0, 0, 0, 0};
+				callback (userData, padding, attibutePaddedMapSize - m_width * m_height);
+			}
 		}
+		dgFreeStack(band);
 	}
-
-	dgInt32 attibutePaddedMapSize = (m_width * m_height + 4) & -4; 
-	callback (userData, m_atributeMap, attibutePaddedMapSize * sizeof (dgInt8));
-	callback (userData, m_diagonals, attibutePaddedMapSize * sizeof (dgInt8));
 	
 	dgInt32 hasDisplacement = m_horizontalDisplacement ? 1 : 0;
 	callback (userData, &hasDisplacement, sizeof (hasDisplacement));
@@ -386,6 +644,49 @@ void dgCollisionHeightField::Serialize(dgSerialize callback, void* const userDat
 	}
 }
 
+bool dgCollisionHeightField::SerializeImage (dgMemoryImageWriter& image) const
+{
+	// tiled height fields are already streamed from the application data, they have no image
+	if (m_tiles) {
+		return false;
+	}
+
+	SerializeLow(dgMemoryImageWriter::SerializeStream, &image);
+
+	dgInt32 elevationDataType = m_elevationDataType;
+	dgInt32 hasDisplacement = m_horizontalDisplacement ? 1 : 0;
+	dgMemoryImageWriter::SerializeStream (&image, &m_width, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_height, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_diagonalMode, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &elevationDataType, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_verticalScale, sizeof (dgFloat32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_horizontalScale_x, sizeof (dgFloat32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_horizontalDisplacementScale_x, sizeof (dgFloat32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_horizontalScale_z, sizeof (dgFloat32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_horizontalDisplacementScale_z, sizeof (dgFloat32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_minBox.m_x, sizeof (dgVector)); 
+	dgMemoryImageWriter::SerializeStream (&image, &m_maxBox.m_x, sizeof (dgVector)); 
+	dgMemoryImageWriter::SerializeStream (&image, &hasDisplacement, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, &m_pyramidLevelsCount, sizeof (dgInt32));
+	dgMemoryImageWriter::SerializeStream (&image, m_pyramidLevelOffset, sizeof (m_pyramidLevelOffset));
+	dgMemoryImageWriter::SerializeStream (&image, m_pyramidLevelWidth, sizeof (m_pyramidLevelWidth));
+	dgMemoryImageWriter::SerializeStream (&image, m_pyramidLevelHeight, sizeof (m_pyramidLevelHeight));
+
+	const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	const dgInt32 attibutePaddedMapSize = (m_width * m_height + 4) & -4; 
+	const dgInt32 pyramidCount = m_pyramidLevelsCount ? m_pyramidLevelOffset[m_pyramidLevelsCount - 1] + m_pyramidLevelWidth[m_pyramidLevelsCount - 1] * m_pyramidLevelHeight[m_pyramidLevelsCount - 1] : 0;
+	image.AddSection (m_elevationMap, m_width * m_height * elementSize);
+	image.AddSection (m_atributeMap, attibutePaddedMapSize * sizeof (dgInt8));
+	image.AddSection (m_diagonals, attibutePaddedMapSize * sizeof (dgInt8));
+	if (pyramidCount) {
+		image.AddSection (m_elevationPyramid, pyramidCount * sizeof (dgElevationRange));
+	}
+	if (hasDisplacement) {
+		image.AddSection (m_horizontalDisplacement, m_width * m_height * sizeof (dgUnsigned16));
+	}
+	return true;
+}
+
 void dgCollisionHeightField::SetCollisionRayCastCallback (dgCollisionHeightFieldRayCastCallback rayCastCallback)
 {
 	m_userRayCastCallback = rayCastCallback;
@@ -393,6 +694,14 @@ void dgCollisionHeightField::SetCollisionRayCastCallback (dgCollisionHeightField
 
 void dgCollisionHeightField::SetHorizontalDisplacement (const dgUnsigned16* const displacemnet, dgFloat32 scale)
 {
+	// horizontal displacement is a map of the whole grid, it is not supported by tiled height fields, 
+	// and it can not be changed on height fields that are loaded from a memory image
+	dgAssert (!m_tiles);
+	dgAssert (!m_memoryImage);
+	if (m_tiles || m_memoryImage) {
+		return;
+	}
+
 	if (m_horizontalDisplacement) {
 		dgFreeStack(m_horizontalDisplacement);
 		m_horizontalDisplacement = NULL;
@@ -407,8 +716,10 @@ void dgCollisionHeightField::SetHorizontalDisplacement (const dgUnsigned16* cons
 
 void dgCollisionHeightField::AllocateVertex(dgWorld* const world, dgInt32 threadIndex) const
 {
-	m_instanceData->m_vertex[threadIndex].Resize (m_instanceData->m_vertex[threadIndex].GetElementsCapacity() * 2);
-	m_instanceData->m_vertexCount[threadIndex] = m_instanceData->m_vertex[threadIndex].GetElementsCapacity();
+	dgAssert (threadIndex < m_instanceData->m_threadCount);
+	dgPerThreadData& threadData = m_instanceData->m_threadData[threadIndex];
+	threadData.m_vertex.Resize (threadData.m_vertex.GetElementsCapacity() * 2);
+	threadData.m_vertexCount = threadData.m_vertex.GetElementsCapacity();
 }
 
 
@@ -493,6 +804,362 @@ void dgCollisionHeightField::CalculateAABB()
 	m_maxBox = dgVector (dgFloat32 (m_width - 1) * m_horizontalScale_x, y1 * m_verticalScale, dgFloat32 (m_height-1) * m_horizontalScale_z, dgFloat32 (0.0f)); 
 }
 
+void dgCollisionHeightField::BuildElevationPyramid()
+{
+	m_pyramidLevelsCount = 0;
+	if ((m_width < 2) || (m_height < 2)) {
+		return;
+	}
+
+	dgInt32 count = 0;
+	dgInt32 width = (m_width - 1 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE - 1) / DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+	dgInt32 height = (m_height - 1 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE - 1) / DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+	do {
+		dgAssert (m_pyramidLevelsCount < DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS);
+		m_pyramidLevelOffset[m_pyramidLevelsCount] = count;
+		m_pyramidLevelWidth[m_pyramidLevelsCount] = width;
+		m_pyramidLevelHeight[m_pyramidLevelsCount] = height;
+		if (m_pyramidLevelsCount >= m_tileLevel) {
+			count += width * height;
+		}
+		m_pyramidLevelsCount ++;
+		if ((width == 1) && (height == 1) && (m_pyramidLevelsCount > m_tileLevel)) {
+			break;
+		}
+		width = (width + 1) >> 1;
+		height = (height + 1) >> 1;
+	} while (1);
+
+	m_elevationPyramid = (dgElevationRange*) dgMallocStack(count * sizeof (dgElevationRange));
+
+	if (!m_tiles) {
+		dgElevationRange* const level0 = m_elevationPyramid;
+		for (dgInt32 z = 0; z < m_pyramidLevelHeight[0]; z ++) {
+			const dgInt32 z0 = z * DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+			const dgInt32 z1 = dgMin (z0 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE, m_height - 1);
+			for (dgInt32 x = 0; x < m_pyramidLevelWidth[0]; x ++) {
+				const dgInt32 x0 = x * DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+				const dgInt32 x1 = dgMin (x0 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE, m_width - 1);
+				level0[z * m_pyramidLevelWidth[0] + x] = CalculateScaledElevationRange(m_mapPage, x0, x1, z0, z1);
+			}
+		}
+	} else {
+		// no tile is in memory yet, the tile level starts with the range of the whole grid and it is narrowed as the tiles are paged in.
+		dgElevationRange range;
+		range.m_min = m_minBox.m_y;
+		range.m_max = m_maxBox.m_y;
+		dgElevationRange* const tileLevel = &m_elevationPyramid[m_pyramidLevelOffset[m_tileLevel]];
+		for (dgInt32 i = 0; i < m_pyramidLevelWidth[m_tileLevel] * m_pyramidLevelHeight[m_tileLevel]; i ++) {
+			tileLevel[i] = range;
+		}
+	}
+
+	for (dgInt32 i = m_tileLevel + 1; i < m_pyramidLevelsCount; i ++) {
+		const dgInt32 childWidth = m_pyramidLevelWidth[i - 1];
+		const dgInt32 childHeight = m_pyramidLevelHeight[i - 1];
+		const dgElevationRange* const children = &m_elevationPyramid[m_pyramidLevelOffset[i - 1]];
+		dgElevationRange* const parents = &m_elevationPyramid[m_pyramidLevelOffset[i]];
+		for (dgInt32 z = 0; z < m_pyramidLevelHeight[i]; z ++) {
+			for (dgInt32 x = 0; x < m_pyramidLevelWidth[i]; x ++) {
+				dgElevationRange range;
+				range.m_min = dgFloat32 (1.0e10f);
+				range.m_max = dgFloat32 (-1.0e10f);
+				for (dgInt32 cz = 2 * z; cz < dgMin (2 * z + 2, childHeight); cz ++) {
+					for (dgInt32 cx = 2 * x; cx < dgMin (2 * x + 2, childWidth); cx ++) {
+						const dgElevationRange& child = children[cz * childWidth + cx];
+						range.m_min = dgMin (range.m_min, child.m_min);
+						range.m_max = dgMax (range.m_max, child.m_max);
+					}
+				}
+				parents[z * m_pyramidLevelWidth[i] + x] = range;
+			}
+		}
+	}
+}
+
+DG_INLINE const dgCollisionHeightField::dgElevationRange& dgCollisionHeightField::GetElevationRange(dgInt32 level, dgInt32 x, dgInt32 z, const dgHeightFieldTile* const tile) const
+{
+	if (level >= m_tileLevel) {
+		return m_elevationPyramid[m_pyramidLevelOffset[level] + z * m_pyramidLevelWidth[level] + x];
+	}
+	const dgInt32 shift = m_tileLevel - level;
+	const dgInt32 mask = (1 << shift) - 1;
+	dgAssert (tile && (tile->m_x == (x >> shift)) && (tile->m_z == (z >> shift)));
+	return tile->m_pyramid[m_tilePyramidOffset[level] + (z & mask) * (mask + 1) + (x & mask)];
+}
+
+dgInt8 dgCollisionHeightField::GetDiagonal(dgInt32 x, dgInt32 z) const
+{
+	switch (m_diagonalMode)
+	{
+		case m_invertedDiagonals:
+			return 1;
+		case m_alternateOddRowsDiagonals:
+			return dgInt8 (z & 1);
+		case m_alternateEvenRowsDiagonals:
+			return dgInt8 ((z & 1) ^ 1);
+		case m_alternateOddColumsDiagonals:
+			return dgInt8 (x & 1);
+		case m_alternateEvenColumsDiagonals:
+			return dgInt8 ((x & 1) ^ 1);
+		case m_starDiagonals:
+			return dgInt8 ((x ^ z) & 1);
+		case m_starInvertexDiagonals:
+			return dgInt8 (((x ^ z) & 1) ^ 1);
+		case m_normalDiagonals:
+		default:
+			return 0;
+	}
+}
+
+DG_INLINE dgInt32 dgCollisionHeightField::GetTileIndex(dgInt32 vertexIndex, dgInt32 tilesCount) const
+{
+	return dgMin (vertexIndex / m_tileSize, tilesCount - 1);
+}
+
+// return the tile with its pin count incremented, so that it is not released while the caller reads it.
+// if the tile is not in memory it is paged in, or NULL is returned when pageIn is false.
+dgCollisionHeightField::dgHeightFieldTile* dgCollisionHeightField::PinTile(dgInt32 x, dgInt32 z, bool pageIn) const
+{
+	dgHeightFieldTileSlot* const slot = &m_tiles[z * m_tilesCount_x + x];
+	dgInt32 pinCount = slot->m_pinCount;
+	while (pinCount != DG_HEIGHTFIELD_TILE_EMPTY) {
+		const dgInt32 oldPinCount = dgInterlockedCompareExchange (&slot->m_pinCount, pinCount + 1, pinCount);
+		if (oldPinCount == pinCount) {
+			if (!slot->m_referenced) {
+				slot->m_referenced = 1;
+			}
+			if (slot->m_loading && !pageIn) {
+				UnpinTile (slot->m_tile);
+				return NULL;
+			}
+			return WaitForTile (slot);
+		}
+		pinCount = oldPinCount;
+	}
+	return pageIn ? PageInTile (x, z) : NULL;
+}
+
+void dgCollisionHeightField::UnpinTile(dgHeightFieldTile* const tile) const
+{
+	dgHeightFieldTileSlot* const slot = &m_tiles[tile->m_z * m_tilesCount_x + tile->m_x];
+	dgAssert (slot->m_pinCount > 0);
+	dgAtomicExchangeAndAdd (&slot->m_pinCount, -1);
+}
+
+// the slot is pinned by the caller, only the threads that need a tile that is being paged in wait for it
+dgCollisionHeightField::dgHeightFieldTile* dgCollisionHeightField::WaitForTile(dgHeightFieldTileSlot* const slot) const
+{
+	dgAssert (slot->m_pinCount > 0);
+	while (dgAtomicExchangeAndAdd (&slot->m_loading, 0)) {
+		dgThreadYield();
+	}
+	return slot->m_tile;
+}
+
+// the slot pin count must be DG_HEIGHTFIELD_TILE_EMPTY, so that no query can pin the tile
+void dgCollisionHeightField::ReleaseTile(dgHeightFieldTile* const tile) const
+{
+	dgHeightFieldTileSlot* const slot = &m_tiles[tile->m_z * m_tilesCount_x + tile->m_x];
+	dgAssert (slot->m_pinCount == DG_HEIGHTFIELD_TILE_EMPTY);
+	slot->m_tile = NULL;
+	m_residentTiles.Remove (tile->m_lruNode);
+	dgFreeStack(tile);
+}
+
+// called with the tile lock held, make room for one more tile in the budget.
+// the resident tiles are visited in clock order, a tile that was pinned since the last visit is moved to the end of the list, 
+// and a tile that was not is released if no query has it pinned.
+void dgCollisionHeightField::ReleaseTiles() const
+{
+	dgInt32 visits = 2 * m_residentTiles.GetCount();
+	for (dgList<dgHeightFieldTile*>::dgListNode* node = m_residentTiles.GetFirst(); node && visits && (m_residentTiles.GetCount() >= m_maxResidentTiles); visits --) {
+		dgHeightFieldTile* const tile = node->GetInfo();
+		dgHeightFieldTileSlot* const slot = &m_tiles[tile->m_z * m_tilesCount_x + tile->m_x];
+		dgList<dgHeightFieldTile*>::dgListNode* const nextNode = node->GetNext() ? node->GetNext() : m_residentTiles.GetFirst();
+		if (slot->m_referenced) {
+			slot->m_referenced = 0;
+			m_residentTiles.RotateToEnd (node);
+		} else if (!dgInterlockedCompareExchange (&slot->m_pinCount, DG_HEIGHTFIELD_TILE_EMPTY, 0)) {
+			ReleaseTile (tile);
+		}
+		node = (nextNode != node) ? nextNode : NULL;
+	}
+}
+
+// return the tile pinned, the lock is only held to reserve the tile in its slot and to update the shared pyramid levels, 
+// the page in callback runs outside of the lock so that queries on other tiles are not blocked by it.
+dgCollisionHeightField::dgHeightFieldTile* dgCollisionHeightField::PageInTile(dgInt32 x, dgInt32 z) const
+{
+	dgHeightFieldTileSlot* const slot = &m_tiles[z * m_tilesCount_x + x];
+	dgHeightFieldTile* tile = NULL;
+	{
+		dgThreadHiveScopeLock lock (m_instanceData->m_world, &m_tileLock, true);
+		if (slot->m_pinCount != DG_HEIGHTFIELD_TILE_EMPTY) {
+			// another thread paged in the tile while this one was waiting for the lock, tiles are only released while holding the lock 
+			dgAtomicExchangeAndAdd (&slot->m_pinCount, 1);
+			slot->m_referenced = 1;
+		} else {
+			ReleaseTiles();
+			tile = (dgHeightFieldTile*) dgMallocStack(m_tilePageSize);
+			tile->m_x = x;
+			tile->m_z = z;
+			tile->m_lruNode = m_residentTiles.Append (tile);
+			slot->m_tile = tile;
+			slot->m_loading = 1;
+			slot->m_referenced = 1;
+			dgInterlockedExchange (&slot->m_pinCount, 1);
+		}
+	}
+
+	if (!tile) {
+		return WaitForTile (slot);
+	}
+
+	LoadTile (tile);
+	dgInterlockedExchange (&slot->m_loading, 0);
+	return tile;
+}
+
+void dgCollisionHeightField::LoadTile(dgHeightFieldTile* const tile) const
+{
+	const dgInt32 x = tile->m_x;
+	const dgInt32 z = tile->m_z;
+	const dgInt32 stride = m_tileSize + 1;
+	const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	const dgInt32 elevationOffset = (sizeof (dgHeightFieldTile) + 15) & -16;
+	const dgInt32 atributesOffset = elevationOffset + ((stride * stride * elementSize + 15) & -16);
+	const dgInt32 diagonalsOffset = atributesOffset + ((stride * stride + 15) & -16);
+	const dgInt32 pyramidOffset = diagonalsOffset + ((stride * stride + 15) & -16);
+
+	dgInt8* const memory = (dgInt8*) tile;
+	dgInt8* const atributes = &memory[atributesOffset];
+	dgInt8* const diagonals = &memory[diagonalsOffset];
+	m_pageInCallback (m_pageInUserData, x, z, &memory[elevationOffset], atributes);
+
+	const dgInt32 x0 = x * m_tileSize;
+	const dgInt32 z0 = z * m_tileSize;
+	const dgInt32 x1 = dgMin (x0 + m_tileSize, m_width - 1);
+	const dgInt32 z1 = dgMin (z0 + m_tileSize, m_height - 1);
+	for (dgInt32 j = 0; j < stride; j ++) {
+		for (dgInt32 i = 0; i < stride; i ++) {
+			diagonals[j * stride + i] = GetDiagonal (x0 + i, z0 + j);
+		}
+	}
+
+	tile->m_page.m_elevation = &memory[elevationOffset];
+	tile->m_page.m_atributes = atributes;
+	tile->m_page.m_diagonals = diagonals;
+	tile->m_page.m_x0 = x0;
+	tile->m_page.m_z0 = z0;
+	tile->m_page.m_stride = stride;
+	tile->m_pyramid = (dgElevationRange*) &memory[pyramidOffset];
+
+	// build the pyramid levels below the tile level, blocks past the edge of the grid are left empty
+	dgElevationRange tileRange;
+	tileRange.m_min = dgFloat32 (1.0e10f);
+	tileRange.m_max = dgFloat32 (-1.0e10f);
+	if (!m_tileLevel) {
+		tileRange = CalculateScaledElevationRange(tile->m_page, x0, x1, z0, z1);
+	} else {
+		const dgInt32 blocksCount = m_tileSize / DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+		for (dgInt32 j = 0; j < blocksCount; j ++) {
+			const dgInt32 bz0 = z0 + j * DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+			const dgInt32 bz1 = dgMin (bz0 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE, z1);
+			for (dgInt32 i = 0; i < blocksCount; i ++) {
+				const dgInt32 bx0 = x0 + i * DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+				const dgInt32 bx1 = dgMin (bx0 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE, x1);
+				dgElevationRange& range = tile->m_pyramid[j * blocksCount + i];
+				if ((bx0 < x1) && (bz0 < z1)) {
+					range = CalculateScaledElevationRange(tile->m_page, bx0, bx1, bz0, bz1);
+				} else {
+					range.m_min = dgFloat32 (1.0e10f);
+					range.m_max = dgFloat32 (-1.0e10f);
+				}
+			}
+		}
+
+		for (dgInt32 level = 1; level <= m_tileLevel; level ++) {
+			const dgInt32 childWidth = blocksCount >> (level - 1);
+			const dgElevationRange* const children = &tile->m_pyramid[m_tilePyramidOffset[level - 1]];
+			for (dgInt32 j = 0; j < (childWidth >> 1); j ++) {
+				for (dgInt32 i = 0; i < (childWidth >> 1); i ++) {
+					dgElevationRange range;
+					range.m_min = dgMin (dgMin (children[2 * j * childWidth + 2 * i].m_min, children[2 * j * childWidth + 2 * i + 1].m_min), 
+										 dgMin (children[(2 * j + 1) * childWidth + 2 * i].m_min, children[(2 * j + 1) * childWidth + 2 * i + 1].m_min));
+					range.m_max = dgMax (dgMax (children[2 * j * childWidth + 2 * i].m_max, children[2 * j * childWidth + 2 * i + 1].m_max), 
+										 dgMax (children[(2 * j + 1) * childWidth + 2 * i].m_max, children[(2 * j + 1) * childWidth + 2 * i + 1].m_max));
+					if (level < m_tileLevel) {
+						tile->m_pyramid[m_tilePyramidOffset[level] + j * (childWidth >> 1) + i] = range;
+					} else {
+						tileRange = range;
+					}
+				}
+			}
+		}
+	}
+
+	// the elevation of a tile does not change, so the narrowed range of the tile stays valid after the tile is released
+	dgThreadHiveScopeLock lock (m_instanceData->m_world, &m_tileLock, true);
+	dgInt32 px = x;
+	dgInt32 pz = z;
+	m_elevationPyramid[m_pyramidLevelOffset[m_tileLevel] + pz * m_pyramidLevelWidth[m_tileLevel] + px] = tileRange;
+	for (dgInt32 level = m_tileLevel + 1; level < m_pyramidLevelsCount; level ++) {
+		px >>= 1;
+		pz >>= 1;
+		const dgInt32 childWidth = m_pyramidLevelWidth[level - 1];
+		const dgInt32 childHeight = m_pyramidLevelHeight[level - 1];
+		const dgElevationRange* const children = &m_elevationPyramid[m_pyramidLevelOffset[level - 1]];
+		dgElevationRange range;
+		range.m_min = dgFloat32 (1.0e10f);
+		range.m_max = dgFloat32 (-1.0e10f);
+		for (dgInt32 cz = 2 * pz; cz < dgMin (2 * pz + 2, childHeight); cz ++) {
+			for (dgInt32 cx = 2 * px; cx < dgMin (2 * px + 2, childWidth); cx ++) {
+				const dgElevationRange& child = children[cz * childWidth + cx];
+				range.m_min = dgMin (range.m_min, child.m_min);
+				range.m_max = dgMax (range.m_max, child.m_max);
+			}
+		}
+		m_elevationPyramid[m_pyramidLevelOffset[level] + pz * m_pyramidLevelWidth[level] + px] = range;
+	}
+}
+
+// copy the vertices in the range [x0, x1] x [z0, z1] of the tiles into row major buffers of x1 - x0 + 1 columns, any of the buffers can be NULL
+void dgCollisionHeightField::GatherTiles(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, void* const elevation, dgInt8* const atributes, dgInt8* const diagonals) const
+{
+	const dgInt32 stride = x1 - x0 + 1;
+	const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	const dgInt32 tz0 = GetTileIndex (z0, m_tilesCount_z);
+	const dgInt32 tz1 = GetTileIndex (dgMax (z0, z1 - 1), m_tilesCount_z);
+	const dgInt32 tx0 = GetTileIndex (x0, m_tilesCount_x);
+	const dgInt32 tx1 = GetTileIndex (dgMax (x0, x1 - 1), m_tilesCount_x);
+	for (dgInt32 tz = tz0; tz <= tz1; tz ++) {
+		for (dgInt32 tx = tx0; tx <= tx1; tx ++) {
+			dgHeightFieldTile* const tile = PinTile (tx, tz, true);
+			const dgHeightFieldPage& page = tile->m_page;
+			const dgInt32 xs = dgMax (x0, page.m_x0);
+			const dgInt32 xe = dgMin (x1, page.m_x0 + m_tileSize);
+			const dgInt32 zs = dgMax (z0, page.m_z0);
+			const dgInt32 ze = dgMin (z1, page.m_z0 + m_tileSize);
+			const dgInt32 count = xe - xs + 1;
+			for (dgInt32 z = zs; z <= ze; z ++) {
+				const dgInt32 src = page.GetIndex (xs, z);
+				const dgInt32 dst = (z - z0) * stride + xs - x0;
+				if (elevation) {
+					memcpy (&((dgInt8*)elevation)[dst * elementSize], &((const dgInt8*)page.m_elevation)[src * elementSize], count * elementSize);
+				}
+				if (atributes) {
+					memcpy (&atributes[dst], &page.m_atributes[src], count * sizeof (dgInt8));
+				}
+				if (diagonals) {
+					memcpy (&diagonals[dst], &page.m_diagonals[src], count * sizeof (dgInt8));
+				}
+			}
+			UnpinTile (tile);
+		}
+	}
+}
+
 void dgCollisionHeightField::GetCollisionInfo(dgCollisionInfo* const info) const
 {
 	dgCollision::GetCollisionInfo(info);
@@ -512,7 +1179,7 @@ void dgCollisionHeightField::GetCollisionInfo(dgCollisionInfo* const info) const
 	data.m_elevation = m_elevationMap;
 }
 
-dgFloat32 dgCollisionHeightField::RayCastCell (const dgFastRayTest& ray, dgInt32 xIndex0, dgInt32 zIndex0, dgVector& normalOut, dgFloat32 maxT) const
+dgFloat32 dgCollisionHeightField::RayCastCell (const dgFastRayTest& ray, const dgHeightFieldPage& page, dgInt32 xIndex0, dgInt32 zIndex0, dgVector& normalOut, dgFloat32 maxT) const
 {
 	dgVector points[4];
 	dgInt32 triangle[3];
@@ -524,34 +1191,34 @@ dgFloat32 dgCollisionHeightField::RayCastCell (const dgFastRayTest& ray, dgInt32
 	
 	dgAssert (maxT <= 1.0);
 
-	dgInt32 base = zIndex0 * m_width + xIndex0;
+	const dgInt32 base = page.GetIndex (xIndex0, zIndex0);
 	
 	switch (m_elevationDataType) 
 	{
 		case m_float32Bit:
 		{
-			const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
+			const dgFloat32* const elevation = (const dgFloat32*)page.m_elevation;
 			points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base],			      (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
 			points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + 1],           (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + m_width + 1], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base + m_width + 0], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+			points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + page.m_stride + 1], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+			points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base + page.m_stride + 0], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
 			break;
 		}
 
 		case m_unsigned16Bit:
 		default:
 		{
-			const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
+			const dgUnsigned16* const elevation = (const dgUnsigned16*)page.m_elevation;
 			points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base]),			   (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
 			points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + 1]),           (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + m_width + 1]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + m_width + 0]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+			points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + page.m_stride + 1]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+			points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + page.m_stride + 0]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
 			break;
 		}
 	}
 	
 	dgFloat32 t = dgFloat32 (1.2f);
-	if (!m_diagonals[base]) {
+	if (!page.m_diagonals[base]) {
 		triangle[0] = 1;
 		triangle[1] = 2;
 		triangle[2] = 3;
@@ -610,101 +1277,133 @@ dgFloat32 dgCollisionHeightField::RayCastCell (const dgFastRayTest& ray, dgInt32
 	return t;
 }
 
+dgFloat32 dgCollisionHeightField::RayCastBlock (const dgFastRayTest& ray, const dgHeightFieldPage& page, dgInt32 xBlock, dgInt32 zBlock, const dgElevationRange& range, dgInt32& xIndexOut, dgInt32& zIndexOut, dgInt32& atributeOut, dgVector& normalOut, dgFloat32 maxT) const
+{
+	const dgInt32 x0 = xBlock * DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+	const dgInt32 z0 = zBlock * DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE;
+	const dgInt32 x1 = dgMin (x0 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE, m_width - 1);
+	const dgInt32 z1 = dgMin (z0 + DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE, m_height - 1);
+
+	dgFloat32 t = dgFloat32 (1.2f);
+	for (dgInt32 z = z0; z < z1; z ++) {
+		for (dgInt32 x = x0; x < x1; x ++) {
+			const dgVector minBox (dgVector (x * m_horizontalScale_x, range.m_min, z * m_horizontalScale_z, dgFloat32 (0.0f)) - m_padding);
+			const dgVector maxBox (dgVector ((x + 1) * m_horizontalScale_x, range.m_max, (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f)) + m_padding);
+			if (ray.BoxIntersect (minBox, maxBox) < maxT) {
+				dgVector normal;
+				const dgFloat32 t1 = RayCastCell (ray, page, x, z, normal, maxT);
+				if (t1 < maxT) {
+					t = t1;
+					maxT = t1;
+					xIndexOut = x;
+					zIndexOut = z;
+					atributeOut = page.m_atributes[page.GetIndex (x, z)];
+					normalOut = normal;
+				}
+			}
+		}
+	}
+	return t;
+}
+
 dgFloat32 dgCollisionHeightField::RayCast (const dgVector& q0, const dgVector& q1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const
 {
-	dgVector boxP0;
-	dgVector boxP1;
+	if (!m_pyramidLevelsCount) {
+		return dgFloat32 (1.2f);
+	}
 
-	// calculate the ray bounding box
-	CalculateMinExtend2d (q0, q1, boxP0, boxP1);
-
-	dgVector p0 (q0);
-	dgVector p1 (q1);
-
-	// clip the line against the bounding box
-	if (dgRayBoxClip (p0, p1, boxP0, boxP1)) { 
-		dgVector dp (p1 - p0);
-		dgVector normalOut (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
-
-		dgFloat32 scale_x = m_horizontalScale_x;
-		dgFloat32 invScale_x = m_horizontalScaleInv_x;
-		dgFloat32 scale_z = m_horizontalScale_z;
-		dgFloat32 invScale_z = m_horizontalScaleInv_z;
-		dgInt32 ix0 = dgFastInt (p0.m_x * invScale_x);
-		dgInt32 iz0 = dgFastInt (p0.m_z * invScale_z);
-
-		// implement a 3ddda line algorithm 
-		dgInt32 xInc;
-		dgFloat32 tx;
-		dgFloat32 stepX;
-		if (dp.m_x > dgFloat32 (0.0f)) {
-			xInc = 1;
-			dgFloat32 val = dgFloat32 (1.0f) / dp.m_x;
-			stepX = scale_x * val;
-			tx = (scale_x * (ix0 + dgFloat32 (1.0f)) - p0.m_x) * val;
-		} else if (dp.m_x < dgFloat32 (0.0f)) {
-			xInc = -1;
-			dgFloat32 val = -dgFloat32 (1.0f) / dp.m_x;
-			stepX = scale_x * val;
-			tx = -(scale_x * ix0 - p0.m_x) * val;
-		} else {
-			xInc = 0;
-			stepX = dgFloat32 (0.0f);
-			tx = dgFloat32 (1.0e10f);
-		}
-
-		dgInt32 zInc;
-		dgFloat32 tz;
-		dgFloat32 stepZ;
-		if (dp.m_z > dgFloat32 (0.0f)) {
-			zInc = 1;
-			dgFloat32 val = dgFloat32 (1.0f) / dp.m_z;
-			stepZ = scale_z * val;
-			tz = (scale_z * (iz0 + dgFloat32 (1.0f)) - p0.m_z) * val;
-		} else if (dp.m_z < dgFloat32 (0.0f)) {
-			zInc = -1;
-			dgFloat32 val = -dgFloat32 (1.0f) / dp.m_z;
-			stepZ = scale_z * val;
-			tz = -(scale_z * iz0 - p0.m_z) * val;
+	dgFastRayTest ray (q0, q1); 
+	dgVector normalOut (dgFloat32 (0.0f));
+
+	// children are pushed far to near, so that the blocks closer to the ray origin are visited first, 
+	// and blocks farther than the closest hit so far, or that the ray pass above or below, are skipped. 
+	const dgInt32 xNear = (q1.m_x < q0.m_x) ? 1 : 0;
+	const dgInt32 zNear = (q1.m_z < q0.m_z) ? 1 : 0;
+
+	dgInt32 xIndex = -1;
+	dgInt32 zIndex = -1;
+	dgInt32 atribute = 0;
+	dgFloat32 t = dgFloat32 (1.2f);
+
+	// on tiled height fields, the tile of a node at the tile level is pinned when the node is hit, 
+	// and unpinned when the traversal pops the next node at or above the tile level, after the whole sub tree of the tile was visited.
+	dgHeightFieldTile* tile = NULL;
+	dgHeightFieldPage page (m_mapPage);
+
+	dgInt32 stack = 1;
+	dgInt32 stackPool[4 * DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS][3];
+	stackPool[0][0] = m_pyramidLevelsCount - 1;
+	stackPool[0][1] = 0;
+	stackPool[0][2] = 0;
+	while (stack) {
+		stack --;
+		const dgInt32 level = stackPool[stack][0];
+		const dgInt32 x = stackPool[stack][1];
+		const dgInt32 z = stackPool[stack][2];
+
+		if (tile && (level >= m_tileLevel)) {
+			UnpinTile (tile);
+			tile = NULL;
+		}
+
+		const dgInt32 size = DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE << level;
+		const dgInt32 x0 = x * size;
+		const dgInt32 z0 = z * size;
+		const dgInt32 x1 = dgMin (x0 + size, m_width - 1);
+		const dgInt32 z1 = dgMin (z0 + size, m_height - 1);
+		const dgElevationRange& range = GetElevationRange (level, x, z, tile);
+		const dgVector minBox (dgVector (x0 * m_horizontalScale_x, range.m_min, z0 * m_horizontalScale_z, dgFloat32 (0.0f)) - m_padding);
+		const dgVector maxBox (dgVector (x1 * m_horizontalScale_x, range.m_max, z1 * m_horizontalScale_z, dgFloat32 (0.0f)) + m_padding);
+		if (ray.BoxIntersect (minBox, maxBox) >= maxT) {
+			continue;
+		}
+
+		if (m_tiles && (level == m_tileLevel)) {
+			tile = PinTile (x, z, true);
+			page = tile->m_page;
+		}
+
+		if (level == 0) {
+			const dgFloat32 t1 = RayCastBlock (ray, page, x, z, range, xIndex, zIndex, atribute, normalOut, maxT);
+			if (t1 < maxT) {
+				t = t1;
+				maxT = t1;
+			}
 		} else {
-			zInc = 0;
-			stepZ = dgFloat32 (0.0f);
-			tz = dgFloat32 (1.0e10f);
-		}
-
-		dgFloat32 txAcc = tx;
-		dgFloat32 tzAcc = tz;
-		dgInt32 xIndex0 = ix0;
-		dgInt32 zIndex0 = iz0;
-		dgFastRayTest ray (q0, q1); 
-
-		// for each cell touched by the line
-		do {
-			dgFloat32 t = RayCastCell (ray, xIndex0, zIndex0, normalOut, maxT);
-			if (t < maxT) {
-				// bail out at the first intersection and copy the data into the descriptor
-				contactOut.m_normal = normalOut.Scale3 (dgRsqrt (normalOut.DotProduct3(normalOut)));
-				contactOut.m_shapeId0 = m_atributeMap[zIndex0 * m_width + xIndex0];
-				contactOut.m_shapeId1 = m_atributeMap[zIndex0 * m_width + xIndex0];
-
-				if (m_userRayCastCallback) {
-					dgVector normal (body->GetCollision()->GetGlobalMatrix().RotateVector (contactOut.m_normal));
-					m_userRayCastCallback (body, this, t, xIndex0, zIndex0, &normal, dgInt32 (contactOut.m_shapeId0), userData);
+			const dgInt32 childLevel = level - 1;
+			const dgInt32 childWidth = m_pyramidLevelWidth[childLevel];
+			const dgInt32 childHeight = m_pyramidLevelHeight[childLevel];
+			for (dgInt32 i = 1; i >= 0; i --) {
+				const dgInt32 cz = 2 * z + (i ^ zNear);
+				for (dgInt32 j = 1; j >= 0; j --) {
+					const dgInt32 cx = 2 * x + (j ^ xNear);
+					if ((cx < childWidth) && (cz < childHeight)) {
+						stackPool[stack][0] = childLevel;
+						stackPool[stack][1] = cx;
+						stackPool[stack][2] = cz;
+						stack ++;
+						dgAssert (stack < dgInt32 (sizeof (stackPool) / sizeof (stackPool[0])));
+					}
 				}
-
-				return t;
 			}
+		}
+	}
 
-			if (txAcc < tzAcc) {
-				xIndex0 += xInc;
-				tx = txAcc;
-				txAcc += stepX;
-			} else {
-				zIndex0 += zInc;
-				tz = tzAcc;
-				tzAcc += stepZ;
-			}
-		} while ((tx <= dgFloat32 (1.0f)) || (tz <= dgFloat32 (1.0f)));
+	if (tile) {
+		UnpinTile (tile);
+	}
+
+	if (t < dgFloat32 (1.0f)) {
+		// copy the data of the closest intersection into the descriptor
+		contactOut.m_normal = normalOut.Scale3 (dgRsqrt (normalOut.DotProduct3(normalOut)));
+		contactOut.m_shapeId0 = atribute;
+		contactOut.m_shapeId1 = atribute;
+
+		if (m_userRayCastCallback) {
+			dgVector normal (body->GetCollision()->GetGlobalMatrix().RotateVector (contactOut.m_normal));
+			m_userRayCastCallback (body, this, t, xIndex, zIndex, &normal, dgInt32 (contactOut.m_shapeId0), userData);
+		}
+		return t;
 	}
 
 	// if no cell was hit, return a large value
@@ -729,7 +1428,10 @@ dgVector dgCollisionHeightField::SupportVertex (const dgVector& dir, dgInt32* co
 {
 	dgFloat32 maxProject (dgFloat32 (-1.e-20f));
 	dgVector support (dgFloat32 (0.0f));
-	if (m_elevationDataType == m_float32Bit)  {
+	if (m_tiles) {
+		// scanning a tiled height field will page in the whole grid, use the corner of the bounding box instead 
+		support = dgVector ((dir.m_x > dgFloat32 (0.0f)) ? m_maxBox.m_x : m_minBox.m_x, (dir.m_y > dgFloat32 (0.0f)) ? m_maxBox.m_y : m_minBox.m_y, (dir.m_z > dgFloat32 (0.0f)) ? m_maxBox.m_z : m_minBox.m_z, dgFloat32 (0.0f));
+	} else if (m_elevationDataType == m_float32Bit)  {
 		const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
 		for (dgInt32 z = 0; z < m_height - 1; z ++) {
 			dgInt32 base = z * m_width;
@@ -769,37 +1471,59 @@ dgVector dgCollisionHeightField::SupportVertexSpecial (const dgVector& dir, dgIn
 }
 
 void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const
+{
+	if (!m_tiles) {
+		DebugCollisionCells (matrix, m_mapPage, 0, m_width - 1, 0, m_height - 1, callback, userData);
+	} else {
+		// only the tiles in memory are displayed, paging in the whole grid would evict the tiles in use by the simulation
+		for (dgInt32 z = 0; z < m_tilesCount_z; z ++) {
+			for (dgInt32 x = 0; x < m_tilesCount_x; x ++) {
+				dgHeightFieldTile* const tile = PinTile (x, z, false);
+				if (tile) {
+					const dgInt32 x0 = x * m_tileSize;
+					const dgInt32 z0 = z * m_tileSize;
+					DebugCollisionCells (matrix, tile->m_page, x0, dgMin (x0 + m_tileSize, m_width - 1), z0, dgMin (z0 + m_tileSize, m_height - 1), callback, userData);
+					UnpinTile (tile);
+				}
+			}
+		}
+	}
+}
+
+// output the triangles of the cells in the range [x0, x1) x [z0, z1)
+void dgCollisionHeightField::DebugCollisionCells (const dgMatrix& matrix, const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const
 {
 	dgVector points[4];
 
-	dgInt32 base = 0;
-	for (dgInt32 z = 0; z < m_height - 1; z ++) {
+	for (dgInt32 z = z0; z < z1; z ++) {
+		const dgInt32 base = page.GetIndex (0, z);
+		const dgInt32 displacementBase = z * m_width;
 		switch (m_elevationDataType) 
 		{
 			case m_float32Bit:
 			{
-				const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
-				points[0 * 2 + 0] = dgVector ((0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base + 0              ], (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-				points[1 * 2 + 0] = dgVector ((0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base + 0 + m_width + 0], (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+				const dgFloat32* const elevation = (const dgFloat32*)page.m_elevation;
+				points[0 * 2 + 0] = dgVector (x0 * m_horizontalScale_x, m_verticalScale * elevation[base + x0], (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[1 * 2 + 0] = dgVector (x0 * m_horizontalScale_x, m_verticalScale * elevation[base + x0 + page.m_stride], (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
 				break;
 			}
 
 			case m_unsigned16Bit:
 			{
-				const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
-				points[0 * 2 + 0] = dgVector ((0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + 0              ]), (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-				points[1 * 2 + 0] = dgVector ((0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + 0 + m_width + 0]), (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+				const dgUnsigned16* const elevation = (const dgUnsigned16*)page.m_elevation;
+				points[0 * 2 + 0] = dgVector (x0 * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + x0]), (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[1 * 2 + 0] = dgVector (x0 * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + x0 + page.m_stride]), (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
 				break;
 			}
 		}
 
 		if (m_horizontalDisplacement) {
-			dgUnsigned16 val = m_horizontalDisplacement[base];
+			dgUnsigned16 val = m_horizontalDisplacement[displacementBase + x0];
 			dgInt8 hor_x = val & 0xff;
 			dgInt8 hor_z = (val >> 8);
 			points[0 * 2 + 0] += dgVector(hor_x * m_horizontalDisplacementScale_x, dgFloat32(0.0f), hor_z * m_horizontalDisplacementScale_z, dgFloat32(0.0f));
 
-			val = m_horizontalDisplacement[base + m_width];
+			val = m_horizontalDisplacement[displacementBase + x0 + m_width];
 			hor_x = val & 0xff;
 			hor_z = (val >> 8);
 			points[1 * 2 + 0] += dgVector(hor_x * m_horizontalDisplacementScale_x, dgFloat32(0.0f), hor_z * m_horizontalDisplacementScale_z, dgFloat32(0.0f));
@@ -808,34 +1532,34 @@ void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision
 		points[0 * 2 + 0] = matrix.TransformVector(points[0 * 2 + 0]);
 		points[1 * 2 + 0] = matrix.TransformVector(points[1 * 2 + 0]);
 
-		for (dgInt32 x = 0; x < m_width - 1; x ++) {
+		for (dgInt32 x = x0; x < x1; x ++) {
 			dgTriplex triangle[3];
 			switch (m_elevationDataType) 
 			{
 				case m_float32Bit:
 				{
-					const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
-					points[0 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + x +           1], (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-					points[1 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + x + m_width + 1], (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+					const dgFloat32* const elevation = (const dgFloat32*)page.m_elevation;
+					points[0 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + x + 1], (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+					points[1 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + x + page.m_stride + 1], (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
 					break;
 				}
 
 				case m_unsigned16Bit:
 				{
-					const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
-					points[0 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + x +           1]), (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-					points[1 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + x + m_width + 1]), (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+					const dgUnsigned16* const elevation = (const dgUnsigned16*)page.m_elevation;
+					points[0 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + x + 1]), (z + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+					points[1 * 2 + 1] = dgVector ((x + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + x + page.m_stride + 1]), (z + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
 					break;
 				}
 			}
 
 			if (m_horizontalDisplacement) {
-				dgUnsigned16 val = m_horizontalDisplacement[base + x + 1];
+				dgUnsigned16 val = m_horizontalDisplacement[displacementBase + x + 1];
 				dgInt8 hor_x = val & 0xff;
 				dgInt8 hor_z = (val >> 8);
 				points[0 * 2 + 1] += dgVector(hor_x * m_horizontalDisplacementScale_x, dgFloat32(0.0f), hor_z * m_horizontalDisplacementScale_z, dgFloat32(0.0f));
 
-				val = m_horizontalDisplacement[base + m_width + x + 1];
+				val = m_horizontalDisplacement[displacementBase + m_width + x + 1];
 				hor_x = val & 0xff;
 				hor_z = (val >> 8);
 				points[1 * 2 + 1] += dgVector(hor_x * m_horizontalDisplacementScale_x, dgFloat32(0.0f), hor_z * m_horizontalDisplacementScale_z, dgFloat32(0.0f));
@@ -844,7 +1568,7 @@ void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision
 			points[0 * 2 + 1] = matrix.TransformVector(points[0 * 2 + 1]);
 			points[1 * 2 + 1] = matrix.TransformVector(points[1 * 2 + 1]);
 
-			const dgInt32* const indirectIndex = &m_cellIndices[dgInt32 (m_diagonals[z * m_width + x])][0];
+			const dgInt32* const indirectIndex = &m_cellIndices[dgInt32 (page.m_diagonals[base + x])][0];
 
 			dgInt32 i0 = indirectIndex[0];
 			dgInt32 i1 = indirectIndex[1];
@@ -862,7 +1586,7 @@ void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision
 			triangle[2].m_x = points[i2].m_x;
 			triangle[2].m_y = points[i2].m_y;
 			triangle[2].m_z = points[i2].m_z;
-			callback (userData, 3, &triangle[0].m_x, m_atributeMap[base]);
+			callback (userData, 3, &triangle[0].m_x, page.m_atributes[base + x]);
 
 			triangle[0].m_x = points[i1].m_x;
 			triangle[0].m_y = points[i1].m_y;
@@ -875,38 +1599,145 @@ void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision
 			triangle[2].m_x = points[i3].m_x;
 			triangle[2].m_y = points[i3].m_y;
 			triangle[2].m_z = points[i3].m_z;
-			callback (userData, 3, &triangle[0].m_x, m_atributeMap[base]);
+			callback (userData, 3, &triangle[0].m_x, page.m_atributes[base + x]);
 
 			points[0 * 2 + 0] = points[0 * 2 + 1];
 			points[1 * 2 + 0] = points[1 * 2 + 1];
 		}
-		base += m_width;
 	}
 }
 
-void dgCollisionHeightField::CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const
+void dgCollisionHeightField::CalculateMinAndMaxElevation(const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const
 {
-	dgInt32 base = z0 * m_width;
+	dgInt32 base = page.GetIndex (0, z0);
 	for (dgInt32 z = z0; z <= z1; z++) {
 		for (dgInt32 x = x0; x <= x1; x++) {
 			dgFloat32 high = elevation[base + x];
 			minHeight = dgMin(high, minHeight);
 			maxHeight = dgMax(high, maxHeight);
 		}
-		base += m_width;
+		base += page.m_stride;
 	}
 }
 
-void dgCollisionHeightField::CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgInt16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const
+void dgCollisionHeightField::CalculateMinAndMaxElevation(const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgUnsigned16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const
 {
-	dgInt32 base = z0 * m_width;
+	dgInt32 base = page.GetIndex (0, z0);
 	for (dgInt32 z = z0; z <= z1; z++) {
 		for (dgInt32 x = x0; x <= x1; x++) {
 			dgFloat32 high = dgFloat32 (elevation[base + x]);
 			minHeight = dgMin(high, minHeight);
 			maxHeight = dgMax(high, maxHeight);
 		}
-		base += m_width;
+		base += page.m_stride;
+	}
+}
+
+dgCollisionHeightField::dgElevationRange dgCollisionHeightField::CalculateScaledElevationRange(const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1) const
+{
+	dgFloat32 minHeight = dgFloat32 (1.0e10f);
+	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
+	switch (m_elevationDataType) 
+	{
+		case m_float32Bit:
+		{
+			CalculateMinAndMaxElevation(page, x0, x1, z0, z1, (const dgFloat32*)page.m_elevation, minHeight, maxHeight);
+			break;
+		}
+
+		case m_unsigned16Bit:
+		{
+			CalculateMinAndMaxElevation(page, x0, x1, z0, z1, (const dgUnsigned16*)page.m_elevation, minHeight, maxHeight);
+			break;
+		}
+	}
+
+	dgElevationRange range;
+	range.m_min = dgMin (minHeight * m_verticalScale, maxHeight * m_verticalScale);
+	range.m_max = dgMax (minHeight * m_verticalScale, maxHeight * m_verticalScale);
+	return range;
+}
+
+// scaled min and max elevation of the vertices in the range [x0, x1] x [z0, z1], 
+// blocks fully inside the range are read from the pyramid, and only the partially covered level zero blocks scan the elevation map.
+// on tiled height fields, partially covered tiles that are not in memory use the range of the whole tile rather than paging it in.
+void dgCollisionHeightField::CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const
+{
+	dgAssert ((x0 >= 0) && (x1 < m_width));
+	dgAssert ((z0 >= 0) && (z1 < m_height));
+
+	minHeight = dgFloat32 (1.0e10f);
+	maxHeight = dgFloat32 (-1.0e10f);
+	if (!m_pyramidLevelsCount) {
+		return;
+	}
+
+	dgInt32 stack = 1;
+	dgInt32 stackPool[4 * DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS][3];
+	stackPool[0][0] = m_pyramidLevelsCount - 1;
+	stackPool[0][1] = 0;
+	stackPool[0][2] = 0;
+
+	dgHeightFieldTile* tile = NULL;
+	dgHeightFieldPage page (m_mapPage);
+	while (stack) {
+		stack --;
+		const dgInt32 level = stackPool[stack][0];
+		const dgInt32 x = stackPool[stack][1];
+		const dgInt32 z = stackPool[stack][2];
+
+		if (tile && (level >= m_tileLevel)) {
+			UnpinTile (tile);
+			tile = NULL;
+		}
+
+		const dgInt32 size = DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE << level;
+		const dgInt32 bx0 = x * size;
+		const dgInt32 bz0 = z * size;
+		const dgInt32 bx1 = dgMin (bx0 + size, m_width - 1);
+		const dgInt32 bz1 = dgMin (bz0 + size, m_height - 1);
+		if ((bx1 < x0) || (bx0 > x1) || (bz1 < z0) || (bz0 > z1)) {
+			continue;
+		}
+
+		if ((bx0 >= x0) && (bx1 <= x1) && (bz0 >= z0) && (bz1 <= z1)) {
+			const dgElevationRange& range = GetElevationRange (level, x, z, tile);
+			minHeight = dgMin (minHeight, range.m_min);
+			maxHeight = dgMax (maxHeight, range.m_max);
+			continue;
+		} 
+		
+		if (m_tiles && (level == m_tileLevel)) {
+			tile = PinTile (x, z, false);
+			if (!tile) {
+				const dgElevationRange& range = GetElevationRange (level, x, z, NULL);
+				minHeight = dgMin (minHeight, range.m_min);
+				maxHeight = dgMax (maxHeight, range.m_max);
+				continue;
+			}
+			page = tile->m_page;
+		}
+
+		if (level == 0) {
+			const dgElevationRange range (CalculateScaledElevationRange(page, dgMax (bx0, x0), dgMin (bx1, x1), dgMax (bz0, z0), dgMin (bz1, z1)));
+			minHeight = dgMin (minHeight, range.m_min);
+			maxHeight = dgMax (maxHeight, range.m_max);
+		} else {
+			const dgInt32 childLevel = level - 1;
+			for (dgInt32 cz = 2 * z; cz < dgMin (2 * z + 2, m_pyramidLevelHeight[childLevel]); cz ++) {
+				for (dgInt32 cx = 2 * x; cx < dgMin (2 * x + 2, m_pyramidLevelWidth[childLevel]); cx ++) {
+					stackPool[stack][0] = childLevel;
+					stackPool[stack][1] = cx;
+					stackPool[stack][2] = cz;
+					stack ++;
+					dgAssert (stack < dgInt32 (sizeof (stackPool) / sizeof (stackPool[0])));
+				}
+			}
+		}
+	}
+
+	if (tile) {
+		UnpinTile (tile);
 	}
 }
 
@@ -929,26 +1760,12 @@ void dgCollisionHeightField::GetLocalAABB (const dgVector& q0, const dgVector& q
 	dgInt32 z0 = dgInt32 (p0.m_iz);
 	dgInt32 z1 = dgInt32 (p1.m_iz);
 
-	dgFloat32 minHeight = dgFloat32 (1.0e10f);
-	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
-	//dgInt32 base = z0 * m_width;
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-
-		case m_unsigned16Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgInt16*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-	}
+	dgFloat32 minHeight;
+	dgFloat32 maxHeight;
+	CalculateMinAndMaxElevation(x0, x1, z0, z1, minHeight, maxHeight);
 
-	boxP0.m_y = m_verticalScale * minHeight;
-	boxP1.m_y = m_verticalScale * maxHeight;
+	boxP0.m_y = minHeight;
+	boxP1.m_y = maxHeight;
 }
 
 void dgCollisionHeightField::AddDisplacement (dgVector* const vertex, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1) const
@@ -997,51 +1814,54 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 	dgInt32 z1 = dgInt32 (p1.m_iz);
 
 	data->m_separationDistance = dgFloat32 (0.0f);
-	dgFloat32 minHeight = dgFloat32 (1.0e10f);
-	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
-//	dgInt32 base = z0 * m_width;
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-
-		case m_unsigned16Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgInt16*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-	}
-
-	minHeight *= m_verticalScale;
-	maxHeight *= m_verticalScale;
+	dgFloat32 minHeight;
+	dgFloat32 maxHeight;
+	CalculateMinAndMaxElevation(x0, x1, z0, z1, minHeight, maxHeight);
 
 	if (!((maxHeight < boxP0.m_y) || (minHeight > boxP1.m_y))) {
 		// scan the vertices's intersected by the box extend
+		dgAssert (data->m_threadNumber < m_instanceData->m_threadCount);
+		dgPerThreadData& threadData = m_instanceData->m_threadData[data->m_threadNumber];
 		dgInt32 base = (z1 - z0 + 1) * (x1 - x0 + 1) + 2 * (z1 - z0) * (x1 - x0);
-		while (base > m_instanceData->m_vertexCount[data->m_threadNumber]) {
+		while (base > threadData.m_vertexCount) {
 			AllocateVertex(world, data->m_threadNumber);
 		}
 
+		dgHeightFieldPage page (m_mapPage);
+		if (m_tiles) {
+			// copy the vertices under the box from the tiles to a buffer of this thread
+			const dgInt32 count = (z1 - z0 + 1) * (x1 - x0 + 1);
+			const dgInt32 elevationSize = (count * ((m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16)) + 15) & -16;
+			const dgInt32 atributesSize = (count + 15) & -16;
+			dgArray<dgInt8>& buffer = threadData.m_tileGather;
+			buffer.ResizeIfNecessary (elevationSize + 2 * atributesSize);
+			dgInt8* const memory = &buffer[0];
+			GatherTiles (x0, x1, z0, z1, memory, &memory[elevationSize], &memory[elevationSize + atributesSize]);
+			page.m_elevation = memory;
+			page.m_atributes = &memory[elevationSize];
+			page.m_diagonals = &memory[elevationSize + atributesSize];
+			page.m_x0 = x0;
+			page.m_z0 = z0;
+			page.m_stride = x1 - x0 + 1;
+		}
+
 		dgInt32 vertexIndex = 0;
-		base = z0 * m_width;
-		dgVector* const vertex = &m_instanceData->m_vertex[data->m_threadNumber][0];
+		base = page.GetIndex (0, z0);
+		dgVector* const vertex = &threadData.m_vertex[0];
 
 		switch (m_elevationDataType) 
 		{
 			case m_float32Bit:
 			{
-				const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
+				const dgFloat32* const elevation = (const dgFloat32*)page.m_elevation;
 				for (dgInt32 z = z0; z <= z1; z ++) {
 					dgFloat32 zVal = m_horizontalScale_z * z;
 					for (dgInt32 x = x0; x <= x1; x ++) {
 						vertex[vertexIndex] = dgVector(m_horizontalScale_x * x, m_verticalScale * elevation[base + x], zVal, dgFloat32 (0.0f));
 						vertexIndex ++;
-						dgAssert (vertexIndex <= m_instanceData->m_vertexCount[data->m_threadNumber]); 
+						dgAssert (vertexIndex <= threadData.m_vertexCount); 
 					}
-					base += m_width;
+					base += page.m_stride;
 				}
 				if (m_horizontalDisplacement) {
 					AddDisplacement (vertex, x0, x1, z0, z1);
@@ -1051,15 +1871,15 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 
 			case m_unsigned16Bit:
 			{
-				const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
+				const dgUnsigned16* const elevation = (const dgUnsigned16*)page.m_elevation;
 				for (dgInt32 z = z0; z <= z1; z ++) {
 					dgFloat32 zVal = m_horizontalScale_z * z;
 					for (dgInt32 x = x0; x <= x1; x ++) {
 						vertex[vertexIndex] = dgVector(m_horizontalScale_x * x, m_verticalScale * dgFloat32 (elevation[base + x]), zVal, dgFloat32 (0.0f));
 						vertexIndex ++;
-						dgAssert (vertexIndex <= m_instanceData->m_vertexCount[data->m_threadNumber]); 
+						dgAssert (vertexIndex <= threadData.m_vertexCount); 
 					}
-					base += m_width;
+					base += page.m_stride;
 				}
 				if (m_horizontalDisplacement) {
 					AddDisplacement(vertex, x0, x1, z0, z1);
@@ -1078,9 +1898,9 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		dgInt32 faceSize = dgInt32 (dgMax (m_horizontalScale_x, m_horizontalScale_z) * dgFloat32 (2.0f)); 
 
 		for (dgInt32 z = z0; (z < z1) && (faceCount < DG_MAX_COLLIDING_FACES); z ++) {
-			dgInt32 zStep = z * m_width;
+			dgInt32 zStep = page.GetIndex (0, z);
 			for (dgInt32 x = x0; (x < x1) && (faceCount < DG_MAX_COLLIDING_FACES); x ++) {
-				const dgInt32* const indirectIndex = &m_cellIndices[dgInt32 (m_diagonals[zStep + x])][0];
+				const dgInt32* const indirectIndex = &m_cellIndices[dgInt32 (page.m_diagonals[zStep + x])][0];
 
 				dgInt32 vIndex[4];
 				vIndex[0] = vertexIndex;
@@ -1112,7 +1932,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 				indices[index + 0 + 0] = i2;
 				indices[index + 0 + 1] = i1;
 				indices[index + 0 + 2] = i0;
-				indices[index + 0 + 3] = m_atributeMap[zStep + x];
+				indices[index + 0 + 3] = page.m_atributes[zStep + x];
 				indices[index + 0 + 4] = normalIndex0;
 				indices[index + 0 + 5] = normalIndex0;
 				indices[index + 0 + 6] = normalIndex0;
@@ -1123,7 +1943,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 				indices[index + 9 + 0] = i1;
 				indices[index + 9 + 1] = i2;
 				indices[index + 9 + 2] = i3;
-				indices[index + 9 + 3] = m_atributeMap[zStep + x];
+				indices[index + 9 + 3] = page.m_atributes[zStep + x];
 				indices[index + 9 + 4] = normalIndex1;
 				indices[index + 9 + 5] = normalIndex1;
 				indices[index + 9 + 6] = normalIndex1;
@@ -1154,12 +1974,12 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		const int maxIndex = index;
 		dgInt32 stepBase = (x1 - x0) * (2 * 9);
 		for (dgInt32 z = z0; z < z1; z ++) {
-			const dgInt32 diagBase = m_width * z;
+			const dgInt32 diagBase = page.GetIndex (0, z);
 			const dgInt32 triangleIndexBase = (z - z0) * stepBase;
 			for (dgInt32 x = x0; x < (x1 - 1); x ++) {
 				dgInt32 index1 = (x - x0) * (2 * 9) + triangleIndexBase;
 				if (index1 < maxIndex) {
-					const dgInt32 code = (m_diagonals[diagBase + x] << 1) + m_diagonals[diagBase + x + 1];
+					const dgInt32 code = (page.m_diagonals[diagBase + x] << 1) + page.m_diagonals[diagBase + x + 1];
 					const dgInt32* const edgeMap = &m_horizontalEdgeMap[code][0];
 				
 					dgInt32* const triangles = &indices[index1];
@@ -1189,8 +2009,8 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			for (dgInt32 z = z0; z < (z1 - 1); z ++) {	
 				dgInt32 index1 = (z - z0) * stepBase + triangleIndexBase;
 				if (index1 < maxIndex) {
-					const dgInt32 diagBase = m_width * z;
-					const dgInt32 code = (m_diagonals[diagBase + x] << 1) + m_diagonals[diagBase + m_width + x];
+					const dgInt32 diagBase = page.GetIndex (0, z);
+					const dgInt32 code = (page.m_diagonals[diagBase + x] << 1) + page.m_diagonals[diagBase + page.m_stride + x];
 					const dgInt32* const edgeMap = &m_verticalEdgeMap[code][0];
 
 					dgInt32* const triangles = &indices[index1];
@@ -25,6 +25,10 @@
 #include "dgCollision.h"
 #include "dgCollisionMesh.h"
 
+#define DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE	4
+#define DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS	24
+#define DG_HEIGHTFIELD_TILE_EMPTY			-1
+
 class dgCollisionHeightField;
 typedef dgFloat32 (*dgCollisionHeightFieldRayCastCallback) (const dgBody* const body, const dgCollisionHeightField* const heightFieldCollision, dgFloat32 interception, dgInt32 row, dgInt32 col, dgVector* const normal, int faceId, void* const usedData);
 
@@ -53,8 +57,18 @@ class dgCollisionHeightField: public dgCollisionMesh
 							const void* const elevationMap, dgElevationType elevationDataType, dgFloat32 verticalScale, 
 							const dgInt8* const atributeMap, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
 
+	// tiled height field, the elevation and attributes of a tile are read by the page in callback the first time a query reaches the tile, 
+	// and tiles that were not used recently are released when more than maxResidentTiles tiles are in memory.
+	dgCollisionHeightField (dgWorld* const world, dgInt32 width, dgInt32 height, dgInt32 contructionMode, 
+							dgElevationType elevationDataType, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z,
+							dgInt32 tileSize, dgInt32 maxResidentTiles, dgFloat32 minElevation, dgFloat32 maxElevation, 
+							dgCollisionHeightFieldPageInCallback pageInCallback, void* const pageInUserData);
+
 	dgCollisionHeightField (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 
+	// the maps and the elevation pyramid point to the image, the image must outlive the collision
+	dgCollisionHeightField (dgWorld* const world, const dgMemoryImageReader& image);
+
 	virtual ~dgCollisionHeightField(void);
 
 	void SetCollisionRayCastCallback (dgCollisionHeightFieldRayCastCallback rayCastCallback);
@@ -62,24 +76,108 @@ class dgCollisionHeightField: public dgCollisionMesh
 
 	void SetHorizontalDisplacement (const dgUnsigned16* const displacemnet, dgFloat32 scale);
 
+	static void SetThreadsCount (dgWorld* const world, dgInt32 count);
+
+	bool IsTiled() const { return m_tiles ? true : false; }
+	bool SerializeImage (dgMemoryImageWriter& image) const;
+	dgInt32 GetResidentTilesCount() const { return m_residentTiles.GetCount(); }
+
 	private:
+	class dgPerThreadData
+	{
+		public:
+		DG_CLASS_ALLOCATOR(allocator)
+
+		dgInt32 m_vertexCount;
+		dgArray<dgVector> m_vertex;
+		dgArray<dgInt8> m_tileGather;
+	};
+
 	class dgPerIntanceData
 	{
 		public:
+		void SetThreadsCount (dgInt32 count);
+
 		dgWorld* m_world;
+		dgPerThreadData* m_threadData;
+		dgInt32 m_threadCount;
 		dgInt32 m_refCount;
-		dgInt32 m_vertexCount[DG_MAX_THREADS_HIVE_COUNT];
-		dgArray<dgVector> m_vertex[DG_MAX_THREADS_HIVE_COUNT];
 	};
 
+	class dgElevationRange
+	{
+		public:
+		dgFloat32 m_min;
+		dgFloat32 m_max;
+	};
+
+	// a rectangle of the grid that is in memory, indexed with the vertex coordinates of the whole grid
+	class dgHeightFieldPage
+	{
+		public:
+		DG_INLINE dgInt32 GetIndex (dgInt32 x, dgInt32 z) const
+		{
+			return (z - m_z0) * m_stride + x - m_x0;
+		}
+
+		const void* m_elevation;
+		const dgInt8* m_atributes;
+		const dgInt8* m_diagonals;
+		dgInt32 m_x0;
+		dgInt32 m_z0;
+		dgInt32 m_stride;
+	};
+
+	// a resident tile holds tileSize + 1 by tileSize + 1 vertices, so that all the cells of the tile are in the page,
+	// and the pyramid levels below the tile level
+	class dgHeightFieldTile
+	{
+		public:
+		dgHeightFieldPage m_page;
+		dgElevationRange* m_pyramid;
+		dgList<dgHeightFieldTile*>::dgListNode* m_lruNode;
+		dgInt32 m_x;
+		dgInt32 m_z;
+	};
+
+	// each tile of the grid has a slot, the pin count of a slot without a tile in memory is DG_HEIGHTFIELD_TILE_EMPTY.
+	// queries pin and unpin resident tiles with atomic operations on the slot, the tile lock is only taken to page in and release tiles.
+	// a tile is pinned by the thread that pages it in, so it can not be released while the page in callback fills it.
+	class dgHeightFieldTileSlot
+	{
+		public:
+		dgHeightFieldTile* m_tile;
+		dgInt32 m_pinCount;
+		dgInt32 m_loading;
+		dgInt32 m_referenced;
+	};
+
+	void AttachInstanceData(dgWorld* const world);
 	void CalculateAABB();
-	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgInt16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
-	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	void BuildElevationPyramid();
+	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	void CalculateMinAndMaxElevation(const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgUnsigned16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	void CalculateMinAndMaxElevation(const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	dgElevationRange CalculateScaledElevationRange(const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1) const;
+	const dgElevationRange& GetElevationRange(dgInt32 level, dgInt32 x, dgInt32 z, const dgHeightFieldTile* const tile) const;
+
+	dgInt8 GetDiagonal(dgInt32 x, dgInt32 z) const;
+	dgInt32 GetTileIndex(dgInt32 vertexIndex, dgInt32 tilesCount) const;
+	dgHeightFieldTile* PinTile(dgInt32 x, dgInt32 z, bool pageIn) const;
+	void UnpinTile(dgHeightFieldTile* const tile) const;
+	dgHeightFieldTile* PageInTile(dgInt32 x, dgInt32 z) const;
+	dgHeightFieldTile* WaitForTile(dgHeightFieldTileSlot* const slot) const;
+	void LoadTile(dgHeightFieldTile* const tile) const;
+	void ReleaseTiles() const;
+	void ReleaseTile(dgHeightFieldTile* const tile) const;
+	void GatherTiles(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, void* const elevation, dgInt8* const atributes, dgInt8* const diagonals) const;
 		
 	void AllocateVertex(dgWorld* const world, dgInt32 thread) const;
 	void CalculateMinExtend2d (const dgVector& p0, const dgVector& p1, dgVector& boxP0, dgVector& boxP1) const;
 	void CalculateMinExtend3d (const dgVector& p0, const dgVector& p1, dgVector& boxP0, dgVector& boxP1) const;
-	dgFloat32 RayCastCell (const dgFastRayTest& ray, dgInt32 xIndex0, dgInt32 zIndex0, dgVector& normalOut, dgFloat32 maxT) const;
+	dgFloat32 RayCastCell (const dgFastRayTest& ray, const dgHeightFieldPage& page, dgInt32 xIndex0, dgInt32 zIndex0, dgVector& normalOut, dgFloat32 maxT) const;
+	dgFloat32 RayCastBlock (const dgFastRayTest& ray, const dgHeightFieldPage& page, dgInt32 xBlock, dgInt32 zBlock, const dgElevationRange& range, dgInt32& xIndexOut, dgInt32& zIndexOut, dgInt32& atributeOut, dgVector& normalOut, dgFloat32 maxT) const;
+	void DebugCollisionCells (const dgMatrix& matrix, const dgHeightFieldPage& page, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const;
 
 	virtual void Serialize(dgSerialize callback, void* const userData) const;
 	virtual dgFloat32 RayCast (const dgVector& localP0, const dgVector& localP1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const;
@@ -125,6 +223,30 @@ class dgCollisionHeightField: public dgCollisionMesh
 	dgCollisionHeightFieldRayCastCallback m_userRayCastCallback;
 	dgElevationType m_elevationDataType;
 
+	// min and max scaled elevation of blocks of cells, level zero blocks are DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE cells wide
+	// and each level above merges two by two blocks of the level below, up to a single block that covers the whole grid.
+	dgElevationRange* m_elevationPyramid;
+	dgInt32 m_pyramidLevelsCount;
+	dgInt32 m_pyramidLevelOffset[DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS];
+	dgInt32 m_pyramidLevelWidth[DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS];
+	dgInt32 m_pyramidLevelHeight[DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS];
+
+	// tiled height fields only keep the pyramid levels at and above the tile level, the levels below are part of each tile page.
+	// flat height fields are a single page and their tile level is zero.
+	dgHeightFieldPage m_mapPage;
+	dgHeightFieldTileSlot* m_tiles;
+	mutable dgList<dgHeightFieldTile*> m_residentTiles;
+	mutable dgThread::dgCriticalSection m_tileLock;
+	dgCollisionHeightFieldPageInCallback m_pageInCallback;
+	void* m_pageInUserData;
+	dgInt32 m_tileSize;
+	dgInt32 m_tileLevel;
+	dgInt32 m_tilesCount_x;
+	dgInt32 m_tilesCount_z;
+	dgInt32 m_maxResidentTiles;
+	dgInt32 m_tilePageSize;
+	dgInt32 m_tilePyramidOffset[DG_HEIGHTFIELD_PYRAMID_MAX_LEVELS];
+	bool m_memoryImage;
 	
 	static dgVector m_yMask;
 	static dgVector m_padding;
@@ -25,78 +25,196 @@
 #include "dgContact.h"
 #include "dgMeshEffect.h"
 #include "dgDynamicBody.h"
+#include "dgCollisionInstance.h"
 #include "dgCollisionIncompressibleParticles.h"
 
 
-dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(dgWorld* const world, dgMeshEffect* const mesh)
-	:dgCollisionLumpedMassParticles(world, m_deformableSolidMesh)
+// particles are spaced at two radius, and the smoothing kernel covers two particle spacings
+#define DG_FLUID_KERNEL_RADIUS_SCALE		dgFloat32 (4.0f)
+#define DG_FLUID_MIN_NEIGHBORS				48
+#define DG_FLUID_PARTICLES_BATCH			128
+#define DG_FLUID_SOLVER_ITERATIONS			4
+#define DG_FLUID_VISCOSITY					dgFloat32 (0.01f)
+#define DG_FLUID_RELAXATION					dgFloat32 (0.01f)
+#define DG_FLUID_TENSILE_COEFFICIENT		dgFloat32 (0.01f)
+#define DG_FLUID_TENSILE_DISTANCE			dgFloat32 (0.2f)
+#define DG_FLUID_BOUNDARY_SKIN				dgFloat32 (0.5f)
+#define DG_FLUID_SENTINEL_DISTANCE			dgFloat32 (1.0e10f)
+
+
+class dgCollisionIncompressibleParticles::dgSolverDescriptor
 {
-	m_rtti |= dgCollisionIncompressibleParticles_RTTI;
+	public:
+	dgCollisionIncompressibleParticles* m_me;
+	dgVector* m_posit;
+	dgVector* m_predicted;
+	dgVector m_externalAccel;
+	dgVector m_origin;
+	dgVector m_invCellSize;
+	dgFloat32 m_timestep;
+	dgFloat32 m_invTimestep;
+	dgFloat32 m_kernelRadius;
+	dgFloat32 m_kernelRadius2;
+	dgFloat32 m_poly6;
+	dgFloat32 m_spikyGrad;
+	dgFloat32 m_massDensity;
+	dgFloat32 m_tensileScale;
+	dgFloat32 m_invTensileWeight;
+	dgInt32 m_atomicIndex;
+	dgInt32 m_threadCount;
+	dgInt32 m_neighborsOverflow;
 
-/*
-	dgInt32 count = mesh->GetVertexCount();
-	dgVector* const points = dgAlloca(dgVector, count);
+	// per thread reductions of the final particle state
+	dgVector* m_minBox;
+	dgVector* m_maxBox;
+	dgVector* m_momentum;
+	dgVector* m_positSum;
+	dgVector* m_maxAccel;
+};
 
-	for (dgInt32 i = 0; i < count; i++) {
-		dgBigVector p(mesh->GetVertex(i));
-		points[i] = p;
-	}
 
-	m_indexToVertexCount = count;
-	m_indexToVertexMap.Resize(count);
-	dgInt32* const indexToVertexMap = &m_indexToVertexMap[0];
-	m_particlesCount = dgVertexListToIndexList(&points[0].m_x, sizeof(dgVector), 3 * sizeof(dgFloat32), 0, count, indexToVertexMap, dgFloat32(1.0e-5f));
-	for (dgInt32 i = 0; i < m_particlesCount; i++) {
-		m_posit[i] = points[i];
-	}
+DG_INLINE dgInt32 dgFluidCellHash (dgInt32 x, dgInt32 y, dgInt32 z, dgInt32 mask)
+{
+	const dgUnsigned32 key = (dgUnsigned32 (x) * 73856093u) ^ (dgUnsigned32 (y) * 19349663u) ^ (dgUnsigned32 (z) * 83492791u);
+	return dgInt32 (key & dgUnsigned32 (mask));
+}
 
+DG_INLINE dgFloat32 dgFluidPoly6 (dgFloat32 r2, dgFloat32 h)
+{
+	dgFloat32 q = dgMax (h * h - r2, dgFloat32 (0.0f));
+	return dgFloat32 (315.0f / 64.0f) / (dgPI * dgPow (h, dgFloat32 (9.0f))) * q * q * q;
+}
 
-	dgInt32 edgeCount = 0;
-	dgSoftLink* const links = dgAlloca(dgSoftLink, mesh->GetCount() / 2);
-	for (void* edgePtr = mesh->GetFirstEdge(); edgePtr; edgePtr = mesh->GetNextEdge(edgePtr)) {
-		const dgEdge* const edge = mesh->GetPolyhedraEdgeFromNode(edgePtr);
+DG_INLINE dgFloat32 dgFluidSpikyGradient (dgFloat32 r, dgFloat32 h)
+{
+	dgFloat32 q = dgMax (h - r, dgFloat32 (0.0f));
+	return dgFloat32 (-45.0f) / (dgPI * dgPow (h, dgFloat32 (6.0f))) * q * q;
+}
 
-		dgInt32 v0 = indexToVertexMap[edge->m_incidentVertex];
-		dgInt32 v1 = indexToVertexMap[edge->m_twin->m_incidentVertex];
-		links[edgeCount].m_m0 = dgInt16(dgMin(v0, v1));
-		links[edgeCount].m_m1 = dgInt16(dgMax(v0, v1));
-		edgeCount++;
-		if ((edge->m_incidentFace > 0) && (edge->m_twin->m_incidentFace > 0)) {
-			v0 = indexToVertexMap[edge->m_prev->m_incidentVertex];
-			v1 = indexToVertexMap[edge->m_twin->m_prev->m_incidentVertex];
-			links[edgeCount].m_m0 = dgInt16(dgMin(v0, v1));
-			links[edgeCount].m_m1 = dgInt16(dgMax(v0, v1));
-			edgeCount++;
-		}
-	}
-	dgSort(links, edgeCount, CompareEdges);
 
-	dgInt32 uniqueEdgeCount = 0;
-	for (dgInt32 i = 1; i < edgeCount; i++) {
-		if (CompareEdges(&links[i], &links[uniqueEdgeCount], NULL) > 0) {
-			uniqueEdgeCount++;
-			links[uniqueEdgeCount] = links[i];
+dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(dgWorld* const world, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity)
+	:dgCollisionLumpedMassParticles(world, m_deformableSolidMesh)
+	,m_predictedPosit0(world->GetAllocator())
+	,m_predictedPosit1(world->GetAllocator())
+	,m_tmpVeloc(world->GetAllocator())
+	,m_lambda(world->GetAllocator())
+	,m_cellKey(world->GetAllocator())
+	,m_cellStart(world->GetAllocator())
+	,m_cellParticles(world->GetAllocator())
+	,m_neighbors(world->GetAllocator())
+	,m_neighborsCount(world->GetAllocator())
+	,m_boundaryBodies(world->GetAllocator())
+	,m_boundaryImpulse(world->GetAllocator())
+	,m_boundaryLock()
+	,m_restDensity(restDensity)
+	,m_particleMass(dgFloat32 (1.0f))
+	,m_kernelRadius(DG_FLUID_KERNEL_RADIUS_SCALE * particleRadius)
+	,m_relaxation(dgFloat32 (1.0f))
+	,m_viscosity(DG_FLUID_VISCOSITY)
+	,m_solverIterations(DG_FLUID_SOLVER_ITERATIONS)
+	,m_boundaryBodiesCount(0)
+	,m_hashSize(0)
+	,m_neighborsStride(DG_FLUID_MIN_NEIGHBORS)
+{
+	m_rtti |= dgCollisionIncompressibleParticles_RTTI;
+	dgAssert (particleRadius > dgFloat32 (0.0f));
+	dgAssert (restDensity > dgFloat32 (0.0f));
+
+	// the particle mass is the one that makes a particle at rest in a cubic lattice 
+	// have exactly the rest density, the same lattice gives the scale of the constraint gradients
+	const dgFloat32 h = m_kernelRadius;
+	const dgFloat32 spacing = dgFloat32 (2.0f) * particleRadius;
+	const dgInt32 steps = dgInt32 (h / spacing) + 1;
+	dgFloat32 kernelSum = dgFloat32 (0.0f);
+	dgFloat32 gradientSum2 = dgFloat32 (0.0f);
+	for (dgInt32 z = -steps; z <= steps; z ++) {
+		for (dgInt32 y = -steps; y <= steps; y ++) {
+			for (dgInt32 x = -steps; x <= steps; x ++) {
+				dgVector p (dgFloat32 (x) * spacing, dgFloat32 (y) * spacing, dgFloat32 (z) * spacing, dgFloat32 (0.0f));
+				const dgFloat32 r2 = p.DotProduct3(p);
+				if (r2 < h * h) {
+					kernelSum += dgFluidPoly6 (r2, h);
+					if (r2 > dgFloat32 (0.0f)) {
+						const dgFloat32 grad = dgFluidSpikyGradient (dgSqrt (r2), h);
+						gradientSum2 += grad * grad;
+					}
+				}
+			}
 		}
 	}
-	uniqueEdgeCount++;
-	m_linksCount = uniqueEdgeCount;
-	m_linkList.Resize(m_linksCount);
-	for (dgInt32 i = 0; i < m_linksCount; i++) {
-		m_linkList[i] = links[i];
+	const dgFloat32 massDensity = dgFloat32 (1.0f) / kernelSum;
+	m_particleMass = restDensity * massDensity;
+	m_relaxation = DG_FLUID_RELAXATION * massDensity * massDensity * gradientSum2;
+
+	m_particlesCount = pointCount;
+	m_particleRadius = particleRadius;
+	m_posit.Resize(m_particlesCount);
+	m_mass.Resize(m_particlesCount);
+	m_invMass.Resize(m_particlesCount);
+	const dgInt32 stride = strideInBytes / sizeof (dgFloat32);
+	m_totalMass = dgFloat32(0.0f);
+	for (dgInt32 i = 0; i < pointCount; i++) {
+		m_totalMass += m_particleMass;
+		m_mass[i] = m_particleMass;
+		m_invMass[i] = dgFloat32(1.0f) / m_particleMass;
+		m_posit[i] = dgVector(points[i * stride + 0], points[i * stride + 1], points[i * stride + 2], dgFloat32(0.0f));
 	}
+
 	FinalizeBuild();
-*/
+	ResizeSolverBuffers ();
 }
 
-
 dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(const dgCollisionIncompressibleParticles& source)
 	:dgCollisionLumpedMassParticles(source)
+	,m_predictedPosit0(source.m_allocator)
+	,m_predictedPosit1(source.m_allocator)
+	,m_tmpVeloc(source.m_allocator)
+	,m_lambda(source.m_allocator)
+	,m_cellKey(source.m_allocator)
+	,m_cellStart(source.m_allocator)
+	,m_cellParticles(source.m_allocator)
+	,m_neighbors(source.m_allocator)
+	,m_neighborsCount(source.m_allocator)
+	,m_boundaryBodies(source.m_allocator)
+	,m_boundaryImpulse(source.m_allocator)
+	,m_boundaryLock()
+	,m_restDensity(source.m_restDensity)
+	,m_particleMass(source.m_particleMass)
+	,m_kernelRadius(source.m_kernelRadius)
+	,m_relaxation(source.m_relaxation)
+	,m_viscosity(source.m_viscosity)
+	,m_solverIterations(source.m_solverIterations)
+	,m_boundaryBodiesCount(0)
+	,m_hashSize(0)
+	,m_neighborsStride(DG_FLUID_MIN_NEIGHBORS)
 {
 	m_rtti |= source.m_rtti;
+	ResizeSolverBuffers ();
 }
 
 dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollisionLumpedMassParticles(world, deserialization, userData, revisionNumber)
+	,m_predictedPosit0(world->GetAllocator())
+	,m_predictedPosit1(world->GetAllocator())
+	,m_tmpVeloc(world->GetAllocator())
+	,m_lambda(world->GetAllocator())
+	,m_cellKey(world->GetAllocator())
+	,m_cellStart(world->GetAllocator())
+	,m_cellParticles(world->GetAllocator())
+	,m_neighbors(world->GetAllocator())
+	,m_neighborsCount(world->GetAllocator())
+	,m_boundaryBodies(world->GetAllocator())
+	,m_boundaryImpulse(world->GetAllocator())
+	,m_boundaryLock()
+	,m_restDensity(dgFloat32 (1.0f))
+	,m_particleMass(dgFloat32 (1.0f))
+	,m_kernelRadius(DG_FLUID_KERNEL_RADIUS_SCALE * m_particleRadius)
+	,m_relaxation(dgFloat32 (1.0f))
+	,m_viscosity(DG_FLUID_VISCOSITY)
+	,m_solverIterations(DG_FLUID_SOLVER_ITERATIONS)
+	,m_boundaryBodiesCount(0)
+	,m_hashSize(0)
+	,m_neighborsStride(DG_FLUID_MIN_NEIGHBORS)
 {
 }
 
@@ -104,8 +222,660 @@ dgCollisionIncompressibleParticles::~dgCollisionIncompressibleParticles(void)
 {
 }
 
+void dgCollisionIncompressibleParticles::SetSolverParameters (dgInt32 iterations, dgFloat32 viscosity)
+{
+	m_solverIterations = dgMax (iterations, 1);
+	m_viscosity = dgClamp (viscosity, dgFloat32 (0.0f), dgFloat32 (1.0f));
+}
+
+dgInt32 dgCollisionIncompressibleParticles::GetMemoryBufferSizeInBytes() const
+{
+	dgInt32 sizeInByte = 0;
+	sizeInByte += 3 * (m_particlesCount + 1) * sizeof (dgVector);
+	sizeInByte += 1 * (m_particlesCount + 1) * sizeof (dgFloat32);
+	sizeInByte += (m_neighborsStride + 3) * m_particlesCount * sizeof (dgInt32);
+	sizeInByte += (m_hashSize + 1) * sizeof (dgInt32);
+	return sizeInByte;
+}
+
+void dgCollisionIncompressibleParticles::ResizeSolverBuffers ()
+{
+	// one extra particle far away from everything pads the neighbor lists to a multiple of four
+	const dgInt32 count = m_particlesCount + 1;
+	m_hashSize = 1;
+	while (m_hashSize < 2 * m_particlesCount) {
+		m_hashSize *= 2;
+	}
+	m_predictedPosit0.Resize(count);
+	m_predictedPosit1.Resize(count);
+	m_tmpVeloc.Resize(count);
+	m_lambda.Resize(count);
+	m_cellKey.Resize(count);
+	m_cellParticles.Resize(count);
+	m_cellStart.Resize(m_hashSize + 1);
+	m_neighborsCount.Resize(count);
+	m_neighbors.Resize(count * m_neighborsStride);
+
+	const dgVector sentinel (DG_FLUID_SENTINEL_DISTANCE, DG_FLUID_SENTINEL_DISTANCE, DG_FLUID_SENTINEL_DISTANCE, dgFloat32 (0.0f));
+	m_predictedPosit0[m_particlesCount] = sentinel;
+	m_predictedPosit1[m_particlesCount] = sentinel;
+	m_tmpVeloc[m_particlesCount] = dgVector::m_zero;
+	m_lambda[m_particlesCount] = dgFloat32 (0.0f);
+}
+
+void dgCollisionIncompressibleParticles::RegisterCollision(const dgBody* const otherBody)
+{
+	// called from the broad phase worker threads for every body overlapping the fluid volume
+	if (!otherBody->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
+		dgWorld* const world = m_body->GetWorld();
+		dgThreadHiveScopeLock lock (world, &m_boundaryLock, false);
+		m_boundaryBodies[m_boundaryBodiesCount] = otherBody;
+		m_boundaryBodiesCount ++;
+		if (!otherBody->m_state->m_equilibrium) {
+			m_body->m_state->m_sleeping = false;
+			m_body->m_state->m_equilibrium = false;
+			world->WakeUpIsland(m_body);
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::DispatchKernel (dgWorkerThreadTaskCallback kernel, dgSolverDescriptor& descriptor) const
+{
+	dgWorld* const world = m_body->GetWorld();
+	descriptor.m_atomicIndex = 0;
+	for (dgInt32 i = 0; i < descriptor.m_threadCount; i ++) {
+		world->QueueJob (kernel, &descriptor, world);
+	}
+	world->SynchronizationBarrier();
+}
+
+void dgCollisionIncompressibleParticles::BuildSpatialHash (dgSolverDescriptor& descriptor)
+{
+	// counting sort of the particles by cell key, buckets keep the particles in index order
+	const dgInt32* const cellKey = &m_cellKey[0];
+	dgInt32* const cellStart = &m_cellStart[0];
+	dgInt32* const cellParticles = &m_cellParticles[0];
+
+	memset (cellStart, 0, (m_hashSize + 1) * sizeof (dgInt32));
+	for (dgInt32 i = 0; i < m_particlesCount; i ++) {
+		cellStart[cellKey[i]] ++;
+	}
+	dgInt32 acc = 0;
+	for (dgInt32 i = 0; i < m_hashSize; i ++) {
+		acc += cellStart[i];
+		cellStart[i] = acc;
+	}
+	cellStart[m_hashSize] = m_particlesCount;
+	for (dgInt32 i = m_particlesCount - 1; i >= 0; i --) {
+		const dgInt32 key = cellKey[i];
+		cellStart[key] --;
+		cellParticles[cellStart[key]] = i;
+	}
+
+	descriptor.m_neighborsOverflow = 0;
+	DispatchKernel (CalculateNeighborsKernel, descriptor);
+	if (descriptor.m_neighborsOverflow) {
+		// some particle has more neighbors than the lists can hold, 
+		// grow the lists to the largest count found and search again
+		m_neighborsStride = descriptor.m_neighborsOverflow;
+		m_neighbors.Resize((m_particlesCount + 1) * m_neighborsStride);
+		descriptor.m_neighborsOverflow = 0;
+		DispatchKernel (CalculateNeighborsKernel, descriptor);
+		dgAssert (!descriptor.m_neighborsOverflow);
+	}
+}
+
+void dgCollisionIncompressibleParticles::PredictPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	const dgVector* const posit = &me->m_posit[0];
+	dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const predicted = descriptor->m_predicted;
+	dgInt32* const cellKey = &me->m_cellKey[0];
+	const dgVector timestep (descriptor->m_timestep);
+	const dgVector accel (descriptor->m_externalAccel * timestep);
+	const dgInt32 mask = me->m_hashSize - 1;
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			veloc[j] += accel;
+			predicted[j] = posit[j] + veloc[j] * timestep;
+			const dgVector cell ((predicted[j] * descriptor->m_invCellSize).Floor());
+			cellKey[j] = dgFluidCellHash (dgInt32 (cell.m_x), dgInt32 (cell.m_y), dgInt32 (cell.m_z), mask);
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::CalculateNeighborsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	const dgVector* const predicted = descriptor->m_predicted;
+	const dgInt32* const cellStart = &me->m_cellStart[0];
+	const dgInt32* const cellParticles = &me->m_cellParticles[0];
+	dgInt32* const neighborsArray = &me->m_neighbors[0];
+	dgInt32* const neighborsCount = &me->m_neighborsCount[0];
+	const dgFloat32 h2 = descriptor->m_kernelRadius2;
+	const dgInt32 mask = me->m_hashSize - 1;
+	const dgInt32 stride = me->m_neighborsStride;
+	const dgInt32 particlesCount = me->m_particlesCount;
+	dgInt32 overflow = 0;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgVector p (predicted[j]);
+			const dgVector cell ((p * descriptor->m_invCellSize).Floor());
+			const dgInt32 x0 = dgInt32 (cell.m_x);
+			const dgInt32 y0 = dgInt32 (cell.m_y);
+			const dgInt32 z0 = dgInt32 (cell.m_z);
+
+			dgInt32 keysCount = 0;
+			dgInt32 keys[27];
+			dgInt32 neighborCount = 0;
+			dgInt32* const neighbors = &neighborsArray[j * stride];
+			for (dgInt32 z = z0 - 1; z <= z0 + 1; z ++) {
+				for (dgInt32 y = y0 - 1; y <= y0 + 1; y ++) {
+					for (dgInt32 x = x0 - 1; x <= x0 + 1; x ++) {
+						// different cells can hash to the same bucket, only visit each bucket once
+						const dgInt32 key = dgFluidCellHash (x, y, z, mask);
+						bool visited = false;
+						for (dgInt32 k = 0; k < keysCount; k ++) {
+							visited |= (keys[k] == key);
+						}
+						if (!visited) {
+							keys[keysCount] = key;
+							keysCount ++;
+							const dgInt32 end = cellStart[key + 1];
+							for (dgInt32 k = cellStart[key]; k < end; k ++) {
+								const dgInt32 index = cellParticles[k];
+								const dgVector dist (predicted[index] - p);
+								if ((index != j) && (dist.DotProduct3(dist) < h2)) {
+									// keep counting past the end of the list so that the caller knows how much to grow it
+									if (neighborCount < stride) {
+										neighbors[neighborCount] = index;
+									}
+									neighborCount ++;
+								}
+							}
+						}
+					}
+				}
+			}
+			if (neighborCount > stride) {
+				overflow = dgMax (overflow, (neighborCount + 3) & -4);
+				neighborCount = stride;
+			}
+			while (neighborCount & 3) {
+				neighbors[neighborCount] = particlesCount;
+				neighborCount ++;
+			}
+			neighborsCount[j] = neighborCount;
+		}
+	}
+
+	if (overflow) {
+		dgInt32 largest = descriptor->m_neighborsOverflow;
+		while (largest < overflow) {
+			const dgInt32 value = dgInterlockedCompareExchange (&descriptor->m_neighborsOverflow, overflow, largest);
+			if (value == largest) {
+				break;
+			}
+			largest = value;
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::SolveBoundaryKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	const dgVector* const posit = &me->m_posit[0];
+	dgVector* const predicted = descriptor->m_predicted;
+	const dgInt32 bodiesCount = me->m_boundaryBodiesCount;
+	const dgBody** const bodies = &me->m_boundaryBodies[0];
+	dgVector* const impulses = &me->m_boundaryImpulse[threadID * bodiesCount * 2];
+	const dgVector origin (descriptor->m_origin);
+	const dgVector particleImpulse (me->m_particleMass * descriptor->m_invTimestep);
+	const dgVector timestep (descriptor->m_timestep);
+	const dgFloat32 skin = me->m_particleRadius * DG_FLUID_BOUNDARY_SKIN;
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			// a second pass resolves particles pushed from one boundary into another, like at container corners
+			const dgVector p0 (origin + posit[j]);
+			bool corrected = true;
+			for (dgInt32 pass = 0; (pass < 2) && corrected; pass ++) {
+				corrected = false;
+				for (dgInt32 k = 0; k < bodiesCount; k ++) {
+					const dgBody* const body = bodies[k];
+					const dgVector p1 (origin + predicted[j]);
+					// bodies were already integrated, so the sweep starts from where the particle was relative to the moving body
+					const dgVector q0 ((p0 + body->GetVelocityAtPoint(p0) * timestep) & dgVector::m_triplexMask);
+					const dgVector step (p1 - q0);
+					const dgFloat32 step2 = step.DotProduct3(step);
+					if (step2 < dgFloat32 (1.0e-12f)) {
+						continue;
+					}
+					// the sweep is extended by the skin so that particles landing right on a surface are also caught
+					const dgVector p2 (p1 + step.Scale4 (skin / dgSqrt (step2)));
+					const dgVector boxP0 (q0.GetMin(p2));
+					const dgVector boxP1 (q0.GetMax(p2));
+					if (dgOverlapTest (boxP0, boxP1, body->m_state->m_minAABB, body->m_state->m_maxAABB)) {
+						// sweep the particle from its last valid position, and project it out along the surface normal 
+						dgContactPoint contact;
+						const dgCollisionInstance* const collision = body->m_collision;
+						const dgMatrix& matrix = collision->GetGlobalMatrix();
+						const dgVector localP0 (matrix.UntransformVector(q0) & dgVector::m_triplexMask);
+						const dgVector localP2 (matrix.UntransformVector(p2) & dgVector::m_triplexMask);
+						const dgFloat32 t = collision->RayCast (localP0, localP2, dgFloat32 (1.0f), contact, NULL, body, NULL);
+						if (t < dgFloat32 (1.0f)) {
+							const dgVector normal (matrix.RotateVector(contact.m_normal) & dgVector::m_triplexMask);
+							const dgVector point (q0 + (p2 - q0).Scale4 (t));
+							const dgFloat32 penetration = normal.DotProduct3(p1 - point) - skin;
+							if (penetration < dgFloat32 (0.0f)) {
+								const dgVector correction (normal.Scale4 (-penetration));
+								predicted[j] += correction;
+								corrected = true;
+
+								const dgVector impulse (correction * particleImpulse);
+								impulses[k * 2 + 0] -= impulse;
+								impulses[k * 2 + 1] -= (point - body->m_globalCentreOfMass).CrossProduct3(impulse);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::CalculateLambdaKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	const dgVector* const predicted = descriptor->m_predicted;
+	const dgInt32* const neighborsArray = &me->m_neighbors[0];
+	const dgInt32* const neighborsCount = &me->m_neighborsCount[0];
+	dgFloat32* const lambda = &me->m_lambda[0];
+
+	const dgVector h (descriptor->m_kernelRadius);
+	const dgVector h2 (descriptor->m_kernelRadius2);
+	const dgVector spiky (descriptor->m_spikyGrad);
+	const dgVector minDist (descriptor->m_kernelRadius * dgFloat32 (1.0e-4f));
+	const dgFloat32 massDensity = descriptor->m_massDensity;
+	const dgFloat32 selfDensity = descriptor->m_poly6 * descriptor->m_kernelRadius2 * descriptor->m_kernelRadius2 * descriptor->m_kernelRadius2;
+	const dgInt32 stride = me->m_neighborsStride;
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgVector p (predicted[j]);
+			const dgVector px (p.BroadcastX());
+			const dgVector py (p.BroadcastY());
+			const dgVector pz (p.BroadcastZ());
+			dgVector density (dgVector::m_zero);
+			dgVector gradX (dgVector::m_zero);
+			dgVector gradY (dgVector::m_zero);
+			dgVector gradZ (dgVector::m_zero);
+			dgVector gradMag2 (dgVector::m_zero);
+
+			// evaluate four neighbors at a time in structure of array form
+			const dgInt32* const neighbors = &neighborsArray[j * stride];
+			for (dgInt32 k = 0; k < neighborsCount[j]; k += 4) {
+				dgVector x;
+				dgVector y;
+				dgVector z;
+				dgVector w;
+				dgVector::Transpose4x4 (x, y, z, w, predicted[neighbors[k + 0]], predicted[neighbors[k + 1]], predicted[neighbors[k + 2]], predicted[neighbors[k + 3]]);
+				const dgVector dx (px - x);
+				const dgVector dy (py - y);
+				const dgVector dz (pz - z);
+				const dgVector r2 (dx * dx + dy * dy + dz * dz);
+				const dgVector mask (r2 < h2);
+				const dgVector q ((h2 - r2) & mask);
+				const dgVector r ((r2 & mask).Sqrt());
+				const dgVector hr ((h - r) & mask);
+				const dgVector scale ((spiky * hr * hr * r.GetMax(minDist).Reciproc()) & mask);
+				density += q * q * q;
+				gradX += dx * scale;
+				gradY += dy * scale;
+				gradZ += dz * scale;
+				gradMag2 += scale * scale * r2;
+			}
+
+			const dgFloat32 rho = massDensity * (descriptor->m_poly6 * density.AddHorizontal().GetScalar() + selfDensity);
+			const dgFloat32 constraint = dgMax (rho - dgFloat32 (1.0f), dgFloat32 (0.0f));
+			const dgFloat32 gx = gradX.AddHorizontal().GetScalar();
+			const dgFloat32 gy = gradY.AddHorizontal().GetScalar();
+			const dgFloat32 gz = gradZ.AddHorizontal().GetScalar();
+			const dgFloat32 den = massDensity * massDensity * (gradMag2.AddHorizontal().GetScalar() + gx * gx + gy * gy + gz * gz) + me->m_relaxation;
+			lambda[j] = -constraint / den;
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::SolveDensityKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	const dgVector* const predicted = descriptor->m_posit;
+	dgVector* const output = descriptor->m_predicted;
+	const dgInt32* const neighborsArray = &me->m_neighbors[0];
+	const dgInt32* const neighborsCount = &me->m_neighborsCount[0];
+	const dgFloat32* const lambda = &me->m_lambda[0];
+
+	const dgVector h (descriptor->m_kernelRadius);
+	const dgVector h2 (descriptor->m_kernelRadius2);
+	const dgVector spiky (descriptor->m_spikyGrad);
+	const dgVector minDist (descriptor->m_kernelRadius * dgFloat32 (1.0e-4f));
+	const dgVector tensileWeight (descriptor->m_poly6 * descriptor->m_invTensileWeight);
+	const dgVector tensileScale (descriptor->m_tensileScale);
+	const dgFloat32 massDensity = descriptor->m_massDensity;
+	const dgInt32 stride = me->m_neighborsStride;
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgVector p (predicted[j]);
+			const dgVector px (p.BroadcastX());
+			const dgVector py (p.BroadcastY());
+			const dgVector pz (p.BroadcastZ());
+			const dgVector lambda0 (lambda[j]);
+			dgVector deltaX (dgVector::m_zero);
+			dgVector deltaY (dgVector::m_zero);
+			dgVector deltaZ (dgVector::m_zero);
+
+			const dgInt32* const neighbors = &neighborsArray[j * stride];
+			for (dgInt32 k = 0; k < neighborsCount[j]; k += 4) {
+				dgVector x;
+				dgVector y;
+				dgVector z;
+				dgVector w;
+				dgVector::Transpose4x4 (x, y, z, w, predicted[neighbors[k + 0]], predicted[neighbors[k + 1]], predicted[neighbors[k + 2]], predicted[neighbors[k + 3]]);
+				const dgVector lambda1 (lambda[neighbors[k + 0]], lambda[neighbors[k + 1]], lambda[neighbors[k + 2]], lambda[neighbors[k + 3]]);
+				const dgVector dx (px - x);
+				const dgVector dy (py - y);
+				const dgVector dz (pz - z);
+				const dgVector r2 (dx * dx + dy * dy + dz * dz);
+				const dgVector mask (r2 < h2);
+				const dgVector q ((h2 - r2) & mask);
+				const dgVector r ((r2 & mask).Sqrt());
+				const dgVector hr ((h - r) & mask);
+				const dgVector scale ((spiky * hr * hr * r.GetMax(minDist).Reciproc()) & mask);
+
+				// artificial pressure term that keeps particles from clumping at the free surface
+				const dgVector weight (tensileWeight * q * q * q);
+				const dgVector weight2 (weight * weight);
+				const dgVector tensile (tensileScale * weight2 * weight2);
+				const dgVector factor ((lambda0 + lambda1 - tensile) * scale);
+				deltaX += dx * factor;
+				deltaY += dy * factor;
+				deltaZ += dz * factor;
+			}
+			const dgVector delta (deltaX.AddHorizontal().GetScalar(), deltaY.AddHorizontal().GetScalar(), deltaZ.AddHorizontal().GetScalar(), dgFloat32 (0.0f));
+			output[j] = p + delta.Scale4 (massDensity);
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::UpdateVelocityKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	const dgVector* const posit = &me->m_posit[0];
+	const dgVector* const predicted = descriptor->m_predicted;
+	dgVector* const tmpVeloc = &me->m_tmpVeloc[0];
+	const dgVector invTimestep (descriptor->m_invTimestep);
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			tmpVeloc[j] = (predicted[j] - posit[j]) * invTimestep;
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::ApplyViscosityKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	dgVector* const posit = &me->m_posit[0];
+	dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const accel = &me->m_accel[0];
+	const dgVector* const predicted = descriptor->m_predicted;
+	const dgVector* const tmpVeloc = &me->m_tmpVeloc[0];
+	const dgInt32* const neighborsArray = &me->m_neighbors[0];
+	const dgInt32* const neighborsCount = &me->m_neighborsCount[0];
+
+	const dgVector h2 (descriptor->m_kernelRadius2);
+	const dgVector invTimestep (descriptor->m_invTimestep);
+	const dgVector viscosity (me->m_viscosity * descriptor->m_massDensity * descriptor->m_poly6);
+
+	dgVector minBox (descriptor->m_minBox[threadID]);
+	dgVector maxBox (descriptor->m_maxBox[threadID]);
+	dgVector momentum (descriptor->m_momentum[threadID]);
+	dgVector positSum (descriptor->m_positSum[threadID]);
+	dgVector maxAccel (descriptor->m_maxAccel[threadID]);
+	const dgInt32 stride = me->m_neighborsStride;
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgVector p (predicted[j]);
+			const dgVector v (tmpVeloc[j]);
+			const dgVector px (p.BroadcastX());
+			const dgVector py (p.BroadcastY());
+			const dgVector pz (p.BroadcastZ());
+			const dgVector vx (v.BroadcastX());
+			const dgVector vy (v.BroadcastY());
+			const dgVector vz (v.BroadcastZ());
+			dgVector dampX (dgVector::m_zero);
+			dgVector dampY (dgVector::m_zero);
+			dgVector dampZ (dgVector::m_zero);
+
+			const dgInt32* const neighbors = &neighborsArray[j * stride];
+			for (dgInt32 k = 0; k < neighborsCount[j]; k += 4) {
+				dgVector x;
+				dgVector y;
+				dgVector z;
+				dgVector w;
+				dgVector::Transpose4x4 (x, y, z, w, predicted[neighbors[k + 0]], predicted[neighbors[k + 1]], predicted[neighbors[k + 2]], predicted[neighbors[k + 3]]);
+				const dgVector dx (px - x);
+				const dgVector dy (py - y);
+				const dgVector dz (pz - z);
+				const dgVector r2 (dx * dx + dy * dy + dz * dz);
+				const dgVector q ((h2 - r2) & (r2 < h2));
+				const dgVector weight (q * q * q);
+
+				dgVector::Transpose4x4 (x, y, z, w, tmpVeloc[neighbors[k + 0]], tmpVeloc[neighbors[k + 1]], tmpVeloc[neighbors[k + 2]], tmpVeloc[neighbors[k + 3]]);
+				dampX += (x - vx) * weight;
+				dampY += (y - vy) * weight;
+				dampZ += (z - vz) * weight;
+			}
+			const dgVector damp (dampX.AddHorizontal().GetScalar(), dampY.AddHorizontal().GetScalar(), dampZ.AddHorizontal().GetScalar(), dgFloat32 (0.0f));
+			const dgVector newVeloc (v + damp * viscosity);
+			const dgVector particleAccel ((newVeloc - veloc[j]) * invTimestep);
+
+			accel[j] = particleAccel;
+			veloc[j] = newVeloc;
+			posit[j] = p;
+
+			minBox = minBox.GetMin(p);
+			maxBox = maxBox.GetMax(p);
+			momentum += newVeloc;
+			positSum += p;
+			const dgVector accelMask (particleAccel.DotProduct4(particleAccel) > maxAccel.DotProduct4(maxAccel));
+			maxAccel = (particleAccel & accelMask) | maxAccel.AndNot(accelMask);
+		}
+	}
+	descriptor->m_minBox[threadID] = minBox;
+	descriptor->m_maxBox[threadID] = maxBox;
+	descriptor->m_momentum[threadID] = momentum;
+	descriptor->m_positSum[threadID] = positSum;
+	descriptor->m_maxAccel[threadID] = maxAccel;
+}
+
+void dgCollisionIncompressibleParticles::TranslateParticlesKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionIncompressibleParticles* const me = descriptor->m_me;
+	dgVector* const posit = &me->m_posit[0];
+	const dgVector translation (descriptor->m_origin);
+	const dgInt32 particlesCount = me->m_particlesCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_FLUID_PARTICLES_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_FLUID_PARTICLES_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			posit[j] -= translation;
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::ApplyBoundaryImpulses (dgSolverDescriptor& descriptor) const
+{
+	const dgInt32 bodiesCount = m_boundaryBodiesCount;
+	const dgVector* const impulses = &m_boundaryImpulse[0];
+	for (dgInt32 i = 0; i < bodiesCount; i ++) {
+		dgBody* const body = (dgBody*) m_boundaryBodies[i];
+		if (body->GetInvMass().m_w > dgFloat32 (0.0f)) {
+			dgVector linearImpulse (dgVector::m_zero);
+			dgVector angularImpulse (dgVector::m_zero);
+			for (dgInt32 j = 0; j < descriptor.m_threadCount; j ++) {
+				linearImpulse += impulses[(j * bodiesCount + i) * 2 + 0];
+				angularImpulse += impulses[(j * bodiesCount + i) * 2 + 1];
+			}
+			if (linearImpulse.DotProduct3(linearImpulse) > dgFloat32 (0.0f)) {
+				body->ApplyImpulsePair (linearImpulse & dgVector::m_triplexMask, angularImpulse & dgVector::m_triplexMask, descriptor.m_timestep);
+			}
+		}
+	}
+}
 
 void dgCollisionIncompressibleParticles::CalculateAcceleration(dgFloat32 timestep)
 {
-	dgAssert(0);
+	// position based incompressible fluid: predict, find neighbors on a spatial hash, 
+	// iterate density constraints with boundary projection, and derive velocities from positions
+	dgWorld* const world = m_body->GetWorld();
+	const dgFloat32 h = m_kernelRadius;
+
+	dgSolverDescriptor descriptor;
+	descriptor.m_me = this;
+	descriptor.m_posit = &m_predictedPosit1[0];
+	descriptor.m_predicted = &m_predictedPosit0[0];
+	descriptor.m_externalAccel = (m_body->m_externalForce * dgVector(m_body->m_invMass.m_w)) & dgVector::m_triplexMask;
+	descriptor.m_origin = m_body->GetCollision()->GetGlobalMatrix().m_posit & dgVector::m_triplexMask;
+	descriptor.m_invCellSize = dgVector (dgFloat32 (1.0f) / h);
+	descriptor.m_timestep = timestep;
+	descriptor.m_invTimestep = dgFloat32 (1.0f) / timestep;
+	descriptor.m_kernelRadius = h;
+	descriptor.m_kernelRadius2 = h * h;
+	descriptor.m_poly6 = dgFluidPoly6 (dgFloat32 (0.0f), h) / (h * h * h * h * h * h);
+	descriptor.m_spikyGrad = dgFluidSpikyGradient (dgFloat32 (0.0f), h) / (h * h);
+	descriptor.m_massDensity = m_particleMass / m_restDensity;
+	descriptor.m_tensileScale = DG_FLUID_TENSILE_COEFFICIENT * DG_FLUID_RELAXATION / m_relaxation;
+	descriptor.m_invTensileWeight = dgFloat32 (1.0f) / dgFluidPoly6 (DG_FLUID_TENSILE_DISTANCE * DG_FLUID_TENSILE_DISTANCE * h * h, h);
+	descriptor.m_atomicIndex = 0;
+	descriptor.m_threadCount = world->GetThreadCount();
+	descriptor.m_minBox = dgAlloca (dgVector, descriptor.m_threadCount);
+	descriptor.m_maxBox = dgAlloca (dgVector, descriptor.m_threadCount);
+	descriptor.m_momentum = dgAlloca (dgVector, descriptor.m_threadCount);
+	descriptor.m_positSum = dgAlloca (dgVector, descriptor.m_threadCount);
+	descriptor.m_maxAccel = dgAlloca (dgVector, descriptor.m_threadCount);
+
+	m_boundaryImpulse.Resize (dgMax (descriptor.m_threadCount * m_boundaryBodiesCount * 2, 1));
+	dgVector* const boundaryImpulse = &m_boundaryImpulse[0];
+	for (dgInt32 i = descriptor.m_threadCount * m_boundaryBodiesCount * 2 - 1; i >= 0; i --) {
+		boundaryImpulse[i] = dgVector::m_zero;
+	}
+
+	// static bodies go last, so that they have the final say when a particle is pinched between two bodies
+	const dgBody** const boundaryBodies = &m_boundaryBodies[0];
+	for (dgInt32 i = 0, j = m_boundaryBodiesCount - 1; i < j; ) {
+		if (boundaryBodies[i]->GetInvMass().m_w == dgFloat32 (0.0f)) {
+			dgSwap (boundaryBodies[i], boundaryBodies[j]);
+			j --;
+		} else {
+			i ++;
+		}
+	}
+
+	DispatchKernel (PredictPositionsKernel, descriptor);
+	BuildSpatialHash (descriptor);
+	if (m_boundaryBodiesCount) {
+		DispatchKernel (SolveBoundaryKernel, descriptor);
+	}
+
+	for (dgInt32 i = 0; i < m_solverIterations; i ++) {
+		DispatchKernel (CalculateLambdaKernel, descriptor);
+		dgSwap (descriptor.m_posit, descriptor.m_predicted);
+		DispatchKernel (SolveDensityKernel, descriptor);
+	}
+	if (m_boundaryBodiesCount) {
+		DispatchKernel (SolveBoundaryKernel, descriptor);
+		ApplyBoundaryImpulses (descriptor);
+	}
+
+	for (dgInt32 i = 0; i < descriptor.m_threadCount; i ++) {
+		descriptor.m_minBox[i] = dgVector (dgFloat32 (1.0e10f));
+		descriptor.m_maxBox[i] = dgVector (dgFloat32 (-1.0e10f));
+		descriptor.m_momentum[i] = dgVector::m_zero;
+		descriptor.m_positSum[i] = dgVector::m_zero;
+		descriptor.m_maxAccel[i] = dgVector::m_zero;
+	}
+	DispatchKernel (UpdateVelocityKernel, descriptor);
+	DispatchKernel (ApplyViscosityKernel, descriptor);
+	m_boundaryBodiesCount = 0;
+
+	// reduce the per thread results, all particles have the same mass
+	dgVector minBox (descriptor.m_minBox[0]);
+	dgVector maxBox (descriptor.m_maxBox[0]);
+	dgVector momentum (descriptor.m_momentum[0]);
+	dgVector positSum (descriptor.m_positSum[0]);
+	dgVector maxAccel (descriptor.m_maxAccel[0]);
+	for (dgInt32 i = 1; i < descriptor.m_threadCount; i ++) {
+		minBox = minBox.GetMin(descriptor.m_minBox[i]);
+		maxBox = maxBox.GetMax(descriptor.m_maxBox[i]);
+		momentum += descriptor.m_momentum[i];
+		positSum += descriptor.m_positSum[i];
+		const dgVector accelMask (descriptor.m_maxAccel[i].DotProduct4(descriptor.m_maxAccel[i]) > maxAccel.DotProduct4(maxAccel));
+		maxAccel = (descriptor.m_maxAccel[i] & accelMask) | maxAccel.AndNot(accelMask);
+	}
+
+	const dgVector invCount (dgFloat32 (1.0f) / m_particlesCount);
+	const dgVector comVeloc ((momentum * invCount) & dgVector::m_triplexMask);
+	const dgVector localCom ((positSum * invCount) & dgVector::m_triplexMask);
+
+	// the body carries the center of mass motion, and its acceleration reports the most 
+	// accelerated particle so that the volume does not go to sleep while the fluid is still settling
+	m_body->m_accel = maxAccel & dgVector::m_triplexMask;
+	m_body->m_state->m_veloc = comVeloc;
+	m_body->m_alpha = dgVector::m_zero;
+	m_body->m_state->m_omega = dgVector::m_zero;
+	m_body->m_externalForce = dgVector::m_zero;
+	m_body->m_externalTorque = dgVector::m_zero;
+	m_body->m_invWorldInertiaMatrix = dgGetIdentityMatrix();
+
+	// move the particles back so that the center of mass stays at the body origin, 
+	// the body integration moves the volume by the same amount
+	descriptor.m_origin = localCom - (m_body->m_localCentreOfMass & dgVector::m_triplexMask);
+	DispatchKernel (TranslateParticlesKernel, descriptor);
+
+	const dgVector radius (m_particleRadius);
+	m_boxSize = (dgVector::m_half * (maxBox - minBox) + radius) & dgVector::m_triplexMask;
+	m_boxOrigin = (dgVector::m_half * (maxBox + minBox) - descriptor.m_origin) & dgVector::m_triplexMask;
+}
+
+void dgCollisionIncompressibleParticles::IntegrateForces(dgFloat32 timestep)
+{
+	dgAssert(m_body->m_invMass.m_w > dgFloat32(0.0f));
+	dgAssert(m_body->IsRTTIType(dgBody::m_dynamicBodyRTTI));
+
+	dgAssert (m_body->GetCollision()->GetGlobalMatrix()[0][0] == dgFloat32 (1.0f));
+	dgAssert (m_body->GetCollision()->GetGlobalMatrix()[1][1] == dgFloat32 (1.0f));
+	dgAssert (m_body->GetCollision()->GetGlobalMatrix()[2][2] == dgFloat32 (1.0f));
+	if (m_particlesCount) {
+		CalculateAcceleration (timestep);
+	}
 }
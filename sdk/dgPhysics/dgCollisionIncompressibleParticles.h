@@ -32,16 +32,58 @@ class dgCollisionIncompressibleParticles: public dgCollisionLumpedMassParticles
 {
 	public:
 	dgCollisionIncompressibleParticles (const dgCollisionIncompressibleParticles& source);
-	dgCollisionIncompressibleParticles (dgWorld* const world, dgMeshEffect* const mesh);
+	dgCollisionIncompressibleParticles (dgWorld* const world, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity);
 	dgCollisionIncompressibleParticles (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 
 	virtual ~dgCollisionIncompressibleParticles(void);
 	virtual void CalculateAcceleration(dgFloat32 timestep);
-};
 
+	void SetSolverParameters (dgInt32 iterations, dgFloat32 viscosity);
+
+	protected:
+	class dgSolverDescriptor;
+
+	virtual void IntegrateForces (dgFloat32 timestep);
+	virtual void RegisterCollision(const dgBody* const otherBody);
+	virtual dgInt32 GetMemoryBufferSizeInBytes() const;
 
+	void ResizeSolverBuffers ();
+	void BuildSpatialHash (dgSolverDescriptor& descriptor);
+	void ApplyBoundaryImpulses (dgSolverDescriptor& descriptor) const;
+	void DispatchKernel (dgWorkerThreadTaskCallback kernel, dgSolverDescriptor& descriptor) const;
 
+	static void PredictPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateNeighborsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void SolveBoundaryKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateLambdaKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void SolveDensityKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void UpdateVelocityKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void ApplyViscosityKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void TranslateParticlesKernel (void* const context, void* const worldContext, dgInt32 threadID);
 
+	dgArray<dgVector> m_predictedPosit0;
+	dgArray<dgVector> m_predictedPosit1;
+	dgArray<dgVector> m_tmpVeloc;
+	dgArray<dgFloat32> m_lambda;
+	dgArray<dgInt32> m_cellKey;
+	dgArray<dgInt32> m_cellStart;
+	dgArray<dgInt32> m_cellParticles;
+	dgArray<dgInt32> m_neighbors;
+	dgArray<dgInt32> m_neighborsCount;
+	dgArray<const dgBody*> m_boundaryBodies;
+	dgArray<dgVector> m_boundaryImpulse;
+	dgThread::dgCriticalSection m_boundaryLock;
+
+	dgFloat32 m_restDensity;
+	dgFloat32 m_particleMass;
+	dgFloat32 m_kernelRadius;
+	dgFloat32 m_relaxation;
+	dgFloat32 m_viscosity;
+	dgInt32 m_solverIterations;
+	dgInt32 m_boundaryBodiesCount;
+	dgInt32 m_hashSize;
+	dgInt32 m_neighborsStride;
+};
 
 #endif 
 
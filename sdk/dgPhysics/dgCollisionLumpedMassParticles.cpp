@@ -148,8 +148,9 @@ void dgCollisionLumpedMassParticles::SetOwnerAndMassPraperties (dgDynamicBody* c
 	body->m_collision->SetScale(dgVector (dgFloat32 (1.0f)));
 	body->m_collision->SetLocalMatrix (dgGetIdentityMatrix());
 	matrix.m_posit = position;
-	body->m_matrix = matrix;
+	body->m_state->m_matrix = matrix;
 	body->m_localCentreOfMass = xMassSum * invMass;
+	body->m_globalCentreOfMass = matrix.TransformVector(body->m_localCentreOfMass);
 
 	//dgVector inertia (xxMassSum.Scale4(invMass) - body->m_localCentreOfMass); 
 	//inertia += dgVector (inertiaSum);
@@ -27,9 +27,44 @@
 #include "dgDynamicBody.h"
 #include "dgCollisionMassSpringDamperSystem.h"
 
+#define DG_SPRING_DAMPER_RK_ITERATIONS		4
+#define DG_SPRING_DAMPER_IMPLICIT_ITERATIONS	4
+#define DG_SPRING_DAMPER_BATCH				64
+#define DG_SPRING_DAMPER_PARALLEL_CUTOFF	1024
+
+class dgCollisionMassSpringDamperSystem::dgSolverDescriptor
+{
+	public:
+	dgCollisionMassSpringDamperSystem* m_me;
+	const dgVector* m_normalDir;
+	const dgVector* m_normalAccel;
+	const dgFloat32* m_frictionCoefficient;
+	dgVector* m_inertia;
+	dgVector* m_positPrev;
+	dgVector* m_rhs;
+	dgVector m_timestep;
+	dgVector m_invTimestep;
+	dgInt32 m_atomicIndex;
+	dgInt32 m_threadCount;
+};
+
 
 dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem (dgWorld* const world, dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, const dgFloat32* const pointsMasses, dgInt32 linksCount, const dgInt32* const links, const dgFloat32* const linksSpring, const dgFloat32* const LinksDamper)
 	:dgCollisionDeformableMesh(world, m_deformableSolidMesh)
+	,m_linkBlocks(world->GetAllocator())
+	,m_linkForce(world->GetAllocator())
+	,m_particleLinksStart(world->GetAllocator())
+	,m_particleLinks(world->GetAllocator())
+	,m_linkBlocksCount(0)
+	,m_permutation(world->GetAllocator())
+	,m_envelopeStart(world->GetAllocator())
+	,m_envelopeOffset(world->GetAllocator())
+	,m_factor(world->GetAllocator())
+	,m_invDiagonal(world->GetAllocator())
+	,m_factoredTimestep(dgFloat32 (0.0f))
+	,m_implicitIterations(DG_SPRING_DAMPER_IMPLICIT_ITERATIONS)
+	,m_implicit(false)
+	,m_hasEnvelope(false)
 {
 	m_rtti |= dgCollisionMassSpringDamperSystem_RTTI;
 
@@ -69,17 +104,47 @@ dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem (dgWorld* c
 	}
 
 	FinalizeBuild();
+	BuildLinkBlocks();
 }
 
 
 dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem(const dgCollisionMassSpringDamperSystem& source)
 	:dgCollisionDeformableMesh(source)
+	,m_linkBlocks(source.m_linkBlocks, source.m_linkBlocksCount)
+	,m_linkForce(source.m_linkForce.GetAllocator())
+	,m_particleLinksStart(source.m_particleLinksStart, source.m_particlesCount + 1)
+	,m_particleLinks(source.m_particleLinks, source.m_linksCount * 2)
+	,m_linkBlocksCount(source.m_linkBlocksCount)
+	,m_permutation(source.m_permutation.GetAllocator())
+	,m_envelopeStart(source.m_envelopeStart.GetAllocator())
+	,m_envelopeOffset(source.m_envelopeOffset.GetAllocator())
+	,m_factor(source.m_factor.GetAllocator())
+	,m_invDiagonal(source.m_invDiagonal.GetAllocator())
+	,m_factoredTimestep(dgFloat32 (0.0f))
+	,m_implicitIterations(source.m_implicitIterations)
+	,m_implicit(source.m_implicit)
+	,m_hasEnvelope(false)
 {
 	m_rtti |= source.m_rtti;
+	m_linkForce.Resize(dgMax (m_linkBlocksCount * 4, 1));
 }
 
 dgCollisionMassSpringDamperSystem::dgCollisionMassSpringDamperSystem(dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollisionDeformableMesh(world, deserialization, userData, revisionNumber)
+	,m_linkBlocks(world->GetAllocator())
+	,m_linkForce(world->GetAllocator())
+	,m_particleLinksStart(world->GetAllocator())
+	,m_particleLinks(world->GetAllocator())
+	,m_linkBlocksCount(0)
+	,m_permutation(world->GetAllocator())
+	,m_envelopeStart(world->GetAllocator())
+	,m_envelopeOffset(world->GetAllocator())
+	,m_factor(world->GetAllocator())
+	,m_invDiagonal(world->GetAllocator())
+	,m_factoredTimestep(dgFloat32 (0.0f))
+	,m_implicitIterations(DG_SPRING_DAMPER_IMPLICIT_ITERATIONS)
+	,m_implicit(false)
+	,m_hasEnvelope(false)
 {
 }
 
@@ -90,11 +155,533 @@ dgCollisionMassSpringDamperSystem::~dgCollisionMassSpringDamperSystem(void)
 dgInt32 dgCollisionMassSpringDamperSystem::GetMemoryBufferSizeInBytes() const
 {
 	dgInt32 sizeInByte = 0;
-	sizeInByte += 3 * m_particlesCount * sizeof (dgVector);
+	sizeInByte += 5 * m_particlesCount * sizeof (dgVector);
 	sizeInByte += 1 * m_particlesCount * sizeof (dgFloat32);
 	return sizeInByte;
 }
 
+bool dgCollisionMassSpringDamperSystem::GetImplicitSolver () const
+{
+	return m_implicit;
+}
+
+void dgCollisionMassSpringDamperSystem::SetImplicitSolver (bool state, dgInt32 iterations)
+{
+	m_implicit = state;
+	m_implicitIterations = dgClamp (iterations, 1, 64);
+	m_factoredTimestep = dgFloat32 (0.0f);
+}
+
+void dgCollisionMassSpringDamperSystem::BuildLinkBlocks()
+{
+	// pack the links four at a time, the padding lanes have no spring and contribute no force
+	m_linkBlocksCount = (m_linksCount + 3) >> 2;
+	m_linkBlocks.Resize(dgMax (m_linkBlocksCount, 1));
+	m_linkForce.Resize(dgMax (m_linkBlocksCount * 4, 1));
+	const dgSpringDamperLink* const links = &m_linkList[0];
+	for (dgInt32 i = 0; i < m_linkBlocksCount; i ++) {
+		dgSpringDamperLinkBlock& block = m_linkBlocks[i];
+		dgFloat32 spring[4];
+		dgFloat32 damper[4];
+		dgFloat32 restlength[4];
+		for (dgInt32 j = 0; j < 4; j ++) {
+			const dgInt32 index = i * 4 + j;
+			if (index < m_linksCount) {
+				spring[j] = links[index].m_spring;
+				damper[j] = links[index].m_damper;
+				restlength[j] = links[index].m_restlength;
+				block.m_m0[j] = links[index].m_m0;
+				block.m_m1[j] = links[index].m_m1;
+			} else {
+				spring[j] = dgFloat32 (0.0f);
+				damper[j] = dgFloat32 (0.0f);
+				restlength[j] = dgFloat32 (0.0f);
+				block.m_m0[j] = 0;
+				block.m_m1[j] = 0;
+			}
+		}
+		block.m_spring = dgVector (spring[0], spring[1], spring[2], spring[3]);
+		block.m_damper = dgVector (damper[0], damper[1], damper[2], damper[3]);
+		block.m_restlength = dgVector (restlength[0], restlength[1], restlength[2], restlength[3]);
+	}
+
+	// each particle gathers the forces of its links, so the integration does not scatter.
+	// the low bit of each entry tells on which side of the link the particle is. 
+	m_particleLinksStart.Resize(m_particlesCount + 1);
+	m_particleLinks.Resize(dgMax (m_linksCount * 2, 1));
+	dgInt32* const start = &m_particleLinksStart[0];
+	memset (start, 0, (m_particlesCount + 1) * sizeof (dgInt32));
+	for (dgInt32 i = 0; i < m_linksCount; i ++) {
+		start[links[i].m_m0] ++;
+		start[links[i].m_m1] ++;
+	}
+	dgInt32 acc = 0;
+	for (dgInt32 i = 0; i <= m_particlesCount; i ++) {
+		const dgInt32 count = start[i];
+		start[i] = acc;
+		acc += count;
+	}
+	dgInt32* const particleLinks = &m_particleLinks[0];
+	for (dgInt32 i = 0; i < m_linksCount; i ++) {
+		particleLinks[start[links[i].m_m0]] = i * 2 + 0;
+		start[links[i].m_m0] ++;
+		particleLinks[start[links[i].m_m1]] = i * 2 + 1;
+		start[links[i].m_m1] ++;
+	}
+	for (dgInt32 i = m_particlesCount; i > 0; i --) {
+		start[i] = start[i - 1];
+	}
+	start[0] = 0;
+}
+
+void dgCollisionMassSpringDamperSystem::DispatchKernel (dgWorkerThreadTaskCallback kernel, dgSolverDescriptor& descriptor) const
+{
+	dgWorld* const world = m_body->GetWorld();
+	descriptor.m_atomicIndex = 0;
+	if (descriptor.m_threadCount > 1) {
+		for (dgInt32 i = 0; i < descriptor.m_threadCount; i ++) {
+			world->QueueJob (kernel, &descriptor, world);
+		}
+		world->SynchronizationBarrier();
+	} else {
+		kernel (&descriptor, world, 0);
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::CalculateLinkForcesKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionMassSpringDamperSystem* const me = descriptor->m_me;
+	const dgVector* const posit = &me->m_posit[0];
+	const dgVector* const veloc = &me->m_veloc[0];
+	const dgSpringDamperLinkBlock* const blocks = &me->m_linkBlocks[0];
+	dgVector* const linkForce = &me->m_linkForce[0];
+	const dgVector dt (descriptor->m_timestep);
+	const dgInt32 blocksCount = me->m_linkBlocksCount;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH); i < blocksCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_SPRING_DAMPER_BATCH, blocksCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgSpringDamperLinkBlock& block = blocks[j];
+
+			dgVector dx;
+			dgVector dy;
+			dgVector dz;
+			dgVector vx;
+			dgVector vy;
+			dgVector vz;
+			dgVector unused;
+			dgVector::Transpose4x4 (dx, dy, dz, unused, 
+				posit[block.m_m0[0]] - posit[block.m_m1[0]], posit[block.m_m0[1]] - posit[block.m_m1[1]], 
+				posit[block.m_m0[2]] - posit[block.m_m1[2]], posit[block.m_m0[3]] - posit[block.m_m1[3]]);
+			dgVector::Transpose4x4 (vx, vy, vz, unused, 
+				veloc[block.m_m0[0]] - veloc[block.m_m1[0]], veloc[block.m_m0[1]] - veloc[block.m_m1[1]], 
+				veloc[block.m_m0[2]] - veloc[block.m_m1[2]], veloc[block.m_m0[3]] - veloc[block.m_m1[3]]);
+
+			const dgVector mag2 (dx * dx + dy * dy + dz * dz);
+			const dgVector mask (mag2 > m_smallestLenght2);
+			const dgVector length (((mag2 & mask) | m_smallestLenght2.AndNot(mask)).Sqrt());
+			const dgVector invMag (length.Reciproc());
+			const dgVector invMag2 (invMag * invMag);
+			const dgVector dvdp (vx * dx + vy * dy + vz * dz);
+
+			// spring, damper and the spring derivative times the velocity
+			const dgVector k01 ((block.m_spring * (length - block.m_restlength) * invMag) * dgVector::m_negOne);
+			const dgVector d01 ((block.m_damper * dvdp * invMag2) * dgVector::m_negOne);
+			const dgVector h01dt ((dt * block.m_spring * block.m_restlength * invMag2 * invMag) * dgVector::m_negOne);
+			const dgVector scale (k01 + d01 + h01dt * dvdp);
+
+			dgVector::Transpose4x4 (linkForce[j * 4 + 0], linkForce[j * 4 + 1], linkForce[j * 4 + 2], linkForce[j * 4 + 3], dx * scale, dy * scale, dz * scale, dgVector::m_zero);
+		}
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::IntegrateParticlesKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionMassSpringDamperSystem* const me = descriptor->m_me;
+	dgVector* const accel = &me->m_accel[0];
+	dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const posit = &me->m_posit[0];
+	const dgVector* const extAccel = &me->m_externalAccel[0];
+	const dgVector* const linkForce = &me->m_linkForce[0];
+	const dgInt32* const start = &me->m_particleLinksStart[0];
+	const dgInt32* const particleLinks = &me->m_particleLinks[0];
+	const dgVector* const normalDir = descriptor->m_normalDir;
+	const dgVector* const normalAccel = descriptor->m_normalAccel;
+	const dgFloat32* const frictionCoeffecient = descriptor->m_frictionCoefficient;
+	const dgVector dtRK4 (descriptor->m_timestep);
+	const dgVector epsilon (dgFloat32(1.0e-14f));
+	const dgInt32 particlesCount = me->m_particlesCount;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_SPRING_DAMPER_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			dgVector linkAccel (dgVector::m_zero);
+			for (dgInt32 k = start[j]; k < start[j + 1]; k ++) {
+				const dgInt32 entry = particleLinks[k];
+				const dgVector force (linkForce[entry >> 1]);
+				linkAccel += (entry & 1) ? force * dgVector::m_negOne : force;
+			}
+			accel[j] = linkAccel;
+
+			dgVector netAccel (linkAccel + extAccel[j]);
+			dgVector tangentDir(veloc[j] - normalDir[j] * (normalDir[j].DotProduct4(veloc[j])));
+			dgVector mag(tangentDir.DotProduct4(tangentDir) + epsilon);
+
+			dgFloat32 tangentFrictionAccel = dgAbsf(netAccel.DotProduct4(normalDir[j]).GetScalar());
+			dgVector friction(tangentDir.Scale4(frictionCoeffecient[j] * tangentFrictionAccel / dgSqrt(mag.GetScalar())));
+
+			dgVector normalDirAccel(normalDir[j] * (netAccel.DotProduct4(normalDir[j])));
+			netAccel = netAccel + normalAccel[j] - normalDirAccel - friction;
+			veloc[j] += netAccel * dtRK4;
+			posit[j] += veloc[j] * dtRK4;
+		}
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::CalculateEnvelopeOrdering ()
+{
+	// reverse Cuthill McKee ordering, it keeps the factor of mesh like systems in a narrow envelope
+	const dgInt32 count = m_particlesCount;
+	const dgInt32* const start = &m_particleLinksStart[0];
+	const dgInt32* const particleLinks = &m_particleLinks[0];
+	const dgSpringDamperLink* const links = &m_linkList[0];
+
+	dgStack<dgInt32> orderPool(count);
+	dgStack<dgInt32> inversePool(count);
+	dgInt32* const order = &orderPool[0];
+	dgInt32* const inverse = &inversePool[0];
+	for (dgInt32 i = 0; i < count; i ++) {
+		inverse[i] = -1;
+	}
+
+	dgInt32 tail = 0;
+	for (dgInt32 head = 0; head < count; head ++) {
+		if (head == tail) {
+			// start each disconnected piece from its lowest degree particle
+			dgInt32 seed = -1;
+			for (dgInt32 i = 0; i < count; i ++) {
+				if ((inverse[i] == -1) && ((seed == -1) || ((start[i + 1] - start[i]) < (start[seed + 1] - start[seed])))) {
+					seed = i;
+				}
+			}
+			inverse[seed] = tail;
+			order[tail] = seed;
+			tail ++;
+		}
+
+		const dgInt32 particle = order[head];
+		const dgInt32 first = tail;
+		for (dgInt32 i = start[particle]; i < start[particle + 1]; i ++) {
+			const dgSpringDamperLink& link = links[particleLinks[i] >> 1];
+			const dgInt32 other = (particleLinks[i] & 1) ? link.m_m0 : link.m_m1;
+			if (inverse[other] == -1) {
+				inverse[other] = tail;
+				order[tail] = other;
+				tail ++;
+			}
+		}
+
+		// visit the new neighbors by increasing degree
+		for (dgInt32 i = first + 1; i < tail; i ++) {
+			const dgInt32 tmp = order[i];
+			const dgInt32 degree = start[tmp + 1] - start[tmp];
+			dgInt32 j = i - 1;
+			for (; (j >= first) && ((start[order[j] + 1] - start[order[j]]) > degree); j --) {
+				order[j + 1] = order[j];
+			}
+			order[j + 1] = tmp;
+		}
+	}
+	dgAssert (tail == count);
+
+	m_permutation.Resize(count);
+	m_envelopeStart.Resize(count);
+	m_envelopeOffset.Resize(count + 1);
+	m_invDiagonal.Resize(count);
+	for (dgInt32 i = 0; i < count; i ++) {
+		m_permutation[i] = order[count - i - 1];
+		inverse[m_permutation[i]] = i;
+	}
+
+	dgInt32 offset = 0;
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgInt32 particle = m_permutation[i];
+		dgInt32 firstColumn = i;
+		for (dgInt32 j = start[particle]; j < start[particle + 1]; j ++) {
+			const dgSpringDamperLink& link = links[particleLinks[j] >> 1];
+			const dgInt32 other = (particleLinks[j] & 1) ? link.m_m0 : link.m_m1;
+			firstColumn = dgMin (firstColumn, inverse[other]);
+		}
+		m_envelopeStart[i] = firstColumn;
+		m_envelopeOffset[i] = offset;
+		offset += i - firstColumn;
+	}
+	m_envelopeOffset[count] = offset;
+	m_factor.Resize(dgMax (offset, 1));
+	m_hasEnvelope = true;
+}
+
+void dgCollisionMassSpringDamperSystem::FactorizeSystem (dgFloat32 timestep)
+{
+	// projective dynamics system matrix: unit mass over dt^2 plus the link spring and damper laplacian.
+	// the links are in unit acceleration, so like the explicit integrator the particle masses are not part of the system. 
+	if (!m_hasEnvelope) {
+		CalculateEnvelopeOrdering ();
+	}
+
+	const dgInt32 count = m_particlesCount;
+	const dgFloat32 invTimestep = dgFloat32 (1.0f) / timestep;
+	const dgInt32* const permutation = &m_permutation[0];
+	const dgInt32* const envelopeStart = &m_envelopeStart[0];
+	const dgInt32* const envelopeOffset = &m_envelopeOffset[0];
+	dgFloat32* const factor = &m_factor[0];
+	dgFloat32* const invDiagonal = &m_invDiagonal[0];
+
+	dgStack<dgInt32> inversePool(count);
+	dgStack<dgFloat32> diagonalPool(count);
+	dgInt32* const inverse = &inversePool[0];
+	dgFloat32* const diagonal = &diagonalPool[0];
+	for (dgInt32 i = 0; i < count; i ++) {
+		inverse[permutation[i]] = i;
+		diagonal[i] = invTimestep * invTimestep;
+	}
+	memset (factor, 0, envelopeOffset[count] * sizeof (dgFloat32));
+
+	const dgSpringDamperLink* const links = &m_linkList[0];
+	for (dgInt32 i = 0; i < m_linksCount; i ++) {
+		const dgInt32 row0 = inverse[links[i].m_m0];
+		const dgInt32 row1 = inverse[links[i].m_m1];
+		const dgFloat32 weight = links[i].m_spring + links[i].m_damper * invTimestep;
+		const dgInt32 row = dgMax (row0, row1);
+		const dgInt32 column = dgMin (row0, row1);
+		diagonal[row0] += weight;
+		diagonal[row1] += weight;
+		factor[envelopeOffset[row] + column - envelopeStart[row]] -= weight;
+	}
+
+	// row by row envelope Cholesky, the fill in stays inside the envelope 
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgInt32 start_i = envelopeStart[i];
+		dgFloat32* const row_i = &factor[envelopeOffset[i] - start_i];
+		dgFloat32 pivot = diagonal[i];
+		for (dgInt32 j = start_i; j < i; j ++) {
+			const dgInt32 start_j = envelopeStart[j];
+			const dgFloat32* const row_j = &factor[envelopeOffset[j] - start_j];
+			dgFloat32 sum = row_i[j];
+			for (dgInt32 k = dgMax (start_i, start_j); k < j; k ++) {
+				sum -= row_i[k] * row_j[k];
+			}
+			row_i[j] = sum * invDiagonal[j];
+			pivot -= row_i[j] * row_i[j];
+		}
+		dgAssert (pivot > dgFloat32 (0.0f));
+		invDiagonal[i] = dgFloat32 (1.0f) / dgSqrt (pivot);
+	}
+	m_factoredTimestep = timestep;
+}
+
+void dgCollisionMassSpringDamperSystem::SolveSystem (dgVector* const rhs, dgVector* const x) const
+{
+	// the three axis share the same matrix, so they are solved together in the vector lanes
+	const dgInt32 count = m_particlesCount;
+	const dgInt32* const envelopeStart = &m_envelopeStart[0];
+	const dgInt32* const envelopeOffset = &m_envelopeOffset[0];
+	const dgFloat32* const factor = &m_factor[0];
+	const dgFloat32* const invDiagonal = &m_invDiagonal[0];
+
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgFloat32* const row = &factor[envelopeOffset[i] - envelopeStart[i]];
+		// two partial sums break the dependency chain of the dot product
+		dgVector sum0 (rhs[i]);
+		dgVector sum1 (dgVector::m_zero);
+		dgInt32 k = envelopeStart[i];
+		for (; k < (i - 1); k += 2) {
+			sum0 -= rhs[k].Scale4 (row[k]);
+			sum1 -= rhs[k + 1].Scale4 (row[k + 1]);
+		}
+		if (k < i) {
+			sum0 -= rhs[k].Scale4 (row[k]);
+		}
+		rhs[i] = (sum0 + sum1).Scale4 (invDiagonal[i]);
+	}
+
+	for (dgInt32 i = count - 1; i >= 0; i --) {
+		const dgFloat32* const row = &factor[envelopeOffset[i] - envelopeStart[i]];
+		const dgVector value (rhs[i].Scale4 (invDiagonal[i]));
+		rhs[i] = value;
+		for (dgInt32 k = envelopeStart[i]; k < i; k ++) {
+			rhs[k] -= value.Scale4 (row[k]);
+		}
+	}
+
+	const dgInt32* const permutation = &m_permutation[0];
+	for (dgInt32 i = 0; i < count; i ++) {
+		x[permutation[i]] = rhs[i];
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::PredictPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionMassSpringDamperSystem* const me = descriptor->m_me;
+	const dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const posit = &me->m_posit[0];
+	const dgVector* const extAccel = &me->m_externalAccel[0];
+	const dgVector* const normalDir = descriptor->m_normalDir;
+	const dgVector* const normalAccel = descriptor->m_normalAccel;
+	const dgFloat32* const frictionCoeffecient = descriptor->m_frictionCoefficient;
+	dgVector* const inertia = descriptor->m_inertia;
+	dgVector* const positPrev = descriptor->m_positPrev;
+	const dgVector timestep (descriptor->m_timestep);
+	const dgVector invTimestep2 (descriptor->m_invTimestep * descriptor->m_invTimestep);
+	const dgVector epsilon (dgFloat32(1.0e-14f));
+	const dgInt32 particlesCount = me->m_particlesCount;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_SPRING_DAMPER_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			// external and contact accelerations are explicit, the links are implicit
+			dgVector netAccel (extAccel[j]);
+			dgVector tangentDir(veloc[j] - normalDir[j] * (normalDir[j].DotProduct4(veloc[j])));
+			dgVector mag(tangentDir.DotProduct4(tangentDir) + epsilon);
+
+			dgFloat32 tangentFrictionAccel = dgAbsf(netAccel.DotProduct4(normalDir[j]).GetScalar());
+			dgVector friction(tangentDir.Scale4(frictionCoeffecient[j] * tangentFrictionAccel / dgSqrt(mag.GetScalar())));
+
+			// half the contact acceleration moves the particle out of the penetration in one full step, 
+			// the way the explicit sub steps do.
+			dgVector normalDirAccel(normalDir[j] * (netAccel.DotProduct4(normalDir[j])));
+			netAccel = netAccel + normalAccel[j] * dgVector::m_half - normalDirAccel - friction;
+
+			const dgVector target (posit[j] + (veloc[j] + netAccel * timestep) * timestep);
+			positPrev[j] = posit[j];
+			inertia[j] = target * invTimestep2;
+			posit[j] = target;
+		}
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::ProjectLinksKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionMassSpringDamperSystem* const me = descriptor->m_me;
+	const dgVector* const posit = &me->m_posit[0];
+	const dgVector* const positPrev = descriptor->m_positPrev;
+	const dgSpringDamperLinkBlock* const blocks = &me->m_linkBlocks[0];
+	dgVector* const linkForce = &me->m_linkForce[0];
+	const dgVector invTimestep (descriptor->m_invTimestep);
+	const dgInt32 blocksCount = me->m_linkBlocksCount;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH); i < blocksCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_SPRING_DAMPER_BATCH, blocksCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgSpringDamperLinkBlock& block = blocks[j];
+
+			dgVector dx;
+			dgVector dy;
+			dgVector dz;
+			dgVector px;
+			dgVector py;
+			dgVector pz;
+			dgVector unused;
+			dgVector::Transpose4x4 (dx, dy, dz, unused, 
+				posit[block.m_m0[0]] - posit[block.m_m1[0]], posit[block.m_m0[1]] - posit[block.m_m1[1]], 
+				posit[block.m_m0[2]] - posit[block.m_m1[2]], posit[block.m_m0[3]] - posit[block.m_m1[3]]);
+			dgVector::Transpose4x4 (px, py, pz, unused, 
+				positPrev[block.m_m0[0]] - positPrev[block.m_m1[0]], positPrev[block.m_m0[1]] - positPrev[block.m_m1[1]], 
+				positPrev[block.m_m0[2]] - positPrev[block.m_m1[2]], positPrev[block.m_m0[3]] - positPrev[block.m_m1[3]]);
+
+			// project each link to its rest length, the damper pulls toward the previous link vector
+			const dgVector mag2 (dx * dx + dy * dy + dz * dz);
+			const dgVector mask (mag2 > m_smallestLenght2);
+			const dgVector length (((mag2 & mask) | m_smallestLenght2.AndNot(mask)).Sqrt());
+			const dgVector springScale (block.m_spring * block.m_restlength * length.Reciproc());
+			const dgVector damperScale (block.m_damper * invTimestep);
+
+			dgVector::Transpose4x4 (linkForce[j * 4 + 0], linkForce[j * 4 + 1], linkForce[j * 4 + 2], linkForce[j * 4 + 3], 
+				dx * springScale + px * damperScale, dy * springScale + py * damperScale, dz * springScale + pz * damperScale, dgVector::m_zero);
+		}
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::CalculateRhsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionMassSpringDamperSystem* const me = descriptor->m_me;
+	const dgVector* const linkForce = &me->m_linkForce[0];
+	const dgInt32* const start = &me->m_particleLinksStart[0];
+	const dgInt32* const particleLinks = &me->m_particleLinks[0];
+	const dgInt32* const permutation = &me->m_permutation[0];
+	const dgVector* const inertia = descriptor->m_inertia;
+	dgVector* const rhs = descriptor->m_rhs;
+	const dgInt32 particlesCount = me->m_particlesCount;
+
+	// the right hand side is written in the factor order 
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_SPRING_DAMPER_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			const dgInt32 particle = permutation[j];
+			dgVector sum (inertia[particle]);
+			for (dgInt32 k = start[particle]; k < start[particle + 1]; k ++) {
+				const dgInt32 entry = particleLinks[k];
+				const dgVector force (linkForce[entry >> 1]);
+				sum += (entry & 1) ? force * dgVector::m_negOne : force;
+			}
+			rhs[j] = sum;
+		}
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::UpdateVelocityKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dgSolverDescriptor* const descriptor = (dgSolverDescriptor*) context;
+	dgCollisionMassSpringDamperSystem* const me = descriptor->m_me;
+	dgVector* const accel = &me->m_accel[0];
+	dgVector* const veloc = &me->m_veloc[0];
+	dgVector* const posit = &me->m_posit[0];
+	const dgVector* const extAccel = &me->m_externalAccel[0];
+	const dgVector* const normalDir = descriptor->m_normalDir;
+	const dgVector* const inertia = descriptor->m_inertia;
+	const dgVector* const positPrev = descriptor->m_positPrev;
+	const dgVector invTimestep (descriptor->m_invTimestep);
+	const dgVector timestep2 (descriptor->m_timestep * descriptor->m_timestep);
+	const dgInt32 particlesCount = me->m_particlesCount;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH); i < particlesCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_SPRING_DAMPER_BATCH)) {
+		const dgInt32 count = dgMin (i + DG_SPRING_DAMPER_BATCH, particlesCount);
+		for (dgInt32 j = i; j < count; j ++) {
+			// the links do not know about contacts, do not let them pull a particle deeper than its predicted position 
+			const dgVector penetration (normalDir[j].DotProduct4(posit[j] - inertia[j] * timestep2));
+			posit[j] -= normalDir[j] * (penetration & (penetration < dgVector::m_zero));
+
+			// and like the explicit integrator, a particle in contact leaves the step at rest along the contact normal
+			dgVector velocity ((posit[j] - positPrev[j]) * invTimestep);
+			velocity -= normalDir[j] * normalDir[j].DotProduct4(velocity);
+			accel[j] = (velocity - veloc[j]) * invTimestep - extAccel[j];
+			veloc[j] = velocity;
+		}
+	}
+}
+
+void dgCollisionMassSpringDamperSystem::CalculateImplicitPositions (dgSolverDescriptor& descriptor)
+{
+	// projective dynamics, alternate a parallel local projection of the links 
+	// with a global solve of the prefactored system, a full time step at the time.
+	if (m_factoredTimestep != descriptor.m_timestep.GetScalar()) {
+		FactorizeSystem (descriptor.m_timestep.GetScalar());
+	}
+
+	DispatchKernel (PredictPositionsKernel, descriptor);
+	for (dgInt32 i = 0; i < m_implicitIterations; i ++) {
+		DispatchKernel (ProjectLinksKernel, descriptor);
+		DispatchKernel (CalculateRhsKernel, descriptor);
+		SolveSystem (descriptor.m_rhs, &m_posit[0]);
+	}
+	DispatchKernel (UpdateVelocityKernel, descriptor);
+}
+
 #if 0
 void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep)
 {
@@ -230,152 +817,54 @@ void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep
 {
 	// Ks is in [sec^-2] a spring constant unit acceleration, not a spring force acceleration. 
 	// Kc is in [sec^-1] a damper constant unit velocity, not a damper force acceleration. 
-
-	dgInt32 iter = 4;
-	dgVector* const accel = &m_accel[0];
-	dgVector* const veloc = &m_veloc[0];
-	dgVector* const posit = &m_posit[0];
-	dgVector* const extAccel = &m_externalAccel[0];
-	const dgSpringDamperLink* const links = &m_linkList[0];
-/*
-	
-	dgVector* const dx = dgAlloca(dgVector, m_linksCount);
-	dgVector* const dv = dgAlloca(dgVector, m_linksCount);
-	dgVector* const dpdv = dgAlloca(dgVector, m_linksCount);
-
-	dgVector* const normalDir = dgAlloca(dgVector, m_particlesCount);
-	dgVector* const normalAccel = dgAlloca(dgVector, m_particlesCount);
-	dgFloat32* const spring_A01 = dgAlloca(dgFloat32, m_linksCount);
-	dgFloat32* const spring_B01 = dgAlloca(dgFloat32, m_linksCount);
-	dgFloat32* const frictionCoeffecient = dgAlloca(dgFloat32, m_particlesCount);
-*/
-	//	dgFloat32* const damper_A01 = dgAlloca(dgFloat32, m_linksCount);
-	//	dgFloat32* const damper_B01 = dgAlloca(dgFloat32, m_linksCount);
-	//	dgFloat32* const damper_C01 = dgAlloca(dgFloat32, m_linksCount);
-	//	dgVector* const collisionDir1 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const collisionDir2 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const tmp1 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const tmp2 = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const diag = dgAlloca(dgVector, m_particlesCount);
-	//	dgVector* const offDiag = dgAlloca(dgVector, m_particlesCount);
-	//dgVector deltaOmega(m_body->m_invWorldInertiaMatrix.RotateVector(m_body->m_externalTorque.Scale4(timestep)));
-
 	dgWorld* const world = m_body->GetWorld();
 	world->m_solverJacobiansMemory.ResizeIfNecessary(GetMemoryBufferSizeInBytes() + 1024);
 
 	dgVector* const normalAccel = (dgVector*)&world->m_solverJacobiansMemory[0];
 	dgVector* const normalDir = &normalAccel[m_particlesCount];
-	dgVector* const diagonal = &normalDir[m_particlesCount];
-	dgFloat32* const frictionCoeffecient = (dgFloat32*)&diagonal[m_particlesCount];
+	dgVector* const inertia = &normalDir[m_particlesCount];
+	dgVector* const positPrev = &inertia[m_particlesCount];
+	dgVector* const rhs = &positPrev[m_particlesCount];
+	dgFloat32* const frictionCoeffecient = (dgFloat32*)&rhs[m_particlesCount];
 
 	dgVector unitAccel(m_body->m_externalForce * dgVector(m_body->m_invMass.m_w));
 
 	// here I need to add all other external acceleration like wind and pressure, friction and collision.
+	dgVector* const extAccel = &m_externalAccel[0];
 	for (dgInt32 i = 0; i < m_particlesCount; i++) {
 		extAccel[i] = unitAccel;
 	}
 
 	dgAssert(m_body->IsRTTIType(dgBody::m_dynamicBodyRTTI));
 	m_body->m_alpha = dgVector::m_zero;
-	m_body->m_omega = dgVector::m_zero;
+	m_body->m_state->m_omega = dgVector::m_zero;
 	m_body->m_externalForce = dgVector::m_zero;
 	m_body->m_externalTorque = dgVector::m_zero;
 
-	//dgFloat32 ks_dt = -timestep * kSpring;
-	//dgFloat32 kd_dt0 = -timestep * kDamper;
-	//dgFloat32 kd_dt1 = -timestep * kDamper * dgFloat32(2.0f);
-
-	//dgFloat32 dtRK4__ = timestep / iter;
-	dgVector dtRK4 (timestep / iter);
-	dgVector epsilon(dgFloat32(1.0e-14f));
-
-//	dtRK4 = dtRK4 & dgVector::m_triplexMask;
 	HandleCollision(timestep, normalDir, normalAccel, frictionCoeffecient);
-	for (dgInt32 k = 0; k < iter; k++) {
-		for (dgInt32 i = 0; i < m_particlesCount; i++) {
-			accel[i] = dgVector::m_zero; 
-			diagonal[i] = dgVector::m_zero; 
-		}
-/*
-		for (dgInt32 i = 0; i < m_linksCount; i++) {
-			const dgInt32 j0 = links[i].m_m0;
-			const dgInt32 j1 = links[i].m_m1;
-
-			const dgVector p0p1(posit[j0] - posit[j1]);
-			const dgVector v0v1(veloc[j0] - veloc[j1]);
-			const dgVector dpdv(p0p1.CompProduct4(v0v1));
-
-			const dgVector mag2(p0p1.DotProduct4(p0p1));
-			const dgVector mask(mag2 > m_smallestLenght2);
-
-			const dgVector lenght2((mag2 & mask) | mag2.AndNot(mask));
-			const dgFloat32 length = (lenght2.Sqrt()).GetScalar();
-			const dgFloat32 invDen = dgFloat32(1.0f) / length;
-			const dgFloat32 lenghtRatio = restLenght[i] * invDen;
-			const dgFloat32 compression = dgFloat32(1.0f) - lenghtRatio;
-			const dgVector fs(p0p1.Scale4(kSpring * compression));
-			const dgVector fd(p0p1.Scale4(kDamper * invDen * invDen * (v0v1.DotProduct4(p0p1)).GetScalar()));
-			const dgVector dfsdx(v0v1.Scale4 (ks_dt * compression) + (p0p1.CompProduct4(dpdv).Scale4 (ks_dt * lenghtRatio * invDen * invDen)));
-			dgAssert(fs.m_w == dgFloat32(0.0f));
-			dgAssert(fs.m_w == dgFloat32(0.0f));
-			dgAssert(p0p1.m_w == dgFloat32(0.0f));
-			dgAssert(dfsdx.m_w == dgFloat32(0.0f));
-
-			const dgVector nextAccel(fs + fd - dfsdx);
-			accel[j0] -= nextAccel;
-			accel[j1] += nextAccel;
-		}
-*/
-
-		for (dgInt32 i = 0; i < m_linksCount; i++) {
-			const dgInt32 j0 = links[i].m_m0;
-			const dgInt32 j1 = links[i].m_m1;
-			const dgVector p0p1(posit[j0] - posit[j1]);
-			const dgVector v0v1(veloc[j0] - veloc[j1]);
-			const dgVector dvdp(v0v1 * p0p1);
 
-			const dgVector p0p1Mag2(p0p1.DotProduct4(p0p1));
-			const dgVector p0p1Mask(p0p1Mag2 > m_smallestLenght2);
-			const dgVector p0p1Lenght2((p0p1Mag2 & p0p1Mask) | m_smallestLenght2.AndNot(p0p1Mask));
-
-			const dgFloat32 p0p1Length = p0p1Lenght2.Sqrt().GetScalar();
-			const dgFloat32 p0p1InvMag = dgFloat32 (1.0f) / p0p1Length;
-
-			const dgFloat32 k01 = -links[i].m_spring * (p0p1Length - links[i].m_restlength) * p0p1InvMag;
-			const dgFloat32 d01 = -links[i].m_damper * dvdp.GetScalar() * p0p1InvMag * p0p1InvMag;
-			const dgFloat32 h01dt = - dtRK4.GetScalar() * links[i].m_spring * links[i].m_restlength * p0p1InvMag * p0p1InvMag * p0p1InvMag;
-
-			const dgVector diag ((p0p1 * p0p1).Scale4(h01dt * dtRK4.GetScalar()));
-
-			const dgFloat32 dtdfp0dx0 = h01dt * v0v1.DotProduct4(p0p1).GetScalar();
-			const dgVector netForce (p0p1.Scale4(k01 + d01 + dtdfp0dx0));
-			
-
-			diagonal[j0] -= diag;
-			diagonal[j1] -= diag;
-			accel[j0] += netForce;
-			accel[j1] -= netForce;
-		}
-
-
-		for (dgInt32 i = 0; i < m_particlesCount; i++) {
-			//dgVector dirAccel1 (collisionDir1[i].CompProduct4(accel[i].DotProduct4(collisionDir1[i])));
-			//dgVector dirAccel2 (collisionDir2[i].CompProduct4(accel[i].DotProduct4(collisionDir2[i])));
-			//tmp0[i] = accel[i] + collidingAccel[i] - dirAccel0 - dirAccel1 - dirAccel2;
-
-			dgVector netAccel (accel[i] + extAccel[i]);
-			dgVector tangentDir(veloc[i] - normalDir[i] * (normalDir[i].DotProduct4(veloc[i])));
-			dgVector mag(tangentDir.DotProduct4(tangentDir) + epsilon);
-			
-			dgFloat32 tangentFrictionAccel = dgAbsf(netAccel.DotProduct4(normalDir[i]).GetScalar());
-			dgVector friction(tangentDir.Scale4(frictionCoeffecient[i] * tangentFrictionAccel / dgSqrt(mag.GetScalar())));
-
-			//dgVector particleAccel (accel[i] + normalAccel[i] - normalDirAccel);
-			dgVector normalDirAccel(normalDir[i] * (netAccel.DotProduct4(normalDir[i])));
-			//accel[i] = accel[i] + normalAccel[i] - normalDirAccel - friction;
-			netAccel = netAccel + normalAccel[i] - normalDirAccel - friction;
-			veloc[i] += netAccel * dtRK4;
-			posit[i] += veloc[i] * dtRK4;
+	// small systems are not worth the thread synchronization
+	dgSolverDescriptor descriptor;
+	descriptor.m_me = this;
+	descriptor.m_normalDir = normalDir;
+	descriptor.m_normalAccel = normalAccel;
+	descriptor.m_frictionCoefficient = frictionCoeffecient;
+	descriptor.m_inertia = inertia;
+	descriptor.m_positPrev = positPrev;
+	descriptor.m_rhs = rhs;
+	descriptor.m_atomicIndex = 0;
+	descriptor.m_threadCount = (m_linksCount >= DG_SPRING_DAMPER_PARALLEL_CUTOFF) ? dgMin (world->GetThreadCount(), DG_MAX_THREADS_HIVE_COUNT) : 1;
+
+	if (m_implicit) {
+		descriptor.m_timestep = dgVector (timestep);
+		descriptor.m_invTimestep = dgVector (dgFloat32 (1.0f) / timestep);
+		CalculateImplicitPositions (descriptor);
+	} else {
+		descriptor.m_timestep = dgVector (timestep / DG_SPRING_DAMPER_RK_ITERATIONS);
+		descriptor.m_invTimestep = dgVector (DG_SPRING_DAMPER_RK_ITERATIONS / timestep);
+		for (dgInt32 k = 0; k < DG_SPRING_DAMPER_RK_ITERATIONS; k++) {
+			DispatchKernel (CalculateLinkForcesKernel, descriptor);
+			DispatchKernel (IntegrateParticlesKernel, descriptor);
 		}
 	}
 }
@@ -40,6 +40,56 @@ class dgCollisionMassSpringDamperSystem: public dgCollisionDeformableMesh
 	virtual void CalculateAcceleration(dgFloat32 timestep);
 
 	dgInt32 GetMemoryBufferSizeInBytes() const;
+
+	bool GetImplicitSolver () const;
+	void SetImplicitSolver (bool state, dgInt32 iterations);
+
+	protected:
+	class dgSolverDescriptor;
+
+	// four links in structure of array form
+	class dgSpringDamperLinkBlock
+	{
+		public:
+		dgVector m_spring;
+		dgVector m_damper;
+		dgVector m_restlength;
+		dgInt32 m_m0[4];
+		dgInt32 m_m1[4];
+	};
+
+	void BuildLinkBlocks();
+	void DispatchKernel (dgWorkerThreadTaskCallback kernel, dgSolverDescriptor& descriptor) const;
+
+	void CalculateImplicitPositions (dgSolverDescriptor& descriptor);
+	void CalculateEnvelopeOrdering ();
+	void FactorizeSystem (dgFloat32 timestep);
+	void SolveSystem (dgVector* const rhs, dgVector* const x) const;
+
+	static void CalculateLinkForcesKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void IntegrateParticlesKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void PredictPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void ProjectLinksKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateRhsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void UpdateVelocityKernel (void* const context, void* const worldContext, dgInt32 threadID);
+
+	dgArray<dgSpringDamperLinkBlock> m_linkBlocks;
+	dgArray<dgVector> m_linkForce;
+	dgArray<dgInt32> m_particleLinksStart;
+	dgArray<dgInt32> m_particleLinks;
+	dgInt32 m_linkBlocksCount;
+
+	// implicit solver, the system matrix is factored in envelope form and reused while the time step does not change.
+	// the ordering only depends on the links, so it is calculated once and kept when the system is factored again.
+	dgArray<dgInt32> m_permutation;
+	dgArray<dgInt32> m_envelopeStart;
+	dgArray<dgInt32> m_envelopeOffset;
+	dgArray<dgFloat32> m_factor;
+	dgArray<dgFloat32> m_invDiagonal;
+	dgFloat32 m_factoredTimestep;
+	dgInt32 m_implicitIterations;
+	bool m_implicit;
+	bool m_hasEnvelope;
 };
 
 
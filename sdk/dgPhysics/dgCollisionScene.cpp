@@ -93,7 +93,7 @@ void dgCollisionScene::CollidePair (dgBroadPhase::dgPair* const pair, dgCollisio
 	const dgMatrix& otherMatrix = otherInstance->GetGlobalMatrix();
 	dgMatrix matrix (otherMatrix * myMatrix.Inverse());
 
-	const dgVector& hullVeloc = otherBody->m_veloc;
+	const dgVector& hullVeloc = otherBody->m_state->m_veloc;
 	dgFloat32 baseLinearSpeed = dgSqrt (hullVeloc.DotProduct3(hullVeloc));
 
 	dgFloat32 closestDist = dgFloat32 (1.0e10f);
@@ -103,7 +103,7 @@ void dgCollisionScene::CollidePair (dgBroadPhase::dgPair* const pair, dgCollisio
 		dgVector p1;
 		otherInstance->CalcAABB (matrix, p0, p1);
 
-		const dgVector& hullOmega = otherBody->m_omega;
+		const dgVector& hullOmega = otherBody->m_state->m_omega;
 
 		dgFloat32 minRadius = otherInstance->GetBoxMinRadius();
 		dgFloat32 maxAngularSpeed = dgSqrt (hullOmega.DotProduct3(hullOmega));
@@ -259,15 +259,15 @@ void dgCollisionScene::CollideCompoundPair (dgBroadPhase::dgPair* const pair, dg
 
 	const dgContactMaterial* const material = constraint->GetMaterial();
 
-	dgMatrix myMatrix (myCompoundInstance->GetLocalMatrix() * myBody->m_matrix);
-	dgMatrix otherMatrix (otherCompoundInstance->GetLocalMatrix() * otherBody->m_matrix);
+	dgMatrix myMatrix (myCompoundInstance->GetLocalMatrix() * myBody->m_state->m_matrix);
+	dgMatrix otherMatrix (otherCompoundInstance->GetLocalMatrix() * otherBody->m_state->m_matrix);
 	dgOOBBTestData data (otherMatrix * myMatrix.Inverse());
 
 	dgInt32 stack = 1;
 	stackPool[0][0] = m_root;
 	stackPool[0][1] = otherCompound->m_root;
 
-	const dgVector& hullVeloc = otherBody->m_veloc;
+	const dgVector& hullVeloc = otherBody->m_state->m_veloc;
 	dgFloat32 baseLinearSpeed = dgSqrt (hullVeloc.DotProduct3(hullVeloc));
 
 	dgFloat32 closestDist = dgFloat32 (1.0e10f);
@@ -300,10 +300,10 @@ void dgContact::JacobianContactDerivative (dgContraintDescritor& params, const d
 void dgContact::JointAccelerations(dgJointAccelerationDecriptor* const params)
 {
 	dgJacobianMatrixElement* const rowMatrix = params->m_rowMatrix;
-	const dgVector& bodyVeloc0 = m_body0->m_veloc;
-	const dgVector& bodyOmega0 = m_body0->m_omega;
-	const dgVector& bodyVeloc1 = m_body1->m_veloc;
-	const dgVector& bodyOmega1 = m_body1->m_omega;
+	const dgVector& bodyVeloc0 = m_body0->m_state->m_veloc;
+	const dgVector& bodyOmega0 = m_body0->m_state->m_omega;
+	const dgVector& bodyVeloc1 = m_body1->m_state->m_veloc;
+	const dgVector& bodyOmega1 = m_body1->m_state->m_omega;
 
 	const dgInt32 count = params->m_rowsCount;
 
@@ -209,14 +209,14 @@ void dgDynamicBody::SetAccel(const dgVector& accel)
 
 bool dgDynamicBody::IsInEquilibrium() const
 {
-	if (m_equilibrium) {
+	if (m_state->m_equilibrium) {
 		dgVector deltaAccel((m_externalForce - m_savedExternalForce).Scale4(m_invMass.m_w));
 		dgAssert(deltaAccel.m_w == 0.0f);
 		dgFloat32 deltaAccel2 = deltaAccel.DotProduct4(deltaAccel).GetScalar();
 		if (deltaAccel2 > DG_ERR_TOLERANCE2) {
 			return false;
 		}
-		dgVector deltaAlpha(m_matrix.UnrotateVector(m_externalTorque - m_savedExternalTorque) * m_invMass);
+		dgVector deltaAlpha(m_state->m_matrix.UnrotateVector(m_externalTorque - m_savedExternalTorque) * m_invMass);
 		dgAssert(deltaAlpha.m_w == 0.0f);
 		dgFloat32 deltaAlpha2 = deltaAlpha.DotProduct4(deltaAlpha).GetScalar();
 		if (deltaAlpha2 > DG_ERR_TOLERANCE2) {
@@ -252,14 +252,14 @@ void dgDynamicBody::AddDampingAcceleration(dgFloat32 timestep)
 	} 
 
 	if (m_linearDampOn) {
-		m_veloc = m_veloc.Scale4(m_cachedDampCoef.m_w);
+		m_state->m_veloc = m_state->m_veloc.Scale4(m_cachedDampCoef.m_w);
 	}
 
 	if (m_angularDampOn) {
 		dgVector omegaDamp(m_cachedDampCoef & dgVector::m_triplexMask);
-		dgVector omega(m_matrix.UnrotateVector(m_omega) * omegaDamp);
+		dgVector omega(m_state->m_matrix.UnrotateVector(m_state->m_omega) * omegaDamp);
 		//omega = omega * omegaDamp;
-		m_omega = m_matrix.RotateVector(omega);
+		m_state->m_omega = m_state->m_matrix.RotateVector(omega);
 	}
 }
 
@@ -274,7 +274,7 @@ void dgDynamicBody::InvalidateCache ()
 
 void dgDynamicBody::IntegrateOpenLoopExternalForce(dgFloat32 timestep)
 {
-	if (!m_equilibrium) {
+	if (!m_state->m_equilibrium) {
 		if (!m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
 			AddDampingAcceleration(timestep);
 			CalcInvInertiaMatrix();
@@ -286,7 +286,7 @@ void dgDynamicBody::IntegrateOpenLoopExternalForce(dgFloat32 timestep)
 			m_alpha = alpha;
 
 			dgVector timeStepVect(timestep);
-			m_veloc += accel * timeStepVect;
+			m_state->m_veloc += accel * timeStepVect;
 
 #if 0
 			// Using forward half step Euler integration 
@@ -297,13 +297,13 @@ void dgDynamicBody::IntegrateOpenLoopExternalForce(dgFloat32 timestep)
 			// Using forward and backward Euler integration
 			// (good to resolve high angular velocity precession) 
 			// alpha = (T * R^1 - (wl cross (wl * Il)) Il^1 * R
-			dgVector omega(m_omega);
+			dgVector omega(m_state->m_omega);
 			dgVector halfStep(dgVector::m_half.Scale4(timestep));
-			dgMatrix matrix (m_matrix);
+			dgMatrix matrix (m_state->m_matrix);
 
 			for (dgInt32 i = 0; i < 2; i++) {
 				// get forward derivative
-				dgVector localOmega(matrix.UnrotateVector(m_omega));
+				dgVector localOmega(matrix.UnrotateVector(m_state->m_omega));
 				dgVector localTorque(matrix.UnrotateVector(m_externalTorque));
 				dgVector predictDerivative(matrix.RotateVector(m_invMass * (localTorque - localOmega.CrossProduct3(localOmega * m_mass))));
 				dgVector predictOmega(omega + predictDerivative * timeStepVect);
@@ -324,9 +324,9 @@ void dgDynamicBody::IntegrateOpenLoopExternalForce(dgFloat32 timestep)
 				// calculate omega as the average of forward and backward derivatives.
 				// In theory since alpha is a quadratic function of omega, this should converge to an eact value
 				// in one at most two steps.
-				omega = m_omega + halfStep * (correctionDerivative + predictDerivative);
+				omega = m_state->m_omega + halfStep * (correctionDerivative + predictDerivative);
 			}
-			m_omega = omega;
+			m_state->m_omega = omega;
 #endif
 
 		} else {
@@ -124,6 +124,7 @@ class dgDynamicBody : public dgBody
 	friend class dgCollisionDeformableMesh;
 	friend class dgCollisionDeformableSolidMesh;
 	friend class dgCollisionMassSpringDamperSystem;
+	friend class dgCollisionIncompressibleParticles;
 } DG_GCC_VECTOR_ALIGMENT;
 
 
@@ -200,12 +201,12 @@ DG_INLINE void dgDynamicBody::SetTorque (const dgVector& torque)
 
 DG_INLINE dgVector dgDynamicBody::PredictLinearVelocity(dgFloat32 timestep) const
 {
-	return 	m_veloc + m_externalForce.Scale3 (timestep * m_invMass.m_w);
+	return 	m_state->m_veloc + m_externalForce.Scale3 (timestep * m_invMass.m_w);
 }
 
 DG_INLINE dgVector dgDynamicBody::PredictAngularVelocity(dgFloat32 timestep) const
 {
-	return m_omega + m_invWorldInertiaMatrix.RotateVector(m_externalTorque).Scale3 (timestep);
+	return m_state->m_omega + m_invWorldInertiaMatrix.RotateVector(m_externalTorque).Scale3 (timestep);
 }
 
 
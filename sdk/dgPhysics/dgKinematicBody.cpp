@@ -29,7 +29,7 @@ dgVector dgKinematicBody::m_dummy (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32
 dgKinematicBody::dgKinematicBody()
 	:dgBody()
 {
-	m_collidable = false;
+	m_state->m_collidable = false;
 	m_type = m_kinematicBody;
 	m_rtti |= m_kinematicBodyRTTI;
 }
@@ -37,7 +37,7 @@ dgKinematicBody::dgKinematicBody()
 dgKinematicBody::dgKinematicBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>* const collisionNode, dgDeserialize serializeCallback, void* const userData, dgInt32 revisionNumber)
 	:dgBody (world, collisionNode, serializeCallback, userData, revisionNumber)
 {
-	m_collidable = false;
+	m_state->m_collidable = false;
 	m_type = m_kinematicBody;
 	m_rtti |= m_kinematicBodyRTTI;
 }
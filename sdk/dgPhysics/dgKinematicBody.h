@@ -50,11 +50,11 @@ class dgKinematicBody: public dgBody
 	virtual void SetLinearDamping (dgFloat32 linearDamp) {}
 	virtual void SetAngularDamping (const dgVector& angularDamp) {}
 
-	virtual dgVector PredictLinearVelocity(dgFloat32 timestep) const {return m_veloc;}
-	virtual dgVector PredictAngularVelocity(dgFloat32 timestep) const {return m_omega;}
+	virtual dgVector PredictLinearVelocity(dgFloat32 timestep) const {return m_state->m_veloc;}
+	virtual dgVector PredictAngularVelocity(dgFloat32 timestep) const {return m_state->m_omega;}
 
 	virtual bool IsInEquilibrium  () const {return true;}
-	virtual void SetCollidable (bool state) {m_collidable = state;}
+	virtual void SetCollidable (bool state) {m_state->m_collidable = state;}
 	virtual void Serialize (const dgTree<dgInt32, const dgCollision*>& collisionRemapId, dgSerialize serializeCallback, void* const userData);
 
 	virtual void AddDampingAcceleration(dgFloat32 timestep) {}
@@ -275,6 +275,14 @@ dgCollisionInstance* dgWorld::CreateMassSpringDamperSystem (dgInt32 shapeID, dgI
 	return instance;
 }
 
+dgCollisionInstance* dgWorld::CreateIncompressibleParticles (dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity)
+{
+	dgCollision* const collision = new (m_allocator) dgCollisionIncompressibleParticles(this, pointCount, points, strideInBytes, particleRadius, restDensity);
+	dgCollisionInstance* const instance = CreateInstance(collision, shapeID, dgGetIdentityMatrix());
+	collision->Release();
+	return instance;
+}
+
 dgCollisionInstance* dgWorld::CreateDeformableSolid (dgMeshEffect* const mesh, dgInt32 shapeID)
 {
 	dgAssert (m_allocator == mesh->GetAllocator());
@@ -315,6 +323,26 @@ dgCollisionInstance* dgWorld::CreateHeightField(
 	return instance;
 }
 
+dgCollisionInstance* dgWorld::CreateTiledHeightField(
+	dgInt32 width, dgInt32 height, dgInt32 contructionMode, dgInt32 elevationDataType, 
+	dgInt32 tileSize, dgInt32 maxResidentTiles, dgFloat32 minElevation, dgFloat32 maxElevation, 
+	dgCollisionHeightFieldPageInCallback pageInCallback, void* const pageInUserData,
+	dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z)
+{
+	// the page in callback writes rows of tileSize + 1 entries, a tile size that had to be rounded would corrupt the map
+	if (!pageInCallback || (tileSize < DG_HEIGHTFIELD_PYRAMID_BLOCK_SIZE) || (tileSize & (tileSize - 1))) {
+		return NULL;
+	}
+
+	dgCollision* const collision = new  (m_allocator) dgCollisionHeightField (this, width, height, contructionMode, 
+																			  elevationDataType	? dgCollisionHeightField::m_unsigned16Bit : dgCollisionHeightField::m_float32Bit,	
+																			  verticalScale, horizontalScale_x, horizontalScale_z, 
+																			  tileSize, maxResidentTiles, minElevation, maxElevation, pageInCallback, pageInUserData);
+	dgCollisionInstance* const instance = CreateInstance (collision, 0, dgGetIdentityMatrix()); 
+	collision->Release();
+	return instance;
+}
+
 dgCollisionInstance* dgWorld::CreateInstance (const dgCollision* const child, dgInt32 shapeID, const dgMatrix& offsetMatrix)
 {
 	dgAssert (dgAbsf (offsetMatrix[0].DotProduct3(offsetMatrix[0]) - dgFloat32 (1.0f)) < dgFloat32 (1.0e-5f));
@@ -344,6 +372,60 @@ dgCollisionInstance* dgWorld::CreateCollisionFromSerialization (dgDeserialize de
 }
 
 
+bool dgWorld::SerializeCollisionImage (const dgCollisionInstance* const shape, dgSerialize serialization, void* const userData) const
+{
+	// only the static meshes have an image, the instance is not part of the image
+	const dgCollision* const collision = shape->GetChildShape();
+	dgMemoryImageWriter image (m_allocator, collision->GetCollisionPrimityType());
+	if (collision->IsType (dgCollision::dgCollisionBVH_RTTI)) {
+		((dgCollisionBVH*) collision)->SerializeImage (image);
+	} else if (collision->IsType (dgCollision::dgCollisionHeightField_RTTI)) {
+		if (!((dgCollisionHeightField*) collision)->SerializeImage (image)) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	image.Write (serialization, userData);
+	return true;
+}
+
+dgCollisionInstance* dgWorld::CreateCollisionFromImage (const void* const imageData, dgInt64 sizeInBytes)
+{
+	dgMemoryImageReader image (imageData, sizeInBytes);
+	if (!image.IsValid()) {
+		return NULL;
+	}
+
+	dgCollision* collision = NULL;
+	switch (image.GetType())
+	{
+		case m_boundingBoxHierachy:
+		{
+			collision = new (m_allocator) dgCollisionBVH (this, image);
+			break;
+		}
+
+		case m_heightField:
+		{
+			collision = new (m_allocator) dgCollisionHeightField (this, image);
+			break;
+		}
+
+		default:
+			return NULL;
+	}
+
+	if (!image.IsValid()) {
+		collision->Release();
+		return NULL;
+	}
+	dgCollisionInstance* const instance = CreateInstance (collision, 0, dgGetIdentityMatrix()); 
+	collision->Release();
+	return instance;
+}
+
+
 dgContactMaterial* dgWorld::GetMaterial (dgUnsigned32 bodyGroupId0, dgUnsigned32 bodyGroupId1)	const
 {
 	if (bodyGroupId0 > bodyGroupId1) {
@@ -444,11 +526,11 @@ dgInt32 dgWorld::ClosestPoint(const dgCollisionInstance* const collisionSrcA, co
 	dgCollisionInstance collisionA(*collisionSrcA, collisionSrcA->GetChildShape());
 	dgCollisionInstance collisionB(*collisionSrcB, collisionSrcB->GetChildShape());
 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.m_state->m_matrix = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collisionA.SetGlobalMatrix(collisionA.GetLocalMatrix() * matrixA);
 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.m_state->m_matrix = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collisionB.SetGlobalMatrix (collisionB.GetLocalMatrix() * matrixB);
 
@@ -509,21 +591,27 @@ bool dgWorld::IntersectionTest (const dgCollisionInstance* const collisionSrcA,
 
 	collideBodyA.m_world = this;
 	collideBodyA.SetContinueCollisionMode(false); 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.m_state->m_matrix = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collideBodyA.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
 	collideBodyB.m_world = this;
 	collideBodyB.SetContinueCollisionMode(false); 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.m_state->m_matrix = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collideBodyB.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
+	return IntersectionTest (&collideBodyA, &collideBodyB, threadIndex);
+}
+
+bool dgWorld::IntersectionTest (dgBody* const body0, dgBody* const body1, dgInt32 threadIndex)
+{
 	dgContactMaterial material; 
 	material.m_penetration = dgFloat32 (0.0f);
 
+	// the contact only lives on the stack to drive the narrow phase, it is never attached to the bodies
 	dgContact contactJoint (this, &material);
-	contactJoint.SetBodies (&collideBodyA, &collideBodyB);
+	contactJoint.SetBodies (body0, body1);
 
 	dgBroadPhase::dgPair pair;
 	pair.m_contactCount = 0;
@@ -790,12 +878,12 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 		count ++;
 	}
 
-	const dgVector& v0 = body0->m_veloc;
-	const dgVector& w0 = body0->m_omega;
+	const dgVector& v0 = body0->m_state->m_veloc;
+	const dgVector& w0 = body0->m_state->m_omega;
 	const dgVector& com0 = body0->m_globalCentreOfMass;
 
-	const dgVector& v1 = body1->m_veloc;
-	const dgVector& w1 = body1->m_omega;
+	const dgVector& v1 = body1->m_state->m_veloc;
+	const dgVector& w1 = body1->m_state->m_omega;
 	const dgVector& com1 = body1->m_globalCentreOfMass;
 
 	dgVector controlDir0 (dgFloat32 (0.0f));
@@ -846,9 +934,7 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 			nodes[index] = nodes[count];
 			cachePosition[index] = cachePosition[count];
 		} else {
-			GlobalLock(false);
 			contactNode = list.Append ();
-			GlobalUnlock();
 		}
 
 		dgContactMaterial* const contactMaterial = &contactNode->GetInfo();
@@ -942,11 +1028,9 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 	}
 
 	if (count) {
-		GlobalLock(false);
 		for (dgInt32 i = 0; i < count; i ++) {
 			list.Remove(nodes[i]);
 		}
-		GlobalUnlock();
 	}
 
 	contact->m_maxDOF = dgUnsigned32 (3 * contact->GetCount());
@@ -1212,22 +1296,22 @@ dgInt32 dgWorld::CollideContinue (
 
 	collideBodyA.m_world = this;
 	collideBodyA.SetContinueCollisionMode(true); 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.m_state->m_matrix = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collideBodyA.m_masterNode = NULL;
 	collideBodyA.m_broadPhaseNode = NULL;
-	collideBodyA.m_veloc = dgVector (velocA[0], velocA[1], velocA[2], dgFloat32 (0.0f));
-	collideBodyA.m_omega = dgVector (omegaA[0], omegaA[1], omegaA[2], dgFloat32 (0.0f));
+	collideBodyA.m_state->m_veloc = dgVector (velocA[0], velocA[1], velocA[2], dgFloat32 (0.0f));
+	collideBodyA.m_state->m_omega = dgVector (omegaA[0], omegaA[1], omegaA[2], dgFloat32 (0.0f));
 	collisionA.SetGlobalMatrix(collisionA.GetLocalMatrix() * matrixA);
 
 	collideBodyB.m_world = this;
 	collideBodyB.SetContinueCollisionMode(true); 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.m_state->m_matrix = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collideBodyB.m_masterNode = NULL;
 	collideBodyB.m_broadPhaseNode = NULL;
-	collideBodyB.m_veloc = dgVector (velocB[0], velocB[1], velocB[2], dgFloat32 (0.0f));
-	collideBodyB.m_omega = dgVector (omegaB[0], omegaB[1], omegaB[2], dgFloat32 (0.0f));
+	collideBodyB.m_state->m_veloc = dgVector (velocB[0], velocB[1], velocB[2], dgFloat32 (0.0f));
+	collideBodyB.m_state->m_omega = dgVector (omegaB[0], omegaB[1], omegaB[2], dgFloat32 (0.0f));
 	collisionB.SetGlobalMatrix(collisionB.GetLocalMatrix() * matrixB);
 
 	dgContactMaterial material;
@@ -1256,7 +1340,7 @@ dgInt32 dgWorld::CollideContinue (
 		//dgFloat32 swapContactScale = (contactJoint.GetBody0() != &collideBodyA) ? dgFloat32 (-1.0f) : dgFloat32 (1.0f);
 		if (pair.m_flipContacts) {
  			for (dgInt32 i = 0; i < count; i++) {
-				dgVector step ((collideBodyA.m_veloc - collideBodyB.m_veloc).Scale4 (pair.m_timestep));
+				dgVector step ((collideBodyA.m_state->m_veloc - collideBodyB.m_state->m_veloc).Scale4 (pair.m_timestep));
 				points[i].m_x = contacts[i].m_point.m_x + step.m_x;
 				points[i].m_y = contacts[i].m_point.m_y + step.m_y;
 				points[i].m_z = contacts[i].m_point.m_z + step.m_z;
@@ -1306,13 +1390,13 @@ dgInt32 dgWorld::Collide (
 		
 	collideBodyA.m_world = this;
 	collideBodyA.SetContinueCollisionMode(false); 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.m_state->m_matrix = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collideBodyA.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
 	collideBodyB.m_world = this;
 	collideBodyB.SetContinueCollisionMode(false); 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.m_state->m_matrix = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collideBodyB.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
@@ -1571,8 +1655,8 @@ dgInt32 dgWorld::CalculateConvexToNonConvexContacts(dgCollisionParamProxy& proxy
 		if (proxy.m_continueCollision) {
 			data.m_doContinuesCollisionTest = true;
 
-			const dgVector& hullVeloc = data.m_objBody->m_veloc;
-			const dgVector& hullOmega = data.m_objBody->m_omega;
+			const dgVector& hullVeloc = data.m_objBody->m_state->m_veloc;
+			const dgVector& hullOmega = data.m_objBody->m_state->m_omega;
 
 			dgFloat32 baseLinearSpeed = dgSqrt(hullVeloc.DotProduct3(hullVeloc));
 			if (baseLinearSpeed > dgFloat32(1.0e-6f)) {
@@ -30,6 +30,7 @@
 #include "dgCollision.h"
 #include "dgMeshEffect.h"
 #include "dgConstraint.h"
+#include "dgSensorBody.h"
 #include "dgDynamicBody.h"
 #include "dgCollisionBVH.h"
 #include "dgContactSolver.h"
@@ -55,6 +56,8 @@
 #include "dgCollisionDeformableMesh.h"
 #include "dgCollisionCompoundFractured.h"
 #include "dgCollisionLumpedMassParticles.h"
+#include "dgCollisionIncompressibleParticles.h"
+#include "dgCollisionMassSpringDamperSystem.h"
 
 #endif 
 
@@ -0,0 +1,62 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "dgPhysicsStdafx.h"
+#include "dgSensorBody.h"
+
+
+dgSensorBody::dgSensorBody()
+	:dgKinematicBody()
+	,m_sensorMatrix(dgGetZeroMatrix())
+	,m_sensorCallback(NULL)
+{
+	m_type = m_sensorBody;
+	m_rtti |= m_sensorBodyRTTI;
+}
+
+dgSensorBody::dgSensorBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>* const collisionNode, dgDeserialize serializeCallback, void* const userData, dgInt32 revisionNumber)
+	:dgKinematicBody (world, collisionNode, serializeCallback, userData, revisionNumber)
+	,m_sensorMatrix(dgGetZeroMatrix())
+	,m_sensorCallback(NULL)
+{
+	m_type = m_sensorBody;
+	m_rtti |= m_sensorBodyRTTI;
+}
+
+dgSensorBody::~dgSensorBody ()
+{
+}
+
+void dgSensorBody::Serialize (const dgTree<dgInt32, const dgCollision*>& collisionRemapId, dgSerialize serializeCallback, void* const userData)
+{
+	dgKinematicBody::Serialize (collisionRemapId, serializeCallback, userData);
+}
+
+bool dgSensorBody::UpdateSensorMatrix ()
+{
+	// kinematic bodies are always in equilibrium, so a sensor that was moved by the application 
+	// would never refresh its broadphase node, instead it is flagged as moving for one frame
+	const dgVector equal ((m_state->m_matrix.m_front == m_sensorMatrix.m_front) & (m_state->m_matrix.m_up == m_sensorMatrix.m_up) & 
+						  (m_state->m_matrix.m_right == m_sensorMatrix.m_right) & (m_state->m_matrix.m_posit == m_sensorMatrix.m_posit));
+	m_sensorMatrix = m_state->m_matrix;
+	return equal.GetSignMask() != 0x0f;
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef _DG_SENSOR_BODY_H_
+#define _DG_SENSOR_BODY_H_
+
+#include "dgPhysicsStdafx.h"
+#include "dgKinematicBody.h"
+
+
+// a sensor is a kinematic volume that never generates contacts, the broadphase 
+// tests it against the dynamics bodies overlapping its aabb with an exact shape 
+// intersection test and report the overlap begin, persist and end events after the step  
+DG_MSC_VECTOR_ALIGMENT
+class dgSensorBody: public dgKinematicBody 
+{
+	public:
+	enum dgSensorEventType
+	{
+		m_overlapBegin = 0,
+		m_overlapPersist,
+		m_overlapEnd,
+	};
+
+	typedef void (dgApi *OnSensorEvent) (dgSensorBody& sensor, dgBody& body, dgSensorEventType eventType);
+
+	dgSensorBody();
+	dgSensorBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>* const collisionNode, dgDeserialize serializeCallback, void* const userData, dgInt32 revisionNumber);
+	virtual ~dgSensorBody ();
+
+	OnSensorEvent GetSensorCallback () const;
+	void SetSensorCallback (OnSensorEvent callback);
+
+	virtual void SetCollidable (bool state) {}
+	virtual void Serialize (const dgTree<dgInt32, const dgCollision*>& collisionRemapId, dgSerialize serializeCallback, void* const userData);
+
+	private:
+	bool UpdateSensorMatrix ();
+
+	dgMatrix m_sensorMatrix;
+	OnSensorEvent m_sensorCallback;
+
+	friend class dgWorld;
+	friend class dgBroadPhase;
+} DG_GCC_VECTOR_ALIGMENT;
+
+
+DG_INLINE dgSensorBody::OnSensorEvent dgSensorBody::GetSensorCallback () const
+{
+	return m_sensorCallback;
+}
+
+DG_INLINE void dgSensorBody::SetSensorCallback (OnSensorEvent callback)
+{
+	m_sensorCallback = callback;
+}
+
+#endif 
+
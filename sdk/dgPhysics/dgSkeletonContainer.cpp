@@ -599,6 +599,72 @@ void dgSkeletonContainer::Finalize(dgInt32 loopJointsCount, dgBilateralConstrain
 }
 
 
+// computes four entries of a mass matrix block row at a time. the transpose puts the 
+// four products in separate lanes, so each entry is reduced in the same order as AddHorizontal 
+DG_INLINE void dgSkeletonContainer::CalculateBlockRow(dgFloat32* const row, const dgJacobian& JMinv, dgJacobianMatrixElement** const rowArray, dgInt32 count, dgJacobian dgJacobianPair::* const jacobian) const
+{
+	dgInt32 j = 0;
+	for (; j < (count - 3); j += 4) {
+		const dgJacobian& Jt0 = rowArray[j + 0]->m_Jt.*jacobian;
+		const dgJacobian& Jt1 = rowArray[j + 1]->m_Jt.*jacobian;
+		const dgJacobian& Jt2 = rowArray[j + 2]->m_Jt.*jacobian;
+		const dgJacobian& Jt3 = rowArray[j + 3]->m_Jt.*jacobian;
+
+		dgVector dot0;
+		dgVector dot1;
+		dgVector dot2;
+		dgVector dot3;
+		dgVector::Transpose4x4(dot0, dot1, dot2, dot3, 
+							   JMinv.m_linear * Jt0.m_linear + JMinv.m_angular * Jt0.m_angular,
+							   JMinv.m_linear * Jt1.m_linear + JMinv.m_angular * Jt1.m_angular,
+							   JMinv.m_linear * Jt2.m_linear + JMinv.m_angular * Jt2.m_angular,
+							   JMinv.m_linear * Jt3.m_linear + JMinv.m_angular * Jt3.m_angular);
+		((dot0 + dot1) + (dot2 + dot3)).Store(&row[j]);
+	}
+
+	for (; j < count; j++) {
+		const dgJacobian& Jt = rowArray[j]->m_Jt.*jacobian;
+		dgVector Aij(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
+		row[j] = Aij.AddHorizontal().GetScalar();
+	}
+}
+
+DG_INLINE void dgSkeletonContainer::CalculateBlockRow(dgFloat32* const row, const dgJacobianPair& JMinv, dgJacobianMatrixElement** const rowArray, dgInt32 count) const
+{
+	const dgJacobian& JMinvM0 = JMinv.m_jacobianM0;
+	const dgJacobian& JMinvM1 = JMinv.m_jacobianM1;
+
+	dgInt32 j = 0;
+	for (; j < (count - 3); j += 4) {
+		const dgJacobianPair& Jt0 = rowArray[j + 0]->m_Jt;
+		const dgJacobianPair& Jt1 = rowArray[j + 1]->m_Jt;
+		const dgJacobianPair& Jt2 = rowArray[j + 2]->m_Jt;
+		const dgJacobianPair& Jt3 = rowArray[j + 3]->m_Jt;
+
+		dgVector dot0;
+		dgVector dot1;
+		dgVector dot2;
+		dgVector dot3;
+		dgVector::Transpose4x4(dot0, dot1, dot2, dot3, 
+							   JMinvM0.m_linear * Jt0.m_jacobianM0.m_linear + JMinvM0.m_angular * Jt0.m_jacobianM0.m_angular +
+							   JMinvM1.m_linear * Jt0.m_jacobianM1.m_linear + JMinvM1.m_angular * Jt0.m_jacobianM1.m_angular,
+							   JMinvM0.m_linear * Jt1.m_jacobianM0.m_linear + JMinvM0.m_angular * Jt1.m_jacobianM0.m_angular +
+							   JMinvM1.m_linear * Jt1.m_jacobianM1.m_linear + JMinvM1.m_angular * Jt1.m_jacobianM1.m_angular,
+							   JMinvM0.m_linear * Jt2.m_jacobianM0.m_linear + JMinvM0.m_angular * Jt2.m_jacobianM0.m_angular +
+							   JMinvM1.m_linear * Jt2.m_jacobianM1.m_linear + JMinvM1.m_angular * Jt2.m_jacobianM1.m_angular,
+							   JMinvM0.m_linear * Jt3.m_jacobianM0.m_linear + JMinvM0.m_angular * Jt3.m_jacobianM0.m_angular +
+							   JMinvM1.m_linear * Jt3.m_jacobianM1.m_linear + JMinvM1.m_angular * Jt3.m_jacobianM1.m_angular);
+		((dot0 + dot1) + (dot2 + dot3)).Store(&row[j]);
+	}
+
+	for (; j < count; j++) {
+		const dgJacobianPair& Jt = rowArray[j]->m_Jt;
+		dgVector Aij(JMinvM0.m_linear * Jt.m_jacobianM0.m_linear + JMinvM0.m_angular * Jt.m_jacobianM0.m_angular +
+					 JMinvM1.m_linear * Jt.m_jacobianM1.m_linear + JMinvM1.m_angular * Jt.m_jacobianM1.m_angular);
+		row[j] = Aij.AddHorizontal().GetScalar();
+	}
+}
+
 DG_INLINE void dgSkeletonContainer::CalculateBlock_GijJij(const dgJointInfo* const jointInfoArray, const dgNode* const auxiliaryNode, const dgNode* const primaryNode)
 {
 	const dgJointInfo* const auxiliaryInfo = &jointInfoArray[auxiliaryNode->m_joint->m_index];
@@ -614,18 +680,7 @@ DG_INLINE void dgSkeletonContainer::CalculateBlock_GijJij(const dgJointInfo* con
 	for (dgInt32 i = 0; i < auxiliaryDof; i++) {
 		dgFloat32* const matrixRow10 = &m_massMatrix10[primaryCount * (auxiliaryStart + i)];
 		const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
-
-		const dgJacobian& JMinvM0 = auxiliaryRow->m_JMinv.m_jacobianM0;
-		const dgJacobian& JMinvM1 = auxiliaryRow->m_JMinv.m_jacobianM1;
-		for (dgInt32 j = 0; j < primaryDof; j++) {
-			const dgJacobianMatrixElement* const primaryRow = m_rowArray[primaryStart + j];
-			const dgJacobian& JtM0 = primaryRow->m_Jt.m_jacobianM0;
-			const dgJacobian& JtM1 = primaryRow->m_Jt.m_jacobianM1;
-
-			dgVector Aii(JMinvM0.m_linear * JtM0.m_linear + JMinvM0.m_angular * JtM0.m_angular +
-						 JMinvM1.m_linear * JtM1.m_linear + JMinvM1.m_angular * JtM1.m_angular);
-			matrixRow10[primaryStart + j] = Aii.AddHorizontal().GetScalar();
-		}
+		CalculateBlockRow(&matrixRow10[primaryStart], auxiliaryRow->m_JMinv, &m_rowArray[primaryStart], primaryDof);
 	}
 }
 
@@ -647,60 +702,23 @@ DG_INLINE void dgSkeletonContainer::CalculateBlock_GikJkj(const dgJointInfo* con
 	const dgInt32 primaryStart = primaryNode->m_primaryStart;
 	const dgInt32 auxiliaryStart = auxiliaryNode->m_auxiliaryStart;
 
+	dgJacobian dgJacobianPair::* JMinvSide = &dgJacobianPair::m_jacobianM0;
+	dgJacobian dgJacobianPair::* JtSide = &dgJacobianPair::m_jacobianM0;
 	if (primaryM1_i == auxiliaryM0_j) {
-		for (dgInt32 i = 0; i < auxiliaryDof; i++) {
-			dgFloat32* const matrixRow10 = &m_massMatrix10[primaryCount * (auxiliaryStart + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
-			const dgJacobian& JMinv = auxiliaryRow->m_JMinv.m_jacobianM0;
-
-			for (dgInt32 j = 0; j < primaryDof; j++) {
-				const dgJacobianMatrixElement* const primaryRow = m_rowArray[primaryStart + j];
-				const dgJacobian& Jt = primaryRow->m_Jt.m_jacobianM1;
-				dgVector Aii(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				matrixRow10[primaryStart + j] = Aii.AddHorizontal().GetScalar();
-			}
-		}
+		JtSide = &dgJacobianPair::m_jacobianM1;
 	} else if (primaryM1_i == auxiliaryM1_j) {
-		for (dgInt32 i = 0; i < auxiliaryDof; i++) {
-			dgFloat32* const matrixRow10 = &m_massMatrix10[primaryCount * (auxiliaryStart + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
-			const dgJacobian& JMinv = auxiliaryRow->m_JMinv.m_jacobianM1;
-
-			for (dgInt32 j = 0; j < primaryDof; j++) {
-				const dgJacobianMatrixElement* const primaryRow = m_rowArray[primaryStart + j];
-				const dgJacobian& Jt = primaryRow->m_Jt.m_jacobianM1;
-				dgVector Aii(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				matrixRow10[primaryStart + j] = Aii.AddHorizontal().GetScalar();
-			}
-		}
+		JMinvSide = &dgJacobianPair::m_jacobianM1;
+		JtSide = &dgJacobianPair::m_jacobianM1;
 	} else if (primaryM0_i == auxiliaryM1_j) {
-		for (dgInt32 i = 0; i < auxiliaryDof; i++) {
-			dgFloat32* const matrixRow10 = &m_massMatrix10[primaryCount * (auxiliaryStart + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
-			const dgJacobian& JMinv = auxiliaryRow->m_JMinv.m_jacobianM1;
-
-			for (dgInt32 j = 0; j < primaryDof; j++) {
-				const dgJacobianMatrixElement* const primaryRow = m_rowArray[primaryStart + j];
-				const dgJacobian& Jt = primaryRow->m_Jt.m_jacobianM0;
-				dgVector Aii(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				matrixRow10[primaryStart + j] = Aii.AddHorizontal().GetScalar();
-			}
-		}
+		JMinvSide = &dgJacobianPair::m_jacobianM1;
 	} else {
 		dgAssert (primaryM0_i == auxiliaryM0_j);
+	}
 
-		for (dgInt32 i = 0; i < auxiliaryDof; i++) {
-			dgFloat32* const matrixRow10 = &m_massMatrix10[primaryCount * (auxiliaryStart + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
-			const dgJacobian& JMinv = auxiliaryRow->m_JMinv.m_jacobianM0;
-
-			for (dgInt32 j = 0; j < primaryDof; j++) {
-				const dgJacobianMatrixElement* const primaryRow = m_rowArray[primaryStart + j];
-				const dgJacobian& Jt = primaryRow->m_Jt.m_jacobianM0;
-				dgVector Aii(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				matrixRow10[primaryStart + j] = Aii.AddHorizontal().GetScalar();
-			}
-		}
+	for (dgInt32 i = 0; i < auxiliaryDof; i++) {
+		dgFloat32* const matrixRow10 = &m_massMatrix10[primaryCount * (auxiliaryStart + i)];
+		const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
+		CalculateBlockRow(&matrixRow10[primaryStart], auxiliaryRow->m_JMinv.*JMinvSide, &m_rowArray[primaryStart], primaryDof, JtSide);
 	}
 }
 
@@ -718,27 +736,14 @@ DG_INLINE void dgSkeletonContainer::CalculateBlock_GijGij(const dgJointInfo* con
 		dgFloat32* const matrixRow11 = &m_massMatrix11[auxiliaryCount * (auxiliaryStart + i)];
 		const dgJacobianMatrixElement* const auxiliaryRow = m_rowArray[primaryCount + auxiliaryStart + i];
 
-		const dgJacobian& JMinvM0 = auxiliaryRow->m_JMinv.m_jacobianM0;
-		const dgJacobian& JMinvM1 = auxiliaryRow->m_JMinv.m_jacobianM1;
-		const dgJacobian& JtM0 = auxiliaryRow->m_Jt.m_jacobianM0;
-		const dgJacobian& JtM1 = auxiliaryRow->m_Jt.m_jacobianM1;
-
-		dgVector Aii(JMinvM0.m_linear * JtM0.m_linear + JMinvM0.m_angular * JtM0.m_angular +
-					 JMinvM1.m_linear * JtM1.m_linear + JMinvM1.m_angular * JtM1.m_angular);
-		dgFloat32 diagonal = Aii.AddHorizontal().GetScalar() + auxiliaryRow->m_diagDamp * dgFloat32(2.0f);
+		// the row starts at the diagonal, the upper triangle is mirrored below it
+		CalculateBlockRow(&matrixRow11[auxiliaryStart + i], auxiliaryRow->m_JMinv, &m_rowArray[primaryCount + auxiliaryStart + i], auxiliaryDof - i);
+		dgFloat32 diagonal = matrixRow11[auxiliaryStart + i] + auxiliaryRow->m_diagDamp * dgFloat32(2.0f);
 		matrixRow11[auxiliaryStart + i] = diagonal;
 		diagDamp[auxiliaryStart + i] = diagonal * (DG_PSD_DAMP_TOL * dgFloat32(2.0f));
 
 		for (dgInt32 j = i + 1; j < auxiliaryDof; j++) {
-			const dgJacobianMatrixElement* const auxiliaryRowJ = m_rowArray[primaryCount + auxiliaryStart + j];
-			const dgJacobian& JtM0_1 = auxiliaryRowJ->m_Jt.m_jacobianM0;
-			const dgJacobian& JtM1_1 = auxiliaryRowJ->m_Jt.m_jacobianM1;
-
-			dgVector Aij(JMinvM0.m_linear * JtM0_1.m_linear + JMinvM0.m_angular * JtM0_1.m_angular +
-						 JMinvM1.m_linear * JtM1_1.m_linear + JMinvM1.m_angular * JtM1_1.m_angular);
-			dgFloat32 offDiagValue = Aij.AddHorizontal().GetScalar();
-			matrixRow11[auxiliaryStart + j] = offDiagValue;
-			m_massMatrix11[(auxiliaryStart + j) * m_auxiliaryRowCount + auxiliaryStart + i] = offDiagValue;
+			m_massMatrix11[(auxiliaryStart + j) * m_auxiliaryRowCount + auxiliaryStart + i] = matrixRow11[auxiliaryStart + j];
 		}
 	}
 }
@@ -762,67 +767,25 @@ void dgSkeletonContainer::CalculateBlock_GikGkj(const dgJointInfo* const jointIn
 	const dgInt32 auxiliaryStart_I = auxiliaryNodeI->m_auxiliaryStart;
 	const dgInt32 auxiliaryStart_J = auxiliaryNodeJ->m_auxiliaryStart;
 
+	dgJacobian dgJacobianPair::* JMinvSide = &dgJacobianPair::m_jacobianM0;
+	dgJacobian dgJacobianPair::* JtSide = &dgJacobianPair::m_jacobianM0;
 	if (auxiliaryM1_i == auxiliaryM0_j) {
-		for (dgInt32 i = 0; i < auxiliaryDof_I; i++) {
-			dgFloat32* const matrixRow11 = &m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_I + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow_I = m_rowArray[primaryCount + auxiliaryStart_I + i];
-			const dgJacobian& JMinv = auxiliaryRow_I->m_JMinv.m_jacobianM1;
-
-			for (dgInt32 j = 0; j < auxiliaryDof_J; j++) {
-				const dgJacobianMatrixElement* const auxiliaryRow_J = m_rowArray[primaryCount + auxiliaryStart_J + j];
-				const dgJacobian& Jt = auxiliaryRow_J->m_Jt.m_jacobianM0;
-				dgVector Aij(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				dgFloat32 offDiagValue = Aij.AddHorizontal().GetScalar();
-				matrixRow11[auxiliaryStart_J + j] = offDiagValue;
-				m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_J + j) + auxiliaryStart_I + i] = offDiagValue;
-			}
-		}
+		JMinvSide = &dgJacobianPair::m_jacobianM1;
 	} else if (auxiliaryM1_i == auxiliaryM1_j) {
-		for (dgInt32 i = 0; i < auxiliaryDof_I; i++) {
-			dgFloat32* const matrixRow11 = &m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_I + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow_I = m_rowArray[primaryCount + auxiliaryStart_I + i];
-			const dgJacobian& JMinv = auxiliaryRow_I->m_JMinv.m_jacobianM1;
-
-			for (dgInt32 j = 0; j < auxiliaryDof_J; j++) {
-				const dgJacobianMatrixElement* const auxiliaryRow_J = m_rowArray[primaryCount + auxiliaryStart_J + j];
-				const dgJacobian& Jt = auxiliaryRow_J->m_Jt.m_jacobianM1;
-				dgVector Aij(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				dgFloat32 offDiagValue = Aij.AddHorizontal().GetScalar();
-				matrixRow11[auxiliaryStart_J + j] = offDiagValue;
-				m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_J + j) + auxiliaryStart_I + i] = offDiagValue;
-			}
-		}
+		JMinvSide = &dgJacobianPair::m_jacobianM1;
+		JtSide = &dgJacobianPair::m_jacobianM1;
 	} else if (auxiliaryM0_i == auxiliaryM1_j) {
-		for (dgInt32 i = 0; i < auxiliaryDof_I; i++) {
-			dgFloat32* const matrixRow11 = &m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_I + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow_I = m_rowArray[primaryCount + auxiliaryStart_I + i];
-			const dgJacobian& JMinv = auxiliaryRow_I->m_JMinv.m_jacobianM0;
-
-			for (dgInt32 j = 0; j < auxiliaryDof_J; j++) {
-				const dgJacobianMatrixElement* const auxiliaryRow_J = m_rowArray[primaryCount + auxiliaryStart_J + j];
-				const dgJacobian& Jt = auxiliaryRow_J->m_Jt.m_jacobianM1;
-				dgVector Aij(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				dgFloat32 offDiagValue = Aij.AddHorizontal().GetScalar();
-				matrixRow11[auxiliaryStart_J + j] = offDiagValue;
-				m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_J + j) + auxiliaryStart_I + i] = offDiagValue;
-			}
-		}
+		JtSide = &dgJacobianPair::m_jacobianM1;
 	} else {
 		dgAssert(auxiliaryM0_i == auxiliaryM0_j);
+	}
 
-		for (dgInt32 i = 0; i < auxiliaryDof_I; i++) {
-			dgFloat32* const matrixRow11 = &m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_I + i)];
-			const dgJacobianMatrixElement* const auxiliaryRow_I = m_rowArray[primaryCount + auxiliaryStart_I + i];
-			const dgJacobian& JMinv = auxiliaryRow_I->m_JMinv.m_jacobianM0;
-
-			for (dgInt32 j = 0; j < auxiliaryDof_J; j++) {
-				const dgJacobianMatrixElement* const auxiliaryRow_J = m_rowArray[primaryCount + auxiliaryStart_J + j];
-				const dgJacobian& Jt = auxiliaryRow_J->m_Jt.m_jacobianM0;
-				dgVector Aij(JMinv.m_linear * Jt.m_linear + JMinv.m_angular * Jt.m_angular);
-				dgFloat32 offDiagValue = Aij.AddHorizontal().GetScalar();
-				matrixRow11[auxiliaryStart_J + j] = offDiagValue;
-				m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_J + j) + auxiliaryStart_I + i] = offDiagValue;
-			}
+	for (dgInt32 i = 0; i < auxiliaryDof_I; i++) {
+		dgFloat32* const matrixRow11 = &m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_I + i)];
+		const dgJacobianMatrixElement* const auxiliaryRow_I = m_rowArray[primaryCount + auxiliaryStart_I + i];
+		CalculateBlockRow(&matrixRow11[auxiliaryStart_J], auxiliaryRow_I->m_JMinv.*JMinvSide, &m_rowArray[primaryCount + auxiliaryStart_J], auxiliaryDof_J, JtSide);
+		for (dgInt32 j = 0; j < auxiliaryDof_J; j++) {
+			m_massMatrix11[auxiliaryRowCount * (auxiliaryStart_J + j) + auxiliaryStart_I + i] = matrixRow11[auxiliaryStart_J + j];
 		}
 	}
 }
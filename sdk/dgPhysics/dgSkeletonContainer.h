@@ -77,6 +77,8 @@ class dgSkeletonContainer
 	DG_INLINE void UpdateForces(dgJointInfo* const jointInfoArray, dgJacobian* const internalForces, dgJacobianMatrixElement* const matrixRow, const dgForcePair* const force) const;
 	DG_INLINE void CalculateJointAccel (dgJointInfo* const jointInfoArray, const dgJacobian* const internalForces, dgJacobianMatrixElement* const matrixRow, dgForcePair* const accel) const;
 
+	DG_INLINE void CalculateBlockRow(dgFloat32* const row, const dgJacobian& JMinv, dgJacobianMatrixElement** const rowArray, dgInt32 count, dgJacobian dgJacobianPair::* const jacobian) const;
+	DG_INLINE void CalculateBlockRow(dgFloat32* const row, const dgJacobianPair& JMinv, dgJacobianMatrixElement** const rowArray, dgInt32 count) const;
 	DG_INLINE void CalculateMassMatrixCoeffBruteForce(dgInt32 loopStart, dgFloat32* const diagDamp);
 	DG_INLINE void CalculateMassMatrixCoeff(const dgJointInfo* const jointInfoArray, dgFloat32* const diagDamp);
 	DG_INLINE void CalculateBlock_GijGij(const dgJointInfo* const jointInfoArray, const dgNode* const auxiliaryNode, dgFloat32* const diagDamp);
@@ -24,6 +24,7 @@
 
 #include "dgDynamicBody.h"
 #include "dgKinematicBody.h"
+#include "dgSensorBody.h"
 #include "dgCollisionBox.h"
 #include "dgKinematicBody.h"
 #include "dgCollisionNull.h"
@@ -35,6 +36,7 @@
 #include "dgBroadPhaseDefault.h"
 #include "dgCollisionInstance.h"
 #include "dgCollisionCompound.h"
+#include "dgCollisionHeightField.h"
 #include "dgWorldDynamicUpdate.h"
 #include "dgCollisionConvexHull.h"
 #include "dgBroadPhasePersistent.h"
@@ -212,9 +214,11 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	,m_bodiesMemory (allocator, 64)
 	,m_jointsMemory (allocator, 64)
 	,m_solverJacobiansMemory (allocator, 64)
-	,m_solverForceAccumulatorMemory (allocator, 64)
 	,m_clusterMemory (allocator, 64)
 	,m_stack(allocator)
+	,m_threadArena(NULL)
+	,m_performanceCounters(allocator)
+	,m_lastPerformanceCounters(allocator)
 	,m_postUpdateCallback(NULL)
 {
 	dgMutexThread* const mutexThread = this;
@@ -225,7 +229,7 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_jointsMemory.Resize(1024 * 32);
 	m_clusterMemory.Resize(1024 * 32);
 	m_solverJacobiansMemory.Resize(1024 * 64);
-	m_solverForceAccumulatorMemory.Resize(1024 * 32);
+	m_solverArena.SetAllocator(allocator);
 
 	m_savetimestep = dgFloat32 (0.0f);
 	m_allocator = allocator;
@@ -241,6 +245,9 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_inUpdate = 0;
 	m_bodyGroupID = 0;
 	m_lastExecutionTime = 0;
+	m_lastPerformanceThreadCount = 0;
+	m_performanceCountersEnabled = false;
+	memset (m_lastPerformanceCounts, 0, sizeof (m_lastPerformanceCounts));
 	
 	m_defualtBodyGroupID = CreateBodyGroupID();
 	m_genericLRUMark = 0;
@@ -319,6 +326,7 @@ dgWorld::~dgWorld()
 	DestroyBody (m_sentinelBody);
 
 	delete m_broadPhase;
+	delete[] m_threadArena;
 }
 
 
@@ -365,6 +373,25 @@ void dgWorld::DestroyAllBodies()
 void dgWorld::SetThreadsCount (dgInt32 count)
 {
 	dgThreadHive::SetThreadsCount(count);
+
+	// all per thread buffers are sized to the worker count, not to the largest possible hive
+	const dgInt32 threadCount = GetThreadCount();
+	if (m_threadArena) {
+		delete[] m_threadArena;
+	}
+	m_threadArena = new (m_allocator) dgFrameArena[threadCount];
+	for (dgInt32 i = 0; i < threadCount; i ++) {
+		m_threadArena[i].SetAllocator(m_allocator);
+	}
+
+	m_performanceCounters.Resize(threadCount);
+	m_lastPerformanceCounters.Resize(threadCount);
+	m_lastPerformanceThreadCount = 0;
+
+	if (m_broadPhase) {
+		m_broadPhase->SetThreadsCount(threadCount);
+	}
+	dgCollisionHeightField::SetThreadsCount(this, threadCount);
 }
 
 dgUnsigned32 dgWorld::GetPerformanceCount ()
@@ -386,6 +413,79 @@ dgDynamicBody* dgWorld::GetSentinelBody() const
 	return m_sentinelBody;
 }
 
+// arena zero holds the solver memory, arena i + 1 is the scratch memory of worker thread i
+dgInt32 dgWorld::GetFrameArenaCount() const
+{
+	return GetThreadCount() + 1;
+}
+
+void dgWorld::ReserveFrameArena (dgInt32 arenaIndex, dgInt32 sizeInBytes)
+{
+	Sync();
+	dgAssert ((arenaIndex >= 0) && (arenaIndex < GetFrameArenaCount()));
+	dgFrameArena& arena = arenaIndex ? m_threadArena[arenaIndex - 1] : m_solverArena;
+	arena.Reserve(sizeInBytes);
+}
+
+void dgWorld::GetFrameArenaStatistics (dgInt32 arenaIndex, dgInt32& highWaterMark, dgInt32& capacity, dgInt32& allocationsCount) const
+{
+	dgAssert ((arenaIndex >= 0) && (arenaIndex < GetFrameArenaCount()));
+	const dgFrameArena& arena = arenaIndex ? m_threadArena[arenaIndex - 1] : m_solverArena;
+	highWaterMark = arena.GetHighWaterMark();
+	capacity = arena.GetCapacity();
+	allocationsCount = arena.GetAllocationsCount();
+}
+
+
+void dgWorld::SetPerformanceCountersState(bool state)
+{
+	Sync();
+	m_performanceCountersEnabled = state;
+	m_lastPerformanceThreadCount = 0;
+	memset (m_lastPerformanceCounts, 0, sizeof (m_lastPerformanceCounts));
+}
+
+// thread index -1 returns the sum of all threads
+void dgWorld::GetPerformanceCounters (dgInt32 threadIndex, dgUnsigned64* const phaseTimes) const
+{
+	for (dgInt32 i = 0; i < dgWorldPerformanceCounters::m_phasesCount; i ++) {
+		phaseTimes[i] = 0;
+	}
+	const dgInt32 first = (threadIndex >= 0) ? threadIndex : 0;
+	const dgInt32 last = (threadIndex >= 0) ? dgMin (threadIndex + 1, m_lastPerformanceThreadCount) : m_lastPerformanceThreadCount;
+	for (dgInt32 i = first; i < last; i ++) {
+		for (dgInt32 j = 0; j < dgWorldPerformanceCounters::m_phasesCount; j ++) {
+			phaseTimes[j] += m_lastPerformanceCounters[i].m_phaseTime[j];
+		}
+	}
+}
+
+dgInt32 dgWorld::GetPerformanceCount (dgWorldPerformanceCounters::dgCount count) const
+{
+	dgAssert ((count >= 0) && (count < dgWorldPerformanceCounters::m_countsCount));
+	return m_lastPerformanceCounts[count];
+}
+
+// the counters accumulate over all the sub steps of an update and are published at the end of it,
+// so that they can be read while the next update is running
+void dgWorld::BeginPerformanceCounters ()
+{
+	if (m_performanceCountersEnabled) {
+		memset (&m_performanceCounters[0], 0, GetThreadCount() * sizeof (dgWorldPerformanceCounters));
+		memset (m_performanceCounts, 0, sizeof (m_performanceCounts));
+	}
+}
+
+void dgWorld::EndPerformanceCounters ()
+{
+	if (m_performanceCountersEnabled) {
+		const dgInt32 threadCount = GetThreadCount();
+		memcpy (&m_lastPerformanceCounters[0], &m_performanceCounters[0], threadCount * sizeof (dgWorldPerformanceCounters));
+		memcpy (m_lastPerformanceCounts, m_performanceCounts, sizeof (m_performanceCounts));
+		m_lastPerformanceThreadCount = threadCount;
+	}
+}
+
 
 void dgWorld::SetSolverMode (dgInt32 mode)
 {
@@ -400,7 +500,8 @@ dgInt32 dgWorld::GetSolverMode() const
 
 dgInt32 dgWorld::EnumerateHardwareModes() const
 {
-	dgInt32 count = 1;
+	// mode zero is the default sse solver, the other modes are the structure of arrays kernels of the parallel solver
+	dgInt32 count = 1 + m_soaKernelsCount;
 	return count;
 }
 
@@ -409,6 +510,8 @@ void dgWorld::GetHardwareVendorString (dgInt32 deviceIndex, char* const descript
 	deviceIndex = dgClamp(deviceIndex, 0, EnumerateHardwareModes() - 1);
 	if (deviceIndex == 0) {
 		sprintf (description, "newton cpu");
+	} else {
+		sprintf (description, "newton cpu %s", m_soaKernels[deviceIndex - 1].m_name);
 	}
 }
 
@@ -468,7 +571,7 @@ void dgWorld::InitBody (dgBody* const body, dgCollisionInstance* const collision
 	m_bodiesUniqueID ++;
 	body->m_world = this;
 
-	body->m_spawnnedFromCallback = dgUnsigned32 (m_inUpdate ? true : false);
+	body->m_state->m_spawnnedFromCallback = dgUnsigned32 (m_inUpdate ? true : false);
 	body->m_uniqueID = dgInt32 (m_bodiesUniqueID);
 
 	dgBodyMasterList::AddBody(body);
@@ -506,6 +609,7 @@ void dgWorld::BodyDisableSimulation(dgBody* const body)
 {
 	if (body->m_masterNode) {
 		m_broadPhase->Remove(body);
+		m_broadPhase->RemoveSensorOverlaps(body);
 		dgBodyMasterList::RemoveBody(body);
 		m_disableBodies.Insert(0, body);
 		dgAssert (!body->m_masterNode);
@@ -537,6 +641,16 @@ dgKinematicBody* dgWorld::CreateKinematicBody (dgCollisionInstance* const collis
 	return body;
 }
 
+dgSensorBody* dgWorld::CreateSensorBody (dgCollisionInstance* const collision, const dgMatrix& matrix)
+{
+	dgSensorBody* const body = new (m_allocator) dgSensorBody();
+	dgAssert (dgInt32 (sizeof (dgBody) & 0xf) == 0);
+	dgAssert ((dgUnsigned64 (body) & 0xf) == 0);
+
+	InitBody (body, collision, matrix);
+	return body;
+}
+
 
 void dgWorld::DestroyBody(dgBody* const body)
 {
@@ -557,6 +671,8 @@ void dgWorld::DestroyBody(dgBody* const body)
 		m_broadPhase->Remove (body);
 		dgBodyMasterList::RemoveBody (body);
 	}
+	m_broadPhase->RemoveSensorOverlaps (body);
+	m_dirtySkeletonBodies.Remove(body->m_uniqueID);
 
 	dgAssert (body->m_collision);
 	body->m_collision->Release();
@@ -911,9 +1027,16 @@ void dgWorld::StepDynamics (dgFloat32 timestep)
 
 	m_inUpdate ++;
 
+	// release all the transient memory of the previous step
+	m_solverArena.Reset();
+	for (dgInt32 i = 0; i < GetThreadCount(); i ++) {
+		m_threadArena[i].Reset();
+	}
+
 	UpdateSkeletons();
 	UpdateBroadphase(timestep);
 	UpdateDynamics (timestep);
+	m_broadPhase->DispatchSensorEvents();
 
 	if (m_listeners.GetCount()) {
 		dTimeTrackerEvent("postListeners");
@@ -955,33 +1078,33 @@ void dgWorld::Sync ()
 	}
 }
 
-void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgWorld::UpdateTransforms(dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
-	const dgInt32 threadsCount = GetThreadCount();
-	while (node) {
-		dgBody* const body = node->GetInfo().GetBody();
-		if (body->m_transformIsDirty && body->m_matrixUpdate) {
-			body->m_matrixUpdate (*body, body->m_matrix, threadID);
-		}
-		body->m_transformIsDirty = false;
-
-		for (dgInt32 i = 0; i < threadsCount; i++) {
-			node = node ? node->GetNext() : NULL;
+	dgBody** const bodyArray = GetBodyArray();
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBodyState* const state = GetBodyState(i);
+		if (state->m_transformIsDirty) {
+			dgBody* const body = bodyArray[i];
+			if (body->m_matrixUpdate) {
+				body->m_matrixUpdate (*body, state->m_matrix, threadID);
+			}
+			state->m_transformIsDirty = false;
 		}
 	}
 }
 
-void dgWorld::UpdateTransforms(void* const context, void* const nodePtr, dgInt32 threadID)
+void dgWorld::UpdateTransforms(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dTimeTrackerEvent(__FUNCTION__);
 	dgWorld* const world = (dgWorld*)context;
-	dgBodyMasterList::dgListNode* node = (dgBodyMasterList::dgListNode*) nodePtr;
-	world->UpdateTransforms(node, threadID);
+	world->UpdateTransforms(start, end, threadID);
 }
 
 void dgWorld::RunStep ()
 {
 	dgUnsigned64 timeAcc = m_getDebugTime ? m_getDebugTime() : 0;
+	BeginPerformanceCounters ();
+	dgBodyMasterList::ReleaseRetiredBodyArrays();
 	dgFloat32 step = m_savetimestep / m_numberOfSubsteps;
 	for (dgUnsigned32 i = 0; i < m_numberOfSubsteps; i ++) {
 		dgInterlockedExchange(&m_delayDelateLock, 1);
@@ -995,20 +1118,17 @@ void dgWorld::RunStep ()
 		bodyList.DestroyBodies (*this);
 	}
 
-	const dgBodyMasterList* const masterList = this;
-	dgBodyMasterList::dgListNode* node = masterList->GetFirst();
-	const dgInt32 threadsCount = GetThreadCount();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		QueueJob(UpdateTransforms, this, node);
-		node = node ? node->GetNext() : NULL;
-	}
-	SynchronizationBarrier();
+	ParallelFor (UpdateTransforms, this, GetBodyArrayCount(), DG_BODY_ARRAY_CHUNK_SIZE);
+	EndPerformanceCounters ();
 
 	if (m_postUpdateCallback) {
 		m_postUpdateCallback (this, m_savetimestep);
 	}
 
 	m_lastExecutionTime = m_getDebugTime ? dgFloat32 (m_getDebugTime() - timeAcc) * dgFloat32 (1.0e-6f): 0;
+
+	// each world update is one frame of the time tracker capture
+	dTimeTrackerUpdate();
 }
 
 void dgWorld::TickCallback (dgInt32 threadID)
@@ -1126,7 +1246,7 @@ dgSkeletonContainer* dgWorld::CreateNewtonSkeletonContainer (dgBody* const rootB
 		list->RemoveAll();
 
 		dgInt32 index = DG_SKELETON_BASE_UNIQUE_ID;
-		for (dgList<dgSkeletonContainer*>::dgListNode* ptr = saveList.GetFirst(); ptr; ptr ++) {
+		for (dgList<dgSkeletonContainer*>::dgListNode* ptr = saveList.GetFirst(); ptr; ptr = ptr->GetNext()) {
 			dgSkeletonContainer* const skeleton = ptr->GetInfo();
 			skeleton->m_id = index;
 			list->Insert (skeleton, skeleton->GetId());
@@ -1241,6 +1361,7 @@ void dgDeadBodies::DestroyBodies(dgWorld& world)
 
 void dgWorld::UpdateBroadphase(dgFloat32 timestep)
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	m_broadPhase->UpdateContacts (timestep);
 }
 
@@ -1269,12 +1390,106 @@ dgInt32 dgWorld::CompareJointByInvMass(const dgBilateralConstraint* const jointA
 }
 
 
+void dgWorld::SetSkeletonDirty (dgBody* const body)
+{
+	dgSkeletonList& skelManager = *this;
+	if (!skelManager.m_skelListIsDirty) {
+		skelManager.m_dirtySkeletonBodies.Insert(body, body->m_uniqueID);
+	}
+}
+
+void dgWorld::BuildSkeletons (dgBilateralConstraint** const jointList, dgInt32 jointCount)
+{
+	dgSortIndirect(jointList, jointCount, CompareJointByInvMass);
+
+	const dgInt32 poolSize = 1024 * 4;
+	dgBilateralConstraint* loopJoints[64];
+	dgSkeletonContainer::dgNode* queuePool[poolSize];
+
+	m_dynamicsLru = m_dynamicsLru + 1;
+	const dgUnsigned32 lru = m_dynamicsLru;
+	for (dgInt32 i = 0; i < jointCount; i++) {
+		dgBilateralConstraint* const constraint = jointList[i];
+		if (constraint->m_dynamicsLru != lru) {
+			dgQueue<dgSkeletonContainer::dgNode*> queue(queuePool, poolSize);
+
+			dgInt32 loopCount = 0;
+			dgDynamicBody* const rootBody = (dgDynamicBody*)((constraint->GetBody0()->GetInvMass().m_w < constraint->GetBody1()->GetInvMass().m_w) ? constraint->GetBody0() : constraint->GetBody1());
+			dgSkeletonContainer* const skeleton = CreateNewtonSkeletonContainer(rootBody);
+			dgSkeletonContainer::dgNode* const rootNode = skeleton->GetRoot();
+			if (rootBody->GetInvMass().m_w == dgFloat32 (0.0f)) {
+				if (constraint->IsBilateral() && (constraint->m_dynamicsLru != lru)) {
+					constraint->m_dynamicsLru = lru;
+					dgDynamicBody* const childBody = (dgDynamicBody*)((constraint->GetBody0() == rootBody) ? constraint->GetBody1() : constraint->GetBody0());
+					if (!constraint->m_solverModel) {
+						if ((childBody->m_dynamicsLru != lru) && (childBody->GetInvMass().m_w != dgFloat32(0.0f))) {
+							childBody->m_dynamicsLru = lru;
+							dgSkeletonContainer::dgNode* const node = skeleton->AddChild((dgBilateralConstraint*)constraint, rootNode);
+							queue.Insert(node);
+						}
+					}
+				}
+			} else {
+				queue.Insert(rootNode);
+				rootBody->m_dynamicsLru = lru;
+			}
+
+			while (!queue.IsEmpty()) {
+				dgInt32 count = queue.m_firstIndex - queue.m_lastIndex;
+				if (count < 0) {
+					count += queue.m_mod;
+				}
+
+				dgInt32 index = queue.m_lastIndex;
+				queue.Reset();
+
+				for (dgInt32 j = 0; j < count; j++) {
+					dgSkeletonContainer::dgNode* const parentNode = queue.m_pool[index];
+					dgDynamicBody* const parentBody = skeleton->GetBody(parentNode);
+
+					for (dgBodyMasterListRow::dgListNode* jointNode1 = parentBody->m_masterNode->GetInfo().GetFirst(); jointNode1; jointNode1 = jointNode1->GetNext()) {
+						dgBodyMasterListCell* const cell1 = &jointNode1->GetInfo();
+						dgConstraint* const constraint1 = cell1->m_joint;
+						if (constraint1->IsBilateral() && (constraint1->m_dynamicsLru != lru)) {
+							constraint1->m_dynamicsLru = lru;
+
+							dgDynamicBody* const childBody = (dgDynamicBody*)((constraint1->GetBody0() == parentBody) ? constraint1->GetBody1() : constraint1->GetBody0());
+							if (!constraint1->m_solverModel) {
+								if ((childBody->m_dynamicsLru != lru) && (childBody->GetInvMass().m_w != dgFloat32(0.0f))) {
+									childBody->m_dynamicsLru = lru;
+									dgSkeletonContainer::dgNode* const childNode = skeleton->AddChild((dgBilateralConstraint*)constraint1, parentNode);
+									queue.Insert(childNode);
+								} else if (loopCount < (sizeof (loopJoints) / sizeof(loopJoints[0]))) {
+									loopJoints[loopCount] = (dgBilateralConstraint*)constraint1;
+									loopCount++;
+								}
+
+							} else if ((constraint1->m_solverModel != 2) && loopCount < (sizeof (loopJoints) / sizeof(loopJoints[0]))) {
+								loopJoints[loopCount] = (dgBilateralConstraint*)constraint1;
+								loopCount++;
+							}
+						}
+					}
+					index++;
+					if (index >= queue.m_mod) {
+						index = 0;
+					}
+				}
+			}
+
+			skeleton->Finalize(loopCount, loopJoints);
+		}
+	}
+}
+
 void dgWorld::UpdateSkeletons()
 {
 	dgSkeletonList& skelManager = *this;
+	dgBodyMasterList& masterList = *this;
 	if (skelManager.m_skelListIsDirty) {
 		dTimeTrackerEvent(__FUNCTION__);
 		skelManager.m_skelListIsDirty = false;
+		skelManager.m_dirtySkeletonBodies.RemoveAll();
 		dgSkeletonList::Iterator iter(skelManager);
 		for (iter.Begin(); iter; iter++) {
 			dgSkeletonContainer* const skeleton = iter.GetNode()->GetInfo();
@@ -1285,14 +1500,14 @@ void dgWorld::UpdateSkeletons()
 		m_dynamicsLru = m_dynamicsLru + 1;
 		dgUnsigned32 lru = m_dynamicsLru;
 
-		dgBodyMasterList& masterList = *this;
 		m_solverJacobiansMemory.ResizeIfNecessary((2 * (masterList.m_constraintCount + 1024)) * sizeof (dgBilateralConstraint*));
 		dgBilateralConstraint** const jointList = (dgBilateralConstraint**)&m_solverJacobiansMemory[0];
 
 		dgInt32 jointCount = 0;
-		for (dgBodyMasterList::dgListNode* node = masterList.GetFirst(); node; node = node->GetNext()) {
-			const dgBodyMasterListRow& graphNode = node->GetInfo();
-			dgBody* const srcBody = graphNode.GetBody();
+		dgBody** const bodyArray = masterList.GetBodyArray();
+		const dgInt32 bodyCount = masterList.GetBodyArrayCount();
+		for (dgInt32 i = 0; i < bodyCount; i ++) {
+			dgBody* const srcBody = bodyArray[i];
 
 			for (dgBodyMasterListRow::dgListNode* jointNode = srcBody->m_masterNode->GetInfo().GetLast(); jointNode; jointNode = jointNode->GetPrev()) {
 				dgBodyMasterListCell* const cell = &jointNode->GetInfo();
@@ -1307,87 +1522,59 @@ void dgWorld::UpdateSkeletons()
 				}
 			}
 		}
+		BuildSkeletons (jointList, jointCount);
 
-		dgSortIndirect(jointList, jointCount, CompareJointByInvMass);
-
-		const dgInt32 poolSize = 1024 * 4;
-		dgBilateralConstraint* loopJoints[64];
-		dgSkeletonContainer::dgNode* queuePool[poolSize];
+	} else if (skelManager.m_dirtySkeletonBodies.GetCount()) {
+		dTimeTrackerEvent(__FUNCTION__);
 
 		m_dynamicsLru = m_dynamicsLru + 1;
-		lru = m_dynamicsLru;
-		for (dgInt32 i = 0; i < jointCount; i++) {
-			dgBilateralConstraint* const constraint = jointList[i];
-			if (constraint->m_dynamicsLru != lru) {
-				dgQueue<dgSkeletonContainer::dgNode*> queue(queuePool, poolSize);
-
-				dgInt32 loopCount = 0;
-				dgDynamicBody* const rootBody = (dgDynamicBody*)((constraint->GetBody0()->GetInvMass().m_w < constraint->GetBody1()->GetInvMass().m_w) ? constraint->GetBody0() : constraint->GetBody1());
-				dgSkeletonContainer* const skeleton = CreateNewtonSkeletonContainer(rootBody);
-				dgSkeletonContainer::dgNode* const rootNode = skeleton->GetRoot();
-				if (rootBody->GetInvMass().m_w == dgFloat32 (0.0f)) {
-					if (constraint->IsBilateral() && (constraint->m_dynamicsLru != lru)) {
-						constraint->m_dynamicsLru = lru;
-						dgDynamicBody* const childBody = (dgDynamicBody*)((constraint->GetBody0() == rootBody) ? constraint->GetBody1() : constraint->GetBody0());
-						if (!constraint->m_solverModel) {
-							if ((childBody->m_dynamicsLru != lru) && (childBody->GetInvMass().m_w != dgFloat32(0.0f))) {
-								childBody->m_dynamicsLru = lru;
-								dgSkeletonContainer::dgNode* const node = skeleton->AddChild((dgBilateralConstraint*)constraint, rootNode);
-								queue.Insert(node);
-							}
-						}
-					}
-				} else {
-					queue.Insert(rootNode);
-					rootBody->m_dynamicsLru = lru;
-				}
+		const dgUnsigned32 lru = m_dynamicsLru;
 
-				while (!queue.IsEmpty()) {
-					dgInt32 count = queue.m_firstIndex - queue.m_lastIndex;
-					if (count < 0) {
-						count += queue.m_mod;
-					}
+		m_solverJacobiansMemory.ResizeIfNecessary((2 * (masterList.m_constraintCount + 1024)) * sizeof (dgBilateralConstraint*));
+		dgBilateralConstraint** const jointList = (dgBilateralConstraint**)&m_solverJacobiansMemory[0];
 
-					dgInt32 index = queue.m_lastIndex;
-					queue.Reset();
-
-					for (dgInt32 j = 0; j < count; j++) {
-						dgSkeletonContainer::dgNode* const parentNode = queue.m_pool[index];
-						dgDynamicBody* const parentBody = skeleton->GetBody(parentNode);
-
-						for (dgBodyMasterListRow::dgListNode* jointNode1 = parentBody->m_masterNode->GetInfo().GetFirst(); jointNode1; jointNode1 = jointNode1->GetNext()) {
-							dgBodyMasterListCell* const cell1 = &jointNode1->GetInfo();
-							dgConstraint* const constraint1 = cell1->m_joint;
-							if (constraint1->IsBilateral() && (constraint1->m_dynamicsLru != lru)) {
-								constraint1->m_dynamicsLru = lru;
-
-								dgDynamicBody* const childBody = (dgDynamicBody*)((constraint1->GetBody0() == parentBody) ? constraint1->GetBody1() : constraint1->GetBody0());
-								if (!constraint1->m_solverModel) {
-									if ((childBody->m_dynamicsLru != lru) && (childBody->GetInvMass().m_w != dgFloat32(0.0f))) {
-										childBody->m_dynamicsLru = lru;
-										dgSkeletonContainer::dgNode* const childNode = skeleton->AddChild((dgBilateralConstraint*)constraint1, parentNode);
-										queue.Insert(childNode);
-									} else if (loopCount < (sizeof (loopJoints) / sizeof(loopJoints[0]))) {
-										loopJoints[loopCount] = (dgBilateralConstraint*)constraint1;
-										loopCount++;
-									}
-
-								} else if ((constraint1->m_solverModel != 2) && loopCount < (sizeof (loopJoints) / sizeof(loopJoints[0]))) {
-									loopJoints[loopCount] = (dgBilateralConstraint*)constraint1;
-									loopCount++;
-								}
-							}
-						}
-						index++;
-						if (index >= queue.m_mod) {
-							index = 0;
-						}
+		// flood the connected components of the dirty bodies across the dynamic bodies, 
+		// collecting their joints and destroying the skeletons they used to belong to.
+		dgInt32 stack = 0;
+		::dgStack<dgBody*> stackPool (masterList.GetCount() + 1);
+		dgTree<dgBody*, dgInt32>::Iterator iter (skelManager.m_dirtySkeletonBodies);
+		for (iter.Begin(); iter; iter ++) {
+			dgBody* const body = iter.GetNode()->GetInfo();
+			if ((body->GetInvMass().m_w != dgFloat32 (0.0f)) && (body->m_dynamicsLru != lru)) {
+				body->m_dynamicsLru = lru;
+				stackPool[stack] = body;
+				stack ++;
+			}
+		}
+		skelManager.m_dirtySkeletonBodies.RemoveAll();
+
+		dgInt32 jointCount = 0;
+		while (stack) {
+			stack --;
+			dgBody* const body = stackPool[stack];
+			dgSkeletonContainer* const skeleton = body->GetSkeleton();
+			if (skeleton) {
+				DestroySkeletonContainer(skeleton);
+			}
+
+			for (dgBodyMasterListRow::dgListNode* jointNode = body->m_masterNode->GetInfo().GetLast(); jointNode; jointNode = jointNode->GetPrev()) {
+				dgConstraint* const constraint = jointNode->GetInfo().m_joint;
+				if (constraint->IsBilateral() && (constraint->m_solverModel < 2)) {
+					if (constraint->m_dynamicsLru != lru) {
+						constraint->m_dynamicsLru = lru;
+						jointList[jointCount] = (dgBilateralConstraint*)constraint;
+						jointCount++;
+					}
+					dgBody* const linkBody = jointNode->GetInfo().m_bodyNode;
+					if ((linkBody->GetInvMass().m_w != dgFloat32 (0.0f)) && (linkBody->m_dynamicsLru != lru)) {
+						linkBody->m_dynamicsLru = lru;
+						stackPool[stack] = linkBody;
+						stack ++;
 					}
 				}
-
-				skeleton->Finalize(loopCount, loopJoints);
 			}
 		}
+		BuildSkeletons (jointList, jointCount);
 	}
 }
 
@@ -1533,14 +1720,19 @@ void dgWorld::DeserializeBodyArray (void* const userData, OnBodyDeserialize body
 				body = new (m_allocator)dgKinematicBody(this, &shapeMap, deserializeCallback, serializeHandle, revision);
 				break;
 			}
+			case dgBody::m_sensorBody:
+			{
+				body = new (m_allocator)dgSensorBody(this, &shapeMap, deserializeCallback, serializeHandle, revision);
+				break;
+			}
 		}
 
 		dgAssert(body);
 		m_bodiesUniqueID++;
-		body->m_freeze = false;
-		body->m_sleeping = false;
-		body->m_equilibrium = false;
-		body->m_spawnnedFromCallback = false;
+		body->m_state->m_freeze = false;
+		body->m_state->m_sleeping = false;
+		body->m_state->m_equilibrium = false;
+		body->m_state->m_spawnnedFromCallback = false;
 		body->m_uniqueID = dgInt32(m_bodiesUniqueID);
 
 //if (body->m_uniqueID == 5 || body->m_uniqueID == 33)
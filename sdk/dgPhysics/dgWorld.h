@@ -41,6 +41,7 @@
 class dgBody;
 class dgDynamicBody;
 class dgKinematicBody;
+class dgSensorBody;
 class dgCollisionPoint;
 class dgUserConstraint;
 class dgBallConstraint;
@@ -78,9 +79,13 @@ class dgSkeletonList: public dgTree<dgSkeletonContainer*, dgInt32>
 	public:
 	dgSkeletonList(dgMemoryAllocator* const allocator)
 		:dgTree<dgSkeletonContainer*, dgInt32>(allocator)
+		,m_dirtySkeletonBodies(allocator)
 		,m_skelListIsDirty(true)
 	{
 	}
+
+	// bodies whose joints changed, keyed by unique id so the partial rebuild visits them in creation order
+	dgTree<dgBody*, dgInt32> m_dirtySkeletonBodies;
 	bool m_skelListIsDirty;
 };
 
@@ -150,6 +155,48 @@ class dgDeadBodies: public dgTree<dgBody*, void* >
 	dgInt32 m_lock;
 };
 
+// time spent by one thread in each phase of the last update, in nanoseconds
+class dgWorldPerformanceCounters
+{
+	public:
+	enum dgPhase
+	{
+		m_forceAndTorque,
+		m_broadPhaseUpdate,
+		m_pairFinding,
+		m_narrowPhase,
+		m_islandBuild,
+		m_jacobianBuild,
+		m_solverIterations,
+		m_integration,
+		m_phasesCount,
+	};
+
+	enum dgCount
+	{
+		m_activeBodies,
+		m_activeContacts,
+		m_activeJoints,
+		m_jointRows,
+		m_clusters,
+		m_countsCount,
+	};
+
+	dgUnsigned64 m_phaseTime[m_phasesCount];
+};
+
+// adds the time spent in its scope to a phase of the calling thread, when the world performance counters are enabled
+class dgWorldPhaseTimer
+{
+	public:
+	dgWorldPhaseTimer (dgWorld* const world, dgInt32 threadID, dgWorldPerformanceCounters::dgPhase phase);
+	~dgWorldPhaseTimer ();
+
+	private:
+	dgUnsigned64* m_time;
+	dgUnsigned64 m_start;
+};
+
 typedef void (*dgPostUpdateCallback) (const dgWorld* const world, dgFloat32 timestep);
 
 DG_MSC_VECTOR_ALIGMENT
@@ -280,6 +327,7 @@ class dgWorld
 	bool IntersectionTest (const dgCollisionInstance* const collisionA, const dgMatrix& matrixA, 
 						   const dgCollisionInstance* const collisionB, const dgMatrix& matrixB, 
 						   dgInt32 threadIndex);
+	bool IntersectionTest (dgBody* const body0, dgBody* const body1, dgInt32 threadIndex);
 	
 	dgInt32 ClosestPoint (dgTriplex& point, const dgCollisionInstance* const collision, const dgMatrix& matrix, dgTriplex& contact, dgTriplex& normal, dgInt32 threadIndex);
 	dgInt32 ClosestPoint (const dgCollisionInstance* const collisionA, const dgMatrix& matrixA, 
@@ -306,6 +354,7 @@ class dgWorld
 	void InitBody (dgBody* const body, dgCollisionInstance* const collision, const dgMatrix& matrix);
 	dgDynamicBody* CreateDynamicBody (dgCollisionInstance* const collision, const dgMatrix& matrix);
 	dgKinematicBody* CreateKinematicBody (dgCollisionInstance* const collision, const dgMatrix& matrix);
+	dgSensorBody* CreateSensorBody (dgCollisionInstance* const collision, const dgMatrix& matrix);
 	void DestroyBody(dgBody* const body);
 	void DestroyAllBodies ();
 
@@ -340,10 +389,12 @@ class dgWorld
 
 	dgCollisionInstance* CreateDeformableSolid (dgMeshEffect* const mesh, dgInt32 shapeID);
 	dgCollisionInstance* CreateMassSpringDamperSystem (dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 srideInBytes, const dgFloat32* const pointsMass, dgInt32 linksCount, const dgInt32* const links, const dgFloat32* const linksSpring, const dgFloat32* const LinksDamper);
+	dgCollisionInstance* CreateIncompressibleParticles (dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity);
 
 	dgCollisionInstance* CreateBVH ();	
 	dgCollisionInstance* CreateStaticUserMesh (const dgVector& boxP0, const dgVector& boxP1, const dgUserMeshCreation& data);
 	dgCollisionInstance* CreateHeightField (dgInt32 width, dgInt32 height, dgInt32 contructionMode, dgInt32 elevationDataType, const void* const elevationMap, const dgInt8* const atributeMap, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
+	dgCollisionInstance* CreateTiledHeightField (dgInt32 width, dgInt32 height, dgInt32 contructionMode, dgInt32 elevationDataType, dgInt32 tileSize, dgInt32 maxResidentTiles, dgFloat32 minElevation, dgFloat32 maxElevation, dgCollisionHeightFieldPageInCallback pageInCallback, void* const pageInUserData, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
 	dgCollisionInstance* CreateScene ();	
 
 	dgBroadPhaseAggregate* CreateAggreGate() const; 
@@ -377,6 +428,8 @@ class dgWorld
 
 	void SerializeCollision (dgCollisionInstance* const shape, dgSerialize deserialization, void* const userData) const;
 	dgCollisionInstance* CreateCollisionFromSerialization (dgDeserialize deserialization, void* const userData);
+	bool SerializeCollisionImage (const dgCollisionInstance* const shape, dgSerialize serialization, void* const userData) const;
+	dgCollisionInstance* CreateCollisionFromImage (const void* const image, dgInt64 sizeInBytes);
 	void ReleaseCollision(const dgCollision* const collision);
 	
 	dgUpVectorConstraint* CreateUpVectorConstraint (const dgVector& pin, dgBody *body);
@@ -391,6 +444,7 @@ class dgWorld
 
 	dgSkeletonContainer* CreateNewtonSkeletonContainer (dgBody* const rootBone);
 	void DestroySkeletonContainer (dgSkeletonContainer* const container);
+	void SetSkeletonDirty (dgBody* const body);
 
 	dgUnsigned32 CreateBodyGroupID();
 	void RemoveAllGroupID();
@@ -413,6 +467,15 @@ class dgWorld
 	dgDynamicBody* GetSentinelBody() const;
 	dgMemoryAllocator* GetAllocator() const;
 
+	dgInt32 GetFrameArenaCount() const;
+	void ReserveFrameArena (dgInt32 arenaIndex, dgInt32 sizeInBytes);
+	void GetFrameArenaStatistics (dgInt32 arenaIndex, dgInt32& highWaterMark, dgInt32& capacity, dgInt32& allocationsCount) const;
+
+	bool GetPerformanceCountersState() const;
+	void SetPerformanceCountersState(bool state);
+	void GetPerformanceCounters (dgInt32 threadIndex, dgUnsigned64* const phaseTimes) const;
+	dgInt32 GetPerformanceCount (dgWorldPerformanceCounters::dgCount count) const;
+
 	dgInt32 GetBroadPhaseType() const;
 	void SetBroadPhaseType (dgInt32 type);
 	void ResetBroadPhase();
@@ -421,6 +484,7 @@ class dgWorld
 	void SetContactMergeTolerance(dgFloat32 tolerenace);
 
 	void Sync ();
+	bool IsUpdating () const;
 
 	void SetSubsteps (dgInt32 subSteps);
 	dgInt32 GetSubsteps () const;
@@ -510,6 +574,7 @@ class dgWorld
 	bool AreBodyConnectedByJoints (dgBody* const origin, dgBody* const target);
 	
 	void UpdateSkeletons();
+	void BuildSkeletons (dgBilateralConstraint** const jointList, dgInt32 jointCount);
 	void UpdateBroadphase(dgFloat32 timestep);
 	
 	void AddSentinelBody();
@@ -518,10 +583,12 @@ class dgWorld
 
 	virtual void Execute (dgInt32 threadID);
 	virtual void TickCallback (dgInt32 threadID);
-	void UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	void UpdateTransforms(dgInt32 start, dgInt32 end, dgInt32 threadID);
+	void BeginPerformanceCounters ();
+	void EndPerformanceCounters ();
 
 	static dgUnsigned32 dgApi GetPerformanceCount ();
-	static void UpdateTransforms(void* const context, void* const node, dgInt32 threadID);
+	static void UpdateTransforms(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	static dgInt32 SortFaces (const dgAdressDistPair* const A, const dgAdressDistPair* const B, void* const context);
 	static dgInt32 CompareJointByInvMass (const dgBilateralConstraint* const jointA, const dgBilateralConstraint* const jointB, void* notUsed);
 
@@ -567,9 +634,16 @@ class dgWorld
 	dgArray<dgUnsigned8> m_bodiesMemory; 
 	dgArray<dgUnsigned8> m_jointsMemory; 
 	dgArray<dgUnsigned8> m_solverJacobiansMemory;  
-	dgArray<dgUnsigned8> m_solverForceAccumulatorMemory;
 	dgArray<dgUnsigned8> m_clusterMemory;
 	dgStack m_stack;
+	dgFrameArena m_solverArena;
+	dgFrameArena* m_threadArena;
+	dgArray<dgWorldPerformanceCounters> m_performanceCounters;
+	dgArray<dgWorldPerformanceCounters> m_lastPerformanceCounters;
+	dgInt32 m_performanceCounts[dgWorldPerformanceCounters::m_countsCount];
+	dgInt32 m_lastPerformanceCounts[dgWorldPerformanceCounters::m_countsCount];
+	dgInt32 m_lastPerformanceThreadCount;
+	bool m_performanceCountersEnabled;
 
 	dgPostUpdateCallback m_postUpdateCallback;
 	
@@ -587,6 +661,7 @@ class dgWorld
 	friend class dgCollisionInstance;
 	friend class dgCollisionCompound;
 	friend class dgWorldDynamicUpdate;
+	friend class dgWorldPhaseTimer;
 	friend class dgParallelSolverClear;	
 	friend class dgParallelSolverSolve;
 	friend class dgCollisionHeightField;
@@ -601,6 +676,7 @@ class dgWorld
 	friend class dgBroadPhaseApplyExternalForce;
 	friend class dgParallelSolverCalculateForces;
 	friend class dgCollisionMassSpringDamperSystem;
+	friend class dgCollisionIncompressibleParticles;
 	friend class dgParallelSolverJointAcceleration;
 	friend class dgParallelSolverBuildJacobianRows;
 	friend class dgParallelSolverInitFeedbackUpdate;
@@ -642,4 +718,33 @@ inline void dgWorld::SetPosUpdateCallback (const dgWorld* const newtonWorld, dgP
 	m_postUpdateCallback = callback;
 }
 
+// true while an update is running, or when called from any callback of an update
+inline bool dgWorld::IsUpdating () const
+{
+	return m_inUpdate || dgMutexThread::IsBusy() || dgAsyncThread::IsBusy();
+}
+
+inline bool dgWorld::GetPerformanceCountersState() const
+{
+	return m_performanceCountersEnabled;
+}
+
+inline dgWorldPhaseTimer::dgWorldPhaseTimer (dgWorld* const world, dgInt32 threadID, dgWorldPerformanceCounters::dgPhase phase)
+	:m_time(NULL)
+	,m_start(0)
+{
+	if (world->m_performanceCountersEnabled) {
+		dgAssert ((threadID >= 0) && (threadID < world->GetThreadCount()));
+		m_time = &world->m_performanceCounters[threadID].m_phaseTime[phase];
+		m_start = dgGetTimeInNanoseconds();
+	}
+}
+
+inline dgWorldPhaseTimer::~dgWorldPhaseTimer ()
+{
+	if (m_time) {
+		*m_time += dgGetTimeInNanoseconds() - m_start;
+	}
+}
+
 #endif
@@ -66,7 +66,17 @@ dgWorldDynamicUpdate::dgWorldDynamicUpdate()
 	,m_markLru(0)
 	,m_softBodyCriticalSectionLock()
 	,m_clusterMemory(NULL)
+	,m_soaKernelsCount(0)
 {
+	const dgUnsigned32 cpuFeatures = dgGetCpuFeatures();
+	if (cpuFeatures & DG_CPU_FEATURE_AVX2) {
+		m_soaKernels[m_soaKernelsCount] = dgGetSoaSolverKernelAvx2();
+		m_soaKernelsCount += m_soaKernels[m_soaKernelsCount].m_solver ? 1 : 0;
+	}
+	if (cpuFeatures & DG_CPU_FEATURE_AVX512) {
+		m_soaKernels[m_soaKernelsCount] = dgGetSoaSolverKernelAvx512();
+		m_soaKernelsCount += m_soaKernels[m_soaKernelsCount].m_solver ? 1 : 0;
+	}
 }
 
 void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
@@ -82,9 +92,9 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 
 	dgDynamicBody* const sentinelBody = world->m_sentinelBody;
 	sentinelBody->m_index = 0; 
-	sentinelBody->m_resting = 1;
-	sentinelBody->m_sleeping = 1;
-	sentinelBody->m_equilibrium = 1;
+	sentinelBody->m_state->m_resting = 1;
+	sentinelBody->m_state->m_sleeping = 1;
+	sentinelBody->m_state->m_equilibrium = 1;
 	sentinelBody->m_dynamicsLru = m_markLru;
 
 	BuildClusters(timestep);
@@ -101,6 +111,21 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	}
 	m_solverMemory.Init (world, maxRowCount, m_bodies, blockMatrixSize);
 
+	if (world->m_performanceCountersEnabled) {
+		// each cluster has the sentinel body in its first entry
+		dgInt32 contactsCount = 0;
+		const dgJointInfo* const constraintArray = (dgJointInfo*)&world->m_jointsMemory[0];
+		for (dgInt32 i = 0; i < m_joints; i ++) {
+			contactsCount += (constraintArray[i].m_joint->GetId() == dgConstraint::m_contactConstraint) ? 1 : 0;
+		}
+		dgInt32* const counts = world->m_performanceCounts;
+		counts[dgWorldPerformanceCounters::m_activeBodies] = m_bodies - m_clusters;
+		counts[dgWorldPerformanceCounters::m_activeContacts] = contactsCount;
+		counts[dgWorldPerformanceCounters::m_activeJoints] = m_joints;
+		counts[dgWorldPerformanceCounters::m_jointRows] = maxRowCount;
+		counts[dgWorldPerformanceCounters::m_clusters] = m_clusters;
+	}
+
 	dgInt32 threadCount = world->GetThreadCount();	
 
 	dgWorldDynamicUpdateSyncDescriptor descriptor;
@@ -116,16 +141,16 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	//useParallel = 1;
 	if (useParallel) {
 		dgInt32 sum = m_joints;
-		useParallel = useParallel && m_joints && m_clusters;
-		useParallel = useParallel && ((threadCount * m_clusterMemory[0].m_jointCount) >= sum);
-		useParallel = useParallel && (m_clusterMemory[0].m_jointCount > DG_PARALLEL_JOINT_COUNT_CUT_OFF);
+		useParallel = useParallel && m_joints && (index < m_clusters);
+		useParallel = useParallel && ((threadCount * m_clusterMemory[index].m_jointCount) >= sum);
+		useParallel = useParallel && (m_clusterMemory[index].m_jointCount > DG_PARALLEL_JOINT_COUNT_CUT_OFF);
 		//useParallel = 1;
 		while (useParallel) {
 			CalculateReactionForcesParallel(&m_clusterMemory[index], timestep);
-			index ++;
 			sum -= m_clusterMemory[index].m_jointCount;
+			index ++;
 			useParallel = useParallel && (index < m_clusters);
-			useParallel = useParallel && ((threadCount * m_clusterMemory[index].m_jointCount) >= m_joints);
+			useParallel = useParallel && ((threadCount * m_clusterMemory[index].m_jointCount) >= sum);
 			useParallel = useParallel && (m_clusterMemory[index].m_jointCount > DG_PARALLEL_JOINT_COUNT_CUT_OFF);
 		}
 	}
@@ -158,6 +183,7 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 void dgWorldDynamicUpdate::SortClustersByCount ()
 {
 	dTimeTrackerEvent(__FUNCTION__);
+	dgWorldPhaseTimer timer ((dgWorld*) this, 0, dgWorldPerformanceCounters::m_islandBuild);
 	dgSort(m_clusterMemory, m_clusters, CompareClusters);
 }
 
@@ -166,36 +192,45 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	dTimeTrackerEvent(__FUNCTION__);
 
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, 0, dgWorldPerformanceCounters::m_islandBuild);
 	dgUnsigned32 lru = m_markLru - 1;
 
 	dgBodyMasterList& masterList = *world;
 
 	dgAssert (masterList.GetFirst()->GetInfo().GetBody() == world->m_sentinelBody);
-	world->m_solverJacobiansMemory.ResizeIfNecessary ((2 * (masterList.m_constraintCount + 1024)) * sizeof (dgDynamicBody*));
-	dgDynamicBody** const stackPoolBuffer = (dgDynamicBody**)&world->m_solverJacobiansMemory[0];
-
-	for (dgBodyMasterList::dgListNode* node = masterList.GetLast(); node; node = node->GetPrev()) {
-		const dgBodyMasterListRow& graphNode = node->GetInfo();
-		dgBody* const body = graphNode.GetBody();
-
-		if (body->GetInvMass().m_w == dgFloat32(0.0f)) {
-#ifdef _DEBUG
-			for (; node; node = node->GetPrev()) {
-				//dgAssert ((body->GetType() == dgBody::m_kinamticBody) ||(node->GetInfo().GetBody()->GetInvMass().m_w == dgFloat32(0.0f)));
-				dgAssert(node->GetInfo().GetBody()->GetInvMass().m_w == dgFloat32(0.0f));
+	dgFrameArenaScope scratch(&world->m_solverArena);
+	dgDynamicBody** const stackPoolBuffer = scratch.Alloc<dgDynamicBody*>(2 * (masterList.m_constraintCount + 1024));
+
+	// only the bodies of the active islands are visited, an island goes to sleep when all its bodies are sleeping
+	dgBodyMasterList::dgIslandList::dgListNode* nextIsland = NULL;
+	for (dgBodyMasterList::dgIslandList::dgListNode* islandNode = masterList.m_activeIslands.GetFirst(); islandNode; islandNode = nextIsland) {
+		masterList.SplitIsland(islandNode);
+		nextIsland = islandNode->GetNext();
+
+		const dgBodyIsland& island = islandNode->GetInfo();
+		bool isSleeping = true;
+		for (dgBodyIsland::dgListNode* node = island.GetFirst(); node; node = node->GetNext()) {
+			dgBody* const body = node->GetInfo();
+			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body->GetInvMass().m_w > dgFloat32(0.0f))) {
+				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+				if (dynamicBody->m_dynamicsLru < lru) {
+					if (!(dynamicBody->m_state->m_freeze | dynamicBody->m_state->m_spawnnedFromCallback | dynamicBody->m_state->m_sleeping)) {
+						SpanningTree(dynamicBody, stackPoolBuffer, timestep);
+					}
+				}
+				isSleeping = isSleeping && !dynamicBody->m_state->m_spawnnedFromCallback;
+				dynamicBody->m_state->m_spawnnedFromCallback = false;
 			}
-#endif
-			break;
 		}
 
-		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
-			dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
-			if (dynamicBody->m_dynamicsLru < lru) {
-				if (!(dynamicBody->m_freeze | dynamicBody->m_spawnnedFromCallback | dynamicBody->m_sleeping)) {
-					SpanningTree(dynamicBody, stackPoolBuffer, timestep);
-				}
+		for (dgBodyIsland::dgListNode* node = island.GetFirst(); isSleeping && node; node = node->GetNext()) {
+			dgBody* const body = node->GetInfo();
+			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body->GetInvMass().m_w > dgFloat32(0.0f))) {
+				isSleeping = (body->m_state->m_sleeping | body->m_state->m_freeze) ? true : false;
 			}
-			dynamicBody->m_spawnnedFromCallback = false;
+		}
+		if (isSleeping) {
+			masterList.SleepIsland(islandNode);
 		}
 	}
 }
@@ -239,16 +274,16 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 			world->m_bodiesMemory.ResizeIfNecessary ((bodyIndex + 1) * sizeof (dgBodyInfo));
 			dgBodyInfo* const bodyArray1 = (dgBodyInfo*)&world->m_bodiesMemory[0];
 			bodyArray1[bodyIndex].m_body = srcBody;
-			isInEquilibrium &= srcBody->m_equilibrium;
-			globalAutoSleep &= (srcBody->m_autoSleep & srcBody->m_equilibrium); 
+			isInEquilibrium &= srcBody->m_state->m_equilibrium;
+			globalAutoSleep &= (srcBody->m_state->m_autoSleep & srcBody->m_state->m_equilibrium); 
 			
 			srcBody->m_index = bodyCount;
 			srcBody->m_dynamicsLru = lruMark;
-			srcBody->m_resting = srcBody->m_equilibrium;
+			srcBody->m_state->m_resting = srcBody->m_state->m_equilibrium;
 
-			hasSoftBodies |= (srcBody->m_collision->IsType(dgCollision::dgCollisionDeformableMesh_RTTI) ? 1 : 0);
+			hasSoftBodies |= (srcBody->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI) ? 1 : 0);
 
-			srcBody->m_sleeping = false;
+			srcBody->m_state->m_sleeping = false;
 
 			bodyCount++;
 			for (dgBodyMasterListRow::dgListNode* jointNode = srcBody->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
@@ -262,7 +297,7 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 				const dgContact* const contact = (constraint->GetId() == dgConstraint::m_contactConstraint) ? (dgContact*)constraint : NULL;
 
 				bool check0 = linkBody->IsCollidable();
-				check0 = check0 && (!contact || (contact->m_contactActive && contact->m_maxDOF) || (srcBody->m_continueCollisionMode | linkBody->m_continueCollisionMode));
+				check0 = check0 && (!contact || (contact->m_contactActive && contact->m_maxDOF) || (srcBody->m_state->m_continueCollisionMode | linkBody->m_state->m_continueCollisionMode));
 				if (check0) {
 					bool check1 = constraint->m_dynamicsLru != lruMark;
 					if (check1) {
@@ -299,7 +334,7 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 		for (dgInt32 i = 1; i < bodyCount; i++) {
 			dgBody* const body1 = bodyArray[m_bodies + i].m_body;
 			body1->m_dynamicsLru = m_markLru;
-			body1->m_sleeping = globalAutoSleep;
+			body1->m_state->m_sleeping = globalAutoSleep;
 		}
 	} else {
 		if (world->m_clusterUpdate) {
@@ -356,13 +391,13 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 			dgAssert (constraintArray[i].m_pairCount < 64);
 			rowsCount += constraintArray[i].m_pairCount;
 			if (joint->GetId() == dgConstraint::m_contactConstraint) {
-				if (body0->m_continueCollisionMode | body1->m_continueCollisionMode) {
+				if (body0->m_state->m_continueCollisionMode | body1->m_state->m_continueCollisionMode) {
 					dgInt32 ccdJoint = false;
-					const dgVector& veloc0 = body0->m_veloc;
-					const dgVector& veloc1 = body1->m_veloc;
+					const dgVector& veloc0 = body0->m_state->m_veloc;
+					const dgVector& veloc1 = body1->m_state->m_veloc;
 
-					const dgVector& omega0 = body0->m_omega;
-					const dgVector& omega1 = body1->m_omega;
+					const dgVector& omega0 = body0->m_state->m_omega;
+					const dgVector& omega1 = body1->m_state->m_omega;
 
 					const dgVector& com0 = body0->m_globalCentreOfMass;
 					const dgVector& com1 = body1->m_globalCentreOfMass;
@@ -383,7 +418,7 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 						dgInt64 attrib1[16];
 						dgFloat32 penetrations[16];
 						dgFloat32 timeToImpact = timestep;
-						const dgInt32 ccdContactCount = world->CollideContinue(collision0, body0->m_matrix, veloc0, omega0, collision1, body1->m_matrix, veloc1, omega1,
+						const dgInt32 ccdContactCount = world->CollideContinue(collision0, body0->m_state->m_matrix, veloc0, omega0, collision1, body1->m_state->m_matrix, veloc1, omega1,
 																			   timeToImpact, points, normals, penetrations, attrib0, attrib1, 6, 0);
 
 						for (dgInt32 j = 0; j < ccdContactCount; j++) {
@@ -419,14 +454,16 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 dgInt32 dgWorldDynamicUpdate::SortClusters(const dgBodyCluster* const cluster, dgFloat32 timestep, dgInt32 threadID) const
 {
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_islandBuild);
 	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*)&world->m_bodiesMemory[0];
 	dgJointInfo* const constraintArrayPtr = (dgJointInfo*)&world->m_jointsMemory[0];
 	
 	dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
 	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
 
-	dgJointInfo* const tmpInfoList = dgAlloca(dgJointInfo, cluster->m_jointCount);
-	dgJointInfo** queueBuffer = dgAlloca(dgJointInfo*, cluster->m_jointCount * 2 + 1024 * 8);
+	dgFrameArenaScope scratch(&world->m_threadArena[threadID]);
+	dgJointInfo* const tmpInfoList = scratch.Alloc<dgJointInfo>(cluster->m_jointCount);
+	dgJointInfo** queueBuffer = scratch.Alloc<dgJointInfo*>(cluster->m_jointCount * 2 + 1024 * 8);
 	dgQueue<dgJointInfo*> queue(queueBuffer, cluster->m_jointCount * 2 + 1024 * 8);
 	dgFloat32 heaviestMass = dgFloat32(1.0e20f);
 	dgInt32 infoIndex = 0;
@@ -448,9 +485,9 @@ dgInt32 dgWorldDynamicUpdate::SortClusters(const dgBodyCluster* const cluster, d
 		const dgFloat32 invMass0 = body0->GetInvMass().m_w;
 		const dgFloat32 invMass1 = body1->GetInvMass().m_w;
 
-		dgInt32 resting = body0->m_equilibrium & body1->m_equilibrium;
-		body0->m_resting &= resting | (invMass0 == dgFloat32 (0.0f));
-		body1->m_resting &= resting | (invMass1 == dgFloat32 (0.0f));
+		dgInt32 resting = body0->m_state->m_equilibrium & body1->m_state->m_equilibrium;
+		body0->m_state->m_resting &= resting | (invMass0 == dgFloat32 (0.0f));
+		body1->m_state->m_resting &= resting | (invMass1 == dgFloat32 (0.0f));
 
 		if ((invMass0 == dgFloat32 (0.0f)) || (invMass1 == dgFloat32 (0.0f))) {
 			queue.Insert(&tmpInfoList[i]);
@@ -496,7 +533,7 @@ dgInt32 dgWorldDynamicUpdate::SortClusters(const dgBodyCluster* const cluster, d
 				const dgBody* const body0 = bodyArray[m0].m_body;
 				const dgBody* const body1 = bodyArray[m1].m_body;
 				
-				activeJoints += !(body0->m_resting & body1->m_resting);
+				activeJoints += !(body0->m_state->m_resting & body1->m_state->m_resting);
 				
 				if (body0->GetInvMass().m_w > dgFloat32(0.0f)) {
 					for (dgBodyMasterListRow::dgListNode* jointNode1 = body0->m_masterNode->GetInfo().GetFirst(); jointNode1; jointNode1 = jointNode1->GetNext()) {
@@ -612,11 +649,11 @@ dgInt32 dgWorldDynamicUpdate::GetJacobianDerivatives (dgContraintDescritor& cons
 	dgAssert(body0->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body0->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 	dgAssert(body1->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body1->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 
-	body0->m_inCallback = true;
-	body1->m_inCallback = true;
+	body0->m_state->m_inCallback = true;
+	body1->m_state->m_inCallback = true;
 	dof = constraint->JacobianDerivative(constraintParamOut);
-	body0->m_inCallback = false;
-	body1->m_inCallback = false;
+	body0->m_state->m_inCallback = false;
+	body1->m_state->m_inCallback = false;
 	
 	jointInfo->m_pairCount = dof;
 	jointInfo->m_pairStart = rowCount;
@@ -651,11 +688,13 @@ dgInt32 dgWorldDynamicUpdate::GetJacobianDerivatives (dgContraintDescritor& cons
 
 void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster, dgFloat32 accelTolerance, dgFloat32 timestep, dgInt32 threadID) const
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	bool stackSleeping = true;
 	bool isClusterResting = true;
 	dgInt32 sleepCounter = 10000;
 
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_integration);
 
 	dgFloat32 velocityDragCoeff = DG_FREEZZING_VELOCITY_DRAG;
 	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
@@ -663,9 +702,9 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 	dgInt32 count = cluster->m_bodyCount - 1;
 	if (count <= 2) {
 		//bool autosleep = bodyArray[0].m_body->m_autoSleep;
-		bool equilibrium  = bodyArray[0].m_body->m_equilibrium;
+		bool equilibrium  = bodyArray[0].m_body->m_state->m_equilibrium;
 		if (count == 2) {
-			equilibrium  &= bodyArray[1].m_body->m_equilibrium;
+			equilibrium  &= bodyArray[1].m_body->m_state->m_equilibrium;
 		}
 		if (!equilibrium ) {
 			velocityDragCoeff = dgFloat32 (0.9999f);
@@ -685,8 +724,8 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 		dgBody* const body = bodyArray[i].m_body;
 		dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBody));
 		
-		body->m_equilibrium = 1;
-		dgVector isMovingMask ((body->m_veloc + body->m_omega + body->m_accel + body->m_alpha) & dgVector::m_signMask);
+		body->m_state->m_equilibrium = 1;
+		dgVector isMovingMask ((body->m_state->m_veloc + body->m_state->m_omega + body->m_accel + body->m_alpha) & dgVector::m_signMask);
 		if ((isMovingMask.TestZero().GetSignMask() & 7) != 7) {
 			dgAssert (body->m_invMass.m_w);
 			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
@@ -695,12 +734,12 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 
 			dgAssert (body->m_accel.m_w == dgFloat32 (0.0f));
 			dgAssert (body->m_alpha.m_w == dgFloat32 (0.0f));
-			dgAssert (body->m_veloc.m_w == dgFloat32 (0.0f));
-			dgAssert (body->m_omega.m_w == dgFloat32 (0.0f));
+			dgAssert (body->m_state->m_veloc.m_w == dgFloat32 (0.0f));
+			dgAssert (body->m_state->m_omega.m_w == dgFloat32 (0.0f));
 			dgFloat32 accel2 = body->m_accel.DotProduct4(body->m_accel).GetScalar();
 			dgFloat32 alpha2 = body->m_alpha.DotProduct4(body->m_alpha).GetScalar();
-			dgFloat32 speed2 = body->m_veloc.DotProduct4(body->m_veloc).GetScalar();
-			dgFloat32 omega2 = body->m_omega.DotProduct4(body->m_omega).GetScalar();
+			dgFloat32 speed2 = body->m_state->m_veloc.DotProduct4(body->m_state->m_veloc).GetScalar();
+			dgFloat32 omega2 = body->m_state->m_omega.DotProduct4(body->m_state->m_omega).GetScalar();
 
 			maxAccel = dgMax (maxAccel, accel2);
 			maxAlpha = dgMax (maxAlpha, alpha2);
@@ -708,16 +747,16 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 			maxOmega = dgMax (maxOmega, omega2);
 			bool equilibrium = (accel2 < accelFreeze) && (alpha2 < accelFreeze) && (speed2 < speedFreeze) && (omega2 < speedFreeze);
 			if (equilibrium) {
-				dgVector veloc (body->m_veloc * velocDragVect);
-				dgVector omega (body->m_omega * velocDragVect);
-				body->m_veloc = (veloc.DotProduct4(veloc) > m_velocTol) & veloc;
-				body->m_omega = (omega.DotProduct4(omega) > m_velocTol) & omega;
+				dgVector veloc (body->m_state->m_veloc * velocDragVect);
+				dgVector omega (body->m_state->m_omega * velocDragVect);
+				body->m_state->m_veloc = (veloc.DotProduct4(veloc) > m_velocTol) & veloc;
+				body->m_state->m_omega = (omega.DotProduct4(omega) > m_velocTol) & omega;
 			}
 
-			body->m_equilibrium = equilibrium ? 1 : 0;
+			body->m_state->m_equilibrium = equilibrium ? 1 : 0;
 //body->m_equilibrium &= body->m_autoSleep;
 			stackSleeping &= equilibrium;
-			isClusterResting &= (body->m_autoSleep & equilibrium);
+			isClusterResting &= (body->m_state->m_autoSleep & equilibrium);
 			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 				sleepCounter = dgMin (sleepCounter, ((dgDynamicBody*)body)->m_sleepingCounter);
 			}
@@ -733,9 +772,9 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 				dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 				body->m_accel = dgVector::m_zero;
 				body->m_alpha = dgVector::m_zero;
-				body->m_veloc = dgVector::m_zero;
-				body->m_omega = dgVector::m_zero;
-				body->m_sleeping = body->m_autoSleep;
+				body->m_state->m_veloc = dgVector::m_zero;
+				body->m_state->m_omega = dgVector::m_zero;
+				body->m_state->m_sleeping = body->m_state->m_autoSleep;
 			}
 		} else {
 			const bool state = (maxAccel > world->m_sleepTable[DG_SLEEP_ENTRIES - 1].m_maxAccel) || (maxAlpha > world->m_sleepTable[DG_SLEEP_ENTRIES - 1].m_maxAlpha) ||
@@ -765,10 +804,10 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 						dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 						body->m_accel = dgVector::m_zero;
 						body->m_alpha = dgVector::m_zero;
-						body->m_veloc = dgVector::m_zero;
-						body->m_omega = dgVector::m_zero;
-						body->m_equilibrium = 1;
-						body->m_sleeping = body->m_autoSleep;
+						body->m_state->m_veloc = dgVector::m_zero;
+						body->m_state->m_omega = dgVector::m_zero;
+						body->m_state->m_equilibrium = 1;
+						body->m_state->m_sleeping = body->m_state->m_autoSleep;
 					}
 				} else {
 					sleepCounter ++;
@@ -786,12 +825,9 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 
 void dgJacobianMemory::Init(dgWorld* const world, dgInt32 rowsCount, dgInt32 bodyCount, dgInt32 blockMatrixSizeInBytes)
 {
-	world->m_solverJacobiansMemory.ResizeIfNecessary ((rowsCount + 1) * sizeof (dgJacobianMatrixElement));
-	m_jacobianBuffer = (dgJacobianMatrixElement*)&world->m_solverJacobiansMemory[0];
-
-	world->m_solverForceAccumulatorMemory.ResizeIfNecessary ((bodyCount + 8) * sizeof (dgJacobian));
-	m_internalForcesBuffer = (dgJacobian*)&world->m_solverForceAccumulatorMemory[0];
-	dgAssert(bodyCount <= (((world->m_solverForceAccumulatorMemory.GetBytesCapacity() - 16) / dgInt32(sizeof (dgJacobian))) & (-8)));
+	// these live until the next step, the solver arena is reset by dgWorld::StepDynamics
+	m_jacobianBuffer = (dgJacobianMatrixElement*)world->m_solverArena.Alloc((rowsCount + 1) * sizeof (dgJacobianMatrixElement));
+	m_internalForcesBuffer = (dgJacobian*)world->m_solverArena.Alloc((bodyCount + 8) * sizeof (dgJacobian));
 
 	dgAssert((dgUnsigned64(m_jacobianBuffer) & 0x01f) == 0);
 	dgAssert((dgUnsigned64(m_internalForcesBuffer) & 0x01f) == 0);
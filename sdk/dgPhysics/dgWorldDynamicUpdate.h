@@ -24,6 +24,7 @@
 
 
 #include "dgPhysicsStdafx.h"
+#include "dgWorldDynamicsParallelSolver.h"
 
 
 //#define DG_PSD_DAMP_TOL				dgFloat32 (1.0e-2f)
@@ -35,6 +36,7 @@
 #define	DG_MAX_SKELETON_JOINT_COUNT		256
 #define DG_MAX_CONTINUE_COLLISON_STEPS	8
 #define	DG_SMALL_ISLAND_COUNT			2
+#define	DG_PARALLEL_SOLVER_MAX_COLORS	64
 
 #define	DG_FREEZZING_VELOCITY_DRAG		dgFloat32 (0.9f)
 #define	DG_SOLVER_MAX_ERROR				(DG_FREEZE_ACCEL * dgFloat32 (0.5f))
@@ -55,6 +57,7 @@
 
 class dgBody;
 class dgDynamicBody;
+class dgSkeletonContainer;
 class dgParallelSolverSyncData;
 class dgWorldDynamicUpdateSyncDescriptor;
 
@@ -118,8 +121,6 @@ class dgParallelSolverSyncData
 		memset (this, 0, sizeof (dgParallelSolverSyncData));
 	}
 
-	dgFloat32 m_accelNorm[DG_MAX_THREADS_HIVE_COUNT];
-
 	dgFloat32 m_timestep;
 	dgFloat32 m_invTimestep;
 	dgFloat32 m_invStepRK;
@@ -133,17 +134,24 @@ class dgParallelSolverSyncData
 	dgInt32 m_maxPasses;
 	dgInt32 m_bodyCount;
 	dgInt32 m_jointCount;
-	dgInt32 m_rowCount;
 	dgInt32 m_atomicIndex;
-	dgInt32 m_lock0;
-	dgInt32 m_lock1;
-	dgInt32 m_jacobianMatrixRowAtomicIndex;
+	dgInt32 m_soaBlockCount;
+	dgInt32 m_skeletonCount;
 
-	dgInt32* m_bodyLocks;  
 	const dgBodyCluster* m_cluster;
 	dgParallelJointMap* m_jointConflicts;
-	dgInt32 m_jointBatches[32];
-	dgInt32 m_hasJointFeeback[DG_MAX_THREADS_HIVE_COUNT];
+	dgSkeletonContainer** m_skeletonArray;
+	dgInt32* m_skeletonMemoryStart;
+	dgInt8* m_skeletonMemory;
+	dgSoaJointBlock* m_soaBlocks;
+	dgFloat32* m_soaRows;
+	const dgSoaSolverKernel* m_soaKernel;
+	dgInt32 m_jointBatches[DG_PARALLEL_SOLVER_MAX_COLORS + 2];
+	dgInt32 m_blockBatches[DG_PARALLEL_SOLVER_MAX_COLORS + 2];
+
+	// per thread reductions, one entry per worker
+	dgFloat32* m_accelNorm;
+	dgInt32* m_hasJointFeeback;
 };
 
 
@@ -252,25 +260,22 @@ class dgWorldDynamicUpdate
 
 	static void CalculateClusterReactionForcesKernel (void* const context, void* const worldContext, dgInt32 threadID);
 
-	static void IntegrateInslandParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void InitializeBodyArrayParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void BuildJacobianMatrixParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void SolverInitInternalForcesParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void CalculateJointsForceParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
 	static void CalculateJointsAccelParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void CalculateJointsVelocParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void KinematicCallbackUpdateParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
-	static void UpdateFeedbackForcesParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void CalculateJointsForceParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void InitSoaBlocksParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void InitSkeletonsParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void UpdateSoaBlocksParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void UpdateSoaRowsParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
 	static void UpdateBodyVelocityParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void UpdateFeedbackForcesParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void CalculateNetAccelerationParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
+	static void KinematicCallbackUpdateParallelKernel (void* const context, void* const worldContext, dgInt32 threadID); 
 	static dgInt32 SortJointInfoByColor(const dgParallelSolverSyncData::dgParallelJointMap* const indirectIndexA, const dgParallelSolverSyncData::dgParallelJointMap* const indirectIndexB, void* const context);
 
-	void IntegrateClusterParallel(dgParallelSolverSyncData* const syncData) const; 
-	void InitilizeBodyArrayParallel (dgParallelSolverSyncData* const syncData) const; 
-	void BuildJacobianMatrixParallel (dgParallelSolverSyncData* const syncData) const; 
-	void SolverInitInternalForcesParallel (dgParallelSolverSyncData* const syncData) const; 
+	void BuildSoaBlocksParallel (dgParallelSolverSyncData* const syncData) const; 
 	void CalculateForcesGameModeParallel (dgParallelSolverSyncData* const syncData) const; 
 
-	void CalculateReactionForcesParallel (const dgBodyCluster* const cluster, dgFloat32 timestep) const;
+	void CalculateReactionForcesParallel (dgBodyCluster* const cluster, dgFloat32 timestep) const;
 	void LinearizeJointParallelArray(dgParallelSolverSyncData* const solverSyncData, dgJointInfo* const constraintArray, const dgBodyCluster* const cluster) const;
 
 	void CalculateNetAcceleration (dgBody* const body, const dgVector& invTimeStep, const dgVector& accNorm) const;
@@ -299,6 +304,8 @@ class dgWorldDynamicUpdate
 	dgJacobianMemory m_solverMemory;
 	dgThread::dgCriticalSection m_softBodyCriticalSectionLock;
 	dgBodyCluster* m_clusterMemory;
+	dgInt32 m_soaKernelsCount;
+	dgSoaSolverKernel m_soaKernels[2];
 	
 	static dgVector m_velocTol;
 	
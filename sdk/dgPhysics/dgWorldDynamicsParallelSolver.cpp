@@ -25,62 +25,76 @@
 #include "dgWorld.h"
 #include "dgConstraint.h"
 #include "dgDynamicBody.h"
+#include "dgSkeletonContainer.h"
 #include "dgWorldDynamicUpdate.h"
 
 
-
-
-
-void dgWorldDynamicUpdate::CalculateReactionForcesParallel(const dgBodyCluster* const cluster, dgFloat32 timestep) const
+// the parallel solver colors the joints of the cluster so that no two joints of the same color share a body,
+// all joints of one color are solved concurrently, and when an extended instruction set is available
+// they are also packed into structure of arrays blocks, one joint per lane.
+void dgWorldDynamicUpdate::CalculateReactionForcesParallel(dgBodyCluster* const cluster, dgFloat32 timestep) const
 {
-	dgAssert(0);
-	/*
-	dgParallelSolverSyncData syncData;
-
+	dTimeTrackerEvent(__FUNCTION__);
 	dgWorld* const world = (dgWorld*) this;
 
-	syncData.m_bodyLocks = dgAlloca (dgInt32, island->m_bodyCount + 1024);
-	syncData.m_jointConflicts = dgAlloca (dgParallelSolverSyncData::dgParallelJointMap, island->m_jointCount + 1024);
-	memset (syncData.m_bodyLocks, 0, island->m_bodyCount * sizeof (dgInt32));
+	if (cluster->m_isContinueCollision) {
+		ResolveClusterForces(cluster, 0, timestep);
+		return;
+	}
 
-	dgInt32 bodyCount = island->m_bodyCount;
-	dgInt32 jointsCount = island->m_jointCount;
-	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
-	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
+	const dgInt32 activeJoint = SortClusters(cluster, timestep, 0);
+	if (activeJoint > 1) {
+		BuildJacobianMatrix(cluster, 0, timestep);
+
+		dgParallelSolverSyncData syncData;
+		dgJointInfo* const constraintArrayPtr = (dgJointInfo*)&world->m_jointsMemory[0];
+		dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+
+		const dgInt32 maxPasses = 4;
+		syncData.m_timestep = timestep;
+		syncData.m_invTimestep = (timestep > dgFloat32(0.0f)) ? dgFloat32(1.0f) / timestep : dgFloat32(0.0f);
+		syncData.m_invStepRK = (dgFloat32(1.0f) / dgFloat32(maxPasses));
+		syncData.m_timestepRK = syncData.m_timestep * syncData.m_invStepRK;
+		syncData.m_invTimestepRK = syncData.m_invTimestep * dgFloat32(maxPasses);
+		syncData.m_maxPasses = maxPasses;
+		syncData.m_passes = world->m_solverMode;
+		syncData.m_bodyCount = cluster->m_bodyCount;
+		syncData.m_jointCount = cluster->m_jointCount;
+		syncData.m_cluster = cluster;
+		syncData.m_soaKernel = (world->m_hardwaredIndex > 0) ? &m_soaKernels[world->m_hardwaredIndex - 1] : NULL;
+
+		dgFrameArenaScope scratch(&world->m_solverArena);
+		syncData.m_jointConflicts = scratch.Alloc<dgParallelSolverSyncData::dgParallelJointMap>(syncData.m_jointCount + 1);
+		syncData.m_accelNorm = scratch.Alloc<dgFloat32>(world->GetThreadCount());
+		syncData.m_hasJointFeeback = scratch.Alloc<dgInt32>(world->GetThreadCount());
+		memset (syncData.m_accelNorm, 0, world->GetThreadCount() * sizeof (dgFloat32));
+		memset (syncData.m_hasJointFeeback, 0, world->GetThreadCount() * sizeof (dgInt32));
+
+		LinearizeJointParallelArray(&syncData, constraintArray, cluster);
+		if (syncData.m_soaKernel) {
+			BuildSoaBlocksParallel(&syncData);
+		}
+		CalculateForcesGameModeParallel(&syncData);
+	} else {
+		dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*)&world->m_bodiesMemory[0];
+		dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
+		dgVector zero(dgVector::m_zero);
+		for (dgInt32 i = 1; i < cluster->m_bodyCount; i++) {
+			dgDynamicBody* const body = (dgDynamicBody*)bodyArray[i].m_body;
+			body->m_accel = zero;
+			body->m_alpha = zero;
+		}
+	}
 
-	LinearizeJointParallelArray (&syncData, constraintArray, island);
-	
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[0];
-	internalForces[0].m_linear = dgVector::m_zero;
-	internalForces[0].m_angular = dgVector::m_zero;
-
-	const dgInt32 maxPasses = 4;
-	syncData.m_timestep = timestep;
-	syncData.m_invTimestep = (timestep > dgFloat32 (0.0f)) ? dgFloat32 (1.0f) / timestep : dgFloat32 (0.0f);
-	syncData.m_invStepRK = (dgFloat32 (1.0f) / dgFloat32 (maxPasses));
-	syncData.m_timestepRK = syncData.m_timestep * syncData.m_invStepRK;
-	syncData.m_invTimestepRK = syncData.m_invTimestep * dgFloat32 (maxPasses);
-	syncData.m_maxPasses = maxPasses;
-	syncData.m_passes = world->m_solverMode;
-
-	syncData.m_bodyCount = bodyCount;
-	syncData.m_jointCount = jointsCount;
-	syncData.m_atomicIndex = 0;
-	syncData.m_island = island;
-
-	InitilizeBodyArrayParallel (&syncData);
-	BuildJacobianMatrixParallel (&syncData);
-	SolverInitInternalForcesParallel (&syncData);
-	CalculateForcesGameModeParallel (&syncData);
-	IntegrateIslandParallel(&syncData); 
-*/
+	IntegrateVelocity(cluster, DG_SOLVER_MAX_ERROR, timestep, 0);
 }
 
 
 dgInt32 dgWorldDynamicUpdate::SortJointInfoByColor(const dgParallelSolverSyncData::dgParallelJointMap* const indirectIndexA, const dgParallelSolverSyncData::dgParallelJointMap* const indirectIndexB, void* const )
 {
-	dgInt64 keyA = (((dgInt64)indirectIndexA->m_bashCount) << 32) + indirectIndexA->m_color;
-	dgInt64 keyB = (((dgInt64)indirectIndexB->m_bashCount) << 32) + indirectIndexB->m_color;
+	// joints with similar row count are packed in the same block, to minimize the padding rows
+	dgInt64 keyA = (((dgInt64)indirectIndexA->m_color) << 32) - indirectIndexA->m_bashCount;
+	dgInt64 keyB = (((dgInt64)indirectIndexB->m_color) << 32) - indirectIndexB->m_bashCount;
 	if (keyA < keyB) {
 		return -1;
 	}
@@ -93,457 +107,610 @@ dgInt32 dgWorldDynamicUpdate::SortJointInfoByColor(const dgParallelSolverSyncDat
 
 void dgWorldDynamicUpdate::LinearizeJointParallelArray(dgParallelSolverSyncData* const solverSyncData, dgJointInfo* const constraintArray, const dgBodyCluster* const cluster) const
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = solverSyncData->m_jointConflicts;
-	dgInt32 count = cluster->m_jointCount;
-	for (dgInt32 i = 0; i < count; i++) {
-		dgConstraint* const joint = constraintArray[i].m_joint;
-		joint->m_index = i;
-		jointInfoMap[i].m_jointIndex = i;
-		jointInfoMap[i].m_color = 0;
-	}
-	jointInfoMap[count].m_color = 0x7fffffff;
-	jointInfoMap[count].m_jointIndex = -1;
+	const dgInt32 count = cluster->m_jointCount;
+
+	// greedy coloring using the cluster body indices, the sentinel body does not receive forces so it never causes a conflict.
+	// joints that can not be colored are solved sequentially after all colored batches.
+	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, 0, dgWorldPerformanceCounters::m_jacobianBuild);
+	dgFrameArenaScope scratch(&world->m_solverArena);
+	dgUnsigned64* const bodyColors = scratch.Alloc<dgUnsigned64>(cluster->m_bodyCount);
+	memset(bodyColors, 0, cluster->m_bodyCount * sizeof (dgUnsigned64));
 
+	dgInt32 colorCount = 0;
 	for (dgInt32 i = 0; i < count; i++) {
-		dgInt32 index = 0;
-		dgInt32 color = jointInfoMap[i].m_color;
-		for (dgInt32 n = 1; n & color; n <<= 1) {
-			index++;
-			dgAssert(index < 32);
+		const dgJointInfo& jointInfo = constraintArray[i];
+		const dgInt32 m0 = jointInfo.m_m0;
+		const dgInt32 m1 = jointInfo.m_m1;
+		const dgUnsigned64 conflicts = bodyColors[m0] | bodyColors[m1];
+
+		dgInt32 color = 0;
+		while ((color < DG_PARALLEL_SOLVER_MAX_COLORS) && (conflicts & (dgUnsigned64(1) << color))) {
+			color++;
 		}
-		jointInfoMap[i].m_bashCount = index;
-		color = 1 << index;
-		dgAssert(jointInfoMap[i].m_jointIndex == i);
-		dgJointInfo& jointInfo = constraintArray[i];
-
-		dgConstraint* const constraint = jointInfo.m_joint;
-		dgDynamicBody* const body0 = (dgDynamicBody*)constraint->m_body0;
-		dgAssert(body0->IsRTTIType(dgBody::m_dynamicBodyRTTI));
-
-		if (body0->m_invMass.m_w > dgFloat32(0.0f)) {
-			for (dgBodyMasterListRow::dgListNode* jointNode = body0->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
-				dgBodyMasterListCell& cell = jointNode->GetInfo();
-
-				dgConstraint* const neiborgLink = cell.m_joint;
-				if ((neiborgLink != constraint) && (neiborgLink->m_maxDOF)) {
-					dgParallelSolverSyncData::dgParallelJointMap& info = jointInfoMap[neiborgLink->m_index];
-					info.m_color |= color;
-				}
-			}
+		if (color < DG_PARALLEL_SOLVER_MAX_COLORS) {
+			const dgUnsigned64 colorMask = dgUnsigned64(1) << color;
+			bodyColors[m0] |= colorMask;
+			bodyColors[m1] |= colorMask;
+			bodyColors[0] = 0;
+			colorCount = dgMax(colorCount, color + 1);
 		}
 
-		dgDynamicBody* const body1 = (dgDynamicBody*)constraint->m_body1;
-		dgAssert(body1->IsRTTIType(dgBody::m_dynamicBodyRTTI));
-		if (body1->m_invMass.m_w > dgFloat32(0.0f)) {
-			for (dgBodyMasterListRow::dgListNode* jointNode = body1->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
-				dgBodyMasterListCell& cell = jointNode->GetInfo();
-
-				dgConstraint* const neiborgLink = cell.m_joint;
-				if ((neiborgLink != constraint) && (neiborgLink->m_maxDOF)) {
-					dgParallelSolverSyncData::dgParallelJointMap& info = jointInfoMap[neiborgLink->m_index];
-					info.m_color |= color;
-				}
-			}
-		}
+		jointInfoMap[i].m_color = color;
+		jointInfoMap[i].m_bashCount = jointInfo.m_pairCount;
+		jointInfoMap[i].m_jointIndex = i;
 	}
+	jointInfoMap[count].m_color = 0x7fffffff;
+	jointInfoMap[count].m_bashCount = 0;
+	jointInfoMap[count].m_jointIndex = -1;
 
 	dgSort(jointInfoMap, count, SortJointInfoByColor);
 
-	dgInt32 acc = 0;
-	dgInt32 bash = 0;
-	dgInt32 bachCount = 0;
-	for (int i = 0; i < count; i++) {
-		if (jointInfoMap[i].m_bashCount > bash) {
-			bash = jointInfoMap[i].m_bashCount;
-			solverSyncData->m_jointBatches[bachCount + 1] = acc;
-			bachCount++;
-			dgAssert(bachCount < (dgInt32(sizeof (solverSyncData->m_jointBatches) / sizeof (solverSyncData->m_jointBatches[0])) - 1));
+	dgInt32 index = 0;
+	for (dgInt32 i = 0; i <= colorCount; i++) {
+		solverSyncData->m_jointBatches[i] = index;
+		while ((index < count) && (jointInfoMap[index].m_color == i)) {
+			index++;
 		}
-		acc++;
 	}
-	bachCount++;
-	solverSyncData->m_bachCount = bachCount;
-	solverSyncData->m_jointBatches[bachCount] = acc;
-	dgAssert(bachCount < (dgInt32(sizeof (solverSyncData->m_jointBatches) / sizeof (solverSyncData->m_jointBatches[0])) - 1));
+	// the last batch holds the joints that could not be colored
+	solverSyncData->m_jointBatches[colorCount + 1] = count;
+	solverSyncData->m_bachCount = colorCount;
 }
 
 
-void dgWorldDynamicUpdate::InitilizeBodyArrayParallel (dgParallelSolverSyncData* const syncData) const
+void dgWorldDynamicUpdate::BuildSoaBlocksParallel(dgParallelSolverSyncData* const syncData) const
 {
-	dgAssert (0);
-	/*
 	dgWorld* const world = (dgWorld*) this;
-	const dgInt32 threadCounts = world->GetThreadCount();	
-
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[0];
-	internalForces[0].m_linear = dgVector(dgFloat32(0.0f));
-	internalForces[0].m_angular = dgVector(dgFloat32(0.0f));
+	const dgInt32 threadCounts = world->GetThreadCount();
+	const dgInt32 lanes = syncData->m_soaKernel->m_lanes;
+	const dgInt32 rowStride = m_soaRowFieldsCount * lanes;
+	const dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
+
+	// the joints in each batch are sorted by decreasing row count, so the first lane of a block sets the block row count
+	dgInt32 blockCount = 0;
+	dgInt32 rowsCount = 0;
+	for (dgInt32 i = 0; i < syncData->m_bachCount; i++) {
+		syncData->m_blockBatches[i] = blockCount;
+		for (dgInt32 j = syncData->m_jointBatches[i]; j < syncData->m_jointBatches[i + 1]; j += lanes) {
+			rowsCount += jointInfoMap[j].m_bashCount + 1;
+			blockCount++;
+		}
+	}
+	syncData->m_blockBatches[syncData->m_bachCount] = blockCount;
+	syncData->m_soaBlockCount = blockCount;
+
+	// released with the joint map by the caller
+	syncData->m_soaBlocks = (dgSoaJointBlock*)world->m_solverArena.Alloc(blockCount * sizeof (dgSoaJointBlock));
+	syncData->m_soaRows = (dgFloat32*)world->m_solverArena.Alloc(rowsCount * rowStride * sizeof (dgFloat32));
+	dgAssert((dgUnsigned64(syncData->m_soaRows) & 0x3f) == 0);
+
+	dgInt32 rowStart = 0;
+	dgSoaJointBlock* block = syncData->m_soaBlocks;
+	for (dgInt32 i = 0; i < syncData->m_bachCount; i++) {
+		const dgInt32 batchEnd = syncData->m_jointBatches[i + 1];
+		for (dgInt32 j = syncData->m_jointBatches[i]; j < batchEnd; j += lanes) {
+			block->m_jointStart = j;
+			block->m_laneCount = dgMin(lanes, batchEnd - j);
+			block->m_rowCount = jointInfoMap[j].m_bashCount;
+			block->m_rowStart = rowStart;
+			rowStart += (block->m_rowCount + 1) * rowStride;
+			block++;
+		}
+	}
 
-	syncData->m_atomicIndex = 1;
-	for (dgInt32 i = 0; i < threadCounts; i ++) {
-		world->QueueJob (InitializeBodyArrayParallelKernel, syncData, world);
+	syncData->m_atomicIndex = 0;
+	for (dgInt32 i = 0; i < threadCounts; i++) {
+		world->QueueJob(InitSoaBlocksParallelKernel, syncData, world);
 	}
 	world->SynchronizationBarrier();
-*/
 }
 
-void dgWorldDynamicUpdate::InitializeBodyArrayParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+
+void dgWorldDynamicUpdate::CalculateForcesGameModeParallel (dgParallelSolverSyncData* const syncData) const
 {
-	dgAssert (0);
-/*
-	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
-	dgWorld* const world = (dgWorld*) worldContext;
-	dgInt32* const atomicIndex = &syncData->m_atomicIndex; 
+	dgWorld* const world = (dgWorld*) this;
+	const dgInt32 threadCounts = world->GetThreadCount();
+
+	const dgBodyCluster* const cluster = syncData->m_cluster;
+	dgJacobian* const internalForces = &m_solverMemory.m_internalForcesBuffer[cluster->m_bodyStart];
+	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*)&world->m_bodiesMemory[0];
+	dgJointInfo* const constraintArrayPtr = (dgJointInfo*)&world->m_jointsMemory[0];
+	dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	dgJacobianMatrixElement* const matrixRow = &m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
+
+	dgInt32 skeletonCount = 0;
+	dgInt32 skeletonMemorySizeInBytes = 0;
+	dgInt32 lru = dgAtomicExchangeAndAdd(&dgSkeletonContainer::m_lruMarker, 1);
+	dgSkeletonContainer* skeletonArray[DG_MAX_SKELETON_JOINT_COUNT];
+	dgInt32 memoryStart[DG_MAX_SKELETON_JOINT_COUNT];
+	for (dgInt32 i = 1; i < syncData->m_bodyCount; i++) {
+		dgDynamicBody* const body = (dgDynamicBody*)bodyArray[i].m_body;
+		dgSkeletonContainer* const container = body->GetSkeleton();
+		if (container && (container->m_lru != lru)) {
+			container->m_lru = lru;
+			memoryStart[skeletonCount] = skeletonMemorySizeInBytes;
+			skeletonMemorySizeInBytes += container->GetMemoryBufferSizeInBytes(constraintArray, matrixRow);
+			skeletonArray[skeletonCount] = container;
+			skeletonCount++;
+			dgAssert(skeletonCount < dgInt32(sizeof(skeletonArray) / sizeof(skeletonArray[0])));
+		}
+	}
 
-	const dgIsland* const island = syncData->m_island;
-	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-	dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[0];
+	dgFrameArenaScope scratch(&world->m_solverArena);
+	dgInt8* const skeletonMemory = scratch.Alloc<dgInt8>(skeletonMemorySizeInBytes);
+	dgAssert((dgInt64(skeletonMemory) & 0x0f) == 0);
+
+	// each skeleton factors its own mass matrix into its own slice of the buffer, 
+	// so they are all independent tasks ahead of the iterative solve
+	syncData->m_skeletonCount = skeletonCount;
+	syncData->m_skeletonArray = skeletonArray;
+	syncData->m_skeletonMemoryStart = memoryStart;
+	syncData->m_skeletonMemory = skeletonMemory;
+	if (skeletonCount > 1) {
+		syncData->m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			world->QueueJob(InitSkeletonsParallelKernel, syncData, world);
+		}
+		world->SynchronizationBarrier();
+	} else if (skeletonCount) {
+		skeletonArray[0]->InitMassMatrix(constraintArray, matrixRow, skeletonMemory);
+	}
 
-	if (syncData->m_timestep != dgFloat32 (0.0f)) {
-		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-			dgAssert (bodyArray[0].m_body->IsRTTIType (dgBody::m_dynamicBodyRTTI) || (((dgDynamicBody*)bodyArray[0].m_body)->m_accel.DotProduct3(((dgDynamicBody*)bodyArray[0].m_body)->m_accel)) == dgFloat32 (0.0f));
-			dgAssert (bodyArray[0].m_body->IsRTTIType (dgBody::m_dynamicBodyRTTI) || (((dgDynamicBody*)bodyArray[0].m_body)->m_alpha.DotProduct3(((dgDynamicBody*)bodyArray[0].m_body)->m_alpha)) == dgFloat32 (0.0f));
+	const dgInt32 passes = syncData->m_passes;
+	const dgInt32 maxPasses = syncData->m_maxPasses;
+	const dgInt32 batchCount = syncData->m_bachCount;
+	const dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
+	syncData->m_firstPassCoef = dgFloat32 (0.0f);
 
-			dgBody* const body = bodyArray[i].m_body;
-			dgAssert (body->m_index == i);
-			if (!body->m_equilibrium) {
-				dgAssert (body->m_invMass.m_w > dgFloat32 (0.0f));
-				body->AddDampingAcceleration(syncData->m_timestep);
-				body->CalcInvInertiaMatrix ();
-			}
+	for (dgInt32 step = 0; step < maxPasses; step++) {
+		syncData->m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			world->QueueJob(CalculateJointsAccelParallelKernel, syncData, world);
+		}
+		world->SynchronizationBarrier();
+		syncData->m_firstPassCoef = dgFloat32(1.0f);
 
-			if (body->m_active) {
-				// re use these variables for temp storage 
-				body->m_netForce = body->m_veloc;
-				body->m_netTorque = body->m_omega;
-				internalForces[i].m_linear = dgVector::m_zero;
-				internalForces[i].m_angular = dgVector::m_zero;
+		if (syncData->m_soaKernel) {
+			syncData->m_atomicIndex = 0;
+			for (dgInt32 i = 0; i < threadCounts; i++) {
+				world->QueueJob(UpdateSoaBlocksParallelKernel, syncData, world);
 			}
+			world->SynchronizationBarrier();
 		}
-	} else {
-		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-			dgAssert(bodyArray[0].m_body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || (((dgDynamicBody*)bodyArray[0].m_body)->m_accel.DotProduct3(((dgDynamicBody*)bodyArray[0].m_body)->m_accel)) == dgFloat32(0.0f));
-			dgAssert(bodyArray[0].m_body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || (((dgDynamicBody*)bodyArray[0].m_body)->m_alpha.DotProduct3(((dgDynamicBody*)bodyArray[0].m_body)->m_alpha)) == dgFloat32(0.0f));
 
-			dgBody* const body = bodyArray[i].m_body;
-			if (!body->m_equilibrium) {
-				dgAssert(body->m_invMass.m_w > dgFloat32(0.0f));
-				body->CalcInvInertiaMatrix();
+		const dgFloat32 maxAccNorm = DG_SOLVER_MAX_ERROR * DG_SOLVER_MAX_ERROR;
+		dgFloat32 accNorm = maxAccNorm * dgFloat32(2.0f);
+		for (dgInt32 k = 0; (k < passes) && (accNorm > maxAccNorm); k++) {
+			accNorm = dgFloat32(0.0f);
+			for (dgInt32 batchIndex = 0; batchIndex < batchCount; batchIndex++) {
+				const dgInt32* const batches = syncData->m_soaKernel ? syncData->m_blockBatches : syncData->m_jointBatches;
+				syncData->m_atomicIndex = batches[batchIndex];
+				syncData->m_bachIndex = batches[batchIndex + 1];
+				for (dgInt32 i = 0; i < threadCounts; i++) {
+					syncData->m_accelNorm[i] = dgFloat32(0.0f);
+				}
+				for (dgInt32 i = 0; i < threadCounts; i++) {
+					world->QueueJob(CalculateJointsForceParallelKernel, syncData, world);
+				}
+				world->SynchronizationBarrier();
+				for (dgInt32 i = 0; i < threadCounts; i++) {
+					accNorm = dgMax(accNorm, syncData->m_accelNorm[i]);
+				}
 			}
 
-			if (body->m_active) {
-				 //re use these variables for temp storage 
-				body->m_netForce = body->m_veloc;
-				body->m_netTorque = body->m_omega;
-				internalForces[i].m_linear = dgVector::m_zero;
-				internalForces[i].m_angular = dgVector::m_zero;
+			for (dgInt32 i = syncData->m_jointBatches[batchCount]; i < syncData->m_jointCount; i++) {
+				dgJointInfo* const jointInfo = &constraintArray[jointInfoMap[i].m_jointIndex];
+				accNorm = dgMax(accNorm, CalculateJointForce(jointInfo, bodyArray, internalForces, matrixRow));
 			}
 		}
+
+		if (syncData->m_soaKernel) {
+			syncData->m_atomicIndex = 0;
+			for (dgInt32 i = 0; i < threadCounts; i++) {
+				world->QueueJob(UpdateSoaRowsParallelKernel, syncData, world);
+			}
+			world->SynchronizationBarrier();
+		}
+
+		for (dgInt32 j = 0; j < skeletonCount; j++) {
+			skeletonArray[j]->CalculateJointForce(constraintArray, bodyArray, internalForces, matrixRow);
+		}
+
+		syncData->m_atomicIndex = 1;
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			world->QueueJob(UpdateBodyVelocityParallelKernel, syncData, world);
+		}
+		world->SynchronizationBarrier();
 	}
-*/
-}
 
+	if (syncData->m_timestepRK != dgFloat32 (0.0f)) {
+		syncData->m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCounts; i ++) {
+			world->QueueJob (UpdateFeedbackForcesParallelKernel, syncData, world);
+		}
+		world->SynchronizationBarrier();
+
+		dgInt32 hasJointFeeback = 0;
+		for (dgInt32 i = 0; i < threadCounts; i ++) {
+			hasJointFeeback |= syncData->m_hasJointFeeback[i];
+		}
 
-void dgWorldDynamicUpdate::BuildJacobianMatrixParallel (dgParallelSolverSyncData* const syncData) const
-{
-	dgWorld* const world = (dgWorld*) this;
-	const dgInt32 threadCounts = world->GetThreadCount();	
+		syncData->m_atomicIndex = 1;
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			world->QueueJob(CalculateNetAccelerationParallelKernel, syncData, world);
+		}
+		world->SynchronizationBarrier();
 
-	syncData->m_atomicIndex = 0;
-	for (dgInt32 i = 0; i < threadCounts; i ++) {
-		world->QueueJob (BuildJacobianMatrixParallelKernel, syncData, world);
+		if (hasJointFeeback) {
+			syncData->m_atomicIndex = 0;
+			for (dgInt32 i = 0; i < threadCounts; i++) {
+				world->QueueJob(KinematicCallbackUpdateParallelKernel, syncData, world);
+			}
+			world->SynchronizationBarrier();
+		}
+	} else {
+		for (dgInt32 i = 1; i < syncData->m_bodyCount; i++) {
+			dgBody* const body = bodyArray[i].m_body;
+			dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
+			body->m_accel = dgVector::m_zero;
+			body->m_alpha = dgVector::m_zero;
+		}
 	}
-	world->SynchronizationBarrier();
 }
 
 
-void dgWorldDynamicUpdate::BuildJacobianMatrixParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+void dgWorldDynamicUpdate::CalculateJointsAccelParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-	dgAssert (0);
-/*
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
-	dgInt32* const atomicIndex = &syncData->m_atomicIndex; 
-	const dgIsland* const island = syncData->m_island;
-	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-	dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
 	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
-	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
-	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[0];
-	dgAssert (syncData->m_jointCount);
-
-	dgContraintDescritor constraintParams;
-	constraintParams.m_world = world;
-	constraintParams.m_threadIndex = threadID;
-	constraintParams.m_timestep = syncData->m_timestep;
-	constraintParams.m_invTimestep = syncData->m_invTimestep;
-
-	dgFloat32 forceOrImpulseScale = (syncData->m_timestep > dgFloat32 (0.0f)) ? dgFloat32 (1.0f) : dgFloat32 (0.0f);
-	for (dgInt32 jointIndex = dgAtomicExchangeAndAdd(atomicIndex, 1); jointIndex < syncData->m_jointCount;  jointIndex = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-		dgJointInfo* const jointInfo = &constraintArray[jointIndex];
-		dgConstraint* const constraint = jointInfo->m_joint;
-
-		dgInt32 rowBase = dgAtomicExchangeAndAdd(&syncData->m_jacobianMatrixRowAtomicIndex, jointInfo->m_pairCount);
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
 
-		world->GetJacobianDerivatives(constraintParams, jointInfo, constraint, matrixRow, rowBase);
+	dgJointAccelerationDecriptor joindDesc;
+	joindDesc.m_timeStep = syncData->m_timestepRK;
+	joindDesc.m_invTimeStep = syncData->m_invTimestepRK;
+	joindDesc.m_firstPassCoefFlag = syncData->m_firstPassCoef;
 
-		dgAssert (jointInfo->m_m0 >= 0);
-		dgAssert (jointInfo->m_m1 >= 0);
-		dgAssert (jointInfo->m_m0 != jointInfo->m_m1);
-		dgAssert (jointInfo->m_m0 < island->m_bodyCount);
-		dgAssert (jointInfo->m_m1 < island->m_bodyCount);
-		world->BuildJacobianMatrix (bodyArray, jointInfo, matrixRow, forceOrImpulseScale);
+	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_jointCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		dgJointInfo* const jointInfo = &constraintArray[i];
+		dgConstraint* const constraint = jointInfo->m_joint;
+		joindDesc.m_rowsCount = jointInfo->m_pairCount;
+		joindDesc.m_rowMatrix = &matrixRow[jointInfo->m_pairStart];
+		constraint->JointAccelerations(&joindDesc);
 	}
-*/
 }
 
 
-void dgWorldDynamicUpdate::SolverInitInternalForcesParallel (dgParallelSolverSyncData* const syncData) const
+void dgWorldDynamicUpdate::CalculateJointsForceParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-	dgWorld* const world = (dgWorld*) this;
-	const dgInt32 threadCounts = world->GetThreadCount();	
+	dTimeTrackerEvent(__FUNCTION__);
+	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
+	dgWorld* const world = (dgWorld*) worldContext;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
+	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[cluster->m_bodyStart];
 
-	syncData->m_atomicIndex = 0;
-	for (dgInt32 i = 0; i < threadCounts; i ++) {
-		world->QueueJob (SolverInitInternalForcesParallelKernel, syncData, world);
+	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
+	const dgInt32 batchEnd = syncData->m_bachIndex;
+	dgFloat32 accNorm = dgFloat32(0.0f);
+	if (syncData->m_soaKernel) {
+		const dgSoaBlockSolver solver = syncData->m_soaKernel->m_solver;
+		const dgSoaJointBlock* const blocks = syncData->m_soaBlocks;
+		dgFloat32* const soaRows = syncData->m_soaRows;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < batchEnd; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+			accNorm = dgMax(accNorm, solver(&blocks[i], soaRows, &internalForces[0].m_linear.m_x));
+		}
+	} else {
+		dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
+		dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0];
+		const dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
+		dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
+		dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+		const dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < batchEnd; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+			dgJointInfo* const jointInfo = &constraintArray[jointInfoMap[i].m_jointIndex];
+			accNorm = dgMax(accNorm, world->CalculateJointForce(jointInfo, bodyArray, internalForces, matrixRow));
+		}
 	}
-	world->SynchronizationBarrier();
+	syncData->m_accelNorm[threadID] = dgMax(syncData->m_accelNorm[threadID], accNorm);
 }
 
 
-void dgWorldDynamicUpdate::SolverInitInternalForcesParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+void dgWorldDynamicUpdate::InitSkeletonsParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-	dgAssert (0);
-/*
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
-	const dgIsland* const island = syncData->m_island;
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[0];
-	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[0];
-	dgInt32* const atomicIndex = &syncData->m_atomicIndex; 
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_jacobianBuild);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
 	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
-	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
-	dgInt32* const bodyLocks = syncData->m_bodyLocks;
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
 
-	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_jointCount;  i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-		dgJointInfo* const jointInfo = &constraintArray[i];
-		if (jointInfo->m_joint->m_solverActive) {
-			dgJacobian y0;
-			dgJacobian y1;
-			world->InitJointForce (jointInfo, matrixRow, y0, y1);
-			const dgInt32 m0 = jointInfo->m_m0;
-			const dgInt32 m1 = jointInfo->m_m1;
-			dgAssert (m0 != m1);
-
-			if (m0) {
-				dgSpinLock(&bodyLocks[m0], false);
-				internalForces[m0].m_linear += y0.m_linear;
-				internalForces[m0].m_angular += y0.m_angular;
-				dgSpinUnlock(&bodyLocks[m0]);
-			}
-			if (m1) {
-				dgSpinLock(&bodyLocks[m1], false);
-				internalForces[m1].m_linear += y1.m_linear;
-				internalForces[m1].m_angular += y1.m_angular;
-				dgSpinUnlock(&bodyLocks[m1]);
-			}
-		}
+	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_skeletonCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		dgSkeletonContainer* const skeleton = syncData->m_skeletonArray[i];
+		skeleton->InitMassMatrix(constraintArray, matrixRow, &syncData->m_skeletonMemory[syncData->m_skeletonMemoryStart[i]]);
 	}
-*/
 }
 
 
-void dgWorldDynamicUpdate::CalculateJointsAccelParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+void dgWorldDynamicUpdate::InitSoaBlocksParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-	dgAssert (0);
-/*
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
-	const dgIsland* const island = syncData->m_island;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_jacobianBuild);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
 	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
-	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
-	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[0];
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	const dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
+	const dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
 
-	dgJointAccelerationDecriptor joindDesc;
-	joindDesc.m_timeStep = syncData->m_timestepRK;
-	joindDesc.m_invTimeStep = syncData->m_invTimestepRK;
-	joindDesc.m_firstPassCoefFlag = syncData->m_firstPassCoef;
+	const dgInt32 lanes = syncData->m_soaKernel->m_lanes;
+	const dgInt32 rowStride = m_soaRowFieldsCount * lanes;
 
-	dgInt32* const atomicIndex = &syncData->m_atomicIndex; 
-	if (joindDesc.m_firstPassCoefFlag == dgFloat32 (0.0f)) {
-		for (dgInt32 curJoint = dgAtomicExchangeAndAdd(atomicIndex, 1); curJoint < syncData->m_jointCount;  curJoint = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-			dgJointInfo* const jointInfo = &constraintArray[curJoint];
-			dgConstraint* const constraint = jointInfo->m_joint;
-			if (constraint->m_solverActive) {
-				joindDesc.m_rowsCount = jointInfo->m_pairCount;
-				joindDesc.m_rowMatrix = &matrixRow[jointInfo->m_pairStart];
-				constraint->JointAccelerations(&joindDesc);
+	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_soaBlockCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		dgSoaJointBlock* const block = &syncData->m_soaBlocks[i];
+		dgFloat32* const rows = &syncData->m_soaRows[block->m_rowStart];
+
+		// padding lanes and padding rows have zero jacobians and zero bounds, so their force is always zero.
+		// the extra row at the end is the unit normal force used by rows without friction bounds
+		memset(rows, 0, (block->m_rowCount + 1) * rowStride * sizeof (dgFloat32));
+		memset(block->m_m0, 0, sizeof (block->m_m0));
+		memset(block->m_m1, 0, sizeof (block->m_m1));
+		memset(block->m_activeMask, 0, sizeof (block->m_activeMask));
+		memset(block->m_scale0, 0, sizeof (block->m_scale0));
+		memset(block->m_scale1, 0, sizeof (block->m_scale1));
+
+		dgFloat32* const unitRow = &rows[block->m_rowCount * rowStride];
+		const dgInt32 unitNormalIndex = block->m_rowCount * rowStride + m_soaForce * lanes;
+		for (dgInt32 lane = 0; lane < lanes; lane++) {
+			unitRow[m_soaForce * lanes + lane] = dgFloat32(1.0f);
+			for (dgInt32 j = 0; j < block->m_rowCount; j++) {
+				dgInt32* const normalIndex = (dgInt32*)&rows[j * rowStride + m_soaNormalForceIndex * lanes];
+				normalIndex[lane] = unitNormalIndex + lane;
 			}
 		}
-	} else {
-		const dgIsland* const island = syncData->m_island;
-		dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-		const dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-
-		for (dgInt32 curJoint = dgAtomicExchangeAndAdd(atomicIndex, 1); curJoint < syncData->m_jointCount;  curJoint = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-			dgJointInfo* const jointInfo = &constraintArray[curJoint];
-			dgConstraint* const constraint = jointInfo->m_joint;
-			if (constraint->m_solverActive) {
-				const dgInt32 m0 = jointInfo->m_m0;
-				const dgInt32 m1 = jointInfo->m_m1;
-				const dgBody* const body0 = bodyArray[m0].m_body;
-				const dgBody* const body1 = bodyArray[m1].m_body;
-				if (!(body0->m_resting & body1->m_resting)) {
-					joindDesc.m_rowsCount = jointInfo->m_pairCount;
-					joindDesc.m_rowMatrix = &matrixRow[jointInfo->m_pairStart];
-					constraint->JointAccelerations(&joindDesc);
+
+		for (dgInt32 lane = 0; lane < block->m_laneCount; lane++) {
+			const dgJointInfo* const jointInfo = &constraintArray[jointInfoMap[block->m_jointStart + lane].m_jointIndex];
+			block->m_m0[lane] = jointInfo->m_m0;
+			block->m_m1[lane] = jointInfo->m_m1;
+			block->m_scale0[lane] = jointInfo->m_scale0;
+			block->m_scale1[lane] = jointInfo->m_scale1;
+
+			const dgInt32 rowsCount = jointInfo->m_pairCount;
+			dgAssert (rowsCount <= block->m_rowCount);
+			for (dgInt32 j = 0; j < rowsCount; j++) {
+				const dgJacobianMatrixElement* const row = &matrixRow[jointInfo->m_pairStart + j];
+				dgFloat32* const soaRow = &rows[j * rowStride];
+
+				const dgFloat32* const Jt0 = &row->m_Jt.m_jacobianM0.m_linear.m_x;
+				const dgFloat32* const Jt1 = &row->m_Jt.m_jacobianM1.m_linear.m_x;
+				const dgFloat32* const JMinv0 = &row->m_JMinv.m_jacobianM0.m_linear.m_x;
+				const dgFloat32* const JMinv1 = &row->m_JMinv.m_jacobianM1.m_linear.m_x;
+				for (dgInt32 k = 0; k < 3; k++) {
+					soaRow[(m_soaJt + k + 0) * lanes + lane] = Jt0[k];
+					soaRow[(m_soaJt + k + 3) * lanes + lane] = Jt0[k + 4];
+					soaRow[(m_soaJt + k + 6) * lanes + lane] = Jt1[k];
+					soaRow[(m_soaJt + k + 9) * lanes + lane] = Jt1[k + 4];
+					soaRow[(m_soaJMinv + k + 0) * lanes + lane] = JMinv0[k];
+					soaRow[(m_soaJMinv + k + 3) * lanes + lane] = JMinv0[k + 4];
+					soaRow[(m_soaJMinv + k + 6) * lanes + lane] = JMinv1[k];
+					soaRow[(m_soaJMinv + k + 9) * lanes + lane] = JMinv1[k + 4];
+				}
+				soaRow[m_soaDiagDamp * lanes + lane] = row->m_diagDamp;
+				soaRow[m_soaInvJinvMJt * lanes + lane] = row->m_invJinvMJt;
+				soaRow[m_soaLowerBoundFrictionCoefficent * lanes + lane] = row->m_lowerBoundFrictionCoefficent;
+				soaRow[m_soaUpperBoundFrictionCoefficent * lanes + lane] = row->m_upperBoundFrictionCoefficent;
+
+				dgAssert(row->m_normalForceIndex >= 0);
+				dgAssert(row->m_normalForceIndex <= rowsCount);
+				if (row->m_normalForceIndex < rowsCount) {
+					dgInt32* const normalIndex = (dgInt32*)&soaRow[m_soaNormalForceIndex * lanes];
+					normalIndex[lane] = row->m_normalForceIndex * rowStride + m_soaForce * lanes + lane;
 				}
 			}
 		}
 	}
-*/
 }
 
 
-void dgWorldDynamicUpdate::CalculateJointsVelocParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+void dgWorldDynamicUpdate::UpdateSoaBlocksParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-dgAssert (0);
-/*
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
+	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0];
+	const dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
+	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	const dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
+	const dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
 
-	const dgIsland* const island = syncData->m_island;
-	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-	dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[0];
+	const dgInt32 lanes = syncData->m_soaKernel->m_lanes;
+	const dgInt32 rowStride = m_soaRowFieldsCount * lanes;
 
-	dgVector speedFreeze2 (world->m_freezeSpeed2 * dgFloat32 (0.1f));
-	dgVector freezeOmega2 (world->m_freezeOmega2 * dgFloat32 (0.1f));
-	dgVector forceActiveMask ((syncData->m_jointCount <= DG_SMALL_ISLAND_COUNT) ?  dgVector (-1, -1, -1, -1) : dgFloat32 (0.0f));
+	// the joint accelerations and the forces of skeleton joints change with each integration step
 	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
-
-	if (syncData->m_timestepRK != dgFloat32 (0.0f)) {
-		dgVector timestep4 (syncData->m_timestepRK);
-		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount;  i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-			dgDynamicBody* const body = (dgDynamicBody*) bodyArray[i].m_body;
-			dgAssert (body->m_index == i);
-			world->ApplyNetVelcAndOmega (body, internalForces[i], timestep4, speedFreeze2, forceActiveMask);
-		}
-	} else {
-		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount;  i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-			dgBody* const body = bodyArray[i].m_body;
-			if (body->m_active) {
-				const dgVector& linearMomentum = internalForces[i].m_linear;
-				const dgVector& angularMomentum = internalForces[i].m_angular;
-
-				body->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
-				body->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_soaBlockCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		dgSoaJointBlock* const block = &syncData->m_soaBlocks[i];
+		dgFloat32* const rows = &syncData->m_soaRows[block->m_rowStart];
+		for (dgInt32 lane = 0; lane < block->m_laneCount; lane++) {
+			const dgJointInfo* const jointInfo = &constraintArray[jointInfoMap[block->m_jointStart + lane].m_jointIndex];
+			const dgBody* const body0 = bodyArray[jointInfo->m_m0].m_body;
+			const dgBody* const body1 = bodyArray[jointInfo->m_m1].m_body;
+			block->m_activeMask[lane] = (body0->m_state->m_resting & body1->m_state->m_resting) ? 0 : -1;
+
+			const dgInt32 rowsCount = jointInfo->m_pairCount;
+			for (dgInt32 j = 0; j < rowsCount; j++) {
+				const dgJacobianMatrixElement* const row = &matrixRow[jointInfo->m_pairStart + j];
+				dgFloat32* const soaRow = &rows[j * rowStride];
+				soaRow[m_soaForce * lanes + lane] = row->m_force;
+				soaRow[m_soaCoordenateAccel * lanes + lane] = row->m_coordenateAccel;
 			}
 		}
 	}
-*/
 }
 
-/*
-void dgWorldDynamicUpdate::CalculateJointsImpulseVelocParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+
+void dgWorldDynamicUpdate::UpdateSoaRowsParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
+	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
+	const dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
 
-	const dgIsland* const island = syncData->m_island;
-	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-	dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForces[0];
-	//dgJacobian* const internalVeloc = &world->m_solverMemory.m_internalVeloc[0];
+	const dgInt32 lanes = syncData->m_soaKernel->m_lanes;
+	const dgInt32 rowStride = m_soaRowFieldsCount * lanes;
 
 	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
-	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount;  i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-		dgInt32 index = i + 1;
-		dgAssert (index);
-		dgDynamicBody* const body = (dgDynamicBody*) bodyArray[index].m_body;
-		dgAssert (body->m_index == index);
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_soaBlockCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		const dgSoaJointBlock* const block = &syncData->m_soaBlocks[i];
+		const dgFloat32* const rows = &syncData->m_soaRows[block->m_rowStart];
+		for (dgInt32 lane = 0; lane < block->m_laneCount; lane++) {
+			if (block->m_activeMask[lane]) {
+				const dgJointInfo* const jointInfo = &constraintArray[jointInfoMap[block->m_jointStart + lane].m_jointIndex];
+				const dgInt32 rowsCount = jointInfo->m_pairCount;
+				for (dgInt32 j = 0; j < rowsCount; j++) {
+					dgJacobianMatrixElement* const row = &matrixRow[jointInfo->m_pairStart + j];
+					row->m_force = rows[j * rowStride + m_soaForce * lanes + lane];
+					row->m_maxImpact = dgMax(dgAbsf(row->m_force), row->m_maxImpact);
+				}
+			}
+		}
+	}
+}
+
+
+void dgWorldDynamicUpdate::UpdateBodyVelocityParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	dTimeTrackerEvent(__FUNCTION__);
+	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
+	dgWorld* const world = (dgWorld*) worldContext;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
+	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[cluster->m_bodyStart];
+	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0];
+	dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
 
-		const dgVector& linearMomentum = internalForces[index].m_linear;
-		const dgVector& angularMomentum = internalForces[index].m_angular;
+	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
+	if (syncData->m_timestepRK != dgFloat32(0.0f)) {
+		const dgVector speedFreeze2(world->m_freezeSpeed2 * dgFloat32(0.1f));
+		const dgVector timestep4(syncData->m_timestepRK);
+		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+			dgDynamicBody* const body = (dgDynamicBody*)bodyArray[i].m_body;
+			dgAssert(body->m_index == i);
+			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+				const dgJacobian& forceAndTorque = internalForces[i];
+				const dgVector force(body->m_externalForce + forceAndTorque.m_linear);
+				const dgVector torque(body->m_externalTorque + forceAndTorque.m_angular);
+
+				const dgVector velocStep((force.Scale4(body->m_invMass.m_w)) * timestep4);
+				const dgVector omegaStep((body->m_invWorldInertiaMatrix.RotateVector(torque)) * timestep4);
+
+				if (!body->m_state->m_resting) {
+					body->m_state->m_veloc += velocStep;
+					body->m_state->m_omega += omegaStep;
+				} else {
+					const dgVector velocStep2(velocStep.DotProduct4(velocStep));
+					const dgVector omegaStep2(omegaStep.DotProduct4(omegaStep));
+					const dgVector test(((velocStep2 > speedFreeze2) | (omegaStep2 > speedFreeze2)) & dgVector::m_negOne);
+					const dgInt32 equilibrium = test.GetSignMask() ? 0 : 1;
+					body->m_state->m_resting &= equilibrium;
+				}
 
-		body->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
-		body->m_omega += body->m_invWorldInertiaMatrix.RotateVector (angularMomentum);
+				dgAssert(body->m_state->m_veloc.m_w == dgFloat32(0.0f));
+				dgAssert(body->m_state->m_omega.m_w == dgFloat32(0.0f));
+			}
+		}
+	} else {
+		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+			dgDynamicBody* const body = (dgDynamicBody*)bodyArray[i].m_body;
+			const dgVector& linearMomentum = internalForces[i].m_linear;
+			const dgVector& angularMomentum = internalForces[i].m_angular;
 
-		//internalVeloc[index].m_linear += body->m_veloc;
-		//internalVeloc[index].m_angular += body->m_omega;
+			body->m_state->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
+			body->m_state->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
+		}
 	}
 }
-*/
+
 
 void dgWorldDynamicUpdate::UpdateFeedbackForcesParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-dgAssert (0);
-/*
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
-	const dgIsland* const island = syncData->m_island;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
 	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
-	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
-	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[0];
+	dgJointInfo* const constraintArray = &constraintArrayPtr[cluster->m_jointStart];
+	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[cluster->m_rowsStart];
 
 	dgInt32 hasJointFeeback = 0;
 	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
-	
-	for (dgInt32 curJoint = dgAtomicExchangeAndAdd(atomicIndex, 1); curJoint < syncData->m_jointCount;  curJoint = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-		dgJointInfo* const jointInfo = &constraintArray[curJoint];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_jointCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		dgJointInfo* const jointInfo = &constraintArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
-		if (constraint->m_solverActive) {
-			const dgInt32 first = jointInfo->m_pairStart;
-			const dgInt32 count = jointInfo->m_pairCount;
-
-			for (dgInt32 j = 0; j < count; j++) {
-				dgJacobianMatrixElement* const row = &matrixRow[j + first];
-				dgFloat32 val = row->m_force;
-				dgAssert(dgCheckFloat(val));
-				row->m_jointFeebackForce->m_force = val;
-				row->m_jointFeebackForce->m_impact = row->m_maxImpact * syncData->m_timestepRK;
-			}
-			hasJointFeeback |= (constraint->m_updaFeedbackCallback ? 1 : 0);
+		const dgInt32 first = jointInfo->m_pairStart;
+		const dgInt32 count = jointInfo->m_pairCount;
+
+		for (dgInt32 j = 0; j < count; j++) {
+			dgJacobianMatrixElement* const row = &matrixRow[j + first];
+			dgAssert(dgCheckFloat(row->m_force));
+			row->m_jointFeebackForce->m_force = row->m_force;
+			row->m_jointFeebackForce->m_impact = row->m_maxImpact * syncData->m_timestepRK;
 		}
+		hasJointFeeback |= (constraint->m_updaFeedbackCallback ? 1 : 0);
 	}
-	syncData->m_hasJointFeeback[threadID] = hasJointFeeback;
-*/
+	syncData->m_hasJointFeeback[threadID] |= hasJointFeeback;
 }
 
 
-void dgWorldDynamicUpdate::UpdateBodyVelocityParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
+void dgWorldDynamicUpdate::CalculateNetAccelerationParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
-dgAssert (0);
-/*
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
+	const dgBodyCluster* const cluster = syncData->m_cluster;
+	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0];
+	dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
 
-	const dgBodyCluster* const island = syncData->m_cluster;
-	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-	dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-
-	dgFloat32 maxAccNorm2 = DG_SOLVER_MAX_ERROR * DG_SOLVER_MAX_ERROR;
-
-	//dgFloat32 invTimestepSrc = dgFloat32 (1.0f) / syncData->m_timestep;
-	dgFloat32 invTimestepSrc = syncData->m_invTimestep;
-
-	dgVector invTime (invTimestepSrc);
+	const dgVector invTime(syncData->m_invTimestep);
+	const dgVector maxAccNorm2(DG_SOLVER_MAX_ERROR * DG_SOLVER_MAX_ERROR);
 	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
 	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < syncData->m_bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-		dgDynamicBody* const body = (dgDynamicBody*) bodyArray[i].m_body;
-		world->CalculateNetAcceleration (body, invTime, maxAccNorm2);
+		world->CalculateNetAcceleration(bodyArray[i].m_body, invTime, maxAccNorm2);
 	}
-*/
 }
 
 
 void dgWorldDynamicUpdate::KinematicCallbackUpdateParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
 	dgWorld* const world = (dgWorld*) worldContext;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
 	const dgBodyCluster* const island = syncData->m_cluster;
 	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
 	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
@@ -556,185 +723,3 @@ void dgWorldDynamicUpdate::KinematicCallbackUpdateParallelKernel (void* const co
 		}
 	}
 }
-
-
-void dgWorldDynamicUpdate::IntegrateClusterParallel(dgParallelSolverSyncData* const syncData) const
-{
-	dgAssert (0);
-/*
-	dgWorld* const world = (dgWorld*) this;
-//	dgWorldDynamicUpdate::IntegrateIslandParallelKernel (syncData, world, 0);
-	world->IntegrateVelocity (syncData->m_cluster, DG_SOLVER_MAX_ERROR, syncData->m_timestep, 0); 
-*/
-}
-
-
-void dgWorldDynamicUpdate::CalculateForcesGameModeParallel (dgParallelSolverSyncData* const syncData) const
-{
-dgAssert (0);
-/*
-	dgWorld* const world = (dgWorld*) this;
-	const dgInt32 threadCounts = world->GetThreadCount();	
-
-	const dgInt32 passes = syncData->m_passes;
-	const dgInt32 maxPasses = syncData->m_maxPasses;
-//	const dgInt32 batchCount = syncData->m_bachCount;
-	syncData->m_firstPassCoef = dgFloat32 (0.0f);
-
-	for (dgInt32 step = 0; step < maxPasses; step++) {
-
-		syncData->m_atomicIndex = 0;
-		for (dgInt32 i = 0; i < threadCounts; i++) {
-			world->QueueJob(CalculateJointsAccelParallelKernel, syncData, world);
-		}
-		world->SynchronizationBarrier();
-		syncData->m_firstPassCoef = dgFloat32(1.0f);
-
-		dgFloat32 accNorm = DG_SOLVER_MAX_ERROR * dgFloat32(2.0f);
-		for (dgInt32 k = 0; (k < passes) && (accNorm > DG_SOLVER_MAX_ERROR); k++) {
-
-#if 0
-			dgInt32 batchIndex = 0;
-			dgInt32 count = syncData->m_jointBatches[batchIndex + 1];
-			while ((batchIndex < batchCount) && (count >= threadCounts * 8)) {
-				syncData->m_bachIndex = syncData->m_jointBatches[batchIndex + 1];
-				syncData->m_atomicIndex = syncData->m_jointBatches[batchIndex];
-				for (dgInt32 i = 0; i < threadCounts; i++) {
-					world->QueueJob(CalculateJointsForceParallelKernel, syncData, world);
-				}
-				world->SynchronizationBarrier();
-				accNorm = dgFloat32(0.0f);
-				for (dgInt32 i = 0; i < threadCounts; i++) {
-					accNorm = dgMax(accNorm, syncData->m_accelNorm[i]);
-				}
-
-				batchIndex++;
-				count = syncData->m_jointBatches[batchIndex + 1] - syncData->m_jointBatches[batchIndex];
-			}
-
-			if (batchIndex < batchCount) {
-				syncData->m_bachIndex = syncData->m_jointBatches[batchCount];
-				syncData->m_atomicIndex = syncData->m_jointBatches[batchIndex];
-				CalculateJointsForceParallelKernel(syncData, world, 0);
-				accNorm = dgMax(accNorm, syncData->m_accelNorm[0]);
-			}
-#endif
-
-			syncData->m_atomicIndex = 0;
-			for (dgInt32 i = 0; i < threadCounts; i++) {
-				world->QueueJob(CalculateJointsForceParallelKernel, syncData, world);
-			}
-			world->SynchronizationBarrier();
-			accNorm = dgFloat32(0.0f);
-			for (dgInt32 i = 0; i < threadCounts; i++) {
-				accNorm = dgMax(accNorm, syncData->m_accelNorm[i]);
-			}
-		}
-
-
-		syncData->m_atomicIndex = 1;
-		for (dgInt32 j = 0; j < threadCounts; j++) {
-			world->QueueJob(CalculateJointsVelocParallelKernel, syncData, world);
-		}
-		world->SynchronizationBarrier();
-	}
-
-	if (syncData->m_timestepRK != dgFloat32 (0.0f)) {
-		syncData->m_atomicIndex = 0;
-		for (dgInt32 j = 0; j < threadCounts; j ++) {
-			world->QueueJob (UpdateFeedbackForcesParallelKernel, syncData, world);
-		}
-		world->SynchronizationBarrier();
-
-		dgInt32 hasJointFeeback = 0;
-		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
-			hasJointFeeback |= syncData->m_hasJointFeeback[i];
-		}
-
-		syncData->m_atomicIndex = 1;
-		for (dgInt32 j = 0; j < threadCounts; j++) {
-			world->QueueJob(UpdateBodyVelocityParallelKernel, syncData, world);
-		}
-		world->SynchronizationBarrier();
-
-		if (hasJointFeeback) {
-			syncData->m_atomicIndex = 0;
-			for (dgInt32 j = 0; j < threadCounts; j++) {
-				world->QueueJob(KinematicCallbackUpdateParallelKernel, syncData, world);
-			}
-			world->SynchronizationBarrier();
-		}
-
-	} else {
-		const dgInt32 count = syncData->m_bodyCount;
-		const dgIsland* const island = syncData->m_island;
-		dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*)&world->m_bodiesMemory[0];
-		dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-		for (dgInt32 i = 1; i < count; i++) {
-			dgBody* const body = bodyArray[i].m_body;
-			if (body->m_active) {
-				body->m_netForce = dgVector::m_zero;
-				body->m_netTorque = dgVector::m_zero;
-			}
-		}
-	}
-*/
-}
-
-
-void dgWorldDynamicUpdate::CalculateJointsForceParallelKernel (void* const context, void* const worldContext, dgInt32 threadID)
-{
-	dgAssert (0);
-/*
-	dgParallelSolverSyncData* const syncData = (dgParallelSolverSyncData*) context;
-	dgWorld* const world = (dgWorld*) worldContext;
-
-	const dgIsland* const island = syncData->m_island;
-	dgJacobianMatrixElement* const matrixRow = &world->m_solverMemory.m_jacobianBuffer[0];
-	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
-	const dgBodyInfo* const bodyArray = &bodyArrayPtr[island->m_bodyStart];
-	dgJointInfo* const constraintArrayPtr = (dgJointInfo*) &world->m_jointsMemory[0];
-	dgJointInfo* const constraintArray = &constraintArrayPtr[island->m_jointStart];
-	dgJacobian* const internalForces = &world->m_solverMemory.m_internalForcesBuffer[0];
-//	const int jointCount = syncData->m_bachIndex;
-	const int jointCount = syncData->m_jointCount;
-
-	dgInt32* const bodyLocks = syncData->m_bodyLocks;
-	dgParallelSolverSyncData::dgParallelJointMap* const jointInfoMap = syncData->m_jointConflicts;
-
-	dgInt32* const atomicIndex = &syncData->m_atomicIndex;
-	dgFloat32 accNorm = dgFloat32(0.0f);
-	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
-		dgInt32 index = jointInfoMap[i].m_jointIndex;
-		dgJointInfo* const jointInfo = &constraintArray[index];
-
-		const dgInt32 m0 = jointInfo->m_m0;
-		const dgInt32 m1 = jointInfo->m_m1;
-		dgAssert(m0 != m1);
-
-		dgSpinLock(&syncData->m_lock0, false);
-			if (m0) {
-				dgSpinLock(&bodyLocks[m0], false);
-			}
-			if (m1) {
-				dgSpinLock(&bodyLocks[m1], false);
-			}
-		dgSpinUnlock(&syncData->m_lock0);
-
-		dgFloat32 accel = world->CalculateJointForce(jointInfo, bodyArray, internalForces, matrixRow);
-
-		dgSpinLock(&syncData->m_lock1, false);
-			if (m0) {
-				dgSpinUnlock(&bodyLocks[m0]);
-			}
-			if (m1) {
-				dgSpinUnlock(&bodyLocks[m1]);
-			}
-		dgSpinUnlock(&syncData->m_lock1);
-
-		accNorm = (accel > accNorm) ? accel : accNorm;
-	}
-
-	syncData->m_accelNorm[threadID] = accNorm;
-*/
-}
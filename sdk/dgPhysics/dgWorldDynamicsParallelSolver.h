@@ -0,0 +1,185 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _DG_WORLD_DYNAMICS_PARALLEL_SOLVER_H_
+#define _DG_WORLD_DYNAMICS_PARALLEL_SOLVER_H_
+
+// this header is also included by the translation units compiled with avx2 and avx512 code generation,
+// it must only depend on the core types, so that no inline function of the engine is ever instantiated
+// with an instruction set that is not supported by the running cpu.
+#include "dgStdafx.h"
+
+
+#define DG_SOA_MAX_LANES			16
+#define DG_SOA_BODY_FORCE_STRIDE	8
+
+// the joints of a graph colored batch are packed into blocks of structure of arrays rows,
+// each field of a row is an array of one float per lane, one lane per joint.
+enum dgSoaRowField
+{
+	m_soaJt = 0,
+	m_soaJMinv = 12,
+	m_soaForce = 24,
+	m_soaCoordenateAccel,
+	m_soaDiagDamp,
+	m_soaInvJinvMJt,
+	m_soaLowerBoundFrictionCoefficent,
+	m_soaUpperBoundFrictionCoefficent,
+	m_soaNormalForceIndex,
+	m_soaRowFieldsCount = 32,
+};
+
+class dgSoaJointBlock
+{
+	public:
+	dgInt32 m_rowStart;
+	dgInt32 m_rowCount;
+	dgInt32 m_laneCount;
+	dgInt32 m_jointStart;
+	dgInt32 m_m0[DG_SOA_MAX_LANES];
+	dgInt32 m_m1[DG_SOA_MAX_LANES];
+	dgInt32 m_activeMask[DG_SOA_MAX_LANES];
+	dgFloat32 m_scale0[DG_SOA_MAX_LANES];
+	dgFloat32 m_scale1[DG_SOA_MAX_LANES];
+};
+
+// solve all lanes of a block one Gauss-Seidel sweep at the time, it returns the largest
+// squared acceleration error of any lane in the first sweep, internalForces is the cluster dgJacobian array
+typedef dgFloat32 (*dgSoaBlockSolver) (const dgSoaJointBlock* const block, dgFloat32* const soaRows, dgFloat32* const internalForces);
+
+class dgSoaSolverKernel
+{
+	public:
+	dgSoaBlockSolver m_solver;
+	dgInt32 m_lanes;
+	const char* m_name;
+};
+
+// these are compiled with the extended instruction set, only call them after dgGetCpuFeatures reported it.
+// the returned kernel has a NULL solver when the instruction set was not compiled in
+dgSoaSolverKernel dgGetSoaSolverKernelAvx2();
+dgSoaSolverKernel dgGetSoaSolverKernelAvx512();
+
+
+// dgSoaFloat is a wrapper of the native register of the instruction set, with as many lanes as the block.
+template<class dgSoaFloat>
+DG_INLINE dgSoaFloat dgSoaSolveBlockSweep (dgFloat32* const rows, dgInt32 rowCount, dgSoaFloat* const force, const dgSoaFloat& scale0, const dgSoaFloat& scale1, const dgSoaFloat& activeMask)
+{
+	const dgInt32 lanes = dgSoaFloat::m_lanes;
+	const dgInt32 stride = m_soaRowFieldsCount * lanes;
+
+	dgSoaFloat accNorm (dgFloat32 (0.0f));
+	for (dgInt32 i = 0; i < rowCount; i ++) {
+		dgFloat32* const row = &rows[i * stride];
+
+		dgSoaFloat diag (force[0] * dgSoaFloat (&row[m_soaJMinv * lanes]));
+		for (dgInt32 j = 1; j < 12; j ++) {
+			diag = diag.MulAdd (dgSoaFloat (&row[(m_soaJMinv + j) * lanes]), force[j]);
+		}
+
+		const dgSoaFloat x (&row[m_soaForce * lanes]);
+		const dgSoaFloat b (&row[m_soaCoordenateAccel * lanes]);
+		const dgSoaFloat accel (b - x * dgSoaFloat (&row[m_soaDiagDamp * lanes]) - diag);
+		const dgSoaFloat f (x.MulAdd (dgSoaFloat (&row[m_soaInvJinvMJt * lanes]), accel));
+
+		const dgSoaFloat frictionNormal (dgSoaFloat::Gather (rows, (dgInt32*) &row[m_soaNormalForceIndex * lanes]));
+		const dgSoaFloat lowerFrictionForce (frictionNormal * dgSoaFloat (&row[m_soaLowerBoundFrictionCoefficent * lanes]));
+		const dgSoaFloat upperFrictionForce (frictionNormal * dgSoaFloat (&row[m_soaUpperBoundFrictionCoefficent * lanes]));
+
+		const dgSoaFloat clampedAccel (accel.AndNot ((f > upperFrictionForce) | (f < lowerFrictionForce)) & activeMask);
+		const dgSoaFloat deltaForce ((f.GetMax (lowerFrictionForce).GetMin (upperFrictionForce) - x) & activeMask);
+		accNorm = accNorm.MulAdd (clampedAccel, clampedAccel);
+		(x + deltaForce).Store (&row[m_soaForce * lanes]);
+
+		const dgSoaFloat deltaForce0 (deltaForce * scale0);
+		const dgSoaFloat deltaForce1 (deltaForce * scale1);
+		for (dgInt32 j = 0; j < 6; j ++) {
+			force[j] = force[j].MulAdd (dgSoaFloat (&row[(m_soaJt + j) * lanes]), deltaForce0);
+		}
+		for (dgInt32 j = 6; j < 12; j ++) {
+			force[j] = force[j].MulAdd (dgSoaFloat (&row[(m_soaJt + j) * lanes]), deltaForce1);
+		}
+	}
+	return accNorm;
+}
+
+template<class dgSoaFloat>
+dgFloat32 dgSoaSolveBlock (const dgSoaJointBlock* const block, dgFloat32* const soaRows, dgFloat32* const internalForces)
+{
+	const dgInt32 lanes = dgSoaFloat::m_lanes;
+	dgFloat32 transpose[12][DG_SOA_MAX_LANES];
+
+	// the block lanes never share a body other than the sentinel, so gathering and scattering the forces needs no locks
+	for (dgInt32 i = 0; i < lanes; i ++) {
+		const dgFloat32* const force0 = &internalForces[block->m_m0[i] * DG_SOA_BODY_FORCE_STRIDE];
+		const dgFloat32* const force1 = &internalForces[block->m_m1[i] * DG_SOA_BODY_FORCE_STRIDE];
+		for (dgInt32 j = 0; j < 3; j ++) {
+			transpose[j + 0][i] = force0[j];
+			transpose[j + 3][i] = force0[j + 4];
+			transpose[j + 6][i] = force1[j];
+			transpose[j + 9][i] = force1[j + 4];
+		}
+	}
+
+	dgSoaFloat force[12];
+	for (dgInt32 j = 0; j < 12; j ++) {
+		force[j] = dgSoaFloat (transpose[j]);
+	}
+
+	dgFloat32* const rows = &soaRows[block->m_rowStart];
+	const dgSoaFloat scale0 (block->m_scale0);
+	const dgSoaFloat scale1 (block->m_scale1);
+	const dgSoaFloat activeMask ((dgFloat32*) block->m_activeMask);
+
+	const dgFloat32 tol2 = dgFloat32 (1.0e-4f);
+	const dgSoaFloat accNorm (dgSoaSolveBlockSweep (rows, block->m_rowCount, force, scale0, scale1, activeMask));
+	dgFloat32 maxAccel = accNorm.GetMaxHorizontal();
+	for (dgInt32 j = 0; (j < 4) && (maxAccel > tol2); j ++) {
+		maxAccel = dgSoaSolveBlockSweep (rows, block->m_rowCount, force, scale0, scale1, activeMask).GetMaxHorizontal();
+	}
+
+	for (dgInt32 j = 0; j < 12; j ++) {
+		force[j].Store (transpose[j]);
+	}
+	for (dgInt32 i = 0; i < block->m_laneCount; i ++) {
+		if (block->m_activeMask[i]) {
+			const dgInt32 m0 = block->m_m0[i];
+			const dgInt32 m1 = block->m_m1[i];
+			if (m0) {
+				dgFloat32* const force0 = &internalForces[m0 * DG_SOA_BODY_FORCE_STRIDE];
+				for (dgInt32 j = 0; j < 3; j ++) {
+					force0[j] = transpose[j + 0][i];
+					force0[j + 4] = transpose[j + 3][i];
+				}
+			}
+			if (m1) {
+				dgFloat32* const force1 = &internalForces[m1 * DG_SOA_BODY_FORCE_STRIDE];
+				for (dgInt32 j = 0; j < 3; j ++) {
+					force1[j] = transpose[j + 6][i];
+					force1[j + 4] = transpose[j + 9][i];
+				}
+			}
+		}
+	}
+	return accNorm.GetMaxHorizontal();
+}
+
+#endif
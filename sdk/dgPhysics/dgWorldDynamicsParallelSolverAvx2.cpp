@@ -0,0 +1,160 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+// this file is compiled with avx2 and fma code generation,
+// the kernel is only called after cpuid reported the instruction set.
+#include "dgWorldDynamicsParallelSolver.h"
+
+#if !defined (_NEWTON_USE_DOUBLE) && ((defined (__AVX2__) && defined (__FMA__)) || (defined (_MSC_VER) && (_MSC_VER >= 1700)))
+#include <immintrin.h>
+
+class dgSoaFloatAvx2
+{
+	public:
+	enum {
+		m_lanes = 8,
+	};
+
+	DG_INLINE dgSoaFloatAvx2 ()
+	{
+	}
+
+	DG_INLINE dgSoaFloatAvx2 (const __m256 type)
+		:m_type (type)
+	{
+	}
+
+	DG_INLINE dgSoaFloatAvx2 (const dgFloat32 a)
+		:m_type (_mm256_set1_ps (a))
+	{
+	}
+
+	DG_INLINE dgSoaFloatAvx2 (const dgFloat32* const ptr)
+		:m_type (_mm256_loadu_ps (ptr))
+	{
+	}
+
+	DG_INLINE void Store (dgFloat32* const ptr) const
+	{
+		_mm256_storeu_ps (ptr, m_type);
+	}
+
+	DG_INLINE static dgSoaFloatAvx2 Gather (const dgFloat32* const base, const dgInt32* const index)
+	{
+		return _mm256_i32gather_ps (base, _mm256_loadu_si256 ((const __m256i*) index), 4);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator+ (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_add_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator- (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_sub_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator* (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_mul_ps (m_type, A.m_type);
+	}
+
+	// return this + A * B
+	DG_INLINE dgSoaFloatAvx2 MulAdd (const dgSoaFloatAvx2& A, const dgSoaFloatAvx2& B) const
+	{
+		return _mm256_fmadd_ps (A.m_type, B.m_type, m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator> (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_cmp_ps (m_type, A.m_type, _CMP_GT_OQ);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator< (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_cmp_ps (m_type, A.m_type, _CMP_LT_OQ);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator| (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_or_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 operator& (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_and_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 AndNot (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_andnot_ps (A.m_type, m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 GetMax (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_max_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx2 GetMin (const dgSoaFloatAvx2& A) const
+	{
+		return _mm256_min_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgFloat32 GetMaxHorizontal () const
+	{
+		__m128 tmp (_mm_max_ps (_mm256_castps256_ps128 (m_type), _mm256_extractf128_ps (m_type, 1)));
+		tmp = _mm_max_ps (tmp, _mm_movehl_ps (tmp, tmp));
+		tmp = _mm_max_ss (tmp, _mm_shuffle_ps (tmp, tmp, 1));
+		return _mm_cvtss_f32 (tmp);
+	}
+
+	__m256 m_type;
+};
+
+static dgFloat32 dgSoaSolveBlockAvx2 (const dgSoaJointBlock* const block, dgFloat32* const soaRows, dgFloat32* const internalForces)
+{
+	dgFloat32 accNorm = dgSoaSolveBlock<dgSoaFloatAvx2> (block, soaRows, internalForces);
+	// avoid the avx to sse transition penalty in the caller
+	_mm256_zeroupper();
+	return accNorm;
+}
+
+dgSoaSolverKernel dgGetSoaSolverKernelAvx2()
+{
+	dgSoaSolverKernel kernel;
+	kernel.m_solver = dgSoaSolveBlockAvx2;
+	kernel.m_lanes = dgSoaFloatAvx2::m_lanes;
+	kernel.m_name = "avx2";
+	return kernel;
+}
+
+#else
+
+dgSoaSolverKernel dgGetSoaSolverKernelAvx2()
+{
+	dgSoaSolverKernel kernel;
+	kernel.m_solver = NULL;
+	kernel.m_lanes = 8;
+	kernel.m_name = "avx2";
+	return kernel;
+}
+
+#endif
@@ -0,0 +1,176 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+// this file is compiled with avx512 code generation,
+// the kernel is only called after cpuid reported the instruction set.
+#include "dgWorldDynamicsParallelSolver.h"
+
+#if !defined (_NEWTON_USE_DOUBLE) && (defined (__AVX512F__) || (defined (_MSC_VER) && (_MSC_VER >= 1911)))
+#include <immintrin.h>
+
+class dgSoaFloatAvx512
+{
+	public:
+	enum {
+		m_lanes = 16,
+	};
+
+	// the unmasked forms of some intrinsics start from an undefined register, which some gcc versions 
+	// report as maybe uninitialized, the masked forms with all lanes set generate the same instructions
+	static const __mmask16 m_allLanes = __mmask16 (0xffff);
+
+	DG_INLINE dgSoaFloatAvx512 ()
+	{
+	}
+
+	DG_INLINE dgSoaFloatAvx512 (const __m512 type)
+		:m_type (type)
+	{
+	}
+
+	DG_INLINE dgSoaFloatAvx512 (const dgFloat32 a)
+		:m_type (_mm512_set1_ps (a))
+	{
+	}
+
+	DG_INLINE dgSoaFloatAvx512 (const dgFloat32* const ptr)
+		:m_type (_mm512_loadu_ps (ptr))
+	{
+	}
+
+	DG_INLINE void Store (dgFloat32* const ptr) const
+	{
+		_mm512_storeu_ps (ptr, m_type);
+	}
+
+	DG_INLINE static dgSoaFloatAvx512 Gather (const dgFloat32* const base, const dgInt32* const index)
+	{
+		return _mm512_mask_i32gather_ps (_mm512_setzero_ps(), m_allLanes, _mm512_loadu_si512 (index), base, 4);
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator+ (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_add_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator- (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_sub_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator* (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_mul_ps (m_type, A.m_type);
+	}
+
+	// return this + A * B
+	DG_INLINE dgSoaFloatAvx512 MulAdd (const dgSoaFloatAvx512& A, const dgSoaFloatAvx512& B) const
+	{
+		return _mm512_fmadd_ps (A.m_type, B.m_type, m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator> (const dgSoaFloatAvx512& A) const
+	{
+		return MaskToFloat (_mm512_cmp_ps_mask (m_type, A.m_type, _CMP_GT_OQ));
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator< (const dgSoaFloatAvx512& A) const
+	{
+		return MaskToFloat (_mm512_cmp_ps_mask (m_type, A.m_type, _CMP_LT_OQ));
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator| (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_castsi512_ps (_mm512_or_si512 (_mm512_castps_si512 (m_type), _mm512_castps_si512 (A.m_type)));
+	}
+
+	DG_INLINE dgSoaFloatAvx512 operator& (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_castsi512_ps (_mm512_and_si512 (_mm512_castps_si512 (m_type), _mm512_castps_si512 (A.m_type)));
+	}
+
+	DG_INLINE dgSoaFloatAvx512 AndNot (const dgSoaFloatAvx512& A) const
+	{
+		const __m512i a (_mm512_castps_si512 (A.m_type));
+		return _mm512_castsi512_ps (_mm512_mask_andnot_epi32 (a, m_allLanes, a, _mm512_castps_si512 (m_type)));
+	}
+
+	DG_INLINE dgSoaFloatAvx512 GetMax (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_mask_max_ps (m_type, m_allLanes, m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloatAvx512 GetMin (const dgSoaFloatAvx512& A) const
+	{
+		return _mm512_mask_min_ps (m_type, m_allLanes, m_type, A.m_type);
+	}
+
+	DG_INLINE dgFloat32 GetMaxHorizontal () const
+	{
+		const __m256 low (_mm256_castpd_ps (_mm512_mask_extractf64x4_pd (_mm256_setzero_pd(), __mmask8 (0x0f), _mm512_castps_pd (m_type), 0)));
+		const __m256 high (_mm256_castpd_ps (_mm512_mask_extractf64x4_pd (_mm256_setzero_pd(), __mmask8 (0x0f), _mm512_castps_pd (m_type), 1)));
+		const __m256 tmp256 (_mm256_max_ps (low, high));
+		__m128 tmp (_mm_max_ps (_mm256_castps256_ps128 (tmp256), _mm256_extractf128_ps (tmp256, 1)));
+		tmp = _mm_max_ps (tmp, _mm_movehl_ps (tmp, tmp));
+		tmp = _mm_max_ss (tmp, _mm_shuffle_ps (tmp, tmp, 1));
+		return _mm_cvtss_f32 (tmp);
+	}
+
+	private:
+	// avx512f has no floating point logical operations, the masks are expanded to full lanes
+	DG_INLINE static dgSoaFloatAvx512 MaskToFloat (const __mmask16 mask)
+	{
+		return _mm512_castsi512_ps (_mm512_maskz_mov_epi32 (mask, _mm512_set1_epi32 (-1)));
+	}
+
+	public:
+	__m512 m_type;
+};
+
+static dgFloat32 dgSoaSolveBlockAvx512 (const dgSoaJointBlock* const block, dgFloat32* const soaRows, dgFloat32* const internalForces)
+{
+	dgFloat32 accNorm = dgSoaSolveBlock<dgSoaFloatAvx512> (block, soaRows, internalForces);
+	// avoid the avx to sse transition penalty in the caller
+	_mm256_zeroupper();
+	return accNorm;
+}
+
+dgSoaSolverKernel dgGetSoaSolverKernelAvx512()
+{
+	dgSoaSolverKernel kernel;
+	kernel.m_solver = dgSoaSolveBlockAvx512;
+	kernel.m_lanes = dgSoaFloatAvx512::m_lanes;
+	kernel.m_name = "avx512";
+	return kernel;
+}
+
+#else
+
+dgSoaSolverKernel dgGetSoaSolverKernelAvx512()
+{
+	dgSoaSolverKernel kernel;
+	kernel.m_solver = NULL;
+	kernel.m_lanes = 16;
+	kernel.m_name = "avx512";
+	return kernel;
+}
+
+#endif
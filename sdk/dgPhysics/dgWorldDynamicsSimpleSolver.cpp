@@ -98,8 +98,8 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 
 				const dgFloat32 accel2 = body->m_accel.DotProduct3(body->m_accel);
 				const dgFloat32 alpha2 = body->m_alpha.DotProduct3(body->m_alpha);
-				const dgFloat32 speed2 = body->m_veloc.DotProduct3(body->m_veloc);
-				const dgFloat32 omega2 = body->m_omega.DotProduct3(body->m_omega);
+				const dgFloat32 speed2 = body->m_state->m_veloc.DotProduct3(body->m_state->m_veloc);
+				const dgFloat32 omega2 = body->m_state->m_omega.DotProduct3(body->m_state->m_omega);
 
 				maxAccel = dgMax (maxAccel, accel2);
 				maxAlpha = dgMax (maxAlpha, alpha2);
@@ -108,15 +108,15 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 
 				bool equilibrium = (accel2 < accelFreeze) && (alpha2 < accelFreeze) && (speed2 < speedFreeze) && (omega2 < speedFreeze);
 				if (equilibrium) {
-					dgVector veloc (body->m_veloc * forceDampVect);
-					dgVector omega = body->m_omega * forceDampVect;
-					body->m_veloc = (veloc.DotProduct4(veloc) > m_velocTol) & veloc;
-					body->m_omega = (omega.DotProduct4(omega) > m_velocTol) & omega;
+					dgVector veloc (body->m_state->m_veloc * forceDampVect);
+					dgVector omega = body->m_state->m_omega * forceDampVect;
+					body->m_state->m_veloc = (veloc.DotProduct4(veloc) > m_velocTol) & veloc;
+					body->m_state->m_omega = (omega.DotProduct4(omega) > m_velocTol) & omega;
 
 				}
-				body->m_equilibrium = equilibrium ? 1 : 0;
+				body->m_state->m_equilibrium = equilibrium ? 1 : 0;
 				stackSleeping &= equilibrium;
-				isAutoSleep &= body->m_autoSleep;
+				isAutoSleep &= body->m_state->m_autoSleep;
 
 				sleepCounter = dgMin (sleepCounter, body->m_sleepingCounter);
 			}
@@ -133,8 +133,8 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 					dgAssert (body->IsRTTIType (dgBody::m_dynamicBodyRTTI) || body->IsRTTIType (dgBody::m_kinematicBodyRTTI));
 					body->m_accel = dgVector::m_zero;
 					body->m_alpha = dgVector::m_zero;
-					body->m_veloc = dgVector::m_zero;
-					body->m_omega = dgVector::m_zero;
+					body->m_state->m_veloc = dgVector::m_zero;
+					body->m_state->m_omega = dgVector::m_zero;
 				}
 			} else {
 				// island is not sleeping but may be resting with small residual velocity for a long time
@@ -170,9 +170,9 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 							dgAssert (body->IsRTTIType (dgBody::m_dynamicBodyRTTI) || body->IsRTTIType (dgBody::m_kinematicBodyRTTI));
 							body->m_accel = dgVector::m_zero;
 							body->m_alpha = dgVector::m_zero;
-							body->m_veloc = dgVector::m_zero;
-							body->m_omega = dgVector::m_zero;
-							body->m_equilibrium = 1;
+							body->m_state->m_veloc = dgVector::m_zero;
+							body->m_state->m_omega = dgVector::m_zero;
+							body->m_state->m_equilibrium = 1;
 						}
 					} else {
 						sleepCounter ++;
@@ -205,7 +205,7 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 					if (contact->GetId() == dgConstraint::m_contactConstraint) {
 						dgDynamicBody* const body0 = (dgDynamicBody*)contact->m_body0;
 						dgDynamicBody* const body1 = (dgDynamicBody*)contact->m_body1;
-						if (body0->m_continueCollisionMode | body1->m_continueCollisionMode) {
+						if (body0->m_state->m_continueCollisionMode | body1->m_state->m_continueCollisionMode) {
 							dgVector p;
 							dgVector q;
 							dgVector normal;
@@ -263,11 +263,11 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 									const dgBody* const body0 = contact->m_body0;
 									const dgBody* const body1 = contact->m_body1;
 
-									const dgVector& veloc0 = body0->m_veloc;
-									const dgVector& veloc1 = body1->m_veloc;
+									const dgVector& veloc0 = body0->m_state->m_veloc;
+									const dgVector& veloc1 = body1->m_state->m_veloc;
 
-									const dgVector& omega0 = body0->m_omega;
-									const dgVector& omega1 = body1->m_omega;
+									const dgVector& omega0 = body0->m_state->m_omega;
+									const dgVector& omega1 = body1->m_state->m_omega;
 
 									const dgVector& com0 = body0->m_globalCentreOfMass;
 									const dgVector& com1 = body1->m_globalCentreOfMass;
@@ -466,6 +466,7 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 	dgAssert (cluster->m_bodyCount >= 2);
 
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_jacobianBuild);
 	const dgInt32 bodyCount = cluster->m_bodyCount;
 
 	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
@@ -485,7 +486,7 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 		for (dgInt32 i = 1; i < bodyCount; i ++) {
 			dgDynamicBody* const body = (dgDynamicBody*)bodyArray[i].m_body;
 			dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
-			if (!body->m_equilibrium) {
+			if (!body->m_state->m_equilibrium) {
 				dgAssert (body->m_invMass.m_w > dgFloat32 (0.0f));
 				body->AddDampingAcceleration(timestep);
 				body->CalcInvInertiaMatrix ();
@@ -493,8 +494,8 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 			}
 
 			// re use these variables for temp storage 
-			body->m_accel = body->m_veloc;
-			body->m_alpha = body->m_omega;
+			body->m_accel = body->m_state->m_veloc;
+			body->m_alpha = body->m_state->m_omega;
 			internalForces[i].m_linear = dgVector::m_zero;
 			internalForces[i].m_angular = dgVector::m_zero;
 		}
@@ -503,14 +504,14 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 		for (dgInt32 i = 1; i < bodyCount; i ++) {
 			dgBody* const body = bodyArray[i].m_body;
 			dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
-			if (!body->m_equilibrium) {
+			if (!body->m_state->m_equilibrium) {
 				dgAssert (body->m_invMass.m_w > dgFloat32 (0.0f));
 				body->CalcInvInertiaMatrix ();
 			}
 
 			// re use these variables for temp storage 
-			body->m_accel = body->m_veloc;
-			body->m_alpha = body->m_omega;
+			body->m_accel = body->m_state->m_veloc;
+			body->m_alpha = body->m_state->m_omega;
 
 			internalForces[i].m_linear = dgVector::m_zero;
 			internalForces[i].m_angular = dgVector::m_zero;
@@ -555,6 +556,7 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 void dgWorldDynamicUpdate::IntegrateExternalForce(const dgBodyCluster* const cluster, dgFloat32 timestep, dgInt32 threadID) const
 {
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_integration);
 	dgBodyInfo* const bodyArrayPtr = (dgBodyInfo*) &world->m_bodiesMemory[0]; 
 	dgBodyInfo* const bodyArray = &bodyArrayPtr[cluster->m_bodyStart];
 
@@ -571,8 +573,8 @@ void dgWorldDynamicUpdate::CalculateNetAcceleration(dgBody* const body, const dg
 {
 	dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 	// the initial velocity and angular velocity were stored in m_accel and body->m_alpha for memory saving
-	dgVector accel (invTimeStep * (body->m_veloc - body->m_accel));
-	dgVector alpha (invTimeStep * (body->m_omega - body->m_alpha));
+	dgVector accel (invTimeStep * (body->m_state->m_veloc - body->m_accel));
+	dgVector alpha (invTimeStep * (body->m_state->m_omega - body->m_alpha));
 	dgVector accelTest((accel.DotProduct4(accel) > maxAccNorm2) | (alpha.DotProduct4(alpha) > maxAccNorm2));
 	accel = accel & accelTest;
 	alpha = alpha & accelTest;
@@ -584,6 +586,7 @@ void dgWorldDynamicUpdate::CalculateNetAcceleration(dgBody* const body, const dg
 
 void dgWorldDynamicUpdate::IntegrateReactionsForces(const dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const
 {
+	dTimeTrackerEvent(__FUNCTION__);
 	if (cluster->m_jointCount == 0) {
 		IntegrateExternalForce(cluster, timestep, threadID);
 	} else {
@@ -600,7 +603,7 @@ dgFloat32 dgWorldDynamicUpdate::CalculateJointForce_3_13(const dgJointInfo* cons
 	const dgBody* const body0 = bodyArray[m0].m_body;
 	const dgBody* const body1 = bodyArray[m1].m_body;
 
-	if (!(body0->m_resting & body1->m_resting)) {
+	if (!(body0->m_state->m_resting & body1->m_state->m_resting)) {
 		dgFloat32 normalForce[DG_CONSTRAINT_MAX_ROWS + 4];
 		dgVector linearM0(internalForces[m0].m_linear);
 		dgVector angularM0(internalForces[m0].m_angular);
@@ -687,7 +690,7 @@ dgFloat32 dgWorldDynamicUpdate::CalculateJointForce_1_50(const dgJointInfo* cons
 	const dgInt32 m1 = jointInfo->m_m1;
 	const dgBody* const body0 = bodyArray[m0].m_body;
 	const dgBody* const body1 = bodyArray[m1].m_body;
-	if (!(body0->m_resting & body1->m_resting)) {
+	if (!(body0->m_state->m_resting & body1->m_state->m_resting)) {
 		const dgInt32 index = jointInfo->m_pairStart;
 		const dgInt32 rowsCount = jointInfo->m_pairCount;
 		dgAssert(rowsCount <= DG_CONSTRAINT_MAX_ROWS);
@@ -766,7 +769,7 @@ dgFloat32 dgWorldDynamicUpdate::CalculateJointForce(const dgJointInfo* const joi
 	const dgInt32 m1 = jointInfo->m_m1;
 	const dgBody* const body0 = bodyArray[m0].m_body;
 	const dgBody* const body1 = bodyArray[m1].m_body;
-	if (!(body0->m_resting & body1->m_resting)) {
+	if (!(body0->m_state->m_resting & body1->m_state->m_resting)) {
 		dgVector b[DG_CONSTRAINT_MAX_ROWS];
 		dgVector x[DG_CONSTRAINT_MAX_ROWS + 1];
 		dgVector low[DG_CONSTRAINT_MAX_ROWS];
@@ -1021,6 +1024,7 @@ void dgWorldDynamicUpdate::CalculateSingleClusterReactionForces(const dgBodyClus
 {
 	dTimeTrackerEvent(__FUNCTION__);
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
 	const dgInt32 bodyCount = cluster->m_bodyCount;
 	const dgInt32 jointCount = cluster->m_jointCount;
 
@@ -1065,19 +1069,19 @@ void dgWorldDynamicUpdate::CalculateSingleClusterReactionForces(const dgBodyClus
 				const dgVector velocStep((force.Scale4(body->m_invMass.m_w)) * timestep4);
 				const dgVector omegaStep((body->m_invWorldInertiaMatrix.RotateVector(torque)) * timestep4);
 
-				if (!body->m_resting) {
-					body->m_veloc += velocStep;
-					body->m_omega += omegaStep;
+				if (!body->m_state->m_resting) {
+					body->m_state->m_veloc += velocStep;
+					body->m_state->m_omega += omegaStep;
 				} else {
 					const dgVector velocStep2(velocStep.DotProduct4(velocStep));
 					const dgVector omegaStep2(omegaStep.DotProduct4(omegaStep));
 					const dgVector test(((velocStep2 > speedFreeze2) | (omegaStep2 > speedFreeze2)) & dgVector::m_negOne);
 					const dgInt32 equilibrium = test.GetSignMask() ? 0 : 1;
-					body->m_resting &= equilibrium;
+					body->m_state->m_resting &= equilibrium;
 				}
 
-				dgAssert(body->m_veloc.m_w == dgFloat32(0.0f));
-				dgAssert(body->m_omega.m_w == dgFloat32(0.0f));
+				dgAssert(body->m_state->m_veloc.m_w == dgFloat32(0.0f));
+				dgAssert(body->m_state->m_omega.m_w == dgFloat32(0.0f));
 			}
 		}
 	} else {
@@ -1086,8 +1090,8 @@ void dgWorldDynamicUpdate::CalculateSingleClusterReactionForces(const dgBodyClus
 			const dgVector& linearMomentum = internalForces[i].m_linear;
 			const dgVector& angularMomentum = internalForces[i].m_angular;
 
-			body->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
-			body->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
+			body->m_state->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
+			body->m_state->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
 		}
 	}
 
@@ -1137,6 +1141,7 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 {
 	dTimeTrackerEvent(__FUNCTION__);
 	dgWorld* const world = (dgWorld*) this;
+	dgWorldPhaseTimer timer (world, threadID, dgWorldPerformanceCounters::m_solverIterations);
 	const dgInt32 bodyCount = cluster->m_bodyCount;
 	const dgInt32 jointCount = cluster->m_jointCount;
 
@@ -1181,7 +1186,8 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 		}
 	}
 
-	dgInt8* const skeletonMemory = (dgInt8*)dgAlloca(dgVector, skeletonMemorySizeInBytes / sizeof(dgVector));
+	dgFrameArenaScope scratch(&world->m_threadArena[threadID]);
+	dgInt8* const skeletonMemory = scratch.Alloc<dgInt8>(skeletonMemorySizeInBytes);
 	dgAssert((dgInt64(skeletonMemory) & 0x0f) == 0);
 
 	skeletonMemorySizeInBytes = 0;
@@ -1231,19 +1237,19 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 					const dgVector velocStep((force.Scale4(body->m_invMass.m_w)) * timestep4);
 					const dgVector omegaStep((body->m_invWorldInertiaMatrix.RotateVector(torque)) * timestep4);
 
-					if (!body->m_resting) {
-						body->m_veloc += velocStep;
-						body->m_omega += omegaStep;
+					if (!body->m_state->m_resting) {
+						body->m_state->m_veloc += velocStep;
+						body->m_state->m_omega += omegaStep;
 					} else {
 						const dgVector velocStep2(velocStep.DotProduct4(velocStep));
 						const dgVector omegaStep2(omegaStep.DotProduct4(omegaStep));
 						const dgVector test(((velocStep2 > speedFreeze2) | (omegaStep2 > speedFreeze2)) & dgVector::m_negOne);
 						const dgInt32 equilibrium = test.GetSignMask() ? 0 : 1;
-						body->m_resting &= equilibrium;
+						body->m_state->m_resting &= equilibrium;
 					}
 
-					dgAssert(body->m_veloc.m_w == dgFloat32(0.0f));
-					dgAssert(body->m_omega.m_w == dgFloat32(0.0f));
+					dgAssert(body->m_state->m_veloc.m_w == dgFloat32(0.0f));
+					dgAssert(body->m_state->m_omega.m_w == dgFloat32(0.0f));
 				}
 			}
 		} else {
@@ -1252,8 +1258,8 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 				const dgVector& linearMomentum = internalForces[i].m_linear;
 				const dgVector& angularMomentum = internalForces[i].m_angular;
 
-				body->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
-				body->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
+				body->m_state->m_veloc += linearMomentum.Scale4(body->m_invMass.m_w);
+				body->m_state->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
 			}
 		}
 	}
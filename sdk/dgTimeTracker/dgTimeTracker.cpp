@@ -1,4 +1,3 @@
-
 /* Copyright (c) <2003-2016> <Newton Game Dynamics>
 * 
 * This software is provided 'as-is', without any express or implied
@@ -10,12 +9,73 @@
 * freely
 */
 
+#include "dgTimeTracker.h"
+
+#ifdef D_TIME_TRACKER
 
-#include "stdafx.h"
-// need to include stdafx.h first so that visual studio do no issues a precompiled header error 
-#if defined (D_TIME_TRACKER) && defined(_MSC_VER)
+#include <time.h>
+#include <string.h>
+#include <mutex>
+#include <chrono>
 
-#include "dTimeTracker.h"
+#ifdef _MSC_VER
+	#define D_TIME_TRACKER_THREAD_LOCAL __declspec(thread)
+#else
+	#define D_TIME_TRACKER_THREAD_LOCAL __thread
+#endif
+
+class dTimeTrackerRecord
+{
+	public:
+	long long m_startTime;
+	long long m_endTime;
+	int m_nameIndex;
+};
+
+// single producer, single consumer ring, the owner thread writes the head and the thread calling Update writes the tail.
+// buffers are never freed while the tracker is alive, at the start of a capture they are released and reused by the threads that record events.
+class dTimeTracker::dThreadBuffer
+{
+	public:
+	dThreadBuffer ()
+		:m_next(NULL)
+		,m_head(0)
+		,m_tail(0)
+		,m_droppedEvents(0)
+		,m_threadId(0)
+		,m_owned(false)
+	{
+		m_name[0] = 0;
+	}
+
+	dThreadBuffer* m_next;
+	std::atomic<unsigned> m_head;
+	std::atomic<unsigned> m_tail;
+	std::atomic<int> m_droppedEvents;
+	int m_threadId;
+	bool m_owned;
+	char m_name[D_TIME_TRACKER_NAME_SIZE];
+	dTimeTrackerRecord m_ring[D_TIME_TRACKER_RING_SIZE];
+};
+
+static std::mutex dTimeTrackerLock;
+static std::atomic<int> dTimeTrackerThreadCount(0);
+static D_TIME_TRACKER_THREAD_LOCAL dTimeTracker::dThreadBuffer* dTimeTrackerThreadBuffer = NULL;
+static D_TIME_TRACKER_THREAD_LOCAL int dTimeTrackerThreadGeneration = -1;
+static D_TIME_TRACKER_THREAD_LOCAL int dTimeTrackerThreadId = 0;
+static D_TIME_TRACKER_THREAD_LOCAL char dTimeTrackerThreadName[D_TIME_TRACKER_NAME_SIZE];
+
+
+static void dTimeTrackerCopyName (char* const dst, const char* const src)
+{
+	// names are written to the json file without escaping
+	int i = 0;
+	for (; src[i] && (i < D_TIME_TRACKER_NAME_SIZE - 1); i ++) {
+		char ch = src[i];
+		dst[i] = ((ch == '"') || (ch == '\\') || (ch < ' ')) ? '_' : ch;
+	}
+	dst[i] = 0;
+}
 
 dTimeTracker* dTimeTracker::GetInstance()
 {
@@ -23,212 +83,255 @@ dTimeTracker* dTimeTracker::GetInstance()
 	return &instance;
 }
 
-
 dTimeTracker::dTimeTracker ()
+	:m_file(NULL)
+	,m_threads(NULL)
+	,m_baseTime(0)
+	,m_droppedEvents(0)
+	,m_namesCount(1)
+	,m_framesCount(0)
+	,m_firstRecord(0)
+	,m_capturing(0)
+	,m_generation(0)
 {
-	m_file = NULL;
-	m_firstRecord = 0;
-	m_numberOfFrames = 0;
-	m_processId = GetCurrentProcessId();
-	QueryPerformanceFrequency(&m_frequency);
-	QueryPerformanceCounter (&m_baseCount);
+	// the first name is used for the sections registered after the table is full
+	strcpy (m_names[0], "unnamed");
+}
 
-	InitializeCriticalSectionAndSpinCount(&m_criticalSection, 0x1000);
+dTimeTracker::~dTimeTracker ()
+{
+	if (m_file) {
+		std::unique_lock<std::mutex> lock (dTimeTrackerLock);
+		EndSection();
+	}
 
-	m_bufferIndex = 0;
-	m_bufferSize = 1024;
-	m_buffer = ((dTrackEntry*) dContainersAlloc::Alloc (m_bufferSize * sizeof (dTrackEntry)));
+	dThreadBuffer* next;
+	for (dThreadBuffer* buffer = m_threads; buffer; buffer = next) {
+		next = buffer->m_next;
+		delete buffer;
+	}
+}
 
-	m_outQueueBufferindex = 0;
-	m_outQueueBufferSize = 1024 * 512;
-	m_outQueueBuffer = ((dTrackEntry*) dContainersAlloc::Alloc (m_outQueueBufferSize * sizeof (dTrackEntry)));
+long long dTimeTracker::GetTimeInNanoseconds () const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - m_baseTime;
 }
 
-dTimeTracker::~dTimeTracker ()
+int dTimeTracker::RegisterName (const char* const name)
+{
+	char label[D_TIME_TRACKER_NAME_SIZE];
+	dTimeTrackerCopyName (label, name);
+
+	std::unique_lock<std::mutex> lock (dTimeTrackerLock);
+	for (int i = 1; i < m_namesCount; i ++) {
+		if (!strcmp (m_names[i], label)) {
+			return i;
+		}
+	}
+	if (m_namesCount >= D_TIME_TRACKER_MAX_NAMES) {
+		return 0;
+	}
+	strcpy (m_names[m_namesCount], label);
+	m_namesCount ++;
+	return m_namesCount - 1;
+}
+
+void dTimeTracker::RegisterThreadName (const char* const threadName)
 {
-	dContainersAlloc::Free (m_buffer);
-	dContainersAlloc::Free (m_outQueueBuffer);
-	DeleteCriticalSection(&m_criticalSection);
+	dTimeTrackerCopyName (dTimeTrackerThreadName, threadName);
+	if (dTimeTrackerThreadBuffer && (dTimeTrackerThreadGeneration == m_generation.load())) {
+		std::unique_lock<std::mutex> lock (dTimeTrackerLock);
+		strcpy (dTimeTrackerThreadBuffer->m_name, dTimeTrackerThreadName);
+	}
 }
 
-void dTimeTracker::StartSection (int numberOfFrames)
+dTimeTracker::dThreadBuffer* dTimeTracker::GetThreadBuffer ()
 {
-	if (m_file) {
-		fclose (m_file);
+	const int generation = m_generation.load();
+	if (dTimeTrackerThreadBuffer && (dTimeTrackerThreadGeneration == generation)) {
+		return dTimeTrackerThreadBuffer;
 	}
 
+	if (!dTimeTrackerThreadId) {
+		dTimeTrackerThreadId = dTimeTrackerThreadCount.fetch_add(1) + 1;
+	}
+
+	std::unique_lock<std::mutex> lock (dTimeTrackerLock);
+	// a capture may have started since the generation was read
+	const int ownerGeneration = m_generation.load();
+	dThreadBuffer* buffer = m_threads;
+	for (; buffer && buffer->m_owned; buffer = buffer->m_next);
+	if (!buffer) {
+		buffer = new dThreadBuffer;
+		buffer->m_next = m_threads;
+		m_threads = buffer;
+	}
+
+	buffer->m_owned = true;
+	buffer->m_threadId = dTimeTrackerThreadId;
+	buffer->m_head.store(0);
+	buffer->m_tail.store(0);
+	buffer->m_droppedEvents.store(0);
+	if (dTimeTrackerThreadName[0]) {
+		strcpy (buffer->m_name, dTimeTrackerThreadName);
+	} else {
+		sprintf (buffer->m_name, "thread_%d", dTimeTrackerThreadId);
+	}
+
+	dTimeTrackerThreadBuffer = buffer;
+	dTimeTrackerThreadGeneration = ownerGeneration;
+	return buffer;
+}
+
+void dTimeTracker::StartSection (int numberOfFrames)
+{
 	time_t rawtime;
 	char fileName [80];
 
 	time (&rawtime);
 	struct tm * timeinfo = localtime (&rawtime);
 	strftime (fileName, sizeof(fileName), "profile_%H%M%S%m%d%Y.json", timeinfo);
-	
+	StartSection (fileName, numberOfFrames);
+}
+
+bool dTimeTracker::StartSection (const char* const fileName, int numberOfFrames)
+{
+	std::unique_lock<std::mutex> lock (dTimeTrackerLock);
+	if (m_file) {
+		EndSection();
+	}
+
 	m_file = fopen (fileName, "wb");
+	if (!m_file) {
+		return false;
+	}
 
 	fprintf (m_file, "{\n");
 	fprintf (m_file, "\t\"traceEvents\": [");
 
-	QueryPerformanceFrequency(&m_frequency);
-	QueryPerformanceCounter (&m_baseCount);
-	m_numberOfFrames = numberOfFrames;	
+	m_firstRecord = 0;
+	m_droppedEvents = 0;
+	m_framesCount = (numberOfFrames > 0) ? numberOfFrames : 1;
+	m_baseTime = 0;
+	m_baseTime = GetTimeInNanoseconds();
+
+	// all buffers are released, threads claim one again with the first event of the capture
+	for (dThreadBuffer* buffer = m_threads; buffer; buffer = buffer->m_next) {
+		buffer->m_owned = false;
+	}
+	m_generation.fetch_add(1);
+	m_capturing.store(1);
+	return true;
 }
 
+void dTimeTracker::FlushThreadBuffer (dThreadBuffer* const buffer)
+{
+	const unsigned head = buffer->m_head.load(std::memory_order_acquire);
+	unsigned tail = buffer->m_tail.load(std::memory_order_relaxed);
+	for (; tail != head; tail ++) {
+		const dTimeTrackerRecord& event = buffer->m_ring[tail & (D_TIME_TRACKER_RING_SIZE - 1)];
+		fprintf (m_file, m_firstRecord ? ",\n" : "\n");
+		m_firstRecord = 1;
+
+		fprintf (m_file, "\t\t {");
+		fprintf (m_file, "\"name\": \"%s\"", m_names[event.m_nameIndex]);
+		fprintf (m_file, ", \"cat\": \"newton\"");
+		fprintf (m_file, ", \"ph\": \"X\"");
+		fprintf (m_file, ", \"pid\": 0");
+		fprintf (m_file, ", \"tid\": %d", buffer->m_threadId);
+		fprintf (m_file, ", \"ts\": %.3f", double (event.m_startTime) * 1.0e-3);
+		fprintf (m_file, ", \"dur\": %.3f", double (event.m_endTime - event.m_startTime) * 1.0e-3);
+		fprintf (m_file, "}");
+	}
+	buffer->m_tail.store(tail, std::memory_order_release);
+	m_droppedEvents += buffer->m_droppedEvents.exchange(0);
+}
+
+// it must be called with the tracker locked
 void dTimeTracker::EndSection ()
 {
-	EnterCriticalSection(&m_criticalSection); 
-	FlushQueue ();
+	m_capturing.store(0);
+	const int generation = m_generation.load();
+	for (dThreadBuffer* buffer = m_threads; buffer; buffer = buffer->m_next) {
+		if (buffer->m_owned) {
+			FlushThreadBuffer (buffer);
+		}
+	}
+
+	// thread names are metadata events
+	for (dThreadBuffer* buffer = m_threads; buffer; buffer = buffer->m_next) {
+		if (buffer->m_owned) {
+			fprintf (m_file, m_firstRecord ? ",\n" : "\n");
+			m_firstRecord = 1;
+			fprintf (m_file, "\t\t {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"%s\"}}", buffer->m_threadId, buffer->m_name);
+		}
+	}
 
 	fprintf (m_file, "\n");
 	fprintf (m_file, "\t],\n");
 
 	fprintf (m_file, "\t\"displayTimeUnit\": \"ns\",\n");
-	fprintf (m_file, "\t\"systemTraceEvents\": \"SystemTraceData\",\n");
 	fprintf (m_file, "\t\"otherData\": {\n");
-	fprintf (m_file, "\t\t\"version\": \"My Application v1.0\"\n");
+	fprintf (m_file, "\t\t\"capture\": \"%d\",\n", generation);
+	fprintf (m_file, "\t\t\"droppedEvents\": \"%lld\"\n", m_droppedEvents);
 	fprintf (m_file, "\t}\n");
 	fprintf (m_file, "}\n");
 
 	fclose (m_file);
 	m_file = NULL;
-	m_firstRecord = 0;
-	LeaveCriticalSection(&m_criticalSection);
 }
 
 void dTimeTracker::Update ()
 {
-	if (m_file) {
-		QueueEvents ();
-		m_numberOfFrames --;
-		if (m_numberOfFrames == 0) {
-			EndSection ();
+	if (IsCapturing()) {
+		std::unique_lock<std::mutex> lock (dTimeTrackerLock);
+		if (m_file) {
+			for (dThreadBuffer* buffer = m_threads; buffer; buffer = buffer->m_next) {
+				if (buffer->m_owned) {
+					FlushThreadBuffer (buffer);
+				}
+			}
+			m_framesCount --;
+			if (m_framesCount == 0) {
+				EndSection ();
+			}
 		}
 	}
 }
 
-
-long long dTimeTracker::GetTimeInNanosenconds()
-{
-	LARGE_INTEGER count;
-	QueryPerformanceCounter (&count);
-	count.QuadPart -= m_baseCount.QuadPart;
-	LONGLONG ticks = LONGLONG (count.QuadPart * LONGLONG (1000000000) / m_frequency.QuadPart);
-	return ticks;
-}
-
-dCRCTYPE dTimeTracker::RegisterName (const char* const name)
-{
-	dCRCTYPE crc = dCRC64 (name);
-
-	EnterCriticalSection(&m_criticalSection); 
-	dTree<dLabels, dCRCTYPE>::dTreeNode* const node = m_dictionary.Insert (crc);
-	LeaveCriticalSection(&m_criticalSection);
-	if (node) {
-		strncpy (&node->GetInfo().m_name[0], name, sizeof (node->GetInfo().m_name));  
-	}
-	return crc;
-}
-
-TIMETRACKER_API void dTimeTracker::RegisterThreadName (const char* const threadName)
-{
-	dCRCTYPE crc = GetCurrentThreadId();
-	EnterCriticalSection(&m_criticalSection); 
-	dTree<dLabels, dCRCTYPE>::dTreeNode* const node = m_dictionary.Insert (crc);
-	LeaveCriticalSection(&m_criticalSection);
-	if (node) {
-		strncpy (&node->GetInfo().m_name[0], threadName, sizeof (node->GetInfo().m_name));  
-	}
-}	
-
-void dTimeTracker::QueueEvents ()
-{
-	EnterCriticalSection(&m_criticalSection); 
-	if ((m_outQueueBufferindex + m_bufferIndex) > m_outQueueBufferSize) {
-		FlushQueue ();
-		m_outQueueBufferindex = 0;
-	}
-	memcpy (&m_outQueueBuffer[m_outQueueBufferindex], m_buffer, m_bufferIndex * sizeof (dTrackEntry));
-	m_outQueueBufferindex += m_bufferIndex;
-	m_bufferIndex = 0;
-
-	LeaveCriticalSection(&m_criticalSection);
-}
-
-
-void dTimeTracker::FlushQueue ()
-{
-	for (int i = 0; i < m_outQueueBufferindex; i ++) {
-		const dTrackEntry& event = m_outQueueBuffer[i];
-		if (!m_firstRecord) {
-			fprintf (m_file, "\n");
-			m_firstRecord = true;
-		} else {
-			fprintf (m_file, ",\n");
-		}
-		
-		dTree<dLabels, dCRCTYPE>::dTreeNode* threadNodeName = m_dictionary.Find (event.m_threadId);
-		if (!threadNodeName) {
-			threadNodeName = m_dictionary.Insert(event.m_threadId);
-			sprintf (threadNodeName->GetInfo().m_name, "thread_%d", event.m_threadId);
-		}
-
-		fprintf (m_file, "\t\t {");
-		fprintf (m_file, "\"name\": \"%s\"", m_dictionary.Find (event.m_nameCRC)->GetInfo().m_name);
-		fprintf (m_file, ", \"cat\": \"%s\"", threadNodeName->GetInfo().m_name);
-		fprintf (m_file, ", \"ph\": \"X\"");
-		fprintf (m_file, ", \"pid\": \"%d\"", m_processId);
-		fprintf (m_file, ", \"tid\": \"%d\"", event.m_threadId);
-		fprintf (m_file, ", \"ts\": %lld", event.m_startTime);
-		fprintf (m_file, ", \"dur\": %lld", event.m_endTime - event.m_startTime);
-		fprintf (m_file, "}");
-/*
-		fprintf (m_file, "\t\t {");
-		fprintf (m_file, "\"name\": \"%s\", ", m_dictionary.Find (event.m_nameCRC)->GetInfo().m_name);
-		fprintf (m_file, "\"cat\": \"%s\", ", threadNodeName->GetInfo().m_name);
-		fprintf (m_file, "\"ph\": \"E\", ");
-		fprintf (m_file, "\"pid\": \"%d\", ", m_processId);
-		fprintf (m_file, "\"tid\": \"%d\", ", event.m_threadId);
-		fprintf (m_file, "\"ts\": %lld", event.m_endTime);
-		fprintf (m_file, "}");
-*/
-	}
-
-	m_outQueueBufferindex = 0;
-}
-
-
-
-dTimeTracker::dTrackEntry::dTrackEntry(dCRCTYPE nameCRC)
+dTimeTracker::dTrackEntry::dTrackEntry(int nameIndex)
+	:m_startTime(-1)
+	,m_nameIndex(nameIndex)
+	,m_generation(0)
 {
 	dTimeTracker* const instance = dTimeTracker::GetInstance();
-	if (instance->m_file) {
-		long long startTime = instance->GetTimeInNanosenconds ();
-		m_nameCRC = nameCRC;
-		m_startTime = startTime;
-		m_endTime = startTime;
-		m_threadId = GetCurrentThreadId();
+	if (instance->IsCapturing()) {
+		m_generation = instance->m_generation.load(std::memory_order_relaxed);
+		m_startTime = instance->GetTimeInNanoseconds ();
 	}
-
 }
 
 dTimeTracker::dTrackEntry::~dTrackEntry()
 {
-	dTimeTracker* const instance = dTimeTracker::GetInstance();
-	m_endTime = instance->GetTimeInNanosenconds ();
-	if (instance->m_file) {
-		EnterCriticalSection(&instance->m_criticalSection); 
-		if (instance->m_bufferIndex >= instance->m_bufferSize) {
-			dTrackEntry* const buffer = ((dTrackEntry*) dContainersAlloc::Alloc (2 * instance->m_bufferSize * sizeof (dTrackEntry)));
-			memcpy (buffer, instance->m_buffer, instance->m_bufferIndex * sizeof (dTrackEntry));
-			dContainersAlloc::Free (instance->m_buffer);
-			instance->m_bufferSize = instance->m_bufferSize * 2;
-			instance->m_buffer = buffer;
+	if (m_startTime >= 0) {
+		dTimeTracker* const instance = dTimeTracker::GetInstance();
+		// sections that started in a previous capture are discarded
+		if (instance->IsCapturing() && (m_generation == instance->m_generation.load(std::memory_order_relaxed))) {
+			const long long endTime = instance->GetTimeInNanoseconds ();
+			dThreadBuffer* const buffer = instance->GetThreadBuffer();
+			const unsigned head = buffer->m_head.load(std::memory_order_relaxed);
+			const unsigned tail = buffer->m_tail.load(std::memory_order_acquire);
+			if ((head - tail) < D_TIME_TRACKER_RING_SIZE) {
+				dTimeTrackerRecord& event = buffer->m_ring[head & (D_TIME_TRACKER_RING_SIZE - 1)];
+				event.m_startTime = m_startTime;
+				event.m_endTime = endTime;
+				event.m_nameIndex = m_nameIndex;
+				buffer->m_head.store(head + 1, std::memory_order_release);
+			} else {
+				buffer->m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+			}
 		}
-		instance->m_buffer[instance->m_bufferIndex] = *this;
-		instance->m_bufferIndex ++;
-		LeaveCriticalSection(&instance->m_criticalSection);
 	}
 }
 
-
-#endif
\ No newline at end of file
+#endif
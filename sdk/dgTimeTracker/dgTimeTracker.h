@@ -16,12 +16,87 @@
 
 #ifdef D_TIME_TRACKER
 
+#include <stdio.h>
+#include <atomic>
+
+#ifdef _NEWTON_STATIC_LIB
+	#define D_TIME_TRACKER_API
+#else
+	#ifdef _NEWTON_BUILD_DLL
+		#ifdef _WIN32
+			#define D_TIME_TRACKER_API __declspec (dllexport)
+		#else
+			#define D_TIME_TRACKER_API __attribute__ ((visibility("default")))
+		#endif
+	#else
+		#ifdef _WIN32
+			#define D_TIME_TRACKER_API __declspec (dllimport)
+		#else
+			#define D_TIME_TRACKER_API
+		#endif
+	#endif
+#endif
+
+#define D_TIME_TRACKER_RING_SIZE	(1<<15)
+#define D_TIME_TRACKER_MAX_NAMES	1024
+#define D_TIME_TRACKER_NAME_SIZE	64
+
+// low overhead profiler for capturing a few frames.
+// each thread records the begin and end time of every named section in its own ring buffer without locking,
+// the buffers are drained by Update, which the world calls at the end of each update,
+// and the captured frames are saved in chrome trace event format (open the file with chrome://tracing)
 class dTimeTracker
 {
 	public:
+	class dThreadBuffer;
+
+	class dTrackEntry
+	{
+		public:
+		D_TIME_TRACKER_API dTrackEntry (int nameIndex);
+		D_TIME_TRACKER_API ~dTrackEntry ();
+
+		private:
+		long long m_startTime;
+		int m_nameIndex;
+		int m_generation;
+	};
+
+	D_TIME_TRACKER_API static dTimeTracker* GetInstance();
+
+	D_TIME_TRACKER_API void StartSection (int numberOfFrames);
+	D_TIME_TRACKER_API bool StartSection (const char* const fileName, int numberOfFrames);
+	D_TIME_TRACKER_API void Update ();
+
+	D_TIME_TRACKER_API int RegisterName (const char* const name);
+	D_TIME_TRACKER_API void RegisterThreadName (const char* const threadName);
+
+	bool IsCapturing () const
+	{
+		return m_capturing.load(std::memory_order_relaxed) != 0;
+	}
+
 	private:
 	dTimeTracker ();
 	~dTimeTracker ();
+
+	void EndSection ();
+	void FlushThreadBuffer (dThreadBuffer* const buffer);
+	dThreadBuffer* GetThreadBuffer ();
+	long long GetTimeInNanoseconds () const;
+
+	FILE* m_file;
+	dThreadBuffer* m_threads;
+	long long m_baseTime;
+	long long m_droppedEvents;
+	int m_namesCount;
+	int m_framesCount;
+	int m_firstRecord;
+	std::atomic<int> m_capturing;
+	std::atomic<int> m_generation;
+	char m_names[D_TIME_TRACKER_MAX_NAMES][D_TIME_TRACKER_NAME_SIZE];
+
+	friend class dTrackEntry;
 };
 
 
@@ -35,10 +110,10 @@ class dTimeTracker
 	dTimeTracker::GetInstance()->RegisterThreadName (name);
 
 #define dTimeTrackerEvent(name)																\
-	static dCRCTYPE __crcEventName__ = dTimeTracker::GetInstance()->RegisterName (name);	\
-	dTimeTracker::dTrackEntry ___trackerEntry___(__crcEventName__);	
+	static int __eventNameIndex__ = dTimeTracker::GetInstance()->RegisterName (name);		\
+	dTimeTracker::dTrackEntry ___trackerEntry___(__eventNameIndex__);
 
-#else 
+#else
 
 #define dTimeTrackerUpdate()
 #define dTimeTrackerEvent(name)
@@ -47,4 +122,4 @@ class dTimeTracker
 
 #endif
 
-#endif
\ No newline at end of file
+#endif